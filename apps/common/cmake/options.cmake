@@ -79,6 +79,15 @@ ENDIF()
 
 SET(CFG_DEBUG_LVL "0xEC000000L" CACHE STRING "Debug Level for debug output")
 
+# highest console log level compiled into the applications, entries above it
+# are removed by the compiler (0 = none, 1 = error, 2 = warning, 3 = info, 4 = debug)
+SET(CFG_CONSOLE_LOG_FLOOR "4" CACHE STRING "Highest console log level compiled in")
+SET_PROPERTY(CACHE CFG_CONSOLE_LOG_FLOOR PROPERTY STRINGS 0 1 2 3 4)
+IF(NOT CFG_CONSOLE_LOG_FLOOR MATCHES "^[0-4]$")
+    MESSAGE(FATAL_ERROR "CFG_CONSOLE_LOG_FLOOR must be 0, 1, 2, 3 or 4 (is ${CFG_CONSOLE_LOG_FLOOR})")
+ENDIF()
+ADD_DEFINITIONS(-DCONSOLE_LOG_FLOOR=${CFG_CONSOLE_LOG_FLOOR})
+
 # set global include directories
 INCLUDE_DIRECTORIES (
     ${OPLK_INCLUDE_DIR}
@@ -0,0 +1,971 @@
+/**
+********************************************************************************
+\file   rttune-windows.c
+
+\brief  Real-time host tuning for Windows
+
+The file implements the real-time host tuning for Windows. It inspects the host
+settings which influence the wake-up latency of the real-time threads and
+optionally applies the recommended values. The impact of every applied setting
+is measured with the wake-up latency of a thread created like the sync thread.
+
+\ingroup module_app_common
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#define _WIN32_WINNT 0x0501     // Windows version must be at least Windows XP
+#define WIN32_LEAN_AND_MEAN     // Do not use extended Win32 API functions
+#include <Windows.h>
+
+#include "system.h"
+#include "rttune.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define RTTUNE_VALUE_SIZE           32          ///< Size of the value strings
+
+// registry key of the network adapter class
+#define RTTUNE_NIC_CLASS_KEY        "SYSTEM\\CurrentControlSet\\Control\\Class\\{4d36e972-e325-11ce-bfc1-08002be10318}"
+#define RTTUNE_NIC_MODERATION       "*InterruptModeration"
+#define RTTUNE_NIC_INSTANCE_ID      "NetCfgInstanceId"
+
+// process information class and flags of the power throttling (Windows 10 1709)
+#define RTTUNE_PROCESS_POWER_THROTTLING     4
+#define RTTUNE_THROTTLING_VERSION           1
+#define RTTUNE_THROTTLING_EXECUTION_SPEED   0x1
+#define RTTUNE_THROTTLING_TIMER_RESOLUTION  0x4
+#define RTTUNE_THROTTLING_MASK              (RTTUNE_THROTTLING_EXECUTION_SPEED | \
+                                             RTTUNE_THROTTLING_TIMER_RESOLUTION)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  State of a setting
+*/
+typedef enum
+{
+    kRtTuneStateOk = 0,                     ///< The setting has the recommended value
+    kRtTuneStateNeedsTuning,                ///< The setting should be changed
+    kRtTuneStateNotSupported                ///< The setting is not available on this host
+} tRtTuneState;
+
+/**
+\brief  Result of applying a setting
+*/
+typedef enum
+{
+    kRtTuneResultApplied = 0,               ///< The setting is effective
+    kRtTuneResultPending,                   ///< The setting is effective after a restart of the device
+    kRtTuneResultFailed                     ///< The setting could not be changed
+} tRtTuneResult;
+
+/**
+\brief  Tuning item
+
+The structure describes a setting checked by the real-time host tuning.
+Settings marked as process settings only affect the process which applies
+them.
+*/
+typedef struct
+{
+    const char*         pszName;            ///< Name of the setting
+    const char*         pszRecommended;     ///< Recommended value
+    BOOL                fProcess;           ///< The setting is local to the process
+    tRtTuneState        (*pfnCheck)(char* pszValue_p);  ///< Reads the current value
+    tRtTuneResult       (*pfnApply)(void);  ///< Applies the recommended value, or NULL
+} tRtTuneItem;
+
+/**
+\brief  Wake-up latency measurement
+*/
+typedef struct
+{
+    UINT64              periodNs;           ///< Wake-up period [ns]
+    UINT64              durationNs;         ///< Duration of the measurement [ns]
+    UINT32              count;              ///< Number of wake-ups
+    UINT64              maxLatency;         ///< Maximum wake-up latency [ns]
+    UINT64              sumLatency;         ///< Sum of all wake-up latencies [ns]
+} tRtTuneLatency;
+
+typedef DWORD (WINAPI* tPowerGetActiveScheme)(HKEY hRoot_p, GUID** ppScheme_p);
+typedef DWORD (WINAPI* tPowerSetActiveScheme)(HKEY hRoot_p, const GUID* pScheme_p);
+typedef DWORD (WINAPI* tPowerReadACValueIndex)(HKEY hRoot_p, const GUID* pScheme_p, const GUID* pSubGroup_p,
+                                               const GUID* pSetting_p, LPDWORD pValue_p);
+typedef DWORD (WINAPI* tPowerWriteACValueIndex)(HKEY hRoot_p, const GUID* pScheme_p, const GUID* pSubGroup_p,
+                                                const GUID* pSetting_p, DWORD value_p);
+typedef LONG (NTAPI* tNtQueryTimerResolution)(PULONG pCoarsest_p, PULONG pFinest_p, PULONG pCurrent_p);
+typedef LONG (NTAPI* tNtSetTimerResolution)(ULONG resolution_p, BOOLEAN fSet_p, PULONG pCurrent_p);
+typedef BOOL (WINAPI* tProcessInformation)(HANDLE hProcess_p, int class_p, LPVOID pInfo_p, DWORD size_p);
+
+/**
+\brief  Power throttling state of a process
+*/
+typedef struct
+{
+    ULONG               version;            ///< Version of the structure
+    ULONG               controlMask;        ///< Throttling policies controlled by the process
+    ULONG               stateMask;          ///< Throttling policies enabled by the process
+} tRtTuneThrottling;
+
+/**
+\brief  Real-time host tuning instance
+
+The structure contains the system functions which are not available on all
+versions of Windows. They are loaded at run time, a missing function makes
+the corresponding setting unavailable.
+*/
+typedef struct
+{
+    const char*                 pszIfName;              ///< Name of the POWERLINK interface, or NULL
+    HMODULE                     hPowrProf;              ///< Handle of the power management library
+    tPowerGetActiveScheme       pfnGetActiveScheme;     ///< PowerGetActiveScheme()
+    tPowerSetActiveScheme       pfnSetActiveScheme;     ///< PowerSetActiveScheme()
+    tPowerReadACValueIndex      pfnReadAcValue;         ///< PowerReadACValueIndex()
+    tPowerWriteACValueIndex     pfnWriteAcValue;        ///< PowerWriteACValueIndex()
+    tNtQueryTimerResolution     pfnQueryTimerResolution;    ///< NtQueryTimerResolution()
+    tNtSetTimerResolution       pfnSetTimerResolution;  ///< NtSetTimerResolution()
+    tProcessInformation         pfnGetProcessInfo;      ///< GetProcessInformation()
+    tProcessInformation         pfnSetProcessInfo;      ///< SetProcessInformation()
+} tRtTuneInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tRtTuneInstance      rtTuneInstance_l;
+
+// power schemes and settings of the power management
+static const GUID           guidHighPerformance_l =
+    {0x8c5e7fda, 0xe8bf, 0x4a96, {0x9a, 0x85, 0xa6, 0xe2, 0x3a, 0x8c, 0x63, 0x5c}};
+static const GUID           guidBalanced_l =
+    {0x381b4222, 0xf694, 0x41f0, {0x96, 0x85, 0xff, 0x5b, 0xb2, 0x60, 0xdf, 0x2e}};
+static const GUID           guidPowerSaver_l =
+    {0xa1841308, 0x3541, 0x4fab, {0xbc, 0x81, 0xf7, 0x15, 0x56, 0xf2, 0x0b, 0x4a}};
+static const GUID           guidProcessorSettings_l =
+    {0x54533251, 0x82be, 0x4824, {0x96, 0xc1, 0x47, 0xb6, 0x0b, 0x74, 0x0d, 0x00}};
+static const GUID           guidProcessorIdleDisable_l =
+    {0x5d76a2ca, 0xe8c0, 0x402f, {0xa1, 0x33, 0x21, 0x58, 0x49, 0x2d, 0x58, 0xad}};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void loadFunctions(void);
+static void measureLatency(tRtTuneLatency* pLatency_p);
+static void measureThread(void* pArg_p);
+static tRtTuneState checkCpuIsolation(char* pszValue_p);
+static tRtTuneState checkInterruptModeration(char* pszValue_p);
+static tRtTuneResult applyInterruptModeration(void);
+static tRtTuneState checkPowerScheme(char* pszValue_p);
+static tRtTuneResult applyPowerScheme(void);
+static tRtTuneState checkIdleStates(char* pszValue_p);
+static tRtTuneResult applyIdleStates(void);
+static tRtTuneState checkTimerResolution(char* pszValue_p);
+static tRtTuneResult applyTimerResolution(void);
+static tRtTuneState checkPriorityClass(char* pszValue_p);
+static tRtTuneResult applyPriorityClass(void);
+static tRtTuneState checkPowerThrottling(char* pszValue_p);
+static tRtTuneResult applyPowerThrottling(void);
+static int processModeration(BOOL fDisable_p, BOOL* pfEnabled_p);
+static BOOL matchInterface(const char* pszInstanceId_p);
+
+// The power scheme must be applied before the idle states, which are written
+// to the active scheme.
+static const tRtTuneItem    aItem_l[] =
+{
+    {"CPU isolation",           "sync CPU isolated",    FALSE,  checkCpuIsolation,          NULL},
+    {"NIC interrupt moderation", "off",                 FALSE,  checkInterruptModeration,   applyInterruptModeration},
+    {"Power scheme",            "high performance",     FALSE,  checkPowerScheme,           applyPowerScheme},
+    {"Processor idle states",   "disabled",             FALSE,  checkIdleStates,            applyIdleStates},
+    {"Timer resolution",        "finest",               TRUE,   checkTimerResolution,       applyTimerResolution},
+    {"Priority class",          "realtime",             TRUE,   checkPriorityClass,         applyPriorityClass},
+    {"Power throttling",        "off",                  TRUE,   checkPowerThrottling,       applyPowerThrottling},
+};
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the real-time host tuning
+
+The function checks the host settings which influence the real-time behavior
+and prints a report. If requested, the recommended values are applied and the
+wake-up latency is measured before and after every change.
+
+Process settings (timer resolution, priority class and power throttling) only
+affect the calling process. They are effective for the application if the
+application executes the tuning itself.
+
+The interrupt moderation is only changed on the adapter of the given
+interface, other adapters of the host are left untouched.
+
+\param  pszIfName_p         Name of the POWERLINK interface. It must contain the
+                            GUID of the adapter, like the pcap device names do.
+                            NULL skips the interrupt moderation.
+\param  flags_p             RTTUNE_FLAG_APPLY to apply the recommended values,
+                            RTTUNE_FLAG_MEASURE to measure their impact.
+\param  period_p            Wake-up period of the measurement [us].
+\param  duration_p          Duration of one measurement [ms].
+
+\return The function returns the number of settings which do not have the
+        recommended value.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int rttune_run(const char* pszIfName_p, UINT flags_p, UINT32 period_p, UINT duration_p)
+{
+    const tRtTuneItem*  pItem;
+    tRtTuneState        state;
+    tRtTuneResult       result;
+    tRtTuneLatency      before;
+    tRtTuneLatency      after;
+    char                aValue[RTTUNE_VALUE_SIZE];
+    const char*         pszStatus;
+    BOOL                fImpact;
+    int                 remaining = 0;
+    UINT                i;
+
+    loadFunctions();
+    rtTuneInstance_l.pszIfName = pszIfName_p;
+
+    memset(&before, 0, sizeof(before));
+    before.periodNs = (UINT64)period_p * 1000;
+    before.durationNs = (UINT64)duration_p * 1000000;
+    after = before;
+
+    printf("Real-time host tuning (%s):\n",
+           (flags_p & RTTUNE_FLAG_APPLY) ? "apply" : "inspect only");
+
+    if ((flags_p & RTTUNE_FLAG_MEASURE) && (flags_p & RTTUNE_FLAG_APPLY))
+    {
+        measureLatency(&before);
+        if (before.count != 0)
+        {
+            printf("  Wake-up latency before tuning: max %.1f us, avg %.1f us (%lu us period)\n",
+                   (double)before.maxLatency / 1000.0,
+                   (double)before.sumLatency / (double)before.count / 1000.0, (ULONG)period_p);
+        }
+    }
+
+    printf("  %-26s %-20s %-20s %-16s %s\n", "Setting", "Current", "Recommended", "Status", "Impact");
+
+    for (i = 0; i < sizeof(aItem_l) / sizeof(aItem_l[0]); i++)
+    {
+        pItem = &aItem_l[i];
+        fImpact = FALSE;
+        strcpy(aValue, "-");
+
+        state = pItem->pfnCheck(aValue);
+        switch (state)
+        {
+            case kRtTuneStateOk:
+                pszStatus = "ok";
+                break;
+
+            case kRtTuneStateNotSupported:
+                pszStatus = "n/a";
+                break;
+
+            default:
+                pszStatus = "needs tuning";
+                if (!(flags_p & RTTUNE_FLAG_APPLY) || (pItem->pfnApply == NULL))
+                    break;
+
+                result = pItem->pfnApply();
+                if (result == kRtTuneResultFailed)
+                {
+                    pszStatus = "failed";
+                    break;
+                }
+
+                state = pItem->pfnCheck(aValue);
+                if (result == kRtTuneResultPending)
+                {
+                    pszStatus = "restart device";
+                    break;
+                }
+
+                pszStatus = "applied";
+                if ((flags_p & RTTUNE_FLAG_MEASURE) && (before.count != 0))
+                {
+                    measureLatency(&after);
+                    fImpact = (after.count != 0);
+                }
+                break;
+        }
+
+        if ((state == kRtTuneStateNeedsTuning) && (pItem->pfnApply != NULL))
+            remaining++;
+
+        printf("  %-26s %-20s %-20s %-16s", pItem->pszName, aValue, pItem->pszRecommended, pszStatus);
+        if (fImpact)
+        {
+            printf(" max %.1f -> %.1f us, avg %.1f -> %.1f us",
+                   (double)before.maxLatency / 1000.0, (double)after.maxLatency / 1000.0,
+                   (double)before.sumLatency / (double)before.count / 1000.0,
+                   (double)after.sumLatency / (double)after.count / 1000.0);
+            before = after;
+        }
+        printf("%s\n", pItem->fProcess ? " (process setting)" : "");
+    }
+
+    printf("  %d setting(s) not tuned\n", remaining);
+
+    if (rtTuneInstance_l.hPowrProf != NULL)
+        FreeLibrary(rtTuneInstance_l.hPowrProf);
+    memset(&rtTuneInstance_l, 0, sizeof(rtTuneInstance_l));
+
+    return remaining;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load the optional system functions
+
+The function resolves the system functions which are not available on all
+versions of Windows.
+*/
+//------------------------------------------------------------------------------
+static void loadFunctions(void)
+{
+    tRtTuneInstance*    pInstance = &rtTuneInstance_l;
+    HMODULE             hModule;
+
+    memset(pInstance, 0, sizeof(tRtTuneInstance));
+
+    pInstance->hPowrProf = LoadLibraryA("powrprof.dll");
+    if (pInstance->hPowrProf != NULL)
+    {
+        hModule = pInstance->hPowrProf;
+        pInstance->pfnGetActiveScheme = (tPowerGetActiveScheme)GetProcAddress(hModule, "PowerGetActiveScheme");
+        pInstance->pfnSetActiveScheme = (tPowerSetActiveScheme)GetProcAddress(hModule, "PowerSetActiveScheme");
+        pInstance->pfnReadAcValue = (tPowerReadACValueIndex)GetProcAddress(hModule, "PowerReadACValueIndex");
+        pInstance->pfnWriteAcValue = (tPowerWriteACValueIndex)GetProcAddress(hModule, "PowerWriteACValueIndex");
+    }
+
+    hModule = GetModuleHandleA("ntdll.dll");
+    if (hModule != NULL)
+    {
+        pInstance->pfnQueryTimerResolution = (tNtQueryTimerResolution)GetProcAddress(hModule, "NtQueryTimerResolution");
+        pInstance->pfnSetTimerResolution = (tNtSetTimerResolution)GetProcAddress(hModule, "NtSetTimerResolution");
+    }
+
+    hModule = GetModuleHandleA("kernel32.dll");
+    if (hModule != NULL)
+    {
+        pInstance->pfnGetProcessInfo = (tProcessInformation)GetProcAddress(hModule, "GetProcessInformation");
+        pInstance->pfnSetProcessInfo = (tProcessInformation)GetProcAddress(hModule, "SetProcessInformation");
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure the wake-up latency
+
+The function measures the wake-up latency of a thread created like the sync
+thread. The result is stored in the measurement structure, the count is 0 if
+the measurement could not be executed.
+
+\param  pLatency_p          Pointer to the measurement with the period and the
+                            duration.
+*/
+//------------------------------------------------------------------------------
+static void measureLatency(tRtTuneLatency* pLatency_p)
+{
+    tSystemThread       thread;
+
+    pLatency_p->count = 0;
+    pLatency_p->maxLatency = 0;
+    pLatency_p->sumLatency = 0;
+
+    if ((pLatency_p->periodNs == 0) ||
+        (system_createThread(measureThread, pLatency_p, &thread) != 0))
+        return;
+
+    system_joinThread(&thread);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measurement thread
+
+\param  pArg_p              Pointer to the measurement.
+*/
+//------------------------------------------------------------------------------
+static void measureThread(void* pArg_p)
+{
+    tRtTuneLatency*     pLatency = (tRtTuneLatency*)pArg_p;
+    tSystemTimer        timer;
+    UINT64              wakeTime;
+    UINT64              endTime;
+    UINT64              latency;
+
+    if (system_openTimer(&timer) != 0)
+        return;
+
+    wakeTime = system_getTimeNs() + pLatency->periodNs;
+    endTime = wakeTime + pLatency->durationNs;
+
+    while (wakeTime < endTime)
+    {
+        system_waitTimer(&timer, wakeTime);
+        latency = system_getTimeNs() - wakeTime;
+
+        if (latency > pLatency->maxLatency)
+            pLatency->maxLatency = latency;
+        pLatency->sumLatency += latency;
+        pLatency->count++;
+
+        // continue with the next period in the future after a late wake-up
+        wakeTime += (latency / pLatency->periodNs + 1) * pLatency->periodNs;
+    }
+
+    system_closeTimer(&timer);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the CPU isolation
+
+Windows does not provide a way to exclude a CPU from the scheduling of other
+threads, so the setting is only reported.
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkCpuIsolation(char* pszValue_p)
+{
+    SYSTEM_INFO         info;
+
+    GetSystemInfo(&info);
+    sprintf(pszValue_p, "%lu CPUs shared", (ULONG)info.dwNumberOfProcessors);
+    return kRtTuneStateNotSupported;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the interrupt moderation of the POWERLINK adapter
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkInterruptModeration(char* pszValue_p)
+{
+    BOOL                fEnabled;
+
+    if ((rtTuneInstance_l.pszIfName == NULL) || (*rtTuneInstance_l.pszIfName == '\0'))
+    {
+        strcpy(pszValue_p, "no interface");
+        return kRtTuneStateNotSupported;
+    }
+
+    if (processModeration(FALSE, &fEnabled) != 0)
+        return kRtTuneStateNotSupported;
+
+    strcpy(pszValue_p, fEnabled ? "on" : "off");
+    return fEnabled ? kRtTuneStateNeedsTuning : kRtTuneStateOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Disable the interrupt moderation of the POWERLINK adapter
+
+The setting is read by the driver when the adapter is started, so it becomes
+effective after the adapter has been restarted.
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyInterruptModeration(void)
+{
+    BOOL                fEnabled;
+
+    if (processModeration(TRUE, &fEnabled) != 0)
+        return kRtTuneResultFailed;
+
+    return kRtTuneResultPending;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the active power scheme
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkPowerScheme(char* pszValue_p)
+{
+    GUID*               pScheme;
+    tRtTuneState        state;
+
+    if ((rtTuneInstance_l.pfnGetActiveScheme == NULL) ||
+        (rtTuneInstance_l.pfnGetActiveScheme(NULL, &pScheme) != ERROR_SUCCESS))
+        return kRtTuneStateNotSupported;
+
+    state = kRtTuneStateNeedsTuning;
+    if (memcmp(pScheme, &guidHighPerformance_l, sizeof(GUID)) == 0)
+    {
+        strcpy(pszValue_p, "high performance");
+        state = kRtTuneStateOk;
+    }
+    else if (memcmp(pScheme, &guidBalanced_l, sizeof(GUID)) == 0)
+    {
+        strcpy(pszValue_p, "balanced");
+    }
+    else if (memcmp(pScheme, &guidPowerSaver_l, sizeof(GUID)) == 0)
+    {
+        strcpy(pszValue_p, "power saver");
+    }
+    else
+    {
+        strcpy(pszValue_p, "custom");
+    }
+
+    LocalFree(pScheme);
+    return state;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Activate the high performance power scheme
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyPowerScheme(void)
+{
+    if ((rtTuneInstance_l.pfnSetActiveScheme == NULL) ||
+        (rtTuneInstance_l.pfnSetActiveScheme(NULL, &guidHighPerformance_l) != ERROR_SUCCESS))
+        return kRtTuneResultFailed;
+
+    return kRtTuneResultApplied;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the processor idle states
+
+The idle states are disabled by a setting of the active power scheme. With
+disabled idle states, the processors don't enter the deep C-states, which
+take long to leave.
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkIdleStates(char* pszValue_p)
+{
+    GUID*               pScheme;
+    DWORD               value;
+    DWORD               ret;
+
+    if ((rtTuneInstance_l.pfnGetActiveScheme == NULL) || (rtTuneInstance_l.pfnReadAcValue == NULL) ||
+        (rtTuneInstance_l.pfnGetActiveScheme(NULL, &pScheme) != ERROR_SUCCESS))
+        return kRtTuneStateNotSupported;
+
+    ret = rtTuneInstance_l.pfnReadAcValue(NULL, pScheme, &guidProcessorSettings_l,
+                                          &guidProcessorIdleDisable_l, &value);
+    LocalFree(pScheme);
+    if (ret != ERROR_SUCCESS)
+        return kRtTuneStateNotSupported;
+
+    strcpy(pszValue_p, (value != 0) ? "disabled" : "enabled");
+    return (value != 0) ? kRtTuneStateOk : kRtTuneStateNeedsTuning;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Disable the processor idle states
+
+The setting is written to the active power scheme, which is activated again
+to make it effective.
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyIdleStates(void)
+{
+    GUID*               pScheme;
+    tRtTuneResult       result = kRtTuneResultFailed;
+
+    if ((rtTuneInstance_l.pfnGetActiveScheme == NULL) || (rtTuneInstance_l.pfnWriteAcValue == NULL) ||
+        (rtTuneInstance_l.pfnSetActiveScheme == NULL) ||
+        (rtTuneInstance_l.pfnGetActiveScheme(NULL, &pScheme) != ERROR_SUCCESS))
+        return kRtTuneResultFailed;
+
+    if ((rtTuneInstance_l.pfnWriteAcValue(NULL, pScheme, &guidProcessorSettings_l,
+                                          &guidProcessorIdleDisable_l, 1) == ERROR_SUCCESS) &&
+        (rtTuneInstance_l.pfnSetActiveScheme(NULL, pScheme) == ERROR_SUCCESS))
+        result = kRtTuneResultApplied;
+
+    LocalFree(pScheme);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the system timer resolution
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkTimerResolution(char* pszValue_p)
+{
+    ULONG               coarsest;
+    ULONG               finest;
+    ULONG               current;
+
+    if ((rtTuneInstance_l.pfnQueryTimerResolution == NULL) ||
+        (rtTuneInstance_l.pfnQueryTimerResolution(&coarsest, &finest, &current) != 0))
+        return kRtTuneStateNotSupported;
+
+    // the resolution is given in 100 ns units, the finest has the lowest value
+    if (coarsest < finest)
+        finest = coarsest;
+
+    sprintf(pszValue_p, "%.1f ms", (double)current / 10000.0);
+    return (current <= finest) ? kRtTuneStateOk : kRtTuneStateNeedsTuning;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Request the finest system timer resolution
+
+The request is held until the process terminates.
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyTimerResolution(void)
+{
+    ULONG               coarsest;
+    ULONG               finest;
+    ULONG               current;
+
+    if ((rtTuneInstance_l.pfnQueryTimerResolution == NULL) ||
+        (rtTuneInstance_l.pfnSetTimerResolution == NULL) ||
+        (rtTuneInstance_l.pfnQueryTimerResolution(&coarsest, &finest, &current) != 0))
+        return kRtTuneResultFailed;
+
+    if (coarsest < finest)
+        finest = coarsest;
+
+    if (rtTuneInstance_l.pfnSetTimerResolution(finest, TRUE, &current) != 0)
+        return kRtTuneResultFailed;
+
+    return kRtTuneResultApplied;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the priority class of the process
+
+Without the privilege to increase the scheduling priority, Windows silently
+uses the high priority class instead of the realtime class.
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkPriorityClass(char* pszValue_p)
+{
+    DWORD               priorityClass;
+
+    priorityClass = GetPriorityClass(GetCurrentProcess());
+    switch (priorityClass)
+    {
+        case REALTIME_PRIORITY_CLASS:
+            strcpy(pszValue_p, "realtime");
+            return kRtTuneStateOk;
+
+        case HIGH_PRIORITY_CLASS:
+            strcpy(pszValue_p, "high");
+            break;
+
+        case NORMAL_PRIORITY_CLASS:
+            strcpy(pszValue_p, "normal");
+            break;
+
+        default:
+            sprintf(pszValue_p, "0x%lx", (ULONG)priorityClass);
+            break;
+    }
+
+    return kRtTuneStateNeedsTuning;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Activate the realtime priority class
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyPriorityClass(void)
+{
+    if (!SetPriorityClass(GetCurrentProcess(), REALTIME_PRIORITY_CLASS) ||
+        (GetPriorityClass(GetCurrentProcess()) != REALTIME_PRIORITY_CLASS))
+        return kRtTuneResultFailed;
+
+    return kRtTuneResultApplied;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the power throttling of the process
+
+With power throttling, the system may run the process on efficient cores with
+lower clock rates and ignore its timer resolution requests.
+
+\param  pszValue_p          Buffer for the current value.
+
+\return The function returns the state of the setting.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneState checkPowerThrottling(char* pszValue_p)
+{
+    tRtTuneThrottling   throttling;
+
+    if (rtTuneInstance_l.pfnSetProcessInfo == NULL)
+        return kRtTuneStateNotSupported;
+
+    // the state can only be read on newer versions, it is left to the system by default
+    memset(&throttling, 0, sizeof(throttling));
+    throttling.version = RTTUNE_THROTTLING_VERSION;
+    if ((rtTuneInstance_l.pfnGetProcessInfo == NULL) ||
+        !rtTuneInstance_l.pfnGetProcessInfo(GetCurrentProcess(), RTTUNE_PROCESS_POWER_THROTTLING,
+                                            &throttling, sizeof(throttling)))
+    {
+        strcpy(pszValue_p, "system default");
+        return kRtTuneStateNeedsTuning;
+    }
+
+    if ((throttling.controlMask & RTTUNE_THROTTLING_MASK) != RTTUNE_THROTTLING_MASK)
+    {
+        strcpy(pszValue_p, "system default");
+        return kRtTuneStateNeedsTuning;
+    }
+
+    strcpy(pszValue_p, ((throttling.stateMask & RTTUNE_THROTTLING_MASK) != 0) ? "on" : "off");
+    return ((throttling.stateMask & RTTUNE_THROTTLING_MASK) != 0) ? kRtTuneStateNeedsTuning :
+                                                                     kRtTuneStateOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Disable the power throttling of the process
+
+\return The function returns the result of the change.
+*/
+//------------------------------------------------------------------------------
+static tRtTuneResult applyPowerThrottling(void)
+{
+    tRtTuneThrottling   throttling;
+
+    if (rtTuneInstance_l.pfnSetProcessInfo == NULL)
+        return kRtTuneResultFailed;
+
+    throttling.version = RTTUNE_THROTTLING_VERSION;
+    throttling.controlMask = RTTUNE_THROTTLING_MASK;
+    throttling.stateMask = 0;
+    if (!rtTuneInstance_l.pfnSetProcessInfo(GetCurrentProcess(), RTTUNE_PROCESS_POWER_THROTTLING,
+                                            &throttling, sizeof(throttling)))
+        return kRtTuneResultFailed;
+
+    return kRtTuneResultApplied;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Inspect or disable the interrupt moderation
+
+The function walks the driver keys of the network adapter class and looks for
+the adapter of the POWERLINK interface by its NetCfgInstanceId. It evaluates
+the standardized interrupt moderation keyword of that adapter only. The keys
+can only be written with administrator rights.
+
+\param  fDisable_p          Disable the interrupt moderation if it is enabled.
+\param  pfEnabled_p         Returns whether the interrupt moderation is enabled.
+
+\return The function returns 0 if the adapter supports the interrupt moderation
+        and the change could be written, otherwise -1.
+*/
+//------------------------------------------------------------------------------
+static int processModeration(BOOL fDisable_p, BOOL* pfEnabled_p)
+{
+    HKEY                hClass;
+    HKEY                hAdapter;
+    char                aName[64];
+    char                aInstanceId[64];
+    char                aValue[8];
+    DWORD               size;
+    DWORD               type;
+    DWORD               index;
+    REGSAM              access;
+    int                 ret = -1;
+
+    *pfEnabled_p = FALSE;
+
+    if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, RTTUNE_NIC_CLASS_KEY, 0, KEY_READ, &hClass) != ERROR_SUCCESS)
+        return -1;
+
+    access = KEY_QUERY_VALUE | (fDisable_p ? KEY_SET_VALUE : 0);
+    for (index = 0; ; index++)
+    {
+        size = sizeof(aName);
+        if (RegEnumKeyExA(hClass, index, aName, &size, NULL, NULL, NULL, NULL) != ERROR_SUCCESS)
+            break;
+
+        // some subkeys are not accessible, they don't describe adapters
+        if (RegOpenKeyExA(hClass, aName, 0, KEY_QUERY_VALUE, &hAdapter) != ERROR_SUCCESS)
+            continue;
+
+        size = sizeof(aInstanceId) - 1;
+        if ((RegQueryValueExA(hAdapter, RTTUNE_NIC_INSTANCE_ID, NULL, &type, (LPBYTE)aInstanceId,
+                              &size) != ERROR_SUCCESS) || (type != REG_SZ))
+        {
+            RegCloseKey(hAdapter);
+            continue;
+        }
+
+        aInstanceId[size] = '\0';
+        if (!matchInterface(aInstanceId))
+        {
+            RegCloseKey(hAdapter);
+            continue;
+        }
+
+        // the adapter is found, the remaining keys need not be searched
+        size = sizeof(aValue) - 1;
+        if ((RegQueryValueExA(hAdapter, RTTUNE_NIC_MODERATION, NULL, &type, (LPBYTE)aValue,
+                              &size) != ERROR_SUCCESS) || (type != REG_SZ))
+        {
+            RegCloseKey(hAdapter);
+            break;
+        }
+        RegCloseKey(hAdapter);
+
+        aValue[size] = '\0';
+        *pfEnabled_p = (strcmp(aValue, "0") != 0);
+        ret = 0;
+        if (!fDisable_p || !*pfEnabled_p)
+            break;
+
+        if (RegOpenKeyExA(hClass, aName, 0, access, &hAdapter) != ERROR_SUCCESS)
+        {
+            ret = -1;
+            break;
+        }
+
+        if (RegSetValueExA(hAdapter, RTTUNE_NIC_MODERATION, 0, REG_SZ, (const BYTE*)"0", 2) != ERROR_SUCCESS)
+            ret = -1;
+        RegCloseKey(hAdapter);
+        break;
+    }
+
+    RegCloseKey(hClass);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check whether an adapter belongs to the POWERLINK interface
+
+The interface names of pcap ("\\Device\\NPF_{GUID}") and of the network
+configuration contain the NetCfgInstanceId of the adapter, so the ID is
+searched in the interface name. GUIDs are compared case-insensitively.
+
+\param  pszInstanceId_p     NetCfgInstanceId of the adapter.
+
+\return The function returns TRUE if the adapter belongs to the interface.
+*/
+//------------------------------------------------------------------------------
+static BOOL matchInterface(const char* pszInstanceId_p)
+{
+    const char*         pszIfName = rtTuneInstance_l.pszIfName;
+    size_t              idLen = strlen(pszInstanceId_p);
+
+    if (idLen == 0)
+        return FALSE;
+
+    for (; strlen(pszIfName) >= idLen; pszIfName++)
+    {
+        if (_strnicmp(pszIfName, pszInstanceId_p, idLen) == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/// \}
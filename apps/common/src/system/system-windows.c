@@ -42,6 +42,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // includes
 //------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+
 #define _WIN32_WINNT 0x0501     // Windows version must be at least Windows XP
 #define WIN32_LEAN_AND_MEAN     // Do not use extended Win32 API functions
 #include <Windows.h>
@@ -72,10 +75,89 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION   0x00000002
+#endif
+
+#define FILEWATCH_BUFFER_SIZE   4096        // size of the change notification buffer
+
+#define SYSTEM_PROCESS_INFORMATION_CLASS    5           // SystemProcessInformation
+#define STATUS_INFO_LENGTH_MISMATCH         0xC0000004L // buffer of NtQuerySystemInformation() too small
+#define PROCINFO_BUFFER_SIZE                0x40000     // initial size of the process information buffer
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+typedef HANDLE (WINAPI* tCreateWaitableTimerExW)(LPSECURITY_ATTRIBUTES pAttr_p, LPCWSTR pName_p,
+                                                 DWORD flags_p, DWORD access_p);
+typedef BOOL (WINAPI* tQueryThreadCycleTime)(HANDLE hThread_p, PULONG64 pCycles_p);
+typedef DWORD (WINAPI* tGetCurrentProcessorNumber)(void);
+typedef LONG (NTAPI* tNtQuerySystemInformation)(ULONG class_p, PVOID pInfo_p, ULONG size_p,
+                                                PULONG pReturnSize_p);
+
+/**
+\brief  Thread information of NtQuerySystemInformation()
+
+The structure describes a thread in the result of
+NtQuerySystemInformation(SystemProcessInformation).
+*/
+typedef struct
+{
+    LARGE_INTEGER   kernelTime;             ///< CPU time in kernel mode [100 ns]
+    LARGE_INTEGER   userTime;               ///< CPU time in user mode [100 ns]
+    LARGE_INTEGER   createTime;             ///< Creation time of the thread
+    ULONG           waitTime;               ///< Tick count when the thread started waiting
+    PVOID           pStartAddress;          ///< Start address of the thread
+    HANDLE          uniqueProcess;          ///< ID of the process
+    HANDLE          uniqueThread;           ///< ID of the thread
+    LONG            priority;               ///< Current priority
+    LONG            basePriority;           ///< Base priority
+    ULONG           contextSwitches;        ///< Number of context switches
+    ULONG           threadState;            ///< Scheduling state
+    ULONG           waitReason;             ///< Reason of the current wait
+} tNtThreadInfo;
+
+/**
+\brief  Process information of NtQuerySystemInformation()
+
+The structure describes a process in the result of
+NtQuerySystemInformation(SystemProcessInformation). The thread information
+follows the structure.
+*/
+typedef struct
+{
+    ULONG           nextEntryOffset;        ///< Offset of the next process (0 = last)
+    ULONG           numberOfThreads;        ///< Number of threads of the process
+    BYTE            aReserved1[48];         ///< Process times and counters
+    USHORT          imageNameLength;        ///< Length of the image name [bytes]
+    USHORT          imageNameMaxLength;     ///< Size of the image name buffer [bytes]
+    PWSTR           pImageName;             ///< Image name
+    LONG            basePriority;           ///< Base priority of the process
+    HANDLE          uniqueProcessId;        ///< ID of the process
+    HANDLE          inheritedFromProcessId; ///< ID of the parent process
+    ULONG           handleCount;            ///< Number of handles
+    ULONG           sessionId;              ///< Session of the process
+    ULONG_PTR       uniqueProcessKey;       ///< Reserved
+    SIZE_T          aReserved2[12];         ///< Memory counters and private pages
+    LARGE_INTEGER   aReserved3[6];          ///< I/O counters
+} tNtProcessInfo;
+
+/**
+\brief  File watch state
+
+The structure contains the state of a file watch. The directory of the file is
+watched with an overlapped ReadDirectoryChangesW() call, whose notifications
+are filtered for the name of the file.
+*/
+typedef struct
+{
+    HANDLE          hDir;                   ///< Handle of the watched directory
+    OVERLAPPED      overlapped;             ///< Overlapped structure of the pending read
+    BOOL            fPending;               ///< A read of change notifications is pending
+    WCHAR           aFileName[MAX_PATH];    ///< Name of the watched file
+    DWORD           aBuffer[FILEWATCH_BUFFER_SIZE / sizeof(DWORD)]; ///< Change notifications
+} tFileWatch;
+
 #if defined(CONFIG_USE_SYNCTHREAD)
 /**
 \brief  Local instance for synchronization thread
@@ -96,6 +178,10 @@ typedef struct
 #if defined(CONFIG_USE_SYNCTHREAD)
 static tSyncThreadInstance syncThreadInstance_l;
 #endif
+static LARGE_INTEGER       perfFrequency_l;
+static tQueryThreadCycleTime        pfnQueryThreadCycleTime_l;
+static tGetCurrentProcessorNumber   pfnGetCurrentProcessorNumber_l;
+static tNtQuerySystemInformation    pfnNtQuerySystemInformation_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -103,6 +189,10 @@ static tSyncThreadInstance syncThreadInstance_l;
 #if defined(CONFIG_USE_SYNCTHREAD)
 static DWORD WINAPI syncThread(LPVOID pArg_p);
 #endif
+static DWORD WINAPI threadRoutine(LPVOID pArg_p);
+static int          startFileWatch(tFileWatch* pWatch_p);
+static void         getSwitchCounts(const tSystemThreadRef* aRef_p, UINT count_p,
+                                    tSystemThreadStats* aStats_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -128,6 +218,17 @@ int system_init(void)
     // lower the priority of this thread
     SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
 
+    // the performance counter frequency is fixed at system boot
+    QueryPerformanceFrequency(&perfFrequency_l);
+
+    // the thread statistics functions are not available on all Windows versions
+    pfnQueryThreadCycleTime_l = (tQueryThreadCycleTime)GetProcAddress(GetModuleHandleA("kernel32.dll"),
+                                                                      "QueryThreadCycleTime");
+    pfnGetCurrentProcessorNumber_l = (tGetCurrentProcessorNumber)GetProcAddress(GetModuleHandleA("kernel32.dll"),
+                                                                                "GetCurrentProcessorNumber");
+    pfnNtQuerySystemInformation_l = (tNtQuerySystemInformation)GetProcAddress(GetModuleHandleA("ntdll.dll"),
+                                                                              "NtQuerySystemInformation");
+
 #if defined(CONFIG_USE_SYNCTHREAD)
     syncThreadInstance_l.fThreadExit = FALSE;
 #endif
@@ -183,6 +284,704 @@ void system_msleep(unsigned int milliSeconds_p)
     Sleep(milliSeconds_p);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get current time in nanoseconds
+
+The function returns the value of a monotonic high resolution clock in
+nanoseconds. The clock is derived from the performance counter, therefore
+time stamps taken by different threads and processes on the same host are
+comparable. The resolution depends on the performance counter frequency.
+
+\return The function returns the current time in nanoseconds.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+UINT64 system_getTimeNs(void)
+{
+    LARGE_INTEGER   counter;
+
+    if (perfFrequency_l.QuadPart == 0)
+        QueryPerformanceFrequency(&perfFrequency_l);
+
+    QueryPerformanceCounter(&counter);
+
+    // split the conversion to avoid an overflow of the intermediate result
+    return ((UINT64)(counter.QuadPart / perfFrequency_l.QuadPart) * 1000000000ULL) +
+           (((UINT64)(counter.QuadPart % perfFrequency_l.QuadPart) * 1000000000ULL) /
+            (UINT64)perfFrequency_l.QuadPart);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the wall clock time in nanoseconds
+
+The function returns the system time in nanoseconds since 1970-01-01 UTC.
+Unlike system_getTimeNs(), the time may jump when the clock is adjusted. The
+resolution is 100 ns, the accuracy depends on the system clock.
+
+\return The function returns the wall clock time in nanoseconds.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+UINT64 system_getWallTimeNs(void)
+{
+    FILETIME        fileTime;
+    ULARGE_INTEGER  time;
+
+    GetSystemTimeAsFileTime(&fileTime);
+    time.LowPart = fileTime.dwLowDateTime;
+    time.HighPart = fileTime.dwHighDateTime;
+
+    // file time counts 100 ns intervals since 1601-01-01
+    return (time.QuadPart - 116444736000000000ULL) * 100ULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Issue a full memory barrier
+
+The function orders all memory accesses issued before the barrier against all
+accesses issued after it. It is used by the lock-free data exchange between
+the threads and processes of the demo applications.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_memoryBarrier(void)
+{
+    MemoryBarrier();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a named shared memory region
+
+The function opens the named shared memory region with the given size. If the
+region does not yet exist, it is created and initialized with zero. The region
+is mapped into the address space of the calling process.
+
+\param  pName_p             Name of the shared memory region
+\param  size_p              Size of the shared memory region in bytes
+\param  pShm_p              Pointer to the shared memory descriptor to fill
+
+\return The function returns 0 if the region could be opened, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_openSharedMem(const char* pName_p, size_t size_p, tSystemSharedMem* pShm_p)
+{
+    HANDLE      hMapping;
+    void*       pBase;
+
+    hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE,     // Use the paging file
+                                  NULL,                     // Default security attributes
+                                  PAGE_READWRITE,
+                                  (DWORD)((UINT64)size_p >> 32),
+                                  (DWORD)size_p,
+                                  pName_p);
+    if (hMapping == NULL)
+        return -1;
+
+    pBase = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size_p);
+    if (pBase == NULL)
+    {
+        CloseHandle(hMapping);
+        return -1;
+    }
+
+    pShm_p->pHandle = hMapping;
+    pShm_p->pBase = pBase;
+    pShm_p->size = size_p;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a shared memory region
+
+The function unmaps the shared memory region from the address space of the
+calling process. The region is destroyed by the system if no other process
+has mapped it.
+
+\param  pShm_p              Pointer to the shared memory descriptor
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_closeSharedMem(tSystemSharedMem* pShm_p)
+{
+    if (pShm_p->pBase != NULL)
+        UnmapViewOfFile(pShm_p->pBase);
+
+    if (pShm_p->pHandle != NULL)
+        CloseHandle((HANDLE)pShm_p->pHandle);
+
+    pShm_p->pBase = NULL;
+    pShm_p->pHandle = NULL;
+    pShm_p->size = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Map a file
+
+The function maps a whole file read-only into the address space of the
+calling process. The pages are read by the system when they are accessed, so
+large files can be processed without reading them into memory.
+
+\param  pPath_p             Path of the file
+\param  pFile_p             Pointer to the mapped file descriptor to fill
+
+\return The function returns 0 if the file could be mapped, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_mapFile(const char* pPath_p, tSystemMappedFile* pFile_p)
+{
+    HANDLE          hFile;
+    HANDLE          hMapping;
+    LARGE_INTEGER   size;
+    void*           pBase;
+
+    memset(pFile_p, 0, sizeof(tSystemMappedFile));
+
+    hFile = CreateFileA(pPath_p, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                        FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return -1;
+
+    // an empty file cannot be mapped and a view must fit into the address space
+    if (!GetFileSizeEx(hFile, &size) || (size.QuadPart == 0) ||
+        ((UINT64)size.QuadPart > (SIZE_T)-1))
+    {
+        CloseHandle(hFile);
+        return -1;
+    }
+
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL)
+    {
+        CloseHandle(hFile);
+        return -1;
+    }
+
+    pBase = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (pBase == NULL)
+    {
+        CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return -1;
+    }
+
+    pFile_p->pFileHandle = hFile;
+    pFile_p->pMapHandle = hMapping;
+    pFile_p->pBase = pBase;
+    pFile_p->size = (UINT64)size.QuadPart;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Unmap a file
+
+The function unmaps a file mapped with system_mapFile().
+
+\param  pFile_p             Pointer to the mapped file descriptor
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_unmapFile(tSystemMappedFile* pFile_p)
+{
+    if (pFile_p->pBase != NULL)
+        UnmapViewOfFile(pFile_p->pBase);
+
+    if (pFile_p->pMapHandle != NULL)
+        CloseHandle((HANDLE)pFile_p->pMapHandle);
+
+    if (pFile_p->pFileHandle != NULL)
+        CloseHandle((HANDLE)pFile_p->pFileHandle);
+
+    memset(pFile_p, 0, sizeof(tSystemMappedFile));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Create a thread
+
+The function creates a thread which executes the given routine. The thread
+descriptor must remain valid until the thread has been joined with
+system_joinThread().
+
+\param  pfnThread_p         Thread routine
+\param  pArg_p              Argument passed to the thread routine
+\param  pThread_p           Pointer to the thread descriptor to fill
+
+\return The function returns 0 if the thread could be created, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_createThread(tSystemThreadCb pfnThread_p, void* pArg_p, tSystemThread* pThread_p)
+{
+    pThread_p->pfnThread = pfnThread_p;
+    pThread_p->pArg = pArg_p;
+    pThread_p->pHandle = CreateThread(NULL,             // Default security attributes
+                                      0,                // Use Default stack size
+                                      threadRoutine,    // Thread routine
+                                      pThread_p,        // Argument to the thread routine
+                                      0,                // Use default creation flags
+                                      NULL              // Returned thread Id
+                                      );
+
+    return (pThread_p->pHandle != NULL) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Join a thread
+
+The function waits until the thread has terminated and frees its resources.
+
+\param  pThread_p           Pointer to the thread descriptor
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_joinThread(tSystemThread* pThread_p)
+{
+    if (pThread_p->pHandle == NULL)
+        return;
+
+    WaitForSingleObject((HANDLE)pThread_p->pHandle, INFINITE);
+    CloseHandle((HANDLE)pThread_p->pHandle);
+    pThread_p->pHandle = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Bind the calling thread to a CPU
+
+The function restricts the calling thread to one CPU and raises its priority
+to time critical, so a polling thread is not disturbed by other threads.
+
+\param  cpu_p               Number of the CPU
+
+\return The function returns 0 on success, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_setThreadAffinity(UINT cpu_p)
+{
+    if ((cpu_p >= sizeof(DWORD_PTR) * 8) ||
+        (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu_p) == 0))
+        return -1;
+
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a timer
+
+The function creates a timer for periodic waits of the calling thread. The high
+resolution waitable timer is used if the system provides it, otherwise the
+wake-up is bound to the resolution of the system timer tick.
+
+\param  pTimer_p            Pointer to the timer descriptor to fill
+
+\return The function returns 0 if the timer could be created, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_openTimer(tSystemTimer* pTimer_p)
+{
+    tCreateWaitableTimerExW     pfnCreateTimer;
+    HANDLE                      hTimer = NULL;
+
+    // CreateWaitableTimerExW() is not available on Windows XP
+    pfnCreateTimer = (tCreateWaitableTimerExW)GetProcAddress(GetModuleHandleA("kernel32.dll"),
+                                                             "CreateWaitableTimerExW");
+    if (pfnCreateTimer != NULL)
+        hTimer = pfnCreateTimer(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+    if (hTimer == NULL)
+        hTimer = CreateWaitableTimerA(NULL, TRUE, NULL);
+
+    pTimer_p->pHandle = hTimer;
+    return (hTimer != NULL) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for a timer
+
+The function suspends the calling thread until the given time is reached. It
+returns immediately if the time has already passed.
+
+\param  pTimer_p            Pointer to the timer descriptor
+\param  wakeTimeNs_p        Wake-up time in the time base of system_getTimeNs()
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_waitTimer(tSystemTimer* pTimer_p, UINT64 wakeTimeNs_p)
+{
+    LARGE_INTEGER               dueTime;
+    UINT64                      now;
+
+    now = system_getTimeNs();
+    if (wakeTimeNs_p <= now)
+        return;
+
+    // a negative due time is relative and given in 100 ns units
+    dueTime.QuadPart = -(LONGLONG)((wakeTimeNs_p - now + 99) / 100);
+    if (SetWaitableTimer((HANDLE)pTimer_p->pHandle, &dueTime, 0, NULL, NULL, FALSE))
+        WaitForSingleObject((HANDLE)pTimer_p->pHandle, INFINITE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a timer
+
+The function frees a timer created with system_openTimer().
+
+\param  pTimer_p            Pointer to the timer descriptor
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_closeTimer(tSystemTimer* pTimer_p)
+{
+    if (pTimer_p->pHandle != NULL)
+        CloseHandle((HANDLE)pTimer_p->pHandle);
+
+    pTimer_p->pHandle = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a file watch
+
+The function starts watching the given file for changes. Changes are detected
+on the directory of the file, so files which are replaced by renaming a new
+version (as many editors do) are detected as well. The watch must be used and
+closed by the thread which opened it.
+
+\param  pPath_p             Path of the file to watch
+\param  pWatch_p            Pointer to the file watch descriptor to fill
+
+\return The function returns 0 if the watch could be started, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_openFileWatch(const char* pPath_p, tSystemFileWatch* pWatch_p)
+{
+    tFileWatch*     pWatch;
+    char            aDir[MAX_PATH];
+    const char*     pName;
+    size_t          dirLen;
+
+    pWatch_p->pHandle = NULL;
+
+    pName = pPath_p + strlen(pPath_p);
+    while ((pName > pPath_p) && (pName[-1] != '\\') && (pName[-1] != '/') && (pName[-1] != ':'))
+        pName--;
+
+    dirLen = (size_t)(pName - pPath_p);
+    if ((*pName == '\0') || (dirLen >= sizeof(aDir)))
+        return -1;
+
+    if (dirLen == 0)
+    {
+        strcpy(aDir, ".");
+    }
+    else
+    {
+        memcpy(aDir, pPath_p, dirLen);
+        aDir[dirLen] = '\0';
+    }
+
+    pWatch = (tFileWatch*)calloc(1, sizeof(tFileWatch));
+    if (pWatch == NULL)
+        return -1;
+
+    pWatch_p->pHandle = pWatch;
+    pWatch->hDir = CreateFileA(aDir, FILE_LIST_DIRECTORY,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                               OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    pWatch->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+    if ((pWatch->hDir == INVALID_HANDLE_VALUE) || (pWatch->overlapped.hEvent == NULL) ||
+        (MultiByteToWideChar(CP_ACP, 0, pName, -1, pWatch->aFileName, MAX_PATH) == 0) ||
+        (startFileWatch(pWatch) != 0))
+    {
+        system_closeFileWatch(pWatch_p);
+        return -1;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for a change of a watched file
+
+The function waits until the watched file is changed, created, renamed or
+deleted. Editors usually write a file in several steps, so a single save may
+be reported more than once.
+
+\param  pWatch_p            Pointer to the file watch descriptor
+\param  timeoutMs_p         Maximum time to wait [ms]
+
+\return The function returns 1 if the file has changed, 0 if the timeout has
+        expired or only other files have changed, and -1 on error.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_waitFileWatch(tSystemFileWatch* pWatch_p, UINT timeoutMs_p)
+{
+    tFileWatch*                 pWatch = (tFileWatch*)pWatch_p->pHandle;
+    FILE_NOTIFY_INFORMATION*    pInfo;
+    WCHAR                       aName[MAX_PATH];
+    DWORD                       size;
+    DWORD                       nameLen;
+    DWORD                       waitRet;
+    int                         fChanged = 0;
+
+    if (pWatch == NULL)
+        return -1;
+
+    waitRet = WaitForSingleObject(pWatch->overlapped.hEvent, timeoutMs_p);
+    if (waitRet == WAIT_TIMEOUT)
+        return 0;
+
+    pWatch->fPending = FALSE;
+    if ((waitRet != WAIT_OBJECT_0) ||
+        !GetOverlappedResult(pWatch->hDir, &pWatch->overlapped, &size, FALSE))
+        return -1;
+
+    if (size == 0)
+    {
+        // the notification buffer overflowed, the file may have changed
+        fChanged = 1;
+    }
+    else
+    {
+        pInfo = (FILE_NOTIFY_INFORMATION*)pWatch->aBuffer;
+        for (;;)
+        {
+            nameLen = pInfo->FileNameLength / sizeof(WCHAR);
+            if (nameLen < MAX_PATH)
+            {
+                memcpy(aName, pInfo->FileName, nameLen * sizeof(WCHAR));
+                aName[nameLen] = 0;
+                if (lstrcmpiW(aName, pWatch->aFileName) == 0)
+                    fChanged = 1;
+            }
+
+            if (pInfo->NextEntryOffset == 0)
+                break;
+            pInfo = (FILE_NOTIFY_INFORMATION*)((BYTE*)pInfo + pInfo->NextEntryOffset);
+        }
+    }
+
+    if (startFileWatch(pWatch) != 0)
+        return -1;
+
+    return fChanged;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a file watch
+
+The function stops watching the file and frees the watch.
+
+\param  pWatch_p            Pointer to the file watch descriptor
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_closeFileWatch(tSystemFileWatch* pWatch_p)
+{
+    tFileWatch*     pWatch = (tFileWatch*)pWatch_p->pHandle;
+    DWORD           size;
+
+    if (pWatch == NULL)
+        return;
+
+    if (pWatch->hDir != INVALID_HANDLE_VALUE)
+    {
+        // the buffer must not be freed before the cancelled read has completed
+        if (pWatch->fPending && CancelIo(pWatch->hDir))
+            GetOverlappedResult(pWatch->hDir, &pWatch->overlapped, &size, TRUE);
+        CloseHandle(pWatch->hDir);
+    }
+
+    if (pWatch->overlapped.hEvent != NULL)
+        CloseHandle(pWatch->overlapped.hEvent);
+
+    free(pWatch);
+    pWatch_p->pHandle = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a reference to the calling thread
+
+The function opens a reference to the calling thread, which can be used by
+other threads to query its statistics with system_getThreadStats().
+
+\param  pRef_p              Pointer to the thread reference to fill
+
+\return The function returns 0 if the reference could be opened, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_openThreadRef(tSystemThreadRef* pRef_p)
+{
+    HANDLE      hThread;
+
+    pRef_p->pHandle = NULL;
+    pRef_p->threadId = (UINT32)GetCurrentThreadId();
+
+    // GetCurrentThread() returns a pseudo handle, which is only valid in the
+    // calling thread
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &hThread,
+                         THREAD_QUERY_INFORMATION, FALSE, 0))
+        return -1;
+
+    pRef_p->pHandle = hThread;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a thread reference
+
+\param  pRef_p              Pointer to the thread reference
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void system_closeThreadRef(tSystemThreadRef* pRef_p)
+{
+    if (pRef_p->pHandle != NULL)
+        CloseHandle((HANDLE)pRef_p->pHandle);
+
+    pRef_p->pHandle = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get thread statistics
+
+The function reads the accumulated statistics of the given threads. The CPU
+times are read with GetThreadTimes(), the cycles with QueryThreadCycleTime()
+(Windows Vista and later). The context switches are taken from a single
+NtQuerySystemInformation() snapshot of all threads, so the function is too
+expensive to be called in the cyclic path.
+
+Windows does not distinguish voluntary and involuntary context switches and
+does not count migrations or the time threads wait in the ready state.
+
+\param  aRef_p              Array of thread references
+\param  count_p             Number of threads
+\param  aStats_p            Array to store the statistics of the threads
+
+\return The function returns 0 if the statistics were read, otherwise -1.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_getThreadStats(const tSystemThreadRef* aRef_p, UINT count_p, tSystemThreadStats* aStats_p)
+{
+    FILETIME        createTime;
+    FILETIME        exitTime;
+    FILETIME        kernelTime;
+    FILETIME        userTime;
+    ULONG64         cycles;
+    UINT64          kernelNs;
+    UINT64          userNs;
+    UINT            i;
+    int             ret = 0;
+
+    for (i = 0; i < count_p; i++)
+    {
+        memset(&aStats_p[i], 0, sizeof(tSystemThreadStats));
+        if (aRef_p[i].pHandle == NULL)
+            continue;
+
+        if (GetThreadTimes((HANDLE)aRef_p[i].pHandle, &createTime, &exitTime, &kernelTime, &userTime))
+        {
+            kernelNs = (((UINT64)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime) * 100;
+            userNs = (((UINT64)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime) * 100;
+            aStats_p[i].kernelTimeNs = kernelNs;
+            aStats_p[i].cpuTimeNs = kernelNs + userNs;
+        }
+        else
+        {
+            ret = -1;
+        }
+
+        if ((pfnQueryThreadCycleTime_l != NULL) &&
+            pfnQueryThreadCycleTime_l((HANDLE)aRef_p[i].pHandle, &cycles))
+            aStats_p[i].cycleCount = cycles;
+    }
+
+    getSwitchCounts(aRef_p, count_p, aStats_p);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the ID of the calling thread
+
+\return The function returns the system specific ID of the calling thread.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+UINT32 system_getCurrentThreadId(void)
+{
+    return (UINT32)GetCurrentThreadId();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the processor of the calling thread
+
+The function returns the processor the calling thread is running on. It is
+cheap enough to be called in every cycle.
+
+\return The function returns the number of the processor or -1 if it is not
+        available (before Windows Vista or before system_init()).
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+int system_getCurrentCpu(void)
+{
+    if (pfnGetCurrentProcessorNumber_l == NULL)
+        return -1;
+
+    return (int)pfnGetCurrentProcessorNumber_l();
+}
+
 #if defined(CONFIG_USE_SYNCTHREAD)
 //------------------------------------------------------------------------------
 /**
@@ -275,4 +1074,115 @@ static DWORD WINAPI syncThread(LPVOID pArg_p)
 }
 #endif
 
+//------------------------------------------------------------------------------
+/**
+\brief  Thread routine wrapper
+
+The function calls the routine of a thread created with system_createThread().
+
+\param  pArg_p    Pointer to the thread descriptor
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static DWORD WINAPI threadRoutine(LPVOID pArg_p)
+{
+    tSystemThread*  pThread = (tSystemThread*)pArg_p;
+
+    pThread->pfnThread(pThread->pArg);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start reading change notifications
+
+The function starts an overlapped read of the change notifications of the
+watched directory.
+
+\param  pWatch_p    Pointer to the file watch state
+
+\return The function returns 0 if the read was started, otherwise -1.
+*/
+//------------------------------------------------------------------------------
+static int startFileWatch(tFileWatch* pWatch_p)
+{
+    ResetEvent(pWatch_p->overlapped.hEvent);
+    if (!ReadDirectoryChangesW(pWatch_p->hDir, pWatch_p->aBuffer, sizeof(pWatch_p->aBuffer), FALSE,
+                               FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                               FILE_NOTIFY_CHANGE_LAST_WRITE,
+                               NULL, &pWatch_p->overlapped, NULL))
+        return -1;
+
+    pWatch_p->fPending = TRUE;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the context switch counts of threads
+
+The function reads the context switch counts of the given threads from a
+snapshot of all processes and threads. The buffer is grown until the snapshot
+fits.
+
+\param  aRef_p      Array of thread references
+\param  count_p     Number of threads
+\param  aStats_p    Array to store the statistics of the threads
+*/
+//------------------------------------------------------------------------------
+static void getSwitchCounts(const tSystemThreadRef* aRef_p, UINT count_p,
+                            tSystemThreadStats* aStats_p)
+{
+    BYTE*                   pBuffer = NULL;
+    ULONG                   size = PROCINFO_BUFFER_SIZE;
+    ULONG                   retSize;
+    LONG                    status;
+    const tNtProcessInfo*   pProcess;
+    const tNtThreadInfo*    pThread;
+    HANDLE                  processId = (HANDLE)(ULONG_PTR)GetCurrentProcessId();
+    ULONG                   t;
+    UINT                    i;
+
+    if (pfnNtQuerySystemInformation_l == NULL)
+        return;
+
+    for (;;)
+    {
+        pBuffer = (BYTE*)malloc(size);
+        if (pBuffer == NULL)
+            return;
+
+        status = pfnNtQuerySystemInformation_l(SYSTEM_PROCESS_INFORMATION_CLASS, pBuffer, size, &retSize);
+        if (status != STATUS_INFO_LENGTH_MISMATCH)
+            break;
+
+        free(pBuffer);
+        size = (retSize > size) ? (retSize + PROCINFO_BUFFER_SIZE) : (size * 2);
+    }
+
+    pProcess = (const tNtProcessInfo*)pBuffer;
+    while ((status >= 0) && (pProcess != NULL))
+    {
+        if (pProcess->uniqueProcessId == processId)
+        {
+            pThread = (const tNtThreadInfo*)(pProcess + 1);
+            for (t = 0; t < pProcess->numberOfThreads; t++, pThread++)
+            {
+                for (i = 0; i < count_p; i++)
+                {
+                    if (pThread->uniqueThread == (HANDLE)(ULONG_PTR)aRef_p[i].threadId)
+                        aStats_p[i].switchCount = pThread->contextSwitches;
+                }
+            }
+            break;
+        }
+
+        pProcess = (pProcess->nextEntryOffset == 0) ? NULL :
+                   (const tNtProcessInfo*)((const BYTE*)pProcess + pProcess->nextEntryOffset);
+    }
+
+    free(pBuffer);
+}
+
 /// \}
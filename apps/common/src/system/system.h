@@ -52,6 +52,100 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
+/**
+\brief  Shared memory descriptor
+
+The structure describes a named shared memory region which is mapped into the
+address space of the calling process.
+*/
+typedef struct
+{
+    void*       pHandle;                ///< System specific handle of the shared memory object
+    void*       pBase;                  ///< Base address of the mapped region
+    size_t      size;                   ///< Size of the mapped region
+} tSystemSharedMem;
+
+/**
+\brief  Mapped file descriptor
+
+The structure describes a file which is mapped read-only into the address
+space of the calling process.
+*/
+typedef struct
+{
+    void*       pFileHandle;            ///< System specific handle of the file
+    void*       pMapHandle;             ///< System specific handle of the mapping
+    const void* pBase;                  ///< Base address of the mapped file
+    UINT64      size;                   ///< Size of the file in bytes
+} tSystemMappedFile;
+
+/**
+\brief  Thread routine
+
+The type describes the routine executed by a thread created with
+system_createThread().
+*/
+typedef void (*tSystemThreadCb)(void* pArg_p);
+
+/**
+\brief  Thread descriptor
+
+The structure describes a thread created with system_createThread().
+*/
+typedef struct
+{
+    void*               pHandle;        ///< System specific handle of the thread
+    tSystemThreadCb     pfnThread;      ///< Thread routine
+    void*               pArg;           ///< Argument passed to the thread routine
+} tSystemThread;
+
+/**
+\brief  Timer descriptor
+
+The structure describes a high-resolution timer created with
+system_openTimer().
+*/
+typedef struct
+{
+    void*               pHandle;        ///< System specific handle of the timer
+} tSystemTimer;
+
+/**
+\brief  File watch descriptor
+
+The structure describes a watch for changes of a file created with
+system_openFileWatch().
+*/
+typedef struct
+{
+    void*               pHandle;        ///< System specific watch state
+} tSystemFileWatch;
+
+/**
+\brief  Thread reference
+
+The structure references a thread for querying its statistics. It is opened
+by the thread itself with system_openThreadRef().
+*/
+typedef struct
+{
+    void*               pHandle;        ///< System specific handle of the thread
+    UINT32              threadId;       ///< System specific ID of the thread
+} tSystemThreadRef;
+
+/**
+\brief  Thread statistics
+
+The structure contains the accumulated statistics of a thread. Counters which
+are not provided by the system are 0.
+*/
+typedef struct
+{
+    UINT64              cpuTimeNs;      ///< CPU time in user and kernel mode [ns]
+    UINT64              kernelTimeNs;   ///< CPU time in kernel mode [ns]
+    UINT64              cycleCount;     ///< Consumed CPU cycles
+    UINT64              switchCount;    ///< Number of context switches
+} tSystemThreadStats;
 
 //------------------------------------------------------------------------------
 // function prototypes
@@ -66,6 +160,27 @@ int  system_init(void);
 void system_exit(void);
 BOOL system_getTermSignalState();
 void system_msleep(unsigned int milliSeconds_p);
+UINT64 system_getTimeNs(void);
+UINT64 system_getWallTimeNs(void);
+void system_memoryBarrier(void);
+int  system_openSharedMem(const char* pName_p, size_t size_p, tSystemSharedMem* pShm_p);
+void system_closeSharedMem(tSystemSharedMem* pShm_p);
+int  system_mapFile(const char* pPath_p, tSystemMappedFile* pFile_p);
+void system_unmapFile(tSystemMappedFile* pFile_p);
+int  system_createThread(tSystemThreadCb pfnThread_p, void* pArg_p, tSystemThread* pThread_p);
+void system_joinThread(tSystemThread* pThread_p);
+int  system_setThreadAffinity(UINT cpu_p);
+int  system_openTimer(tSystemTimer* pTimer_p);
+void system_waitTimer(tSystemTimer* pTimer_p, UINT64 wakeTimeNs_p);
+void system_closeTimer(tSystemTimer* pTimer_p);
+int  system_openFileWatch(const char* pPath_p, tSystemFileWatch* pWatch_p);
+int  system_waitFileWatch(tSystemFileWatch* pWatch_p, UINT timeoutMs_p);
+void system_closeFileWatch(tSystemFileWatch* pWatch_p);
+int  system_openThreadRef(tSystemThreadRef* pRef_p);
+void system_closeThreadRef(tSystemThreadRef* pRef_p);
+int  system_getThreadStats(const tSystemThreadRef* aRef_p, UINT count_p, tSystemThreadStats* aStats_p);
+UINT32 system_getCurrentThreadId(void);
+int  system_getCurrentCpu(void);
 
 #if defined(CONFIG_USE_SYNCTHREAD)
 void system_startSyncThread(tSyncCb pfnSync_p);
@@ -0,0 +1,981 @@
+/**
+********************************************************************************
+\file   alarm.c
+
+\brief  Alarm engine of the MN demo application
+
+This file contains the alarm engine of the MN demo application. It monitors
+channels of the process images and reports alarm transitions.
+
+The alarms are read from a configuration file. Every alarm names a channel
+of the process image (see xap.xml) and a condition on its raw value:
+
+    # name     channel                  condition        [options]
+    TempHigh   CN1.M01.AI_00h.Temp      hi 800           hyst=10 delay=500
+    TempDev    CN1.M01.AI_00h.Temp      dev 600 150
+    TempRamp   CN1.M01.AI_00h.Temp      roc 200
+    DriveFault CN1.M02.Statusword       bits 0x0008 0x0008
+
+Conditions:
+- hi LIMIT: value above LIMIT
+- lo LIMIT: value below LIMIT
+- dev REFERENCE BAND: value deviates more than BAND from REFERENCE
+- roc RATE: value changes faster than RATE per second
+- bits MASK PATTERN: the bits of MASK equal PATTERN
+
+Options:
+- hyst=H: an active alarm is only cleared when the value is H inside the limit
+- delay=MS: the condition must hold for MS milliseconds to raise the alarm
+
+The alarms are evaluated incrementally. Every cycle only the 64 bit words of
+the process images which contain monitored channels are compared with their
+values of the previous cycle. Only the alarms of changed words and the alarms
+with a running delay or an active rate condition are evaluated. The states of
+the alarms are kept in bitsets, the transitions are passed to the application
+through a lock-free queue.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "pidesc.h"
+#include "alarm.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ALARM_LINE_LEN          512                     // maximum length of a line in the configuration
+#define ALARM_MAX_WORDS         (2 * ALARM_MAX_ALARMS)  // maximum number of monitored words
+#define ALARM_SET_WORDS         (ALARM_MAX_ALARMS / 64) // size of an alarm bitset
+#define ALARM_WORD_SHIFT        28                      // position of the image in a word key
+
+#define ALARM_BIT(i_p)          ((UINT64)1 << ((i_p) & 63))
+#define ALARM_SET_BIT(set_p, i_p)   ((set_p)[(i_p) >> 6] |= ALARM_BIT(i_p))
+#define ALARM_CLEAR_BIT(set_p, i_p) ((set_p)[(i_p) >> 6] &= ~ALARM_BIT(i_p))
+#define ALARM_TEST_BIT(set_p, i_p)  (((set_p)[(i_p) >> 6] & ALARM_BIT(i_p)) != 0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Alarm conditions
+
+The enumeration lists the conditions of alarms.
+*/
+typedef enum
+{
+    kAlarmCondHigh = 0,                     ///< Value above limit
+    kAlarmCondLow,                          ///< Value below limit
+    kAlarmCondDeviation,                    ///< Value outside a band around a reference
+    kAlarmCondRate,                         ///< Value changes too fast
+    kAlarmCondBits                          ///< Bit pattern
+} tAlarmCond;
+
+/**
+\brief  Alarm engine
+
+The structure contains the alarm engine. The parameters and states of the
+alarms are stored in separate arrays, the alarm states in bitsets.
+
+The monitored words of the process images are sorted by image and offset.
+The alarms of word i are listed in aWordAlarm[aWordStart[i]] to
+aWordAlarm[aWordStart[i + 1] - 1].
+*/
+typedef struct
+{
+    char            aName[ALARM_MAX_ALARMS][ALARM_NAME_LEN];    ///< Alarm names
+    UINT8           aCond[ALARM_MAX_ALARMS];        ///< Conditions (tAlarmCond)
+    UINT8           aImage[ALARM_MAX_ALARMS];       ///< Process images of the channels
+    UINT8           aType[ALARM_MAX_ALARMS];        ///< Data types of the channels (tPiDescType)
+    UINT8           aSize[ALARM_MAX_ALARMS];        ///< Sizes of the channels [bytes]
+    UINT            aOffset[ALARM_MAX_ALARMS];      ///< Offsets of the channels [bytes]
+    double          aLimit[ALARM_MAX_ALARMS];       ///< Limits, references or rates
+    double          aBand[ALARM_MAX_ALARMS];        ///< Deviation bands
+    double          aHyst[ALARM_MAX_ALARMS];        ///< Hystereses
+    UINT64          aMask[ALARM_MAX_ALARMS];        ///< Bit masks
+    UINT64          aPattern[ALARM_MAX_ALARMS];     ///< Bit patterns
+    UINT            aDelay[ALARM_MAX_ALARMS];       ///< Delays [cycles]
+    UINT            aDelayCount[ALARM_MAX_ALARMS];  ///< Cycles the condition holds
+    double          aValue[ALARM_MAX_ALARMS];       ///< Values of the last evaluation
+    UINT32          aValueCycle[ALARM_MAX_ALARMS];  ///< Cycles of the last evaluation
+    UINT64          aActive[ALARM_SET_WORDS];       ///< Active alarms
+    UINT64          aPending[ALARM_SET_WORDS];      ///< Alarms evaluated in every cycle
+    UINT64          aDirty[ALARM_SET_WORDS];        ///< Alarms to evaluate in the current cycle
+    UINT32          aWordKey[ALARM_MAX_WORDS];      ///< Image and index of the monitored words
+    UINT            aWordLen[ALARM_MAX_WORDS];      ///< Number of valid bytes of the monitored words
+    UINT            aWordStart[ALARM_MAX_WORDS + 1];    ///< First alarm of the monitored words
+    UINT16          aWordAlarm[ALARM_MAX_WORDS];    ///< Alarms of the monitored words
+    UINT64          aShadow[ALARM_MAX_WORDS];       ///< Values of the monitored words
+    UINT64          aChanged[ALARM_MAX_WORDS / 64]; ///< Changed words of the current cycle
+    UINT            alarmCount;                     ///< Number of alarms
+    UINT            wordCount;                      ///< Number of monitored words
+    UINT32          cycle;                          ///< Cycle counter
+    double          cycleTime;                      ///< Cycle time [s]
+    BOOL            fFirstCycle;                    ///< All alarms are evaluated
+    tAlarmEvent     aEvent[ALARM_QUEUE_LEN];        ///< Transition queue
+    volatile UINT   eventReadIndex;                 ///< Next event to read, written by the application
+    volatile UINT   eventWriteIndex;                ///< Next free event, written by alarm_process()
+    UINT            lostEventCount;                 ///< Number of transitions lost on a full queue
+} tAlarmInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tAlarmInstance   alarmInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p);
+static tOplkError buildWordIndex(void);
+static int        compareWordAlarm(const void* pA_p, const void* pB_p);
+static void       detectChanges(tAlarmInstance* pInst_p, const BYTE* const* apImage_p);
+static void       evaluate(tAlarmInstance* pInst_p, UINT alarm_p, const BYTE* const* apImage_p);
+static double     readValue(const BYTE* pData_p, tPiDescType type_p, UINT size_p, UINT64* pRaw_p);
+static void       postEvent(tAlarmInstance* pInst_p, UINT alarm_p, BOOL fActive_p, double value_p);
+static UINT       lowestBit(UINT64 bits_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the alarm engine
+
+The function loads the alarm configuration. The process image description
+must be loaded before.
+
+\param  pszConfigFile_p         File name of the alarm configuration.
+\param  cycleLenUs_p            Cycle length [us].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError alarm_init(const char* pszConfigFile_p, UINT32 cycleLenUs_p)
+{
+    FILE*           pFile;
+    char            aLine[ALARM_LINE_LEN];
+    UINT            lineNo = 0;
+    tOplkError      ret = kErrorOk;
+
+    memset(&alarmInstance_l, 0, sizeof(alarmInstance_l));
+    if (cycleLenUs_p == 0)
+        return kErrorApiInvalidParam;
+
+    alarmInstance_l.cycleTime = (double)cycleLenUs_p / 1000000.0;
+    alarmInstance_l.fFirstCycle = TRUE;
+
+    pFile = fopen(pszConfigFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open alarm configuration %s!\n", pszConfigFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        ret = parseLine(aLine);
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid alarm in line %u of %s!\n", lineNo, pszConfigFile_p);
+        return ret;
+    }
+
+    ret = buildWordIndex();
+    if (ret != kErrorOk)
+        return ret;
+
+    printf("Monitoring %u alarms in %u process image words\n",
+           alarmInstance_l.alarmCount, alarmInstance_l.wordCount);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate the alarms
+
+The function evaluates the alarms whose channels changed in this cycle and
+the alarms which need to be evaluated in every cycle. It is called by the
+synchronous data handler after the input process image is complete.
+
+\param  pPiOut_p                Pointer to the output process image (data
+                                received from the CNs).
+\param  pPiIn_p                 Pointer to the input process image (data
+                                sent to the CNs).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void alarm_process(const BYTE* pPiOut_p, const BYTE* pPiIn_p)
+{
+    tAlarmInstance* pInst = &alarmInstance_l;
+    const BYTE*     apImage[kPiDescImageCount];
+    UINT            setWords = (pInst->alarmCount + 63) / 64;
+    UINT            i;
+    UINT64          bits;
+
+    if (pInst->alarmCount == 0)
+        return;
+
+    apImage[kPiDescImageOut] = pPiOut_p;
+    apImage[kPiDescImageIn] = pPiIn_p;
+    pInst->cycle++;
+
+    detectChanges(pInst, apImage);
+
+    for (i = 0; i < setWords; i++)
+    {
+        bits = pInst->aDirty[i] | pInst->aPending[i];
+        pInst->aDirty[i] = 0;
+
+        while (bits != 0)
+        {
+            evaluate(pInst, i * 64 + lowestBit(bits), apImage);
+            bits &= bits - 1;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the next alarm transition
+
+The function is called by the application thread which consumes the alarm
+transitions.
+
+\param  pEvent_p                Pointer to store the transition.
+
+\return The function returns TRUE if a transition was read.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL alarm_getEvent(tAlarmEvent* pEvent_p)
+{
+    tAlarmInstance* pInst = &alarmInstance_l;
+    UINT            readIndex = pInst->eventReadIndex;
+
+    if (readIndex == pInst->eventWriteIndex)
+        return FALSE;
+
+    system_memoryBarrier();
+    *pEvent_p = pInst->aEvent[readIndex & (ALARM_QUEUE_LEN - 1)];
+    system_memoryBarrier();
+    pInst->eventReadIndex = readIndex + 1;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the name of an alarm
+
+\param  alarm_p                 Index of the alarm.
+
+\return The function returns the name of the alarm.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const char* alarm_getName(UINT alarm_p)
+{
+    if (alarm_p >= alarmInstance_l.alarmCount)
+        return "";
+
+    return alarmInstance_l.aName[alarm_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an alarm is active
+
+\param  alarm_p                 Index of the alarm.
+
+\return The function returns TRUE if the alarm is active.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL alarm_isActive(UINT alarm_p)
+{
+    if (alarm_p >= alarmInstance_l.alarmCount)
+        return FALSE;
+
+    return ALARM_TEST_BIT(alarmInstance_l.aActive, alarm_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the active alarms
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void alarm_printStatus(void)
+{
+    const tAlarmInstance*   pInst = &alarmInstance_l;
+    UINT                    activeCount = 0;
+    UINT                    i;
+
+    if (pInst->alarmCount == 0)
+    {
+        printf("No alarms configured\n");
+        return;
+    }
+
+    printf("Active alarms:\n");
+    for (i = 0; i < pInst->alarmCount; i++)
+    {
+        if (!ALARM_TEST_BIT(pInst->aActive, i))
+            continue;
+
+        printf("  %-16s value %g\n", pInst->aName[i], pInst->aValue[i]);
+        activeCount++;
+    }
+    printf("%u of %u alarms active, %u transitions lost\n",
+           activeCount, pInst->alarmCount, pInst->lostEventCount);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Benchmark the alarm engine
+
+The function measures the evaluation time of the given number of high limit
+alarms, each monitoring its own REAL32 channel. It measures quiet cycles
+without changes and cycles in which 1 % of the channels change and raise or
+clear their alarms. The configuration of the alarm engine is replaced.
+
+\param  alarmCount_p            Number of alarms.
+\param  cycleCount_p            Number of measured cycles of each kind.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void alarm_benchmark(UINT alarmCount_p, UINT cycleCount_p)
+{
+    tAlarmInstance* pInst = &alarmInstance_l;
+    BYTE*           pPiOut;
+    BYTE            piIn[8];
+    float           value;
+    tAlarmEvent     event;
+    UINT            eventCount = 0;
+    UINT            pass;
+    UINT            cycle;
+    UINT            changeCount;
+    UINT            channel = 0;
+    UINT            i;
+    UINT64          start;
+    UINT64          aSumTime[2] = {0, 0};
+    UINT64          aMaxTime[2] = {0, 0};
+    UINT64          time;
+
+    if ((alarmCount_p == 0) || (cycleCount_p == 0))
+        return;
+
+    if (alarmCount_p > ALARM_MAX_ALARMS)
+        alarmCount_p = ALARM_MAX_ALARMS;
+
+    pPiOut = (BYTE*)calloc(alarmCount_p, sizeof(float));
+    if (pPiOut == NULL)
+        return;
+
+    memset(pInst, 0, sizeof(*pInst));
+    memset(piIn, 0, sizeof(piIn));
+    pInst->cycleTime = 1e-3;
+    pInst->fFirstCycle = TRUE;
+
+    for (i = 0; i < alarmCount_p; i++)
+    {
+        sprintf(pInst->aName[i], "bench%u", i);
+        pInst->aCond[i] = kAlarmCondHigh;
+        pInst->aImage[i] = kPiDescImageOut;
+        pInst->aType[i] = kPiDescTypeReal32;
+        pInst->aSize[i] = sizeof(float);
+        pInst->aOffset[i] = i * sizeof(float);
+        pInst->aLimit[i] = 50.0;
+        pInst->aHyst[i] = 5.0;
+    }
+    pInst->alarmCount = alarmCount_p;
+    buildWordIndex();
+    alarm_process(pPiOut, piIn);
+
+    // pass 0: quiet cycles, pass 1: 1 % of the channels change
+    changeCount = (alarmCount_p + 99) / 100;
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (cycle = 0; cycle < cycleCount_p; cycle++)
+        {
+            for (i = 0; (pass == 1) && (i < changeCount); i++)
+            {
+                channel = (channel + 7919) % alarmCount_p;
+                memcpy(&value, &pPiOut[channel * sizeof(float)], sizeof(float));
+                value = (value > 50.0f) ? 10.0f : 60.0f;
+                memcpy(&pPiOut[channel * sizeof(float)], &value, sizeof(float));
+            }
+
+            start = system_getTimeNs();
+            alarm_process(pPiOut, piIn);
+            time = system_getTimeNs() - start;
+
+            aSumTime[pass] += time;
+            if (time > aMaxTime[pass])
+                aMaxTime[pass] = time;
+
+            while (alarm_getEvent(&event))
+                eventCount++;
+        }
+    }
+
+    printf("Alarm engine: %u alarms in %u words\n", alarmCount_p, pInst->wordCount);
+    printf("  Quiet cycles:       avg %lu ns, max %lu ns\n",
+           (ULONG)(aSumTime[0] / cycleCount_p), (ULONG)aMaxTime[0]);
+    printf("  %u changes/cycle: avg %lu ns, max %lu ns, %u transitions, %u lost\n",
+           changeCount, (ULONG)(aSumTime[1] / cycleCount_p), (ULONG)aMaxTime[1],
+           eventCount, pInst->lostEventCount);
+
+    memset(pInst, 0, sizeof(*pInst));
+    free(pPiOut);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a line of the alarm configuration
+
+\param  pLine_p                 Pointer to the line, it is modified.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p)
+{
+    tAlarmInstance*         pInst = &alarmInstance_l;
+    char*                   apToken[16];
+    char*                   pToken;
+    char*                   pComment;
+    char*                   pEnd = "";
+    UINT                    tokenCount = 0;
+    UINT                    alarm = pInst->alarmCount;
+    UINT                    argCount;
+    const tPiDescChannel*   pChannel;
+    tPiDescImage            image;
+    double                  delayMs;
+    UINT                    i;
+
+    pComment = strchr(pLine_p, '#');
+    if (pComment != NULL)
+        *pComment = '\0';
+
+    for (pToken = strtok(pLine_p, " \t\r\n"); pToken != NULL; pToken = strtok(NULL, " \t\r\n"))
+    {
+        if (tokenCount >= 16)
+            return kErrorApiInvalidParam;
+        apToken[tokenCount++] = pToken;
+    }
+
+    if (tokenCount == 0)
+        return kErrorOk;
+    if ((tokenCount < 4) || (strlen(apToken[0]) >= ALARM_NAME_LEN))
+        return kErrorApiInvalidParam;
+    if (alarm >= ALARM_MAX_ALARMS)
+        return kErrorNoResource;
+
+    pChannel = pidesc_findChannel(apToken[1], &image);
+    if (pChannel == NULL)
+    {
+        fprintf(stderr, "Channel %s of alarm %s not found!\n", apToken[1], apToken[0]);
+        return kErrorApiInvalidParam;
+    }
+
+    if ((pChannel->type == kPiDescTypeUnknown) || ((pChannel->offset % 8) != 0) ||
+        ((pChannel->size % 8) != 0) || (pChannel->size > 64))
+    {
+        fprintf(stderr, "Channel %s has an unsupported type or alignment!\n", apToken[1]);
+        return kErrorApiInvalidParam;
+    }
+
+    strncpy(pInst->aName[alarm], apToken[0], ALARM_NAME_LEN - 1);
+    pInst->aImage[alarm] = (UINT8)image;
+    pInst->aType[alarm] = (UINT8)pChannel->type;
+    pInst->aSize[alarm] = (UINT8)(pChannel->size / 8);
+    pInst->aOffset[alarm] = pChannel->offset / 8;
+
+    if ((strcmp(apToken[2], "hi") == 0) || (strcmp(apToken[2], "lo") == 0))
+    {
+        pInst->aCond[alarm] = (apToken[2][0] == 'h') ? kAlarmCondHigh : kAlarmCondLow;
+        pInst->aLimit[alarm] = strtod(apToken[3], &pEnd);
+        argCount = 1;
+    }
+    else if (strcmp(apToken[2], "dev") == 0)
+    {
+        if (tokenCount < 5)
+            return kErrorApiInvalidParam;
+
+        pInst->aCond[alarm] = kAlarmCondDeviation;
+        pInst->aLimit[alarm] = strtod(apToken[3], &pEnd);
+        if (*pEnd == '\0')
+            pInst->aBand[alarm] = strtod(apToken[4], &pEnd);
+        argCount = 2;
+    }
+    else if (strcmp(apToken[2], "roc") == 0)
+    {
+        pInst->aCond[alarm] = kAlarmCondRate;
+        pInst->aLimit[alarm] = strtod(apToken[3], &pEnd);
+        argCount = 1;
+    }
+    else if (strcmp(apToken[2], "bits") == 0)
+    {
+        if (tokenCount < 5)
+            return kErrorApiInvalidParam;
+
+        pInst->aCond[alarm] = kAlarmCondBits;
+        pInst->aMask[alarm] = strtoull(apToken[3], &pEnd, 0);
+        if (*pEnd == '\0')
+            pInst->aPattern[alarm] = strtoull(apToken[4], &pEnd, 0) & pInst->aMask[alarm];
+        argCount = 2;
+    }
+    else
+        return kErrorApiInvalidParam;
+
+    if (*pEnd != '\0')
+        return kErrorApiInvalidParam;
+
+    for (i = 3 + argCount; i < tokenCount; i++)
+    {
+        if (strncmp(apToken[i], "hyst=", 5) == 0)
+        {
+            pInst->aHyst[alarm] = strtod(apToken[i] + 5, &pEnd);
+            if (pInst->aHyst[alarm] < 0.0)
+                return kErrorApiInvalidParam;
+        }
+        else if (strncmp(apToken[i], "delay=", 6) == 0)
+        {
+            delayMs = strtod(apToken[i] + 6, &pEnd);
+            if (delayMs < 0.0)
+                return kErrorApiInvalidParam;
+            pInst->aDelay[alarm] = (UINT)ceil(delayMs / 1000.0 / pInst->cycleTime);
+        }
+        else
+            return kErrorApiInvalidParam;
+
+        if (*pEnd != '\0')
+            return kErrorApiInvalidParam;
+    }
+
+    pInst->alarmCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Build the index of the monitored words
+
+The function collects the process image words covered by the channels of
+the alarms and lists the alarms of every word.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError buildWordIndex(void)
+{
+    tAlarmInstance* pInst = &alarmInstance_l;
+    UINT32*         pPair;
+    UINT            pairCount = 0;
+    UINT            aImageEnd[kPiDescImageCount] = {0, 0};
+    UINT            end;
+    UINT            word;
+    UINT            key;
+    UINT            wordStart;
+    UINT            i;
+
+    // pairs of word key (upper 32 bits) and alarm (lower 32 bits)
+    pPair = (UINT32*)malloc(ALARM_MAX_WORDS * 2 * sizeof(UINT32));
+    if (pPair == NULL)
+        return kErrorNoResource;
+
+    for (i = 0; i < pInst->alarmCount; i++)
+    {
+        end = pInst->aOffset[i] + pInst->aSize[i];
+        if (end > aImageEnd[pInst->aImage[i]])
+            aImageEnd[pInst->aImage[i]] = end;
+
+        for (word = pInst->aOffset[i] / 8; word * 8 < end; word++)
+        {
+            pPair[pairCount * 2] = ((UINT32)pInst->aImage[i] << ALARM_WORD_SHIFT) | word;
+            pPair[pairCount * 2 + 1] = i;
+            pairCount++;
+        }
+    }
+
+    qsort(pPair, pairCount, 2 * sizeof(UINT32), compareWordAlarm);
+
+    pInst->wordCount = 0;
+    for (i = 0; i < pairCount; i++)
+    {
+        key = pPair[i * 2];
+        if ((pInst->wordCount == 0) || (pInst->aWordKey[pInst->wordCount - 1] != key))
+        {
+            wordStart = (key & ((1 << ALARM_WORD_SHIFT) - 1)) * 8;
+            end = aImageEnd[key >> ALARM_WORD_SHIFT];
+            pInst->aWordKey[pInst->wordCount] = key;
+            pInst->aWordLen[pInst->wordCount] = ((end - wordStart) < 8) ? (end - wordStart) : 8;
+            pInst->aWordStart[pInst->wordCount] = i;
+            pInst->wordCount++;
+        }
+        pInst->aWordAlarm[i] = (UINT16)pPair[i * 2 + 1];
+    }
+    pInst->aWordStart[pInst->wordCount] = pairCount;
+
+    free(pPair);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare two word/alarm pairs
+
+\param  pA_p                    Pointer to the first pair.
+\param  pB_p                    Pointer to the second pair.
+
+\return The function returns the order of the pairs for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareWordAlarm(const void* pA_p, const void* pB_p)
+{
+    const UINT32*   pA = (const UINT32*)pA_p;
+    const UINT32*   pB = (const UINT32*)pB_p;
+
+    if (pA[0] != pB[0])
+        return (pA[0] < pB[0]) ? -1 : 1;
+    if (pA[1] != pB[1])
+        return (pA[1] < pB[1]) ? -1 : 1;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Detect the changed words
+
+The function compares the monitored words with their values of the previous
+cycle and marks the alarms of changed words for evaluation.
+
+\param  pInst_p                 Pointer to the alarm engine.
+\param  apImage_p               Pointers to the process images.
+*/
+//------------------------------------------------------------------------------
+static void detectChanges(tAlarmInstance* pInst_p, const BYTE* const* apImage_p)
+{
+    UINT        i;
+    UINT        j;
+    UINT        key;
+    UINT64      value;
+    UINT64      bits;
+    const BYTE* pData;
+
+    memset(pInst_p->aChanged, 0, ((pInst_p->wordCount + 63) / 64) * sizeof(UINT64));
+
+    for (i = 0; i < pInst_p->wordCount; i++)
+    {
+        key = pInst_p->aWordKey[i];
+        pData = apImage_p[key >> ALARM_WORD_SHIFT] + (key & ((1 << ALARM_WORD_SHIFT) - 1)) * 8;
+        if (pInst_p->aWordLen[i] == 8)
+            memcpy(&value, pData, 8);
+        else
+        {
+            // last word of an image
+            value = 0;
+            memcpy(&value, pData, pInst_p->aWordLen[i]);
+        }
+
+        if (pInst_p->fFirstCycle || (value != pInst_p->aShadow[i]))
+        {
+            pInst_p->aShadow[i] = value;
+            ALARM_SET_BIT(pInst_p->aChanged, i);
+        }
+    }
+    pInst_p->fFirstCycle = FALSE;
+
+    for (i = 0; i < (pInst_p->wordCount + 63) / 64; i++)
+    {
+        for (bits = pInst_p->aChanged[i]; bits != 0; bits &= bits - 1)
+        {
+            key = i * 64 + lowestBit(bits);
+            for (j = pInst_p->aWordStart[key]; j < pInst_p->aWordStart[key + 1]; j++)
+                ALARM_SET_BIT(pInst_p->aDirty, pInst_p->aWordAlarm[j]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate an alarm
+
+The function evaluates the condition of an alarm, applies the hysteresis and
+the delay and posts a transition if the state of the alarm changes.
+
+\param  pInst_p                 Pointer to the alarm engine.
+\param  alarm_p                 Index of the alarm.
+\param  apImage_p               Pointers to the process images.
+*/
+//------------------------------------------------------------------------------
+static void evaluate(tAlarmInstance* pInst_p, UINT alarm_p, const BYTE* const* apImage_p)
+{
+    BOOL        fActive = ALARM_TEST_BIT(pInst_p->aActive, alarm_p);
+    BOOL        fCond;
+    BOOL        fPending = FALSE;
+    double      value;
+    double      limit = pInst_p->aLimit[alarm_p];
+    double      hyst = fActive ? pInst_p->aHyst[alarm_p] : 0.0;
+    double      rate;
+    UINT64      raw;
+
+    value = readValue(apImage_p[pInst_p->aImage[alarm_p]] + pInst_p->aOffset[alarm_p],
+                      (tPiDescType)pInst_p->aType[alarm_p], pInst_p->aSize[alarm_p], &raw);
+
+    switch (pInst_p->aCond[alarm_p])
+    {
+        case kAlarmCondHigh:
+            fCond = (value > limit - hyst);
+            break;
+
+        case kAlarmCondLow:
+            fCond = (value < limit + hyst);
+            break;
+
+        case kAlarmCondDeviation:
+            fCond = (fabs(value - limit) > pInst_p->aBand[alarm_p] - hyst);
+            break;
+
+        case kAlarmCondRate:
+            // An alarm is evaluated in every cycle its channel changes. Without
+            // an evaluation the channel was unchanged, so the value of the last
+            // evaluation is also the value of the previous cycle.
+            rate = 0.0;
+            if (pInst_p->aValueCycle[alarm_p] != 0)
+                rate = fabs(value - pInst_p->aValue[alarm_p]) / pInst_p->cycleTime;
+            fCond = (rate > limit - hyst);
+
+            // the rate drops to zero on quiet cycles, so an active alarm is evaluated in every cycle
+            fPending = fActive || fCond;
+            break;
+
+        case kAlarmCondBits:
+            fCond = ((raw & pInst_p->aMask[alarm_p]) == pInst_p->aPattern[alarm_p]);
+            break;
+
+        default:
+            fCond = FALSE;
+            break;
+    }
+
+    pInst_p->aValue[alarm_p] = value;
+    pInst_p->aValueCycle[alarm_p] = pInst_p->cycle;
+
+    if (fCond && !fActive)
+    {
+        if (pInst_p->aDelayCount[alarm_p] >= pInst_p->aDelay[alarm_p])
+        {
+            ALARM_SET_BIT(pInst_p->aActive, alarm_p);
+            postEvent(pInst_p, alarm_p, TRUE, value);
+        }
+        else
+        {
+            // the delay runs without changes of the channel
+            pInst_p->aDelayCount[alarm_p]++;
+            fPending = TRUE;
+        }
+    }
+    else if (!fCond)
+    {
+        pInst_p->aDelayCount[alarm_p] = 0;
+        if (fActive)
+        {
+            ALARM_CLEAR_BIT(pInst_p->aActive, alarm_p);
+            postEvent(pInst_p, alarm_p, FALSE, value);
+        }
+    }
+
+    if (fPending)
+        ALARM_SET_BIT(pInst_p->aPending, alarm_p);
+    else
+        ALARM_CLEAR_BIT(pInst_p->aPending, alarm_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the value of a channel
+
+\param  pData_p                 Pointer to the channel in the process image.
+\param  type_p                  Data type of the channel.
+\param  size_p                  Size of the channel [bytes].
+\param  pRaw_p                  Pointer to store the raw bits of the channel.
+
+\return The function returns the value of the channel.
+*/
+//------------------------------------------------------------------------------
+static double readValue(const BYTE* pData_p, tPiDescType type_p, UINT size_p, UINT64* pRaw_p)
+{
+    UINT64      raw = 0;
+    float       real32;
+    double      real64;
+
+    memcpy(&raw, pData_p, size_p);
+    *pRaw_p = raw;
+
+    switch (type_p)
+    {
+        case kPiDescTypeInteger8:
+            return (double)(INT8)raw;
+
+        case kPiDescTypeInteger16:
+            return (double)(INT16)raw;
+
+        case kPiDescTypeInteger32:
+            return (double)(INT32)raw;
+
+        case kPiDescTypeInteger64:
+            return (double)(INT64)raw;
+
+        case kPiDescTypeReal32:
+            memcpy(&real32, pData_p, sizeof(real32));
+            return real32;
+
+        case kPiDescTypeReal64:
+            memcpy(&real64, pData_p, sizeof(real64));
+            return real64;
+
+        default:
+            return (double)raw;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post an alarm transition
+
+\param  pInst_p                 Pointer to the alarm engine.
+\param  alarm_p                 Index of the alarm.
+\param  fActive_p               New state of the alarm.
+\param  value_p                 Value which caused the transition.
+*/
+//------------------------------------------------------------------------------
+static void postEvent(tAlarmInstance* pInst_p, UINT alarm_p, BOOL fActive_p, double value_p)
+{
+    UINT            writeIndex = pInst_p->eventWriteIndex;
+    tAlarmEvent*    pEvent;
+
+    if ((writeIndex - pInst_p->eventReadIndex) >= ALARM_QUEUE_LEN)
+    {
+        pInst_p->lostEventCount++;
+        return;
+    }
+
+    pEvent = &pInst_p->aEvent[writeIndex & (ALARM_QUEUE_LEN - 1)];
+    pEvent->alarm = alarm_p;
+    pEvent->fActive = fActive_p;
+    pEvent->cycle = pInst_p->cycle;
+    pEvent->value = value_p;
+
+    system_memoryBarrier();
+    pInst_p->eventWriteIndex = writeIndex + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the lowest set bit
+
+\param  bits_p                  Bits, must not be zero.
+
+\return The function returns the index of the lowest set bit.
+*/
+//------------------------------------------------------------------------------
+static UINT lowestBit(UINT64 bits_p)
+{
+#if defined(__GNUC__)
+    return (UINT)__builtin_ctzll(bits_p);
+#else
+    UINT    index = 0;
+
+    while ((bits_p & 0xFF) == 0)
+    {
+        bits_p >>= 8;
+        index += 8;
+    }
+    while ((bits_p & 1) == 0)
+    {
+        bits_p >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/// \}
@@ -0,0 +1,90 @@
+/**
+********************************************************************************
+\file   alarm.h
+
+\brief  Definitions for the alarm engine
+
+The file contains the definitions for the alarm engine of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_alarm_H_
+#define _INC_alarm_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ALARM_MAX_ALARMS            8192    ///< Maximum number of alarms (multiple of 64)
+#define ALARM_NAME_LEN              32      ///< Maximum length of an alarm name
+#define ALARM_QUEUE_LEN             1024    ///< Number of queued transitions (power of 2)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Alarm transition
+
+The structure describes the transition of an alarm.
+*/
+typedef struct
+{
+    UINT            alarm;                  ///< Index of the alarm
+    BOOL            fActive;                ///< TRUE if the alarm was raised, FALSE if it was cleared
+    UINT32          cycle;                  ///< Cycle of the transition
+    double          value;                  ///< Value of the channel which caused the transition
+} tAlarmEvent;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError  alarm_init(const char* pszConfigFile_p, UINT32 cycleLenUs_p);
+void        alarm_process(const BYTE* pPiOut_p, const BYTE* pPiIn_p);
+BOOL        alarm_getEvent(tAlarmEvent* pEvent_p);
+const char* alarm_getName(UINT alarm_p);
+BOOL        alarm_isActive(UINT alarm_p);
+void        alarm_printStatus(void);
+void        alarm_benchmark(UINT alarmCount_p, UINT cycleCount_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_alarm_H_ */
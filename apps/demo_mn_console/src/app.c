@@ -44,9 +44,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <oplk/oplk.h>
+#include <console/console.h>
+
+#include <string.h>
 
 #include "app.h"
 #include "xap.h"
+#include "standby.h"
+#include "reinteg.h"
+#include "startup.h"
+#include "iolat.h"
+#include "phase.h"
+#include "mplx.h"
+#include "scale.h"
+#include "pid.h"
+#include "axis.h"
+#include "alarm.h"
+#include "hist.h"
+#include "cyctune.h"
+#include "param.h"
+#include "threadstat.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -87,6 +104,8 @@ typedef struct
     UINT            inputOld;
     UINT            period;
     int             toggle;
+    BOOL            fValid;
+    UINT            refreshCnt;
 } APP_NODE_VAR_T;
 
 //------------------------------------------------------------------------------
@@ -95,13 +114,19 @@ typedef struct
 static int                  usedNodeIds_l[] = {1, 32, 110, 0};
 static UINT                 cnt_l;
 static APP_NODE_VAR_T       nodeVar_l[MAX_NODES];
+static int                  usedNodeCount_l;
+static int                  aNodeIndex_l[MPLX_NODE_COUNT + 1];
 static PI_IN*               pProcessImageIn_l;
 static PI_OUT*              pProcessImageOut_l;
+static BOOL                 fPhasedOutput_l;
+static tOplkError           outputRet_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
 static tOplkError initProcessImage(void);
+static void restoreAppState(const tStandbyState* pState_p);
+static void handoverOutputs(void* pArg_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -122,20 +147,55 @@ tOplkError initApp(void)
 {
     tOplkError ret = kErrorOk;
     int        i;
+    int        outputOffset;
 
     cnt_l = 0;
 
+    for (i = 0; i <= MPLX_NODE_COUNT; i++)
+        aNodeIndex_l[i] = -1;
+
     for (i = 0; (i < MAX_NODES) && (usedNodeIds_l[i] != 0); i++)
     {
+        aNodeIndex_l[usedNodeIds_l[i]] = i;
         nodeVar_l[i].leds = 0;
         nodeVar_l[i].ledsOld = 0;
         nodeVar_l[i].input = 0;
         nodeVar_l[i].inputOld = 0;
         nodeVar_l[i].toggle = 0;
         nodeVar_l[i].period = 0;
+        nodeVar_l[i].fValid = FALSE;
+        nodeVar_l[i].refreshCnt = 0;
     }
+    usedNodeCount_l = i;
 
     ret = initProcessImage();
+    if (ret != kErrorOk)
+        return ret;
+
+    // touch the process images now, so the first cycles don't take page faults
+    if (startup_isFastStart())
+    {
+        startup_beginPhase(kStartupPhasePrefault);
+        startup_prefault(pProcessImageIn_l, sizeof(PI_IN));
+        startup_prefault(pProcessImageOut_l, sizeof(PI_OUT));
+        startup_endPhase(kStartupPhasePrefault);
+    }
+
+    // continue with the state of the primary MN if we have taken over
+    restoreAppState(standby_getTakeoverState());
+
+    // hand over the outputs at a fixed phase of the cycle if configured
+    fPhasedOutput_l = FALSE;
+    if (phase_getOutputOffset(&outputOffset))
+    {
+        ret = phase_addTask("Outputs", outputOffset, handoverOutputs, NULL);
+        if (ret != kErrorOk)
+        {
+            printf("Invalid output offset %d us!\n", outputOffset);
+            return ret;
+        }
+        fPhasedOutput_l = TRUE;
+    }
 
     return ret;
 }
@@ -171,27 +231,72 @@ tOplkError processSync(void)
 {
     tOplkError          ret = kErrorOk;
     int                 i;
+    const UINT8*        pNodes;
+    UINT                nodeCount;
+    UINT                n;
+    const tParamSet*    pParams;
 
     ret = oplk_waitSyncEvent(100000);
     if (ret != kErrorOk)
+    {
+        CONSOLE_LOG_WARNING(kConsoleModSync, "Sync: waiting for the sync event failed with 0x%X\n", ret);
         return ret;
+    }
+
+    phase_syncEvent();
+    cyctune_syncEvent();
+    threadstat_enter(kThreadStatRoleSync);
+
+    /* Changed runtime parameters are taken over at the cycle boundary */
+    pParams = param_syncEvent();
 
     ret = oplk_exchangeProcessImageOut();
     if (ret != kErrorOk)
         return ret;
 
+    startup_signalCycle();
+
+    scale_processInputs((const BYTE*)pProcessImageOut_l);
+
     cnt_l++;
 
     nodeVar_l[0].input = pProcessImageOut_l->CN1_M00_DigitalInput_00h_AU8_DigitalInput;
     nodeVar_l[1].input = pProcessImageOut_l->CN32_M00_DigitalInput_00h_AU8_DigitalInput;
     nodeVar_l[2].input = pProcessImageOut_l->CN110_M00_DigitalInput_00h_AU8_DigitalInput;
 
-    for (i = 0; (i < MAX_NODES) && (usedNodeIds_l[i] != 0); i++)
+    /* Only the CNs refreshed in this cycle are processed, the others keep their state */
+    pNodes = mplx_beginCycle(&nodeCount);
+    for (n = 0; n < nodeCount; n++)
     {
+        i = aNodeIndex_l[pNodes[n]];
+        if (i < 0)
+            continue;
+
+        nodeVar_l[i].refreshCnt++;
+
+        /* Freeze the state of nodes without valid data, their slots get safe values */
+        nodeVar_l[i].fValid = reinteg_isNodeDataValid(usedNodeIds_l[i]);
+        if (!nodeVar_l[i].fValid)
+            continue;
+
+        /* Nodes removed from the node list get safe values as well */
+        if (!PARAM_NODE_ENABLED(pParams, usedNodeIds_l[i]))
+        {
+            nodeVar_l[i].fValid = FALSE;
+            continue;
+        }
+
+        /* The node used for the latency measurement gets the test pattern */
+        if (usedNodeIds_l[i] == (int)iolat_getNodeId())
+        {
+            nodeVar_l[i].leds = iolat_process(cnt_l, nodeVar_l[i].input);
+            continue;
+        }
+
         /* Running LEDs */
         /* period for LED flashing determined by inputs */
-        nodeVar_l[i].period = (nodeVar_l[i].input == 0) ? 1 : (nodeVar_l[i].input * 20);
-        if (cnt_l % nodeVar_l[i].period == 0)
+        nodeVar_l[i].period = (nodeVar_l[i].input == 0) ? 1 : (nodeVar_l[i].input * pParams->ledPeriodScale);
+        if (nodeVar_l[i].refreshCnt % nodeVar_l[i].period == 0)
         {
             if (nodeVar_l[i].leds == 0x00)
             {
@@ -230,9 +335,26 @@ tOplkError processSync(void)
         }
     }
 
-    pProcessImageIn_l->CN1_M00_DigitalOutput_00h_AU8_DigitalOutput = nodeVar_l[0].leds;
-    pProcessImageIn_l->CN32_M00_DigitalOutput_00h_AU8_DigitalOutput = nodeVar_l[1].leds;
-    pProcessImageIn_l->CN110_M00_DigitalOutput_00h_AU8_DigitalOutput = nodeVar_l[2].leds;
+    pProcessImageIn_l->CN1_M00_DigitalOutput_00h_AU8_DigitalOutput =
+        nodeVar_l[0].fValid ? nodeVar_l[0].leds : pParams->safeOutput;
+    pProcessImageIn_l->CN32_M00_DigitalOutput_00h_AU8_DigitalOutput =
+        nodeVar_l[1].fValid ? nodeVar_l[1].leds : pParams->safeOutput;
+    pProcessImageIn_l->CN110_M00_DigitalOutput_00h_AU8_DigitalOutput =
+        nodeVar_l[2].fValid ? nodeVar_l[2].leds : pParams->safeOutput;
+
+    axis_process((const BYTE*)pProcessImageOut_l, (BYTE*)pProcessImageIn_l);
+    pid_process();
+    scale_processOutputs((BYTE*)pProcessImageIn_l);
+    alarm_process((const BYTE*)pProcessImageOut_l, (const BYTE*)pProcessImageIn_l);
+    hist_sample((const BYTE*)pProcessImageOut_l, (const BYTE*)pProcessImageIn_l);
+
+    standby_publish(cnt_l, pProcessImageIn_l, sizeof(PI_IN), pProcessImageOut_l, sizeof(PI_OUT),
+                    nodeVar_l, usedNodeCount_l * sizeof(APP_NODE_VAR_T));
+
+    phase_runTasks();
+    cyctune_syncDone();
+    if (fPhasedOutput_l)
+        return outputRet_l;
 
     ret = oplk_exchangeProcessImageIn();
 
@@ -275,4 +397,58 @@ static tOplkError initProcessImage(void)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Restore application state
+
+The function restores the application state replicated from a primary MN.
+The cycle count, the running light states and the last outputs are taken
+over, so the outputs of the CNs continue where the primary MN stopped.
+
+\param  pState_p                Pointer to the replicated state, may be NULL.
+*/
+//------------------------------------------------------------------------------
+static void restoreAppState(const tStandbyState* pState_p)
+{
+    UINT            nodeCount = 0;
+    UINT            i;
+
+    if (pState_p == NULL)
+        return;
+
+    cnt_l = pState_p->cycleCount;
+
+    if (pState_p->appDataSize <= sizeof(nodeVar_l))
+        memcpy(nodeVar_l, pState_p->aAppData, pState_p->appDataSize);
+
+    if (pState_p->piInSize == sizeof(PI_IN))
+        memcpy(pProcessImageIn_l, pState_p->aPiIn, sizeof(PI_IN));
+
+    for (i = 0; i < STANDBY_NODE_COUNT; i++)
+    {
+        if (pState_p->aNodeState[i] == kNmtCsOperational)
+            nodeCount++;
+    }
+
+    printf("Restored application state of primary MN (cycle %lu, %u nodes were operational)\n",
+           (ULONG)cnt_l, nodeCount);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Hand over the outputs
+
+The function is executed by the phase-locked scheduler at the configured
+output offset. It hands over the output process image to the stack.
+
+\param  pArg_p              Task argument. Not used!
+*/
+//------------------------------------------------------------------------------
+static void handoverOutputs(void* pArg_p)
+{
+    UNUSED_PARAMETER(pArg_p);
+
+    outputRet_l = oplk_exchangeProcessImageIn();
+}
+
 /// \}
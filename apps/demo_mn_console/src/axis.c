@@ -0,0 +1,1280 @@
+/**
+********************************************************************************
+\file   axis.c
+
+\brief  CiA 402 axis engine of the MN demo application
+
+This file contains the axis engine of the MN demo application. It drives
+CiA 402 servo drives in cyclic synchronous position mode (CSP): every cycle
+it runs the power drive state machines of all axes and generates jerk limited
+position setpoints, optionally with velocity and torque feed forward values.
+
+The axes are read from a configuration file. Every axis names its channels of
+the process image (see xap.xml) and its limits in user units:
+
+    # name  controlword        statusword         target position    vmax amax  jmax   [options]
+    X       CN1.M01.CW         CN1.M01.SW         CN1.M01.TargetPos  0.5  5.0   100.0  res=100000 act=CN1.M01.ActPos
+
+Options:
+- res=R: counts per user unit (default 1)
+- act=CHANNEL: position actual value (0x6064), the setpoint follows it while
+  the axis is disabled
+- vel=CHANNEL: velocity feed forward (0x60B1) [counts/s]
+- trq=CHANNEL: torque feed forward (0x60B2), see ff=
+- ff=K: torque feed forward per acceleration [0.1 % / (unit/s^2)]
+- mode=CHANNEL: modes of operation (0x6060), set to CSP
+
+Moves are planned by the thread calling axis_moveTo() or axis_moveBy() and
+passed to the synchronous data handler through a lock-free queue per axis.
+Every move is a rest-to-rest seven phase profile with constant jerk in each
+phase, so the cyclic part only evaluates a cubic polynomial per axis.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "pidesc.h"
+#include "axis.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define AXIS_LINE_LEN           512         // maximum length of a line in the configuration
+#define AXIS_PHASE_COUNT        7           // number of phases of a move
+#define AXIS_NO_CHANNEL         0xFFFFFFFF  // offset of an unused channel
+#define AXIS_MODE_CSP           8           // cyclic synchronous position mode
+
+// controlword bits
+#define AXIS_CW_FAULT_RESET     0x0080
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Process image channel of an axis
+
+The structure describes a channel used by an axis.
+*/
+typedef struct
+{
+    UINT            offset;                 ///< Offset in the process image [bytes], AXIS_NO_CHANNEL if unused
+    tPiDescType     type;                   ///< Data type
+} tAxisChannel;
+
+/**
+\brief  Move
+
+The structure describes a planned move. It contains the start state and the
+duration of every phase, relative to the start position of the move.
+*/
+typedef struct
+{
+    double          aPos[AXIS_PHASE_COUNT];     ///< Positions at the start of the phases
+    double          aVel[AXIS_PHASE_COUNT];     ///< Velocities at the start of the phases
+    double          aAcc[AXIS_PHASE_COUNT];     ///< Accelerations at the start of the phases
+    double          aJerk[AXIS_PHASE_COUNT];    ///< Jerks of the phases
+    double          aTime[AXIS_PHASE_COUNT];    ///< Durations of the phases [s]
+    double          distance;                   ///< Distance of the move
+} tAxisMove;
+
+/**
+\brief  Move queue
+
+The structure contains the queue of planned moves of an axis. The planning
+thread only writes writeIndex, the synchronous data handler only writes
+readIndex. A move is removed from the queue when it is finished.
+*/
+typedef struct
+{
+    tAxisMove       aMove[AXIS_QUEUE_LEN];  ///< Queued moves
+    volatile UINT   readIndex;              ///< Index of the current move
+    volatile UINT   writeIndex;             ///< Index of the next free entry
+} tAxisQueue;
+
+/**
+\brief  Axis engine
+
+The structure contains the axis engine. The cyclic state of the axes is
+stored in separate arrays, so every pass of axis_process() runs over
+contiguous data.
+*/
+typedef struct
+{
+    char            aName[AXIS_MAX_AXES][AXIS_NAME_LEN];    ///< Axis names
+    tAxisChannel    aControlwordCh[AXIS_MAX_AXES];          ///< Controlword (0x6040) channels
+    tAxisChannel    aStatuswordCh[AXIS_MAX_AXES];           ///< Statusword (0x6041) channels
+    tAxisChannel    aTargetPosCh[AXIS_MAX_AXES];            ///< Target position (0x607A) channels
+    tAxisChannel    aActualPosCh[AXIS_MAX_AXES];            ///< Position actual value channels
+    tAxisChannel    aVelOffsetCh[AXIS_MAX_AXES];            ///< Velocity offset channels
+    tAxisChannel    aTorqueOffsetCh[AXIS_MAX_AXES];         ///< Torque offset channels
+    tAxisChannel    aModeCh[AXIS_MAX_AXES];                 ///< Modes of operation channels
+    double          aResolution[AXIS_MAX_AXES];             ///< Counts per user unit
+    double          aTorqueGain[AXIS_MAX_AXES];             ///< Torque feed forward per acceleration
+    double          aVelMax[AXIS_MAX_AXES];                 ///< Velocity limits
+    double          aAccMax[AXIS_MAX_AXES];                 ///< Acceleration limits
+    double          aJerkMax[AXIS_MAX_AXES];                ///< Jerk limits
+    UINT16          aStatusword[AXIS_MAX_AXES];             ///< Statuswords of the current cycle
+    UINT16          aControlword[AXIS_MAX_AXES];            ///< Controlwords of the current cycle
+    UINT8           aState[AXIS_MAX_AXES];                  ///< Drive states (tAxisState)
+    volatile BOOL   aEnable[AXIS_MAX_AXES];                 ///< Operation requested by the application
+    double          aActualPos[AXIS_MAX_AXES];              ///< Actual positions [units]
+    double          aPos[AXIS_MAX_AXES];                    ///< Position setpoints [units]
+    double          aVel[AXIS_MAX_AXES];                    ///< Velocity setpoints [units/s]
+    double          aAcc[AXIS_MAX_AXES];                    ///< Acceleration setpoints [units/s^2]
+    double          aBase[AXIS_MAX_AXES];                   ///< Start positions of the current moves
+    double          aTau[AXIS_MAX_AXES];                    ///< Times within the current phases [s]
+    UINT            aPhase[AXIS_MAX_AXES];                  ///< Current phases
+    const tAxisMove* apMove[AXIS_MAX_AXES];                 ///< Current moves, NULL if idle
+    UINT            aAbortCount[AXIS_MAX_AXES];             ///< Number of aborted moves
+    double          aPlanEnd[AXIS_MAX_AXES];                ///< End positions of the queued moves (planning thread)
+    tAxisQueue      aQueue[AXIS_MAX_AXES];                  ///< Move queues
+    UINT            axisCount;                              ///< Number of axes
+    double          cycleTime;                              ///< Cycle time [s]
+} tAxisInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tAxisInstance    axisInstance_l;
+
+/* Controlword to reach the requested operation from each state, indexed by
+   state and enable request. A fault is only reset if operation is requested. */
+static const UINT16     aControlword_l[kAxisStateCount][2] =
+{
+    {0x0000, 0x0000},                       // not ready to switch on
+    {0x0006, 0x0006},                       // switch on disabled: shutdown
+    {0x0006, 0x0007},                       // ready to switch on: switch on
+    {0x0006, 0x000F},                       // switched on: enable operation
+    {0x0007, 0x000F},                       // operation enabled: disable operation
+    {0x0000, 0x0000},                       // quick stop active: disable voltage
+    {0x0000, 0x0000},                       // fault reaction active
+    {0x0000, AXIS_CW_FAULT_RESET}           // fault: fault reset
+};
+
+static const char*      apStateName_l[kAxisStateCount] =
+{
+    "not ready", "disabled", "ready", "switched on", "enabled", "quick stop", "fault reaction", "fault"
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p);
+static tOplkError findChannel(const char* pszName_p, tPiDescImage image_p, BOOL fPosition_p,
+                              tAxisChannel* pChannel_p);
+static tOplkError addAxis(const char* pszName_p, const double* pLimit_p);
+static void       readInputs(tAxisInstance* pInst_p, const BYTE* pPiOut_p);
+static void       updateStates(tAxisInstance* pInst_p);
+static void       updateTrajectories(tAxisInstance* pInst_p);
+static void       writeOutputs(tAxisInstance* pInst_p, BYTE* pPiIn_p);
+static tAxisState decodeState(UINT16 statusword_p);
+static INT64      readChannel(const BYTE* pImage_p, const tAxisChannel* pChannel_p);
+static void       writeChannel(BYTE* pImage_p, const tAxisChannel* pChannel_p, INT64 value_p);
+static void       planMove(double distance_p, double velMax_p, double accMax_p, double jerkMax_p,
+                           tAxisMove* pMove_p);
+static UINT16     simulateDrive(UINT16 statusword_p, UINT16 controlword_p, UINT16 prevControlword_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the axis engine
+
+The function loads the axis configuration. The process image description
+must be loaded before.
+
+\param  pszConfigFile_p         File name of the axis configuration.
+\param  cycleLenUs_p            Cycle length [us].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError axis_init(const char* pszConfigFile_p, UINT32 cycleLenUs_p)
+{
+    FILE*           pFile;
+    char            aLine[AXIS_LINE_LEN];
+    UINT            lineNo = 0;
+    tOplkError      ret = kErrorOk;
+
+    memset(&axisInstance_l, 0, sizeof(axisInstance_l));
+    if (cycleLenUs_p == 0)
+        return kErrorApiInvalidParam;
+
+    axisInstance_l.cycleTime = (double)cycleLenUs_p / 1000000.0;
+
+    pFile = fopen(pszConfigFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open axis configuration %s!\n", pszConfigFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        ret = parseLine(aLine);
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid axis in line %u of %s!\n", lineNo, pszConfigFile_p);
+        return ret;
+    }
+
+    printf("Running %u CiA 402 axes every %lu us\n", axisInstance_l.axisCount, (ULONG)cycleLenUs_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the axes
+
+The function reads the statuswords, runs the drive state machines, advances
+the trajectories and writes the controlwords and setpoints of all axes. It is
+called by the synchronous data handler.
+
+\param  pPiOut_p                Pointer to the output process image (data
+                                received from the CNs).
+\param  pPiIn_p                 Pointer to the input process image (data
+                                sent to the CNs).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void axis_process(const BYTE* pPiOut_p, BYTE* pPiIn_p)
+{
+    tAxisInstance*  pInst = &axisInstance_l;
+
+    if (pInst->axisCount == 0)
+        return;
+
+    readInputs(pInst, pPiOut_p);
+    updateStates(pInst);
+    updateTrajectories(pInst);
+    writeOutputs(pInst, pPiIn_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find an axis by name
+
+\param  pszName_p               Name of the axis.
+
+\return The function returns the index of the axis or -1 if it is not found.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int axis_findAxis(const char* pszName_p)
+{
+    UINT    i;
+
+    for (i = 0; i < axisInstance_l.axisCount; i++)
+    {
+        if (strcmp(axisInstance_l.aName[i], pszName_p) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of axes
+
+\return The function returns the number of configured axes.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT axis_getAxisCount(void)
+{
+    return axisInstance_l.axisCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable or disable an axis
+
+The state machine of the drive is moved towards "operation enabled" or
+"ready to switch on". A pending fault is reset when the axis is enabled.
+
+\param  axis_p                  Index of the axis.
+\param  fEnable_p               TRUE to enable the axis.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void axis_setEnable(UINT axis_p, BOOL fEnable_p)
+{
+    if (axis_p < axisInstance_l.axisCount)
+        axisInstance_l.aEnable[axis_p] = fEnable_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the drive state of an axis
+
+\param  axis_p                  Index of the axis.
+
+\return The function returns the state decoded from the last statusword.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tAxisState axis_getState(UINT axis_p)
+{
+    if (axis_p >= axisInstance_l.axisCount)
+        return kAxisStateNotReady;
+
+    return (tAxisState)axisInstance_l.aState[axis_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an axis has finished all moves
+
+\param  axis_p                  Index of the axis.
+
+\return The function returns TRUE if no move is queued or running.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL axis_isIdle(UINT axis_p)
+{
+    const tAxisQueue*   pQueue;
+
+    if (axis_p >= axisInstance_l.axisCount)
+        return TRUE;
+
+    pQueue = &axisInstance_l.aQueue[axis_p];
+    return (pQueue->readIndex == pQueue->writeIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue a move to an absolute position
+
+The move starts at the end of the previously queued move, or at the current
+position if the axis is idle. Moves must be queued by a single thread and
+are only accepted while operation is enabled. If the axis leaves "operation
+enabled", the running move is aborted and the queue is cleared.
+
+\param  axis_p                  Index of the axis.
+\param  target_p                Target position [units].
+
+\return The function returns a tOplkError error code.
+\retval kErrorNoResource        The queue of the axis is full.
+\retval kErrorReject            Operation is not enabled.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError axis_moveTo(UINT axis_p, double target_p)
+{
+    tAxisInstance*  pInst = &axisInstance_l;
+    tAxisQueue*     pQueue;
+    UINT            writeIndex;
+
+    if (axis_p >= pInst->axisCount)
+        return kErrorApiInvalidParam;
+
+    if (!pInst->aEnable[axis_p] || (pInst->aState[axis_p] != kAxisStateOperationEnabled))
+        return kErrorReject;
+
+    pQueue = &pInst->aQueue[axis_p];
+    writeIndex = pQueue->writeIndex;
+    if (pQueue->readIndex == writeIndex)
+        pInst->aPlanEnd[axis_p] = pInst->aPos[axis_p];
+    else if ((writeIndex - pQueue->readIndex) >= AXIS_QUEUE_LEN)
+        return kErrorNoResource;
+
+    planMove(target_p - pInst->aPlanEnd[axis_p], pInst->aVelMax[axis_p], pInst->aAccMax[axis_p],
+             pInst->aJerkMax[axis_p], &pQueue->aMove[writeIndex & (AXIS_QUEUE_LEN - 1)]);
+    pInst->aPlanEnd[axis_p] = target_p;
+
+    system_memoryBarrier();
+    pQueue->writeIndex = writeIndex + 1;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue a relative move
+
+The distance is relative to the end of the previously queued move, or to the
+current position if the axis is idle. See axis_moveTo().
+
+\param  axis_p                  Index of the axis.
+\param  distance_p              Distance of the move [units].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError axis_moveBy(UINT axis_p, double distance_p)
+{
+    if (axis_p >= axisInstance_l.axisCount)
+        return kErrorApiInvalidParam;
+
+    if (axis_isIdle(axis_p))
+        axisInstance_l.aPlanEnd[axis_p] = axisInstance_l.aPos[axis_p];
+
+    return axis_moveTo(axis_p, axisInstance_l.aPlanEnd[axis_p] + distance_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the state of the axes
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void axis_printStatus(void)
+{
+    const tAxisInstance*    pInst = &axisInstance_l;
+    UINT                    i;
+
+    if (pInst->axisCount == 0)
+    {
+        printf("No axes configured\n");
+        return;
+    }
+
+    printf("Axes:\n");
+    for (i = 0; i < pInst->axisCount; i++)
+    {
+        printf("  %-16s %-14s SW 0x%04X  POS %12.4f  VEL %10.4f  queued %u  aborted %u\n",
+               pInst->aName[i], apStateName_l[pInst->aState[i]], pInst->aStatusword[i],
+               pInst->aPos[i], pInst->aVel[i],
+               pInst->aQueue[i].writeIndex - pInst->aQueue[i].readIndex, pInst->aAbortCount[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Benchmark the axis engine
+
+The function measures the processing time of the given number of axes. Every
+axis drives a simulated CiA 402 drive which follows the state machine and the
+position setpoints. The simulated drives raise a fault from time to time, and
+new moves are queued as soon as an axis gets idle. The configuration of the
+axis engine is replaced.
+
+\param  axisCount_p             Number of axes.
+\param  cycleCount_p            Number of measured cycles.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void axis_benchmark(UINT axisCount_p, UINT cycleCount_p)
+{
+    tAxisInstance*  pInst = &axisInstance_l;
+    BYTE*           pPiOut;
+    BYTE*           pPiIn;
+    UINT16*         pPrevControlword;
+    double          aLimit[3];
+    char            aName[AXIS_NAME_LEN];
+    UINT            i;
+    UINT            cycle;
+    UINT            moveCount = 0;
+    UINT            faultCount = 0;
+    double          velPeak = 0.0;
+    double          accPeak = 0.0;
+    UINT64          start;
+    UINT64          time;
+    UINT64          minTime = ~0ULL;
+    UINT64          maxTime = 0;
+    UINT64          sumTime = 0;
+
+    if ((axisCount_p == 0) || (cycleCount_p == 0))
+        return;
+
+    if (axisCount_p > AXIS_MAX_AXES)
+        axisCount_p = AXIS_MAX_AXES;
+
+    // per axis: controlword and target position in PI_IN, statusword and actual position in PI_OUT
+    pPiOut = (BYTE*)calloc(axisCount_p, 8);
+    pPiIn = (BYTE*)calloc(axisCount_p, 8);
+    pPrevControlword = (UINT16*)calloc(axisCount_p, sizeof(UINT16));
+    if ((pPiOut == NULL) || (pPiIn == NULL) || (pPrevControlword == NULL))
+    {
+        free(pPiOut);
+        free(pPiIn);
+        free(pPrevControlword);
+        return;
+    }
+
+    memset(pInst, 0, sizeof(*pInst));
+    pInst->cycleTime = 250e-6;
+
+    aLimit[0] = 1.0;                        // vmax [units/s]
+    aLimit[1] = 20.0;                       // amax [units/s^2]
+    aLimit[2] = 1000.0;                     // jmax [units/s^3]
+    for (i = 0; i < axisCount_p; i++)
+    {
+        sprintf(aName, "bench%u", i);
+        pInst->aControlwordCh[i].offset = i * 8;
+        pInst->aControlwordCh[i].type = kPiDescTypeUnsigned16;
+        pInst->aTargetPosCh[i].offset = i * 8 + 4;
+        pInst->aTargetPosCh[i].type = kPiDescTypeInteger32;
+        pInst->aStatuswordCh[i].offset = i * 8;
+        pInst->aStatuswordCh[i].type = kPiDescTypeUnsigned16;
+        pInst->aActualPosCh[i].offset = i * 8 + 4;
+        pInst->aActualPosCh[i].type = kPiDescTypeInteger32;
+        pInst->aVelOffsetCh[i].offset = AXIS_NO_CHANNEL;
+        pInst->aTorqueOffsetCh[i].offset = AXIS_NO_CHANNEL;
+        pInst->aModeCh[i].offset = AXIS_NO_CHANNEL;
+        pInst->aResolution[i] = 100000.0;
+        addAxis(aName, aLimit);
+        pInst->aEnable[i] = TRUE;
+        pPiOut[i * 8] = 0x40;               // switch on disabled
+    }
+
+    for (cycle = 0; cycle < cycleCount_p; cycle++)
+    {
+        start = system_getTimeNs();
+        axis_process(pPiOut, pPiIn);
+        time = system_getTimeNs() - start;
+
+        if (time < minTime)
+            minTime = time;
+        if (time > maxTime)
+            maxTime = time;
+        sumTime += time;
+
+        for (i = 0; i < axisCount_p; i++)
+        {
+            UINT16  statusword;
+            UINT16  controlword;
+
+            if (fabs(pInst->aVel[i]) > velPeak)
+                velPeak = fabs(pInst->aVel[i]);
+            if (fabs(pInst->aAcc[i]) > accPeak)
+                accPeak = fabs(pInst->aAcc[i]);
+
+            // simulated drive: follows the setpoint with one cycle delay
+            memcpy(&statusword, &pPiOut[i * 8], 2);
+            memcpy(&controlword, &pPiIn[i * 8], 2);
+            statusword = simulateDrive(statusword, controlword, pPrevControlword[i]);
+            if ((decodeState(statusword) == kAxisStateOperationEnabled) && ((cycle + i * 97) % 20011 == 0))
+            {
+                statusword = 0x0008;
+                faultCount++;
+            }
+            pPrevControlword[i] = controlword;
+            memcpy(&pPiOut[i * 8], &statusword, 2);
+            memcpy(&pPiOut[i * 8 + 4], &pPiIn[i * 8 + 4], 4);
+
+            // planning thread
+            if ((pInst->aState[i] == kAxisStateOperationEnabled) && axis_isIdle(i))
+            {
+                if (axis_moveBy(i, ((moveCount & 1) ? -0.3 : 0.3) + 0.01 * (i % 7)) == kErrorOk)
+                    moveCount++;
+            }
+        }
+    }
+
+    printf("CiA 402 axis engine: %u axes\n", axisCount_p);
+    printf("  Cycle time min/avg/max: %lu / %lu / %lu ns, %.1f ns per axis\n",
+           (ULONG)minTime, (ULONG)(sumTime / cycleCount_p), (ULONG)maxTime,
+           (double)sumTime / cycleCount_p / axisCount_p);
+    printf("  %u moves queued, %u faults, peak velocity %.3f (limit %.3f), peak acceleration %.3f (limit %.3f)\n",
+           moveCount, faultCount, velPeak, aLimit[0], accPeak, aLimit[1]);
+
+    memset(pInst, 0, sizeof(*pInst));
+    free(pPiOut);
+    free(pPiIn);
+    free(pPrevControlword);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a line of the axis configuration
+
+\param  pLine_p                 Pointer to the line, it is modified.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p)
+{
+    tAxisInstance*  pInst = &axisInstance_l;
+    char*           apToken[16];
+    char*           pToken;
+    char*           pComment;
+    char*           pEnd;
+    UINT            tokenCount = 0;
+    UINT            axis = pInst->axisCount;
+    double          aLimit[3];
+    tOplkError      ret;
+    UINT            i;
+
+    pComment = strchr(pLine_p, '#');
+    if (pComment != NULL)
+        *pComment = '\0';
+
+    for (pToken = strtok(pLine_p, " \t\r\n"); pToken != NULL; pToken = strtok(NULL, " \t\r\n"))
+    {
+        if (tokenCount >= 16)
+            return kErrorApiInvalidParam;
+        apToken[tokenCount++] = pToken;
+    }
+
+    if (tokenCount == 0)
+        return kErrorOk;
+    if ((tokenCount < 7) || (strlen(apToken[0]) >= AXIS_NAME_LEN))
+        return kErrorApiInvalidParam;
+    if (axis >= AXIS_MAX_AXES)
+        return kErrorNoResource;
+
+    // vmax, amax, jmax
+    for (i = 0; i < 3; i++)
+    {
+        aLimit[i] = strtod(apToken[4 + i], &pEnd);
+        if ((*pEnd != '\0') || !(aLimit[i] > 0.0))
+            return kErrorApiInvalidParam;
+    }
+
+    if (((ret = findChannel(apToken[1], kPiDescImageIn, FALSE, &pInst->aControlwordCh[axis])) != kErrorOk) ||
+        ((ret = findChannel(apToken[2], kPiDescImageOut, FALSE, &pInst->aStatuswordCh[axis])) != kErrorOk) ||
+        ((ret = findChannel(apToken[3], kPiDescImageIn, TRUE, &pInst->aTargetPosCh[axis])) != kErrorOk))
+        return ret;
+
+    if ((pInst->aControlwordCh[axis].type != kPiDescTypeUnsigned16) ||
+        (pInst->aStatuswordCh[axis].type != kPiDescTypeUnsigned16))
+    {
+        fprintf(stderr, "Controlword and statusword of axis %s must be UNSIGNED16!\n", apToken[0]);
+        return kErrorApiInvalidParam;
+    }
+
+    pInst->aActualPosCh[axis].offset = AXIS_NO_CHANNEL;
+    pInst->aVelOffsetCh[axis].offset = AXIS_NO_CHANNEL;
+    pInst->aTorqueOffsetCh[axis].offset = AXIS_NO_CHANNEL;
+    pInst->aModeCh[axis].offset = AXIS_NO_CHANNEL;
+    pInst->aResolution[axis] = 1.0;
+    pInst->aTorqueGain[axis] = 0.0;
+
+    for (i = 7; i < tokenCount; i++)
+    {
+        pEnd = "";
+        if (strncmp(apToken[i], "res=", 4) == 0)
+        {
+            pInst->aResolution[axis] = strtod(apToken[i] + 4, &pEnd);
+            if (!(pInst->aResolution[axis] > 0.0))
+                return kErrorApiInvalidParam;
+        }
+        else if (strncmp(apToken[i], "ff=", 3) == 0)
+            pInst->aTorqueGain[axis] = strtod(apToken[i] + 3, &pEnd);
+        else if (strncmp(apToken[i], "act=", 4) == 0)
+            ret = findChannel(apToken[i] + 4, kPiDescImageOut, TRUE, &pInst->aActualPosCh[axis]);
+        else if (strncmp(apToken[i], "vel=", 4) == 0)
+            ret = findChannel(apToken[i] + 4, kPiDescImageIn, FALSE, &pInst->aVelOffsetCh[axis]);
+        else if (strncmp(apToken[i], "trq=", 4) == 0)
+            ret = findChannel(apToken[i] + 4, kPiDescImageIn, FALSE, &pInst->aTorqueOffsetCh[axis]);
+        else if (strncmp(apToken[i], "mode=", 5) == 0)
+            ret = findChannel(apToken[i] + 5, kPiDescImageIn, FALSE, &pInst->aModeCh[axis]);
+        else
+            return kErrorApiInvalidParam;
+
+        if ((ret != kErrorOk) || (*pEnd != '\0'))
+            return kErrorApiInvalidParam;
+    }
+
+    return addAxis(apToken[0], aLimit);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Look up a channel of an axis
+
+The function looks up a channel in the process image description. Only
+integer channels are supported, a position channel must have 32 bits.
+
+\param  pszName_p               Name of the channel.
+\param  image_p                 Process image the channel must belong to.
+\param  fPosition_p             The channel is a position.
+\param  pChannel_p              Pointer to store the channel.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError findChannel(const char* pszName_p, tPiDescImage image_p, BOOL fPosition_p,
+                              tAxisChannel* pChannel_p)
+{
+    const tPiDescChannel*   pChannel;
+    tPiDescImage            image;
+
+    pChannel = pidesc_findChannel(pszName_p, &image);
+    if ((pChannel == NULL) || (image != image_p))
+    {
+        fprintf(stderr, "Channel %s not found in the %s process image!\n", pszName_p,
+                (image_p == kPiDescImageIn) ? "input" : "output");
+        return kErrorApiInvalidParam;
+    }
+
+    if ((pChannel->type < kPiDescTypeInteger8) || (pChannel->type > kPiDescTypeUnsigned32) ||
+        (fPosition_p && (pChannel->size != 32)) || ((pChannel->offset % 8) != 0))
+    {
+        fprintf(stderr, "Channel %s has an unsupported type or alignment!\n", pszName_p);
+        return kErrorApiInvalidParam;
+    }
+
+    pChannel_p->offset = pChannel->offset / 8;
+    pChannel_p->type = pChannel->type;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an axis
+
+The channels, the resolution and the torque feed forward of the axis must
+already be set up.
+
+\param  pszName_p               Name of the axis.
+\param  pLimit_p                Pointer to the velocity, acceleration and
+                                jerk limits.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError addAxis(const char* pszName_p, const double* pLimit_p)
+{
+    tAxisInstance*  pInst = &axisInstance_l;
+    UINT            i = pInst->axisCount;
+
+    if (i >= AXIS_MAX_AXES)
+        return kErrorNoResource;
+
+    strncpy(pInst->aName[i], pszName_p, AXIS_NAME_LEN - 1);
+    pInst->aVelMax[i] = pLimit_p[0];
+    pInst->aAccMax[i] = pLimit_p[1];
+    pInst->aJerkMax[i] = pLimit_p[2];
+
+    pInst->axisCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the inputs of the axes
+
+\param  pInst_p                 Pointer to the axis engine.
+\param  pPiOut_p                Pointer to the output process image.
+*/
+//------------------------------------------------------------------------------
+static void readInputs(tAxisInstance* pInst_p, const BYTE* pPiOut_p)
+{
+    UINT    i;
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+        memcpy(&pInst_p->aStatusword[i], pPiOut_p + pInst_p->aStatuswordCh[i].offset, sizeof(UINT16));
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+    {
+        if (pInst_p->aActualPosCh[i].offset != AXIS_NO_CHANNEL)
+        {
+            pInst_p->aActualPos[i] = (double)readChannel(pPiOut_p, &pInst_p->aActualPosCh[i]) /
+                                     pInst_p->aResolution[i];
+        }
+        else
+            pInst_p->aActualPos[i] = pInst_p->aPos[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the drive state machines
+
+The function decodes the drive states and selects the controlwords which
+move the drives towards the requested operation.
+
+\param  pInst_p                 Pointer to the axis engine.
+*/
+//------------------------------------------------------------------------------
+static void updateStates(tAxisInstance* pInst_p)
+{
+    UINT        i;
+    UINT16      controlword;
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+        pInst_p->aState[i] = (UINT8)decodeState(pInst_p->aStatusword[i]);
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+    {
+        controlword = aControlword_l[pInst_p->aState[i]][pInst_p->aEnable[i] ? 1 : 0];
+
+        // the fault reset is triggered by a rising edge
+        if ((controlword & pInst_p->aControlword[i]) & AXIS_CW_FAULT_RESET)
+            controlword = 0;
+
+        pInst_p->aControlword[i] = controlword;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Advance the trajectories
+
+The function advances the current move of every axis in operation. An axis
+which is not in operation holds its actual position, its move is aborted and
+its queue is cleared.
+
+\param  pInst_p                 Pointer to the axis engine.
+*/
+//------------------------------------------------------------------------------
+static void updateTrajectories(tAxisInstance* pInst_p)
+{
+    UINT                i;
+    UINT                phase;
+    double              tau;
+    double              jerk;
+    const tAxisMove*    pMove;
+    tAxisQueue*         pQueue;
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+    {
+        pQueue = &pInst_p->aQueue[i];
+        pMove = pInst_p->apMove[i];
+
+        if ((pInst_p->aState[i] != kAxisStateOperationEnabled) || !pInst_p->aEnable[i])
+        {
+            if (pMove != NULL)
+                pInst_p->aAbortCount[i]++;
+
+            pInst_p->apMove[i] = NULL;
+            pInst_p->aPos[i] = pInst_p->aActualPos[i];
+            pInst_p->aVel[i] = 0.0;
+            pInst_p->aAcc[i] = 0.0;
+            pQueue->readIndex = pQueue->writeIndex;
+            continue;
+        }
+
+        if (pMove == NULL)
+        {
+            if (pQueue->readIndex == pQueue->writeIndex)
+                continue;
+
+            system_memoryBarrier();
+            pMove = &pQueue->aMove[pQueue->readIndex & (AXIS_QUEUE_LEN - 1)];
+            pInst_p->apMove[i] = pMove;
+            pInst_p->aBase[i] = pInst_p->aPos[i];
+            pInst_p->aTau[i] = 0.0;
+            pInst_p->aPhase[i] = 0;
+        }
+
+        tau = pInst_p->aTau[i] + pInst_p->cycleTime;
+        phase = pInst_p->aPhase[i];
+        while ((phase < AXIS_PHASE_COUNT) && (tau >= pMove->aTime[phase]))
+        {
+            tau -= pMove->aTime[phase];
+            phase++;
+        }
+
+        if (phase == AXIS_PHASE_COUNT)
+        {
+            // finished, remove the move from the queue
+            pInst_p->aPos[i] = pInst_p->aBase[i] + pMove->distance;
+            pInst_p->aVel[i] = 0.0;
+            pInst_p->aAcc[i] = 0.0;
+            pInst_p->apMove[i] = NULL;
+            system_memoryBarrier();
+            pQueue->readIndex++;
+            continue;
+        }
+
+        jerk = pMove->aJerk[phase];
+        pInst_p->aAcc[i] = pMove->aAcc[phase] + jerk * tau;
+        pInst_p->aVel[i] = pMove->aVel[phase] + tau * (pMove->aAcc[phase] + tau * jerk / 2.0);
+        pInst_p->aPos[i] = pInst_p->aBase[i] + pMove->aPos[phase] +
+                           tau * (pMove->aVel[phase] + tau * (pMove->aAcc[phase] / 2.0 + tau * jerk / 6.0));
+        pInst_p->aTau[i] = tau;
+        pInst_p->aPhase[i] = phase;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the outputs of the axes
+
+\param  pInst_p                 Pointer to the axis engine.
+\param  pPiIn_p                 Pointer to the input process image.
+*/
+//------------------------------------------------------------------------------
+static void writeOutputs(tAxisInstance* pInst_p, BYTE* pPiIn_p)
+{
+    UINT    i;
+    double  resolution;
+
+    for (i = 0; i < pInst_p->axisCount; i++)
+    {
+        memcpy(pPiIn_p + pInst_p->aControlwordCh[i].offset, &pInst_p->aControlword[i], sizeof(UINT16));
+
+        resolution = pInst_p->aResolution[i];
+        writeChannel(pPiIn_p, &pInst_p->aTargetPosCh[i], (INT64)floor(pInst_p->aPos[i] * resolution + 0.5));
+
+        if (pInst_p->aVelOffsetCh[i].offset != AXIS_NO_CHANNEL)
+        {
+            writeChannel(pPiIn_p, &pInst_p->aVelOffsetCh[i],
+                         (INT64)floor(pInst_p->aVel[i] * resolution + 0.5));
+        }
+
+        if (pInst_p->aTorqueOffsetCh[i].offset != AXIS_NO_CHANNEL)
+        {
+            writeChannel(pPiIn_p, &pInst_p->aTorqueOffsetCh[i],
+                         (INT64)floor(pInst_p->aAcc[i] * pInst_p->aTorqueGain[i] + 0.5));
+        }
+
+        if (pInst_p->aModeCh[i].offset != AXIS_NO_CHANNEL)
+            writeChannel(pPiIn_p, &pInst_p->aModeCh[i], AXIS_MODE_CSP);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Decode the drive state
+
+\param  statusword_p            Statusword of the drive.
+
+\return The function returns the drive state.
+*/
+//------------------------------------------------------------------------------
+static tAxisState decodeState(UINT16 statusword_p)
+{
+    switch (statusword_p & 0x004F)
+    {
+        case 0x0000:
+            return kAxisStateNotReady;
+
+        case 0x0040:
+            return kAxisStateSwitchOnDisabled;
+
+        case 0x000F:
+            return kAxisStateFaultReactionActive;
+
+        case 0x0008:
+            return kAxisStateFault;
+
+        default:
+            break;
+    }
+
+    switch (statusword_p & 0x006F)
+    {
+        case 0x0021:
+            return kAxisStateReadyToSwitchOn;
+
+        case 0x0023:
+            return kAxisStateSwitchedOn;
+
+        case 0x0027:
+            return kAxisStateOperationEnabled;
+
+        case 0x0007:
+            return kAxisStateQuickStopActive;
+
+        default:
+            return kAxisStateNotReady;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an integer channel
+
+\param  pImage_p                Pointer to the process image.
+\param  pChannel_p              Pointer to the channel.
+
+\return The function returns the value of the channel.
+*/
+//------------------------------------------------------------------------------
+static INT64 readChannel(const BYTE* pImage_p, const tAxisChannel* pChannel_p)
+{
+    const BYTE* pData = pImage_p + pChannel_p->offset;
+    INT8        int8;
+    INT16       int16;
+    UINT16      uint16;
+    INT32       int32;
+    UINT32      uint32;
+
+    switch (pChannel_p->type)
+    {
+        case kPiDescTypeInteger8:
+            memcpy(&int8, pData, 1);
+            return int8;
+
+        case kPiDescTypeUnsigned8:
+            return *pData;
+
+        case kPiDescTypeInteger16:
+            memcpy(&int16, pData, 2);
+            return int16;
+
+        case kPiDescTypeUnsigned16:
+            memcpy(&uint16, pData, 2);
+            return uint16;
+
+        case kPiDescTypeInteger32:
+            memcpy(&int32, pData, 4);
+            return int32;
+
+        case kPiDescTypeUnsigned32:
+            memcpy(&uint32, pData, 4);
+            return uint32;
+
+        default:
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write an integer channel
+
+The value is truncated to the size of the channel, so positions wrap around
+like the position counters of the drives.
+
+\param  pImage_p                Pointer to the process image.
+\param  pChannel_p              Pointer to the channel.
+\param  value_p                 Value to write.
+*/
+//------------------------------------------------------------------------------
+static void writeChannel(BYTE* pImage_p, const tAxisChannel* pChannel_p, INT64 value_p)
+{
+    BYTE*       pData = pImage_p + pChannel_p->offset;
+    UINT16      uint16 = (UINT16)value_p;
+    UINT32      uint32 = (UINT32)value_p;
+
+    switch (pChannel_p->type)
+    {
+        case kPiDescTypeInteger8:
+        case kPiDescTypeUnsigned8:
+            *pData = (BYTE)value_p;
+            break;
+
+        case kPiDescTypeInteger16:
+        case kPiDescTypeUnsigned16:
+            memcpy(pData, &uint16, 2);
+            break;
+
+        case kPiDescTypeInteger32:
+        case kPiDescTypeUnsigned32:
+            memcpy(pData, &uint32, 4);
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Plan a move
+
+The function plans a rest-to-rest move with limited velocity, acceleration
+and jerk. The move consists of seven phases with constant jerk: jerk up,
+constant acceleration, jerk down, constant velocity and the mirrored
+deceleration. If the distance is too short, the peak velocity is reduced and
+the constant acceleration or velocity phases are dropped.
+
+\param  distance_p              Distance of the move.
+\param  velMax_p                Velocity limit.
+\param  accMax_p                Acceleration limit.
+\param  jerkMax_p               Jerk limit.
+\param  pMove_p                 Pointer to store the move.
+*/
+//------------------------------------------------------------------------------
+static void planMove(double distance_p, double velMax_p, double accMax_p, double jerkMax_p,
+                     tAxisMove* pMove_p)
+{
+    double      dist = fabs(distance_p);
+    double      jerk = (distance_p < 0.0) ? -jerkMax_p : jerkMax_p;
+    double      jerkTime = accMax_p / jerkMax_p;    // duration of a jerk phase
+    double      accTime;                            // duration of the acceleration
+    double      velTime;                            // duration of the constant velocity
+    double      vel = velMax_p;
+    double      pos = 0.0;
+    double      velStart = 0.0;
+    double      acc = 0.0;
+    double      t;
+    UINT        i;
+
+    // acceleration to the velocity limit, possibly without reaching the acceleration limit
+    if (velMax_p * jerkMax_p < accMax_p * accMax_p)
+    {
+        jerkTime = sqrt(velMax_p / jerkMax_p);
+        accTime = 2.0 * jerkTime;
+    }
+    else
+        accTime = jerkTime + velMax_p / accMax_p;
+
+    if (vel * accTime > dist)
+    {
+        // velocity limit not reached, try with the acceleration limit
+        jerkTime = accMax_p / jerkMax_p;
+        vel = 0.5 * accMax_p * (sqrt(jerkTime * jerkTime + 4.0 * dist / accMax_p) - jerkTime);
+        if (vel < accMax_p * jerkTime)
+        {
+            // acceleration limit not reached either
+            vel = pow(dist * sqrt(jerkMax_p) / 2.0, 2.0 / 3.0);
+            jerkTime = sqrt(vel / jerkMax_p);
+            accTime = 2.0 * jerkTime;
+        }
+        else
+            accTime = jerkTime + vel / accMax_p;
+        velTime = 0.0;
+    }
+    else
+        velTime = (dist - vel * accTime) / vel;
+
+    pMove_p->aTime[0] = jerkTime;
+    pMove_p->aTime[1] = accTime - 2.0 * jerkTime;
+    pMove_p->aTime[2] = jerkTime;
+    pMove_p->aTime[3] = velTime;
+    pMove_p->aTime[4] = jerkTime;
+    pMove_p->aTime[5] = accTime - 2.0 * jerkTime;
+    pMove_p->aTime[6] = jerkTime;
+    pMove_p->aJerk[0] = jerk;
+    pMove_p->aJerk[1] = 0.0;
+    pMove_p->aJerk[2] = -jerk;
+    pMove_p->aJerk[3] = 0.0;
+    pMove_p->aJerk[4] = -jerk;
+    pMove_p->aJerk[5] = 0.0;
+    pMove_p->aJerk[6] = jerk;
+
+    for (i = 0; i < AXIS_PHASE_COUNT; i++)
+    {
+        if (pMove_p->aTime[i] < 0.0)
+            pMove_p->aTime[i] = 0.0;
+
+        pMove_p->aPos[i] = pos;
+        pMove_p->aVel[i] = velStart;
+        pMove_p->aAcc[i] = acc;
+
+        t = pMove_p->aTime[i];
+        pos += t * (velStart + t * (acc / 2.0 + t * pMove_p->aJerk[i] / 6.0));
+        velStart += t * (acc + t * pMove_p->aJerk[i] / 2.0);
+        acc += t * pMove_p->aJerk[i];
+    }
+
+    pMove_p->distance = distance_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Simulate a CiA 402 drive
+
+The function returns the next statusword of a simulated drive which follows
+the controlword of the MN.
+
+\param  statusword_p            Current statusword of the drive.
+\param  controlword_p           Controlword received from the MN.
+\param  prevControlword_p       Controlword of the previous cycle.
+
+\return The function returns the new statusword.
+*/
+//------------------------------------------------------------------------------
+static UINT16 simulateDrive(UINT16 statusword_p, UINT16 controlword_p, UINT16 prevControlword_p)
+{
+    tAxisState  state = decodeState(statusword_p);
+
+    if (state == kAxisStateFault)
+    {
+        if ((controlword_p & ~prevControlword_p) & AXIS_CW_FAULT_RESET)
+            return 0x0040;
+        return statusword_p;
+    }
+
+    if ((controlword_p & 0x0002) == 0)
+        return 0x0040;                      // disable voltage
+
+    switch (controlword_p & 0x000F)
+    {
+        case 0x0006:
+            return 0x0021;                  // shutdown
+
+        case 0x0007:
+            return (state == kAxisStateSwitchOnDisabled) ? statusword_p : 0x0023;
+
+        case 0x000F:
+            if ((state == kAxisStateSwitchedOn) || (state == kAxisStateOperationEnabled))
+                return 0x0027;
+            return statusword_p;
+
+        default:
+            return 0x0007;                  // quick stop
+    }
+}
+
+/// \}
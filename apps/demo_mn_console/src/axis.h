@@ -0,0 +1,100 @@
+/**
+********************************************************************************
+\file   axis.h
+
+\brief  Definitions for the CiA 402 axis engine
+
+The file contains the definitions for the CiA 402 axis engine of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_axis_H_
+#define _INC_axis_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define AXIS_MAX_AXES               256     ///< Maximum number of axes
+#define AXIS_QUEUE_LEN              16      ///< Number of moves queued per axis (power of 2)
+#define AXIS_NAME_LEN               32      ///< Maximum length of an axis name
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  CiA 402 drive states
+
+The enumeration lists the states of the CiA 402 power drive system state
+machine, decoded from the statusword (0x6041).
+*/
+typedef enum
+{
+    kAxisStateNotReady = 0,                 ///< Not ready to switch on
+    kAxisStateSwitchOnDisabled,             ///< Switch on disabled
+    kAxisStateReadyToSwitchOn,              ///< Ready to switch on
+    kAxisStateSwitchedOn,                   ///< Switched on
+    kAxisStateOperationEnabled,             ///< Operation enabled
+    kAxisStateQuickStopActive,              ///< Quick stop active
+    kAxisStateFaultReactionActive,          ///< Fault reaction active
+    kAxisStateFault,                        ///< Fault
+    kAxisStateCount
+} tAxisState;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError axis_init(const char* pszConfigFile_p, UINT32 cycleLenUs_p);
+void       axis_process(const BYTE* pPiOut_p, BYTE* pPiIn_p);
+int        axis_findAxis(const char* pszName_p);
+UINT       axis_getAxisCount(void);
+void       axis_setEnable(UINT axis_p, BOOL fEnable_p);
+tAxisState axis_getState(UINT axis_p);
+BOOL       axis_isIdle(UINT axis_p);
+tOplkError axis_moveTo(UINT axis_p, double target_p);
+tOplkError axis_moveBy(UINT axis_p, double distance_p);
+void       axis_printStatus(void);
+void       axis_benchmark(UINT axisCount_p, UINT cycleCount_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_axis_H_ */
@@ -0,0 +1,617 @@
+/**
+********************************************************************************
+\file   capfile.c
+
+\brief  Capture file reader
+
+This file contains the reader of pcap and pcapng capture files used by the
+POWERLINK capture analyzer.
+
+The file is mapped into memory and is not modified, so several threads can
+decode different parts of it. The records of a capture file can only be
+located by walking from the start of the file. A thread which starts in the
+middle of the file searches the next offset at which a chain of valid
+records begins (capfile_findBlock()). The caller verifies that the walk of
+the previous part ends at the found offset.
+
+Supported are pcap files with microsecond and nanosecond timestamps in
+either byte order, and pcapng files with one section of Ethernet interfaces.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "capfile.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CAPFILE_PCAP_MAGIC_US       0xA1B2C3D4  // pcap with microsecond timestamps
+#define CAPFILE_PCAP_MAGIC_NS       0xA1B23C4D  // pcap with nanosecond timestamps
+#define CAPFILE_PCAP_HEADER_SIZE    24          // size of the pcap file header
+#define CAPFILE_PCAP_RECORD_SIZE    16          // size of a pcap record header
+#define CAPFILE_LINKTYPE_ETHERNET   1
+
+#define CAPFILE_BLOCK_SHB           0x0A0D0D0A  // section header block
+#define CAPFILE_BLOCK_IDB           0x00000001  // interface description block
+#define CAPFILE_BLOCK_PB            0x00000002  // packet block (obsolete)
+#define CAPFILE_BLOCK_SPB           0x00000003  // simple packet block
+#define CAPFILE_BLOCK_EPB           0x00000006  // enhanced packet block
+#define CAPFILE_BLOCK_LAST_STANDARD 0x0000000A  // highest standard block type
+#define CAPFILE_BLOCK_CUSTOM        0x00000BAD  // custom block
+#define CAPFILE_BYTE_ORDER_MAGIC    0x1A2B3C4D
+#define CAPFILE_BLOCK_MIN_SIZE      12          // type, length and trailing length
+#define CAPFILE_PACKET_HEADER_SIZE  28          // block header up to the packet data (EPB, PB)
+#define CAPFILE_OPT_END             0
+#define CAPFILE_OPT_IF_TSRESOL      9
+
+#define CAPFILE_MAX_CAPLEN          262144      // largest frame accepted from any capture
+#define CAPFILE_SYNC_BLOCKS         8           // valid blocks required to find the next block
+#define CAPFILE_SYNC_MAX_GAP        3600        // maximum time between two records [s]
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError   openPcap(tCapFile* pFile_p);
+static tOplkError   openPcapng(tCapFile* pFile_p);
+static void         readInterface(tCapFile* pFile_p, UINT64 offset_p, UINT blockSize_p);
+static UINT         readPcapRecord(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p);
+static UINT         readPcapngBlock(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p,
+                                    BOOL* pfFrame_p);
+static BOOL         isChainValid(const tCapFile* pFile_p, UINT64 offset_p);
+static UINT16       readUint16(const tCapFile* pFile_p, UINT64 offset_p);
+static UINT32       readUint32(const tCapFile* pFile_p, UINT64 offset_p);
+static UINT64       ticksToNs(UINT64 ticks_p, UINT64 ticksPerSec_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a capture file
+
+The function maps a capture file and reads its header.
+
+\param  pszFileName_p           File name of the capture.
+\param  pFile_p                 Pointer to the capture file to initialize.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError capfile_open(const char* pszFileName_p, tCapFile* pFile_p)
+{
+    tOplkError  ret;
+
+    memset(pFile_p, 0, sizeof(tCapFile));
+    if (system_mapFile(pszFileName_p, &pFile_p->map) != 0)
+    {
+        fprintf(stderr, "Unable to map capture file %s!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+
+    pFile_p->pBase = (const BYTE*)pFile_p->map.pBase;
+    pFile_p->size = pFile_p->map.size;
+
+    if ((pFile_p->size >= CAPFILE_BLOCK_MIN_SIZE) && (readUint32(pFile_p, 0) == CAPFILE_BLOCK_SHB))
+        ret = openPcapng(pFile_p);
+    else
+        ret = openPcap(pFile_p);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "%s is not a pcap or pcapng capture of an Ethernet interface!\n", pszFileName_p);
+        capfile_close(pFile_p);
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a capture file
+
+\param  pFile_p                 Capture file.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void capfile_close(tCapFile* pFile_p)
+{
+    system_unmapFile(&pFile_p->map);
+    memset(pFile_p, 0, sizeof(tCapFile));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a block of a capture file
+
+The function reads the record (pcap) or block (pcapng) at the given offset.
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the block.
+\param  pRecord_p               Pointer to store the frame.
+\param  pfFrame_p               Pointer to store whether the block contains a
+                                frame. Blocks without a frame (e.g. statistics)
+                                are skipped by the caller.
+
+\return The function returns the size of the block, or 0 if there is no valid
+        block at the offset.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT capfile_readBlock(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p,
+                       BOOL* pfFrame_p)
+{
+    if (pFile_p->fPcapng)
+        return readPcapngBlock(pFile_p, offset_p, pRecord_p, pfFrame_p);
+
+    *pfFrame_p = TRUE;
+    return readPcapRecord(pFile_p, offset_p, pRecord_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find the next block of a capture file
+
+The function searches the first offset at or after the given offset at which
+a chain of valid blocks begins.
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset to start the search.
+
+\return The function returns the offset of the block, or the size of the file
+        if there is none.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT64 capfile_findBlock(const tCapFile* pFile_p, UINT64 offset_p)
+{
+    if (offset_p < pFile_p->dataOffset)
+        return pFile_p->dataOffset;
+
+    // pcapng blocks are aligned to 32 bits
+    if (pFile_p->fPcapng)
+        offset_p = (offset_p + 3) & ~(UINT64)3;
+
+    for (; offset_p < pFile_p->size; offset_p += pFile_p->fPcapng ? 4 : 1)
+    {
+        if (isChainValid(pFile_p, offset_p))
+            return offset_p;
+    }
+
+    return pFile_p->size;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the header of a pcap file
+
+\param  pFile_p                 Capture file.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openPcap(tCapFile* pFile_p)
+{
+    UINT32  magic;
+
+    if (pFile_p->size < CAPFILE_PCAP_HEADER_SIZE)
+        return kErrorApiInvalidParam;
+
+    // the magic number is written in the byte order of the capturing host
+    magic = readUint32(pFile_p, 0);
+    pFile_p->fSwapped = ((magic == 0xD4C3B2A1) || (magic == 0x4D3CB2A1));
+    if (pFile_p->fSwapped)
+        magic = readUint32(pFile_p, 0);
+
+    if (magic == CAPFILE_PCAP_MAGIC_US)
+        pFile_p->aTicksPerSec[0] = 1000000;
+    else if (magic == CAPFILE_PCAP_MAGIC_NS)
+        pFile_p->aTicksPerSec[0] = 1000000000;
+    else
+        return kErrorApiInvalidParam;
+
+    if (readUint32(pFile_p, 20) != CAPFILE_LINKTYPE_ETHERNET)
+        return kErrorApiInvalidParam;
+
+    pFile_p->snapLen = readUint32(pFile_p, 16);
+    pFile_p->interfaceCount = 1;
+    pFile_p->dataOffset = CAPFILE_PCAP_HEADER_SIZE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the header blocks of a pcapng file
+
+The function reads the section header and the interface descriptions in
+front of the first packet.
+
+\param  pFile_p                 Capture file.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openPcapng(tCapFile* pFile_p)
+{
+    UINT64  offset = 0;
+    UINT32  type;
+    UINT32  blockSize;
+
+    if (pFile_p->size < CAPFILE_BLOCK_MIN_SIZE + 4)
+        return kErrorApiInvalidParam;
+
+    pFile_p->fSwapped = (readUint32(pFile_p, 8) != CAPFILE_BYTE_ORDER_MAGIC);
+    if (readUint32(pFile_p, 8) != CAPFILE_BYTE_ORDER_MAGIC)
+        return kErrorApiInvalidParam;
+
+    while (offset + CAPFILE_BLOCK_MIN_SIZE <= pFile_p->size)
+    {
+        type = readUint32(pFile_p, offset);
+        blockSize = readUint32(pFile_p, offset + 4);
+        if ((blockSize < CAPFILE_BLOCK_MIN_SIZE) || ((blockSize & 3) != 0) ||
+            (offset + blockSize > pFile_p->size))
+            return kErrorApiInvalidParam;
+
+        if ((type == CAPFILE_BLOCK_EPB) || (type == CAPFILE_BLOCK_PB) || (type == CAPFILE_BLOCK_SPB))
+            break;
+
+        if (type == CAPFILE_BLOCK_IDB)
+        {
+            if ((blockSize < 20) || (readUint16(pFile_p, offset + 8) != CAPFILE_LINKTYPE_ETHERNET))
+                return kErrorApiInvalidParam;
+
+            readInterface(pFile_p, offset, blockSize);
+        }
+
+        offset += blockSize;
+    }
+
+    if (pFile_p->interfaceCount == 0)
+        return kErrorApiInvalidParam;
+
+    pFile_p->fPcapng = TRUE;
+    pFile_p->dataOffset = offset;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an interface description block
+
+The function stores the snap length and the timestamp resolution of an
+interface.
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the block.
+\param  blockSize_p             Size of the block.
+*/
+//------------------------------------------------------------------------------
+static void readInterface(tCapFile* pFile_p, UINT64 offset_p, UINT blockSize_p)
+{
+    UINT64  optOffset = offset_p + 16;
+    UINT64  optEnd = offset_p + blockSize_p - 4;
+    UINT64  ticksPerSec = 1000000;
+    UINT16  code;
+    UINT16  length;
+    UINT    resolution;
+    UINT32  snapLen = readUint32(pFile_p, offset_p + 12);
+
+    while (optOffset + 4 <= optEnd)
+    {
+        code = readUint16(pFile_p, optOffset);
+        length = readUint16(pFile_p, optOffset + 2);
+        if ((code == CAPFILE_OPT_END) || (optOffset + 4 + length > optEnd))
+            break;
+
+        if ((code == CAPFILE_OPT_IF_TSRESOL) && (length >= 1))
+        {
+            // negative power of 10, or of 2 if the MSB is set
+            resolution = pFile_p->pBase[optOffset + 4];
+            if ((resolution & 0x80) != 0)
+                ticksPerSec = (UINT64)1 << ((resolution & 0x7F) > 63 ? 63 : (resolution & 0x7F));
+            else
+                for (ticksPerSec = 1; (resolution > 0) && (ticksPerSec < 1000000000000000000ULL); resolution--)
+                    ticksPerSec *= 10;
+        }
+
+        optOffset += 4 + ((length + 3) & ~3);
+    }
+
+    if ((snapLen == 0) || (snapLen > pFile_p->snapLen))
+        pFile_p->snapLen = (snapLen == 0) ? CAPFILE_MAX_CAPLEN : snapLen;
+
+    if (pFile_p->interfaceCount < CAPFILE_MAX_INTERFACES)
+        pFile_p->aTicksPerSec[pFile_p->interfaceCount++] = ticksPerSec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a pcap record
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the record.
+\param  pRecord_p               Pointer to store the frame.
+
+\return The function returns the size of the record or 0 if it is not valid.
+*/
+//------------------------------------------------------------------------------
+static UINT readPcapRecord(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p)
+{
+    UINT32  seconds;
+    UINT32  fraction;
+    UINT32  capLen;
+    UINT32  origLen;
+
+    if (offset_p + CAPFILE_PCAP_RECORD_SIZE > pFile_p->size)
+        return 0;
+
+    seconds = readUint32(pFile_p, offset_p);
+    fraction = readUint32(pFile_p, offset_p + 4);
+    capLen = readUint32(pFile_p, offset_p + 8);
+    origLen = readUint32(pFile_p, offset_p + 12);
+
+    if ((fraction >= pFile_p->aTicksPerSec[0]) || (capLen == 0) ||
+        (capLen > CAPFILE_MAX_CAPLEN) || (capLen > origLen) || (origLen > CAPFILE_MAX_CAPLEN) ||
+        (offset_p + CAPFILE_PCAP_RECORD_SIZE + capLen > pFile_p->size))
+        return 0;
+
+    pRecord_p->timeNs = (UINT64)seconds * 1000000000ULL +
+                        (UINT64)fraction * (1000000000ULL / pFile_p->aTicksPerSec[0]);
+    pRecord_p->pData = pFile_p->pBase + (size_t)offset_p + CAPFILE_PCAP_RECORD_SIZE;
+    pRecord_p->capLen = capLen;
+    pRecord_p->origLen = origLen;
+
+    return CAPFILE_PCAP_RECORD_SIZE + capLen;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a pcapng block
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the block.
+\param  pRecord_p               Pointer to store the frame.
+\param  pfFrame_p               Pointer to store whether the block contains a
+                                frame.
+
+\return The function returns the size of the block or 0 if it is not valid.
+*/
+//------------------------------------------------------------------------------
+static UINT readPcapngBlock(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p,
+                            BOOL* pfFrame_p)
+{
+    UINT32  type;
+    UINT32  blockSize;
+    UINT32  interfaceId;
+    UINT32  capLen;
+    UINT64  ticks;
+
+    if (offset_p + CAPFILE_BLOCK_MIN_SIZE > pFile_p->size)
+        return 0;
+
+    type = readUint32(pFile_p, offset_p);
+    blockSize = readUint32(pFile_p, offset_p + 4);
+    if ((blockSize < CAPFILE_BLOCK_MIN_SIZE) || ((blockSize & 3) != 0) ||
+        (offset_p + blockSize > pFile_p->size) ||
+        (readUint32(pFile_p, offset_p + blockSize - 4) != blockSize))
+        return 0;
+
+    *pfFrame_p = FALSE;
+    if ((type == CAPFILE_BLOCK_EPB) || (type == CAPFILE_BLOCK_PB))
+    {
+        if (blockSize < CAPFILE_PACKET_HEADER_SIZE + 4)
+            return 0;
+
+        // the obsolete packet block has a 16 bit interface ID and a drop counter
+        interfaceId = (type == CAPFILE_BLOCK_EPB) ? readUint32(pFile_p, offset_p + 8) :
+                                                    readUint16(pFile_p, offset_p + 8);
+        capLen = readUint32(pFile_p, offset_p + 20);
+        if ((interfaceId >= pFile_p->interfaceCount) ||
+            (CAPFILE_PACKET_HEADER_SIZE + capLen + 4 > blockSize))
+            return 0;
+
+        ticks = ((UINT64)readUint32(pFile_p, offset_p + 12) << 32) | readUint32(pFile_p, offset_p + 16);
+        pRecord_p->timeNs = ticksToNs(ticks, pFile_p->aTicksPerSec[interfaceId]);
+        pRecord_p->pData = pFile_p->pBase + (size_t)offset_p + CAPFILE_PACKET_HEADER_SIZE;
+        pRecord_p->capLen = capLen;
+        pRecord_p->origLen = readUint32(pFile_p, offset_p + 24);
+        *pfFrame_p = (capLen > 0);
+    }
+    else if ((type == 0) ||
+             ((type > CAPFILE_BLOCK_LAST_STANDARD) && (type != CAPFILE_BLOCK_SHB) &&
+              ((type & 0x0FFFFFFF) != CAPFILE_BLOCK_CUSTOM) && ((type & 0x80000000) == 0)))
+    {
+        // unknown standard block type, most likely not a block boundary
+        return 0;
+    }
+
+    return blockSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a chain of blocks
+
+The function checks whether a chain of valid blocks begins at an offset. The
+timestamps of consecutive frames must be close to each other.
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the first block.
+
+\return The function returns TRUE if the chain is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL isChainValid(const tCapFile* pFile_p, UINT64 offset_p)
+{
+    tCapRecord  record;
+    UINT64      lastTimeNs = 0;
+    BOOL        fFrame;
+    BOOL        fFirst = TRUE;
+    UINT        size;
+    UINT        i;
+
+    for (i = 0; i < CAPFILE_SYNC_BLOCKS; i++)
+    {
+        // a chain which ends exactly at the end of the file is complete
+        if (offset_p == pFile_p->size)
+            return (i > 0);
+
+        size = capfile_readBlock(pFile_p, offset_p, &record, &fFrame);
+        if (size == 0)
+            return FALSE;
+
+        if (fFrame)
+        {
+            if (!fFirst &&
+                ((record.timeNs + CAPFILE_SYNC_MAX_GAP * 1000000000ULL < lastTimeNs) ||
+                 (record.timeNs > lastTimeNs + CAPFILE_SYNC_MAX_GAP * 1000000000ULL)))
+                return FALSE;
+
+            lastTimeNs = record.timeNs;
+            fFirst = FALSE;
+        }
+
+        offset_p += size;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a 16 bit value in the byte order of the file
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the value.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT16 readUint16(const tCapFile* pFile_p, UINT64 offset_p)
+{
+    const BYTE* pData = pFile_p->pBase + (size_t)offset_p;
+
+    if (pFile_p->fSwapped)
+        return (UINT16)((pData[0] << 8) | pData[1]);
+
+    return (UINT16)(pData[0] | (pData[1] << 8));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a 32 bit value in the byte order of the file
+
+\param  pFile_p                 Capture file.
+\param  offset_p                Offset of the value.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readUint32(const tCapFile* pFile_p, UINT64 offset_p)
+{
+    const BYTE* pData = pFile_p->pBase + (size_t)offset_p;
+
+    if (pFile_p->fSwapped)
+        return ((UINT32)pData[0] << 24) | ((UINT32)pData[1] << 16) | ((UINT32)pData[2] << 8) | pData[3];
+
+    return (UINT32)pData[0] | ((UINT32)pData[1] << 8) | ((UINT32)pData[2] << 16) | ((UINT32)pData[3] << 24);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert a timestamp to nanoseconds
+
+\param  ticks_p                 Timestamp.
+\param  ticksPerSec_p           Resolution of the timestamp.
+
+\return The function returns the timestamp in nanoseconds.
+*/
+//------------------------------------------------------------------------------
+static UINT64 ticksToNs(UINT64 ticks_p, UINT64 ticksPerSec_p)
+{
+    if (ticksPerSec_p == 1000000000ULL)
+        return ticks_p;
+
+    if (ticksPerSec_p == 1000000ULL)
+        return ticks_p * 1000ULL;
+
+    return (ticks_p / ticksPerSec_p) * 1000000000ULL +
+           (UINT64)((double)(ticks_p % ticksPerSec_p) * 1e9 / (double)ticksPerSec_p);
+}
+
+/// \}
@@ -0,0 +1,106 @@
+/**
+********************************************************************************
+\file   capfile.h
+
+\brief  Definitions for the capture file reader
+
+This file contains the definitions for the reader of pcap and pcapng capture
+files used by the POWERLINK capture analyzer.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_capfile_H_
+#define _INC_capfile_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CAPFILE_MAX_INTERFACES      8       ///< Maximum number of interfaces of a pcapng file
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Capture file
+
+The structure describes an opened capture file. It is not modified after
+capfile_open(), so the file can be read by several threads.
+*/
+typedef struct
+{
+    tSystemMappedFile   map;                                    ///< Mapped file
+    const BYTE*         pBase;                                  ///< Start of the file
+    UINT64              size;                                   ///< Size of the file [bytes]
+    UINT64              dataOffset;                             ///< Offset of the first record
+    BOOL                fPcapng;                                ///< File is in pcapng format
+    BOOL                fSwapped;                               ///< File has the other byte order
+    UINT32              snapLen;                                ///< Maximum captured frame size
+    UINT64              aTicksPerSec[CAPFILE_MAX_INTERFACES];   ///< Timestamp resolution per interface
+    UINT                interfaceCount;                         ///< Number of interfaces
+} tCapFile;
+
+/**
+\brief  Captured frame
+
+The structure describes a frame read from a capture file.
+*/
+typedef struct
+{
+    UINT64              timeNs;             ///< Capture time [ns since 1970-01-01 UTC]
+    const BYTE*         pData;              ///< Captured frame data
+    UINT                capLen;             ///< Number of captured bytes
+    UINT                origLen;            ///< Size of the frame on the wire (without FCS)
+} tCapRecord;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError capfile_open(const char* pszFileName_p, tCapFile* pFile_p);
+void       capfile_close(tCapFile* pFile_p);
+UINT       capfile_readBlock(const tCapFile* pFile_p, UINT64 offset_p, tCapRecord* pRecord_p,
+                             BOOL* pfFrame_p);
+UINT64     capfile_findBlock(const tCapFile* pFile_p, UINT64 offset_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_capfile_H_ */
@@ -0,0 +1,773 @@
+/**
+********************************************************************************
+\file   cdc.c
+
+\brief  Concise device configuration module
+
+This file contains the concise device configuration (CDC) module of the MN
+demo application. The module loads the CDC file into memory, provides a
+fingerprint of the configuration and functions to access the object entries of
+the CDC and of the concise DCFs of the CNs contained in it.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "cdc.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CDC_CRC32_POLYNOMIAL    0xEDB88320UL        // reflected IEEE 802.3 polynomial
+#define CDC_COUNT_SIZE          4                   // size of the entry count
+#define CDC_ENTRY_HEADER_SIZE   7                   // index (2), sub-index (1), size (4)
+#define CDC_CONF_TIME_INDEX     0x1020              // CFM_VerifyConfiguration_REC
+#define CDC_CONF_TIME_SUBINDEX  0x02                // ConfTime_U32
+#define CDC_EXP_CONF_TIME_INDEX 0x1F27              // CFM_ExpConfTimeList_AU32
+#define CDC_MS_PER_DAY          86400000UL          // range of the configuration time
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  CDC module instance
+
+The structure contains the local variables of the CDC module.
+*/
+typedef struct
+{
+    BYTE*       pCdcBuffer;             ///< CDC file contents
+    UINT        cdcSize;                ///< Size of the CDC in bytes
+    UINT32      fingerprint;            ///< CRC32 over the CDC contents
+} tCdcInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCdcInstance     cdcInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT32 readUint32Le(const BYTE* pData_p);
+static void writeUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p);
+static tOplkError setEntryData(BYTE** ppCdc_p, UINT* pSize_p, UINT index_p, UINT subIndex_p,
+                               const BYTE* pData_p, UINT dataSize_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the CDC module
+
+The function loads the given CDC file into memory and calculates its
+fingerprint.
+
+\param  pszCdcFileName_p        File name of the CDC.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_init(const char* pszCdcFileName_p)
+{
+    FILE*       pFile;
+    long        fileSize;
+
+    memset(&cdcInstance_l, 0, sizeof(cdcInstance_l));
+
+    pFile = fopen(pszCdcFileName_p, "rb");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open CDC file %s!\n", pszCdcFileName_p);
+        return kErrorNoResource;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    fileSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    if (fileSize <= 0)
+    {
+        fclose(pFile);
+        fprintf(stderr, "CDC file %s is empty!\n", pszCdcFileName_p);
+        return kErrorNoResource;
+    }
+
+    cdcInstance_l.pCdcBuffer = (BYTE*)malloc((size_t)fileSize);
+    if (cdcInstance_l.pCdcBuffer == NULL)
+    {
+        fclose(pFile);
+        return kErrorNoResource;
+    }
+
+    if (fread(cdcInstance_l.pCdcBuffer, 1, (size_t)fileSize, pFile) != (size_t)fileSize)
+    {
+        fclose(pFile);
+        cdc_exit();
+        fprintf(stderr, "Unable to read CDC file %s!\n", pszCdcFileName_p);
+        return kErrorNoResource;
+    }
+    fclose(pFile);
+
+    cdcInstance_l.cdcSize = (UINT)fileSize;
+    cdcInstance_l.fingerprint = cdc_calcCrc32(0, cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcSize);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shutdown the CDC module
+
+The function frees the memory used by the CDC module.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cdc_exit(void)
+{
+    free(cdcInstance_l.pCdcBuffer);
+    cdcInstance_l.pCdcBuffer = NULL;
+    cdcInstance_l.cdcSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the CDC buffer
+
+The function returns the loaded CDC.
+
+\param  pSize_p                 Pointer to store the size of the CDC.
+
+\return The function returns a pointer to the CDC or NULL if no CDC is loaded.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BYTE* cdc_getBuffer(UINT* pSize_p)
+{
+    if (pSize_p != NULL)
+        *pSize_p = cdcInstance_l.cdcSize;
+
+    return cdcInstance_l.pCdcBuffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the configuration fingerprint
+
+The function returns the fingerprint (CRC32) of the loaded CDC.
+
+\return The function returns the configuration fingerprint.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT32 cdc_getFingerprint(void)
+{
+    return cdcInstance_l.fingerprint;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Validate the loaded CDC
+
+The function checks the structure of the loaded CDC. All entries must be
+contained completely in the CDC, and the concise DCFs of the CNs must be valid
+CDCs themselves. The check allows to reject a corrupted configuration before
+it is passed to the stack.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_validate(void)
+{
+    tCdcCursor      cursor;
+    tCdcCursor      dcfCursor;
+    tCdcEntry       entry;
+    tCdcEntry       dcfEntry;
+
+    if (cdc_openCursor(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcSize, &cursor) != kErrorOk)
+        return kErrorObdInvalidDcf;
+
+    while (cdc_nextEntry(&cursor, &entry))
+    {
+        if ((entry.index != CDC_DCF_LIST_INDEX) || (entry.size == 0))
+            continue;
+
+        if (cdc_openCursor(entry.pData, entry.size, &dcfCursor) != kErrorOk)
+            return kErrorObdInvalidDcf;
+
+        while (cdc_nextEntry(&dcfCursor, &dcfEntry))
+            ;
+
+        if (dcfCursor.remainingEntries != 0)
+            return kErrorObdInvalidDcf;
+    }
+
+    if (cursor.remainingEntries != 0)
+        return kErrorObdInvalidDcf;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate CRC32
+
+The function calculates the IEEE 802.3 CRC32 over the given data. The CRC of
+non-contiguous data can be calculated by passing the result of the previous
+call as start value.
+
+\param  crc_p                   Start value (0 for a new calculation).
+\param  pData_p                 Pointer to the data.
+\param  size_p                  Size of the data in bytes.
+
+\return The function returns the CRC32 of the data.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT32 cdc_calcCrc32(UINT32 crc_p, const void* pData_p, UINT size_p)
+{
+    const BYTE*     pData = (const BYTE*)pData_p;
+    UINT32          crc = ~crc_p;
+    UINT            i;
+    int             bit;
+
+    for (i = 0; i < size_p; i++)
+    {
+        crc ^= pData[i];
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (CDC_CRC32_POLYNOMIAL & (0 - (crc & 1)));
+    }
+
+    return ~crc;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a CDC cursor
+
+The function initializes a cursor for iterating over the entries of the given
+CDC or concise DCF.
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  pCursor_p               Pointer to the cursor to initialize.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_openCursor(const BYTE* pCdc_p, UINT size_p, tCdcCursor* pCursor_p)
+{
+    if ((pCdc_p == NULL) || (size_p < CDC_COUNT_SIZE))
+        return kErrorApiInvalidParam;
+
+    pCursor_p->pCdc = pCdc_p;
+    pCursor_p->size = size_p;
+    pCursor_p->offset = CDC_COUNT_SIZE;
+    pCursor_p->remainingEntries = readUint32Le(pCdc_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get next CDC entry
+
+The function reads the next entry from a CDC cursor.
+
+\param  pCursor_p               Pointer to the cursor.
+\param  pEntry_p                Pointer to store the entry.
+
+\return The function returns TRUE if an entry was read or FALSE if the end of
+        the CDC is reached or the CDC is truncated.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL cdc_nextEntry(tCdcCursor* pCursor_p, tCdcEntry* pEntry_p)
+{
+    const BYTE*     pEntry;
+    UINT32          dataSize;
+
+    if (pCursor_p->remainingEntries == 0)
+        return FALSE;
+
+    if ((pCursor_p->size - pCursor_p->offset) < CDC_ENTRY_HEADER_SIZE)
+        return FALSE;
+
+    pEntry = pCursor_p->pCdc + pCursor_p->offset;
+    dataSize = readUint32Le(pEntry + 3);
+    if (dataSize > (pCursor_p->size - pCursor_p->offset - CDC_ENTRY_HEADER_SIZE))
+        return FALSE;
+
+    pEntry_p->index = (UINT16)(pEntry[0] | (pEntry[1] << 8));
+    pEntry_p->subIndex = pEntry[2];
+    pEntry_p->size = dataSize;
+    pEntry_p->pData = pEntry + CDC_ENTRY_HEADER_SIZE;
+
+    pCursor_p->offset += CDC_ENTRY_HEADER_SIZE + dataSize;
+    pCursor_p->remainingEntries--;
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find a CDC entry
+
+The function searches the given CDC or concise DCF for an object entry. If the
+object is contained multiple times, the last entry is returned because it
+determines the final value of the object.
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  index_p                 Object index to search for.
+\param  subIndex_p              Object sub-index to search for.
+\param  pEntry_p                Pointer to store the found entry.
+
+\return The function returns TRUE if the entry was found, otherwise FALSE.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL cdc_findEntry(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                   tCdcEntry* pEntry_p)
+{
+    tCdcCursor      cursor;
+    tCdcEntry       entry;
+    BOOL            fFound = FALSE;
+
+    if (cdc_openCursor(pCdc_p, size_p, &cursor) != kErrorOk)
+        return FALSE;
+
+    while (cdc_nextEntry(&cursor, &entry))
+    {
+        if ((entry.index == index_p) && (entry.subIndex == subIndex_p))
+        {
+            *pEntry_p = entry;
+            fFound = TRUE;
+        }
+    }
+
+    return fFound;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the concise DCF of a CN
+
+The function returns the concise DCF of the given CN which is contained in
+the loaded CDC (object 0x1F22).
+
+\param  nodeId_p                Node ID of the CN.
+\param  ppDcf_p                 Pointer to store the address of the concise DCF.
+\param  pSize_p                 Pointer to store the size of the concise DCF.
+
+\return The function returns TRUE if the CDC contains a concise DCF for the
+        node, otherwise FALSE.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL cdc_getNodeDcf(UINT nodeId_p, const BYTE** ppDcf_p, UINT* pSize_p)
+{
+    tCdcEntry       entry;
+
+    if (!cdc_findEntry(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcSize,
+                       CDC_DCF_LIST_INDEX, nodeId_p, &entry))
+        return FALSE;
+
+    if (entry.size < CDC_COUNT_SIZE)
+        return FALSE;
+
+    *ppDcf_p = entry.pData;
+    *pSize_p = entry.size;
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the value of a CDC entry
+
+The function converts the little endian data of a CDC entry with up to 8 bytes
+into an integer value.
+
+\param  pEntry_p                Pointer to the entry.
+
+\return The function returns the value of the entry.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT64 cdc_getEntryValue(const tCdcEntry* pEntry_p)
+{
+    UINT64          value = 0;
+    UINT            i;
+
+    for (i = 0; (i < pEntry_p->size) && (i < sizeof(value)); i++)
+        value |= (UINT64)pEntry_p->pData[i] << (i * 8);
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set an object value in the loaded CDC
+
+The function sets the value of an object of the MN in the loaded CDC. If the
+object is contained in the CDC, its last entry is modified. Otherwise, a new
+entry is appended. The fingerprint is updated.
+
+\note   The CDC buffer may be reallocated. Pointers into the CDC obtained
+        before are invalid afterwards.
+
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  value_p                 Object value.
+\param  size_p                  Size of the object in bytes (1 to 8).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_setEntry(UINT index_p, UINT subIndex_p, UINT64 value_p, UINT size_p)
+{
+    BYTE            aData[8];
+    tOplkError      ret;
+
+    if ((size_p == 0) || (size_p > sizeof(aData)))
+        return kErrorApiInvalidParam;
+
+    writeUintLe(aData, value_p, size_p);
+    ret = setEntryData(&cdcInstance_l.pCdcBuffer, &cdcInstance_l.cdcSize,
+                       index_p, subIndex_p, aData, size_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    cdcInstance_l.fingerprint = cdc_calcCrc32(0, cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcSize);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set an object value in the concise DCF of a CN
+
+The function sets the value of an object in the concise DCF of the given CN,
+which is contained in the loaded CDC. If the object is contained in the DCF,
+its last entry is modified. Otherwise, a new entry is appended to the DCF.
+The fingerprint is updated.
+
+\note   The CDC buffer may be reallocated. Pointers into the CDC obtained
+        before are invalid afterwards.
+
+\param  nodeId_p                Node ID of the CN.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  value_p                 Object value.
+\param  size_p                  Size of the object in bytes (1 to 8).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_setNodeEntry(UINT nodeId_p, UINT index_p, UINT subIndex_p,
+                            UINT64 value_p, UINT size_p)
+{
+    BYTE            aData[8];
+    const BYTE*     pDcf;
+    UINT            dcfSize;
+    BYTE*           pCopy;
+    tOplkError      ret;
+
+    if ((size_p == 0) || (size_p > sizeof(aData)))
+        return kErrorApiInvalidParam;
+
+    if (!cdc_getNodeDcf(nodeId_p, &pDcf, &dcfSize))
+        return kErrorInvalidNodeId;
+
+    // modify a copy of the DCF and replace the DCF entry afterwards
+    pCopy = (BYTE*)malloc(dcfSize);
+    if (pCopy == NULL)
+        return kErrorNoResource;
+    memcpy(pCopy, pDcf, dcfSize);
+
+    writeUintLe(aData, value_p, size_p);
+    ret = setEntryData(&pCopy, &dcfSize, index_p, subIndex_p, aData, size_p);
+    if (ret == kErrorOk)
+    {
+        ret = setEntryData(&cdcInstance_l.pCdcBuffer, &cdcInstance_l.cdcSize,
+                           CDC_DCF_LIST_INDEX, nodeId_p, pCopy, dcfSize);
+    }
+    free(pCopy);
+
+    if (ret != kErrorOk)
+        return ret;
+
+    cdcInstance_l.fingerprint = cdc_calcCrc32(0, cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcSize);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the configuration time of a node
+
+The function sets a new configuration time in the DCF of a node (0x1020/2)
+and in the expected configuration time list of the MN (0x1F27), so the
+configuration manager downloads a modified DCF. The time is derived from the
+DCF contents, so repeated modifications give the same result.
+
+\param  nodeId_p                Node ID of the CN.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_updateConfTime(UINT nodeId_p)
+{
+    const BYTE*     pDcf;
+    UINT            dcfSize;
+    UINT32          confTime;
+    tOplkError      ret;
+
+    if (!cdc_getNodeDcf(nodeId_p, &pDcf, &dcfSize))
+        return kErrorInvalidNodeId;
+    confTime = cdc_calcCrc32(0, pDcf, dcfSize) % CDC_MS_PER_DAY;
+
+    ret = cdc_setNodeEntry(nodeId_p, CDC_CONF_TIME_INDEX, CDC_CONF_TIME_SUBINDEX, confTime, 4);
+    if (ret == kErrorOk)
+        ret = cdc_setEntry(CDC_EXP_CONF_TIME_INDEX, nodeId_p, confTime, 4);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Save the loaded CDC
+
+The function writes the loaded CDC, including all modifications, to a file.
+
+\param  pszCdcFileName_p        File name of the CDC.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cdc_save(const char* pszCdcFileName_p)
+{
+    FILE*       pFile;
+    size_t      written;
+
+    pFile = fopen(pszCdcFileName_p, "wb");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to create CDC file %s!\n", pszCdcFileName_p);
+        return kErrorNoResource;
+    }
+
+    written = fwrite(cdcInstance_l.pCdcBuffer, 1, cdcInstance_l.cdcSize, pFile);
+    fclose(pFile);
+
+    if (written != cdcInstance_l.cdcSize)
+    {
+        fprintf(stderr, "Unable to write CDC file %s!\n", pszCdcFileName_p);
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read 32 bit little endian value
+
+\param  pData_p                 Pointer to the value.
+
+\return The function returns the value in host byte order.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readUint32Le(const BYTE* pData_p)
+{
+    return (UINT32)pData_p[0] | ((UINT32)pData_p[1] << 8) |
+           ((UINT32)pData_p[2] << 16) | ((UINT32)pData_p[3] << 24);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write a little endian value
+
+\param  pData_p                 Pointer to store the value.
+\param  value_p                 Value to write.
+\param  size_p                  Size of the value in bytes.
+*/
+//------------------------------------------------------------------------------
+static void writeUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p)
+{
+    UINT    i;
+
+    for (i = 0; i < size_p; i++)
+        pData_p[i] = (BYTE)(value_p >> (i * 8));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the data of an entry in a CDC buffer
+
+The function sets the data of the last entry of the given object in a CDC or
+concise DCF buffer. If the size of the data is unchanged, the data is
+overwritten in place. Otherwise, the buffer is rebuilt. If the object is not
+contained, a new entry is appended and the entry count is incremented.
+
+\param  ppCdc_p                 Pointer to the malloc'ed CDC buffer. The buffer
+                                may be reallocated.
+\param  pSize_p                 Pointer to the size of the CDC buffer.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  pData_p                 New data of the entry.
+\param  dataSize_p              Size of the new data in bytes.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setEntryData(BYTE** ppCdc_p, UINT* pSize_p, UINT index_p, UINT subIndex_p,
+                               const BYTE* pData_p, UINT dataSize_p)
+{
+    tCdcCursor      cursor;
+    tCdcEntry       entry;
+    UINT            entryOffset = 0;
+    UINT            oldDataSize = 0;
+    BOOL            fFound = FALSE;
+    BYTE*           pNew;
+    UINT            newSize;
+    UINT            tailOffset;
+
+    if (cdc_openCursor(*ppCdc_p, *pSize_p, &cursor) != kErrorOk)
+        return kErrorApiInvalidParam;
+
+    while (cdc_nextEntry(&cursor, &entry))
+    {
+        if ((entry.index == index_p) && (entry.subIndex == subIndex_p))
+        {
+            fFound = TRUE;
+            entryOffset = (UINT)(entry.pData - *ppCdc_p) - CDC_ENTRY_HEADER_SIZE;
+            oldDataSize = entry.size;
+        }
+    }
+
+    if (fFound && (oldDataSize == dataSize_p))
+    {
+        memcpy(*ppCdc_p + entryOffset + CDC_ENTRY_HEADER_SIZE, pData_p, dataSize_p);
+        return kErrorOk;
+    }
+
+    if (!fFound)
+    {
+        // append a new entry
+        entryOffset = *pSize_p;
+        tailOffset = *pSize_p;
+    }
+    else
+    {
+        tailOffset = entryOffset + CDC_ENTRY_HEADER_SIZE + oldDataSize;
+    }
+
+    newSize = entryOffset + CDC_ENTRY_HEADER_SIZE + dataSize_p + (*pSize_p - tailOffset);
+    pNew = (BYTE*)malloc(newSize);
+    if (pNew == NULL)
+        return kErrorNoResource;
+
+    memcpy(pNew, *ppCdc_p, entryOffset);
+    if (!fFound)
+        writeUintLe(pNew, readUint32Le(pNew) + 1, CDC_COUNT_SIZE);
+
+    writeUintLe(pNew + entryOffset, index_p, 2);
+    writeUintLe(pNew + entryOffset + 2, subIndex_p, 1);
+    writeUintLe(pNew + entryOffset + 3, dataSize_p, 4);
+    memcpy(pNew + entryOffset + CDC_ENTRY_HEADER_SIZE, pData_p, dataSize_p);
+    memcpy(pNew + entryOffset + CDC_ENTRY_HEADER_SIZE + dataSize_p,
+           *ppCdc_p + tailOffset, *pSize_p - tailOffset);
+
+    free(*ppCdc_p);
+    *ppCdc_p = pNew;
+    *pSize_p = newSize;
+
+    return kErrorOk;
+}
+
+/// \}
@@ -0,0 +1,111 @@
+/**
+********************************************************************************
+\file   cdc.h
+
+\brief  Definitions for the concise device configuration module
+
+The file contains the definitions for the concise device configuration (CDC)
+module of the MN demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_cdc_H_
+#define _INC_cdc_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CDC_DCF_LIST_INDEX      0x1F22      ///< Object containing the concise DCFs of the CNs
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  CDC entry
+
+The structure describes a single object entry of a CDC or concise DCF.
+*/
+typedef struct
+{
+    UINT16          index;                  ///< Object index
+    UINT8           subIndex;               ///< Object sub-index
+    UINT32          size;                   ///< Size of the object data in bytes
+    const BYTE*     pData;                  ///< Pointer to the object data (little endian)
+} tCdcEntry;
+
+/**
+\brief  CDC cursor
+
+The structure is used to iterate over the entries of a CDC or concise DCF.
+*/
+typedef struct
+{
+    const BYTE*     pCdc;                   ///< CDC to iterate
+    UINT            size;                   ///< Size of the CDC in bytes
+    UINT            offset;                 ///< Offset of the next entry
+    UINT32          remainingEntries;       ///< Number of entries not yet read
+} tCdcCursor;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError cdc_init(const char* pszCdcFileName_p);
+void       cdc_exit(void);
+BYTE*      cdc_getBuffer(UINT* pSize_p);
+UINT32     cdc_getFingerprint(void);
+tOplkError cdc_validate(void);
+UINT32     cdc_calcCrc32(UINT32 crc_p, const void* pData_p, UINT size_p);
+tOplkError cdc_openCursor(const BYTE* pCdc_p, UINT size_p, tCdcCursor* pCursor_p);
+BOOL       cdc_nextEntry(tCdcCursor* pCursor_p, tCdcEntry* pEntry_p);
+BOOL       cdc_findEntry(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                         tCdcEntry* pEntry_p);
+BOOL       cdc_getNodeDcf(UINT nodeId_p, const BYTE** ppDcf_p, UINT* pSize_p);
+UINT64     cdc_getEntryValue(const tCdcEntry* pEntry_p);
+tOplkError cdc_setEntry(UINT index_p, UINT subIndex_p, UINT64 value_p, UINT size_p);
+tOplkError cdc_setNodeEntry(UINT nodeId_p, UINT index_p, UINT subIndex_p,
+                            UINT64 value_p, UINT size_p);
+tOplkError cdc_updateConfTime(UINT nodeId_p);
+tOplkError cdc_save(const char* pszCdcFileName_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_cdc_H_ */
@@ -0,0 +1,429 @@
+/**
+********************************************************************************
+\file   cnemu.c
+
+\brief  CN emulator
+
+This file contains a tool which emulates a POWERLINK network of up to 239 CNs
+on one network interface of a PC. It is used to test the MN with large
+configurations without the hardware.
+
+The CNs are described by a configuration file (see cnode.c) and answer the
+frames of the MN with the object dictionaries of their XDCs. The frames are
+received by a busy polling thread which is bound to one CPU: the adapter is
+opened with the minimum delivery latency of WinPcap and polled without
+blocking, so the PRes is sent without a wake-up. The latency from the
+reception of a PReq to the transmission of the PRes is reported per CN.
+
+The MN and the emulator are connected by a cable or, on one PC, by two
+interfaces bridged by a switch.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pcap.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <getopt/getopt.h>
+#include <console/console.h>
+
+#include "cnode.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CNEMU_SNAPLEN               1518        // maximum captured frame size
+#define CNEMU_FILTER                "ether proto 0x88ab"
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Emulator options
+
+The structure contains the command line options of the CN emulator.
+*/
+typedef struct
+{
+    const char*     pszDevice;              ///< Network interface
+    const char*     pszNodeFile;            ///< CN configuration
+    int             cpu;                    ///< CPU of the receive thread, -1 if not bound
+    UINT            statsInterval;          ///< Statistics interval [s], 0 for none
+} tEmuOptions;
+
+/**
+\brief  Receive thread state
+
+The structure contains the state shared with the receive thread.
+*/
+typedef struct
+{
+    pcap_t*         pPcap;                  ///< Opened network interface
+    int             cpu;                    ///< CPU of the receive thread, -1 if not bound
+    volatile BOOL   fStop;                  ///< Stop request
+    volatile ULONG  frameCount;             ///< Received POWERLINK frames
+} tEmuRx;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int      getOptions(int argc_p, char** argv_p, tEmuOptions* pOpts_p);
+static void     listDevices(void);
+static pcap_t*  openDevice(const char* pszDevice_p);
+static void     rxThread(void* pArg_p);
+static int      sendFrame(const BYTE* pFrame_p, UINT size_p, void* pArg_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the CN emulator
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    tEmuOptions     opts;
+    tEmuRx          rx;
+    tSystemThread   thread;
+    UINT64          lastPrintNs;
+    UINT64          nowNs;
+    BOOL            fExit = FALSE;
+
+    if (getOptions(argc, argv, &opts) != 0)
+        return EXIT_FAILURE;
+
+    if (opts.pszDevice == NULL)
+    {
+        listDevices();
+        return EXIT_FAILURE;
+    }
+
+    if (system_init() != 0)
+    {
+        fprintf(stderr, "Error initializing system!");
+        return EXIT_FAILURE;
+    }
+
+    memset(&rx, 0, sizeof(rx));
+    rx.cpu = opts.cpu;
+    rx.pPcap = openDevice(opts.pszDevice);
+    if (rx.pPcap == NULL)
+    {
+        system_exit();
+        return EXIT_FAILURE;
+    }
+
+    if (cnode_init(opts.pszNodeFile, sendFrame, rx.pPcap) != kErrorOk)
+    {
+        pcap_close(rx.pPcap);
+        system_exit();
+        return EXIT_FAILURE;
+    }
+
+    if (system_createThread(rxThread, &rx, &thread) != 0)
+    {
+        fprintf(stderr, "Unable to create the receive thread!\n");
+        cnode_exit();
+        pcap_close(rx.pPcap);
+        system_exit();
+        return EXIT_FAILURE;
+    }
+
+    printf("Emulating CNs on %s, press <Esc> to quit\n", opts.pszDevice);
+
+    lastPrintNs = system_getTimeNs();
+    while (!fExit)
+    {
+        if (console_kbhit() && (console_getch() == 0x1B))
+            fExit = TRUE;
+
+        if (system_getTermSignalState())
+            fExit = TRUE;
+
+        nowNs = system_getTimeNs();
+        if ((opts.statsInterval > 0) && (nowNs - lastPrintNs >= (UINT64)opts.statsInterval * 1000000000ULL))
+        {
+            printf("%lu frames received\n", rx.frameCount);
+            cnode_printStatistics();
+            lastPrintNs = nowNs;
+        }
+
+        system_msleep(100);
+    }
+
+    rx.fStop = TRUE;
+    system_joinThread(&thread);
+
+    printf("%lu frames received\n", rx.frameCount);
+    cnode_printStatistics();
+
+    cnode_exit();
+    pcap_close(rx.pPcap);
+    system_exit();
+    return EXIT_SUCCESS;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+\param  argc_p                  Number of arguments.
+\param  argv_p                  Pointer to argument strings.
+\param  pOpts_p                 Pointer to store the options.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, tEmuOptions* pOpts_p)
+{
+    int     opt;
+    BOOL    fValid = TRUE;
+
+    pOpts_p->pszDevice = NULL;
+    pOpts_p->pszNodeFile = "cnemu.txt";
+    pOpts_p->cpu = -1;
+    pOpts_p->statsInterval = 0;
+
+    while ((opt = getopt(argc_p, argv_p, "i:n:p:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                pOpts_p->pszDevice = optarg;
+                break;
+
+            case 'n':
+                pOpts_p->pszNodeFile = optarg;
+                break;
+
+            case 'p':
+                pOpts_p->cpu = (int)strtol(optarg, NULL, 0);
+                break;
+
+            case 's':
+                pOpts_p->statsInterval = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            default: /* '?' */
+                fValid = FALSE;
+                break;
+        }
+    }
+
+    if (!fValid)
+    {
+        printf("Usage: %s [-i DEVICE] [-n NODEFILE] [-p CPU] [-s INTERVAL]\n", argv_p[0]);
+        printf("  -i  Network interface connected to the MN (lists the interfaces if missing)\n");
+        printf("  -n  CN configuration (default: cnemu.txt)\n");
+        printf("  -p  Bind the receive thread to CPU\n");
+        printf("  -s  Print the statistics every INTERVAL seconds\n");
+        return -1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  List the network interfaces
+*/
+//------------------------------------------------------------------------------
+static void listDevices(void)
+{
+    pcap_if_t*  pDevices;
+    pcap_if_t*  pDevice;
+    char        aError[PCAP_ERRBUF_SIZE];
+
+    if (pcap_findalldevs(&pDevices, aError) == -1)
+    {
+        fprintf(stderr, "Unable to list the network interfaces: %s\n", aError);
+        return;
+    }
+
+    printf("Network interfaces (-i DEVICE):\n");
+    for (pDevice = pDevices; pDevice != NULL; pDevice = pDevice->next)
+    {
+        printf("  %s\n", pDevice->name);
+        if (pDevice->description != NULL)
+            printf("      %s\n", pDevice->description);
+    }
+
+    pcap_freealldevs(pDevices);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a network interface
+
+The function opens the network interface for busy polling: frames are
+delivered immediately, own frames are not captured and reads do not block.
+Only POWERLINK frames pass the filter.
+
+\param  pszDevice_p             Name of the network interface.
+
+\return The function returns the opened interface or NULL on error.
+*/
+//------------------------------------------------------------------------------
+static pcap_t* openDevice(const char* pszDevice_p)
+{
+    pcap_t*             pPcap;
+    struct bpf_program  filter;
+    char                aError[PCAP_ERRBUF_SIZE];
+
+    pPcap = pcap_open(pszDevice_p, CNEMU_SNAPLEN,
+                      PCAP_OPENFLAG_PROMISCUOUS | PCAP_OPENFLAG_NOCAPTURE_LOCAL |
+                      PCAP_OPENFLAG_MAX_RESPONSIVENESS,
+                      1, NULL, aError);
+    if (pPcap == NULL)
+    {
+        fprintf(stderr, "Unable to open %s: %s\n", pszDevice_p, aError);
+        return NULL;
+    }
+
+    if ((pcap_compile(pPcap, &filter, CNEMU_FILTER, 1, 0) != 0) ||
+        (pcap_setfilter(pPcap, &filter) != 0))
+    {
+        fprintf(stderr, "Unable to set the filter on %s: %s\n", pszDevice_p, pcap_geterr(pPcap));
+        pcap_close(pPcap);
+        return NULL;
+    }
+    pcap_freecode(&filter);
+
+    if (pcap_setnonblock(pPcap, 1, aError) != 0)
+    {
+        fprintf(stderr, "Unable to set %s to non-blocking mode: %s\n", pszDevice_p, aError);
+        pcap_close(pPcap);
+        return NULL;
+    }
+
+    return pPcap;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Receive thread
+
+The thread polls the network interface and passes the frames to the virtual
+CNs. The time of reception is taken when the frame is returned by WinPcap.
+
+\param  pArg_p                  Receive thread state.
+*/
+//------------------------------------------------------------------------------
+static void rxThread(void* pArg_p)
+{
+    tEmuRx*                 pRx = (tEmuRx*)pArg_p;
+    struct pcap_pkthdr*     pHeader;
+    const u_char*           pData;
+    int                     ret;
+
+    if ((pRx->cpu >= 0) && (system_setThreadAffinity((UINT)pRx->cpu) != 0))
+        fprintf(stderr, "Unable to bind the receive thread to CPU %d!\n", pRx->cpu);
+
+    while (!pRx->fStop)
+    {
+        ret = pcap_next_ex(pRx->pPcap, &pHeader, &pData);
+        if (ret == 1)
+        {
+            cnode_processFrame(pData, pHeader->caplen, system_getTimeNs());
+            pRx->frameCount++;
+        }
+        else if (ret < 0)
+        {
+            fprintf(stderr, "Receive error: %s\n", pcap_geterr(pRx->pPcap));
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send a frame
+
+The function is called by the virtual CNs to send a frame.
+
+\param  pFrame_p                Pointer to the frame.
+\param  size_p                  Size of the frame.
+\param  pArg_p                  Opened network interface.
+
+\return The function returns 0 on success, otherwise -1.
+*/
+//------------------------------------------------------------------------------
+static int sendFrame(const BYTE* pFrame_p, UINT size_p, void* pArg_p)
+{
+    return pcap_sendpacket((pcap_t*)pArg_p, pFrame_p, (int)size_p);
+}
+
+/// \}
@@ -0,0 +1,1601 @@
+/**
+********************************************************************************
+\file   cnode.c
+
+\brief  Virtual CNs of the CN emulator
+
+This file contains the virtual CNs of the CN emulator. Every virtual CN has
+an object dictionary loaded from the XDC of its device and answers the
+POWERLINK frames of the MN like a real CN:
+
+- PReq: PRes with the NMT state and the payload size of the TPDO mapping
+  (0x1A00). The PReq payload is looped back into the PRes payload.
+- SoA IdentRequest/StatusRequest: IdentResponse/StatusResponse built from
+  the object dictionary.
+- SoA UnspecifiedInvite: the next queued asynchronous frame. The number of
+  queued frames is signaled in the RS field of PRes and StatusResponse.
+- NMT commands, including the extended commands with a node list.
+- SDO over ASnd: expedited WriteByIndex and ReadByIndex, so the
+  configuration manager of the MN can download the concise DCF.
+
+The virtual CNs are configured by a file:
+
+    # nodes     XDC file
+    1-200       00000000_POWERLINK_CiA401_CN_1.xdc
+    210         00000000_POWERLINK_CiA401_CN_32.xdc
+
+Every XDC is loaded once and shared by its CNs, only the object values are
+held per CN. A CN starts with the default values of the XDC; the values are
+kept on all resets except NMTSwReset, like a CN which stores its
+configuration.
+
+All frames are processed by one thread. A frame is dispatched to its CN by
+the node ID, and the PRes is prepared when the CN changes its state, so a
+PReq only costs the loop-back copy and the transmission.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "plkframe.h"
+#include "cnode.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CNODE_LINE_LEN              1024        // maximum length of a line in the configuration and XDC
+#define CNODE_MAX_TEMPLATES         16          // maximum number of different XDC files
+#define CNODE_SDO_MAX_DATA          1456        // maximum data of an expedited SDO transfer
+
+// NMT states on the wire
+#define CNODE_STATE_NOT_ACTIVE      0x1C
+#define CNODE_STATE_PREOP1          0x1D
+#define CNODE_STATE_PREOP2          0x5D
+#define CNODE_STATE_READY_TO_OP     0x6D
+#define CNODE_STATE_OPERATIONAL     0xFD
+#define CNODE_STATE_STOPPED         0x4D
+
+// SDO abort codes
+#define CNODE_ABORT_COMMAND         0x05040001  // command specifier not valid or unknown
+#define CNODE_ABORT_READ_ONLY       0x06010002  // attempt to write a read only object
+#define CNODE_ABORT_NO_OBJECT       0x06020000  // object does not exist
+#define CNODE_ABORT_NO_SUBINDEX     0x06090011  // sub-index does not exist
+#define CNODE_ABORT_LENGTH          0x06070010  // length of service parameter does not match
+#define CNODE_ABORT_LENGTH_HIGH     0x06070012  // length of service parameter too high
+
+// objects
+#define CNODE_KEY(index, sub)       (((UINT32)(index) << 8) | (sub))
+#define CNODE_IDX_DEVICE_TYPE       0x1000
+#define CNODE_IDX_IDENTITY          0x1018
+#define CNODE_IDX_VERIFY_CONF       0x1020
+#define CNODE_IDX_APP_SW_VERSION    0x1F52
+#define CNODE_IDX_FEATURE_FLAGS     0x1F82
+#define CNODE_IDX_NMT_CYCLE_TIMING  0x1F98
+#define CNODE_IDX_TPDO_MAPPING      0x1A00
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Object dictionary entry
+
+The structure describes an entry of the object dictionary of an XDC. The
+value of the entry is stored at its offset in the value pool of a CN: the
+current length (UINT16) followed by the capacity in bytes.
+*/
+typedef struct
+{
+    UINT32          key;                    ///< Index << 8 | sub-index
+    UINT16          capacity;               ///< Maximum size of the value [bytes]
+    BOOL            fNumeric;               ///< Value has a fixed size
+    BOOL            fWritable;              ///< Entry can be written by SDO
+    UINT32          offset;                 ///< Offset in the value pool
+} tCnodeEntry;
+
+/**
+\brief  Device template
+
+The structure contains the object dictionary loaded from an XDC.
+*/
+typedef struct
+{
+    char            aFileName[256];         ///< XDC file
+    tCnodeEntry*    pEntry;                 ///< Entries sorted by key
+    UINT            entryCount;             ///< Number of entries
+    BYTE*           pDefaults;              ///< Value pool with the default values
+    UINT            poolSize;               ///< Size of the value pool [bytes]
+} tCnodeTemplate;
+
+/**
+\brief  Virtual CN
+
+The structure contains the state of a virtual CN.
+*/
+typedef struct
+{
+    UINT8                   nodeId;                         ///< Node ID
+    UINT8                   nmtState;                       ///< NMT state on the wire
+    BOOL                    fExceptionClear;                ///< Exception reset received (EC)
+    const tCnodeTemplate*   pTemplate;                      ///< Device template
+    BYTE*                   pValues;                        ///< Value pool
+    BYTE                    aMac[6];                        ///< MAC address
+    BYTE                    aPres[PLK_FRAME_MAX_SIZE];      ///< Prepared PRes
+    UINT                    presSize;                       ///< PRes payload size [bytes]
+    UINT                    presFrameSize;                  ///< PRes frame size [bytes]
+    BYTE                    aaAsync[CNODE_ASYNC_QUEUE_LEN][PLK_FRAME_MAX_SIZE]; ///< Queued asynchronous frames
+    UINT                    aAsyncSize[CNODE_ASYNC_QUEUE_LEN];  ///< Sizes of the queued frames
+    UINT                    asyncRead;                      ///< Next queued frame to send
+    UINT                    asyncWrite;                     ///< Next free queue entry
+    UINT8                   sdoCon;                         ///< SDO connection state
+    UINT8                   sdoRecvSeq;                     ///< Last received SDO sequence number
+    UINT8                   sdoSendSeq;                     ///< Last sent SDO sequence number
+    UINT32                  presCount;                      ///< Sent PRes frames
+    UINT32                  latencyMin;                     ///< Minimum PReq to PRes latency [ns]
+    UINT32                  latencyMax;                     ///< Maximum PReq to PRes latency [ns]
+    UINT64                  latencySum;                     ///< Sum of the PReq to PRes latencies [ns]
+    UINT32                  identCount;                     ///< Sent IdentResponse frames
+    UINT32                  statusCount;                    ///< Sent StatusResponse frames
+    UINT32                  sdoCount;                       ///< Processed SDO commands
+    UINT32                  nmtCount;                       ///< Processed NMT commands
+    UINT32                  dropCount;                      ///< Asynchronous frames dropped on a full queue
+} tCnode;
+
+/**
+\brief  CN emulator instance
+
+The structure contains the virtual CNs.
+*/
+typedef struct
+{
+    tCnodeTemplate  aTemplate[CNODE_MAX_TEMPLATES];     ///< Device templates
+    UINT            templateCount;                      ///< Number of device templates
+    tCnode*         pNode;                              ///< Virtual CNs
+    UINT            nodeCount;                          ///< Number of virtual CNs
+    tCnode*         apNode[256];                        ///< Virtual CNs by node ID
+    UINT            startupCount;                       ///< CNs in NOT_ACTIVE or PRE_OPERATIONAL_1
+    BYTE            aMnMac[6];                          ///< MAC address of the MN
+    BOOL            fMnMacValid;                        ///< MAC address of the MN is known
+    tCnodeSendCb    pfnSend;                            ///< Frame transmit function
+    void*           pSendArg;                           ///< Argument of the transmit function
+    BYTE            aFrame[PLK_FRAME_MAX_SIZE];         ///< Buffer for direct responses
+    UINT32          sendErrorCount;                     ///< Failed transmissions
+} tCnodeInstance;
+
+/**
+\brief  Data type of the object dictionary
+
+The structure describes the size of a data type of the XDC.
+*/
+typedef struct
+{
+    UINT16          dataType;               ///< Data type ID
+    UINT8           size;                   ///< Size [bytes], 0 for strings and domains
+    BOOL            fSigned;                ///< Signed integer
+} tCnodeDataType;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCnodeInstance   cnodeInstance_l;
+
+static const tCnodeDataType aDataType_l[] =
+{
+    { 0x0001, 1, FALSE },   // BOOLEAN
+    { 0x0002, 1, TRUE  },   // INTEGER8
+    { 0x0003, 2, TRUE  },   // INTEGER16
+    { 0x0004, 4, TRUE  },   // INTEGER32
+    { 0x0005, 1, FALSE },   // UNSIGNED8
+    { 0x0006, 2, FALSE },   // UNSIGNED16
+    { 0x0007, 4, FALSE },   // UNSIGNED32
+    { 0x0008, 4, FALSE },   // REAL32
+    { 0x0010, 3, TRUE  },   // INTEGER24
+    { 0x0011, 8, FALSE },   // REAL64
+    { 0x0012, 5, TRUE  },   // INTEGER40
+    { 0x0013, 6, TRUE  },   // INTEGER48
+    { 0x0014, 7, TRUE  },   // INTEGER56
+    { 0x0015, 8, TRUE  },   // INTEGER64
+    { 0x0016, 3, FALSE },   // UNSIGNED24
+    { 0x0018, 5, FALSE },   // UNSIGNED40
+    { 0x0019, 6, FALSE },   // UNSIGNED48
+    { 0x001A, 7, FALSE },   // UNSIGNED56
+    { 0x001B, 8, FALSE },   // UNSIGNED64
+    { 0x0401, 6, FALSE },   // MAC_ADDRESS
+    { 0x0402, 4, FALSE },   // IP_ADDRESS
+    { 0x0403, 8, FALSE },   // NETTIME
+};
+
+static const BYTE   aMulticastPres_l[6] = { PLK_MULTICAST_PREFIX, PLK_MULTICAST_PRES };
+static const BYTE   aMulticastAsnd_l[6] = { PLK_MULTICAST_PREFIX, PLK_MULTICAST_ASND };
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError           parseConfig(const char* pszConfigFile_p);
+static const tCnodeTemplate* loadTemplate(const char* pszXdcFile_p);
+static tOplkError           addEntry(tCnodeTemplate* pTemplate_p, UINT* pCapacity_p, UINT index_p,
+                                     UINT subIndex_p, const char* pszLine_p, UINT dataType_p);
+static BOOL                 getAttribute(const char* pLine_p, const char* pszName_p, char* pValue_p,
+                                         size_t valueSize_p);
+static const tCnodeEntry*   findEntry(const tCnodeTemplate* pTemplate_p, UINT32 key_p, BOOL* pfIndexFound_p);
+static UINT64               readValue(const tCnode* pNode_p, UINT index_p, UINT subIndex_p, UINT64 default_p);
+static void                 resetNode(tCnode* pNode_p, BOOL fDefaults_p);
+static void                 setState(tCnode* pNode_p, UINT8 nmtState_p);
+static void                 preparePres(tCnode* pNode_p);
+static void                 processPreq(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p, UINT64 rxTimeNs_p);
+static void                 processSoa(tCnode* pNode_p, const BYTE* pFrame_p);
+static void                 processNmtCommand(tCnode* pNode_p, UINT command_p);
+static void                 processSdo(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p);
+static UINT                 processSdoCommand(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p, BYTE* pResponse_p);
+static void                 sendIdentResponse(tCnode* pNode_p);
+static void                 sendStatusResponse(tCnode* pNode_p);
+static BYTE*                queueSdoFrame(tCnode* pNode_p, UINT8 recvCon_p, UINT8 sendCon_p);
+static void                 initHeader(BYTE* pFrame_p, const BYTE* pDstMac_p, const tCnode* pNode_p,
+                                       UINT msgType_p, UINT dstNodeId_p);
+static void                 setResponseFlags(const tCnode* pNode_p, BYTE* pFrame_p);
+static void                 sendFrame(const BYTE* pFrame_p, UINT size_p);
+static UINT64               getUintLe(const BYTE* pData_p, UINT size_p);
+static void                 setUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p);
+static int                  compareEntry(const void* pLeft_p, const void* pRight_p);
+static const char*          getStateName(UINT8 nmtState_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the virtual CNs
+
+The function loads the configuration and the XDC files of the virtual CNs.
+
+\param  pszConfigFile_p         File name of the CN configuration.
+\param  pfnSend_p               Function called to send a frame.
+\param  pArg_p                  Argument passed to the transmit function.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cnode_init(const char* pszConfigFile_p, tCnodeSendCb pfnSend_p, void* pArg_p)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+    tOplkError      ret;
+
+    memset(pInst, 0, sizeof(tCnodeInstance));
+    pInst->pfnSend = pfnSend_p;
+    pInst->pSendArg = pArg_p;
+
+    pInst->pNode = (tCnode*)calloc(CNODE_MAX_NODES, sizeof(tCnode));
+    if (pInst->pNode == NULL)
+        return kErrorNoResource;
+
+    ret = parseConfig(pszConfigFile_p);
+    if (ret != kErrorOk)
+    {
+        cnode_exit();
+        return ret;
+    }
+
+    printf("Emulating %u CNs with %u device descriptions\n", pInst->nodeCount, pInst->templateCount);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down the virtual CNs
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cnode_exit(void)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+    UINT            i;
+
+    for (i = 0; i < pInst->nodeCount; i++)
+        free(pInst->pNode[i].pValues);
+
+    for (i = 0; i < pInst->templateCount; i++)
+    {
+        free(pInst->aTemplate[i].pEntry);
+        free(pInst->aTemplate[i].pDefaults);
+    }
+
+    free(pInst->pNode);
+    memset(pInst, 0, sizeof(tCnodeInstance));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a received frame
+
+The function processes a frame of the MN and sends the responses of the
+addressed virtual CNs.
+
+\param  pFrame_p                Pointer to the frame.
+\param  size_p                  Size of the frame.
+\param  rxTimeNs_p              Reception time of the frame (system_getTimeNs()).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cnode_processFrame(const BYTE* pFrame_p, UINT size_p, UINT64 rxTimeNs_p)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+    tCnode*         pNode;
+    UINT            msgType;
+    UINT            command;
+    UINT            i;
+
+    if ((size_p <= PLK_OFS_PDO_SIZE) ||
+        (pFrame_p[PLK_OFS_ETHERTYPE] != (PLK_ETHERTYPE >> 8)) ||
+        (pFrame_p[PLK_OFS_ETHERTYPE + 1] != (PLK_ETHERTYPE & 0xFF)) ||
+        (pFrame_p[PLK_OFS_SRC_NODE] != PLK_NODEID_MN))
+        return;
+
+    msgType = pFrame_p[PLK_OFS_MSGTYPE] & 0x7F;
+    pNode = pInst->apNode[pFrame_p[PLK_OFS_DST_NODE]];
+
+    // the PReq is the time critical case
+    if (msgType == PLK_MSGTYPE_PREQ)
+    {
+        if (pNode != NULL)
+            processPreq(pNode, pFrame_p, size_p, rxTimeNs_p);
+        return;
+    }
+
+    if (!pInst->fMnMacValid)
+    {
+        memcpy(pInst->aMnMac, &pFrame_p[PLK_OFS_SRC_MAC], sizeof(pInst->aMnMac));
+        pInst->fMnMacValid = TRUE;
+    }
+
+    switch (msgType)
+    {
+        case PLK_MSGTYPE_SOC:
+            // NOT_ACTIVE -> PRE_OPERATIONAL_1 -> PRE_OPERATIONAL_2
+            for (i = 0; (pInst->startupCount > 0) && (i < pInst->nodeCount); i++)
+            {
+                pNode = &pInst->pNode[i];
+                if (pNode->nmtState == CNODE_STATE_PREOP1)
+                    setState(pNode, CNODE_STATE_PREOP2);
+                else if (pNode->nmtState == CNODE_STATE_NOT_ACTIVE)
+                    setState(pNode, CNODE_STATE_PREOP1);
+            }
+            break;
+
+        case PLK_MSGTYPE_SOA:
+            for (i = 0; (pInst->startupCount > 0) && (i < pInst->nodeCount); i++)
+            {
+                if (pInst->pNode[i].nmtState == CNODE_STATE_NOT_ACTIVE)
+                    setState(&pInst->pNode[i], CNODE_STATE_PREOP1);
+            }
+
+            pNode = pInst->apNode[pFrame_p[PLK_OFS_SOA_TARGET]];
+            if (pNode != NULL)
+                processSoa(pNode, pFrame_p);
+            break;
+
+        case PLK_MSGTYPE_ASND:
+            if (pFrame_p[PLK_OFS_ASND_SERVICE] == PLK_ASND_NMT_COMMAND)
+            {
+                command = pFrame_p[PLK_OFS_NMT_COMMAND];
+                if (pNode != NULL)
+                {
+                    processNmtCommand(pNode, command);
+                }
+                else if ((pFrame_p[PLK_OFS_DST_NODE] == PLK_NODEID_BROADCAST) &&
+                         (size_p >= PLK_OFS_NMT_DATA + 32))
+                {
+                    // extended commands address the CNs by a node list
+                    for (i = 0; i < pInst->nodeCount; i++)
+                    {
+                        pNode = &pInst->pNode[i];
+                        if ((command < kNmtCmdStartNodeEx) ||
+                            ((pFrame_p[PLK_OFS_NMT_DATA + (pNode->nodeId >> 3)] & (1 << (pNode->nodeId & 7))) != 0))
+                            processNmtCommand(pNode, command);
+                    }
+                }
+            }
+            else if ((pFrame_p[PLK_OFS_ASND_SERVICE] == PLK_ASND_SDO) && (pNode != NULL))
+            {
+                processSdo(pNode, pFrame_p, size_p);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of virtual CNs
+
+\return The function returns the number of virtual CNs.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT cnode_getNodeCount(void)
+{
+    return cnodeInstance_l.nodeCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the statistics of the virtual CNs
+
+The function prints the NMT state, the PRes latency and the asynchronous
+traffic of every virtual CN. The latency is measured from the reception of
+the PReq to the return of the transmit function.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cnode_printStatistics(void)
+{
+    const tCnodeInstance*   pInst = &cnodeInstance_l;
+    const tCnode*           pNode;
+    UINT                    i;
+
+    printf("Node State        PRes       Latency min/avg/max [us]  Ident Status   SDO   NMT Drop\n");
+    for (i = 0; i < pInst->nodeCount; i++)
+    {
+        pNode = &pInst->pNode[i];
+        printf("%4u %-12s %10lu", pNode->nodeId, getStateName(pNode->nmtState), (ULONG)pNode->presCount);
+
+        if (pNode->presCount > 0)
+        {
+            printf("  %8.1f %8.1f %8.1f", pNode->latencyMin / 1000.0,
+                   (double)pNode->latencySum / pNode->presCount / 1000.0, pNode->latencyMax / 1000.0);
+        }
+        else
+        {
+            printf("  %8s %8s %8s", "-", "-", "-");
+        }
+
+        printf("  %5lu %6lu %5lu %5lu %4lu\n", (ULONG)pNode->identCount, (ULONG)pNode->statusCount,
+               (ULONG)pNode->sdoCount, (ULONG)pNode->nmtCount, (ULONG)pNode->dropCount);
+    }
+
+    if (pInst->sendErrorCount > 0)
+        printf("%lu frames could not be sent\n", (ULONG)pInst->sendErrorCount);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse the CN configuration
+
+\param  pszConfigFile_p         File name of the CN configuration.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseConfig(const char* pszConfigFile_p)
+{
+    tCnodeInstance*         pInst = &cnodeInstance_l;
+    FILE*                   pFile;
+    char                    aLine[CNODE_LINE_LEN];
+    char*                   pComment;
+    char*                   pNodes;
+    char*                   pXdcFile;
+    char*                   pEnd;
+    const tCnodeTemplate*   pTemplate;
+    tCnode*                 pNode;
+    ULONG                   first;
+    ULONG                   last;
+    ULONG                   nodeId;
+    UINT                    lineNo = 0;
+    tOplkError              ret = kErrorOk;
+
+    pFile = fopen(pszConfigFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open CN configuration %s!\n", pszConfigFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        pComment = strchr(aLine, '#');
+        if (pComment != NULL)
+            *pComment = '\0';
+
+        pNodes = strtok(aLine, " \t\r\n");
+        if (pNodes == NULL)
+            continue;
+
+        pXdcFile = strtok(NULL, " \t\r\n");
+        if ((pXdcFile == NULL) || (strtok(NULL, " \t\r\n") != NULL))
+        {
+            ret = kErrorApiInvalidParam;
+            break;
+        }
+
+        first = strtoul(pNodes, &pEnd, 0);
+        last = first;
+        if (*pEnd == '-')
+            last = strtoul(pEnd + 1, &pEnd, 0);
+
+        if ((*pEnd != '\0') || (first == 0) || (first > last) || (last > CNODE_MAX_NODES))
+        {
+            ret = kErrorInvalidNodeId;
+            break;
+        }
+
+        pTemplate = loadTemplate(pXdcFile);
+        if (pTemplate == NULL)
+        {
+            ret = kErrorNoResource;
+            break;
+        }
+
+        for (nodeId = first; nodeId <= last; nodeId++)
+        {
+            if (pInst->apNode[nodeId] != NULL)
+            {
+                ret = kErrorInvalidNodeId;
+                break;
+            }
+
+            pNode = &pInst->pNode[pInst->nodeCount];
+            pNode->nodeId = (UINT8)nodeId;
+            pNode->pTemplate = pTemplate;
+            pNode->pValues = (BYTE*)malloc(pTemplate->poolSize);
+            if (pNode->pValues == NULL)
+            {
+                ret = kErrorNoResource;
+                break;
+            }
+
+            // locally administered MAC address derived from the node ID
+            pNode->aMac[0] = 0x02;
+            pNode->aMac[5] = (BYTE)nodeId;
+            pNode->latencyMin = UINT_MAX;
+
+            pInst->apNode[nodeId] = pNode;
+            pInst->nodeCount++;
+            resetNode(pNode, TRUE);
+        }
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid CN configuration in line %u of %s!\n", lineNo, pszConfigFile_p);
+        return ret;
+    }
+
+    if (pInst->nodeCount == 0)
+    {
+        fprintf(stderr, "No CNs in configuration %s!\n", pszConfigFile_p);
+        return kErrorApiInvalidParam;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load a device template
+
+The function loads the object dictionary of an XDC. An XDC which has already
+been loaded is shared.
+
+\param  pszXdcFile_p            File name of the XDC.
+
+\return The function returns the device template or NULL on error.
+*/
+//------------------------------------------------------------------------------
+static const tCnodeTemplate* loadTemplate(const char* pszXdcFile_p)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+    tCnodeTemplate* pTemplate;
+    FILE*           pFile;
+    char            aLine[CNODE_LINE_LEN];
+    char            aValue[16];
+    UINT            index = 0;
+    UINT            objectType;
+    UINT            objectDataType = 0;
+    UINT            dataType;
+    UINT            capacity = 0;
+    UINT            i;
+    tOplkError      ret = kErrorOk;
+
+    for (i = 0; i < pInst->templateCount; i++)
+    {
+        if (strcmp(pInst->aTemplate[i].aFileName, pszXdcFile_p) == 0)
+            return &pInst->aTemplate[i];
+    }
+
+    if ((pInst->templateCount >= CNODE_MAX_TEMPLATES) ||
+        (strlen(pszXdcFile_p) >= sizeof(pInst->aTemplate[0].aFileName)))
+        return NULL;
+
+    pFile = fopen(pszXdcFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open XDC file %s!\n", pszXdcFile_p);
+        return NULL;
+    }
+
+    pTemplate = &pInst->aTemplate[pInst->templateCount];
+    memset(pTemplate, 0, sizeof(tCnodeTemplate));
+    strcpy(pTemplate->aFileName, pszXdcFile_p);
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        if (strstr(aLine, "<Object ") != NULL)
+        {
+            if (!getAttribute(aLine, "index", aValue, sizeof(aValue)))
+                continue;
+            index = (UINT)strtoul(aValue, NULL, 16);
+
+            objectDataType = getAttribute(aLine, "dataType", aValue, sizeof(aValue)) ?
+                             (UINT)strtoul(aValue, NULL, 16) : 0;
+            objectType = getAttribute(aLine, "objectType", aValue, sizeof(aValue)) ?
+                         (UINT)strtoul(aValue, NULL, 10) : 0;
+
+            // a variable has no sub-objects
+            if (objectType == 7)
+                ret = addEntry(pTemplate, &capacity, index, 0, aLine, objectDataType);
+        }
+        else if (strstr(aLine, "<SubObject ") != NULL)
+        {
+            if (!getAttribute(aLine, "subIndex", aValue, sizeof(aValue)))
+                continue;
+
+            i = (UINT)strtoul(aValue, NULL, 16);
+            dataType = getAttribute(aLine, "dataType", aValue, sizeof(aValue)) ?
+                       (UINT)strtoul(aValue, NULL, 16) : objectDataType;
+            ret = addEntry(pTemplate, &capacity, index, i, aLine, dataType);
+        }
+    }
+    fclose(pFile);
+
+    if ((ret != kErrorOk) || (pTemplate->entryCount == 0))
+    {
+        fprintf(stderr, "Unable to load the objects of XDC file %s!\n", pszXdcFile_p);
+        free(pTemplate->pEntry);
+        free(pTemplate->pDefaults);
+        return NULL;
+    }
+
+    qsort(pTemplate->pEntry, pTemplate->entryCount, sizeof(tCnodeEntry), compareEntry);
+    pInst->templateCount++;
+    return pTemplate;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an entry to a device template
+
+The function adds an object or sub-object of the XDC and stores its default
+value in the value pool of the template.
+
+\param  pTemplate_p             Device template.
+\param  pCapacity_p             Number of allocated entries.
+\param  index_p                 Object index.
+\param  subIndex_p              Sub-index.
+\param  pszLine_p               XDC line of the (sub-)object.
+\param  dataType_p              Data type ID.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError addEntry(tCnodeTemplate* pTemplate_p, UINT* pCapacity_p, UINT index_p,
+                           UINT subIndex_p, const char* pszLine_p, UINT dataType_p)
+{
+    tCnodeEntry*            pEntry;
+    const tCnodeDataType*   pType = NULL;
+    char                    aValue[256];
+    char                    aAccess[16];
+    BOOL                    fDefault;
+    BYTE*                   pPool;
+    UINT64                  value = 0;
+    UINT16                  length;
+    double                  real64;
+    float                   real32;
+    UINT                    i;
+
+    if (pTemplate_p->entryCount == *pCapacity_p)
+    {
+        pEntry = (tCnodeEntry*)realloc(pTemplate_p->pEntry, (*pCapacity_p + 256) * sizeof(tCnodeEntry));
+        if (pEntry == NULL)
+            return kErrorNoResource;
+
+        pTemplate_p->pEntry = pEntry;
+        *pCapacity_p += 256;
+    }
+
+    for (i = 0; i < sizeof(aDataType_l) / sizeof(aDataType_l[0]); i++)
+    {
+        if (aDataType_l[i].dataType == dataType_p)
+            pType = &aDataType_l[i];
+    }
+
+    fDefault = getAttribute(pszLine_p, "defaultValue", aValue, sizeof(aValue));
+    if (!fDefault)
+        aValue[0] = '\0';
+
+    pEntry = &pTemplate_p->pEntry[pTemplate_p->entryCount];
+    pEntry->key = CNODE_KEY(index_p, subIndex_p);
+    pEntry->fNumeric = (pType != NULL);
+    pEntry->capacity = (pType != NULL) ? pType->size : (UINT16)strlen(aValue);
+    if (!pEntry->fNumeric && (pEntry->capacity < CNODE_STRING_LEN))
+        pEntry->capacity = CNODE_STRING_LEN;
+
+    pEntry->fWritable = !getAttribute(pszLine_p, "accessType", aAccess, sizeof(aAccess)) ||
+                        ((strcmp(aAccess, "const") != 0) && (strcmp(aAccess, "ro") != 0));
+    pEntry->offset = pTemplate_p->poolSize;
+
+    pPool = (BYTE*)realloc(pTemplate_p->pDefaults, pTemplate_p->poolSize + sizeof(UINT16) + pEntry->capacity);
+    if (pPool == NULL)
+        return kErrorNoResource;
+
+    pTemplate_p->pDefaults = pPool;
+    pTemplate_p->poolSize += sizeof(UINT16) + pEntry->capacity;
+    pPool += pEntry->offset;
+    memset(pPool, 0, sizeof(UINT16) + pEntry->capacity);
+
+    if (!pEntry->fNumeric)
+    {
+        // visible strings keep their text, octet strings and domains start empty
+        length = (dataType_p == 0x0009) ? (UINT16)strlen(aValue) : 0;
+        memcpy(pPool + sizeof(UINT16), aValue, length);
+    }
+    else
+    {
+        if (dataType_p == 0x0008)
+        {
+            real32 = (float)strtod(aValue, NULL);
+            memcpy(&value, &real32, sizeof(real32));
+        }
+        else if (dataType_p == 0x0011)
+        {
+            real64 = strtod(aValue, NULL);
+            memcpy(&value, &real64, sizeof(real64));
+        }
+        else if (dataType_p == 0x0001)
+        {
+            value = (strcmp(aValue, "true") == 0) || (strtoul(aValue, NULL, 0) != 0);
+        }
+        else if (pType->fSigned)
+        {
+            value = (UINT64)strtoll(aValue, NULL, 0);
+        }
+        else
+        {
+            value = strtoull(aValue, NULL, 0);
+        }
+
+        length = pEntry->capacity;
+        setUintLe(pPool + sizeof(UINT16), value, length);
+    }
+
+    memcpy(pPool, &length, sizeof(UINT16));
+    pTemplate_p->entryCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get an attribute of an XDC element
+
+\param  pLine_p                 Line containing the element.
+\param  pszName_p               Name of the attribute.
+\param  pValue_p                Pointer to store the value.
+\param  valueSize_p             Size of the value buffer.
+
+\return The function returns TRUE if the attribute has been found.
+*/
+//------------------------------------------------------------------------------
+static BOOL getAttribute(const char* pLine_p, const char* pszName_p, char* pValue_p,
+                         size_t valueSize_p)
+{
+    const char*     pPos = pLine_p;
+    const char*     pEnd;
+    size_t          nameLen = strlen(pszName_p);
+    size_t          valueLen;
+
+    while ((pPos = strstr(pPos, pszName_p)) != NULL)
+    {
+        if ((pPos > pLine_p) && (pPos[-1] == ' ') && (strncmp(pPos + nameLen, "=\"", 2) == 0))
+        {
+            pPos += nameLen + 2;
+            pEnd = strchr(pPos, '"');
+            if (pEnd == NULL)
+                return FALSE;
+
+            valueLen = (size_t)(pEnd - pPos);
+            if (valueLen >= valueSize_p)
+                valueLen = valueSize_p - 1;
+            memcpy(pValue_p, pPos, valueLen);
+            pValue_p[valueLen] = '\0';
+            return TRUE;
+        }
+        pPos += nameLen;
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find an entry of a device template
+
+\param  pTemplate_p             Device template.
+\param  key_p                   Key of the entry (CNODE_KEY()).
+\param  pfIndexFound_p          Pointer to store whether the object index
+                                exists. May be NULL.
+
+\return The function returns the entry or NULL if it does not exist.
+*/
+//------------------------------------------------------------------------------
+static const tCnodeEntry* findEntry(const tCnodeTemplate* pTemplate_p, UINT32 key_p, BOOL* pfIndexFound_p)
+{
+    UINT    low = 0;
+    UINT    high = pTemplate_p->entryCount;
+    UINT    mid;
+
+    // lower bound of the key
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (pTemplate_p->pEntry[mid].key < key_p)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (pfIndexFound_p != NULL)
+    {
+        *pfIndexFound_p = ((low < pTemplate_p->entryCount) &&
+                           ((pTemplate_p->pEntry[low].key >> 8) == (key_p >> 8))) ||
+                          ((low > 0) && ((pTemplate_p->pEntry[low - 1].key >> 8) == (key_p >> 8)));
+    }
+
+    if ((low < pTemplate_p->entryCount) && (pTemplate_p->pEntry[low].key == key_p))
+        return &pTemplate_p->pEntry[low];
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a numeric object of a CN
+
+\param  pNode_p                 Virtual CN.
+\param  index_p                 Object index.
+\param  subIndex_p              Sub-index.
+\param  default_p               Value returned if the object does not exist.
+
+\return The function returns the value of the object.
+*/
+//------------------------------------------------------------------------------
+static UINT64 readValue(const tCnode* pNode_p, UINT index_p, UINT subIndex_p, UINT64 default_p)
+{
+    const tCnodeEntry*  pEntry = findEntry(pNode_p->pTemplate, CNODE_KEY(index_p, subIndex_p), NULL);
+
+    if ((pEntry == NULL) || !pEntry->fNumeric)
+        return default_p;
+
+    return getUintLe(pNode_p->pValues + pEntry->offset + sizeof(UINT16), pEntry->capacity);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset a CN
+
+The function resets the communication of a CN to NOT_ACTIVE.
+
+\param  pNode_p                 Virtual CN.
+\param  fDefaults_p             Restore the default values of the objects.
+*/
+//------------------------------------------------------------------------------
+static void resetNode(tCnode* pNode_p, BOOL fDefaults_p)
+{
+    if (fDefaults_p)
+        memcpy(pNode_p->pValues, pNode_p->pTemplate->pDefaults, pNode_p->pTemplate->poolSize);
+
+    pNode_p->asyncRead = 0;
+    pNode_p->asyncWrite = 0;
+    pNode_p->sdoCon = PLK_SDO_CON_NONE;
+    pNode_p->fExceptionClear = FALSE;
+
+    if (pNode_p->nmtState == 0)
+    {
+        // initial reset
+        pNode_p->nmtState = CNODE_STATE_NOT_ACTIVE;
+        cnodeInstance_l.startupCount++;
+    }
+    else
+    {
+        setState(pNode_p, CNODE_STATE_NOT_ACTIVE);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change the NMT state of a CN
+
+\param  pNode_p                 Virtual CN.
+\param  nmtState_p              New NMT state.
+*/
+//------------------------------------------------------------------------------
+static void setState(tCnode* pNode_p, UINT8 nmtState_p)
+{
+    BOOL    fWasStartup = (pNode_p->nmtState == CNODE_STATE_NOT_ACTIVE) ||
+                          (pNode_p->nmtState == CNODE_STATE_PREOP1);
+    BOOL    fIsStartup = (nmtState_p == CNODE_STATE_NOT_ACTIVE) ||
+                         (nmtState_p == CNODE_STATE_PREOP1);
+
+    if (fWasStartup && !fIsStartup)
+        cnodeInstance_l.startupCount--;
+    else if (!fWasStartup && fIsStartup)
+        cnodeInstance_l.startupCount++;
+
+    pNode_p->nmtState = nmtState_p;
+
+    // the mapping may have been changed by the MN before the PReqs start
+    if ((nmtState_p == CNODE_STATE_PREOP2) || (nmtState_p == CNODE_STATE_READY_TO_OP))
+        preparePres(pNode_p);
+    else
+        pNode_p->aPres[PLK_OFS_NMTSTATE] = nmtState_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Prepare the PRes of a CN
+
+The function builds the PRes of a CN. The payload size is determined by the
+TPDO mapping (0x1A00).
+
+\param  pNode_p                 Virtual CN.
+*/
+//------------------------------------------------------------------------------
+static void preparePres(tCnode* pNode_p)
+{
+    UINT64  mapping;
+    UINT    mappingCount;
+    UINT    end;
+    UINT    i;
+
+    pNode_p->presSize = 0;
+    mappingCount = (UINT)readValue(pNode_p, CNODE_IDX_TPDO_MAPPING, 0, 0);
+    for (i = 1; i <= mappingCount; i++)
+    {
+        // offset and length of the mapped object [bits] are in the upper half
+        mapping = readValue(pNode_p, CNODE_IDX_TPDO_MAPPING, i, 0);
+        end = (UINT)(((mapping >> 32) & 0xFFFF) + ((mapping >> 48) & 0xFFFF) + 7) / 8;
+        if (end > pNode_p->presSize)
+            pNode_p->presSize = end;
+    }
+
+    if (pNode_p->presSize > PLK_FRAME_MAX_SIZE - PLK_OFS_PDO_PAYLOAD)
+        pNode_p->presSize = PLK_FRAME_MAX_SIZE - PLK_OFS_PDO_PAYLOAD;
+
+    memset(pNode_p->aPres, 0, sizeof(pNode_p->aPres));
+    initHeader(pNode_p->aPres, aMulticastPres_l, pNode_p, PLK_MSGTYPE_PRES, PLK_NODEID_BROADCAST);
+    pNode_p->aPres[PLK_OFS_NMTSTATE] = pNode_p->nmtState;
+    setUintLe(&pNode_p->aPres[PLK_OFS_PDO_SIZE], pNode_p->presSize, 2);
+
+    pNode_p->presFrameSize = PLK_OFS_PDO_PAYLOAD + pNode_p->presSize;
+    if (pNode_p->presFrameSize < PLK_FRAME_MIN_SIZE)
+        pNode_p->presFrameSize = PLK_FRAME_MIN_SIZE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Answer a PReq
+
+\param  pNode_p                 Addressed CN.
+\param  pFrame_p                Pointer to the PReq.
+\param  size_p                  Size of the PReq.
+\param  rxTimeNs_p              Reception time of the PReq.
+*/
+//------------------------------------------------------------------------------
+static void processPreq(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p, UINT64 rxTimeNs_p)
+{
+    BYTE*   pPres = pNode_p->aPres;
+    UINT    size;
+    UINT    pending;
+    UINT32  latency;
+
+    if ((pNode_p->nmtState != CNODE_STATE_PREOP2) && (pNode_p->nmtState != CNODE_STATE_READY_TO_OP) &&
+        (pNode_p->nmtState != CNODE_STATE_OPERATIONAL) && (pNode_p->nmtState != CNODE_STATE_STOPPED))
+        return;
+
+    // the outputs are looped back to the inputs
+    size = (UINT)getUintLe(&pFrame_p[PLK_OFS_PDO_SIZE], 2);
+    if (size > size_p - PLK_OFS_PDO_PAYLOAD)
+        size = size_p - PLK_OFS_PDO_PAYLOAD;
+    if (size > pNode_p->presSize)
+        size = pNode_p->presSize;
+    memcpy(&pPres[PLK_OFS_PDO_PAYLOAD], &pFrame_p[PLK_OFS_PDO_PAYLOAD], size);
+
+    pending = pNode_p->asyncWrite - pNode_p->asyncRead;
+    pPres[PLK_OFS_FLAG1] = (pNode_p->nmtState == CNODE_STATE_OPERATIONAL) ? PLK_FLAG1_RD : 0;
+    pPres[PLK_OFS_FLAG2] = (BYTE)((pending > 0) ? ((PLK_PRIO_GENERIC_REQUEST << PLK_FLAG2_PR_SHIFT) | pending) : 0);
+
+    sendFrame(pPres, pNode_p->presFrameSize);
+
+    latency = (UINT32)(system_getTimeNs() - rxTimeNs_p);
+    pNode_p->presCount++;
+    pNode_p->latencySum += latency;
+    if (latency < pNode_p->latencyMin)
+        pNode_p->latencyMin = latency;
+    if (latency > pNode_p->latencyMax)
+        pNode_p->latencyMax = latency;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Answer a SoA
+
+\param  pNode_p                 CN addressed by the SoA.
+\param  pFrame_p                Pointer to the SoA.
+*/
+//------------------------------------------------------------------------------
+static void processSoa(tCnode* pNode_p, const BYTE* pFrame_p)
+{
+    UINT    index;
+
+    switch (pFrame_p[PLK_OFS_SOA_SERVICE])
+    {
+        case PLK_SOA_IDENT_REQUEST:
+            pNode_p->fExceptionClear = ((pFrame_p[PLK_OFS_FLAG1] & PLK_FLAG1_ER) != 0);
+            sendIdentResponse(pNode_p);
+            break;
+
+        case PLK_SOA_STATUS_REQUEST:
+            pNode_p->fExceptionClear = ((pFrame_p[PLK_OFS_FLAG1] & PLK_FLAG1_ER) != 0);
+            sendStatusResponse(pNode_p);
+            break;
+
+        case PLK_SOA_UNSPEC_INVITE:
+            if (pNode_p->asyncRead != pNode_p->asyncWrite)
+            {
+                index = pNode_p->asyncRead & (CNODE_ASYNC_QUEUE_LEN - 1);
+                sendFrame(pNode_p->aaAsync[index], pNode_p->aAsyncSize[index]);
+                pNode_p->asyncRead++;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process an NMT command
+
+\param  pNode_p                 Addressed CN.
+\param  command_p               NMT command ID, plain or extended.
+*/
+//------------------------------------------------------------------------------
+static void processNmtCommand(tCnode* pNode_p, UINT command_p)
+{
+    UINT8   state = pNode_p->nmtState;
+
+    // extended commands are the plain commands with a node list
+    if (command_p >= kNmtCmdStartNodeEx)
+        command_p -= kNmtCmdStartNodeEx - kNmtCmdStartNode;
+
+    pNode_p->nmtCount++;
+    switch (command_p)
+    {
+        case kNmtCmdStartNode:
+            if (state == CNODE_STATE_READY_TO_OP)
+                setState(pNode_p, CNODE_STATE_OPERATIONAL);
+            break;
+
+        case kNmtCmdStopNode:
+            if ((state == CNODE_STATE_PREOP2) || (state == CNODE_STATE_READY_TO_OP) ||
+                (state == CNODE_STATE_OPERATIONAL))
+                setState(pNode_p, CNODE_STATE_STOPPED);
+            break;
+
+        case kNmtCmdEnterPreOperational2:
+            if ((state == CNODE_STATE_OPERATIONAL) || (state == CNODE_STATE_STOPPED))
+                setState(pNode_p, CNODE_STATE_PREOP2);
+            break;
+
+        case kNmtCmdEnableReadyToOperate:
+            if (state == CNODE_STATE_PREOP2)
+                setState(pNode_p, CNODE_STATE_READY_TO_OP);
+            break;
+
+        case kNmtCmdResetNode:
+        case kNmtCmdResetCommunication:
+        case kNmtCmdResetConfiguration:
+            resetNode(pNode_p, FALSE);
+            break;
+
+        case kNmtCmdSwReset:
+            resetNode(pNode_p, TRUE);
+            break;
+
+        default:
+            pNode_p->nmtCount--;
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process an SDO frame
+
+The function implements the server side of the SDO sequence layer. The
+responses are queued and sent when the MN invites the CN.
+
+\param  pNode_p                 Addressed CN.
+\param  pFrame_p                Pointer to the ASnd frame.
+\param  size_p                  Size of the frame.
+*/
+//------------------------------------------------------------------------------
+static void processSdo(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p)
+{
+    UINT8   sendSeq = pFrame_p[PLK_OFS_SDO_SEND_SEQ] >> 2;
+    UINT8   sendCon = pFrame_p[PLK_OFS_SDO_SEND_SEQ] & 0x03;
+    BOOL    fCommand;
+    BYTE*   pResponse;
+    UINT    size;
+
+    // frames are padded, a sequence layer acknowledge carries a NIL command
+    fCommand = (size_p >= PLK_OFS_SDO_DATA) &&
+               (pFrame_p[PLK_OFS_SDO_COMMAND] != PLK_SDO_CMD_NIL) &&
+               ((pFrame_p[PLK_OFS_SDO_FLAGS] & PLK_SDO_FLAG_RESPONSE) == 0);
+
+    switch (sendCon)
+    {
+        case PLK_SDO_CON_INIT:
+            pNode_p->sdoCon = PLK_SDO_CON_INIT;
+            pNode_p->sdoRecvSeq = sendSeq;
+            queueSdoFrame(pNode_p, PLK_SDO_CON_INIT, PLK_SDO_CON_INIT);
+            break;
+
+        case PLK_SDO_CON_VALID:
+            if (pNode_p->sdoCon == PLK_SDO_CON_NONE)
+            {
+                // unknown connection, the client has to initialize it again
+                queueSdoFrame(pNode_p, PLK_SDO_CON_NONE, PLK_SDO_CON_NONE);
+            }
+            else if (fCommand && (sendSeq != pNode_p->sdoRecvSeq))
+            {
+                pNode_p->sdoCon = PLK_SDO_CON_VALID;
+                pNode_p->sdoRecvSeq = sendSeq;
+                pNode_p->sdoSendSeq = (pNode_p->sdoSendSeq + 1) & 0x3F;
+
+                pResponse = queueSdoFrame(pNode_p, PLK_SDO_CON_VALID, PLK_SDO_CON_VALID);
+                if (pResponse != NULL)
+                {
+                    size = processSdoCommand(pNode_p, pFrame_p, size_p, pResponse);
+                    if (size > PLK_FRAME_MIN_SIZE)
+                        pNode_p->aAsyncSize[(pNode_p->asyncWrite - 1) & (CNODE_ASYNC_QUEUE_LEN - 1)] = size;
+                }
+            }
+            else if (pNode_p->sdoCon == PLK_SDO_CON_INIT)
+            {
+                pNode_p->sdoCon = PLK_SDO_CON_VALID;
+                queueSdoFrame(pNode_p, PLK_SDO_CON_VALID, PLK_SDO_CON_VALID);
+            }
+            break;
+
+        case PLK_SDO_CON_ACK_REQUEST:
+            queueSdoFrame(pNode_p, pNode_p->sdoCon, pNode_p->sdoCon);
+            break;
+
+        default:
+            pNode_p->sdoCon = PLK_SDO_CON_NONE;
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process an SDO command
+
+The function executes an expedited WriteByIndex or ReadByIndex command and
+fills the command layer of the response.
+
+\param  pNode_p                 Addressed CN.
+\param  pFrame_p                Pointer to the request frame.
+\param  size_p                  Size of the request frame.
+\param  pResponse_p             Pointer to the response frame.
+
+\return The function returns the size of the response frame.
+*/
+//------------------------------------------------------------------------------
+static UINT processSdoCommand(tCnode* pNode_p, const BYTE* pFrame_p, UINT size_p, BYTE* pResponse_p)
+{
+    const tCnodeEntry*  pEntry;
+    BYTE*               pValue;
+    UINT                command = pFrame_p[PLK_OFS_SDO_COMMAND];
+    UINT                segmentSize = (UINT)getUintLe(&pFrame_p[PLK_OFS_SDO_SEGMENT_SIZE], 2);
+    UINT                index;
+    UINT                subIndex;
+    UINT16              length;
+    BOOL                fIndexFound;
+    UINT32              abortCode = 0;
+
+    pNode_p->sdoCount++;
+    pResponse_p[PLK_OFS_SDO_TRANSACTION] = pFrame_p[PLK_OFS_SDO_TRANSACTION];
+    pResponse_p[PLK_OFS_SDO_FLAGS] = PLK_SDO_FLAG_RESPONSE;
+    pResponse_p[PLK_OFS_SDO_COMMAND] = (BYTE)command;
+
+    if (((pFrame_p[PLK_OFS_SDO_FLAGS] & PLK_SDO_SEGMENT_MASK) != 0) ||
+        ((command != PLK_SDO_CMD_WRITE_BY_INDEX) && (command != PLK_SDO_CMD_READ_BY_INDEX)) ||
+        (segmentSize < 4) || (segmentSize > size_p - PLK_OFS_SDO_DATA))
+    {
+        abortCode = CNODE_ABORT_COMMAND;
+    }
+    else
+    {
+        index = (UINT)getUintLe(&pFrame_p[PLK_OFS_SDO_DATA], 2);
+        subIndex = pFrame_p[PLK_OFS_SDO_DATA + 2];
+        pEntry = findEntry(pNode_p->pTemplate, CNODE_KEY(index, subIndex), &fIndexFound);
+
+        if (pEntry == NULL)
+        {
+            abortCode = fIndexFound ? CNODE_ABORT_NO_SUBINDEX : CNODE_ABORT_NO_OBJECT;
+        }
+        else if (command == PLK_SDO_CMD_WRITE_BY_INDEX)
+        {
+            length = (UINT16)(segmentSize - 4);
+            pValue = pNode_p->pValues + pEntry->offset;
+
+            if (!pEntry->fWritable)
+                abortCode = CNODE_ABORT_READ_ONLY;
+            else if (length > pEntry->capacity)
+                abortCode = CNODE_ABORT_LENGTH_HIGH;
+            else if (pEntry->fNumeric && (length != pEntry->capacity))
+                abortCode = CNODE_ABORT_LENGTH;
+            else
+            {
+                memcpy(pValue, &length, sizeof(UINT16));
+                memcpy(pValue + sizeof(UINT16), &pFrame_p[PLK_OFS_SDO_DATA + 4], length);
+            }
+        }
+        else
+        {
+            pValue = pNode_p->pValues + pEntry->offset;
+            memcpy(&length, pValue, sizeof(UINT16));
+            if (length > CNODE_SDO_MAX_DATA)
+                abortCode = CNODE_ABORT_LENGTH_HIGH;
+            else
+            {
+                setUintLe(&pResponse_p[PLK_OFS_SDO_SEGMENT_SIZE], length, 2);
+                memcpy(&pResponse_p[PLK_OFS_SDO_DATA], pValue + sizeof(UINT16), length);
+                return PLK_OFS_SDO_DATA + length;
+            }
+        }
+    }
+
+    if (abortCode != 0)
+    {
+        pResponse_p[PLK_OFS_SDO_FLAGS] |= PLK_SDO_FLAG_ABORT;
+        setUintLe(&pResponse_p[PLK_OFS_SDO_SEGMENT_SIZE], 4, 2);
+        setUintLe(&pResponse_p[PLK_OFS_SDO_DATA], abortCode, 4);
+        return PLK_OFS_SDO_DATA + 4;
+    }
+
+    return PLK_OFS_SDO_DATA;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the IdentResponse of a CN
+
+\param  pNode_p                 Virtual CN.
+*/
+//------------------------------------------------------------------------------
+static void sendIdentResponse(tCnode* pNode_p)
+{
+    BYTE*   pFrame = cnodeInstance_l.aFrame;
+    UINT32  vendorId = (UINT32)readValue(pNode_p, CNODE_IDX_IDENTITY, 1, 0);
+
+    memset(pFrame, 0, PLK_IDENT_RESPONSE_SIZE);
+    initHeader(pFrame, aMulticastAsnd_l, pNode_p, PLK_MSGTYPE_ASND, PLK_NODEID_BROADCAST);
+    pFrame[PLK_OFS_ASND_SERVICE] = PLK_ASND_IDENT_RESPONSE;
+    setResponseFlags(pNode_p, pFrame);
+
+    pFrame[PLK_OFS_IDENT_VERSION] = PLK_VERSION;
+    setUintLe(&pFrame[PLK_OFS_IDENT_FEATURES], readValue(pNode_p, CNODE_IDX_FEATURE_FLAGS, 0, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_MTU], readValue(pNode_p, CNODE_IDX_NMT_CYCLE_TIMING, 8, 300), 2);
+    setUintLe(&pFrame[PLK_OFS_IDENT_POLLIN], readValue(pNode_p, CNODE_IDX_NMT_CYCLE_TIMING, 4, 36), 2);
+    setUintLe(&pFrame[PLK_OFS_IDENT_POLLOUT], readValue(pNode_p, CNODE_IDX_NMT_CYCLE_TIMING, 5, 36), 2);
+    setUintLe(&pFrame[PLK_OFS_IDENT_RESPTIME], readValue(pNode_p, CNODE_IDX_NMT_CYCLE_TIMING, 3, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_DEVICETYPE], readValue(pNode_p, CNODE_IDX_DEVICE_TYPE, 0, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_VENDORID], vendorId, 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_PRODUCTCODE], readValue(pNode_p, CNODE_IDX_IDENTITY, 2, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_REVISION], readValue(pNode_p, CNODE_IDX_IDENTITY, 3, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_SERIAL], readValue(pNode_p, CNODE_IDX_IDENTITY, 4, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_CONFDATE], readValue(pNode_p, CNODE_IDX_VERIFY_CONF, 1, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_CONFTIME], readValue(pNode_p, CNODE_IDX_VERIFY_CONF, 2, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_APPSWDATE], readValue(pNode_p, CNODE_IDX_APP_SW_VERSION, 1, 0), 4);
+    setUintLe(&pFrame[PLK_OFS_IDENT_APPSWTIME], readValue(pNode_p, CNODE_IDX_APP_SW_VERSION, 2, 0), 4);
+
+    // 192.168.100.<node ID>/24 like the demo network
+    pFrame[PLK_OFS_IDENT_IPADDR] = 192;
+    pFrame[PLK_OFS_IDENT_IPADDR + 1] = 168;
+    pFrame[PLK_OFS_IDENT_IPADDR + 2] = 100;
+    pFrame[PLK_OFS_IDENT_IPADDR + 3] = pNode_p->nodeId;
+    memset(&pFrame[PLK_OFS_IDENT_SUBNET], 0xFF, 3);
+    memcpy(&pFrame[PLK_OFS_IDENT_GATEWAY], &pFrame[PLK_OFS_IDENT_IPADDR], 3);
+    pFrame[PLK_OFS_IDENT_GATEWAY + 3] = 0xFE;
+    sprintf((char*)&pFrame[PLK_OFS_IDENT_HOSTNAME], "%02x-%08lx", pNode_p->nodeId, (ULONG)vendorId);
+
+    pNode_p->identCount++;
+    sendFrame(pFrame, PLK_IDENT_RESPONSE_SIZE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the StatusResponse of a CN
+
+\param  pNode_p                 Virtual CN.
+*/
+//------------------------------------------------------------------------------
+static void sendStatusResponse(tCnode* pNode_p)
+{
+    BYTE*   pFrame = cnodeInstance_l.aFrame;
+
+    memset(pFrame, 0, PLK_FRAME_MIN_SIZE);
+    initHeader(pFrame, aMulticastAsnd_l, pNode_p, PLK_MSGTYPE_ASND, PLK_NODEID_BROADCAST);
+    pFrame[PLK_OFS_ASND_SERVICE] = PLK_ASND_STATUS_RESPONSE;
+    setResponseFlags(pNode_p, pFrame);
+
+    pNode_p->statusCount++;
+    sendFrame(pFrame, PLK_FRAME_MIN_SIZE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue an SDO frame
+
+The function queues an SDO frame with the sequence layer header. The command
+layer is left empty (NIL command) and can be filled by the caller.
+
+\param  pNode_p                 Virtual CN.
+\param  recvCon_p               Receive connection state.
+\param  sendCon_p               Send connection state.
+
+\return The function returns the queued frame or NULL if the queue is full.
+*/
+//------------------------------------------------------------------------------
+static BYTE* queueSdoFrame(tCnode* pNode_p, UINT8 recvCon_p, UINT8 sendCon_p)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+    UINT            index = pNode_p->asyncWrite & (CNODE_ASYNC_QUEUE_LEN - 1);
+    BYTE*           pFrame = pNode_p->aaAsync[index];
+
+    if ((pNode_p->asyncWrite - pNode_p->asyncRead) >= CNODE_ASYNC_QUEUE_LEN)
+    {
+        pNode_p->dropCount++;
+        return NULL;
+    }
+
+    memset(pFrame, 0, PLK_FRAME_MIN_SIZE);
+    initHeader(pFrame, pInst->fMnMacValid ? pInst->aMnMac : aMulticastAsnd_l, pNode_p,
+               PLK_MSGTYPE_ASND, PLK_NODEID_MN);
+    pFrame[PLK_OFS_ASND_SERVICE] = PLK_ASND_SDO;
+    pFrame[PLK_OFS_SDO_RECV_SEQ] = (BYTE)((pNode_p->sdoRecvSeq << 2) | recvCon_p);
+    pFrame[PLK_OFS_SDO_SEND_SEQ] = (BYTE)((pNode_p->sdoSendSeq << 2) | sendCon_p);
+
+    pNode_p->aAsyncSize[index] = PLK_FRAME_MIN_SIZE;
+    pNode_p->asyncWrite++;
+    return pFrame;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the header of a frame
+
+\param  pFrame_p                Pointer to the frame.
+\param  pDstMac_p               Destination MAC address.
+\param  pNode_p                 Sending CN.
+\param  msgType_p               Message type.
+\param  dstNodeId_p             Destination node ID.
+*/
+//------------------------------------------------------------------------------
+static void initHeader(BYTE* pFrame_p, const BYTE* pDstMac_p, const tCnode* pNode_p,
+                       UINT msgType_p, UINT dstNodeId_p)
+{
+    memcpy(&pFrame_p[PLK_OFS_DST_MAC], pDstMac_p, 6);
+    memcpy(&pFrame_p[PLK_OFS_SRC_MAC], pNode_p->aMac, 6);
+    pFrame_p[PLK_OFS_ETHERTYPE] = (BYTE)(PLK_ETHERTYPE >> 8);
+    pFrame_p[PLK_OFS_ETHERTYPE + 1] = (BYTE)(PLK_ETHERTYPE & 0xFF);
+    pFrame_p[PLK_OFS_MSGTYPE] = (BYTE)msgType_p;
+    pFrame_p[PLK_OFS_DST_NODE] = (BYTE)dstNodeId_p;
+    pFrame_p[PLK_OFS_SRC_NODE] = pNode_p->nodeId;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the flags and the state of an IdentResponse or StatusResponse
+
+\param  pNode_p                 Sending CN.
+\param  pFrame_p                Pointer to the frame.
+*/
+//------------------------------------------------------------------------------
+static void setResponseFlags(const tCnode* pNode_p, BYTE* pFrame_p)
+{
+    UINT    pending = pNode_p->asyncWrite - pNode_p->asyncRead;
+
+    pFrame_p[PLK_OFS_RESP_FLAG1] = pNode_p->fExceptionClear ? PLK_FLAG1_EC : 0;
+    pFrame_p[PLK_OFS_RESP_FLAG2] = (BYTE)((pending > 0) ? ((PLK_PRIO_GENERIC_REQUEST << PLK_FLAG2_PR_SHIFT) | pending) : 0);
+    pFrame_p[PLK_OFS_RESP_NMTSTATE] = pNode_p->nmtState;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send a frame
+
+\param  pFrame_p                Pointer to the frame.
+\param  size_p                  Size of the frame.
+*/
+//------------------------------------------------------------------------------
+static void sendFrame(const BYTE* pFrame_p, UINT size_p)
+{
+    tCnodeInstance* pInst = &cnodeInstance_l;
+
+    if (pInst->pfnSend(pFrame_p, size_p, pInst->pSendArg) != 0)
+        pInst->sendErrorCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a little endian unsigned value
+
+\param  pData_p                 Pointer to the value.
+\param  size_p                  Size of the value [bytes], 1 to 8.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getUintLe(const BYTE* pData_p, UINT size_p)
+{
+    UINT64  value = 0;
+
+    while (size_p > 0)
+    {
+        size_p--;
+        value = (value << 8) | pData_p[size_p];
+    }
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write a little endian unsigned value
+
+\param  pData_p                 Pointer to the destination.
+\param  value_p                 Value.
+\param  size_p                  Size of the value [bytes], 1 to 8.
+*/
+//------------------------------------------------------------------------------
+static void setUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p)
+{
+    UINT    i;
+
+    for (i = 0; i < size_p; i++)
+    {
+        pData_p[i] = (BYTE)value_p;
+        value_p >>= 8;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare two entries by their key
+
+\param  pLeft_p                 First entry.
+\param  pRight_p                Second entry.
+
+\return The function returns <0, 0 or >0 like strcmp().
+*/
+//------------------------------------------------------------------------------
+static int compareEntry(const void* pLeft_p, const void* pRight_p)
+{
+    const tCnodeEntry*  pLeft = (const tCnodeEntry*)pLeft_p;
+    const tCnodeEntry*  pRight = (const tCnodeEntry*)pRight_p;
+
+    if (pLeft->key < pRight->key)
+        return -1;
+
+    return (pLeft->key > pRight->key) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the name of an NMT state
+
+\param  nmtState_p              NMT state on the wire.
+
+\return The function returns the name of the state.
+*/
+//------------------------------------------------------------------------------
+static const char* getStateName(UINT8 nmtState_p)
+{
+    switch (nmtState_p)
+    {
+        case CNODE_STATE_NOT_ACTIVE:    return "NOT_ACTIVE";
+        case CNODE_STATE_PREOP1:        return "PREOP1";
+        case CNODE_STATE_PREOP2:        return "PREOP2";
+        case CNODE_STATE_READY_TO_OP:   return "READY_TO_OP";
+        case CNODE_STATE_OPERATIONAL:   return "OPERATIONAL";
+        case CNODE_STATE_STOPPED:       return "STOPPED";
+        default:                        return "?";
+    }
+}
+
+/// \}
@@ -0,0 +1,87 @@
+/**
+********************************************************************************
+\file   cnode.h
+
+\brief  Definitions for the virtual CNs
+
+The file contains the definitions for the virtual CNs of the CN emulator.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_cnode_H_
+#define _INC_cnode_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CNODE_MAX_NODES             239     ///< Maximum number of virtual CNs
+#define CNODE_ASYNC_QUEUE_LEN       4       ///< Asynchronous frames queued per CN (power of 2)
+#define CNODE_STRING_LEN            32      ///< Minimum capacity of string and domain objects
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Frame transmit function
+
+The function type is called by the virtual CNs to send a frame.
+
+\param  pFrame_p                Pointer to the frame.
+\param  size_p                  Size of the frame without FCS.
+\param  pArg_p                  Argument passed to cnode_init().
+
+\return The function returns 0 if the frame has been sent.
+*/
+typedef int (*tCnodeSendCb)(const BYTE* pFrame_p, UINT size_p, void* pArg_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError cnode_init(const char* pszConfigFile_p, tCnodeSendCb pfnSend_p, void* pArg_p);
+void       cnode_exit(void);
+void       cnode_processFrame(const BYTE* pFrame_p, UINT size_p, UINT64 rxTimeNs_p);
+UINT       cnode_getNodeCount(void);
+void       cnode_printStatistics(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_cnode_H_ */
@@ -0,0 +1,675 @@
+/**
+********************************************************************************
+\file   cyctune.c
+
+\brief  Cycle length auto-tuner of the MN demo application
+
+This file contains the cycle length auto-tuner of the MN demo application,
+which is used during commissioning.
+
+The tuner searches the smallest stable cycle length between a lower bound and
+the configured cycle length (0x1006) by bisection. For every step, the cycle
+length is written to the loaded CDC and the network is restarted with an NMT
+reset. After the MN has reached operational, the network is soaked for
+CYCTUNE_SOAK_TIME while the tuner watches
+- PRes timeouts (E_DLL_LOSS_PRES_TH),
+- loss of SoC and SoA (E_DLL_LOSS_SOC_TH, E_DLL_LOSS_SOA_TH),
+- cycle time exceeded by the MN (E_DLL_CYCLE_EXCEED),
+- the MN dropping out of operational,
+- sync events missed by the application (sync overruns),
+- the application time compared with CYCTUNE_BUDGET_PERCENT of the cycle.
+A step is stable if none of them occurs. The result is the smallest stable
+cycle length plus CYCTUNE_MARGIN_PERCENT. It is written to the CDC, which is
+saved, and optionally to the cycleTime of the openCONFIGURATOR project, so
+the next generated CDC uses it as well.
+
+The control loops, axes and alarms keep the cycle length they were
+initialized with, so the tuner is used without them.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "cyctune.h"
+#include "cdc.h"
+#include "errhist.h"
+#include "phase.h"
+#include "reinteg.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CYCTUNE_CYCLE_LEN_INDEX     0x1006      // NMT_CycleLen_U32 [us]
+#define CYCTUNE_MAX_NODEID          239         // highest node ID of a regular CN
+#define CYCTUNE_POLL_INTERVAL       10          // interval of the state polling [ms]
+#define CYCTUNE_PROJECT_ATTRIBUTE   "cycleTime=\""
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Result of a soak
+*/
+typedef struct
+{
+    BOOL                fOperational;       ///< MN reached operational after the reset
+    UINT64              bootTime;           ///< Time from the reset to operational [ns]
+    UINT32              presTimeoutCount;   ///< PRes timeouts
+    UINT32              lossCount;          ///< Lost SoC and SoA frames
+    UINT32              exceedCount;        ///< Cycles exceeding the cycle length
+    UINT32              dropCount;          ///< Drops out of operational
+    UINT32              overrunCount;       ///< Sync events missed by the application
+    UINT32              maxAppTime;         ///< Maximum application time [ns]
+} tCycTuneSoak;
+
+/**
+\brief  Cycle length tuner instance
+
+The structure contains the local variables of the tuner. The sync statistics
+are written by the sync thread, the tuner requests their reset with
+fResetSync.
+*/
+typedef struct
+{
+    UINT32              cycleLen;           ///< Configured cycle length [us], 0 = disabled
+    UINT32              minCycleLen;        ///< Lower bound of the search [us]
+    const char*         pszCdcFile;         ///< File to save the tuned CDC
+    const char*         pszProjectFile;     ///< openCONFIGURATOR project to update, or NULL
+    volatile UINT32     testCycleLen;       ///< Cycle length of the current step [us]
+    volatile BOOL       fOperational;       ///< MN is operational
+    volatile UINT32     dropCount;          ///< Number of drops out of operational
+    volatile BOOL       fResetSync;         ///< Reset of the sync statistics requested
+    UINT64              syncTime;           ///< Time of the current sync event [ns]
+    UINT64              lastSyncTime;       ///< Time of the previous sync event [ns]
+    volatile UINT32     syncOverrunCount;   ///< Sync events missed by the application
+    volatile UINT32     syncMaxAppTime;     ///< Maximum application time [ns]
+} tCycTuneInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCycTuneInstance     cycTuneInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError testCycleLen(UINT32 cycleLen_p, BOOL* pfStable_p);
+static tOplkError soak(tCycTuneSoak* pSoak_p);
+static tOplkError setCycleLen(UINT32 cycleLen_p);
+static tOplkError updateProject(const char* pszFileName_p, UINT32 cycleLen_p);
+static BOOL       sleepChecked(UINT time_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the cycle length tuner
+
+The function enables the tuner. It must be called after the CDC has been
+loaded.
+
+\param  cycleLen_p              Configured cycle length [us], upper bound of the
+                                search.
+\param  minCycleLen_p           Lower bound of the search [us].
+\param  pszCdcFile_p            File to save the CDC with the tuned cycle length.
+\param  pszProjectFile_p        openCONFIGURATOR project to update, or NULL.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cyctune_init(UINT32 cycleLen_p, UINT32 minCycleLen_p, const char* pszCdcFile_p,
+                  const char* pszProjectFile_p)
+{
+    memset(&cycTuneInstance_l, 0, sizeof(cycTuneInstance_l));
+    cycTuneInstance_l.cycleLen = cycleLen_p;
+    cycTuneInstance_l.minCycleLen = minCycleLen_p;
+    cycTuneInstance_l.pszCdcFile = pszCdcFile_p;
+    cycTuneInstance_l.pszProjectFile = pszProjectFile_p;
+    cycTuneInstance_l.testCycleLen = cycleLen_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check whether the tuner is enabled
+
+\return The function returns TRUE if the cycle length is tuned before the
+        normal operation.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL cyctune_isEnabled(void)
+{
+    return (cycTuneInstance_l.cycleLen != 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record a sync event
+
+The function is called by the synchronous task at the sync event. A sync
+event which comes later than 1.5 cycles after the previous one means that the
+application has missed one.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cyctune_syncEvent(void)
+{
+    tCycTuneInstance*   pInstance = &cycTuneInstance_l;
+    UINT64              now;
+
+    if (pInstance->cycleLen == 0)
+        return;
+
+    now = system_getTimeNs();
+    if (pInstance->fResetSync)
+    {
+        pInstance->syncOverrunCount = 0;
+        pInstance->syncMaxAppTime = 0;
+        pInstance->lastSyncTime = 0;
+        pInstance->fResetSync = FALSE;
+    }
+
+    if ((pInstance->lastSyncTime != 0) &&
+        ((now - pInstance->lastSyncTime) * 2 > (UINT64)pInstance->testCycleLen * 3000))
+        pInstance->syncOverrunCount++;
+
+    pInstance->lastSyncTime = now;
+    pInstance->syncTime = now;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record the end of the synchronous processing
+
+The function is called by the synchronous task when the processing of the
+cycle is finished. The time since the sync event is the application time.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cyctune_syncDone(void)
+{
+    tCycTuneInstance*   pInstance = &cycTuneInstance_l;
+    UINT32              appTime;
+
+    if ((pInstance->cycleLen == 0) || (pInstance->syncTime == 0))
+        return;
+
+    appTime = (UINT32)(system_getTimeNs() - pInstance->syncTime);
+    if (appTime > pInstance->syncMaxAppTime)
+        pInstance->syncMaxAppTime = appTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process an NMT state change of the MN
+
+\param  nmtState_p              New NMT state of the MN.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void cyctune_processNmtState(tNmtState nmtState_p)
+{
+    tCycTuneInstance*   pInstance = &cycTuneInstance_l;
+
+    if (nmtState_p == kNmtMsOperational)
+    {
+        pInstance->fOperational = TRUE;
+    }
+    else if (pInstance->fOperational)
+    {
+        pInstance->fOperational = FALSE;
+        pInstance->dropCount++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the cycle length search
+
+The function searches the smallest stable cycle length. It is called instead
+of the first NMT reset, the sync thread must already be running. When the
+function returns successfully, the tuned cycle length has been passed to the
+stack and is used after the next NMT reset.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The cycle length has been tuned.
+\retval kErrorReject            The configured cycle length is not stable.
+\retval kErrorShutdown          The search has been aborted by the user.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError cyctune_run(void)
+{
+    tCycTuneInstance*   pInstance = &cycTuneInstance_l;
+    UINT32              stableLen;
+    UINT32              unstableLen;
+    UINT32              testLen;
+    UINT32              tunedLen;
+    BOOL                fStable;
+    tOplkError          ret;
+
+    printf("Commissioning: searching the smallest stable cycle length between %lu and %lu us\n",
+           (ULONG)pInstance->minCycleLen, (ULONG)pInstance->cycleLen);
+    printf("Press Esc to abort\n");
+
+    // the configured cycle length must be stable, it is the upper bound
+    ret = testCycleLen(pInstance->cycleLen, &fStable);
+    if (ret != kErrorOk)
+        return ret;
+
+    if (!fStable)
+    {
+        printf("The configured cycle length of %lu us is not stable!\n", (ULONG)pInstance->cycleLen);
+        return kErrorReject;
+    }
+
+    // bisection between the largest unstable and the smallest stable length,
+    // the lower bound counts as unstable until it has been tested
+    stableLen = pInstance->cycleLen;
+    unstableLen = (pInstance->minCycleLen > CYCTUNE_RESOLUTION) ?
+                  (pInstance->minCycleLen - CYCTUNE_RESOLUTION) : 0;
+    while ((stableLen - unstableLen) > CYCTUNE_RESOLUTION)
+    {
+        testLen = unstableLen + ((stableLen - unstableLen) / CYCTUNE_RESOLUTION / 2) * CYCTUNE_RESOLUTION;
+        if (testLen <= unstableLen)
+            testLen = unstableLen + CYCTUNE_RESOLUTION;
+
+        ret = testCycleLen(testLen, &fStable);
+        if (ret != kErrorOk)
+            return ret;
+
+        if (fStable)
+            stableLen = testLen;
+        else
+            unstableLen = testLen;
+    }
+
+    tunedLen = stableLen + (stableLen * CYCTUNE_MARGIN_PERCENT + 99) / 100;
+    tunedLen = ((tunedLen + CYCTUNE_RESOLUTION - 1) / CYCTUNE_RESOLUTION) * CYCTUNE_RESOLUTION;
+    if (tunedLen > pInstance->cycleLen)
+        tunedLen = pInstance->cycleLen;
+
+    printf("Smallest stable cycle length: %lu us, tuned cycle length with %u %% margin: %lu us\n",
+           (ULONG)stableLen, CYCTUNE_MARGIN_PERCENT, (ULONG)tunedLen);
+
+    ret = setCycleLen(tunedLen);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = cdc_save(pInstance->pszCdcFile);
+    if (ret != kErrorOk)
+        return ret;
+    printf("Tuned CDC saved to %s\n", pInstance->pszCdcFile);
+
+    if (pInstance->pszProjectFile != NULL)
+    {
+        ret = updateProject(pInstance->pszProjectFile, tunedLen);
+        if (ret != kErrorOk)
+            return ret;
+        printf("Cycle time of project %s updated\n", pInstance->pszProjectFile);
+    }
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Test a cycle length
+
+The function restarts the network with the given cycle length, soaks it and
+prints the result of the step.
+
+\param  cycleLen_p              Cycle length to test [us].
+\param  pfStable_p              Returns whether the cycle length is stable.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError testCycleLen(UINT32 cycleLen_p, BOOL* pfStable_p)
+{
+    tCycTuneSoak        result;
+    UINT64              budget;
+    tOplkError          ret;
+
+    ret = setCycleLen(cycleLen_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    printf("  %6lu us: ", (ULONG)cycleLen_p);
+    fflush(stdout);
+
+    memset(&result, 0, sizeof(result));
+    ret = soak(&result);
+    if (ret == kErrorShutdown)
+    {
+        printf("aborted\n");
+        return ret;
+    }
+
+    if (ret != kErrorOk)
+    {
+        printf("NMT reset failed with 0x%X\n", ret);
+        return ret;
+    }
+
+    if (!result.fOperational)
+    {
+        printf("unstable, not operational within %u ms\n", CYCTUNE_BOOT_TIMEOUT);
+        *pfStable_p = FALSE;
+        return kErrorOk;
+    }
+
+    budget = (UINT64)cycleLen_p * 10 * CYCTUNE_BUDGET_PERCENT;
+    *pfStable_p = (result.presTimeoutCount == 0) && (result.lossCount == 0) &&
+                  (result.exceedCount == 0) && (result.dropCount == 0) &&
+                  (result.overrunCount == 0) && (result.maxAppTime <= budget);
+
+    printf("%s, boot %.1f s, PRes timeouts %lu, lost frames %lu, cycle exceeded %lu, "
+           "drops %lu, sync overruns %lu, application %.1f us (%.0f %%)\n",
+           *pfStable_p ? "stable" : "unstable", (double)result.bootTime / 1000000000.0,
+           (ULONG)result.presTimeoutCount, (ULONG)result.lossCount, (ULONG)result.exceedCount,
+           (ULONG)result.dropCount, (ULONG)result.overrunCount,
+           (double)result.maxAppTime / 1000.0,
+           (double)result.maxAppTime / 10.0 / (double)cycleLen_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Restart and soak the network
+
+The function resets the network, waits until the MN is operational and
+observes it for the soak time. The soak is ended early if the MN drops out of
+operational.
+
+\param  pSoak_p                 Returns the result of the soak.
+
+\return The function returns a tOplkError error code.
+\retval kErrorShutdown          The user has aborted the soak.
+*/
+//------------------------------------------------------------------------------
+static tOplkError soak(tCycTuneSoak* pSoak_p)
+{
+    tCycTuneInstance*   pInstance = &cycTuneInstance_l;
+    UINT64              startTime;
+    UINT32              presTimeouts;
+    UINT32              losses;
+    UINT32              exceeds;
+    UINT32              drops;
+    UINT                elapsed;
+    tOplkError          ret;
+
+    pInstance->fOperational = FALSE;
+    startTime = system_getTimeNs();
+    ret = oplk_execNmtCommand(kNmtEventSwReset);
+    if (ret != kErrorOk)
+        return ret;
+
+    for (elapsed = 0; !pInstance->fOperational; elapsed += CYCTUNE_POLL_INTERVAL)
+    {
+        if (elapsed >= CYCTUNE_BOOT_TIMEOUT)
+            return kErrorOk;
+        if (!sleepChecked(CYCTUNE_POLL_INTERVAL))
+            return kErrorShutdown;
+    }
+
+    pSoak_p->fOperational = TRUE;
+    pSoak_p->bootTime = system_getTimeNs() - startTime;
+
+    // the first cycles after the boot-up are not representative
+    if (!sleepChecked(CYCTUNE_SETTLE_TIME))
+        return kErrorShutdown;
+
+    presTimeouts = errhist_getCodeCount(E_DLL_LOSS_PRES_TH);
+    losses = errhist_getCodeCount(E_DLL_LOSS_SOC_TH) + errhist_getCodeCount(E_DLL_LOSS_SOA_TH);
+    exceeds = errhist_getCodeCount(E_DLL_CYCLE_EXCEED);
+    drops = pInstance->dropCount;
+    pInstance->fResetSync = TRUE;
+
+    for (elapsed = 0; elapsed < CYCTUNE_SOAK_TIME; elapsed += CYCTUNE_POLL_INTERVAL)
+    {
+        if (pInstance->dropCount != drops)
+            break;
+        if (!sleepChecked(CYCTUNE_POLL_INTERVAL))
+            return kErrorShutdown;
+    }
+
+    pSoak_p->presTimeoutCount = errhist_getCodeCount(E_DLL_LOSS_PRES_TH) - presTimeouts;
+    pSoak_p->lossCount = errhist_getCodeCount(E_DLL_LOSS_SOC_TH) +
+                         errhist_getCodeCount(E_DLL_LOSS_SOA_TH) - losses;
+    pSoak_p->exceedCount = errhist_getCodeCount(E_DLL_CYCLE_EXCEED) - exceeds;
+    pSoak_p->dropCount = pInstance->dropCount - drops;
+    if (!pInstance->fResetSync)
+    {
+        pSoak_p->overrunCount = pInstance->syncOverrunCount;
+        pSoak_p->maxAppTime = pInstance->syncMaxAppTime;
+    }
+    else
+    {
+        // the application has not been synchronized at all
+        pSoak_p->overrunCount = 1;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the cycle length
+
+The function writes the cycle length to the CDC of the MN and to the DCFs of
+the CNs which contain it. The configuration time of a changed DCF is updated,
+so the configuration manager downloads it. The modified CDC is passed to the
+stack and becomes effective with the next NMT reset. The node configurations
+are restaged for the reintegration module, so a CN which still reports the
+previous configuration time is not released by the fast path.
+
+\param  cycleLen_p              Cycle length [us].
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setCycleLen(UINT32 cycleLen_p)
+{
+    tCdcEntry           entry;
+    const BYTE*         pDcf;
+    UINT                dcfSize;
+    BYTE*               pCdc;
+    UINT                cdcSize;
+    UINT                nodeId;
+    tOplkError          ret;
+
+    ret = cdc_setEntry(CYCTUNE_CYCLE_LEN_INDEX, 0, cycleLen_p, 4);
+    if (ret != kErrorOk)
+        return ret;
+
+    for (nodeId = 1; nodeId <= CYCTUNE_MAX_NODEID; nodeId++)
+    {
+        if (!cdc_getNodeDcf(nodeId, &pDcf, &dcfSize) ||
+            !cdc_findEntry(pDcf, dcfSize, CYCTUNE_CYCLE_LEN_INDEX, 0, &entry))
+            continue;
+
+        ret = cdc_setNodeEntry(nodeId, CYCTUNE_CYCLE_LEN_INDEX, 0, cycleLen_p, 4);
+        if (ret == kErrorOk)
+            ret = cdc_updateConfTime(nodeId);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    pCdc = cdc_getBuffer(&cdcSize);
+    ret = oplk_setCdcBuffer(pCdc, cdcSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    reinteg_restage();
+    cycTuneInstance_l.testCycleLen = cycleLen_p;
+    phase_setCycleLen(cycleLen_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the cycle time of the openCONFIGURATOR project
+
+The function replaces the value of the first cycleTime attribute, which
+belongs to the network configuration of the project.
+
+\param  pszFileName_p           File name of the project.
+\param  cycleLen_p              Cycle length [us].
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError updateProject(const char* pszFileName_p, UINT32 cycleLen_p)
+{
+    FILE*               pFile;
+    char*               pText;
+    char*               pValue;
+    char*               pEnd;
+    long                size;
+    tOplkError          ret = kErrorOk;
+
+    pFile = fopen(pszFileName_p, "rb");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open project %s!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    pText = (size > 0) ? (char*)malloc((size_t)size + 1) : NULL;
+    if ((pText == NULL) || (fread(pText, 1, (size_t)size, pFile) != (size_t)size))
+    {
+        fclose(pFile);
+        free(pText);
+        fprintf(stderr, "Unable to read project %s!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+    fclose(pFile);
+    pText[size] = '\0';
+
+    pValue = strstr(pText, CYCTUNE_PROJECT_ATTRIBUTE);
+    pEnd = (pValue != NULL) ? strchr(pValue + strlen(CYCTUNE_PROJECT_ATTRIBUTE), '"') : NULL;
+    if (pEnd == NULL)
+    {
+        free(pText);
+        fprintf(stderr, "Project %s has no cycle time!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+    pValue += strlen(CYCTUNE_PROJECT_ATTRIBUTE);
+
+    pFile = fopen(pszFileName_p, "wb");
+    if ((pFile == NULL) ||
+        (fwrite(pText, 1, (size_t)(pValue - pText), pFile) != (size_t)(pValue - pText)) ||
+        (fprintf(pFile, "%lu", (ULONG)cycleLen_p) < 0) ||
+        (fwrite(pEnd, 1, strlen(pEnd), pFile) != strlen(pEnd)))
+    {
+        fprintf(stderr, "Unable to write project %s!\n", pszFileName_p);
+        ret = kErrorNoResource;
+    }
+
+    if (pFile != NULL)
+        fclose(pFile);
+    free(pText);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Sleep and check for an abort
+
+The function sleeps for the given time and keeps the console log flowing.
+
+\param  time_p                  Time to sleep [ms].
+
+\return The function returns FALSE if the user has aborted the search.
+*/
+//------------------------------------------------------------------------------
+static BOOL sleepChecked(UINT time_p)
+{
+    system_msleep(time_p);
+    console_flushlog();
+
+    if (console_kbhit() && (console_getch() == 0x1B))
+        return FALSE;
+
+    return !system_getTermSignalState();
+}
+
+/// \}
@@ -0,0 +1,82 @@
+/**
+********************************************************************************
+\file   cyctune.h
+
+\brief  Definitions for the cycle length auto-tuner
+
+The file contains the definitions for the cycle length auto-tuner of the MN
+demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_cyctune_H_
+#define _INC_cyctune_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CYCTUNE_MIN_CYCLE_LEN       200     ///< Default lower bound of the search [us]
+#define CYCTUNE_RESOLUTION          10      ///< Resolution of the search [us]
+#define CYCTUNE_MARGIN_PERCENT      20      ///< Safety margin added to the smallest stable cycle length
+#define CYCTUNE_BUDGET_PERCENT      80      ///< Allowed application time [% of the cycle]
+#define CYCTUNE_BOOT_TIMEOUT        30000   ///< Time to reach operational after the reset [ms]
+#define CYCTUNE_SETTLE_TIME         1000    ///< Time between reaching operational and the soak [ms]
+#define CYCTUNE_SOAK_TIME           10000   ///< Duration of the soak at one cycle length [ms]
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void       cyctune_init(UINT32 cycleLen_p, UINT32 minCycleLen_p, const char* pszCdcFile_p,
+                        const char* pszProjectFile_p);
+BOOL       cyctune_isEnabled(void);
+void       cyctune_syncEvent(void);
+void       cyctune_syncDone(void);
+void       cyctune_processNmtState(tNmtState nmtState_p);
+tOplkError cyctune_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_cyctune_H_ */
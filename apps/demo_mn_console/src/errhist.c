@@ -0,0 +1,651 @@
+/**
+********************************************************************************
+\file   errhist.c
+
+\brief  Error history store of the MN demo application
+
+This file contains the error history store of the MN demo application.
+
+The store keeps the most recent error history entries and node errors in a
+fixed-size ring. Every record is chained to the previous record of the same
+node and of the same error code, so the records of a node or an error code
+can be found without scanning the whole ring. Total, per-node and per-code
+counters are updated in O(1) when a record is added.
+
+Records are added only by the stack event callback (single writer). Readers
+never block the writer: a record carries a sequence number which is cleared
+while the slot is written. A reader discards a record whose sequence number
+changed during the copy.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "errhist.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ERRHIST_ENTRY_MASK      (ERRHIST_ENTRY_COUNT - 1)
+#define ERRHIST_CODE_MASK       (ERRHIST_CODE_TABLE_SIZE - 1)
+#define ERRHIST_NODE_COUNT      256
+#define ERRHIST_SUMMARY_CODES   10          // number of error codes printed in the summary
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  History ring slot
+
+The structure describes a slot of the history ring.
+*/
+typedef struct
+{
+    volatile UINT32     sequence;           ///< Sequence number of the record, 0 while written
+    UINT32              prevNodeSequence;   ///< Previous record of the same node (0 = none)
+    UINT32              prevCodeSequence;   ///< Previous record of the same error code (0 = none)
+    tErrHistRecord      record;             ///< Record data
+} tErrHistSlot;
+
+/**
+\brief  Error code index entry
+
+The structure describes an entry of the error code index.
+*/
+typedef struct
+{
+    volatile UINT32     key;                ///< Error code + 1 (0 = unused entry)
+    volatile UINT32     count;              ///< Number of records with this error code
+    volatile UINT32     headSequence;       ///< Most recent record with this error code
+} tErrHistCodeIndex;
+
+/**
+\brief  Error history instance
+
+The structure contains the local variables of the error history store.
+*/
+typedef struct
+{
+    tErrHistSlot        aSlot[ERRHIST_ENTRY_COUNT];             ///< History ring
+    volatile UINT32     lastSequence;                           ///< Sequence number of the last record
+    volatile UINT32     aNodeCount[ERRHIST_NODE_COUNT];         ///< Number of records per node
+    volatile UINT32     aNodeHead[ERRHIST_NODE_COUNT];          ///< Most recent record per node
+    tErrHistCodeIndex   aCodeIndex[ERRHIST_CODE_TABLE_SIZE];    ///< Error code index
+    volatile UINT32     unindexedCount;                         ///< Records not in the code index
+} tErrHistInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tErrHistInstance     errHistInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void               addRecord(UINT nodeId_p, UINT16 entryType_p, UINT16 errorCode_p,
+                                    const tNetTime* pNetTime_p, const UINT8* pAddInfo_p);
+static tErrHistCodeIndex* findCodeIndex(UINT16 errorCode_p, BOOL fCreate_p);
+static BOOL               readRecord(UINT32 sequence_p, tErrHistRecord* pRecord_p,
+                                     UINT32* pPrevNodeSequence_p, UINT32* pPrevCodeSequence_p);
+static UINT               queryChain(UINT32 headSequence_p, BOOL fNodeChain_p,
+                                     UINT64 startTime_p, UINT64 endTime_p,
+                                     tErrHistRecord* pRecords_p, UINT maxRecords_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the error history store
+
+The function initializes the error history store.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void errhist_init(void)
+{
+    memset(&errHistInstance_l, 0, sizeof(errHistInstance_l));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a history entry
+
+The function adds an error history entry reported by the stack.
+
+\param  nodeId_p                Node ID the entry belongs to
+                                (ERRHIST_NODE_LOCAL for the MN itself).
+\param  pEntry_p                Pointer to the history entry.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void errhist_addEntry(UINT nodeId_p, const tErrHistoryEntry* pEntry_p)
+{
+    addRecord(nodeId_p, pEntry_p->entryType, pEntry_p->errorCode,
+              &pEntry_p->timeStamp, pEntry_p->aAddInfo);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a node error
+
+The function adds an error reported for a CN by a node event.
+
+\param  nodeId_p                Node ID of the CN.
+\param  errorCode_p             Error code of the node event.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void errhist_addNodeError(UINT nodeId_p, UINT16 errorCode_p)
+{
+    tNetTime    netTime;
+
+    netTime.sec = 0;
+    netTime.nsec = 0;
+    addRecord(nodeId_p, ERRHIST_TYPE_NODE_ERROR, errorCode_p, &netTime, NULL);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get total number of records
+
+\return The function returns the number of records added since startup.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT32 errhist_getTotalCount(void)
+{
+    return errHistInstance_l.lastSequence;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get number of records of a node
+
+\param  nodeId_p                Node ID.
+
+\return The function returns the number of records added for the node since
+        startup.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT32 errhist_getNodeCount(UINT nodeId_p)
+{
+    if (nodeId_p >= ERRHIST_NODE_COUNT)
+        return 0;
+
+    return errHistInstance_l.aNodeCount[nodeId_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get number of records with an error code
+
+\param  errorCode_p             Error code.
+
+\return The function returns the number of records added with the error code
+        since startup.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT32 errhist_getCodeCount(UINT16 errorCode_p)
+{
+    tErrHistCodeIndex*  pIndex = findCodeIndex(errorCode_p, FALSE);
+
+    return (pIndex != NULL) ? pIndex->count : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Query records by time
+
+The function returns the records in the given time range in chronological
+order. The start of the range is located by a binary search in the ring.
+
+\param  startTime_p             Start of the time range [ns].
+\param  endTime_p               End of the time range [ns].
+\param  pRecords_p              Array to store the records.
+\param  maxRecords_p            Size of the record array.
+
+\return The function returns the number of records stored. If more records
+        are available, the oldest records of the range are returned.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT errhist_queryByTime(UINT64 startTime_p, UINT64 endTime_p,
+                         tErrHistRecord* pRecords_p, UINT maxRecords_p)
+{
+    UINT32          last = errHistInstance_l.lastSequence;
+    UINT32          low;
+    UINT32          high;
+    UINT32          mid;
+    UINT32          sequence;
+    UINT            count = 0;
+    tErrHistRecord  record;
+
+    if (last == 0)
+        return 0;
+
+    low = (last > ERRHIST_ENTRY_COUNT) ? (last - ERRHIST_ENTRY_COUNT + 1) : 1;
+    high = last + 1;
+
+    // find first record with time >= start, overwritten records count as too old
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2);
+        if (!readRecord(mid, &record, NULL, NULL) || (record.time < startTime_p))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    for (sequence = low; (sequence <= last) && (count < maxRecords_p); sequence++)
+    {
+        if (!readRecord(sequence, &record, NULL, NULL))
+            continue;
+
+        if (record.time > endTime_p)
+            break;
+
+        pRecords_p[count++] = record;
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Query records of a node
+
+The function returns the records of a node in the given time range in
+chronological order. Only the records of the node are visited.
+
+\param  nodeId_p                Node ID.
+\param  startTime_p             Start of the time range [ns].
+\param  endTime_p               End of the time range [ns].
+\param  pRecords_p              Array to store the records.
+\param  maxRecords_p            Size of the record array.
+
+\return The function returns the number of records stored. If more records
+        are available, the most recent records of the range are returned.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT errhist_queryByNode(UINT nodeId_p, UINT64 startTime_p, UINT64 endTime_p,
+                         tErrHistRecord* pRecords_p, UINT maxRecords_p)
+{
+    if (nodeId_p >= ERRHIST_NODE_COUNT)
+        return 0;
+
+    return queryChain(errHistInstance_l.aNodeHead[nodeId_p], TRUE,
+                      startTime_p, endTime_p, pRecords_p, maxRecords_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Query records with an error code
+
+The function returns the records with the given error code in the given time
+range in chronological order. Only the records with the error code are
+visited.
+
+\param  errorCode_p             Error code.
+\param  startTime_p             Start of the time range [ns].
+\param  endTime_p               End of the time range [ns].
+\param  pRecords_p              Array to store the records.
+\param  maxRecords_p            Size of the record array.
+
+\return The function returns the number of records stored. If more records
+        are available, the most recent records of the range are returned.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT errhist_queryByCode(UINT16 errorCode_p, UINT64 startTime_p, UINT64 endTime_p,
+                         tErrHistRecord* pRecords_p, UINT maxRecords_p)
+{
+    tErrHistCodeIndex*  pIndex = findCodeIndex(errorCode_p, FALSE);
+
+    if (pIndex == NULL)
+        return 0;
+
+    return queryChain(pIndex->headSequence, FALSE,
+                      startTime_p, endTime_p, pRecords_p, maxRecords_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print error history summary
+
+The function prints the error counters per node and the most frequent error
+codes.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void errhist_printSummary(void)
+{
+    tErrHistCodeIndex*  pIndex;
+    UINT32              aPrinted[ERRHIST_CODE_TABLE_SIZE / 32];
+    UINT32              total = errHistInstance_l.lastSequence;
+    UINT                best;
+    UINT                i;
+    UINT                n;
+
+    printf("Error history: %lu records (%lu in store)\n", (ULONG)total,
+           (ULONG)((total > ERRHIST_ENTRY_COUNT) ? ERRHIST_ENTRY_COUNT : total));
+    if (total == 0)
+        return;
+
+    printf("  Records per node:");
+    for (i = 0; i < ERRHIST_NODE_COUNT; i++)
+    {
+        if (errHistInstance_l.aNodeCount[i] != 0)
+            printf(" %u:%lu", i, (ULONG)errHistInstance_l.aNodeCount[i]);
+    }
+    printf("\n");
+
+    printf("  Most frequent error codes:\n");
+    memset(aPrinted, 0, sizeof(aPrinted));
+    for (n = 0; n < ERRHIST_SUMMARY_CODES; n++)
+    {
+        best = ERRHIST_CODE_TABLE_SIZE;
+        for (i = 0; i < ERRHIST_CODE_TABLE_SIZE; i++)
+        {
+            pIndex = &errHistInstance_l.aCodeIndex[i];
+            if ((pIndex->key == 0) || ((aPrinted[i / 32] & (1UL << (i % 32))) != 0))
+                continue;
+
+            if ((best == ERRHIST_CODE_TABLE_SIZE) ||
+                (pIndex->count > errHistInstance_l.aCodeIndex[best].count))
+                best = i;
+        }
+
+        if (best == ERRHIST_CODE_TABLE_SIZE)
+            break;
+
+        aPrinted[best / 32] |= (1UL << (best % 32));
+        printf("    0x%04lX: %lu\n", (ULONG)(errHistInstance_l.aCodeIndex[best].key - 1),
+               (ULONG)errHistInstance_l.aCodeIndex[best].count);
+    }
+
+    if (errHistInstance_l.unindexedCount != 0)
+        printf("    (%lu records with unindexed codes)\n", (ULONG)errHistInstance_l.unindexedCount);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a record
+
+The function writes a record into the ring and updates the indexes and
+counters.
+
+\param  nodeId_p                Node ID the record belongs to.
+\param  entryType_p             Entry type.
+\param  errorCode_p             Error code.
+\param  pNetTime_p              Network time stamp.
+\param  pAddInfo_p              Additional information (8 bytes), may be NULL.
+*/
+//------------------------------------------------------------------------------
+static void addRecord(UINT nodeId_p, UINT16 entryType_p, UINT16 errorCode_p,
+                      const tNetTime* pNetTime_p, const UINT8* pAddInfo_p)
+{
+    UINT32              sequence = errHistInstance_l.lastSequence + 1;
+    tErrHistSlot*       pSlot = &errHistInstance_l.aSlot[(sequence - 1) & ERRHIST_ENTRY_MASK];
+    tErrHistCodeIndex*  pIndex;
+    UINT                nodeId = nodeId_p & (ERRHIST_NODE_COUNT - 1);
+
+    pIndex = findCodeIndex(errorCode_p, TRUE);
+
+    // invalidate the slot while it is written
+    pSlot->sequence = 0;
+    system_memoryBarrier();
+
+    pSlot->prevNodeSequence = errHistInstance_l.aNodeHead[nodeId];
+    pSlot->prevCodeSequence = (pIndex != NULL) ? pIndex->headSequence : 0;
+    pSlot->record.sequence = sequence;
+    pSlot->record.time = system_getTimeNs();
+    pSlot->record.netTime = *pNetTime_p;
+    pSlot->record.nodeId = (UINT8)nodeId;
+    pSlot->record.entryType = entryType_p;
+    pSlot->record.errorCode = errorCode_p;
+    if (pAddInfo_p != NULL)
+        memcpy(pSlot->record.aAddInfo, pAddInfo_p, sizeof(pSlot->record.aAddInfo));
+    else
+        memset(pSlot->record.aAddInfo, 0, sizeof(pSlot->record.aAddInfo));
+
+    system_memoryBarrier();
+    pSlot->sequence = sequence;
+
+    // publish the record
+    errHistInstance_l.aNodeHead[nodeId] = sequence;
+    errHistInstance_l.aNodeCount[nodeId]++;
+    if (pIndex != NULL)
+    {
+        pIndex->headSequence = sequence;
+        pIndex->count++;
+    }
+    else
+    {
+        errHistInstance_l.unindexedCount++;
+    }
+    system_memoryBarrier();
+    errHistInstance_l.lastSequence = sequence;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find error code index entry
+
+The function searches the error code index (open addressing with linear
+probing) for the given error code.
+
+\param  errorCode_p             Error code.
+\param  fCreate_p               Create the entry if it does not exist.
+
+\return The function returns a pointer to the index entry or NULL if the code
+        is not indexed.
+*/
+//------------------------------------------------------------------------------
+static tErrHistCodeIndex* findCodeIndex(UINT16 errorCode_p, BOOL fCreate_p)
+{
+    tErrHistCodeIndex*  pIndex;
+    UINT32              key = (UINT32)errorCode_p + 1;
+    UINT                hash = ((UINT)errorCode_p * 40503U) >> 8;
+    UINT                i;
+
+    for (i = 0; i < ERRHIST_CODE_TABLE_SIZE; i++)
+    {
+        pIndex = &errHistInstance_l.aCodeIndex[(hash + i) & ERRHIST_CODE_MASK];
+        if (pIndex->key == key)
+            return pIndex;
+
+        if (pIndex->key == 0)
+        {
+            if (!fCreate_p)
+                return NULL;
+
+            pIndex->count = 0;
+            pIndex->headSequence = 0;
+            system_memoryBarrier();
+            pIndex->key = key;
+            return pIndex;
+        }
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a record
+
+The function reads the record with the given sequence number from the ring.
+
+\param  sequence_p              Sequence number of the record.
+\param  pRecord_p               Pointer to store the record.
+\param  pPrevNodeSequence_p     Pointer to store the previous record of the
+                                node, may be NULL.
+\param  pPrevCodeSequence_p     Pointer to store the previous record of the
+                                error code, may be NULL.
+
+\return The function returns TRUE if the record was read or FALSE if it has
+        been overwritten.
+*/
+//------------------------------------------------------------------------------
+static BOOL readRecord(UINT32 sequence_p, tErrHistRecord* pRecord_p,
+                       UINT32* pPrevNodeSequence_p, UINT32* pPrevCodeSequence_p)
+{
+    tErrHistSlot*   pSlot;
+    UINT32          prevNode;
+    UINT32          prevCode;
+
+    if (sequence_p == 0)
+        return FALSE;
+
+    pSlot = &errHistInstance_l.aSlot[(sequence_p - 1) & ERRHIST_ENTRY_MASK];
+    if (pSlot->sequence != sequence_p)
+        return FALSE;
+
+    system_memoryBarrier();
+    *pRecord_p = pSlot->record;
+    prevNode = pSlot->prevNodeSequence;
+    prevCode = pSlot->prevCodeSequence;
+    system_memoryBarrier();
+
+    if (pSlot->sequence != sequence_p)
+        return FALSE;
+
+    if (pPrevNodeSequence_p != NULL)
+        *pPrevNodeSequence_p = prevNode;
+    if (pPrevCodeSequence_p != NULL)
+        *pPrevCodeSequence_p = prevCode;
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Query a record chain
+
+The function follows a node or error code chain from the most recent record
+backwards and collects the records in the given time range.
+
+\param  headSequence_p          Most recent record of the chain.
+\param  fNodeChain_p            TRUE to follow the node chain, FALSE to follow
+                                the error code chain.
+\param  startTime_p             Start of the time range [ns].
+\param  endTime_p               End of the time range [ns].
+\param  pRecords_p              Array to store the records.
+\param  maxRecords_p            Size of the record array.
+
+\return The function returns the number of records stored.
+*/
+//------------------------------------------------------------------------------
+static UINT queryChain(UINT32 headSequence_p, BOOL fNodeChain_p,
+                       UINT64 startTime_p, UINT64 endTime_p,
+                       tErrHistRecord* pRecords_p, UINT maxRecords_p)
+{
+    UINT32          sequence = headSequence_p;
+    UINT32          prevNode;
+    UINT32          prevCode;
+    UINT            count = 0;
+    UINT            i;
+    tErrHistRecord  record;
+
+    while ((sequence != 0) && (count < maxRecords_p))
+    {
+        if (!readRecord(sequence, &record, &prevNode, &prevCode))
+            break;
+
+        if (record.time < startTime_p)
+            break;
+
+        if (record.time <= endTime_p)
+            pRecords_p[count++] = record;
+
+        sequence = fNodeChain_p ? prevNode : prevCode;
+    }
+
+    // return the records in chronological order
+    for (i = 0; i < (count / 2); i++)
+    {
+        record = pRecords_p[i];
+        pRecords_p[i] = pRecords_p[count - 1 - i];
+        pRecords_p[count - 1 - i] = record;
+    }
+
+    return count;
+}
+
+/// \}
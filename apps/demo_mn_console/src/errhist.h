@@ -0,0 +1,100 @@
+/**
+********************************************************************************
+\file   errhist.h
+
+\brief  Definitions for the error history store
+
+The file contains the definitions for the error history store of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_errhist_H_
+#define _INC_errhist_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ERRHIST_ENTRY_COUNT         1024    ///< Size of the history ring (power of 2)
+#define ERRHIST_CODE_TABLE_SIZE     256     ///< Number of distinct error codes indexed (power of 2)
+#define ERRHIST_NODE_LOCAL          0       ///< Node ID used for entries of the MN itself
+#define ERRHIST_TYPE_NODE_ERROR     0xFFFF  ///< Entry type used for node error events
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Error history record
+
+The structure describes a single record returned by the history queries.
+*/
+typedef struct
+{
+    UINT32          sequence;               ///< Sequence number of the record (starts with 1)
+    UINT64          time;                   ///< Local time of the record [ns]
+    tNetTime        netTime;                ///< Network time stamp of the history entry
+    UINT8           nodeId;                 ///< Node ID the record belongs to
+    UINT16          entryType;              ///< Entry type of the history entry
+    UINT16          errorCode;              ///< Error code
+    UINT8           aAddInfo[8];            ///< Additional information of the history entry
+} tErrHistRecord;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void   errhist_init(void);
+void   errhist_addEntry(UINT nodeId_p, const tErrHistoryEntry* pEntry_p);
+void   errhist_addNodeError(UINT nodeId_p, UINT16 errorCode_p);
+UINT32 errhist_getTotalCount(void);
+UINT32 errhist_getNodeCount(UINT nodeId_p);
+UINT32 errhist_getCodeCount(UINT16 errorCode_p);
+UINT   errhist_queryByTime(UINT64 startTime_p, UINT64 endTime_p,
+                           tErrHistRecord* pRecords_p, UINT maxRecords_p);
+UINT   errhist_queryByNode(UINT nodeId_p, UINT64 startTime_p, UINT64 endTime_p,
+                           tErrHistRecord* pRecords_p, UINT maxRecords_p);
+UINT   errhist_queryByCode(UINT16 errorCode_p, UINT64 startTime_p, UINT64 endTime_p,
+                           tErrHistRecord* pRecords_p, UINT maxRecords_p);
+void   errhist_printSummary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_errhist_H_ */
@@ -45,6 +45,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/debugstr.h>
 #include <console/console.h>
 #include "event.h"
+#include "standby.h"
+#include "reinteg.h"
+#include "errhist.h"
+#include "startup.h"
+#include "mplx.h"
+#include "cyctune.h"
+#include "threadstat.h"
+#include "nmtgroup.h"
+#include "objscan.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -163,6 +172,8 @@ tOplkError processEvents(tOplkApiEventType EventType_p,
 
     UNUSED_PARAMETER(pUserArg_p);
 
+    threadstat_enter(kThreadStatRoleEvent);
+
     // check if NMT_GS_OFF is reached
     switch (EventType_p)
     {
@@ -195,13 +206,22 @@ tOplkError processEvents(tOplkApiEventType EventType_p,
         case kOplkApiEventCfmResult:
             ret = processCfmResultEvent(EventType_p, pEventArg_p, pUserArg_p);
             break;
-#else
-        // Configuration Manager is not available,
-        // so process SDO events
+#endif
+
         case kOplkApiEventSdo:
+            // transfers of the object scan carry their channel as user argument
+            if (objscan_processSdoEvent(&pEventArg_p->sdoInfo))
+                break;
+#ifndef CONFIG_INCLUDE_CFM
+            // Configuration Manager is not available,
+            // so process SDO events
             ret = processSdoEvent(EventType_p, pEventArg_p, pUserArg_p);
-            break;
 #endif
+            break;
+
+        case kOplkApiEventUserDef:
+            objscan_processUserEvent(pEventArg_p->pUserArg);
+            break;
 
         default:
             break;
@@ -240,10 +260,13 @@ static tOplkError processStateChangeEvent(tOplkApiEventType EventType_p,
 
     if (pfGsOff_l == NULL)
     {
-        console_printlog("Application event module is not initialized!\n");
+        CONSOLE_LOG_ERROR(kConsoleModEvent, "Application event module is not initialized!\n");
         return kErrorGeneralError;
     }
 
+    cyctune_processNmtState(pNmtStateChange->newNmtState);
+    standby_processNmtState(pNmtStateChange->newNmtState);
+
     switch (pNmtStateChange->newNmtState)
     {
         case kNmtGsOff:
@@ -252,7 +275,7 @@ static tOplkError processStateChangeEvent(tOplkApiEventType EventType_p,
             // -> also shut down oplk_process() and main()
             ret = kErrorShutdown;
 
-            console_printlog("StateChangeEvent:kNmtGsOff originating event = 0x%X (%s)\n",
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent:kNmtGsOff originating event = 0x%X (%s)\n",
                              pNmtStateChange->nmtEvent,
                              debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
 
@@ -264,14 +287,31 @@ static tOplkError processStateChangeEvent(tOplkApiEventType EventType_p,
 #ifndef CONFIG_INCLUDE_CFM
             ret = setDefaultNodeAssignment();
 #endif
-            console_printlog("StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
                              pNmtStateChange->newNmtState,
                              pNmtStateChange->nmtEvent,
                              debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
             break;
 
         case kNmtGsResetConfiguration:
-            console_printlog("StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
+                             pNmtStateChange->newNmtState,
+                             pNmtStateChange->nmtEvent,
+                             debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
+            break;
+
+        case kNmtMsOperational:
+            startup_signalOperational();
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
+                             pNmtStateChange->newNmtState,
+                             pNmtStateChange->nmtEvent,
+                             debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
+            break;
+
+        case kNmtMsPreOperational2:
+            // the isochronous phase starts, the multiplexed slots follow the SoC time
+            mplx_restart();
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
                              pNmtStateChange->newNmtState,
                              pNmtStateChange->nmtEvent,
                              debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
@@ -281,13 +321,11 @@ static tOplkError processStateChangeEvent(tOplkApiEventType EventType_p,
         case kNmtGsResetApplication:        // Implement
         case kNmtMsNotActive:               // handling of
         case kNmtMsPreOperational1:         // different
-        case kNmtMsPreOperational2:         // states here
-        case kNmtMsReadyToOperate:
-        case kNmtMsOperational:
+        case kNmtMsReadyToOperate:          // states here
         case kNmtMsBasicEthernet:           // no break
 
         default:
-            console_printlog("StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
+            CONSOLE_LOG_INFO(kConsoleModEvent, "StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
                              pNmtStateChange->newNmtState,
                              pNmtStateChange->nmtEvent,
                              debugstr_getNmtEventStr(pNmtStateChange->nmtEvent));
@@ -318,15 +356,22 @@ static tOplkError processErrorWarningEvent(tOplkApiEventType EventType_p,
     // on error the API layer stops the NMT state machine
 
     tEventError*            pInternalError = &pEventArg_p->internalError;
+    int                     level;
 
-    UNUSED_PARAMETER(EventType_p);
     UNUSED_PARAMETER(pUserArg_p);
 
-    console_printlog("Err/Warn: Source = %s (%02X) OplkError = %s (0x%03X)\n",
-                     debugstr_getEventSourceStr(pInternalError->eventSource),
-                     pInternalError->eventSource,
-                     debugstr_getRetValStr(pInternalError->oplkError),
-                     pInternalError->oplkError);
+    level = (EventType_p == kOplkApiEventCriticalError) ? CONSOLE_LEVEL_ERROR : CONSOLE_LEVEL_WARNING;
+
+    // errors are rate-limited per source and error code, a failing cycle
+    // would otherwise flood the console
+    if (!CONSOLE_LOG_ENABLED(kConsoleModEvent, level) ||
+        !CONSOLE_PRINTLOG_LIMITED(pInternalError->eventSource, pInternalError->oplkError,
+                                  "Err/Warn: Source = %s (%02X) OplkError = %s (0x%03X)\n",
+                                  debugstr_getEventSourceStr(pInternalError->eventSource),
+                                  pInternalError->eventSource,
+                                  debugstr_getRetValStr(pInternalError->oplkError),
+                                  pInternalError->oplkError))
+        return kErrorOk;
 
     // check additional argument
     switch (pInternalError->eventSource)
@@ -375,12 +420,16 @@ static tOplkError processHistoryEvent(tOplkApiEventType EventType_p,
     UNUSED_PARAMETER(EventType_p);
     UNUSED_PARAMETER(pUserArg_p);
 
-    console_printlog("HistoryEntry: Type=0x%04X Code=0x%04X (0x%02X %02X %02X %02X %02X %02X %02X %02X)\n",
-             pHistoryEntry->entryType, pHistoryEntry->errorCode,
-            (WORD)pHistoryEntry->aAddInfo[0], (WORD)pHistoryEntry->aAddInfo[1],
-            (WORD)pHistoryEntry->aAddInfo[2], (WORD)pHistoryEntry->aAddInfo[3],
-            (WORD)pHistoryEntry->aAddInfo[4], (WORD)pHistoryEntry->aAddInfo[5],
-            (WORD)pHistoryEntry->aAddInfo[6], (WORD)pHistoryEntry->aAddInfo[7]);
+    if (CONSOLE_LOG_ENABLED(kConsoleModEvent, CONSOLE_LEVEL_WARNING))
+        CONSOLE_PRINTLOG_LIMITED(ERRHIST_NODE_LOCAL, pHistoryEntry->errorCode,
+                 "HistoryEntry: Type=0x%04X Code=0x%04X (0x%02X %02X %02X %02X %02X %02X %02X %02X)\n",
+                 pHistoryEntry->entryType, pHistoryEntry->errorCode,
+                (WORD)pHistoryEntry->aAddInfo[0], (WORD)pHistoryEntry->aAddInfo[1],
+                (WORD)pHistoryEntry->aAddInfo[2], (WORD)pHistoryEntry->aAddInfo[3],
+                (WORD)pHistoryEntry->aAddInfo[4], (WORD)pHistoryEntry->aAddInfo[5],
+                (WORD)pHistoryEntry->aAddInfo[6], (WORD)pHistoryEntry->aAddInfo[7]);
+
+    errhist_addEntry(ERRHIST_NODE_LOCAL, pHistoryEntry);
 
     return kErrorOk;
 }
@@ -411,38 +460,50 @@ static tOplkError processNodeEvent(tOplkApiEventType EventType_p,
     switch (pNode->nodeEvent)
     {
         case kNmtNodeEventCheckConf:
-            console_printlog("NodeEvent: (Node=%u, CheckConf)\n", pNode->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModEvent, "NodeEvent: (Node=%u, CheckConf)\n", pNode->nodeId);
             break;
 
         case kNmtNodeEventUpdateConf:
-            console_printlog("NodeEvent: (Node=%u, UpdateConf)\n", pNode->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModEvent, "NodeEvent: (Node=%u, UpdateConf)\n", pNode->nodeId);
             break;
 
         case kNmtNodeEventNmtState:
-            console_printlog("NodeEvent: (Node=%u, NmtState=%s)\n",
-                             pNode->nodeId,
-                             debugstr_getNmtStateStr(pNode->nmtState));
+            if (CONSOLE_LOG_ENABLED(kConsoleModEvent, CONSOLE_LEVEL_INFO))
+                CONSOLE_PRINTLOG_LIMITED(pNode->nodeId, pNode->nmtState,
+                                         "NodeEvent: (Node=%u, NmtState=%s)\n",
+                                         pNode->nodeId,
+                                         debugstr_getNmtStateStr(pNode->nmtState));
+            standby_setNodeState(pNode->nodeId, pNode->nmtState);
             break;
 
         case kNmtNodeEventError:
-            console_printlog("NodeEvent: (Node=%u): Error=%s (0x%.4X)\n",
-                             pNode->nodeId,
-                             debugstr_getEmergErrCodeStr(pNode->errorCode),
-                             pNode->errorCode);
+            if (CONSOLE_LOG_ENABLED(kConsoleModEvent, CONSOLE_LEVEL_WARNING))
+                CONSOLE_PRINTLOG_LIMITED(pNode->nodeId, pNode->errorCode,
+                                         "NodeEvent: (Node=%u): Error=%s (0x%.4X)\n",
+                                         pNode->nodeId,
+                                         debugstr_getEmergErrCodeStr(pNode->errorCode),
+                                         pNode->errorCode);
+            errhist_addNodeError(pNode->nodeId, pNode->errorCode);
             break;
 
         case kNmtNodeEventFound:
-            console_printlog("NodeEvent: (Node=%u, Found)\n", pNode->nodeId);
+            if (CONSOLE_LOG_ENABLED(kConsoleModEvent, CONSOLE_LEVEL_INFO))
+                CONSOLE_PRINTLOG_LIMITED(pNode->nodeId, pNode->nodeEvent,
+                                         "NodeEvent: (Node=%u, Found)\n", pNode->nodeId);
             break;
 
         case kNmtNodeEventAmniReceived:
-            console_printlog("NodeEvent: (Node=%u): Received ActiveManagingNodeIndication)\n", pNode->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModEvent, "NodeEvent: (Node=%u): Received ActiveManagingNodeIndication)\n", pNode->nodeId);
             break;
 
         default:
             break;
     }
-    return kErrorOk;
+
+    nmtgroup_processNodeEvent(pNode);
+    objscan_processNodeEvent(pNode);
+
+    return reinteg_processNodeEvent(pNode);
 }
 
 //------------------------------------------------------------------------------
@@ -471,6 +532,10 @@ static tOplkError processPdoChangeEvent(tOplkApiEventType EventType_p,
     UNUSED_PARAMETER(EventType_p);
     UNUSED_PARAMETER(pUserArg_p);
 
+    // the mapping is only read back if it is printed
+    if (!CONSOLE_LOG_ENABLED(kConsoleModEvent, CONSOLE_LEVEL_DEBUG))
+        return kErrorOk;
+
     console_printlog("PDO change event: (%sPDO = 0x%X to node 0x%X with %d objects %s)\n",
                      (pPdoChange->fTx ? "T" : "R"), pPdoChange->mappParamIndex,
                      pPdoChange->nodeId, pPdoChange->mappObjectCount,
@@ -515,6 +580,9 @@ static tOplkError processCfmProgressEvent(tOplkApiEventType EventType_p,
     UNUSED_PARAMETER(EventType_p);
     UNUSED_PARAMETER(pUserArg_p);
 
+    if (!CONSOLE_LOG_ENABLED(kConsoleModCfm, CONSOLE_LEVEL_DEBUG))
+        return kErrorOk;
+
     console_printlog("CFM Progress: (Node=%u, CFM-Progress: Object 0x%X/%u, ",
                      pCfmProgress->nodeId,
                      pCfmProgress->objectIndex,
@@ -562,24 +630,24 @@ static tOplkError processCfmResultEvent(tOplkApiEventType EventType_p,
     switch (pCfmResult->nodeCommand)
     {
         case kNmtNodeCommandConfOk:
-            console_printlog("CFM Result: (Node=%d, ConfOk)\n", pCfmResult->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModCfm, "CFM Result: (Node=%d, ConfOk)\n", pCfmResult->nodeId);
             break;
 
         case kNmtNodeCommandConfErr:
-            console_printlog("CFM Result: (Node=%d, ConfErr)\n", pCfmResult->nodeId);
+            CONSOLE_LOG_ERROR(kConsoleModCfm, "CFM Result: (Node=%d, ConfErr)\n", pCfmResult->nodeId);
             break;
 
         case kNmtNodeCommandConfReset:
-            console_printlog("CFM Result: (Node=%d, ConfReset)\n", pCfmResult->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModCfm, "CFM Result: (Node=%d, ConfReset)\n", pCfmResult->nodeId);
             break;
 
         case kNmtNodeCommandConfRestored:
-            console_printlog("CFM Result: (Node=%d, ConfRestored)\n", pCfmResult->nodeId);
+            CONSOLE_LOG_INFO(kConsoleModCfm, "CFM Result: (Node=%d, ConfRestored)\n", pCfmResult->nodeId);
             break;
 
         default:
-            console_printlog("CFM Result: (Node=%d, CfmResult=0x%X)\n", pCfmResult->nodeId,
-                             pCfmResult->nodeCommand);
+            CONSOLE_LOG_WARNING(kConsoleModCfm, "CFM Result: (Node=%d, CfmResult=0x%X)\n",
+                                pCfmResult->nodeId, pCfmResult->nodeCommand);
             break;
     }
     return kErrorOk;
@@ -0,0 +1,997 @@
+/**
+********************************************************************************
+\file   hist.c
+
+\brief  Historian of the MN demo application
+
+This file contains the historian of the MN demo application. It records
+channels of the process images as minimum, maximum, mean and last value per
+window, for up to HIST_MAX_WINDOWS window sizes.
+
+The historian is configured by a file:
+
+    dir     history         # directory of the files (default: .)
+    window  1               # window sizes [ms], each a multiple of the previous one
+    window  100
+    window  1000
+    CN1.M01.AI_00h.Temp     # channels (see xap.xml)
+    CN1.M01.AI_01h.Pressure
+
+The synchronous data handler only copies the raw channel values of every
+cycle into a ring buffer. Neighbouring channels of the process image are
+copied in one block. A background thread converts the samples, aggregates
+them into the smallest window with vector instructions and merges every
+closed window into the next larger one. The windows are written to
+time-series files (see histfile.c) and can be read back with the query tool
+histq.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "pidesc.h"
+#include "histfile.h"
+#include "simd.h"
+#include "hist.h"
+#include "threadstat.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define HIST_LINE_LEN           512         // maximum length of a line in the configuration
+#define HIST_REDUCE_INTERVAL    20          // interval of the background reduction [ms]
+#define HIST_ROW_HEADER         8           // size of the time stamp of a row
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Copy span
+
+The structure describes a block of neighbouring channels which is copied from
+a process image into a row of the ring buffer.
+*/
+typedef struct
+{
+    UINT            image;                  ///< Process image
+    UINT            srcOffset;              ///< Offset in the process image [bytes]
+    UINT            dstOffset;              ///< Offset in the row [bytes]
+    UINT            size;                   ///< Size [bytes]
+} tHistSpan;
+
+/**
+\brief  Window accumulator
+
+The structure contains the aggregates of the current window of a window
+size. The arrays are padded to whole vectors. A window holds many thousand
+samples at short cycle times, so the sums are kept in double precision.
+*/
+typedef struct
+{
+    UINT64          windowNs;               ///< Window size [ns]
+    UINT64          window;                 ///< Number of the current window
+    UINT32          count;                  ///< Number of samples in the current window
+    float*          pMin;                   ///< Minimum values, followed by pMax and pLast
+    float*          pMax;                   ///< Maximum values
+    float*          pLast;                  ///< Last values
+    double*         pSum;                   ///< Sums of the values
+    tHistFile       file;                   ///< Files of the window size
+} tHistLevel;
+
+/**
+\brief  Historian
+
+The structure contains the historian.
+*/
+typedef struct
+{
+    char            aDir[256];                          ///< Directory of the files
+    char            (*paName)[HISTFILE_NAME_LEN];       ///< Channel names
+    UINT8*          pType;                              ///< Channel types (tPiDescType)
+    UINT8*          pImage;                             ///< Channel process images
+    UINT*           pSrcOffset;                         ///< Channel offsets in the process images [bytes]
+    UINT*           pRowOffset;                         ///< Channel offsets in a row [bytes]
+    UINT            channelCount;                       ///< Number of channels
+    UINT            paddedCount;                        ///< Number of channels padded to whole vectors
+    tHistSpan*      pSpan;                              ///< Copy spans
+    UINT            spanCount;                          ///< Number of copy spans
+    BYTE*           pRing;                              ///< Ring buffer
+    UINT            rowSize;                            ///< Size of a row of the ring buffer [bytes]
+    volatile UINT   ringRead;                           ///< Next row to reduce, written by the background thread
+    volatile UINT   ringWrite;                          ///< Next free row, written by the synchronous data handler
+    float*          pSample;                            ///< Converted sample
+    tHistFileValue* pRecord;                            ///< Record buffer
+    tHistLevel      aLevel[HIST_MAX_WINDOWS];           ///< Window sizes
+    UINT            levelCount;                         ///< Number of window sizes
+    INT64           wallOffset;                         ///< Wall clock minus monotonic clock [ns]
+    BOOL            fWriteFiles;                        ///< Write the windows to files
+    tSystemThread   thread;                             ///< Background thread
+    BOOL            fThreadRunning;                     ///< Background thread is running
+    volatile BOOL   fStop;                              ///< Stop request for the background thread
+    UINT32          lostCount;                          ///< Samples lost on a full ring buffer
+    UINT32          rowCount;                           ///< Reduced samples
+    UINT32          recordCount;                        ///< Written windows
+    UINT32          writeErrorCount;                    ///< Failed writes
+    UINT64          reduceTimeNs;                       ///< Time spent in the reduction
+} tHistInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tHistInstance    histInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseConfig(const char* pszConfigFile_p);
+static tOplkError addChannel(const char* pszName_p);
+static tOplkError setup(void);
+static void       cleanup(void);
+static void       sampleRow(const BYTE* const* apImage_p, UINT64 timeNs_p);
+static void       reduceThread(void* pArg_p);
+static void       reduceRows(void);
+static void       convertRow(const BYTE* pRow_p, float* pSample_p);
+static void       addSample(UINT64 timeNs_p);
+static void       closeWindow(UINT level_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the historian
+
+The function loads the configuration and starts the background thread. The
+process image description must be loaded before.
+
+\param  pszConfigFile_p         File name of the historian configuration.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError hist_init(const char* pszConfigFile_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    tOplkError      ret;
+    UINT            i;
+
+    memset(pInst, 0, sizeof(tHistInstance));
+    strcpy(pInst->aDir, ".");
+
+    ret = parseConfig(pszConfigFile_p);
+    if (ret == kErrorOk)
+        ret = setup();
+
+    for (i = 0; (ret == kErrorOk) && (i < pInst->levelCount); i++)
+    {
+        ret = histfile_open(&pInst->aLevel[i].file, pInst->aDir,
+                            (UINT32)(pInst->aLevel[i].windowNs / 1000000ULL),
+                            pInst->channelCount, pInst->paName[0]);
+    }
+
+    if (ret != kErrorOk)
+    {
+        cleanup();
+        return ret;
+    }
+
+    pInst->fWriteFiles = TRUE;
+    pInst->wallOffset = (INT64)(system_getWallTimeNs() - system_getTimeNs());
+
+    if (system_createThread(reduceThread, NULL, &pInst->thread) != 0)
+    {
+        fprintf(stderr, "Unable to start the historian thread!\n");
+        cleanup();
+        return kErrorNoResource;
+    }
+    pInst->fThreadRunning = TRUE;
+
+    printf("Recording %u channels (%u copy spans) in %u window sizes to %s\n",
+           pInst->channelCount, pInst->spanCount, pInst->levelCount, pInst->aDir);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down the historian
+
+The function stops the background thread, writes the open windows and closes
+the files. The synchronous data handler must be stopped before.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void hist_exit(void)
+{
+    tHistInstance*  pInst = &histInstance_l;
+
+    if (!pInst->fThreadRunning)
+        return;
+
+    pInst->fStop = TRUE;
+    system_joinThread(&pInst->thread);
+    pInst->fThreadRunning = FALSE;
+    cleanup();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Sample the channels
+
+The function copies the channels of the current cycle into the ring buffer.
+It is called by the synchronous data handler.
+
+\param  pPiOut_p                Pointer to the output process image (data
+                                received from the CNs).
+\param  pPiIn_p                 Pointer to the input process image (data
+                                sent to the CNs).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void hist_sample(const BYTE* pPiOut_p, const BYTE* pPiIn_p)
+{
+    const BYTE*     apImage[kPiDescImageCount];
+
+    if (!histInstance_l.fThreadRunning)
+        return;
+
+    apImage[kPiDescImageOut] = pPiOut_p;
+    apImage[kPiDescImageIn] = pPiIn_p;
+    sampleRow(apImage, system_getTimeNs());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the historian statistics
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void hist_printStatistics(void)
+{
+    const tHistInstance*    pInst = &histInstance_l;
+
+    if (pInst->rowCount == 0)
+        return;
+
+    printf("Historian: %lu samples reduced (%.0f ns each), %lu windows written, %lu samples lost, %lu write errors\n",
+           (ULONG)pInst->rowCount, (double)pInst->reduceTimeNs / pInst->rowCount,
+           (ULONG)pInst->recordCount, (ULONG)pInst->lostCount, (ULONG)pInst->writeErrorCount);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Benchmark the historian
+
+The function measures the sampling time of the synchronous data handler and
+the reduction time per sample for the given number of INTEGER16 channels
+with window sizes of 1 ms, 100 ms and 1 s at a simulated cycle time of
+250 us. No files are written. The configuration of the historian is
+replaced.
+
+\param  channelCount_p          Number of channels.
+\param  cycleCount_p            Number of measured cycles.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void hist_benchmark(UINT channelCount_p, UINT cycleCount_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    BYTE*           pPiOut;
+    const BYTE*     apImage[kPiDescImageCount];
+    char            aName[HISTFILE_NAME_LEN];
+    INT16           value;
+    UINT            cycle;
+    UINT            i;
+    UINT64          start;
+    UINT64          time;
+    UINT64          sampleTime = 0;
+    UINT64          maxSampleTime = 0;
+
+    if ((channelCount_p == 0) || (cycleCount_p == 0))
+        return;
+
+    if (channelCount_p > HISTFILE_MAX_CHANNELS)
+        channelCount_p = HISTFILE_MAX_CHANNELS;
+
+    pPiOut = (BYTE*)calloc(channelCount_p, sizeof(INT16));
+    if (pPiOut == NULL)
+        return;
+
+    memset(pInst, 0, sizeof(tHistInstance));
+    pInst->aLevel[0].windowNs = 1000000ULL;
+    pInst->aLevel[1].windowNs = 100000000ULL;
+    pInst->aLevel[2].windowNs = 1000000000ULL;
+    pInst->levelCount = 3;
+
+    for (i = 0; i < channelCount_p; i++)
+    {
+        sprintf(aName, "bench%u", i);
+        if (addChannel(aName) != kErrorOk)
+            break;
+
+        pInst->pType[i] = kPiDescTypeInteger16;
+        pInst->pImage[i] = kPiDescImageOut;
+        pInst->pSrcOffset[i] = i * sizeof(INT16);
+    }
+
+    if ((i < channelCount_p) || (setup() != kErrorOk))
+    {
+        cleanup();
+        free(pPiOut);
+        return;
+    }
+
+    apImage[kPiDescImageOut] = pPiOut;
+    apImage[kPiDescImageIn] = pPiOut;
+    for (cycle = 0; cycle < cycleCount_p; cycle++)
+    {
+        for (i = 0; i < channelCount_p; i++)
+        {
+            value = (INT16)((cycle * 7 + i * 13) % 2000 - 1000);
+            memcpy(&pPiOut[i * sizeof(INT16)], &value, sizeof(INT16));
+        }
+
+        start = system_getTimeNs();
+        sampleRow(apImage, (UINT64)cycle * 250000ULL);
+        time = system_getTimeNs() - start;
+
+        sampleTime += time;
+        if (time > maxSampleTime)
+            maxSampleTime = time;
+
+        if ((cycle % 1000) == 999)
+            reduceRows();
+    }
+    reduceRows();
+
+    printf("Historian: %u channels in %u copy spans, %s reduction\n",
+           channelCount_p, pInst->spanCount, SIMD_NAME);
+    printf("  Sampling: avg %lu ns, max %lu ns per cycle\n",
+           (ULONG)(sampleTime / cycleCount_p), (ULONG)maxSampleTime);
+    printf("  Reduction: %.0f ns per cycle, %lu windows closed\n",
+           (double)pInst->reduceTimeNs / pInst->rowCount, (ULONG)pInst->recordCount);
+
+    cleanup();
+    free(pPiOut);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse the historian configuration
+
+\param  pszConfigFile_p         File name of the historian configuration.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseConfig(const char* pszConfigFile_p)
+{
+    tHistInstance*          pInst = &histInstance_l;
+    FILE*                   pFile;
+    char                    aLine[HIST_LINE_LEN];
+    char*                   apToken[2];
+    char*                   pComment;
+    char*                   pEnd;
+    UINT                    tokenCount;
+    UINT                    lineNo = 0;
+    ULONG                   windowMs;
+    const tPiDescChannel*   pChannel;
+    tPiDescImage            image;
+    tOplkError              ret = kErrorOk;
+    UINT                    i;
+
+    pFile = fopen(pszConfigFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open historian configuration %s!\n", pszConfigFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        pComment = strchr(aLine, '#');
+        if (pComment != NULL)
+            *pComment = '\0';
+
+        tokenCount = 0;
+        apToken[0] = strtok(aLine, " \t\r\n");
+        if (apToken[0] == NULL)
+            continue;
+        apToken[1] = strtok(NULL, " \t\r\n");
+        if (apToken[1] != NULL)
+            tokenCount = (strtok(NULL, " \t\r\n") == NULL) ? 2 : 3;
+        else
+            tokenCount = 1;
+
+        if ((tokenCount == 2) && (strcmp(apToken[0], "dir") == 0) &&
+            (strlen(apToken[1]) < sizeof(pInst->aDir)))
+        {
+            strcpy(pInst->aDir, apToken[1]);
+        }
+        else if ((tokenCount == 2) && (strcmp(apToken[0], "window") == 0) &&
+                 (pInst->levelCount < HIST_MAX_WINDOWS))
+        {
+            windowMs = strtoul(apToken[1], &pEnd, 0);
+            i = pInst->levelCount;
+
+            // every window must consist of whole windows of the previous size
+            if ((*pEnd != '\0') || (windowMs == 0) ||
+                ((i > 0) && ((windowMs * 1000000ULL <= pInst->aLevel[i - 1].windowNs) ||
+                             (((windowMs * 1000000ULL) % pInst->aLevel[i - 1].windowNs) != 0))))
+                ret = kErrorApiInvalidParam;
+
+            pInst->aLevel[i].windowNs = windowMs * 1000000ULL;
+            pInst->levelCount++;
+        }
+        else if (tokenCount == 1)
+        {
+            pChannel = pidesc_findChannel(apToken[0], &image);
+            if ((pChannel == NULL) || (pChannel->type == kPiDescTypeUnknown) ||
+                ((pChannel->offset % 8) != 0))
+            {
+                fprintf(stderr, "Channel %s not found or not supported!\n", apToken[0]);
+                ret = kErrorApiInvalidParam;
+            }
+            else if ((ret = addChannel(apToken[0])) == kErrorOk)
+            {
+                i = pInst->channelCount - 1;
+                pInst->pType[i] = (UINT8)pChannel->type;
+                pInst->pImage[i] = (UINT8)image;
+                pInst->pSrcOffset[i] = pChannel->offset / 8;
+            }
+        }
+        else
+            ret = kErrorApiInvalidParam;
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid historian configuration in line %u of %s!\n", lineNo, pszConfigFile_p);
+        return ret;
+    }
+
+    if ((pInst->levelCount == 0) || (pInst->channelCount == 0))
+    {
+        fprintf(stderr, "No windows or channels in historian configuration %s!\n", pszConfigFile_p);
+        return kErrorApiInvalidParam;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a channel
+
+The function adds a channel and grows the channel arrays. The type and the
+offset of the channel must be set by the caller.
+
+\param  pszName_p               Name of the channel.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError addChannel(const char* pszName_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    UINT            count = pInst->channelCount;
+
+    if ((count >= HISTFILE_MAX_CHANNELS) || (strlen(pszName_p) >= HISTFILE_NAME_LEN))
+        return kErrorApiInvalidParam;
+
+    // the arrays grow in steps of 64 channels
+    if ((count % 64) == 0)
+    {
+        void*   apNew[5];
+        UINT    i;
+
+        apNew[0] = realloc(pInst->paName, (count + 64) * HISTFILE_NAME_LEN);
+        if (apNew[0] != NULL)
+            pInst->paName = (char(*)[HISTFILE_NAME_LEN])apNew[0];
+        apNew[1] = realloc(pInst->pType, (count + 64) * sizeof(UINT8));
+        if (apNew[1] != NULL)
+            pInst->pType = (UINT8*)apNew[1];
+        apNew[2] = realloc(pInst->pImage, (count + 64) * sizeof(UINT8));
+        if (apNew[2] != NULL)
+            pInst->pImage = (UINT8*)apNew[2];
+        apNew[3] = realloc(pInst->pSrcOffset, (count + 64) * sizeof(UINT));
+        if (apNew[3] != NULL)
+            pInst->pSrcOffset = (UINT*)apNew[3];
+        apNew[4] = realloc(pInst->pRowOffset, (count + 64) * sizeof(UINT));
+        if (apNew[4] != NULL)
+            pInst->pRowOffset = (UINT*)apNew[4];
+
+        for (i = 0; i < 5; i++)
+        {
+            if (apNew[i] == NULL)
+                return kErrorNoResource;
+        }
+    }
+
+    // names are padded with zeros, so they can be compared as blocks
+    memset(pInst->paName[count], 0, HISTFILE_NAME_LEN);
+    strcpy(pInst->paName[count], pszName_p);
+    pInst->channelCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up the buffers of the historian
+
+The function builds the copy spans and allocates the ring buffer and the
+window accumulators.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setup(void)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    tHistSpan*      pSpan = NULL;
+    UINT            rowOffset = 0;
+    UINT            size;
+    UINT            i;
+    UINT            l;
+
+    pInst->pSpan = (tHistSpan*)calloc(pInst->channelCount, sizeof(tHistSpan));
+    if (pInst->pSpan == NULL)
+        return kErrorNoResource;
+
+    // channels which follow each other in the process image share a span
+    for (i = 0; i < pInst->channelCount; i++)
+    {
+        size = (pInst->pType[i] <= kPiDescTypeUnsigned8) ? 1 :
+               (pInst->pType[i] <= kPiDescTypeUnsigned16) ? 2 :
+               (pInst->pType[i] <= kPiDescTypeReal32) ? 4 : 8;
+
+        if ((pSpan == NULL) || (pSpan->image != pInst->pImage[i]) ||
+            (pSpan->srcOffset + pSpan->size != pInst->pSrcOffset[i]))
+        {
+            pSpan = &pInst->pSpan[pInst->spanCount++];
+            pSpan->image = pInst->pImage[i];
+            pSpan->srcOffset = pInst->pSrcOffset[i];
+            pSpan->dstOffset = rowOffset;
+            pSpan->size = 0;
+        }
+
+        pInst->pRowOffset[i] = rowOffset;
+        pSpan->size += size;
+        rowOffset += size;
+    }
+
+    pInst->rowSize = (HIST_ROW_HEADER + rowOffset + 7) & ~7U;
+    pInst->pRing = (BYTE*)malloc((size_t)pInst->rowSize * HIST_RING_ROWS);
+
+    pInst->paddedCount = (pInst->channelCount + SIMD_WIDTH - 1) & ~(UINT)(SIMD_WIDTH - 1);
+    pInst->pSample = (float*)calloc(pInst->paddedCount, sizeof(float));
+    pInst->pRecord = (tHistFileValue*)calloc(pInst->channelCount, sizeof(tHistFileValue));
+    if ((pInst->pRing == NULL) || (pInst->pSample == NULL) || (pInst->pRecord == NULL))
+        return kErrorNoResource;
+
+    // touch the ring buffer, so the synchronous data handler causes no page faults
+    memset(pInst->pRing, 0, (size_t)pInst->rowSize * HIST_RING_ROWS);
+
+    for (l = 0; l < pInst->levelCount; l++)
+    {
+        pInst->aLevel[l].pMin = (float*)calloc(pInst->paddedCount * 3, sizeof(float));
+        pInst->aLevel[l].pSum = (double*)calloc(pInst->paddedCount, sizeof(double));
+        if ((pInst->aLevel[l].pMin == NULL) || (pInst->aLevel[l].pSum == NULL))
+            return kErrorNoResource;
+
+        pInst->aLevel[l].pMax = pInst->aLevel[l].pMin + pInst->paddedCount;
+        pInst->aLevel[l].pLast = pInst->aLevel[l].pMax + pInst->paddedCount;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free the buffers of the historian
+
+The function closes the files and frees all buffers.
+*/
+//------------------------------------------------------------------------------
+static void cleanup(void)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    UINT            l;
+
+    for (l = 0; l < pInst->levelCount; l++)
+    {
+        histfile_close(&pInst->aLevel[l].file);
+        free(pInst->aLevel[l].pMin);
+        pInst->aLevel[l].pMin = NULL;
+        free(pInst->aLevel[l].pSum);
+        pInst->aLevel[l].pSum = NULL;
+    }
+
+    free(pInst->paName);
+    free(pInst->pType);
+    free(pInst->pImage);
+    free(pInst->pSrcOffset);
+    free(pInst->pRowOffset);
+    free(pInst->pSpan);
+    free(pInst->pRing);
+    free(pInst->pSample);
+    free(pInst->pRecord);
+    pInst->paName = NULL;
+    pInst->pType = NULL;
+    pInst->pImage = NULL;
+    pInst->pSrcOffset = NULL;
+    pInst->pRowOffset = NULL;
+    pInst->pSpan = NULL;
+    pInst->pRing = NULL;
+    pInst->pSample = NULL;
+    pInst->pRecord = NULL;
+    pInst->channelCount = 0;
+    pInst->levelCount = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the channels into the ring buffer
+
+\param  apImage_p               Pointers to the process images.
+\param  timeNs_p                Time stamp of the sample [ns].
+*/
+//------------------------------------------------------------------------------
+static void sampleRow(const BYTE* const* apImage_p, UINT64 timeNs_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    UINT            writeIndex = pInst->ringWrite;
+    BYTE*           pRow;
+    const tHistSpan* pSpan;
+    UINT            i;
+
+    if ((writeIndex - pInst->ringRead) >= HIST_RING_ROWS)
+    {
+        pInst->lostCount++;
+        return;
+    }
+
+    pRow = pInst->pRing + (size_t)(writeIndex & (HIST_RING_ROWS - 1)) * pInst->rowSize;
+    memcpy(pRow, &timeNs_p, sizeof(UINT64));
+
+    for (i = 0, pSpan = pInst->pSpan; i < pInst->spanCount; i++, pSpan++)
+        memcpy(pRow + HIST_ROW_HEADER + pSpan->dstOffset, apImage_p[pSpan->image] + pSpan->srcOffset, pSpan->size);
+
+    system_memoryBarrier();
+    pInst->ringWrite = writeIndex + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Background thread of the historian
+
+The thread reduces the buffered samples periodically. When it is stopped, it
+reduces the remaining samples and writes the open windows.
+
+\param  pArg_p                  Thread argument, unused.
+*/
+//------------------------------------------------------------------------------
+static void reduceThread(void* pArg_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    UINT            l;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    while (!pInst->fStop)
+    {
+        threadstat_enter(kThreadStatRoleHistorian);
+        reduceRows();
+        system_msleep(HIST_REDUCE_INTERVAL);
+    }
+
+    reduceRows();
+    for (l = 0; l < pInst->levelCount; l++)
+    {
+        if (pInst->aLevel[l].count != 0)
+            closeWindow(l);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reduce the buffered samples
+*/
+//------------------------------------------------------------------------------
+static void reduceRows(void)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    UINT            readIndex = pInst->ringRead;
+    const BYTE*     pRow;
+    UINT64          timeNs;
+    UINT64          start;
+
+    if (readIndex == pInst->ringWrite)
+        return;
+
+    start = system_getTimeNs();
+    system_memoryBarrier();
+
+    while (readIndex != pInst->ringWrite)
+    {
+        pRow = pInst->pRing + (size_t)(readIndex & (HIST_RING_ROWS - 1)) * pInst->rowSize;
+        memcpy(&timeNs, pRow, sizeof(UINT64));
+        convertRow(pRow, pInst->pSample);
+
+        system_memoryBarrier();
+        pInst->ringRead = ++readIndex;
+
+        addSample(timeNs + pInst->wallOffset);
+        pInst->rowCount++;
+    }
+
+    pInst->reduceTimeNs += system_getTimeNs() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert a row of the ring buffer
+
+\param  pRow_p                  Pointer to the row.
+\param  pSample_p               Pointer to store the channel values.
+*/
+//------------------------------------------------------------------------------
+static void convertRow(const BYTE* pRow_p, float* pSample_p)
+{
+    const tHistInstance*    pInst = &histInstance_l;
+    const BYTE*             pData;
+    UINT64                  raw;
+    float                   real32;
+    double                  real64;
+    UINT                    i;
+
+    for (i = 0; i < pInst->channelCount; i++)
+    {
+        pData = pRow_p + HIST_ROW_HEADER + pInst->pRowOffset[i];
+        raw = 0;
+
+        switch (pInst->pType[i])
+        {
+            case kPiDescTypeInteger8:
+                pSample_p[i] = (float)(INT8)pData[0];
+                break;
+
+            case kPiDescTypeUnsigned8:
+                pSample_p[i] = (float)pData[0];
+                break;
+
+            case kPiDescTypeInteger16:
+                memcpy(&raw, pData, 2);
+                pSample_p[i] = (float)(INT16)raw;
+                break;
+
+            case kPiDescTypeUnsigned16:
+                memcpy(&raw, pData, 2);
+                pSample_p[i] = (float)(UINT16)raw;
+                break;
+
+            case kPiDescTypeInteger32:
+                memcpy(&raw, pData, 4);
+                pSample_p[i] = (float)(INT32)raw;
+                break;
+
+            case kPiDescTypeUnsigned32:
+                memcpy(&raw, pData, 4);
+                pSample_p[i] = (float)(UINT32)raw;
+                break;
+
+            case kPiDescTypeReal32:
+                memcpy(&real32, pData, 4);
+                pSample_p[i] = real32;
+                break;
+
+            case kPiDescTypeInteger64:
+                memcpy(&raw, pData, 8);
+                pSample_p[i] = (float)(INT64)raw;
+                break;
+
+            case kPiDescTypeUnsigned64:
+                memcpy(&raw, pData, 8);
+                pSample_p[i] = (float)raw;
+                break;
+
+            case kPiDescTypeReal64:
+                memcpy(&real64, pData, 8);
+                pSample_p[i] = (float)real64;
+                break;
+
+            default:
+                pSample_p[i] = 0.0f;
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a sample to the windows
+
+The function closes the windows the sample does not belong to and adds the
+sample to the smallest window. Every larger window consists of whole windows
+of the next smaller size, so a larger window can only change if the smaller
+one changes.
+
+\param  timeNs_p                Time stamp of the sample [ns since 1970-01-01 UTC].
+*/
+//------------------------------------------------------------------------------
+static void addSample(UINT64 timeNs_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    tHistLevel*     pLevel = &pInst->aLevel[0];
+    const float*    pSample = pInst->pSample;
+    UINT64          window;
+    tSimdVec        value;
+    UINT            l;
+    UINT            i;
+
+    for (l = 0; l < pInst->levelCount; l++)
+    {
+        window = timeNs_p / pInst->aLevel[l].windowNs;
+        if (window == pInst->aLevel[l].window)
+            break;
+
+        if (pInst->aLevel[l].count != 0)
+            closeWindow(l);
+        pInst->aLevel[l].window = window;
+    }
+
+    if (pLevel->count == 0)
+    {
+        memcpy(pLevel->pMin, pSample, pInst->paddedCount * sizeof(float));
+        memcpy(pLevel->pMax, pSample, pInst->paddedCount * sizeof(float));
+        for (i = 0; i < pInst->paddedCount; i++)
+            pLevel->pSum[i] = pSample[i];
+    }
+    else
+    {
+        for (i = 0; i < pInst->paddedCount; i += SIMD_WIDTH)
+        {
+            value = SIMD_LOAD(&pSample[i]);
+            SIMD_STORE(&pLevel->pMin[i], SIMD_MIN(SIMD_LOAD(&pLevel->pMin[i]), value));
+            SIMD_STORE(&pLevel->pMax[i], SIMD_MAX(SIMD_LOAD(&pLevel->pMax[i]), value));
+        }
+
+        for (i = 0; i < pInst->paddedCount; i++)
+            pLevel->pSum[i] += pSample[i];
+    }
+    memcpy(pLevel->pLast, pSample, pInst->paddedCount * sizeof(float));
+    pLevel->count++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close the current window of a window size
+
+The function writes the window and merges it into the current window of the
+next larger size.
+
+\param  level_p                 Index of the window size.
+*/
+//------------------------------------------------------------------------------
+static void closeWindow(UINT level_p)
+{
+    tHistInstance*  pInst = &histInstance_l;
+    tHistLevel*     pLevel = &pInst->aLevel[level_p];
+    tHistLevel*     pNext;
+    double          scale = 1.0 / (double)pLevel->count;
+    UINT            i;
+
+    if (pInst->fWriteFiles)
+    {
+        for (i = 0; i < pInst->channelCount; i++)
+        {
+            pInst->pRecord[i].min = pLevel->pMin[i];
+            pInst->pRecord[i].max = pLevel->pMax[i];
+            pInst->pRecord[i].mean = (float)(pLevel->pSum[i] * scale);
+            pInst->pRecord[i].last = pLevel->pLast[i];
+        }
+
+        if (histfile_write(&pLevel->file, pLevel->window * pLevel->windowNs, pLevel->count,
+                           pInst->pRecord) != kErrorOk)
+            pInst->writeErrorCount++;
+    }
+    pInst->recordCount++;
+
+    if (level_p + 1 < pInst->levelCount)
+    {
+        pNext = &pInst->aLevel[level_p + 1];
+        if (pNext->count == 0)
+        {
+            memcpy(pNext->pMin, pLevel->pMin, pInst->paddedCount * 3 * sizeof(float));
+            memcpy(pNext->pSum, pLevel->pSum, pInst->paddedCount * sizeof(double));
+        }
+        else
+        {
+            for (i = 0; i < pInst->paddedCount; i += SIMD_WIDTH)
+            {
+                SIMD_STORE(&pNext->pMin[i], SIMD_MIN(SIMD_LOAD(&pNext->pMin[i]), SIMD_LOAD(&pLevel->pMin[i])));
+                SIMD_STORE(&pNext->pMax[i], SIMD_MAX(SIMD_LOAD(&pNext->pMax[i]), SIMD_LOAD(&pLevel->pMax[i])));
+            }
+
+            for (i = 0; i < pInst->paddedCount; i++)
+                pNext->pSum[i] += pLevel->pSum[i];
+
+            memcpy(pNext->pLast, pLevel->pLast, pInst->paddedCount * sizeof(float));
+        }
+        pNext->count += pLevel->count;
+    }
+
+    pLevel->count = 0;
+}
+
+/// \}
@@ -0,0 +1,593 @@
+/**
+********************************************************************************
+\file   histfile.c
+
+\brief  Historian files
+
+This file contains the time-series files of the historian of the MN demo
+application. It is shared by the historian and the query tool.
+
+The aggregates of every window size are stored in segment files with a fixed
+number of windows:
+
+    <dir>/hist_<window>ms_<segment>.hst
+
+The windows are aligned to the wall clock, window n starts at n * window
+since 1970-01-01 UTC. Window n is stored in segment n / HISTFILE_SEGMENT_RECORDS
+at slot n % HISTFILE_SEGMENT_RECORDS. All records of a file have the same
+size, so the file and the position of any point in time are calculated
+directly. Windows without data are left empty (time stamp 0).
+
+The index file <dir>/hist_<window>ms.idx contains the first and the last
+recorded segment of a window size.
+
+A file starts with a header followed by the channel names and the records:
+
+    header          magic, version, window, channel count, record size, segment
+    names           channel count * HISTFILE_NAME_LEN bytes
+    record[slot]    UINT64 start time [ns], UINT32 sample count, UINT32 reserved,
+                    channel count * tHistFileValue
+
+All values are stored in host byte order.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "histfile.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define HISTFILE_MAGIC          "OPLKHIST"
+#define HISTFILE_VERSION        1
+#define HISTFILE_RECORD_HEADER  16          // size of the time stamp and the sample count
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  File header
+
+The structure describes the header of a historian file.
+*/
+typedef struct
+{
+    char            aMagic[8];              ///< HISTFILE_MAGIC
+    UINT32          version;                ///< HISTFILE_VERSION
+    UINT32          windowMs;               ///< Window size [ms]
+    UINT32          channelCount;           ///< Number of channels
+    UINT32          recordSize;             ///< Size of a record [bytes]
+    UINT32          segment;                ///< Segment number
+    UINT32          reserved;               ///< Reserved, 0
+} tHistFileHeader;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void       getFileName(char* pszName_p, const char* pszDir_p, UINT32 windowMs_p, UINT32 segment_p);
+static tOplkError openSegment(tHistFile* pFile_p, UINT32 segment_p);
+static void       updateIndex(const tHistFile* pFile_p, UINT32 segment_p);
+static BOOL       readIndex(const char* pszDir_p, UINT32 windowMs_p, UINT32* pFirst_p, UINT32* pLast_p);
+static BOOL       readHeader(FILE* pFile_p, tHistFileHeader* pHeader_p, UINT32 windowMs_p, UINT32 segment_p);
+static long       getRecordPos(UINT channelCount_p, UINT recordSize_p, UINT32 slot_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open the files of a window size
+
+The function prepares writing the aggregates of a window size. The segment
+files are opened when the first record is written.
+
+\param  pFile_p                 Pointer to the file writer.
+\param  pszDir_p                Directory of the files.
+\param  windowMs_p              Window size [ms].
+\param  channelCount_p          Number of channels.
+\param  pNames_p                Channel names, HISTFILE_NAME_LEN bytes each.
+                                The names must stay valid until the writer
+                                is closed.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError histfile_open(tHistFile* pFile_p, const char* pszDir_p, UINT32 windowMs_p,
+                         UINT channelCount_p, const char* pNames_p)
+{
+    memset(pFile_p, 0, sizeof(tHistFile));
+
+    if ((windowMs_p == 0) || (channelCount_p == 0) || (channelCount_p > HISTFILE_MAX_CHANNELS) ||
+        (strlen(pszDir_p) >= sizeof(pFile_p->aDir) - 32))
+        return kErrorApiInvalidParam;
+
+    strcpy(pFile_p->aDir, pszDir_p);
+    pFile_p->windowMs = windowMs_p;
+    pFile_p->channelCount = channelCount_p;
+    pFile_p->pNames = pNames_p;
+    pFile_p->recordSize = HISTFILE_RECORD_HEADER + channelCount_p * sizeof(tHistFileValue);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the aggregates of a window
+
+\param  pFile_p                 Pointer to the file writer.
+\param  timeNs_p                Start of the window [ns since 1970-01-01 UTC],
+                                a multiple of the window size.
+\param  sampleCount_p           Number of samples of the window.
+\param  pValues_p               Aggregates of the channels.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError histfile_write(tHistFile* pFile_p, UINT64 timeNs_p, UINT32 sampleCount_p,
+                          const tHistFileValue* pValues_p)
+{
+    UINT64      window = timeNs_p / ((UINT64)pFile_p->windowMs * 1000000ULL);
+    UINT32      segment = (UINT32)(window / HISTFILE_SEGMENT_RECORDS);
+    UINT32      slot = (UINT32)(window % HISTFILE_SEGMENT_RECORDS);
+    BYTE        aRecordHeader[HISTFILE_RECORD_HEADER];
+    tOplkError  ret;
+
+    if ((pFile_p->pFile == NULL) || (segment != pFile_p->segment))
+    {
+        ret = openSegment(pFile_p, segment);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    // records are written in order, only a gap needs a seek
+    if (slot != pFile_p->nextSlot)
+    {
+        if (fseek(pFile_p->pFile, getRecordPos(pFile_p->channelCount, pFile_p->recordSize, slot),
+                  SEEK_SET) != 0)
+            return kErrorNoResource;
+    }
+
+    memset(aRecordHeader, 0, sizeof(aRecordHeader));
+    memcpy(aRecordHeader, &timeNs_p, sizeof(UINT64));
+    memcpy(aRecordHeader + 8, &sampleCount_p, sizeof(UINT32));
+
+    if ((fwrite(aRecordHeader, sizeof(aRecordHeader), 1, pFile_p->pFile) != 1) ||
+        (fwrite(pValues_p, sizeof(tHistFileValue), pFile_p->channelCount, pFile_p->pFile) !=
+         pFile_p->channelCount))
+    {
+        pFile_p->nextSlot = HISTFILE_SEGMENT_RECORDS;
+        return kErrorNoResource;
+    }
+
+    pFile_p->nextSlot = slot + 1;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close the files of a window size
+
+\param  pFile_p                 Pointer to the file writer.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void histfile_close(tHistFile* pFile_p)
+{
+    if (pFile_p->pFile != NULL)
+    {
+        fclose(pFile_p->pFile);
+        pFile_p->pFile = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Query the aggregates of a channel
+
+The function reads the stored windows of a channel in a time range. The range
+is limited to the recorded segments listed in the index file. Only the
+segment files covering the range are opened and the first record is found
+by its position.
+
+\param  pszDir_p                Directory of the files.
+\param  windowMs_p              Window size [ms].
+\param  pszChannel_p            Name of the channel.
+\param  fromNs_p                Start of the range [ns since 1970-01-01 UTC].
+\param  toNs_p                  End of the range [ns since 1970-01-01 UTC].
+\param  pfnCallback_p           Function called for every stored window.
+\param  pArg_p                  Argument passed to the callback.
+
+\return The function returns a tOplkError error code.
+\retval kErrorApiInvalidParam   The channel is not stored.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError histfile_query(const char* pszDir_p, UINT32 windowMs_p, const char* pszChannel_p,
+                          UINT64 fromNs_p, UINT64 toNs_p, tHistFileQueryCb pfnCallback_p, void* pArg_p)
+{
+    UINT64          windowNs = (UINT64)windowMs_p * 1000000ULL;
+    UINT64          window;
+    UINT64          lastWindow;
+    UINT32          segment = 0;
+    UINT32          firstSegment;
+    UINT32          lastSegment;
+    UINT32          slot;
+    char            aFileName[300];
+    char            aName[HISTFILE_NAME_LEN];
+    FILE*           pFile = NULL;
+    tHistFileHeader header;
+    BYTE            aRecordHeader[HISTFILE_RECORD_HEADER];
+    UINT64          timeNs;
+    UINT32          sampleCount;
+    tHistFileValue  value;
+    int             channel = -1;
+    BOOL            fFound = FALSE;
+    UINT            i;
+
+    if ((windowMs_p == 0) || (fromNs_p > toNs_p))
+        return kErrorApiInvalidParam;
+
+    if (!readIndex(pszDir_p, windowMs_p, &firstSegment, &lastSegment))
+        return kErrorApiInvalidParam;
+
+    window = fromNs_p / windowNs;
+    if (window < (UINT64)firstSegment * HISTFILE_SEGMENT_RECORDS)
+        window = (UINT64)firstSegment * HISTFILE_SEGMENT_RECORDS;
+
+    lastWindow = toNs_p / windowNs;
+    if (lastWindow >= ((UINT64)lastSegment + 1) * HISTFILE_SEGMENT_RECORDS)
+        lastWindow = ((UINT64)lastSegment + 1) * HISTFILE_SEGMENT_RECORDS - 1;
+
+    for (; window <= lastWindow; window++)
+    {
+        slot = (UINT32)(window % HISTFILE_SEGMENT_RECORDS);
+        if ((pFile == NULL) || (slot == 0))
+        {
+            // open the segment of the window and look up the channel
+            if (pFile != NULL)
+                fclose(pFile);
+
+            segment = (UINT32)(window / HISTFILE_SEGMENT_RECORDS);
+            getFileName(aFileName, pszDir_p, windowMs_p, segment);
+            pFile = fopen(aFileName, "rb");
+            channel = -1;
+
+            if ((pFile != NULL) && readHeader(pFile, &header, windowMs_p, segment))
+            {
+                for (i = 0; i < header.channelCount; i++)
+                {
+                    if (fread(aName, sizeof(aName), 1, pFile) != 1)
+                        break;
+
+                    aName[HISTFILE_NAME_LEN - 1] = '\0';
+                    if (strcmp(aName, pszChannel_p) == 0)
+                    {
+                        channel = (int)i;
+                        fFound = TRUE;
+                        break;
+                    }
+                }
+            }
+
+            if (channel < 0)
+            {
+                // skip the segment
+                window = (UINT64)(segment + 1) * HISTFILE_SEGMENT_RECORDS - 1;
+                continue;
+            }
+
+            if (fseek(pFile, getRecordPos(header.channelCount, header.recordSize, slot), SEEK_SET) != 0)
+                break;
+        }
+
+        if (fread(aRecordHeader, sizeof(aRecordHeader), 1, pFile) != 1)
+        {
+            // end of the segment file
+            window = (UINT64)(segment + 1) * HISTFILE_SEGMENT_RECORDS - 1;
+            continue;
+        }
+
+        memcpy(&timeNs, aRecordHeader, sizeof(UINT64));
+        memcpy(&sampleCount, aRecordHeader + 8, sizeof(UINT32));
+
+        if ((fseek(pFile, channel * (long)sizeof(tHistFileValue), SEEK_CUR) != 0) ||
+            (fread(&value, sizeof(value), 1, pFile) != 1) ||
+            (fseek(pFile, (long)(header.recordSize - HISTFILE_RECORD_HEADER) -
+                          (channel + 1) * (long)sizeof(tHistFileValue), SEEK_CUR) != 0))
+        {
+            window = (UINT64)(segment + 1) * HISTFILE_SEGMENT_RECORDS - 1;
+            continue;
+        }
+
+        if ((timeNs / windowNs == window) && (sampleCount != 0))
+            pfnCallback_p(timeNs, sampleCount, &value, pArg_p);
+    }
+
+    if (pFile != NULL)
+        fclose(pFile);
+
+    return fFound ? kErrorOk : kErrorApiInvalidParam;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the name of a segment file
+
+\param  pszName_p               Pointer to store the name (300 bytes).
+\param  pszDir_p                Directory of the files.
+\param  windowMs_p              Window size [ms].
+\param  segment_p               Segment number.
+*/
+//------------------------------------------------------------------------------
+static void getFileName(char* pszName_p, const char* pszDir_p, UINT32 windowMs_p, UINT32 segment_p)
+{
+    sprintf(pszName_p, "%.255s/hist_%lums_%08lu.hst", pszDir_p, (ULONG)windowMs_p, (ULONG)segment_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a segment file for writing
+
+The function opens an existing segment file or creates a new one. An
+existing file must have the same channels.
+
+\param  pFile_p                 Pointer to the file writer.
+\param  segment_p               Segment number.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openSegment(tHistFile* pFile_p, UINT32 segment_p)
+{
+    char            aFileName[300];
+    tHistFileHeader header;
+    char*           pNames;
+    UINT            namesSize = pFile_p->channelCount * HISTFILE_NAME_LEN;
+    BOOL            fValid;
+
+    histfile_close(pFile_p);
+    getFileName(aFileName, pFile_p->aDir, pFile_p->windowMs, segment_p);
+
+    pFile_p->pFile = fopen(aFileName, "r+b");
+    if (pFile_p->pFile != NULL)
+    {
+        // continue an existing segment, e.g. after a restart
+        fValid = readHeader(pFile_p->pFile, &header, pFile_p->windowMs, segment_p) &&
+                 (header.channelCount == pFile_p->channelCount);
+        if (fValid)
+        {
+            pNames = (char*)malloc(namesSize);
+            fValid = (pNames != NULL) && (fread(pNames, namesSize, 1, pFile_p->pFile) == 1) &&
+                     (memcmp(pNames, pFile_p->pNames, namesSize) == 0);
+            free(pNames);
+        }
+
+        if (!fValid)
+        {
+            fprintf(stderr, "History file %s has different channels!\n", aFileName);
+            histfile_close(pFile_p);
+            return kErrorNoResource;
+        }
+    }
+    else
+    {
+        pFile_p->pFile = fopen(aFileName, "w+b");
+        if (pFile_p->pFile == NULL)
+        {
+            fprintf(stderr, "Unable to create history file %s!\n", aFileName);
+            return kErrorNoResource;
+        }
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.aMagic, HISTFILE_MAGIC, sizeof(header.aMagic));
+        header.version = HISTFILE_VERSION;
+        header.windowMs = pFile_p->windowMs;
+        header.channelCount = pFile_p->channelCount;
+        header.recordSize = pFile_p->recordSize;
+        header.segment = segment_p;
+
+        if ((fwrite(&header, sizeof(header), 1, pFile_p->pFile) != 1) ||
+            (fwrite(pFile_p->pNames, namesSize, 1, pFile_p->pFile) != 1))
+        {
+            histfile_close(pFile_p);
+            return kErrorNoResource;
+        }
+    }
+
+    updateIndex(pFile_p, segment_p);
+    pFile_p->segment = segment_p;
+    pFile_p->nextSlot = HISTFILE_SEGMENT_RECORDS;   // force a seek
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the index file of a window size
+
+The index file contains the first and the last recorded segment. It limits
+the segments a query has to look for.
+
+\param  pFile_p                 Pointer to the file writer.
+\param  segment_p               Opened segment number.
+*/
+//------------------------------------------------------------------------------
+static void updateIndex(const tHistFile* pFile_p, UINT32 segment_p)
+{
+    char        aFileName[300];
+    UINT32      aSegment[2];
+    FILE*       pIndex;
+
+    if (readIndex(pFile_p->aDir, pFile_p->windowMs, &aSegment[0], &aSegment[1]))
+    {
+        if ((segment_p >= aSegment[0]) && (segment_p <= aSegment[1]))
+            return;
+
+        if (segment_p < aSegment[0])
+            aSegment[0] = segment_p;
+        else
+            aSegment[1] = segment_p;
+    }
+    else
+    {
+        aSegment[0] = segment_p;
+        aSegment[1] = segment_p;
+    }
+
+    sprintf(aFileName, "%.255s/hist_%lums.idx", pFile_p->aDir, (ULONG)pFile_p->windowMs);
+    pIndex = fopen(aFileName, "wb");
+    if (pIndex == NULL)
+        return;
+
+    fwrite(aSegment, sizeof(aSegment), 1, pIndex);
+    fclose(pIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the index file of a window size
+
+\param  pszDir_p                Directory of the files.
+\param  windowMs_p              Window size [ms].
+\param  pFirst_p                Pointer to store the first recorded segment.
+\param  pLast_p                 Pointer to store the last recorded segment.
+
+\return The function returns TRUE if the index file is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL readIndex(const char* pszDir_p, UINT32 windowMs_p, UINT32* pFirst_p, UINT32* pLast_p)
+{
+    char        aFileName[300];
+    UINT32      aSegment[2];
+    FILE*       pIndex;
+    BOOL        fValid;
+
+    sprintf(aFileName, "%.255s/hist_%lums.idx", pszDir_p, (ULONG)windowMs_p);
+    pIndex = fopen(aFileName, "rb");
+    if (pIndex == NULL)
+        return FALSE;
+
+    fValid = (fread(aSegment, sizeof(aSegment), 1, pIndex) == 1) && (aSegment[0] <= aSegment[1]);
+    fclose(pIndex);
+
+    *pFirst_p = aSegment[0];
+    *pLast_p = aSegment[1];
+    return fValid;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read and check the header of a segment file
+
+\param  pFile_p                 Segment file.
+\param  pHeader_p               Pointer to store the header.
+\param  windowMs_p              Expected window size [ms].
+\param  segment_p               Expected segment number.
+
+\return The function returns TRUE if the header is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL readHeader(FILE* pFile_p, tHistFileHeader* pHeader_p, UINT32 windowMs_p, UINT32 segment_p)
+{
+    if (fread(pHeader_p, sizeof(tHistFileHeader), 1, pFile_p) != 1)
+        return FALSE;
+
+    return (memcmp(pHeader_p->aMagic, HISTFILE_MAGIC, sizeof(pHeader_p->aMagic)) == 0) &&
+           (pHeader_p->version == HISTFILE_VERSION) &&
+           (pHeader_p->windowMs == windowMs_p) &&
+           (pHeader_p->segment == segment_p) &&
+           (pHeader_p->channelCount > 0) &&
+           (pHeader_p->channelCount <= HISTFILE_MAX_CHANNELS) &&
+           (pHeader_p->recordSize == HISTFILE_RECORD_HEADER +
+                                     pHeader_p->channelCount * sizeof(tHistFileValue));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the position of a record
+
+\param  channelCount_p          Number of channels.
+\param  recordSize_p            Size of a record [bytes].
+\param  slot_p                  Slot of the record.
+
+\return The function returns the file position of the record.
+*/
+//------------------------------------------------------------------------------
+static long getRecordPos(UINT channelCount_p, UINT recordSize_p, UINT32 slot_p)
+{
+    return (long)(sizeof(tHistFileHeader) + channelCount_p * HISTFILE_NAME_LEN +
+                  (size_t)slot_p * recordSize_p);
+}
+
+/// \}
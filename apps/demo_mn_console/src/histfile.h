@@ -0,0 +1,118 @@
+/**
+********************************************************************************
+\file   histfile.h
+
+\brief  Definitions for the historian files
+
+The file contains the definitions for the time-series files written by the
+historian of the MN demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_histfile_H_
+#define _INC_histfile_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define HISTFILE_SEGMENT_RECORDS    65536   ///< Number of windows stored in a file
+#define HISTFILE_NAME_LEN           64      ///< Maximum length of a channel name
+#define HISTFILE_MAX_CHANNELS       1024    ///< Maximum number of channels of a file
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Aggregated channel value
+
+The structure contains the aggregate of a channel over one window.
+*/
+typedef struct
+{
+    float           min;                    ///< Minimum
+    float           max;                    ///< Maximum
+    float           mean;                   ///< Mean value
+    float           last;                   ///< Last value
+} tHistFileValue;
+
+/**
+\brief  Historian file writer
+
+The structure describes the files of one window size. It is used by
+histfile_open(), histfile_write() and histfile_close().
+*/
+typedef struct
+{
+    char            aDir[256];              ///< Directory of the files
+    UINT32          windowMs;               ///< Window size [ms]
+    UINT            channelCount;           ///< Number of channels
+    const char*     pNames;                 ///< Channel names (HISTFILE_NAME_LEN bytes each)
+    UINT            recordSize;             ///< Size of a record [bytes]
+    FILE*           pFile;                  ///< Currently open file, or NULL
+    UINT32          segment;                ///< Segment number of the open file
+    UINT32          nextSlot;               ///< Slot following the last written record
+} tHistFile;
+
+/**
+\brief  Query callback
+
+The function type is called by histfile_query() for every stored window.
+*/
+typedef void (*tHistFileQueryCb)(UINT64 timeNs_p, UINT32 sampleCount_p,
+                                 const tHistFileValue* pValue_p, void* pArg_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError histfile_open(tHistFile* pFile_p, const char* pszDir_p, UINT32 windowMs_p,
+                         UINT channelCount_p, const char* pNames_p);
+tOplkError histfile_write(tHistFile* pFile_p, UINT64 timeNs_p, UINT32 sampleCount_p,
+                          const tHistFileValue* pValues_p);
+void       histfile_close(tHistFile* pFile_p);
+tOplkError histfile_query(const char* pszDir_p, UINT32 windowMs_p, const char* pszChannel_p,
+                          UINT64 fromNs_p, UINT64 toNs_p, tHistFileQueryCb pfnCallback_p, void* pArg_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_histfile_H_ */
@@ -0,0 +1,259 @@
+/**
+********************************************************************************
+\file   histq.c
+
+\brief  Historian query tool
+
+This file contains a tool which reads a channel from the files of the
+historian of the MN demo application.
+
+The windows of the channel within the requested time range are printed as
+comma separated values. Only the segment files which cover the time range
+are read.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <getopt/getopt.h>
+
+#include "histfile.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Query options
+
+The structure contains the command line options of the query tool.
+*/
+typedef struct
+{
+    const char*     pszDir;                 ///< Directory of the historian files
+    const char*     pszChannel;             ///< Channel name
+    UINT32          windowMs;               ///< Window size [ms]
+    UINT64          fromNs;                 ///< Start of the time range [ns since 1970-01-01 UTC]
+    UINT64          toNs;                   ///< End of the time range [ns since 1970-01-01 UTC]
+} tQueryOptions;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static ULONG    recordCount_l = 0;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int  getOptions(int argc_p, char** argv_p, tQueryOptions* pOpts_p);
+static BOOL parseTime(const char* pszTime_p, UINT64* pTimeNs_p);
+static void printRecord(UINT64 timeNs_p, UINT32 sampleCount_p,
+                        const tHistFileValue* pValue_p, void* pArg_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the historian query tool
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    tQueryOptions   opts;
+
+    if (getOptions(argc, argv, &opts) != 0)
+        return EXIT_FAILURE;
+
+    printf("time,samples,min,max,mean,last\n");
+    if (histfile_query(opts.pszDir, opts.windowMs, opts.pszChannel, opts.fromNs, opts.toNs,
+                       printRecord, NULL) != kErrorOk)
+    {
+        fprintf(stderr, "Channel %s is not recorded with %lu ms windows in %s!\n",
+                opts.pszChannel, (ULONG)opts.windowMs, opts.pszDir);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "%lu windows\n", recordCount_l);
+    return EXIT_SUCCESS;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+\param  argc_p                  Number of arguments.
+\param  argv_p                  Pointer to argument strings.
+\param  pOpts_p                 Pointer to store the options.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, tQueryOptions* pOpts_p)
+{
+    int     opt;
+    BOOL    fValid = TRUE;
+
+    pOpts_p->pszDir = ".";
+    pOpts_p->pszChannel = NULL;
+    pOpts_p->windowMs = 0;
+    pOpts_p->fromNs = 0;
+    pOpts_p->toNs = (UINT64)-1;
+
+    while ((opt = getopt(argc_p, argv_p, "d:w:c:f:t:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                pOpts_p->pszDir = optarg;
+                break;
+
+            case 'w':
+                pOpts_p->windowMs = (UINT32)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'c':
+                pOpts_p->pszChannel = optarg;
+                break;
+
+            case 'f':
+                fValid &= parseTime(optarg, &pOpts_p->fromNs);
+                break;
+
+            case 't':
+                fValid &= parseTime(optarg, &pOpts_p->toNs);
+                break;
+
+            default: /* '?' */
+                fValid = FALSE;
+                break;
+        }
+    }
+
+    if (!fValid || (pOpts_p->windowMs == 0) || (pOpts_p->pszChannel == NULL))
+    {
+        printf("Usage: %s [-d DIR] -w WINDOW-MS -c CHANNEL [-f FROM] [-t TO]\n", argv_p[0]);
+        printf("  Prints the windows of a historian channel as CSV. FROM and TO are\n");
+        printf("  given in seconds since 1970-01-01 UTC\n");
+        return -1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a time
+
+\param  pszTime_p               Time in seconds since 1970-01-01 UTC.
+\param  pTimeNs_p               Pointer to store the time [ns].
+
+\return Returns TRUE if the time is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL parseTime(const char* pszTime_p, UINT64* pTimeNs_p)
+{
+    char*   pEnd;
+    double  seconds = strtod(pszTime_p, &pEnd);
+
+    if ((*pEnd != '\0') || (seconds < 0.0))
+        return FALSE;
+
+    *pTimeNs_p = (UINT64)(seconds * 1e9);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print a window
+
+The function is called by histfile_query() for every window of the channel.
+
+\param  timeNs_p                Start of the window [ns since 1970-01-01 UTC].
+\param  sampleCount_p           Number of samples in the window.
+\param  pValue_p                Values of the window.
+\param  pArg_p                  Callback argument, unused.
+*/
+//------------------------------------------------------------------------------
+static void printRecord(UINT64 timeNs_p, UINT32 sampleCount_p,
+                        const tHistFileValue* pValue_p, void* pArg_p)
+{
+    UNUSED_PARAMETER(pArg_p);
+
+    printf("%lu.%09lu,%lu,%g,%g,%g,%g\n",
+           (ULONG)(timeNs_p / 1000000000ULL), (ULONG)(timeNs_p % 1000000000ULL),
+           (ULONG)sampleCount_p, pValue_p->min, pValue_p->max, pValue_p->mean, pValue_p->last);
+    recordCount_l++;
+}
+
+/// \}
@@ -0,0 +1,278 @@
+/**
+********************************************************************************
+\file   iolat.c
+
+\brief  I/O latency measurement of the MN demo application
+
+This file contains the I/O latency measurement of the MN demo application.
+
+The measurement requires a CN whose digital output is wired back to its
+digital input. The application toggles the test bit of the output and
+measures the time and the number of cycles until the change is visible in
+the input. The result is the round trip latency from the application over
+the network to the CN I/O and back, which depends on the selected sync
+source.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "iolat.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Measurement states
+*/
+typedef enum
+{
+    kIoLatStateSettle = 0,                  ///< Waiting before the next stimulus
+    kIoLatStateWaitResponse                 ///< Stimulus sent, waiting for the input
+} tIoLatState;
+
+/**
+\brief  I/O latency instance
+
+The structure contains the local variables of the I/O latency measurement.
+*/
+typedef struct
+{
+    UINT                nodeId;             ///< Node used for the measurement (0 = disabled)
+    tIoLatState         state;              ///< Current measurement state
+    UINT                output;             ///< Current output value
+    UINT64              stimulusTime;       ///< Time the stimulus was written [ns]
+    UINT32              stimulusCycle;      ///< Cycle the stimulus was written
+    UINT32              settleCycle;        ///< Cycle the settle time started
+    UINT32              count;              ///< Number of completed measurements
+    UINT32              timeoutCount;       ///< Number of aborted measurements
+    UINT64              minTime;            ///< Minimum latency [ns]
+    UINT64              maxTime;            ///< Maximum latency [ns]
+    UINT64              sumTime;            ///< Sum of all latencies [ns]
+    UINT32              minCycles;          ///< Minimum latency [cycles]
+    UINT32              maxCycles;          ///< Maximum latency [cycles]
+    UINT64              sumCycles;          ///< Sum of all latencies [cycles]
+} tIoLatInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tIoLatInstance   ioLatInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the I/O latency measurement
+
+The function initializes the I/O latency measurement.
+
+\param  nodeId_p                Node ID of the CN with the output-to-input
+                                loopback. 0 disables the measurement.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void iolat_init(UINT nodeId_p)
+{
+    memset(&ioLatInstance_l, 0, sizeof(ioLatInstance_l));
+    ioLatInstance_l.nodeId = nodeId_p;
+    ioLatInstance_l.state = kIoLatStateSettle;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the measured node
+
+\return The function returns the node ID used for the measurement or 0 if the
+        measurement is disabled.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT iolat_getNodeId(void)
+{
+    return ioLatInstance_l.nodeId;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a cycle of the I/O latency measurement
+
+The function is called by the synchronous task in every cycle with the input
+of the measured node. It checks whether the stimulus has arrived at the input
+and returns the output to be sent to the node.
+
+\param  cycle_p                 Current cycle counter of the application.
+\param  input_p                 Current input of the measured node.
+
+\return The function returns the output for the measured node.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT iolat_process(UINT32 cycle_p, UINT input_p)
+{
+    tIoLatInstance* pInstance = &ioLatInstance_l;
+    UINT64          now;
+    UINT64          latency;
+    UINT32          cycles;
+
+    switch (pInstance->state)
+    {
+        case kIoLatStateSettle:
+            if ((cycle_p - pInstance->settleCycle) < IOLAT_SETTLE_CYCLES)
+                break;
+
+            // toggle the test bit, the stimulus leaves with this cycle
+            pInstance->output ^= IOLAT_TEST_MASK;
+            pInstance->stimulusTime = system_getTimeNs();
+            pInstance->stimulusCycle = cycle_p;
+            pInstance->state = kIoLatStateWaitResponse;
+            break;
+
+        case kIoLatStateWaitResponse:
+            cycles = cycle_p - pInstance->stimulusCycle;
+            if ((input_p & IOLAT_TEST_MASK) == (pInstance->output & IOLAT_TEST_MASK))
+            {
+                now = system_getTimeNs();
+                latency = now - pInstance->stimulusTime;
+
+                if ((pInstance->count == 0) || (latency < pInstance->minTime))
+                    pInstance->minTime = latency;
+                if (latency > pInstance->maxTime)
+                    pInstance->maxTime = latency;
+                if ((pInstance->count == 0) || (cycles < pInstance->minCycles))
+                    pInstance->minCycles = cycles;
+                if (cycles > pInstance->maxCycles)
+                    pInstance->maxCycles = cycles;
+
+                pInstance->sumTime += latency;
+                pInstance->sumCycles += cycles;
+                pInstance->count++;
+            }
+            else if (cycles >= IOLAT_TIMEOUT_CYCLES)
+            {
+                // no loopback or lost stimulus, start over with the input state
+                pInstance->output = input_p & IOLAT_TEST_MASK;
+                pInstance->timeoutCount++;
+            }
+            else
+            {
+                break;
+            }
+
+            pInstance->settleCycle = cycle_p;
+            pInstance->state = kIoLatStateSettle;
+            break;
+
+        default:
+            break;
+    }
+
+    return pInstance->output;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print I/O latency statistics
+
+The function prints the statistics of the I/O latency measurement.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void iolat_printStatistics(void)
+{
+    tIoLatInstance* pInstance = &ioLatInstance_l;
+
+    if (pInstance->nodeId == 0)
+        return;
+
+    printf("I/O latency of node %u: %lu measurements, %lu timeouts\n",
+           pInstance->nodeId, (ULONG)pInstance->count, (ULONG)pInstance->timeoutCount);
+    if (pInstance->count == 0)
+        return;
+
+    printf("  Time [us]: min %.1f avg %.1f max %.1f\n",
+           (double)pInstance->minTime / 1000.0,
+           (double)pInstance->sumTime / (double)pInstance->count / 1000.0,
+           (double)pInstance->maxTime / 1000.0);
+    printf("  Cycles:    min %lu avg %.2f max %lu\n",
+           (ULONG)pInstance->minCycles,
+           (double)pInstance->sumCycles / (double)pInstance->count,
+           (ULONG)pInstance->maxCycles);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+/// \}
@@ -43,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <stdio.h>
+#include <stdlib.h>
 #include <limits.h>
 #include <string.h>
 
@@ -50,11 +51,35 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/debugstr.h>
 
 #include <system/system.h>
+#if defined(CONFIG_RTTUNE)
+#include <system/rttune.h>
+#endif
 #include <getopt/getopt.h>
 #include <console/console.h>
 
 #include "app.h"
 #include "event.h"
+#include "cdc.h"
+#include "standby.h"
+#include "reinteg.h"
+#include "errhist.h"
+#include "startup.h"
+#include "iolat.h"
+#include "phase.h"
+#include "mplx.h"
+#include "payload.h"
+#include "pidesc.h"
+#include "scale.h"
+#include "pid.h"
+#include "axis.h"
+#include "alarm.h"
+#include "hist.h"
+#include "selftest.h"
+#include "cyctune.h"
+#include "param.h"
+#include "threadstat.h"
+#include "nmtgroup.h"
+#include "objscan.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -68,6 +93,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define IP_ADDR           0xc0a86401          // 192.168.100.1
 #define SUBNET_MASK       0xFFFFFF00          // 255.255.255.0
 #define DEFAULT_GATEWAY   0xC0A864FE          // 192.168.100.C_ADR_RT1_DEF_NODE_ID
+#define MAX_CN_NODEID     239                 // highest node ID of a regular CN
+#define CYCLE_LEN_INDEX   0x1006              // NMT_CycleLen_U32
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -94,8 +121,44 @@ typedef struct
 {
     char        cdcFile[256];
     char*       pLogFile;
+    BOOL        fReplicate;
+    BOOL        fStandby;
+    BOOL        fFastStart;
+    UINT        syncNodeId;
+    BOOL        fSyncOnPrcNode;
+    UINT        latencyNodeId;
+    int         outputOffset;
+    char*       pOptCdcFile;
+    char*       pXapFile;
+    char*       pScaleFile;
+    char*       pPidFile;
+    char*       pAxisFile;
+    char*       pAlarmFile;
+    char*       pHistFile;
+    BOOL        fBenchmark;
+    UINT        selfTestDuration;
+    BOOL        fSelfTestEnforce;
+    char*       pTuneCdcFile;
+    char*       pTuneProjectFile;
+    UINT32      tuneMinCycleLen;
+    char*       pParamFile;
+    char*       pGroupCmd;
+    char*       pScanObjects;
 } tOptions;
 
+/**
+\brief  Configuration loading job
+
+The structure describes the job of loading the configuration. In fast-start
+mode, the job is executed by a separate thread.
+*/
+typedef struct
+{
+    const char* pszCdcFile;         ///< CDC file to load
+    const char* pszOptCdcFile;      ///< File to save the CDC with optimized payload limits, or NULL
+    tOplkError  ret;                ///< Result of the job
+} tLoadConfigJob;
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
@@ -104,10 +167,18 @@ typedef struct
 // local function prototypes
 //------------------------------------------------------------------------------
 static int getOptions(int argc_p, char** argv_p, tOptions* pOpts_p);
-static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
-                                const BYTE* macAddr_p);
+static void printUsage(const char* pProgName_p);
+static int parseSyncSource(const char* pArg_p, tOptions* pOpts_p);
+static tOplkError initPowerlink(UINT32 cycleLen_p, const BYTE* macAddr_p,
+                                UINT syncNodeId_p, BOOL fSyncOnPrcNode_p);
+static tOplkError setupCdc(char* pszCdcFileName_p, BOOL fUseBuffer_p);
+static UINT32 getCycleLen(void);
+static tOplkError initScaling(const char* pszScaleFile_p);
+static void runBenchmarks(void);
+static void loadConfiguration(void* pArg_p);
 static void loopMain(void);
 static void shutdownPowerlink(void);
+static BOOL waitForTakeover(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -132,9 +203,26 @@ int main(int argc, char** argv)
     tOplkError                  ret = kErrorOk;
     tOptions                    opts;
     UINT32                      version;
+    tLoadConfigJob              loadJob;
+    tSystemThread               loadThread;
+    BOOL                        fStackCreated = FALSE;
+    BOOL                        fLoadThread = FALSE;
+
+    if (getOptions(argc, argv, &opts) != 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (opts.fBenchmark)
+    {
+        runBenchmarks();
+        return 0;
+    }
 
-    getOptions(argc, argv, &opts);
+    startup_init(opts.fFastStart);
 
+    startup_beginPhase(kStartupPhaseSystem);
     if (system_init() != 0)
     {
         fprintf(stderr, "Error initializing system!");
@@ -142,6 +230,12 @@ int main(int argc, char** argv)
     }
 
     initEvents(&fGsOff_l);
+    startup_endPhase(kStartupPhaseSystem);
+
+    // the error history must be ready before the stack reports the first event
+    startup_beginPhase(kStartupPhaseLog);
+    errhist_init();
+    startup_endPhase(kStartupPhaseLog);
 
     version = oplk_getVersion();
     printf("----------------------------------------------------\n");
@@ -149,17 +243,170 @@ int main(int argc, char** argv)
     printf("using openPOWERLINK Stack: %x.%x.%x\n", PLK_STACK_VER(version), PLK_STACK_REF(version), PLK_STACK_REL(version));
     printf("----------------------------------------------------\n");
 
-    if ((ret = initPowerlink(CYCLE_LEN, opts.cdcFile, aMacAddr_g)) != kErrorOk)
+    if (opts.syncNodeId == C_ADR_SYNC_ON_SOA)
+        printf("Synchronizing application on SoA\n");
+    else
+        printf("Synchronizing application on PRes of %snode %u\n",
+               opts.fSyncOnPrcNode ? "PRC " : "", opts.syncNodeId);
+
+    iolat_init(opts.latencyNodeId);
+
+    loadJob.pszCdcFile = opts.cdcFile;
+    loadJob.pszOptCdcFile = opts.pOptCdcFile;
+    loadJob.ret = kErrorOk;
+
+    if (opts.fFastStart)
+    {
+        // The configuration is loaded while the stack is created. A standby MN
+        // also creates its stack before it waits, so only the NMT reset is
+        // left after a takeover. The payload optimizer determines the limits
+        // passed to the stack, so it has to finish before the stack is created.
+        if ((opts.pOptCdcFile == NULL) &&
+            (system_createThread(loadConfiguration, &loadJob, &loadThread) == 0))
+        {
+            fLoadThread = TRUE;
+        }
+        else
+        {
+            loadConfiguration(&loadJob);
+            if (loadJob.ret != kErrorOk)
+                goto Exit;
+        }
+
+        fStackCreated = TRUE;
+        ret = initPowerlink(CYCLE_LEN, aMacAddr_g, opts.syncNodeId, opts.fSyncOnPrcNode);
+        if (fLoadThread)
+            system_joinThread(&loadThread);
+        if (ret != kErrorOk)
+            goto Exit;
+    }
+    else
+    {
+        loadConfiguration(&loadJob);
+    }
+
+    if (loadJob.ret != kErrorOk)
         goto Exit;
 
+    if (opts.selfTestDuration != 0)
+    {
+        startup_beginPhase(kStartupPhaseSelfTest);
+        ret = selftest_run(getCycleLen(), opts.selfTestDuration);
+        startup_endPhase(kStartupPhaseSelfTest);
+        if ((ret != kErrorOk) && opts.fSelfTestEnforce)
+        {
+            fprintf(stderr, "The platform does not meet the cycle length, refusing to start!\n");
+            goto Exit;
+        }
+    }
+
+    phase_init(getCycleLen(), opts.outputOffset);
+
+    if (opts.pTuneCdcFile != NULL)
+    {
+        // the control loops and axes are set up for the configured cycle length
+        if ((getCycleLen() == 0) || (opts.pPidFile != NULL) || (opts.pAxisFile != NULL))
+        {
+            fprintf(stderr, "Commissioning requires the cycle length in the CDC and no control loops or axes!\n");
+            goto Exit;
+        }
+        cyctune_init(getCycleLen(), opts.tuneMinCycleLen, opts.pTuneCdcFile, opts.pTuneProjectFile);
+    }
+
+    if ((ret = mplx_init()) != kErrorOk)
+        goto Exit;
+    mplx_printConfig();
+
+    if (((opts.pScaleFile != NULL) || (opts.pAxisFile != NULL) || (opts.pAlarmFile != NULL) ||
+         (opts.pHistFile != NULL)) &&
+        ((ret = pidesc_load(opts.pXapFile)) != kErrorOk))
+        goto Exit;
+
+    if ((opts.pScaleFile != NULL) &&
+        ((ret = initScaling(opts.pScaleFile)) != kErrorOk))
+        goto Exit;
+
+    if ((opts.pPidFile != NULL) &&
+        ((ret = pid_init(opts.pPidFile, getCycleLen())) != kErrorOk))
+        goto Exit;
+
+    if ((opts.pAxisFile != NULL) &&
+        ((ret = axis_init(opts.pAxisFile, getCycleLen())) != kErrorOk))
+        goto Exit;
+
+    if ((opts.pAlarmFile != NULL) &&
+        ((ret = alarm_init(opts.pAlarmFile, getCycleLen())) != kErrorOk))
+        goto Exit;
+
+    if ((opts.pHistFile != NULL) &&
+        ((ret = hist_init(opts.pHistFile)) != kErrorOk))
+        goto Exit;
+
+    if ((ret = param_init(opts.pParamFile)) != kErrorOk)
+        goto Exit;
+
+    if ((ret = nmtgroup_init(opts.pGroupCmd)) != kErrorOk)
+        goto Exit;
+
+    if ((ret = objscan_init(opts.pScanObjects)) != kErrorOk)
+        goto Exit;
+
+    if (opts.fReplicate || opts.fStandby)
+    {
+        if (standby_init(opts.fStandby, cdc_getFingerprint()) != kErrorOk)
+            goto Exit;
+
+        if (opts.fStandby)
+        {
+            startup_beginPhase(kStartupPhaseStandby);
+            if (!waitForTakeover())
+            {
+                startup_endPhase(kStartupPhaseStandby);
+                goto Exit;
+            }
+            startup_endPhase(kStartupPhaseStandby);
+        }
+    }
+
+    if (!fStackCreated)
+    {
+        fStackCreated = TRUE;
+        if ((ret = initPowerlink(CYCLE_LEN, aMacAddr_g, opts.syncNodeId,
+                                 opts.fSyncOnPrcNode)) != kErrorOk)
+            goto Exit;
+    }
+
+    if ((ret = setupCdc(opts.cdcFile, opts.fFastStart || (opts.pOptCdcFile != NULL))) != kErrorOk)
+        goto Exit;
+
+    startup_beginPhase(kStartupPhaseApp);
     if ((ret = initApp()) != kErrorOk)
         goto Exit;
+    startup_endPhase(kStartupPhaseApp);
 
     loopMain();
 
 Exit:
-    shutdownPowerlink();
-    shutdownApp();
+    if (fStackCreated)
+    {
+        shutdownPowerlink();
+        shutdownApp();
+    }
+
+    console_flushlog();
+    iolat_printStatistics();
+    phase_printStatistics();
+    reinteg_printStatistics();
+    reinteg_exit();
+    hist_exit();
+    hist_printStatistics();
+    standby_printStatistics();
+    standby_exit();
+    param_exit();
+    threadstat_printStatistics();
+    threadstat_exit();
+    objscan_exit();
+    cdc_exit();
     system_exit();
 
     return 0;
@@ -179,17 +426,23 @@ The function initializes the openPOWERLINK stack.
 
 \param  cycleLen_p              Length of POWERLINK cycle.
 \param  macAddr_p               MAC address to use for POWERLINK interface.
+\param  syncNodeId_p            Node whose PRes triggers the sync event
+                                (C_ADR_SYNC_ON_SOA = SoA).
+\param  fSyncOnPrcNode_p        Node given by syncNodeId_p is a PRC node.
 
 \return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
-                                const BYTE* macAddr_p)
+static tOplkError initPowerlink(UINT32 cycleLen_p, const BYTE* macAddr_p,
+                                UINT syncNodeId_p, BOOL fSyncOnPrcNode_p)
 {
     tOplkError                  ret = kErrorOk;
     static tOplkApiInitParam    initParam;
     static char                 devName[128];
+    UINT                        preqLimit;
+    UINT                        presLimit;
 
+    startup_beginPhase(kStartupPhaseStack);
     printf("Initializing openPOWERLINK stack...\n");
 
     memset(&initParam, 0, sizeof(initParam));
@@ -209,10 +462,13 @@ static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
     initParam.isochrTxMaxPayload      = 256;              // const
     initParam.isochrRxMaxPayload      = 256;              // const
     initParam.presMaxLatency          = 50000;            // const; only required for IdentRes
-    initParam.preqActPayloadLimit     = 36;               // required for initialisation (+28 bytes)
-    initParam.presActPayloadLimit     = 36;               // required for initialisation of Pres frame (+28 bytes)
+    // the optimized limits are only known here if the CDC has been loaded
+    // before, otherwise they are applied from the CDC (0x1F98/5)
+    payload_getMnLimits(&preqLimit, &presLimit);
+    initParam.preqActPayloadLimit     = preqLimit;        // required for initialisation (+28 bytes)
+    initParam.presActPayloadLimit     = presLimit;        // required for initialisation of Pres frame (+28 bytes)
     initParam.asndMaxLatency          = 150000;           // const; only required for IdentRes
-    initParam.multiplCylceCnt         = 0;                // required for error detection
+    initParam.multiplCylceCnt         = 0;                // required for error detection, the CDC sets 0x1F98/7
     initParam.asyncMtu                = 1500;             // required to set up max frame size
     initParam.prescaler               = 2;                // required for sync
     initParam.lossOfFrameTolerance    = 500000;
@@ -227,8 +483,8 @@ static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
     initParam.subnetMask              = SUBNET_MASK;
     initParam.defaultGateway          = DEFAULT_GATEWAY;
     sprintf((char*)initParam.sHostname, "%02x-%08x", initParam.nodeId, initParam.vendorId);
-    initParam.syncNodeId              = C_ADR_SYNC_ON_SOA;
-    initParam.fSyncOnPrcNode          = FALSE;
+    initParam.syncNodeId              = syncNodeId_p;
+    initParam.fSyncOnPrcNode          = fSyncOnPrcNode_p;
 
     // set callback functions
     initParam.pfnCbEvent = processEvents;
@@ -239,6 +495,12 @@ static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
     initParam.pfnCbSync  = NULL;
 #endif
 
+#if defined(CONFIG_RTTUNE)
+    // the demo does not select a device, the stack uses its default, so the
+    // adapter is unknown and its interrupt moderation is left to plktune -i
+    rttune_run(NULL, RTTUNE_FLAG_APPLY, RTTUNE_DEFAULT_PERIOD, RTTUNE_DEFAULT_DURATION);
+#endif
+
     // initialize POWERLINK stack
     ret = oplk_initialize();
     if (ret != kErrorOk)
@@ -254,16 +516,161 @@ static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
         return ret;
     }
 
-    ret = oplk_setCdcFilename(pszCdcFileName_p);
-    if (ret != kErrorOk)
+    startup_endPhase(kStartupPhaseStack);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pass the CDC to the stack
+
+The function passes the CDC to the openPOWERLINK stack. The stack either reads
+the CDC file itself or uses the CDC already loaded by the application.
+
+\param  pszCdcFileName_p        File name of the CDC.
+\param  fUseBuffer_p            Use the loaded CDC instead of reading the file again.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setupCdc(char* pszCdcFileName_p, BOOL fUseBuffer_p)
+{
+    tOplkError                  ret = kErrorOk;
+    BYTE*                       pCdc;
+    UINT                        cdcSize;
+
+    if (fUseBuffer_p)
     {
-        fprintf(stderr, "oplk_setCdcFilename() failed with \"%s\" (0x%04x)\n", debugstr_getRetValStr(ret), ret);
-        return ret;
+        pCdc = cdc_getBuffer(&cdcSize);
+        ret = oplk_setCdcBuffer(pCdc, cdcSize);
+        if (ret != kErrorOk)
+        {
+            fprintf(stderr, "oplk_setCdcBuffer() failed with \"%s\" (0x%04x)\n", debugstr_getRetValStr(ret), ret);
+            return ret;
+        }
+    }
+    else
+    {
+        ret = oplk_setCdcFilename(pszCdcFileName_p);
+        if (ret != kErrorOk)
+        {
+            fprintf(stderr, "oplk_setCdcFilename() failed with \"%s\" (0x%04x)\n", debugstr_getRetValStr(ret), ret);
+            return ret;
+        }
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load the configuration
+
+The function loads and validates the CDC and stages the node configurations
+for the reintegration. In fast-start mode, it is executed by a separate thread
+while the stack is initialized.
+
+\param  pArg_p                  Pointer to the configuration loading job.
+*/
+//------------------------------------------------------------------------------
+static void loadConfiguration(void* pArg_p)
+{
+    tLoadConfigJob*             pJob = (tLoadConfigJob*)pArg_p;
+
+    startup_beginPhase(kStartupPhaseCdc);
+    pJob->ret = cdc_init(pJob->pszCdcFile);
+    if (pJob->ret != kErrorOk)
+        return;
+
+    pJob->ret = cdc_validate();
+    if (pJob->ret != kErrorOk)
+    {
+        fprintf(stderr, "CDC file %s is corrupted!\n", pJob->pszCdcFile);
+        return;
     }
 
+    // The payload optimizer modifies the CDC buffer, so it must run before
+    // the node configurations are staged.
+    if (pJob->pszOptCdcFile != NULL)
+    {
+        pJob->ret = payload_optimize(getCycleLen());
+        if (pJob->ret == kErrorOk)
+            pJob->ret = cdc_save(pJob->pszOptCdcFile);
+        if (pJob->ret != kErrorOk)
+        {
+            fprintf(stderr, "Optimizing the payload limits failed!\n");
+            return;
+        }
+        printf("Optimized CDC saved to %s\n", pJob->pszOptCdcFile);
+    }
+
+    pJob->ret = reinteg_init();
+    startup_endPhase(kStartupPhaseCdc);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the configured cycle length
+
+The function reads the cycle length from the loaded CDC.
+
+\return The function returns the cycle length in us or 0 if the CDC does not
+        contain it.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getCycleLen(void)
+{
+    tCdcEntry                   entry;
+    BYTE*                       pCdc;
+    UINT                        cdcSize;
+
+    pCdc = cdc_getBuffer(&cdcSize);
+    if (!cdc_findEntry(pCdc, cdcSize, CYCLE_LEN_INDEX, 0, &entry))
+        return 0;
+
+    return (UINT32)cdc_getEntryValue(&entry);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the analog channel scaling
+
+\param  pszScaleFile_p          File name of the scaling table.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError initScaling(const char* pszScaleFile_p)
+{
+    tOplkError                  ret;
+
+    ret = scale_init(pszScaleFile_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    scale_printConfig();
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Run the benchmarks
+
+The function measures the execution time of the cyclic processing stages with
+synthetic configurations. It is executed instead of the application.
+*/
+//------------------------------------------------------------------------------
+static void runBenchmarks(void)
+{
+    printf("Running benchmarks...\n");
+    scale_benchmark(2048, 10000);
+    pid_benchmark(512, 10000);
+    axis_benchmark(64, 20000);
+    alarm_benchmark(4096, 20000);
+    hist_benchmark(1024, 40000);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Main loop of demo application
@@ -280,16 +687,27 @@ static void loopMain(void)
     tOplkError              ret = kErrorOk;
     char                    cKey = 0;
     BOOL                    fExit = FALSE;
+    int                     outputOffset;
+    BOOL                    fAxesEnabled = FALSE;
+    UINT                    axis;
+    tAlarmEvent             alarmEvent;
 
 #if !defined(CONFIG_KERNELSTACK_DIRECTLINK)
 
 #if defined(CONFIG_USE_SYNCTHREAD)
+    startup_beginPhase(kStartupPhaseThreads);
     system_startSyncThread(processSync);
+    startup_endPhase(kStartupPhaseThreads);
 #endif
 
 #endif
 
+    // in commissioning mode, the cycle length is searched before the normal start
+    if (cyctune_isEnabled() && (cyctune_run() != kErrorOk))
+        return;
+
     // start stack processing by sending a NMT reset command
+    startup_beginPhase(kStartupPhaseBoot);
     ret = oplk_execNmtCommand(kNmtEventSwReset);
     if (ret != kErrorOk)
     {
@@ -299,6 +717,24 @@ static void loopMain(void)
     printf("\n-------------------------------\n");
     printf("Press Esc to leave the program\n");
     printf("Press r to reset the node\n");
+    printf("Press e to print the error history summary\n");
+    if (iolat_getNodeId() != 0)
+        printf("Press l to print the I/O latency statistics\n");
+    if (phase_getOutputOffset(&outputOffset))
+        printf("Press t to print the phase statistics\n");
+    printf("Press p to print the state of the control loops\n");
+    if (axis_getAxisCount() != 0)
+    {
+        printf("Press a to enable/disable the axes\n");
+        printf("Press g to move all axes by one unit and back\n");
+        printf("Press m to print the state of the axes\n");
+    }
+    printf("Press w to print the active alarms\n");
+    printf("Press v to toggle verbose logging\n");
+    printf("Press u to print the thread statistics\n");
+    if (nmtgroup_hasPreset())
+        printf("Press n to execute the NMT group command\n");
+    printf("Press i to scan the objects of all CNs\n");
     printf("-------------------------------\n\n");
 
     while (!fExit)
@@ -324,6 +760,61 @@ static void loopMain(void)
                     }
                     break;
 
+                case 'e':
+                    errhist_printSummary();
+                    break;
+
+                case 'l':
+                    iolat_printStatistics();
+                    break;
+
+                case 't':
+                    phase_printStatistics();
+                    break;
+
+                case 'p':
+                    pid_printStatus();
+                    break;
+
+                case 'a':
+                    fAxesEnabled = !fAxesEnabled;
+                    for (axis = 0; axis < axis_getAxisCount(); axis++)
+                        axis_setEnable(axis, fAxesEnabled);
+                    break;
+
+                case 'g':
+                    for (axis = 0; axis < axis_getAxisCount(); axis++)
+                    {
+                        if ((axis_moveBy(axis, 1.0) != kErrorOk) ||
+                            (axis_moveBy(axis, -1.0) != kErrorOk))
+                            printf("Axis %u does not accept moves\n", axis);
+                    }
+                    break;
+
+                case 'm':
+                    axis_printStatus();
+                    break;
+
+                case 'w':
+                    alarm_printStatus();
+                    break;
+
+                case 'v':
+                    console_toggleverbose();
+                    break;
+
+                case 'u':
+                    threadstat_printStatistics();
+                    break;
+
+                case 'n':
+                    nmtgroup_execPreset();
+                    break;
+
+                case 'i':
+                    objscan_start();
+                    break;
+
                 case 0x1B:
                     fExit = TRUE;
                     break;
@@ -336,15 +827,29 @@ static void loopMain(void)
         if (system_getTermSignalState() == TRUE)
         {
             fExit = TRUE;
-            printf("Received termination signal, exiting...\n");
+            CONSOLE_LOG_INFO(kConsoleModSystem, "Received termination signal, exiting...\n");
         }
 
         if (oplk_checkKernelStack() == FALSE)
         {
             fExit = TRUE;
-            fprintf(stderr, "Kernel stack has gone! Exiting...\n");
+            CONSOLE_LOG_ERROR(kConsoleModSystem, "Kernel stack has gone! Exiting...\n");
         }
 
+        while (alarm_getEvent(&alarmEvent))
+        {
+            printf("Alarm %s %s (value %g, cycle %lu)\n", alarm_getName(alarmEvent.alarm),
+                   alarmEvent.fActive ? "raised" : "cleared", alarmEvent.value, (ULONG)alarmEvent.cycle);
+        }
+
+        console_flushlog();
+        startup_process();
+        threadstat_enter(kThreadStatRoleMain);
+        threadstat_process();
+        nmtgroup_process();
+        objscan_process();
+        standby_process();
+
 #if defined(CONFIG_USE_SYNCTHREAD) || defined(CONFIG_KERNELSTACK_DIRECTLINK)
         system_msleep(100);
 #else
@@ -393,6 +898,40 @@ static void shutdownPowerlink(void)
     oplk_exit();
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for takeover as standby MN
+
+The function waits until the primary MN has failed or has been shut down. It
+polls the replication channel and keeps a copy of the primary's state, which
+is used to initialize the application after the takeover.
+
+\return The function returns TRUE if the standby has to take over or FALSE if
+        the program should be terminated.
+*/
+//------------------------------------------------------------------------------
+static BOOL waitForTakeover(void)
+{
+    printf("Running as standby MN, waiting for the primary MN to fail\n");
+    printf("Press Esc to leave the program\n");
+
+    while (!standby_checkPrimary())
+    {
+        if (console_kbhit() && (console_getch() == 0x1B))
+            return FALSE;
+
+        if (system_getTermSignalState() == TRUE)
+        {
+            CONSOLE_LOG_INFO(kConsoleModSystem, "Received termination signal, exiting...\n");
+            return FALSE;
+        }
+
+        system_msleep(1);
+    }
+
+    return TRUE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get command line parameters
@@ -416,9 +955,32 @@ static int getOptions(int argc_p, char** argv_p, tOptions* pOpts_p)
     /* setup default parameters */
     strncpy(pOpts_p->cdcFile, "mnobd.cdc", 256);
     pOpts_p->pLogFile = NULL;
+    pOpts_p->fReplicate = FALSE;
+    pOpts_p->fStandby = FALSE;
+    pOpts_p->fFastStart = FALSE;
+    pOpts_p->syncNodeId = C_ADR_SYNC_ON_SOA;
+    pOpts_p->fSyncOnPrcNode = FALSE;
+    pOpts_p->latencyNodeId = 0;
+    pOpts_p->outputOffset = PHASE_OFFSET_NONE;
+    pOpts_p->pOptCdcFile = NULL;
+    pOpts_p->pXapFile = "xap.xml";
+    pOpts_p->pScaleFile = NULL;
+    pOpts_p->pPidFile = NULL;
+    pOpts_p->pAxisFile = NULL;
+    pOpts_p->pAlarmFile = NULL;
+    pOpts_p->pHistFile = NULL;
+    pOpts_p->fBenchmark = FALSE;
+    pOpts_p->selfTestDuration = 0;
+    pOpts_p->fSelfTestEnforce = FALSE;
+    pOpts_p->pTuneCdcFile = NULL;
+    pOpts_p->pTuneProjectFile = NULL;
+    pOpts_p->tuneMinCycleLen = CYCTUNE_MIN_CYCLE_LEN;
+    pOpts_p->pParamFile = NULL;
+    pOpts_p->pGroupCmd = NULL;
+    pOpts_p->pScanObjects = NULL;
 
     /* get command line parameters */
-    while ((opt = getopt(argc_p, argv_p, "c:l:")) != -1)
+    while ((opt = getopt(argc_p, argv_p, "c:l:frsy:L:o:P:x:a:C:M:A:H:bt:T:k:K:m:v:p:n:S:")) != -1)
     {
         switch (opt)
         {
@@ -430,12 +992,201 @@ static int getOptions(int argc_p, char** argv_p, tOptions* pOpts_p)
                 pOpts_p->pLogFile = optarg;
                 break;
 
+            case 'f':
+                pOpts_p->fFastStart = TRUE;
+                break;
+
+            case 'r':
+                pOpts_p->fReplicate = TRUE;
+                break;
+
+            case 's':
+                pOpts_p->fStandby = TRUE;
+                break;
+
+            case 'y':
+                if (parseSyncSource(optarg, pOpts_p) != 0)
+                {
+                    fprintf(stderr, "Invalid sync source %s!\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                pOpts_p->outputOffset = (int)strtol(optarg, NULL, 0);
+                break;
+
+            case 'P':
+                pOpts_p->pOptCdcFile = optarg;
+                break;
+
+            case 'x':
+                pOpts_p->pXapFile = optarg;
+                break;
+
+            case 'a':
+                pOpts_p->pScaleFile = optarg;
+                break;
+
+            case 'C':
+                pOpts_p->pPidFile = optarg;
+                break;
+
+            case 'M':
+                pOpts_p->pAxisFile = optarg;
+                break;
+
+            case 'A':
+                pOpts_p->pAlarmFile = optarg;
+                break;
+
+            case 'H':
+                pOpts_p->pHistFile = optarg;
+                break;
+
+            case 'b':
+                pOpts_p->fBenchmark = TRUE;
+                break;
+
+            case 't':
+            case 'T':
+                pOpts_p->selfTestDuration = (UINT)strtoul(optarg, NULL, 0);
+                pOpts_p->fSelfTestEnforce = (opt == 't');
+                if (pOpts_p->selfTestDuration == 0)
+                {
+                    fprintf(stderr, "Invalid self-test duration %s!\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'k':
+                pOpts_p->pTuneCdcFile = optarg;
+                break;
+
+            case 'K':
+                pOpts_p->pTuneProjectFile = optarg;
+                break;
+
+            case 'm':
+                pOpts_p->tuneMinCycleLen = (UINT32)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'p':
+                pOpts_p->pParamFile = optarg;
+                break;
+
+            case 'n':
+                pOpts_p->pGroupCmd = optarg;
+                break;
+
+            case 'S':
+                pOpts_p->pScanObjects = optarg;
+                break;
+
+            case 'v':
+                if (console_parseloglevels(optarg) != 0)
+                {
+                    fprintf(stderr, "Invalid log levels %s!\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'L':
+                pOpts_p->latencyNodeId = (UINT)strtoul(optarg, NULL, 0);
+                if ((pOpts_p->latencyNodeId == 0) || (pOpts_p->latencyNodeId > MAX_CN_NODEID))
+                {
+                    fprintf(stderr, "Invalid latency measurement node %s!\n", optarg);
+                    pOpts_p->latencyNodeId = 0;
+                    return -1;
+                }
+                break;
+
             default: /* '?' */
-                printf("Usage: %s [-c CDC-FILE] [-l LOGFILE]\n", argv_p[0]);
                 return -1;
         }
     }
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Print command line usage
+
+The function prints the command line parameters of the program.
+
+\param  pProgName_p             Name of the program.
+*/
+//------------------------------------------------------------------------------
+static void printUsage(const char* pProgName_p)
+{
+    printf("Usage: %s [-c CDC-FILE] [-l LOGFILE] [-f] [-r] [-s] [-y SYNC] [-L NODE] [-o OFFSET] [-P FILE] [-x XAP-FILE] [-a TABLE] [-C FILE] [-M FILE] [-A FILE] [-H FILE] [-b] [-t|-T SECONDS] [-k CDC-FILE [-K PROJECT] [-m MIN]] [-v LEVELS] [-p FILE] [-n COMMAND:NODES] [-S OBJECTS]\n", pProgName_p);
+    printf("  -f  Fast start: initialize independent parts in parallel\n");
+    printf("  -r  Replicate the application state to a standby MN\n");
+    printf("  -s  Run as standby MN and take over when the primary MN fails\n");
+    printf("  -y  Sync source: soa, NODE (PRes of CN) or prc:NODE (PRes of PRC node)\n");
+    printf("  -L  Measure the I/O latency of NODE (output wired back to input)\n");
+    printf("  -o  Hand over outputs OFFSET us after the sync event (negative: before the next one)\n");
+    printf("  -P  Minimize the isochronous payload limits and save the optimized CDC to FILE\n");
+    printf("  -x  Process image description (default: xap.xml)\n");
+    printf("  -a  Scale the analog channels listed in TABLE\n");
+    printf("  -C  Run the control loops listed in FILE (requires -a)\n");
+    printf("  -M  Drive the CiA 402 axes listed in FILE\n");
+    printf("  -A  Monitor the alarms listed in FILE\n");
+    printf("  -H  Record the channels listed in FILE to the historian\n");
+    printf("  -b  Run the benchmarks of the cyclic processing stages and exit\n");
+    printf("  -t  Measure the wake-up latency for SECONDS before start-up, refuse to start on failure\n");
+    printf("  -T  Measure the wake-up latency for SECONDS before start-up, report only\n");
+    printf("  -k  Commissioning: search the smallest stable cycle length and save the CDC to CDC-FILE\n");
+    printf("  -K  Commissioning: also write the cycle length to the openCONFIGURATOR PROJECT\n");
+    printf("  -m  Commissioning: lower bound of the cycle length in us (default: %d)\n", CYCTUNE_MIN_CYCLE_LEN);
+    printf("  -v  Log levels, e.g. all=warning,event=debug (modules: event, sync, cfm, prodtest, system;\n");
+    printf("      levels: none, error, warning, info, debug)\n");
+    printf("  -p  Load the runtime parameters from FILE and reload them when it changes\n");
+    printf("  -n  NMT group command executed with key n, e.g. resetcomm:1-40 (start, stop, preop2,\n");
+    printf("      readytoop, resetnode, resetcomm, resetconf, swreset)\n");
+    printf("  -S  Objects read by the object scan with key i (default: %s)\n", OBJSCAN_DEFAULT_OBJECTS);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse the sync source
+
+The function parses the sync source given on the command line. The sync
+source is either "soa", the node ID of a CN whose PRes triggers the sync
+event, or "prc:" followed by the node ID of a PRC node.
+
+\param  pArg_p                  Sync source argument.
+\param  pOpts_p                 Pointer to the options to fill.
+
+\return The function returns 0 on success or -1 if the argument is invalid.
+*/
+//------------------------------------------------------------------------------
+static int parseSyncSource(const char* pArg_p, tOptions* pOpts_p)
+{
+    char*                       pEnd;
+    ULONG                       nodeId;
+    BOOL                        fPrc = FALSE;
+
+    if (strcmp(pArg_p, "soa") == 0)
+    {
+        pOpts_p->syncNodeId = C_ADR_SYNC_ON_SOA;
+        pOpts_p->fSyncOnPrcNode = FALSE;
+        return 0;
+    }
+
+    if (strncmp(pArg_p, "prc:", 4) == 0)
+    {
+        fPrc = TRUE;
+        pArg_p += 4;
+    }
+
+    nodeId = strtoul(pArg_p, &pEnd, 0);
+    if ((pEnd == pArg_p) || (*pEnd != '\0') || (nodeId == 0) || (nodeId > MAX_CN_NODEID))
+        return -1;
+
+    pOpts_p->syncNodeId = (UINT)nodeId;
+    pOpts_p->fSyncOnPrcNode = fPrc;
+    return 0;
+}
+
 /// \}
@@ -0,0 +1,424 @@
+/**
+********************************************************************************
+\file   mplx.c
+
+\brief  Multiplexed cycle handling of the MN demo application
+
+This file contains the multiplexed cycle handling of the MN demo application.
+
+Multiplexed CNs are not polled in every cycle but only in one slot of the
+multiplexed cycle. The module reads the multiplexed cycle length and the slot
+assignment of the CNs from the CDC and builds one node list per slot. In every
+cycle, the application gets the list of the continuous CNs and the CNs of the
+current slot, so its work scales with the number of CNs actually serviced. The
+time of the last refresh is recorded for every node.
+
+The current slot is derived from the relative time of the last SoC, which
+the data link layer advances by one cycle length per cycle from the start of
+the isochronous phase, like its multiplexed cycle count. Missed or coalesced
+sync events therefore cannot shift the slot. The cycle length is read from
+the object dictionary whenever the MN enters PreOperational2, where the
+isochronous phase starts. While the SoC time is not valid, only the
+continuous CNs are serviced.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "cdc.h"
+#include "mplx.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define MPLX_NODE_ASSIGN_INDEX      0x1F81      // NMT_NodeAssignment_AU32
+#define MPLX_CYCLE_TIMING_INDEX     0x1F98      // NMT_CycleTiming_REC
+#define MPLX_CYCLE_COUNT_SUBINDEX   0x07        // MultiplCycleCnt_U8
+#define MPLX_CYCLE_ASSIGN_INDEX     0x1F9B      // NMT_MultiplCycleAssign_AU8
+#define MPLX_CYCLE_LEN_INDEX        0x1006      // NMT_CycleLen_U32
+
+#define NODEASSIGN_NODE_IS_CN       0x00000002  // node is a CN
+#define NODEASSIGN_ASYNCONLY_NODE   0x00000100  // node is not polled isochronously
+#define NODEASSIGN_MULTIPLEXED_CN   0x00000200  // node is polled in a multiplexed slot
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Multiplexed cycle instance
+
+The structure contains the local variables of the multiplexed cycle handling.
+The node lists of all slots are stored in one array. The nodes of slot s are
+located at aNode[aSlotStart[s]] up to aNode[aSlotStart[s + 1] - 1]. The
+continuous nodes are stored in front of each slot's list, so a cycle needs a
+single list.
+*/
+typedef struct
+{
+    UINT                cycleCount;                             ///< Length of the multiplexed cycle (0 = none)
+    UINT8               aSlot[MPLX_NODE_COUNT + 1];             ///< Slot of each node
+    BOOL                aIsochronous[MPLX_NODE_COUNT + 1];      ///< Node is polled isochronously
+    UINT                continuousCount;                        ///< Number of continuous nodes
+    UINT                aSlotStart[MPLX_MAX_CYCLE_COUNT + 2];   ///< Start of the node list of each slot
+    UINT8               aNode[(MPLX_MAX_CYCLE_COUNT + 1) * MPLX_NODE_COUNT]; ///< Node lists of all slots
+    volatile UINT32     cycleLen;                               ///< Cycle length of the isochronous phase [us] (0 = unknown)
+    UINT64              aLastRefresh[MPLX_NODE_COUNT + 1];      ///< Time of the last refresh [ns]
+} tMplxInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tMplxInstance    mplxInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void readConfig(UINT32* pNodeAssign_p, UINT8* pSlotAssign_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the multiplexed cycle handling
+
+The function reads the multiplexed cycle configuration from the loaded CDC
+and builds the node lists of all slots.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError mplx_init(void)
+{
+    tMplxInstance*  pInstance = &mplxInstance_l;
+    UINT32          aNodeAssign[MPLX_NODE_COUNT + 1];
+    UINT8           aSlotAssign[MPLX_NODE_COUNT + 1];
+    UINT            slot;
+    UINT            nodeId;
+    UINT            pos = 0;
+
+    memset(pInstance, 0, sizeof(*pInstance));
+    readConfig(aNodeAssign, aSlotAssign);
+
+    if (pInstance->cycleCount > MPLX_MAX_CYCLE_COUNT)
+    {
+        printf("Multiplexed cycle length %u exceeds the supported %u cycles!\n",
+               pInstance->cycleCount, MPLX_MAX_CYCLE_COUNT);
+        return kErrorApiInvalidParam;
+    }
+
+    for (nodeId = 1; nodeId <= MPLX_NODE_COUNT; nodeId++)
+    {
+        if (((aNodeAssign[nodeId] & NODEASSIGN_NODE_IS_CN) == 0) ||
+            ((aNodeAssign[nodeId] & NODEASSIGN_ASYNCONLY_NODE) != 0))
+            continue;
+
+        pInstance->aIsochronous[nodeId] = TRUE;
+        if ((pInstance->cycleCount != 0) &&
+            ((aNodeAssign[nodeId] & NODEASSIGN_MULTIPLEXED_CN) != 0))
+        {
+            slot = aSlotAssign[nodeId];
+            if (slot > pInstance->cycleCount)
+            {
+                printf("Node %u is assigned to invalid multiplexed slot %u!\n", nodeId, slot);
+                return kErrorApiInvalidParam;
+            }
+            pInstance->aSlot[nodeId] = (UINT8)slot;
+        }
+
+        if (pInstance->aSlot[nodeId] == MPLX_SLOT_CONTINUOUS)
+            pInstance->continuousCount++;
+    }
+
+    // one list per slot: continuous nodes followed by the nodes of the slot
+    for (slot = 1; slot <= ((pInstance->cycleCount == 0) ? 1 : pInstance->cycleCount); slot++)
+    {
+        pInstance->aSlotStart[slot] = pos;
+        for (nodeId = 1; nodeId <= MPLX_NODE_COUNT; nodeId++)
+        {
+            if (pInstance->aIsochronous[nodeId] &&
+                (pInstance->aSlot[nodeId] == MPLX_SLOT_CONTINUOUS))
+                pInstance->aNode[pos++] = (UINT8)nodeId;
+        }
+        for (nodeId = 1; nodeId <= MPLX_NODE_COUNT; nodeId++)
+        {
+            if (pInstance->aIsochronous[nodeId] && (pInstance->aSlot[nodeId] == slot))
+                pInstance->aNode[pos++] = (UINT8)nodeId;
+        }
+    }
+    pInstance->aSlotStart[slot] = pos;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the length of the multiplexed cycle
+
+\return The function returns the number of cycles of a multiplexed cycle or 0
+        if no multiplexed cycle is configured.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT mplx_getCycleCount(void)
+{
+    return mplxInstance_l.cycleCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the slot of a node
+
+\param  nodeId_p                Node ID of the CN.
+
+\return The function returns the slot of the node in the multiplexed cycle or
+        MPLX_SLOT_CONTINUOUS if the node is refreshed in every cycle.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT mplx_getSlot(UINT nodeId_p)
+{
+    if ((nodeId_p == 0) || (nodeId_p > MPLX_NODE_COUNT))
+        return MPLX_SLOT_CONTINUOUS;
+
+    return mplxInstance_l.aSlot[nodeId_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Restart the multiplexed cycle
+
+The function is called when the isochronous phase of the network is
+(re)started. It reads the cycle length used to derive the current slot from
+the SoC time, as it may have changed with the configuration.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void mplx_restart(void)
+{
+    UINT32          cycleLen = 0;
+    UINT            size = sizeof(cycleLen);
+
+    if (oplk_readLocalObject(MPLX_CYCLE_LEN_INDEX, 0, &cycleLen, &size) != kErrorOk)
+        cycleLen = 0;
+
+    mplxInstance_l.cycleLen = cycleLen;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Begin a cycle
+
+The function is called by the synchronous task in every cycle. It determines
+the slot of the multiplexed cycle from the SoC time, records the refresh time
+of the serviced nodes and returns their node IDs.
+
+\param  pNodeCount_p            Pointer to store the number of serviced nodes.
+
+\return The function returns the node IDs of the nodes refreshed in the
+        current cycle.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const UINT8* mplx_beginCycle(UINT* pNodeCount_p)
+{
+    tMplxInstance*      pInstance = &mplxInstance_l;
+    UINT64              now = system_getTimeNs();
+    tOplkApiSocTimeInfo socTime;
+    UINT32              cycleLen = pInstance->cycleLen;
+    UINT                slot = 1;
+    UINT                start;
+    UINT                end;
+    UINT                i;
+
+    start = pInstance->aSlotStart[slot];
+    end = pInstance->aSlotStart[slot + 1];
+
+    if (pInstance->cycleCount != 0)
+    {
+        if ((cycleLen != 0) && (oplk_getSocTime(&socTime) == kErrorOk) && socTime.fValidRelTime)
+        {
+            slot = (UINT)((socTime.relTime / cycleLen) % pInstance->cycleCount) + 1;
+            start = pInstance->aSlotStart[slot];
+            end = pInstance->aSlotStart[slot + 1];
+        }
+        else
+        {
+            // slot is unknown -> only the continuous nodes in front of the list
+            end = start + pInstance->continuousCount;
+        }
+    }
+
+    for (i = start; i < end; i++)
+        pInstance->aLastRefresh[pInstance->aNode[i]] = now;
+
+    *pNodeCount_p = end - start;
+    return &pInstance->aNode[start];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the time of the last refresh of a node
+
+\param  nodeId_p                Node ID of the CN.
+
+\return The function returns the time of the last refresh in ns or 0 if the
+        node has not been refreshed yet.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT64 mplx_getLastRefresh(UINT nodeId_p)
+{
+    if ((nodeId_p == 0) || (nodeId_p > MPLX_NODE_COUNT))
+        return 0;
+
+    return mplxInstance_l.aLastRefresh[nodeId_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the multiplexed cycle configuration
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void mplx_printConfig(void)
+{
+    tMplxInstance*  pInstance = &mplxInstance_l;
+    UINT            slot;
+
+    if (pInstance->cycleCount == 0)
+    {
+        printf("No multiplexed cycle, %u CNs are refreshed in every cycle\n",
+               pInstance->continuousCount);
+        return;
+    }
+
+    printf("Multiplexed cycle of %u cycles, %u continuous CNs\n",
+           pInstance->cycleCount, pInstance->continuousCount);
+    for (slot = 1; slot <= pInstance->cycleCount; slot++)
+    {
+        printf("  Slot %3u: %u CNs\n", slot,
+               pInstance->aSlotStart[slot + 1] - pInstance->aSlotStart[slot] -
+               pInstance->continuousCount);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the multiplexed cycle configuration from the loaded CDC
+
+The function reads the multiplexed cycle length, the node assignment and the
+multiplexed slot assignment in a single pass over the CDC. If an object is
+contained multiple times, the last entry is used.
+
+\param  pNodeAssign_p           Array to store the node assignment of each node.
+\param  pSlotAssign_p           Array to store the slot assignment of each node.
+*/
+//------------------------------------------------------------------------------
+static void readConfig(UINT32* pNodeAssign_p, UINT8* pSlotAssign_p)
+{
+    tCdcCursor      cursor;
+    tCdcEntry       entry;
+    BYTE*           pCdc;
+    UINT            cdcSize;
+
+    memset(pNodeAssign_p, 0, sizeof(UINT32) * (MPLX_NODE_COUNT + 1));
+    memset(pSlotAssign_p, 0, sizeof(UINT8) * (MPLX_NODE_COUNT + 1));
+
+    pCdc = cdc_getBuffer(&cdcSize);
+    if (cdc_openCursor(pCdc, cdcSize, &cursor) != kErrorOk)
+        return;
+
+    while (cdc_nextEntry(&cursor, &entry))
+    {
+        if ((entry.index == MPLX_CYCLE_TIMING_INDEX) &&
+            (entry.subIndex == MPLX_CYCLE_COUNT_SUBINDEX))
+        {
+            mplxInstance_l.cycleCount = (UINT)cdc_getEntryValue(&entry);
+        }
+        else if ((entry.subIndex == 0) || (entry.subIndex > MPLX_NODE_COUNT))
+        {
+            continue;
+        }
+        else if (entry.index == MPLX_NODE_ASSIGN_INDEX)
+        {
+            pNodeAssign_p[entry.subIndex] = (UINT32)cdc_getEntryValue(&entry);
+        }
+        else if (entry.index == MPLX_CYCLE_ASSIGN_INDEX)
+        {
+            pSlotAssign_p[entry.subIndex] = (UINT8)cdc_getEntryValue(&entry);
+        }
+    }
+}
+
+/// \}
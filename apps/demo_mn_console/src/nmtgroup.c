@@ -0,0 +1,566 @@
+/**
+********************************************************************************
+\file   nmtgroup.c
+
+\brief  NMT group command module of the MN demo application
+
+This file contains the NMT group command module of the MN demo application.
+
+A group command executes an NMT state command (e.g. reset communication) on a
+set of CNs. The command is passed to the NMT state machine of the MN for every
+node of the set, so the MN tracks the state changes it causes. The API of the
+stack does not accept the extended NMT state commands with a node list, so
+every node still costs one asynchronous slot. The command is completed when
+every node of the set has reported the target state of the command through a
+node event, which usually happens within a few cycles after the last node has
+been addressed.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "nmtgroup.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NMTGROUP_TEXT_SIZE          1024        // enough for any node list in range notation
+
+#define NMTGROUP_HAS_NODE(pNodes_p, nodeId_p) \
+    (((pNodes_p)->aBits[(nodeId_p) >> 3] & (1 << ((nodeId_p) & 7))) != 0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Command name
+
+The structure assigns a name to an NMT state command.
+*/
+typedef struct
+{
+    const char*         pszName;                ///< Name of the command
+    tNmtCommand         command;                ///< Plain NMT state command
+} tNmtGroupCommandName;
+
+/**
+\brief  NMT group command instance
+
+The structure contains the preset and the tracking state of the group
+command module. While a command is active, the pending nodes are only
+cleared by the event handler. Nodes which could not be addressed are kept in
+a separate list, so the event handler never shares a byte with the sender.
+*/
+typedef struct
+{
+    BOOL                fPreset;                ///< A preset command is configured
+    tNmtCommand         presetCommand;          ///< Command of the preset
+    tNmtGroupNodeList   presetNodes;            ///< Nodes of the preset
+    volatile BOOL       fActive;                ///< A command is being tracked
+    tNmtCommand         command;                ///< Tracked command
+    tNmtGroupNodeList   pending;                ///< Nodes which have not completed the command
+    tNmtGroupNodeList   unsent;                 ///< Nodes the command could not be passed to
+    UINT                nodeCount;              ///< Number of nodes of the command
+    UINT64              startTime;              ///< Time the command was sent [ns]
+    volatile UINT64     doneTime;               ///< Time the last node completed the command [ns]
+} tNmtGroupInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tNmtGroupInstance            nmtGroupInstance_l;
+
+static const tNmtGroupCommandName   aCommandName_l[] =
+{
+    {"start",       kNmtCmdStartNode},
+    {"stop",        kNmtCmdStopNode},
+    {"preop2",      kNmtCmdEnterPreOperational2},
+    {"readytoop",   kNmtCmdEnableReadyToOperate},
+    {"resetnode",   kNmtCmdResetNode},
+    {"resetcomm",   kNmtCmdResetCommunication},
+    {"resetconf",   kNmtCmdResetConfiguration},
+    {"swreset",     kNmtCmdSwReset}
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static const char* getCommandName(tNmtCommand command_p);
+static BOOL        isCommandDone(tNmtCommand command_p, const tOplkApiEventNode* pNodeEvent_p);
+static UINT        formatNodeList(const tNmtGroupNodeList* pNodes_p, char* pText_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the NMT group command module
+
+The function initializes the NMT group command module and configures the
+preset command. The preset has the format COMMAND:NODES, e.g. resetcomm:1-40.
+
+\param  pszPreset_p             Preset command, may be NULL.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError nmtgroup_init(const char* pszPreset_p)
+{
+    tNmtGroupInstance*  pInst = &nmtGroupInstance_l;
+    const char*         pNodes;
+    size_t              nameLen;
+    UINT                i;
+
+    memset(pInst, 0, sizeof(tNmtGroupInstance));
+
+    if (pszPreset_p == NULL)
+        return kErrorOk;
+
+    pNodes = strchr(pszPreset_p, ':');
+    if (pNodes == NULL)
+    {
+        fprintf(stderr, "Group command %s has no node list!\n", pszPreset_p);
+        return kErrorApiInvalidParam;
+    }
+
+    nameLen = (size_t)(pNodes - pszPreset_p);
+    for (i = 0; i < (sizeof(aCommandName_l) / sizeof(aCommandName_l[0])); i++)
+    {
+        if ((strlen(aCommandName_l[i].pszName) == nameLen) &&
+            (strncmp(aCommandName_l[i].pszName, pszPreset_p, nameLen) == 0))
+            break;
+    }
+
+    if (i == (sizeof(aCommandName_l) / sizeof(aCommandName_l[0])))
+    {
+        fprintf(stderr, "Unknown group command %s!\n", pszPreset_p);
+        return kErrorApiInvalidParam;
+    }
+
+    if (nmtgroup_parseNodeList(pNodes + 1, &pInst->presetNodes) != kErrorOk)
+    {
+        fprintf(stderr, "Invalid node list %s!\n", pNodes + 1);
+        return kErrorApiInvalidParam;
+    }
+
+    pInst->presetCommand = aCommandName_l[i].command;
+    pInst->fPreset = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for a preset command
+
+\return The function returns TRUE if a preset command is configured.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL nmtgroup_hasPreset(void)
+{
+    return nmtGroupInstance_l.fPreset;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute the preset command
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError nmtgroup_execPreset(void)
+{
+    tNmtGroupInstance*  pInst = &nmtGroupInstance_l;
+
+    if (!pInst->fPreset)
+        return kErrorApiInvalidParam;
+
+    return nmtgroup_execCommand(pInst->presetCommand, &pInst->presetNodes);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a node list
+
+The function parses a comma-separated list of node IDs and node ID ranges,
+e.g. 1-40,45.
+
+\param  pList_p                 Text of the node list.
+\param  pNodes_p                Pointer to the node list to fill.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError nmtgroup_parseNodeList(const char* pList_p, tNmtGroupNodeList* pNodes_p)
+{
+    const char*     pPos = pList_p;
+    char*           pEnd;
+    ULONG           firstId;
+    ULONG           lastId;
+
+    memset(pNodes_p, 0, sizeof(tNmtGroupNodeList));
+
+    for (;;)
+    {
+        firstId = strtoul(pPos, &pEnd, 0);
+        if ((pEnd == pPos) || (firstId == 0) || (firstId > NMTGROUP_MAX_NODE_ID))
+            return kErrorApiInvalidParam;
+
+        lastId = firstId;
+        if (*pEnd == '-')
+        {
+            pPos = pEnd + 1;
+            lastId = strtoul(pPos, &pEnd, 0);
+            if ((pEnd == pPos) || (lastId < firstId) || (lastId > NMTGROUP_MAX_NODE_ID))
+                return kErrorApiInvalidParam;
+        }
+
+        for (; firstId <= lastId; firstId++)
+            pNodes_p->aBits[firstId >> 3] |= (UINT8)(1 << (firstId & 7));
+
+        if (*pEnd == '\0')
+            return kErrorOk;
+        if (*pEnd != ',')
+            return kErrorApiInvalidParam;
+        pPos = pEnd + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute an NMT state command on a set of nodes
+
+The function sends an NMT state command to all CNs of the node list and starts
+tracking its completion. Only one group command can be tracked at a time. If
+the command cannot be passed to a node, the remaining nodes are reported and
+skipped, while the nodes which already got the command are still tracked.
+
+\param  command_p               Plain NMT state command (kNmtCmdStartNode to
+                                kNmtCmdSwReset).
+\param  pNodes_p                Nodes to execute the command.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError nmtgroup_execCommand(tNmtCommand command_p, const tNmtGroupNodeList* pNodes_p)
+{
+    tNmtGroupInstance*  pInst = &nmtGroupInstance_l;
+    char                aText[NMTGROUP_TEXT_SIZE];
+    UINT                unsentCount;
+    UINT                nodeId;
+    tOplkError          ret = kErrorOk;
+
+    if (getCommandName(command_p) == NULL)
+        return kErrorApiInvalidParam;
+
+    if (pInst->fActive)
+    {
+        CONSOLE_LOG_WARNING(kConsoleModEvent, "NMT group command %s is still active\n",
+                            getCommandName(pInst->command));
+        return kErrorReject;
+    }
+
+    memset(&pInst->pending, 0, sizeof(tNmtGroupNodeList));
+    memset(&pInst->unsent, 0, sizeof(tNmtGroupNodeList));
+    pInst->nodeCount = 0;
+    for (nodeId = 1; nodeId <= NMTGROUP_MAX_NODE_ID; nodeId++)
+    {
+        if (!NMTGROUP_HAS_NODE(pNodes_p, nodeId))
+            continue;
+
+        pInst->pending.aBits[nodeId >> 3] |= (UINT8)(1 << (nodeId & 7));
+        pInst->nodeCount++;
+    }
+
+    if (pInst->nodeCount == 0)
+        return kErrorApiInvalidParam;
+
+    // tracking starts before the first command, so fast nodes are not missed
+    pInst->command = command_p;
+    pInst->startTime = system_getTimeNs();
+    pInst->doneTime = pInst->startTime;
+    system_memoryBarrier();
+    pInst->fActive = TRUE;
+
+    // after a failure, the remaining nodes are not addressed, the nodes which
+    // already got the command are still tracked
+    for (nodeId = 1; nodeId <= NMTGROUP_MAX_NODE_ID; nodeId++)
+    {
+        if (!NMTGROUP_HAS_NODE(pNodes_p, nodeId))
+            continue;
+
+        if (ret == kErrorOk)
+            ret = oplk_execRemoteNmtCommand(nodeId, command_p);
+        if (ret != kErrorOk)
+            pInst->unsent.aBits[nodeId >> 3] |= (UINT8)(1 << (nodeId & 7));
+    }
+
+    if (ret == kErrorOk)
+    {
+        CONSOLE_LOG_INFO(kConsoleModEvent, "NMT group command %s sent to %u nodes\n",
+                         getCommandName(command_p), pInst->nodeCount);
+        return kErrorOk;
+    }
+
+    unsentCount = formatNodeList(&pInst->unsent, aText);
+    CONSOLE_LOG_ERROR(kConsoleModEvent, "Sending NMT group command %s failed with 0x%X, not sent to %u of %u nodes: %s\n",
+                      getCommandName(command_p), ret, unsentCount, pInst->nodeCount, aText);
+    pInst->nodeCount -= unsentCount;
+    if (pInst->nodeCount == 0)
+        pInst->fActive = FALSE;
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process node events
+
+The function is called by the application event handler for every node event.
+It marks the node as completed if the event reports the target state of the
+active group command.
+
+\param  pNodeEvent_p            Pointer to the node event.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void nmtgroup_processNodeEvent(const tOplkApiEventNode* pNodeEvent_p)
+{
+    tNmtGroupInstance*  pInst = &nmtGroupInstance_l;
+    UINT                nodeId = pNodeEvent_p->nodeId;
+
+    if (!pInst->fActive)
+        return;
+
+    system_memoryBarrier();
+    if ((nodeId == 0) || (nodeId > NMTGROUP_MAX_NODE_ID) ||
+        !NMTGROUP_HAS_NODE(&pInst->pending, nodeId) ||
+        !isCommandDone(pInst->command, pNodeEvent_p))
+        return;
+
+    // the time is published before the node, so it is valid once all nodes are done
+    pInst->doneTime = system_getTimeNs();
+    system_memoryBarrier();
+    pInst->pending.aBits[nodeId >> 3] &= (UINT8)~(1 << (nodeId & 7));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the active group command
+
+The function is called periodically by the main loop. It reports the
+completion of the active group command or the nodes which did not complete it
+in time.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void nmtgroup_process(void)
+{
+    tNmtGroupInstance*  pInst = &nmtGroupInstance_l;
+    tNmtGroupNodeList   pending;
+    char                aText[NMTGROUP_TEXT_SIZE];
+    UINT                pendingCount;
+    UINT                i;
+
+    if (!pInst->fActive)
+        return;
+
+    for (i = 0; i < NMTGROUP_NODE_LIST_SIZE; i++)
+        pending.aBits[i] = pInst->pending.aBits[i] & (UINT8)~pInst->unsent.aBits[i];
+
+    pendingCount = formatNodeList(&pending, aText);
+    system_memoryBarrier();
+    if (pendingCount == 0)
+    {
+        CONSOLE_LOG_INFO(kConsoleModEvent, "NMT group command %s completed on %u nodes in %lu ms\n",
+                         getCommandName(pInst->command), pInst->nodeCount,
+                         (ULONG)((pInst->doneTime - pInst->startTime) / 1000000ULL));
+        pInst->fActive = FALSE;
+    }
+    else if ((system_getTimeNs() - pInst->startTime) > (NMTGROUP_TIMEOUT * 1000000ULL))
+    {
+        CONSOLE_LOG_WARNING(kConsoleModEvent, "NMT group command %s not completed by %u of %u nodes: %s\n",
+                            getCommandName(pInst->command), pendingCount, pInst->nodeCount, aText);
+        pInst->fActive = FALSE;
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the name of a command
+
+\param  command_p               Plain NMT state command.
+
+\return The function returns the name or NULL if the command is no plain
+        NMT state command.
+*/
+//------------------------------------------------------------------------------
+static const char* getCommandName(tNmtCommand command_p)
+{
+    UINT    i;
+
+    for (i = 0; i < (sizeof(aCommandName_l) / sizeof(aCommandName_l[0])); i++)
+    {
+        if (aCommandName_l[i].command == command_p)
+            return aCommandName_l[i].pszName;
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a node event completes a command
+
+A state command is completed when the node reports the target state. A reset
+command is completed when the node has restarted, i.e. it is found again or
+reports an initial state.
+
+\param  command_p               Plain NMT state command.
+\param  pNodeEvent_p            Pointer to the node event.
+
+\return The function returns TRUE if the node has completed the command.
+*/
+//------------------------------------------------------------------------------
+static BOOL isCommandDone(tNmtCommand command_p, const tOplkApiEventNode* pNodeEvent_p)
+{
+    BOOL    fStateEvent = (pNodeEvent_p->nodeEvent == kNmtNodeEventNmtState);
+
+    switch (command_p)
+    {
+        case kNmtCmdStartNode:
+            return fStateEvent && (pNodeEvent_p->nmtState == kNmtCsOperational);
+
+        case kNmtCmdStopNode:
+            return fStateEvent && (pNodeEvent_p->nmtState == kNmtCsStopped);
+
+        case kNmtCmdEnterPreOperational2:
+            return fStateEvent && (pNodeEvent_p->nmtState == kNmtCsPreOperational2);
+
+        case kNmtCmdEnableReadyToOperate:
+            return fStateEvent && (pNodeEvent_p->nmtState == kNmtCsReadyToOperate);
+
+        default:
+            return (pNodeEvent_p->nodeEvent == kNmtNodeEventFound) ||
+                   (fStateEvent && ((pNodeEvent_p->nmtState == kNmtCsNotActive) ||
+                                    (pNodeEvent_p->nmtState == kNmtCsPreOperational1)));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Format a node list
+
+The function formats a node list in range notation, e.g. 1-40,45.
+
+\param  pNodes_p                Node list to format.
+\param  pText_p                 Buffer of NMTGROUP_TEXT_SIZE characters.
+
+\return The function returns the number of nodes in the list.
+*/
+//------------------------------------------------------------------------------
+static UINT formatNodeList(const tNmtGroupNodeList* pNodes_p, char* pText_p)
+{
+    UINT    count = 0;
+    UINT    nodeId;
+    UINT    firstId;
+    char*   pPos = pText_p;
+
+    *pPos = '\0';
+    for (nodeId = 1; nodeId <= NMTGROUP_MAX_NODE_ID; nodeId++)
+    {
+        if (!NMTGROUP_HAS_NODE(pNodes_p, nodeId))
+            continue;
+
+        firstId = nodeId;
+        while ((nodeId < NMTGROUP_MAX_NODE_ID) && NMTGROUP_HAS_NODE(pNodes_p, nodeId + 1))
+            nodeId++;
+
+        if (pPos != pText_p)
+            *pPos++ = ',';
+        if (nodeId == firstId)
+            pPos += sprintf(pPos, "%u", firstId);
+        else
+            pPos += sprintf(pPos, "%u-%u", firstId, nodeId);
+        count += nodeId - firstId + 1;
+    }
+
+    return count;
+}
+
+/// \}
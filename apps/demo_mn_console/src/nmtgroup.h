@@ -0,0 +1,88 @@
+/**
+********************************************************************************
+\file   nmtgroup.h
+
+\brief  Definitions for the NMT group command module
+
+This file contains the definitions for the NMT group commands of the demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_nmtgroup_H_
+#define _INC_nmtgroup_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NMTGROUP_NODE_LIST_SIZE     32      ///< Size of a POWERLINK node list [bytes]
+#define NMTGROUP_MAX_NODE_ID        239     ///< Highest node ID of a CN
+#define NMTGROUP_TIMEOUT            5000    ///< Time for all nodes to complete a command [ms]
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Node list
+
+The structure contains a set of CNs in the POWERLINK node list format, i.e.
+bit (nodeId & 7) of byte (nodeId >> 3) is set for every node in the set.
+*/
+typedef struct
+{
+    UINT8       aBits[NMTGROUP_NODE_LIST_SIZE]; ///< Node bits
+} tNmtGroupNodeList;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError nmtgroup_init(const char* pszPreset_p);
+BOOL       nmtgroup_hasPreset(void);
+tOplkError nmtgroup_execPreset(void);
+tOplkError nmtgroup_parseNodeList(const char* pList_p, tNmtGroupNodeList* pNodes_p);
+tOplkError nmtgroup_execCommand(tNmtCommand command_p, const tNmtGroupNodeList* pNodes_p);
+void       nmtgroup_processNodeEvent(const tOplkApiEventNode* pNodeEvent_p);
+void       nmtgroup_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_nmtgroup_H_ */
@@ -0,0 +1,785 @@
+/**
+********************************************************************************
+\file   objscan.c
+
+\brief  Object scan module of the MN demo application
+
+This file contains the object scan module of the MN demo application.
+
+The object scan reads a list of objects (by default identity, configuration
+date/time and error register) from every CN which has completed its
+configuration, i.e. is ReadyToOperate or Operational. The nodes are read
+concurrently over a bounded pool of SDO channels. Each channel reads all
+objects of its node back-to-back on the same SDO connection and then
+continues with the next node which has not been read yet.
+
+The scan is started by the main loop and continues in the context of the
+event handler: the first requests are issued on a user event, every further
+request on the SDO event of the previous one. None of these calls blocks.
+The result is a table sorted by node ID, index and subindex.
+
+The stack returns an existing SDO connection of a node instead of defining a
+new one. Nodes which are still configured are therefore not scanned, and a
+connection is only freed if its node has stayed configured during the read.
+Otherwise the configuration manager may have taken over the connection.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "objscan.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define OBJSCAN_NO_HANDLE           UINT_MAX    // SDO channel is not open
+#define OBJSCAN_VALUE_SIZE          4           // bytes of an object kept in the result
+#define OBJSCAN_ABORT_TIMEOUT       0x05040000  // SDO protocol timed out
+#define OBJSCAN_ABORT_GENERAL       0x08000000  // general error
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Scanned object
+
+The structure describes an object which is read from every node.
+*/
+typedef struct
+{
+    UINT16              index;                  ///< Index of the object
+    UINT8               subindex;               ///< Subindex of the object
+} tObjScanObject;
+
+/**
+\brief  SDO channel
+
+The structure contains the state of an SDO channel of the pool.
+*/
+typedef struct
+{
+    tSdoComConHdl       sdoHdl;                 ///< Handle of the SDO connection
+    BOOL                fBusy;                  ///< A node is being read
+    UINT                nodeSlot;               ///< Slot of the node being read
+    UINT32              nodeStateCount;         ///< State change count of the node when its read started
+    UINT                objectIdx;              ///< Object being read
+    UINT                size;                   ///< Size of the receive buffer
+    BYTE                aData[OBJSCAN_VALUE_SIZE]; ///< Receive buffer
+} tObjScanChannel;
+
+/**
+\brief  Object scan instance
+
+The structure contains the state of the object scan. While a scan is running,
+the channels, the node slots and the result table are only accessed by the
+event handler.
+*/
+typedef struct
+{
+    tObjScanObject      aObject[OBJSCAN_MAX_OBJECTS]; ///< Objects read from every node, sorted
+    UINT                objectCount;            ///< Number of objects
+    tObjScanEntry*      pTable;                 ///< Result table
+    UINT8               aNodeId[OBJSCAN_MAX_NODE_ID]; ///< Node IDs of the scanned nodes
+    UINT                nodeCount;              ///< Number of scanned nodes
+    UINT                nextSlot;               ///< Slot of the next node to read
+    tObjScanChannel     aChannel[OBJSCAN_CHANNEL_COUNT]; ///< SDO channel pool
+    UINT                readCount;              ///< Number of objects read
+    UINT                abortCount;             ///< Number of objects not read
+    UINT64              startTime;              ///< Start time of the scan [ns]
+    UINT64              endTime;                ///< End time of the scan [ns]
+    volatile BOOL       fRunning;               ///< A scan has been started and not yet reported
+    volatile BOOL       fDone;                  ///< All nodes of the running scan have been read
+    BOOL                fValid;                 ///< The result table contains a complete scan
+    volatile BOOL       aNodeConfigured[OBJSCAN_MAX_NODE_ID];   ///< The node is ReadyToOperate or Operational
+    volatile UINT32     aNodeStateCount[OBJSCAN_MAX_NODE_ID];   ///< Number of times the node left these states
+} tObjScanInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tObjScanInstance     objScanInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseObjects(const char* pList_p);
+static int        compareObject(const void* pLeft_p, const void* pRight_p);
+static void       runChannel(tObjScanChannel* pChannel_p);
+static void       storeResult(tObjScanChannel* pChannel_p, UINT32 abortCode_p, UINT size_p);
+static void       closeChannel(tObjScanChannel* pChannel_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the object scan module
+
+The function initializes the object scan module with the list of objects to
+read. The list contains the objects as INDEX/SUBINDEX or INDEX/FIRST-LAST,
+e.g. 0x1018/1-4,0x1001/0. Only the first 4 bytes of an object are kept.
+
+\param  pszObjects_p            List of objects, NULL for OBJSCAN_DEFAULT_OBJECTS.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError objscan_init(const char* pszObjects_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+
+    memset(pInst, 0, sizeof(tObjScanInstance));
+
+    if (pszObjects_p == NULL)
+        pszObjects_p = OBJSCAN_DEFAULT_OBJECTS;
+
+    if (parseObjects(pszObjects_p) != kErrorOk)
+    {
+        fprintf(stderr, "Invalid object list %s!\n", pszObjects_p);
+        return kErrorApiInvalidParam;
+    }
+
+    pInst->pTable = (tObjScanEntry*)malloc(OBJSCAN_MAX_NODE_ID * pInst->objectCount *
+                                           sizeof(tObjScanEntry));
+    if (pInst->pTable == NULL)
+    {
+        fprintf(stderr, "Unable to allocate the object scan table!\n");
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shutdown the object scan module
+
+The function frees the result table. It must be called after the stack has
+been shut down.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void objscan_exit(void)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+
+    free(pInst->pTable);
+    memset(pInst, 0, sizeof(tObjScanInstance));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start an object scan
+
+The function starts reading the objects of all CNs which have completed their
+configuration. It returns immediately; the completion is reported by
+objscan_process().
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError objscan_start(void)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    tObjScanEntry*      pEntry;
+    UINT                nodeId;
+    UINT                slot;
+    UINT                i;
+    tOplkError          ret;
+
+    if (pInst->pTable == NULL)
+        return kErrorApiNotInitialized;
+
+    if (pInst->fRunning)
+    {
+        CONSOLE_LOG_WARNING(kConsoleModEvent, "Object scan is still running\n");
+        return kErrorReject;
+    }
+
+    pInst->fValid = FALSE;
+    pInst->nodeCount = 0;
+    for (nodeId = 1; nodeId <= OBJSCAN_MAX_NODE_ID; nodeId++)
+    {
+        if (pInst->aNodeConfigured[nodeId - 1])
+            pInst->aNodeId[pInst->nodeCount++] = (UINT8)nodeId;
+    }
+
+    if (pInst->nodeCount == 0)
+    {
+        CONSOLE_LOG_WARNING(kConsoleModEvent, "Object scan: no CN has been configured yet\n");
+        return kErrorOk;
+    }
+
+    pEntry = pInst->pTable;
+    for (slot = 0; slot < pInst->nodeCount; slot++)
+    {
+        for (i = 0; i < pInst->objectCount; i++, pEntry++)
+        {
+            pEntry->nodeId = pInst->aNodeId[slot];
+            pEntry->index = pInst->aObject[i].index;
+            pEntry->subindex = pInst->aObject[i].subindex;
+            pEntry->value = 0;
+            pEntry->abortCode = OBJSCAN_ABORT_GENERAL;
+        }
+    }
+
+    for (i = 0; i < OBJSCAN_CHANNEL_COUNT; i++)
+    {
+        pInst->aChannel[i].sdoHdl = OBJSCAN_NO_HANDLE;
+        pInst->aChannel[i].fBusy = FALSE;
+    }
+
+    pInst->nextSlot = 0;
+    pInst->readCount = 0;
+    pInst->abortCount = 0;
+    pInst->fDone = FALSE;
+    pInst->startTime = system_getTimeNs();
+    system_memoryBarrier();
+    pInst->fRunning = TRUE;
+
+    // the requests are issued by the event handler, which owns the channels
+    ret = oplk_postUserEvent(pInst);
+    if (ret != kErrorOk)
+    {
+        pInst->fRunning = FALSE;
+        CONSOLE_LOG_ERROR(kConsoleModEvent, "Starting the object scan failed with 0x%X\n", ret);
+        return ret;
+    }
+
+    CONSOLE_LOG_INFO(kConsoleModEvent, "Object scan: reading %u objects of %u nodes\n",
+                     pInst->objectCount, pInst->nodeCount);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process node events
+
+The function is called by the application event handler for every node event.
+It tracks which CNs have completed their configuration and counts how often
+they leave this state.
+
+\param  pNodeEvent_p            Pointer to the node event.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void objscan_processNodeEvent(const tOplkApiEventNode* pNodeEvent_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    UINT                nodeId = pNodeEvent_p->nodeId;
+    BOOL                fConfigured;
+
+    if ((pNodeEvent_p->nodeEvent != kNmtNodeEventNmtState) ||
+        (nodeId == 0) || (nodeId > OBJSCAN_MAX_NODE_ID))
+        return;
+
+    fConfigured = (pNodeEvent_p->nmtState == kNmtCsReadyToOperate) ||
+                  (pNodeEvent_p->nmtState == kNmtCsOperational);
+    if (!fConfigured)
+        pInst->aNodeStateCount[nodeId - 1]++;
+
+    system_memoryBarrier();
+    pInst->aNodeConfigured[nodeId - 1] = fConfigured;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SDO events
+
+The function is called by the application event handler for every SDO event.
+It stores the result of a finished read and issues the next request on the
+channel.
+
+\param  pSdo_p                  Pointer to the SDO event.
+
+\return The function returns TRUE if the event belongs to the object scan.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL objscan_processSdoEvent(const tSdoComFinished* pSdo_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    tObjScanChannel*    pChannel = NULL;
+    UINT                i;
+
+    if (!pInst->fRunning)
+        return FALSE;
+
+    for (i = 0; i < OBJSCAN_CHANNEL_COUNT; i++)
+    {
+        if (pSdo_p->pUserArg == &pInst->aChannel[i])
+            pChannel = &pInst->aChannel[i];
+    }
+
+    if ((pChannel == NULL) || !pChannel->fBusy)
+        return FALSE;
+
+    switch (pSdo_p->sdoComConState)
+    {
+        case kSdoComTransferFinished:
+            storeResult(pChannel, 0, pSdo_p->transferredBytes);
+            pChannel->objectIdx++;
+            break;
+
+        case kSdoComTransferLowerLayerAbort:
+            // the node does not respond, its other objects would time out as well
+            for (; pChannel->objectIdx < pInst->objectCount; pChannel->objectIdx++)
+                storeResult(pChannel, OBJSCAN_ABORT_TIMEOUT, 0);
+            break;
+
+        default:
+            storeResult(pChannel, (pSdo_p->abortCode != 0) ? pSdo_p->abortCode : OBJSCAN_ABORT_GENERAL, 0);
+            pChannel->objectIdx++;
+            break;
+    }
+
+    runChannel(pChannel);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process user events
+
+The function is called by the application event handler for every user event.
+It issues the first requests of a started scan on all channels of the pool.
+
+\param  pUserArg_p              User argument of the event.
+
+\return The function returns TRUE if the event belongs to the object scan.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL objscan_processUserEvent(void* pUserArg_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    UINT                i;
+
+    if (pUserArg_p != pInst)
+        return FALSE;
+
+    system_memoryBarrier();
+    for (i = 0; i < OBJSCAN_CHANNEL_COUNT; i++)
+        runChannel(&pInst->aChannel[i]);
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the running scan
+
+The function is called periodically by the main loop. It prints the result
+when the running scan has completed.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void objscan_process(void)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+
+    if (!pInst->fRunning || !pInst->fDone)
+        return;
+
+    system_memoryBarrier();
+    pInst->fValid = TRUE;
+    pInst->fRunning = FALSE;
+    objscan_printResult();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find an entry of the scan result
+
+\param  nodeId_p                Node ID of the CN.
+\param  index_p                 Index of the object.
+\param  subindex_p              Subindex of the object.
+
+\return The function returns the entry or NULL if the object has not been
+        scanned or no complete scan is available.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const tObjScanEntry* objscan_findEntry(UINT nodeId_p, UINT index_p, UINT subindex_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    const tObjScanEntry* pEntry;
+    UINT32              key = ((UINT32)nodeId_p << 24) | ((UINT32)index_p << 8) | subindex_p;
+    UINT32              entryKey;
+    UINT                low = 0;
+    UINT                high;
+    UINT                mid;
+
+    if (!pInst->fValid)
+        return NULL;
+
+    high = pInst->nodeCount * pInst->objectCount;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        pEntry = &pInst->pTable[mid];
+        entryKey = ((UINT32)pEntry->nodeId << 24) | ((UINT32)pEntry->index << 8) | pEntry->subindex;
+        if (entryKey == key)
+            return pEntry;
+
+        if (entryKey < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the scan result
+
+The function prints the result of the last complete scan as a table with one
+row per node. Objects which could not be read are shown as dashes, the row
+ends with the first abort code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void objscan_printResult(void)
+{
+    tObjScanInstance*       pInst = &objScanInstance_l;
+    const tObjScanEntry*    pEntry;
+    UINT32                  abortCode;
+    UINT                    slot;
+    UINT                    i;
+
+    if (!pInst->fValid)
+        return;
+
+    printf("Object scan of %u nodes completed in %lu ms: %u objects read, %u not read\n",
+           pInst->nodeCount, (ULONG)((pInst->endTime - pInst->startTime) / 1000000ULL),
+           pInst->readCount, pInst->abortCount);
+
+    printf("  Node");
+    for (i = 0; i < pInst->objectCount; i++)
+        printf("  %04X/%-3u", pInst->aObject[i].index, pInst->aObject[i].subindex);
+    printf("\n");
+
+    pEntry = pInst->pTable;
+    for (slot = 0; slot < pInst->nodeCount; slot++)
+    {
+        abortCode = 0;
+        printf("  %4u", pInst->aNodeId[slot]);
+        for (i = 0; i < pInst->objectCount; i++, pEntry++)
+        {
+            if (pEntry->abortCode == 0)
+            {
+                printf("  %08lX", (ULONG)pEntry->value);
+                continue;
+            }
+
+            printf("  --------");
+            if (abortCode == 0)
+                abortCode = pEntry->abortCode;
+        }
+
+        if (abortCode != 0)
+            printf("  (abort 0x%08lX)", (ULONG)abortCode);
+        printf("\n");
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse the object list
+
+\param  pList_p                 Text of the object list.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseObjects(const char* pList_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    const char*         pPos = pList_p;
+    char*               pEnd;
+    ULONG               index;
+    ULONG               firstSub;
+    ULONG               lastSub;
+    UINT                i;
+
+    for (;;)
+    {
+        index = strtoul(pPos, &pEnd, 0);
+        if ((pEnd == pPos) || (index == 0) || (index > 0xFFFF) || (*pEnd != '/'))
+            return kErrorApiInvalidParam;
+
+        pPos = pEnd + 1;
+        firstSub = strtoul(pPos, &pEnd, 0);
+        if ((pEnd == pPos) || (firstSub > 0xFF))
+            return kErrorApiInvalidParam;
+
+        lastSub = firstSub;
+        if (*pEnd == '-')
+        {
+            pPos = pEnd + 1;
+            lastSub = strtoul(pPos, &pEnd, 0);
+            if ((pEnd == pPos) || (lastSub < firstSub) || (lastSub > 0xFF))
+                return kErrorApiInvalidParam;
+        }
+
+        for (; firstSub <= lastSub; firstSub++)
+        {
+            if (pInst->objectCount == OBJSCAN_MAX_OBJECTS)
+                return kErrorApiInvalidParam;
+
+            pInst->aObject[pInst->objectCount].index = (UINT16)index;
+            pInst->aObject[pInst->objectCount].subindex = (UINT8)firstSub;
+            pInst->objectCount++;
+        }
+
+        if (*pEnd == '\0')
+            break;
+        if (*pEnd != ',')
+            return kErrorApiInvalidParam;
+        pPos = pEnd + 1;
+    }
+
+    // the result table is sorted if the objects are
+    qsort(pInst->aObject, pInst->objectCount, sizeof(tObjScanObject), compareObject);
+    for (i = 1; i < pInst->objectCount; i++)
+    {
+        if (compareObject(&pInst->aObject[i - 1], &pInst->aObject[i]) == 0)
+            return kErrorApiInvalidParam;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare two objects
+
+\param  pLeft_p                 Pointer to the first object.
+\param  pRight_p                Pointer to the second object.
+
+\return The function returns the order of the objects for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareObject(const void* pLeft_p, const void* pRight_p)
+{
+    const tObjScanObject*   pLeft = (const tObjScanObject*)pLeft_p;
+    const tObjScanObject*   pRight = (const tObjScanObject*)pRight_p;
+    UINT32                  leftKey = ((UINT32)pLeft->index << 8) | pLeft->subindex;
+    UINT32                  rightKey = ((UINT32)pRight->index << 8) | pRight->subindex;
+
+    if (leftKey < rightKey)
+        return -1;
+
+    return (leftKey > rightKey) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run an SDO channel
+
+The function issues the next read request of a channel. When all objects of
+its node have been read, the channel continues with the next node. The
+function returns when a request is pending or no node is left.
+
+\param  pChannel_p              Pointer to the channel.
+*/
+//------------------------------------------------------------------------------
+static void runChannel(tObjScanChannel* pChannel_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    tObjScanObject*     pObject;
+    tOplkError          ret;
+    UINT                i;
+
+    for (;;)
+    {
+        if (pChannel_p->fBusy && (pChannel_p->objectIdx >= pInst->objectCount))
+        {
+            closeChannel(pChannel_p);
+            pChannel_p->fBusy = FALSE;
+        }
+
+        if (!pChannel_p->fBusy)
+        {
+            if (pInst->nextSlot >= pInst->nodeCount)
+                break;
+
+            pChannel_p->nodeSlot = pInst->nextSlot++;
+            pChannel_p->nodeStateCount = pInst->aNodeStateCount[pInst->aNodeId[pChannel_p->nodeSlot] - 1];
+            pChannel_p->objectIdx = 0;
+            pChannel_p->fBusy = TRUE;
+
+            // a node which is configured again since the start is skipped
+            if (!pInst->aNodeConfigured[pInst->aNodeId[pChannel_p->nodeSlot] - 1])
+            {
+                for (; pChannel_p->objectIdx < pInst->objectCount; pChannel_p->objectIdx++)
+                    storeResult(pChannel_p, OBJSCAN_ABORT_GENERAL, 0);
+                continue;
+            }
+        }
+
+        // the objects of a node are read back-to-back on the same connection
+        pObject = &pInst->aObject[pChannel_p->objectIdx];
+        pChannel_p->size = sizeof(pChannel_p->aData);
+        memset(pChannel_p->aData, 0, sizeof(pChannel_p->aData));
+        ret = oplk_readObject(&pChannel_p->sdoHdl, pInst->aNodeId[pChannel_p->nodeSlot],
+                              pObject->index, pObject->subindex, pChannel_p->aData,
+                              &pChannel_p->size, kSdoTypeAsnd, pChannel_p);
+        if (ret == kErrorApiTaskDeferred)
+            return;
+
+        storeResult(pChannel_p, (ret == kErrorOk) ? 0 : OBJSCAN_ABORT_GENERAL, pChannel_p->size);
+        pChannel_p->objectIdx++;
+    }
+
+    for (i = 0; i < OBJSCAN_CHANNEL_COUNT; i++)
+    {
+        if (pInst->aChannel[i].fBusy)
+            return;
+    }
+
+    if (!pInst->fDone)
+    {
+        pInst->endTime = system_getTimeNs();
+        system_memoryBarrier();
+        pInst->fDone = TRUE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Store the result of a read request
+
+\param  pChannel_p              Pointer to the channel.
+\param  abortCode_p             SDO abort code, 0 if the object has been read.
+\param  size_p                  Number of bytes read.
+*/
+//------------------------------------------------------------------------------
+static void storeResult(tObjScanChannel* pChannel_p, UINT32 abortCode_p, UINT size_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    tObjScanEntry*      pEntry;
+    UINT32              value = 0;
+    UINT                i;
+
+    pEntry = &pInst->pTable[(pChannel_p->nodeSlot * pInst->objectCount) + pChannel_p->objectIdx];
+    pEntry->abortCode = abortCode_p;
+    if (abortCode_p != 0)
+    {
+        pInst->abortCount++;
+        return;
+    }
+
+    // objects are transferred in little endian
+    if (size_p > OBJSCAN_VALUE_SIZE)
+        size_p = OBJSCAN_VALUE_SIZE;
+    for (i = size_p; i > 0; i--)
+        value = (value << 8) | pChannel_p->aData[i - 1];
+
+    pEntry->value = value;
+    pInst->readCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close the SDO connection of a channel
+
+The connection has been defined by the channel if its node has stayed
+configured during the read. If the node has been reset in the meantime, the
+configuration manager may use the same connection, so it is left to it.
+
+\param  pChannel_p              Pointer to the channel.
+*/
+//------------------------------------------------------------------------------
+static void closeChannel(tObjScanChannel* pChannel_p)
+{
+    tObjScanInstance*   pInst = &objScanInstance_l;
+    UINT                nodeId = pInst->aNodeId[pChannel_p->nodeSlot];
+
+    if (pChannel_p->sdoHdl == OBJSCAN_NO_HANDLE)
+        return;
+
+    if (pInst->aNodeStateCount[nodeId - 1] == pChannel_p->nodeStateCount)
+        oplk_freeSdoChannel(pChannel_p->sdoHdl);
+    pChannel_p->sdoHdl = OBJSCAN_NO_HANDLE;
+}
+
+/// \}
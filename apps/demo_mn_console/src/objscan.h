@@ -0,0 +1,95 @@
+/**
+********************************************************************************
+\file   objscan.h
+
+\brief  Definitions for the object scan module
+
+This file contains the definitions for the network-wide object scan of the
+demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_objscan_H_
+#define _INC_objscan_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define OBJSCAN_MAX_NODE_ID         239     ///< Highest node ID of a CN
+#define OBJSCAN_MAX_OBJECTS         32      ///< Maximum number of objects read from each node
+#define OBJSCAN_CHANNEL_COUNT       8       ///< Number of SDO channels used concurrently
+#define OBJSCAN_DEFAULT_OBJECTS     "0x1018/1-4,0x1020/1-2,0x1001/0"    ///< Identity, configuration date/time, error register
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Object scan entry
+
+The structure contains the result of reading an object of a node. The entries
+of the result table are sorted by node ID, index and subindex.
+*/
+typedef struct
+{
+    UINT8       nodeId;                     ///< Node ID of the CN
+    UINT8       subindex;                   ///< Subindex of the object
+    UINT16      index;                      ///< Index of the object
+    UINT32      value;                      ///< Value of the object (first 4 bytes)
+    UINT32      abortCode;                  ///< SDO abort code, 0 if the object has been read
+} tObjScanEntry;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError           objscan_init(const char* pszObjects_p);
+void                 objscan_exit(void);
+tOplkError           objscan_start(void);
+void                 objscan_processNodeEvent(const tOplkApiEventNode* pNodeEvent_p);
+BOOL                 objscan_processSdoEvent(const tSdoComFinished* pSdo_p);
+BOOL                 objscan_processUserEvent(void* pUserArg_p);
+void                 objscan_process(void);
+const tObjScanEntry* objscan_findEntry(UINT nodeId_p, UINT index_p, UINT subindex_p);
+void                 objscan_printResult(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_objscan_H_ */
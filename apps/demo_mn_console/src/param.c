@@ -0,0 +1,732 @@
+/**
+********************************************************************************
+\file   param.c
+
+\brief  Runtime parameters of the MN demo application
+
+This file contains the runtime parameters of the MN demo application. The
+parameters are read from a file, which is watched for changes while the
+application is running. A changed file is reloaded and validated. Valid
+parameters are handed over to the synchronous data handler at the next cycle,
+invalid ones are reported and the current parameters are kept.
+
+The file contains one parameter per line, '#' starts a comment:
+
+    nodes           1,32,110            # nodes driven by the running light
+    ledPeriodScale  20                  # cycles per input count of the light period
+    safeOutput      0x00                # output value of nodes without valid data
+    log             all=info,cfm=debug  # log levels, see console_parseloglevels()
+    logLimit        10 10               # log rate limit: burst and window [s]
+    pid             TIC1 setpoint 85.0  # setpoint of a control loop
+    pid             TIC1 tuning 2,0.5,0.1   # gains kp, ki [1/s] and kd [s] of a loop
+    pid             TIC1 enable         # enable (or disable) a control loop
+
+Parameters which are not given use their defaults (all nodes, 20, 0x00). The
+log settings are left unchanged if they are not given. The settings of the
+control loops are passed to the controller bank when they differ from the
+ones applied before; a loop keeps its state if its setting is removed.
+
+The synchronous data handler never waits for the loader. The parameters are
+kept in two sets, the one in use and a spare one. The loader fills the spare
+set and publishes a pointer to it. At the beginning of the next cycle the
+handler takes over the published set, the previous set becomes the spare set.
+It is only filled again after the handler has taken over the published set, so
+a set is never modified while it is in use.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "param.h"
+#include "pid.h"
+#include "threadstat.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PARAM_LINE_LEN                  256     // maximum length of a line in the file
+#define PARAM_MAX_LED_PERIOD_SCALE      10000   // maximum cycles per input count of the running light
+#define PARAM_MAX_PID_SETTINGS          64      // maximum number of control loop settings
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Control loop setting types
+
+The enumeration lists the settings of a control loop in the parameter file.
+*/
+typedef enum
+{
+    kParamPidEnable = 0,                            ///< Enable or disable the loop
+    kParamPidSetpoint,                              ///< Setpoint of the loop
+    kParamPidTuning                                 ///< Gains of the loop
+} tParamPidType;
+
+/**
+\brief  Control loop setting
+
+The structure contains a setting of a control loop.
+*/
+typedef struct
+{
+    UINT            loop;                           ///< Index of the loop
+    tParamPidType   type;                           ///< Setting type
+    float           aValue[3];                      ///< Setting values
+} tParamPid;
+
+/**
+\brief  Parameter file contents
+
+The structure contains the parameters read from the file.
+*/
+typedef struct
+{
+    tParamSet       set;                            ///< Parameters of the synchronous data handler
+    char            aLogLevels[PARAM_LINE_LEN];     ///< Log level specification ("" = unchanged)
+    UINT            logBurst;                       ///< Log rate limiting burst (0 = unchanged)
+    UINT            logWindow;                      ///< Log rate limiting window [s]
+    tParamPid       aPid[PARAM_MAX_PID_SETTINGS];   ///< Control loop settings
+    UINT            pidCount;                       ///< Number of control loop settings
+} tParamFile;
+
+/**
+\brief  Runtime parameter instance
+
+The structure contains the parameter sets and the state of the file watcher.
+*/
+typedef struct
+{
+    tParamSet                   aSet[2];        ///< Set in use and spare set
+    const tParamSet* volatile   pCurrent;       ///< Set in use, written by the synchronous data handler
+    const tParamSet* volatile   pPending;       ///< Published set, taken over at the next cycle
+    const char*                 pszFileName;    ///< Name of the parameter file
+    tSystemThread               watchThread;    ///< File watcher thread
+    BOOL                        fWatching;      ///< The file watcher thread is running
+    volatile BOOL               fExit;          ///< Request to stop the file watcher thread
+    tParamPid                   aPid[PARAM_MAX_PID_SETTINGS]; ///< Control loop settings applied last
+    UINT                        pidCount;       ///< Number of control loop settings applied last
+} tParamInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tParamInstance   paramInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void       watchFile(void* pArg_p);
+static void       reload(tParamInstance* pInst_p);
+static tOplkError loadFile(const char* pszFileName_p, tParamFile* pFile_p);
+static tOplkError parseLine(char* pLine_p, tParamFile* pFile_p);
+static tOplkError parseNodes(const char* pList_p, tParamSet* pSet_p);
+static tOplkError parsePid(char** apToken_p, UINT tokenCount_p, tParamFile* pFile_p);
+static tOplkError applyLogSettings(const tParamFile* pFile_p);
+static void       applyPidSettings(tParamInstance* pInst_p, const tParamFile* pFile_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the runtime parameters
+
+The function loads the parameter file and starts watching it for changes.
+Without a file, the default parameters are used. The function must be called
+before the synchronous data exchange is started.
+
+\param  pszFileName_p           File name of the parameters, may be NULL.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError param_init(const char* pszFileName_p)
+{
+    tParamInstance*     pInst = &paramInstance_l;
+    tParamFile          file;
+    tOplkError          ret;
+
+    memset(pInst, 0, sizeof(tParamInstance));
+
+    if (pszFileName_p == NULL)
+    {
+        loadFile(NULL, &file);
+    }
+    else
+    {
+        ret = loadFile(pszFileName_p, &file);
+        if (ret == kErrorOk)
+            ret = applyLogSettings(&file);
+        if (ret != kErrorOk)
+            return ret;
+        applyPidSettings(pInst, &file);
+    }
+
+    memcpy(&pInst->aSet[0], &file.set, sizeof(tParamSet));
+    pInst->pCurrent = &pInst->aSet[0];
+
+    if (pszFileName_p == NULL)
+        return kErrorOk;
+
+    pInst->pszFileName = pszFileName_p;
+    if (system_createThread(watchFile, pInst, &pInst->watchThread) != 0)
+    {
+        fprintf(stderr, "Unable to watch runtime parameters %s!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+    pInst->fWatching = TRUE;
+
+    printf("Runtime parameters loaded from %s, watching for changes\n", pszFileName_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down the runtime parameters
+
+The function stops watching the parameter file.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void param_exit(void)
+{
+    tParamInstance*     pInst = &paramInstance_l;
+
+    if (!pInst->fWatching)
+        return;
+
+    pInst->fExit = TRUE;
+    system_joinThread(&pInst->watchThread);
+    pInst->fWatching = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the parameters of the cycle
+
+The function is called by the synchronous data handler at the beginning of
+each cycle. It takes over a newly published parameter set and returns the set
+to use in this cycle. The returned set stays valid until the next call.
+
+\return The function returns a pointer to the parameter set of the cycle.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const tParamSet* param_syncEvent(void)
+{
+    tParamInstance*     pInst = &paramInstance_l;
+
+    if (pInst->pPending != NULL)
+    {
+        system_memoryBarrier();
+        pInst->pCurrent = pInst->pPending;
+        system_memoryBarrier();
+        pInst->pPending = NULL;
+    }
+
+    return pInst->pCurrent;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  File watcher thread
+
+The thread waits for changes of the parameter file. Editors often write a file
+in several steps, so the file is reloaded when it has not changed for
+PARAM_SETTLE_TIME. A reload is deferred until the synchronous data handler
+has taken over the previously published set.
+
+\param  pArg_p                  Pointer to the parameter instance.
+*/
+//------------------------------------------------------------------------------
+static void watchFile(void* pArg_p)
+{
+    tParamInstance*     pInst = (tParamInstance*)pArg_p;
+    tSystemFileWatch    watch;
+    BOOL                fChanged = FALSE;
+    int                 ret;
+
+    if (system_openFileWatch(pInst->pszFileName, &watch) != 0)
+    {
+        CONSOLE_LOG_ERROR(kConsoleModSystem, "Unable to watch %s, runtime parameters are not reloaded!\n",
+                          pInst->pszFileName);
+        return;
+    }
+
+    while (!pInst->fExit)
+    {
+        threadstat_enter(kThreadStatRoleParam);
+        ret = system_waitFileWatch(&watch, PARAM_SETTLE_TIME);
+        if (ret < 0)
+        {
+            CONSOLE_LOG_ERROR(kConsoleModSystem, "Watching %s failed, runtime parameters are not reloaded!\n",
+                              pInst->pszFileName);
+            break;
+        }
+
+        if (ret > 0)
+        {
+            fChanged = TRUE;
+            continue;
+        }
+
+        if (fChanged && (pInst->pPending == NULL))
+        {
+            fChanged = FALSE;
+            reload(pInst);
+        }
+    }
+
+    system_closeFileWatch(&watch);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reload the parameter file
+
+The function loads and validates the parameter file. The log settings are
+applied immediately, the parameters of the synchronous data handler are
+published in the spare set if they have changed.
+
+\param  pInst_p                 Pointer to the parameter instance.
+*/
+//------------------------------------------------------------------------------
+static void reload(tParamInstance* pInst_p)
+{
+    tParamFile          file;
+    tParamSet*          pSpare;
+
+    if ((loadFile(pInst_p->pszFileName, &file) != kErrorOk) ||
+        (applyLogSettings(&file) != kErrorOk))
+    {
+        CONSOLE_LOG_ERROR(kConsoleModSystem, "Runtime parameters %s are invalid, keeping the current ones\n",
+                          pInst_p->pszFileName);
+        return;
+    }
+
+    applyPidSettings(pInst_p, &file);
+
+    // the handler has taken over the last published set, so it uses the
+    // current set and the other one is free
+    system_memoryBarrier();
+    if (memcmp(&file.set, pInst_p->pCurrent, sizeof(tParamSet)) != 0)
+    {
+        pSpare = (pInst_p->pCurrent == &pInst_p->aSet[0]) ? &pInst_p->aSet[1] : &pInst_p->aSet[0];
+        memcpy(pSpare, &file.set, sizeof(tParamSet));
+        system_memoryBarrier();
+        pInst_p->pPending = pSpare;
+    }
+
+    CONSOLE_LOG_INFO(kConsoleModSystem, "Runtime parameters reloaded from %s\n", pInst_p->pszFileName);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load the parameter file
+
+The function reads the parameter file. Parameters which are not contained in
+the file are set to their defaults.
+
+\param  pszFileName_p           File name of the parameters, NULL only sets
+                                the defaults.
+\param  pFile_p                 Pointer to store the parameters.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError loadFile(const char* pszFileName_p, tParamFile* pFile_p)
+{
+    FILE*           pFile;
+    char            aLine[PARAM_LINE_LEN];
+    UINT            lineNo = 0;
+    tOplkError      ret = kErrorOk;
+
+    // the sets are compared with memcmp(), so the padding is cleared as well
+    memset(pFile_p, 0, sizeof(tParamFile));
+    memset(pFile_p->set.aNodeMask, 0xFF, sizeof(pFile_p->set.aNodeMask));
+    pFile_p->set.ledPeriodScale = PARAM_DEFAULT_LED_PERIOD_SCALE;
+    pFile_p->set.safeOutput = PARAM_DEFAULT_SAFE_OUTPUT;
+
+    if (pszFileName_p == NULL)
+        return kErrorOk;
+
+    pFile = fopen(pszFileName_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open runtime parameters %s!\n", pszFileName_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        ret = parseLine(aLine, pFile_p);
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+        fprintf(stderr, "Invalid runtime parameter in line %u of %s!\n", lineNo, pszFileName_p);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a line of the parameter file
+
+\param  pLine_p                 Pointer to the line, it is modified.
+\param  pFile_p                 Pointer to store the parameter.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p, tParamFile* pFile_p)
+{
+    char*           apToken[4];
+    char*           pToken;
+    char*           pComment;
+    char*           pEnd = "";
+    UINT            tokenCount = 0;
+    ULONG           value;
+    ULONG           window = 0;
+
+    pComment = strchr(pLine_p, '#');
+    if (pComment != NULL)
+        *pComment = '\0';
+
+    for (pToken = strtok(pLine_p, " \t\r\n"); pToken != NULL; pToken = strtok(NULL, " \t\r\n"))
+    {
+        if (tokenCount >= 4)
+            return kErrorApiInvalidParam;
+        apToken[tokenCount++] = pToken;
+    }
+
+    if (tokenCount == 0)
+        return kErrorOk;
+
+    if ((strcmp(apToken[0], "nodes") == 0) && (tokenCount == 2))
+        return parseNodes(apToken[1], &pFile_p->set);
+
+    if ((strcmp(apToken[0], "ledPeriodScale") == 0) && (tokenCount == 2))
+    {
+        value = strtoul(apToken[1], &pEnd, 0);
+        if ((*pEnd != '\0') || (value == 0) || (value > PARAM_MAX_LED_PERIOD_SCALE))
+            return kErrorApiInvalidParam;
+
+        pFile_p->set.ledPeriodScale = (UINT)value;
+        return kErrorOk;
+    }
+
+    if ((strcmp(apToken[0], "safeOutput") == 0) && (tokenCount == 2))
+    {
+        value = strtoul(apToken[1], &pEnd, 0);
+        if ((*pEnd != '\0') || (value > 0xFF))
+            return kErrorApiInvalidParam;
+
+        pFile_p->set.safeOutput = (UINT8)value;
+        return kErrorOk;
+    }
+
+    if ((strcmp(apToken[0], "log") == 0) && (tokenCount == 2))
+    {
+        strncpy(pFile_p->aLogLevels, apToken[1], sizeof(pFile_p->aLogLevels) - 1);
+        return kErrorOk;
+    }
+
+    if ((strcmp(apToken[0], "pid") == 0) && (tokenCount >= 3))
+        return parsePid(apToken, tokenCount, pFile_p);
+
+    if ((strcmp(apToken[0], "logLimit") == 0) && (tokenCount == 3))
+    {
+        value = strtoul(apToken[1], &pEnd, 0);
+        if (*pEnd == '\0')
+            window = strtoul(apToken[2], &pEnd, 0);
+        if ((*pEnd != '\0') || (value == 0) || (window == 0))
+            return kErrorApiInvalidParam;
+
+        pFile_p->logBurst = (UINT)value;
+        pFile_p->logWindow = (UINT)window;
+        return kErrorOk;
+    }
+
+    return kErrorApiInvalidParam;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse the node list
+
+The function parses a comma separated list of node IDs or "none".
+
+\param  pList_p                 Pointer to the node list.
+\param  pSet_p                  Pointer to the parameter set to fill.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseNodes(const char* pList_p, tParamSet* pSet_p)
+{
+    const char*     pPos = pList_p;
+    char*           pEnd;
+    ULONG           nodeId;
+
+    memset(pSet_p->aNodeMask, 0, sizeof(pSet_p->aNodeMask));
+    if (strcmp(pList_p, "none") == 0)
+        return kErrorOk;
+
+    for (;;)
+    {
+        nodeId = strtoul(pPos, &pEnd, 0);
+        if ((pEnd == pPos) || (nodeId == 0) || (nodeId > PARAM_MAX_NODE_ID))
+            return kErrorApiInvalidParam;
+
+        pSet_p->aNodeMask[nodeId >> 5] |= (UINT32)1 << (nodeId & 31);
+
+        if (*pEnd == '\0')
+            return kErrorOk;
+        if (*pEnd != ',')
+            return kErrorApiInvalidParam;
+        pPos = pEnd + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a control loop setting
+
+The function parses the tokens of a "pid" line. A later setting of the same
+type for the same loop replaces the earlier one.
+
+\param  apToken_p               Tokens of the line.
+\param  tokenCount_p            Number of tokens.
+\param  pFile_p                 Pointer to store the setting.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parsePid(char** apToken_p, UINT tokenCount_p, tParamFile* pFile_p)
+{
+    tParamPid       setting;
+    char*           pEnd = "";
+    int             loop;
+    UINT            i;
+
+    memset(&setting, 0, sizeof(setting));
+
+    loop = pid_findLoop(apToken_p[1]);
+    if (loop < 0)
+    {
+        fprintf(stderr, "Unknown control loop %s!\n", apToken_p[1]);
+        return kErrorApiInvalidParam;
+    }
+    setting.loop = (UINT)loop;
+
+    if (((strcmp(apToken_p[2], "enable") == 0) || (strcmp(apToken_p[2], "disable") == 0)) &&
+        (tokenCount_p == 3))
+    {
+        setting.type = kParamPidEnable;
+        setting.aValue[0] = (strcmp(apToken_p[2], "enable") == 0) ? 1.0f : 0.0f;
+    }
+    else if ((strcmp(apToken_p[2], "setpoint") == 0) && (tokenCount_p == 4))
+    {
+        setting.type = kParamPidSetpoint;
+        setting.aValue[0] = (float)strtod(apToken_p[3], &pEnd);
+    }
+    else if ((strcmp(apToken_p[2], "tuning") == 0) && (tokenCount_p == 4))
+    {
+        setting.type = kParamPidTuning;
+        pEnd = apToken_p[3];
+        for (i = 0; i < 3; i++)
+        {
+            setting.aValue[i] = (float)strtod(pEnd, &pEnd);
+            if ((i < 2) && (*pEnd++ != ','))
+                return kErrorApiInvalidParam;
+        }
+    }
+    else
+    {
+        return kErrorApiInvalidParam;
+    }
+
+    if (*pEnd != '\0')
+        return kErrorApiInvalidParam;
+
+    for (i = 0; i < pFile_p->pidCount; i++)
+    {
+        if ((pFile_p->aPid[i].loop == setting.loop) && (pFile_p->aPid[i].type == setting.type))
+            break;
+    }
+
+    if (i >= PARAM_MAX_PID_SETTINGS)
+        return kErrorNoResource;
+
+    pFile_p->aPid[i] = setting;
+    if (i == pFile_p->pidCount)
+        pFile_p->pidCount++;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the log settings
+
+The function applies the log settings of the parameter file. If the log level
+specification is invalid, the previous levels are restored.
+
+\param  pFile_p                 Pointer to the parameters.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError applyLogSettings(const tParamFile* pFile_p)
+{
+    int     aLevel[kConsoleModCount];
+    int     i;
+
+    if (pFile_p->aLogLevels[0] != '\0')
+    {
+        for (i = 0; i < kConsoleModCount; i++)
+            aLevel[i] = console_getloglevel((tConsoleModule)i);
+
+        if (console_parseloglevels(pFile_p->aLogLevels) != 0)
+        {
+            for (i = 0; i < kConsoleModCount; i++)
+                console_setloglevel((tConsoleModule)i, aLevel[i]);
+
+            fprintf(stderr, "Invalid log levels %s!\n", pFile_p->aLogLevels);
+            return kErrorApiInvalidParam;
+        }
+    }
+
+    if (pFile_p->logBurst != 0)
+        console_setloglimit(pFile_p->logBurst, pFile_p->logWindow);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the control loop settings
+
+The function passes the settings of the control loops which differ from the
+ones applied before to the controller bank. The bank applies them at the next
+cycle.
+
+\param  pInst_p                 Pointer to the parameter instance.
+\param  pFile_p                 Pointer to the parameters.
+*/
+//------------------------------------------------------------------------------
+static void applyPidSettings(tParamInstance* pInst_p, const tParamFile* pFile_p)
+{
+    const tParamPid*    pSetting;
+    tOplkError          ret;
+    UINT                i;
+    UINT                j;
+
+    for (i = 0; i < pFile_p->pidCount; i++)
+    {
+        pSetting = &pFile_p->aPid[i];
+        for (j = 0; j < pInst_p->pidCount; j++)
+        {
+            if (memcmp(pSetting, &pInst_p->aPid[j], sizeof(tParamPid)) == 0)
+                break;
+        }
+        if (j < pInst_p->pidCount)
+            continue;
+
+        switch (pSetting->type)
+        {
+            case kParamPidEnable:
+                ret = pid_setEnable(pSetting->loop, (pSetting->aValue[0] != 0.0f));
+                break;
+
+            case kParamPidSetpoint:
+                ret = pid_setSetpoint(pSetting->loop, pSetting->aValue[0]);
+                break;
+
+            default:
+                ret = pid_setTuning(pSetting->loop, pSetting->aValue[0], pSetting->aValue[1],
+                                    pSetting->aValue[2]);
+                break;
+        }
+
+        if (ret != kErrorOk)
+            CONSOLE_LOG_WARNING(kConsoleModSystem, "Control loop setting %u of the runtime parameters not applied (0x%X)\n",
+                                i, ret);
+    }
+
+    memcpy(pInst_p->aPid, pFile_p->aPid, sizeof(pInst_p->aPid));
+    pInst_p->pidCount = pFile_p->pidCount;
+}
+
+/// \}
@@ -0,0 +1,99 @@
+/**
+********************************************************************************
+\file   param.h
+
+\brief  Definitions for the runtime parameters
+
+The file contains the definitions for the runtime parameters of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_param_H_
+#define _INC_param_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PARAM_MAX_NODE_ID               239     ///< Highest node ID of the node list
+#define PARAM_NODE_WORDS                ((PARAM_MAX_NODE_ID + 32) / 32) ///< Size of the node mask
+#define PARAM_DEFAULT_LED_PERIOD_SCALE  20      ///< Default cycles per input count of the running light
+#define PARAM_DEFAULT_SAFE_OUTPUT       0x00    ///< Default output value of nodes without valid data
+#define PARAM_SETTLE_TIME               200     ///< Quiet time after a change before the file is reloaded [ms]
+
+/**
+\brief  Check whether a node is driven by the application
+
+The macro evaluates to nonzero if the node is contained in the node list of
+the parameter set.
+*/
+#define PARAM_NODE_ENABLED(pSet_p, nodeId_p) \
+    (((nodeId_p) <= PARAM_MAX_NODE_ID) && \
+     ((((pSet_p)->aNodeMask[(nodeId_p) >> 5]) >> ((nodeId_p) & 31)) & 1))
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Runtime parameter set
+
+The structure contains the parameters used by the synchronous data handler.
+A set is never modified while it is in use, changed parameters are published
+as a new set.
+*/
+typedef struct
+{
+    UINT32          aNodeMask[PARAM_NODE_WORDS];    ///< Nodes driven by the running light (bit per node ID)
+    UINT            ledPeriodScale;                 ///< Cycles per input count of the running light period
+    UINT8           safeOutput;                     ///< Output value of nodes without valid data
+} tParamSet;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError       param_init(const char* pszFileName_p);
+void             param_exit(void);
+const tParamSet* param_syncEvent(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_param_H_ */
@@ -0,0 +1,462 @@
+/**
+********************************************************************************
+\file   payload.c
+
+\brief  Isochronous payload limit optimizer of the MN demo application
+
+This file contains the isochronous payload limit optimizer of the MN demo
+application.
+
+The optimizer determines the minimum PReq and PRes payload of every CN from
+the PDO mappings of the MN and the concise DCFs of the CNs. The results are
+written into the loaded CDC:
+- PReqActPayloadLimit and PResActPayloadLimit (0x1F98/4, 0x1F98/5) of the CNs
+- PReqPayloadLimitList and PResPayloadLimitList (0x1F8B, 0x1F8D) of the MN
+- PResActPayloadLimit of the MN (0x1F98/5) for the PRes of the MN
+
+If the DCF of a CN is changed, its configuration time (0x1020/2) and the
+expected configuration time of the MN (0x1F27) are updated, so the
+configuration manager downloads the new DCF. The optimizer reports the time
+saved on the wire per cycle.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "cdc.h"
+#include "payload.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PAYLOAD_NODE_COUNT          239         // number of CN node IDs
+#define PAYLOAD_PDO_CHANNELS        256         // number of PDO channels
+
+#define RPDO_COMM_INDEX             0x1400      // PDO_RxCommParam_XXh_REC
+#define RPDO_MAPP_INDEX             0x1600      // PDO_RxMappParam_XXh_AU64
+#define TPDO_COMM_INDEX             0x1800      // PDO_TxCommParam_XXh_REC
+#define TPDO_MAPP_INDEX             0x1A00      // PDO_TxMappParam_XXh_AU64
+#define PDO_COMM_NODEID_SUBINDEX    0x01        // NodeID_U8
+#define NODE_ASSIGN_INDEX           0x1F81      // NMT_NodeAssignment_AU32
+#define PREQ_LIMIT_LIST_INDEX       0x1F8B      // NMT_MNPReqPayloadLimitList_AU16
+#define PRES_LIMIT_LIST_INDEX       0x1F8D      // NMT_PResPayloadLimitList_AU16
+#define CYCLE_TIMING_INDEX          0x1F98      // NMT_CycleTiming_REC
+#define PREQ_LIMIT_SUBINDEX         0x04        // PReqActPayloadLimit_U16
+#define PRES_LIMIT_SUBINDEX         0x05        // PResActPayloadLimit_U16
+
+#define NODEASSIGN_NODE_IS_CN       0x00000002  // node is a CN
+#define NODEASSIGN_ASYNCONLY_NODE   0x00000100  // node is not polled isochronously
+
+#define FRAME_OVERHEAD              28          // Ethernet header, POWERLINK header and FCS
+#define WIRE_OVERHEAD               20          // preamble, SFD and inter-frame gap
+#define BYTE_TIME_NS                80          // transmission time of a byte at 100 Mbit/s
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Payload limits of a CN
+
+The structure contains the current and the optimized payload limits of a CN.
+*/
+typedef struct
+{
+    BOOL            fIsochronous;           ///< Node is polled isochronously
+    BOOL            fHasDcf;                ///< CDC contains a DCF of the node
+    UINT            preqBits;               ///< Mapped PReq payload [bits]
+    UINT            presBits;               ///< Mapped PRes payload [bits]
+    UINT            oldPreqLimit;           ///< Configured PReq payload limit [bytes]
+    UINT            oldPresLimit;           ///< Configured PRes payload limit [bytes]
+    UINT            preqLimit;              ///< Optimized PReq payload limit [bytes]
+    UINT            presLimit;              ///< Optimized PRes payload limit [bytes]
+} tPayloadNode;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPayloadNode     aPayloadNode_l[PAYLOAD_NODE_COUNT + 1];
+static UINT             mnPreqLimit_l = PAYLOAD_MIN_LIMIT;
+static UINT             mnPresLimit_l = PAYLOAD_MIN_LIMIT;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT32 readValue(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                        UINT32 default_p);
+static UINT   getMappedBits(const BYTE* pCdc_p, UINT size_p, UINT mappIndex_p);
+static UINT   getPayloadLimit(UINT bits_p);
+static UINT32 getFrameTime(UINT payload_p);
+static tOplkError writeNodeLimits(UINT nodeId_p, const tPayloadNode* pNode_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Optimize the isochronous payload limits
+
+The function calculates the minimum payload limits from the PDO mappings in
+the loaded CDC and writes them into the CDC. The saved time per cycle is
+reported.
+
+\note   The CDC buffer is modified. It must be called before any pointers into
+        the CDC are stored.
+
+\param  cycleLenUs_p            Configured cycle length [us], used for the
+                                report.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError payload_optimize(UINT32 cycleLenUs_p)
+{
+    tPayloadNode*   pNode;
+    BYTE*           pCdc;
+    UINT            cdcSize;
+    const BYTE*     pDcf;
+    UINT            dcfSize;
+    UINT            channel;
+    UINT            nodeId;
+    UINT            bits;
+    UINT            mnPresBits = 0;
+    UINT32          nodeAssign;
+    INT32           savedNs;
+    INT32           totalSavedNs = 0;
+    tOplkError      ret;
+
+    memset(aPayloadNode_l, 0, sizeof(aPayloadNode_l));
+    pCdc = cdc_getBuffer(&cdcSize);
+
+    // PDOs of the MN: TPDOs to a CN are sent with its PReq, TPDOs to node 0
+    // with the PRes of the MN. RPDOs from a CN are received with its PRes.
+    for (channel = 0; channel < PAYLOAD_PDO_CHANNELS; channel++)
+    {
+        bits = getMappedBits(pCdc, cdcSize, TPDO_MAPP_INDEX + channel);
+        if (bits != 0)
+        {
+            nodeId = readValue(pCdc, cdcSize, TPDO_COMM_INDEX + channel, PDO_COMM_NODEID_SUBINDEX, 0);
+            if (nodeId == 0)
+            {
+                if (bits > mnPresBits)
+                    mnPresBits = bits;
+            }
+            else if ((nodeId <= PAYLOAD_NODE_COUNT) && (bits > aPayloadNode_l[nodeId].preqBits))
+            {
+                aPayloadNode_l[nodeId].preqBits = bits;
+            }
+        }
+
+        bits = getMappedBits(pCdc, cdcSize, RPDO_MAPP_INDEX + channel);
+        if (bits != 0)
+        {
+            nodeId = readValue(pCdc, cdcSize, RPDO_COMM_INDEX + channel, PDO_COMM_NODEID_SUBINDEX, 0);
+            if ((nodeId != 0) && (nodeId <= PAYLOAD_NODE_COUNT) &&
+                (bits > aPayloadNode_l[nodeId].presBits))
+                aPayloadNode_l[nodeId].presBits = bits;
+        }
+    }
+
+    for (nodeId = 1; nodeId <= PAYLOAD_NODE_COUNT; nodeId++)
+    {
+        pNode = &aPayloadNode_l[nodeId];
+
+        nodeAssign = readValue(pCdc, cdcSize, NODE_ASSIGN_INDEX, nodeId, 0);
+        pNode->fIsochronous = ((nodeAssign & NODEASSIGN_NODE_IS_CN) != 0) &&
+                              ((nodeAssign & NODEASSIGN_ASYNCONLY_NODE) == 0);
+        if (!pNode->fIsochronous)
+            continue;
+
+        pNode->oldPreqLimit = PAYLOAD_MIN_LIMIT;
+        pNode->oldPresLimit = PAYLOAD_MIN_LIMIT;
+
+        // PDOs of the CN: TPDOs to node 0 are sent with its PRes, RPDOs from
+        // node 0 are received with its PReq
+        pNode->fHasDcf = cdc_getNodeDcf(nodeId, &pDcf, &dcfSize);
+        if (pNode->fHasDcf)
+        {
+            for (channel = 0; channel < PAYLOAD_PDO_CHANNELS; channel++)
+            {
+                if (readValue(pDcf, dcfSize, TPDO_COMM_INDEX + channel, PDO_COMM_NODEID_SUBINDEX, 0) == 0)
+                {
+                    bits = getMappedBits(pDcf, dcfSize, TPDO_MAPP_INDEX + channel);
+                    if (bits > pNode->presBits)
+                        pNode->presBits = bits;
+                }
+
+                if (readValue(pDcf, dcfSize, RPDO_COMM_INDEX + channel, PDO_COMM_NODEID_SUBINDEX, 0) == 0)
+                {
+                    bits = getMappedBits(pDcf, dcfSize, RPDO_MAPP_INDEX + channel);
+                    if (bits > pNode->preqBits)
+                        pNode->preqBits = bits;
+                }
+            }
+
+            pNode->oldPreqLimit = readValue(pDcf, dcfSize, CYCLE_TIMING_INDEX, PREQ_LIMIT_SUBINDEX,
+                                            pNode->oldPreqLimit);
+            pNode->oldPresLimit = readValue(pDcf, dcfSize, CYCLE_TIMING_INDEX, PRES_LIMIT_SUBINDEX,
+                                            pNode->oldPresLimit);
+        }
+
+        // the lists of the MN take precedence if they are configured
+        pNode->oldPreqLimit = readValue(pCdc, cdcSize, PREQ_LIMIT_LIST_INDEX, nodeId, pNode->oldPreqLimit);
+        pNode->oldPresLimit = readValue(pCdc, cdcSize, PRES_LIMIT_LIST_INDEX, nodeId, pNode->oldPresLimit);
+
+        pNode->preqLimit = getPayloadLimit(pNode->preqBits);
+        pNode->presLimit = getPayloadLimit(pNode->presBits);
+        if ((pNode->preqLimit > PAYLOAD_MAX_LIMIT) || (pNode->presLimit > PAYLOAD_MAX_LIMIT))
+        {
+            printf("Mapped payload of node %u exceeds the maximum payload!\n", nodeId);
+            return kErrorObdValueTooHigh;
+        }
+    }
+
+    mnPresLimit_l = getPayloadLimit(mnPresBits);
+    mnPreqLimit_l = PAYLOAD_MIN_LIMIT;
+
+    // all limits are known, now the CDC can be modified
+    printf("Payload limits (PReq/PRes bytes):\n");
+    for (nodeId = 1; nodeId <= PAYLOAD_NODE_COUNT; nodeId++)
+    {
+        pNode = &aPayloadNode_l[nodeId];
+        if (!pNode->fIsochronous)
+            continue;
+
+        ret = writeNodeLimits(nodeId, pNode);
+        if (ret != kErrorOk)
+            return ret;
+
+        savedNs = (INT32)(getFrameTime(pNode->oldPreqLimit) - getFrameTime(pNode->preqLimit)) +
+                  (INT32)(getFrameTime(pNode->oldPresLimit) - getFrameTime(pNode->presLimit));
+        totalSavedNs += savedNs;
+
+        printf("  Node %3u: mapped %u/%u, limit %u/%u -> %u/%u, %.2f us saved\n",
+               nodeId, (pNode->preqBits + 7) / 8, (pNode->presBits + 7) / 8,
+               pNode->oldPreqLimit, pNode->oldPresLimit,
+               pNode->preqLimit, pNode->presLimit, (double)savedNs / 1000.0);
+    }
+
+    ret = cdc_setEntry(CYCLE_TIMING_INDEX, PRES_LIMIT_SUBINDEX, mnPresLimit_l, 2);
+    if (ret != kErrorOk)
+        return ret;
+
+    printf("  MN PRes: mapped %u, limit %u\n", (mnPresBits + 7) / 8, mnPresLimit_l);
+    printf("  Total: %.2f us saved per cycle", (double)totalSavedNs / 1000.0);
+    if (cycleLenUs_p != 0)
+        printf(" (%.2f %% of the cycle)", (double)totalSavedNs / 10.0 / (double)cycleLenUs_p);
+    printf("\n");
+    if (totalSavedNs == 0)
+        printf("  The payload limits are already minimal\n");
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the payload limits of the MN
+
+The function returns the payload limits of the MN to be used as init
+parameters. Without optimization, the minimum limits are returned.
+
+\param  pPreqLimit_p            Pointer to store the PReq payload limit.
+\param  pPresLimit_p            Pointer to store the PRes payload limit.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void payload_getMnLimits(UINT* pPreqLimit_p, UINT* pPresLimit_p)
+{
+    *pPreqLimit_p = mnPreqLimit_l;
+    *pPresLimit_p = mnPresLimit_l;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an object value from a CDC or concise DCF
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  default_p               Value returned if the object is not contained.
+
+\return The function returns the object value.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readValue(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                        UINT32 default_p)
+{
+    tCdcEntry       entry;
+
+    if (!cdc_findEntry(pCdc_p, size_p, index_p, subIndex_p, &entry))
+        return default_p;
+
+    return (UINT32)cdc_getEntryValue(&entry);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the mapped payload of a PDO
+
+The function determines the end of the last mapped object of a PDO mapping.
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  mappIndex_p             Index of the mapping object.
+
+\return The function returns the mapped payload in bits.
+*/
+//------------------------------------------------------------------------------
+static UINT getMappedBits(const BYTE* pCdc_p, UINT size_p, UINT mappIndex_p)
+{
+    tCdcEntry       entry;
+    UINT64          mapping;
+    UINT            count;
+    UINT            subIndex;
+    UINT            end;
+    UINT            maxEnd = 0;
+
+    count = readValue(pCdc_p, size_p, mappIndex_p, 0, 0);
+    for (subIndex = 1; subIndex <= count; subIndex++)
+    {
+        if (!cdc_findEntry(pCdc_p, size_p, mappIndex_p, subIndex, &entry))
+            continue;
+
+        // mapping entry: length (63..48), offset (47..32), sub-index, index
+        mapping = cdc_getEntryValue(&entry);
+        end = (UINT)((mapping >> 32) & 0xFFFF) + (UINT)((mapping >> 48) & 0xFFFF);
+        if (end > maxEnd)
+            maxEnd = end;
+    }
+
+    return maxEnd;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the payload limit for a mapped payload
+
+\param  bits_p                  Mapped payload in bits.
+
+\return The function returns the payload limit in bytes.
+*/
+//------------------------------------------------------------------------------
+static UINT getPayloadLimit(UINT bits_p)
+{
+    UINT    bytes = (bits_p + 7) / 8;
+
+    return (bytes < PAYLOAD_MIN_LIMIT) ? PAYLOAD_MIN_LIMIT : bytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the transmission time of an isochronous frame
+
+\param  payload_p               Payload limit of the frame in bytes.
+
+\return The function returns the time the frame occupies the wire [ns].
+*/
+//------------------------------------------------------------------------------
+static UINT32 getFrameTime(UINT payload_p)
+{
+    return (UINT32)(payload_p + FRAME_OVERHEAD + WIRE_OVERHEAD) * BYTE_TIME_NS;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the payload limits of a CN into the CDC
+
+The function writes the payload limits into the DCF of the CN and the limit
+lists of the MN. If the DCF is changed, its configuration time is updated.
+
+\param  nodeId_p                Node ID of the CN.
+\param  pNode_p                 Pointer to the payload limits of the CN.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writeNodeLimits(UINT nodeId_p, const tPayloadNode* pNode_p)
+{
+    tOplkError      ret;
+
+    ret = cdc_setEntry(PREQ_LIMIT_LIST_INDEX, nodeId_p, pNode_p->preqLimit, 2);
+    if (ret == kErrorOk)
+        ret = cdc_setEntry(PRES_LIMIT_LIST_INDEX, nodeId_p, pNode_p->presLimit, 2);
+
+    if ((ret != kErrorOk) || !pNode_p->fHasDcf ||
+        ((pNode_p->preqLimit == pNode_p->oldPreqLimit) &&
+         (pNode_p->presLimit == pNode_p->oldPresLimit)))
+        return ret;
+
+    ret = cdc_setNodeEntry(nodeId_p, CYCLE_TIMING_INDEX, PREQ_LIMIT_SUBINDEX, pNode_p->preqLimit, 2);
+    if (ret == kErrorOk)
+        ret = cdc_setNodeEntry(nodeId_p, CYCLE_TIMING_INDEX, PRES_LIMIT_SUBINDEX, pNode_p->presLimit, 2);
+    if (ret == kErrorOk)
+        ret = cdc_updateConfTime(nodeId_p);
+
+    return ret;
+}
+
+/// \}
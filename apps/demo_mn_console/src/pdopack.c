@@ -0,0 +1,976 @@
+/**
+********************************************************************************
+\file   pdopack.c
+
+\brief  PDO mapping packer
+
+This file contains a configuration tool which packs the PDO mappings of a
+POWERLINK network.
+
+The tool reads the CDC and the process image description (xap.xml) generated
+by openCONFIGURATOR. The mapped objects of every PReq and PRes are reordered
+by their alignment so that no padding is left between them. The mappings of
+the CN (concise DCF) and of the MN are changed consistently, the payload
+limits are minimized and the CDC and the xap.* outputs are regenerated.
+
+The process image of the MN is not changed by the packer, only the layout of
+the frames on the wire.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <getopt/getopt.h>
+
+#include "cdc.h"
+#include "payload.h"
+#include "pidesc.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PACK_NODE_COUNT             239         // number of CN node IDs
+#define PACK_PDO_CHANNELS           256         // number of PDO channels
+#define PACK_MAX_ENTRIES            254         // mapping entries of a frame
+#define PACK_PATH_LEN               512         // maximum length of a file name
+#define PACK_PI_ALIGNMENT           32          // alignment of the process image [bits]
+
+#define RPDO_COMM_INDEX             0x1400      // PDO_RxCommParam_XXh_REC
+#define RPDO_MAPP_INDEX             0x1600      // PDO_RxMappParam_XXh_AU64
+#define TPDO_COMM_INDEX             0x1800      // PDO_TxCommParam_XXh_REC
+#define TPDO_MAPP_INDEX             0x1A00      // PDO_TxMappParam_XXh_AU64
+#define PDO_COMM_NODEID_SUBINDEX    0x01        // NodeID_U8
+#define NODE_ASSIGN_INDEX           0x1F81      // NMT_NodeAssignment_AU32
+#define CYCLE_LEN_INDEX             0x1006      // NMT_CycleLen_U32
+
+#define NODEASSIGN_NODE_IS_CN       0x00000002  // node is a CN
+#define NODEASSIGN_ASYNCONLY_NODE   0x00000100  // node is not polled isochronously
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Mapping entry
+
+The structure describes an object mapped into a PReq or PRes.
+*/
+typedef struct
+{
+    UINT            mappIndex;              ///< Index of the mapping object
+    UINT            objIndex;               ///< Index of the mapped object
+    UINT            objSubIndex;            ///< Sub-index of the mapped object
+    UINT            offset;                 ///< Offset in the frame [bits]
+    UINT            length;                 ///< Length of the mapped object [bits]
+    UINT            newOffset;              ///< Packed offset in the frame [bits]
+} tPackEntry;
+
+/**
+\brief  Frame mapping
+
+The structure contains the mapping entries of one side of a frame.
+*/
+typedef struct
+{
+    tPackEntry      aEntry[PACK_MAX_ENTRIES];   ///< Mapping entries
+    UINT            entryCount;                 ///< Number of mapping entries
+} tPackFrame;
+
+/**
+\brief  Process image names
+
+The structure contains the names used for a process image in the generated
+files.
+*/
+typedef struct
+{
+    const char*     pszStruct;                          ///< Name of the C structure
+    const char*     pszSize;                            ///< Name of the size define
+    const char*     pszCsStruct;                        ///< Name of the C# structure
+    const char*     pszCsTitle;                         ///< Title of the C# structure
+} tPackImage;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPackFrame       cnFrame_l;
+static tPackFrame       mnFrame_l;
+static const tPackImage aImage_l[kPiDescImageCount] =
+{
+    { "PI_OUT", "COMPUTED_PI_OUT_SIZE", "AppProcessImageOut", "Out" },
+    { "PI_IN",  "COMPUTED_PI_IN_SIZE",  "AppProcessImageIn",  "In"  }
+};
+static const char*      aImageType_l[kPiDescImageCount] = { "output", "input" };
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int        getOptions(int argc_p, char** argv_p, const char** ppszCdcFile_p,
+                             const char** ppszXapFile_p, const char** ppszOutDir_p);
+static tOplkError packNode(UINT nodeId_p, BOOL fPres_p, BOOL* pfChanged_p);
+static void       readFrame(const BYTE* pCdc_p, UINT size_p, UINT commIndex_p, UINT mappIndex_p,
+                            UINT nodeId_p, tPackFrame* pFrame_p);
+static UINT       getFrameBytes(const tPackFrame* pFrame_p, BOOL fPacked_p);
+static void       packFrame(tPackFrame* pFrame_p);
+static BOOL       matchFrame(const tPackFrame* pCnFrame_p, tPackFrame* pMnFrame_p);
+static tOplkError writeFrame(UINT nodeId_p, tPackFrame* pFrame_p);
+static UINT32     readValue(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                            UINT32 default_p);
+static UINT       getAlignment(UINT length_p);
+static int        compareAlignment(const void* pLeft_p, const void* pRight_p);
+static int        compareMapping(const void* pLeft_p, const void* pRight_p);
+static int        writeXapHeader(const char* pszFileName_p);
+static int        writeXapXml(const char* pszFileName_p);
+static int        writeXapCs(const char* pszFileName_p);
+static UINT       getImageSize(tPiDescImage image_p);
+static void       getIdentifier(const char* pszName_p, char* pIdent_p, size_t identSize_p);
+static const char* getCsType(const tPiDescChannel* pChannel_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the PDO mapping packer
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char*     pszCdcFile;
+    const char*     pszXapFile;
+    const char*     pszOutDir;
+    char            aPath[PACK_PATH_LEN];
+    BYTE*           pCdc;
+    UINT            cdcSize;
+    UINT            nodeId;
+    UINT32          nodeAssign;
+    BOOL            fPreqChanged;
+    BOOL            fPresChanged;
+    tOplkError      ret;
+    int             exitCode = EXIT_FAILURE;
+
+    if (getOptions(argc, argv, &pszCdcFile, &pszXapFile, &pszOutDir) != 0)
+        return EXIT_FAILURE;
+
+    if (pidesc_load(pszXapFile) != kErrorOk)
+        return EXIT_FAILURE;
+
+    if ((cdc_init(pszCdcFile) != kErrorOk) || (cdc_validate() != kErrorOk))
+    {
+        fprintf(stderr, "Unable to load CDC file %s!\n", pszCdcFile);
+        goto Exit;
+    }
+
+    printf("Frame payload (PReq/PRes bytes):\n");
+    for (nodeId = 1; nodeId <= PACK_NODE_COUNT; nodeId++)
+    {
+        pCdc = cdc_getBuffer(&cdcSize);
+        nodeAssign = readValue(pCdc, cdcSize, NODE_ASSIGN_INDEX, nodeId, 0);
+        if (((nodeAssign & NODEASSIGN_NODE_IS_CN) == 0) ||
+            ((nodeAssign & NODEASSIGN_ASYNCONLY_NODE) != 0))
+            continue;
+
+        if (((ret = packNode(nodeId, FALSE, &fPreqChanged)) != kErrorOk) ||
+            ((ret = packNode(nodeId, TRUE, &fPresChanged)) != kErrorOk))
+            goto Exit;
+
+        if ((fPreqChanged || fPresChanged) && ((ret = cdc_updateConfTime(nodeId)) != kErrorOk))
+            goto Exit;
+    }
+
+    pCdc = cdc_getBuffer(&cdcSize);
+    if (payload_optimize(readValue(pCdc, cdcSize, CYCLE_LEN_INDEX, 0, 0)) != kErrorOk)
+        goto Exit;
+
+    sprintf(aPath, "%s/mnobd.cdc", pszOutDir);
+    if (cdc_save(aPath) != kErrorOk)
+        goto Exit;
+
+    sprintf(aPath, "%s/xap.h", pszOutDir);
+    if (writeXapHeader(aPath) != 0)
+        goto Exit;
+
+    sprintf(aPath, "%s/xap.xml", pszOutDir);
+    if (writeXapXml(aPath) != 0)
+        goto Exit;
+
+    sprintf(aPath, "%s/ProcessImage.cs", pszOutDir);
+    if (writeXapCs(aPath) != 0)
+        goto Exit;
+
+    printf("Packed configuration written to %s\n", pszOutDir);
+    exitCode = EXIT_SUCCESS;
+
+Exit:
+    cdc_exit();
+    return exitCode;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+\param  argc_p                  Number of arguments.
+\param  argv_p                  Pointer to argument strings.
+\param  ppszCdcFile_p           Pointer to store the CDC file name.
+\param  ppszXapFile_p           Pointer to store the xap.xml file name.
+\param  ppszOutDir_p            Pointer to store the output directory.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, const char** ppszCdcFile_p,
+                      const char** ppszXapFile_p, const char** ppszOutDir_p)
+{
+    int                         opt;
+
+    *ppszCdcFile_p = "mnobd.cdc";
+    *ppszXapFile_p = "xap.xml";
+    *ppszOutDir_p = ".";
+
+    while ((opt = getopt(argc_p, argv_p, "c:x:d:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c':
+                *ppszCdcFile_p = optarg;
+                break;
+
+            case 'x':
+                *ppszXapFile_p = optarg;
+                break;
+
+            case 'd':
+                *ppszOutDir_p = optarg;
+                break;
+
+            default: /* '?' */
+                printf("Usage: %s [-c CDC-FILE] [-x XAP-FILE] [-d OUTPUT-DIR]\n", argv_p[0]);
+                printf("  Packs the PDO mappings and writes mnobd.cdc, xap.h, xap.xml and\n");
+                printf("  ProcessImage.cs to OUTPUT-DIR\n");
+                return -1;
+        }
+    }
+
+    // leave room for the output file names
+    if (strlen(*ppszOutDir_p) > PACK_PATH_LEN - 32)
+    {
+        fprintf(stderr, "Output directory name is too long!\n");
+        return -1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pack a frame of a CN
+
+The function packs the mapping of the PReq or PRes of a CN. The mapping in the
+DCF of the CN and the corresponding mapping of the MN are changed.
+
+\param  nodeId_p                Node ID of the CN.
+\param  fPres_p                 TRUE: Pack the PRes, FALSE: Pack the PReq.
+\param  pfChanged_p             Pointer to store if the mapping was changed.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError packNode(UINT nodeId_p, BOOL fPres_p, BOOL* pfChanged_p)
+{
+    const BYTE*     pDcf;
+    UINT            dcfSize;
+    BYTE*           pCdc;
+    UINT            cdcSize;
+    UINT            oldBytes;
+    UINT            newBytes;
+    UINT            i;
+    tOplkError      ret;
+
+    *pfChanged_p = FALSE;
+    if (!cdc_getNodeDcf(nodeId_p, &pDcf, &dcfSize))
+        return kErrorOk;
+
+    // the CN sends its PRes with a TPDO and receives the PReq with an RPDO,
+    // the MN uses the opposite direction
+    pCdc = cdc_getBuffer(&cdcSize);
+    if (fPres_p)
+    {
+        readFrame(pDcf, dcfSize, TPDO_COMM_INDEX, TPDO_MAPP_INDEX, 0, &cnFrame_l);
+        readFrame(pCdc, cdcSize, RPDO_COMM_INDEX, RPDO_MAPP_INDEX, nodeId_p, &mnFrame_l);
+    }
+    else
+    {
+        readFrame(pDcf, dcfSize, RPDO_COMM_INDEX, RPDO_MAPP_INDEX, 0, &cnFrame_l);
+        readFrame(pCdc, cdcSize, TPDO_COMM_INDEX, TPDO_MAPP_INDEX, nodeId_p, &mnFrame_l);
+    }
+
+    if (cnFrame_l.entryCount == 0)
+        return kErrorOk;
+
+    packFrame(&cnFrame_l);
+    if (!matchFrame(&cnFrame_l, &mnFrame_l))
+    {
+        printf("  Node %3u: %s mapping of MN and CN differ, not packed\n",
+               nodeId_p, fPres_p ? "PRes" : "PReq");
+        return kErrorOk;
+    }
+
+    oldBytes = getFrameBytes(&cnFrame_l, FALSE);
+    newBytes = getFrameBytes(&cnFrame_l, TRUE);
+    printf("  Node %3u: %s %u -> %u\n", nodeId_p, fPres_p ? "PRes" : "PReq", oldBytes, newBytes);
+
+    for (i = 0; i < cnFrame_l.entryCount; i++)
+    {
+        if (cnFrame_l.aEntry[i].newOffset != cnFrame_l.aEntry[i].offset)
+            *pfChanged_p = TRUE;
+    }
+    if (!*pfChanged_p)
+        return kErrorOk;
+
+    ret = writeFrame(nodeId_p, &cnFrame_l);
+    if (ret == kErrorOk)
+        ret = writeFrame(0, &mnFrame_l);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the mapping of a frame
+
+The function reads the mapping entries of all PDO channels of a CDC or concise
+DCF which are assigned to a node.
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  commIndex_p             Base index of the communication parameters.
+\param  mappIndex_p             Base index of the mapping parameters.
+\param  nodeId_p                Node ID the channels are assigned to.
+\param  pFrame_p                Pointer to store the mapping entries.
+*/
+//------------------------------------------------------------------------------
+static void readFrame(const BYTE* pCdc_p, UINT size_p, UINT commIndex_p, UINT mappIndex_p,
+                      UINT nodeId_p, tPackFrame* pFrame_p)
+{
+    tCdcEntry       entry;
+    tPackEntry*     pEntry;
+    UINT64          mapping;
+    UINT            channel;
+    UINT            count;
+    UINT            subIndex;
+
+    pFrame_p->entryCount = 0;
+    for (channel = 0; channel < PACK_PDO_CHANNELS; channel++)
+    {
+        // a DCF usually leaves the node ID of the CN channels at its default 0
+        if (readValue(pCdc_p, size_p, commIndex_p + channel, PDO_COMM_NODEID_SUBINDEX, 0) != nodeId_p)
+            continue;
+
+        count = readValue(pCdc_p, size_p, mappIndex_p + channel, 0, 0);
+        for (subIndex = 1; subIndex <= count; subIndex++)
+        {
+            if (!cdc_findEntry(pCdc_p, size_p, mappIndex_p + channel, subIndex, &entry) ||
+                (pFrame_p->entryCount >= PACK_MAX_ENTRIES))
+                continue;
+
+            // mapping entry: length (63..48), offset (47..32), sub-index, index
+            mapping = cdc_getEntryValue(&entry);
+            pEntry = &pFrame_p->aEntry[pFrame_p->entryCount++];
+            pEntry->mappIndex = mappIndex_p + channel;
+            pEntry->objIndex = (UINT)(mapping & 0xFFFF);
+            pEntry->objSubIndex = (UINT)((mapping >> 16) & 0xFF);
+            pEntry->offset = (UINT)((mapping >> 32) & 0xFFFF);
+            pEntry->length = (UINT)((mapping >> 48) & 0xFFFF);
+            pEntry->newOffset = pEntry->offset;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the payload of a frame
+
+\param  pFrame_p                Pointer to the mapping entries.
+\param  fPacked_p               Use the packed offsets.
+
+\return The function returns the mapped payload in bytes.
+*/
+//------------------------------------------------------------------------------
+static UINT getFrameBytes(const tPackFrame* pFrame_p, BOOL fPacked_p)
+{
+    UINT    i;
+    UINT    end;
+    UINT    maxEnd = 0;
+
+    for (i = 0; i < pFrame_p->entryCount; i++)
+    {
+        end = (fPacked_p ? pFrame_p->aEntry[i].newOffset : pFrame_p->aEntry[i].offset) +
+              pFrame_p->aEntry[i].length;
+        if (end > maxEnd)
+            maxEnd = end;
+    }
+
+    return (maxEnd + 7) / 8;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pack the mapping of a frame
+
+The function assigns new offsets to the mapping entries. The entries are
+placed in the order of decreasing alignment. The size of every entry is a
+multiple of its alignment, so each entry starts aligned and no padding is
+required between them. The MN maps whole bytes only, so every entry starts at
+a byte boundary.
+
+\param  pFrame_p                Pointer to the mapping entries.
+*/
+//------------------------------------------------------------------------------
+static void packFrame(tPackFrame* pFrame_p)
+{
+    tPackEntry      aSorted[PACK_MAX_ENTRIES];
+    UINT            i;
+    UINT            j;
+    UINT            offset = 0;
+
+    memcpy(aSorted, pFrame_p->aEntry, pFrame_p->entryCount * sizeof(tPackEntry));
+    qsort(aSorted, pFrame_p->entryCount, sizeof(tPackEntry), compareAlignment);
+
+    for (i = 0; i < pFrame_p->entryCount; i++)
+    {
+        for (j = 0; j < pFrame_p->entryCount; j++)
+        {
+            if ((pFrame_p->aEntry[j].mappIndex == aSorted[i].mappIndex) &&
+                (pFrame_p->aEntry[j].offset == aSorted[i].offset))
+            {
+                pFrame_p->aEntry[j].newOffset = offset;
+                break;
+            }
+        }
+        offset += (aSorted[i].length + 7) & ~7U;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the packed offsets to the mapping of the MN
+
+The function assigns the packed offsets of the CN mapping to the entries of
+the MN mapping which refer to the same frame data.
+
+\param  pCnFrame_p              Pointer to the packed mapping of the CN.
+\param  pMnFrame_p              Pointer to the mapping of the MN.
+
+\return The function returns TRUE if both mappings are consistent.
+*/
+//------------------------------------------------------------------------------
+static BOOL matchFrame(const tPackFrame* pCnFrame_p, tPackFrame* pMnFrame_p)
+{
+    UINT    i;
+    UINT    j;
+
+    for (i = 0; i < pMnFrame_p->entryCount; i++)
+    {
+        for (j = 0; j < pCnFrame_p->entryCount; j++)
+        {
+            if (pCnFrame_p->aEntry[j].offset == pMnFrame_p->aEntry[i].offset)
+                break;
+        }
+
+        if ((j == pCnFrame_p->entryCount) ||
+            (pCnFrame_p->aEntry[j].length != pMnFrame_p->aEntry[i].length))
+            return FALSE;
+
+        pMnFrame_p->aEntry[i].newOffset = pCnFrame_p->aEntry[j].newOffset;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the packed mapping of a frame
+
+The function writes the packed mapping entries into the CDC. The entries of
+each mapping object are written in the order of their offsets.
+
+\param  nodeId_p                Node ID of the CN or 0 for the MN mapping.
+\param  pFrame_p                Pointer to the packed mapping entries.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writeFrame(UINT nodeId_p, tPackFrame* pFrame_p)
+{
+    tPackEntry*     pEntry;
+    UINT64          mapping;
+    UINT            i;
+    UINT            subIndex = 0;
+    tOplkError      ret;
+
+    qsort(pFrame_p->aEntry, pFrame_p->entryCount, sizeof(tPackEntry), compareMapping);
+
+    for (i = 0; i < pFrame_p->entryCount; i++)
+    {
+        pEntry = &pFrame_p->aEntry[i];
+        if ((i == 0) || (pEntry->mappIndex != pFrame_p->aEntry[i - 1].mappIndex))
+            subIndex = 1;
+        else
+            subIndex++;
+
+        mapping = ((UINT64)pEntry->length << 48) | ((UINT64)pEntry->newOffset << 32) |
+                  ((UINT64)pEntry->objSubIndex << 16) | pEntry->objIndex;
+        if (nodeId_p == 0)
+            ret = cdc_setEntry(pEntry->mappIndex, subIndex, mapping, 8);
+        else
+            ret = cdc_setNodeEntry(nodeId_p, pEntry->mappIndex, subIndex, mapping, 8);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an object value from a CDC or concise DCF
+
+\param  pCdc_p                  Pointer to the CDC or concise DCF.
+\param  size_p                  Size of the CDC in bytes.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  default_p               Value returned if the object is not contained.
+
+\return The function returns the object value.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readValue(const BYTE* pCdc_p, UINT size_p, UINT index_p, UINT subIndex_p,
+                        UINT32 default_p)
+{
+    tCdcEntry       entry;
+
+    if (!cdc_findEntry(pCdc_p, size_p, index_p, subIndex_p, &entry))
+        return default_p;
+
+    return (UINT32)cdc_getEntryValue(&entry);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the alignment of a mapping entry
+
+The alignment is the largest power of two up to 64 bits which divides the
+byte-rounded length of the entry. Entries with a length which is not a power
+of two, e.g. 24 bits, are therefore placed with the alignment of their length
+and do not misalign the entries following them.
+
+\param  length_p                Length of the mapped object [bits].
+
+\return The function returns the alignment of the entry [bits].
+*/
+//------------------------------------------------------------------------------
+static UINT getAlignment(UINT length_p)
+{
+    UINT    size = (length_p + 7) & ~7U;
+    UINT    align = 64;
+
+    while ((size % align) != 0)
+        align >>= 1;
+
+    return align;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare mapping entries by alignment
+
+Entries with larger alignment come first, entries with the same alignment
+keep their original order.
+
+\param  pLeft_p                 Pointer to the first entry.
+\param  pRight_p                Pointer to the second entry.
+
+\return The function returns the comparison result for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareAlignment(const void* pLeft_p, const void* pRight_p)
+{
+    const tPackEntry*   pLeft = (const tPackEntry*)pLeft_p;
+    const tPackEntry*   pRight = (const tPackEntry*)pRight_p;
+    UINT                leftAlign;
+    UINT                rightAlign;
+
+    leftAlign = getAlignment(pLeft->length);
+    rightAlign = getAlignment(pRight->length);
+    if (leftAlign != rightAlign)
+        return (leftAlign > rightAlign) ? -1 : 1;
+
+    if (pLeft->mappIndex != pRight->mappIndex)
+        return (pLeft->mappIndex < pRight->mappIndex) ? -1 : 1;
+
+    return (pLeft->offset < pRight->offset) ? -1 : (pLeft->offset > pRight->offset);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare mapping entries by mapping object and packed offset
+
+\param  pLeft_p                 Pointer to the first entry.
+\param  pRight_p                Pointer to the second entry.
+
+\return The function returns the comparison result for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareMapping(const void* pLeft_p, const void* pRight_p)
+{
+    const tPackEntry*   pLeft = (const tPackEntry*)pLeft_p;
+    const tPackEntry*   pRight = (const tPackEntry*)pRight_p;
+
+    if (pLeft->mappIndex != pRight->mappIndex)
+        return (pLeft->mappIndex < pRight->mappIndex) ? -1 : 1;
+
+    return (pLeft->newOffset < pRight->newOffset) ? -1 : (pLeft->newOffset > pRight->newOffset);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the process image header file
+
+The function writes xap.h with a bit field structure for each process image.
+Gaps between channels and the end of the process image are filled with
+padding variables.
+
+\param  pszFileName_p           File name of xap.h.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int writeXapHeader(const char* pszFileName_p)
+{
+    FILE*                   pFile;
+    const tPackImage*       pImage;
+    const tPiDescChannel*   pChannel;
+    char                    aIdent[PIDESC_NAME_LEN];
+    UINT                    i;
+    UINT                    ch;
+    UINT                    pos;
+    UINT                    size;
+    UINT                    padding;
+
+    pFile = fopen(pszFileName_p, "w");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to create file %s!\n", pszFileName_p);
+        return -1;
+    }
+
+    fprintf(pFile, "/* This file was generated by pdopack */\n");
+    fprintf(pFile, "#ifndef XAP_h\n#define XAP_h\n");
+
+    for (i = 0; i < kPiDescImageCount; i++)
+    {
+        pImage = &aImage_l[i];
+        size = getImageSize((tPiDescImage)i);
+        padding = 0;
+        pos = 0;
+
+        fprintf(pFile, "\n# define %s %u\n", pImage->pszSize, size / 8);
+        fprintf(pFile, "typedef struct \n{\n");
+        for (ch = 0; ch < pidesc_getChannelCount((tPiDescImage)i); ch++)
+        {
+            pChannel = pidesc_getChannel((tPiDescImage)i, ch);
+            if (pChannel->offset > pos)
+                fprintf(pFile, "\tunsigned PADDING_VAR_%u:%u;\n", ++padding, pChannel->offset - pos);
+
+            getIdentifier(pChannel->aName, aIdent, sizeof(aIdent));
+            fprintf(pFile, "\t%s %s:%u;\n",
+                    (pChannel->size > 32) ? "unsigned long long" :
+                    (strncmp(pChannel->aTypeName, "Integer", 7) == 0) ? "signed" : "unsigned",
+                    aIdent, pChannel->size);
+            pos = pChannel->offset + pChannel->size;
+        }
+        if (size > pos)
+            fprintf(pFile, "\tunsigned PADDING_VAR_%u:%u;\n", ++padding, size - pos);
+        fprintf(pFile, "} %s;\n", pImage->pszStruct);
+    }
+
+    fprintf(pFile, "\n#endif\n");
+    fclose(pFile);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the process image description
+
+\param  pszFileName_p           File name of xap.xml.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int writeXapXml(const char* pszFileName_p)
+{
+    FILE*                   pFile;
+    const tPiDescChannel*   pChannel;
+    UINT                    i;
+    UINT                    ch;
+    UINT                    end = 0;
+
+    pFile = fopen(pszFileName_p, "w");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to create file %s!\n", pszFileName_p);
+        return -1;
+    }
+
+    fprintf(pFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(pFile, "<!--This file was generated by pdopack-->\n");
+    fprintf(pFile, "<ApplicationProcess>\n");
+
+    for (i = 0; i < kPiDescImageCount; i++)
+    {
+        end = 0;
+        pChannel = pidesc_getChannel((tPiDescImage)i, pidesc_getChannelCount((tPiDescImage)i) - 1);
+        if (pChannel != NULL)
+            end = pChannel->offset + pChannel->size;
+
+        fprintf(pFile, "  <ProcessImage type=\"%s\" size=\"%u\">\n", aImageType_l[i], (end + 7) / 8);
+        for (ch = 0; ch < pidesc_getChannelCount((tPiDescImage)i); ch++)
+        {
+            pChannel = pidesc_getChannel((tPiDescImage)i, ch);
+            fprintf(pFile, "    <Channel Name=\"%s\" dataType=\"%s\" dataSize=\"%u\" PIOffset=\"0x%04X\"",
+                    pChannel->aName, pChannel->aTypeName, pChannel->size, pChannel->offset / 8);
+            if ((pChannel->offset % 8) != 0)
+                fprintf(pFile, " BitOffset=\"0x%02X\"", pChannel->offset % 8);
+            fprintf(pFile, "/>\n");
+        }
+        fprintf(pFile, "  </ProcessImage>\n");
+    }
+
+    fprintf(pFile, "</ApplicationProcess>\n");
+    fclose(pFile);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the C# process image file
+
+The function writes ProcessImage.cs with an explicit layout structure for each
+process image. Channels smaller than a byte share the byte they are located
+in.
+
+\param  pszFileName_p           File name of ProcessImage.cs.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int writeXapCs(const char* pszFileName_p)
+{
+    FILE*                   pFile;
+    const tPackImage*       pImage;
+    const tPiDescChannel*   pChannel;
+    char                    aIdent[PIDESC_NAME_LEN];
+    UINT                    i;
+    UINT                    ch;
+    UINT                    pos;
+    UINT                    size;
+    UINT                    padding;
+
+    pFile = fopen(pszFileName_p, "w");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to create file %s!\n", pszFileName_p);
+        return -1;
+    }
+
+    fprintf(pFile, "using System;\nusing System.Runtime.InteropServices;\n");
+    fprintf(pFile, "/// <summary>\n/// This file was generated by pdopack\n/// </summary>\n\n");
+    fprintf(pFile, "namespace openPOWERLINK\n{\n");
+
+    for (i = 0; i < kPiDescImageCount; i++)
+    {
+        pImage = &aImage_l[i];
+        size = getImageSize((tPiDescImage)i) / 8;
+        padding = 0;
+        pos = 0;
+
+        fprintf(pFile, "\n\t/// <summary>\n\t/// Struct : ProcessImage %s\n\t/// </summary>\n",
+                pImage->pszCsTitle);
+        fprintf(pFile, "\t[StructLayout(LayoutKind.Explicit, Pack = 1, Size = %u)]\n", size);
+        fprintf(pFile, "\tpublic struct %s\n\t{\n", pImage->pszCsStruct);
+        for (ch = 0; ch < pidesc_getChannelCount((tPiDescImage)i); ch++)
+        {
+            pChannel = pidesc_getChannel((tPiDescImage)i, ch);
+            for (; pos < pChannel->offset / 8; pos++)
+                fprintf(pFile, "\t\t[FieldOffset(%u)]\n\t\tpublic byte PADDING_VAR_%u;\n", pos, ++padding);
+
+            getIdentifier(pChannel->aName, aIdent, sizeof(aIdent));
+            fprintf(pFile, "\t\t[FieldOffset(%u)]\n\t\tpublic %s %s;\n",
+                    pChannel->offset / 8, getCsType(pChannel), aIdent);
+            pos = (pChannel->offset + pChannel->size + 7) / 8;
+        }
+        for (; pos < size; pos++)
+            fprintf(pFile, "\t\t[FieldOffset(%u)]\n\t\tpublic byte PADDING_VAR_%u;\n", pos, ++padding);
+        fprintf(pFile, "\t}\n");
+    }
+
+    fprintf(pFile, "}\n");
+    fclose(pFile);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the size of a process image
+
+\param  image_p                 Process image.
+
+\return The function returns the aligned size of the process image [bits].
+*/
+//------------------------------------------------------------------------------
+static UINT getImageSize(tPiDescImage image_p)
+{
+    const tPiDescChannel*   pChannel;
+    UINT                    end = 0;
+
+    pChannel = pidesc_getChannel(image_p, pidesc_getChannelCount(image_p) - 1);
+    if (pChannel != NULL)
+        end = pChannel->offset + pChannel->size;
+
+    return (end + PACK_PI_ALIGNMENT - 1) & ~(PACK_PI_ALIGNMENT - 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the identifier of a channel
+
+The function converts a channel name into a C identifier.
+
+\param  pszName_p               Channel name.
+\param  pIdent_p                Pointer to store the identifier.
+\param  identSize_p             Size of the identifier buffer.
+*/
+//------------------------------------------------------------------------------
+static void getIdentifier(const char* pszName_p, char* pIdent_p, size_t identSize_p)
+{
+    size_t      i;
+
+    for (i = 0; (pszName_p[i] != '\0') && (i < identSize_p - 1); i++)
+        pIdent_p[i] = (pszName_p[i] == '.') ? '_' : pszName_p[i];
+    pIdent_p[i] = '\0';
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the C# type of a channel
+
+\param  pChannel_p              Pointer to the channel.
+
+\return The function returns the name of the C# type.
+*/
+//------------------------------------------------------------------------------
+static const char* getCsType(const tPiDescChannel* pChannel_p)
+{
+    switch (pChannel_p->type)
+    {
+        case kPiDescTypeInteger8:
+            return "sbyte";
+
+        case kPiDescTypeInteger16:
+            return "Int16";
+
+        case kPiDescTypeUnsigned16:
+            return "UInt16";
+
+        case kPiDescTypeInteger32:
+            return "Int32";
+
+        case kPiDescTypeUnsigned32:
+            return "UInt32";
+
+        case kPiDescTypeReal32:
+            return "float";
+
+        case kPiDescTypeInteger64:
+            return "Int64";
+
+        case kPiDescTypeUnsigned64:
+            return "UInt64";
+
+        case kPiDescTypeReal64:
+            return "double";
+
+        default:
+            return "byte";
+    }
+}
+
+/// \}
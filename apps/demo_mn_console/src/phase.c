@@ -0,0 +1,435 @@
+/**
+********************************************************************************
+\file   phase.c
+
+\brief  Phase-locked application scheduler of the MN demo application
+
+This file contains the phase-locked application scheduler of the MN demo
+application.
+
+The scheduler estimates the phase and the period of the POWERLINK cycle from
+the time stamps of successive sync events with a software PLL. Tasks are
+executed at configured offsets from the estimated sync instant. A positive
+offset is relative to the current sync event, a negative offset is relative
+to the next one. That way, the application work can be spread over the cycle
+and the outputs can be handed over right before they are sampled. The
+difference between the planned and the actual start of a task is reported as
+phase error.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "phase.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PHASE_GAIN_SHIFT        2           // phase correction: 1/4 of the error
+#define PERIOD_GAIN_SHIFT       6           // period correction: 1/64 of the error
+#define PHASE_LOCK_CYCLES       100         // cycles within tolerance until locked
+#define PHASE_LATE_THRESHOLD    1000        // start delay counted as late [ns]
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Scheduled task
+
+The structure describes a task of the phase-locked scheduler.
+*/
+typedef struct
+{
+    const char*         pName;              ///< Name of the task
+    int                 offsetUs;           ///< Offset from the sync event [us]
+    INT64               sortKey;            ///< Offset from the sync event at nominal period [ns]
+    tPhaseTaskCb        pfnTask;            ///< Task callback
+    void*               pArg;               ///< Argument passed to the callback
+    UINT32              runCount;           ///< Number of executions
+    UINT32              lateCount;          ///< Executions which started after the planned time
+    INT64               minError;           ///< Minimum phase error [ns]
+    INT64               maxError;           ///< Maximum phase error [ns]
+    INT64               sumError;           ///< Sum of the phase errors [ns]
+} tPhaseTask;
+
+/**
+\brief  Phase scheduler instance
+
+The structure contains the local variables of the phase-locked scheduler.
+*/
+typedef struct
+{
+    INT64               nominalPeriod;      ///< Configured cycle length [ns]
+    INT64               period;             ///< Estimated cycle length [ns]
+    INT64               syncTime;           ///< Estimated time of the current sync event [ns]
+    INT64               predictedTime;      ///< Predicted time of the next sync event [ns]
+    BOOL                fStarted;           ///< First sync event has been received
+    UINT32              lockCount;          ///< Consecutive cycles within tolerance
+    UINT32              syncCount;          ///< Number of sync events
+    UINT32              resyncCount;        ///< Number of phase resynchronizations
+    INT64               maxSyncError;       ///< Maximum sync error while locked [ns]
+    INT64               sumSyncError;       ///< Sum of absolute sync errors while locked [ns]
+    UINT32              lockedCount;        ///< Number of sync events while locked
+    int                 outputOffsetUs;     ///< Output offset [us] or PHASE_OFFSET_NONE
+    UINT                taskCount;          ///< Number of tasks
+    tPhaseTask          aTask[PHASE_MAX_TASKS]; ///< Tasks sorted by offset
+} tPhaseInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPhaseInstance   phaseInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static INT64 getTaskOffset(const tPhaseTask* pTask_p, INT64 period_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the phase-locked scheduler
+
+The function initializes the phase-locked scheduler.
+
+\param  cycleLenUs_p            Configured cycle length [us] (object 0x1006).
+\param  outputOffsetUs_p        Offset for handing over the outputs [us], or
+                                PHASE_OFFSET_NONE if the outputs are handed
+                                over immediately.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void phase_init(UINT32 cycleLenUs_p, int outputOffsetUs_p)
+{
+    memset(&phaseInstance_l, 0, sizeof(phaseInstance_l));
+    phaseInstance_l.nominalPeriod = (INT64)cycleLenUs_p * 1000;
+    phaseInstance_l.period = phaseInstance_l.nominalPeriod;
+    phaseInstance_l.outputOffsetUs = outputOffsetUs_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change the cycle length
+
+The function changes the nominal cycle length, e.g. when the network is
+restarted with a different cycle length. The estimation starts over with the
+next sync event, the tasks are kept.
+
+\param  cycleLenUs_p            New cycle length [us].
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void phase_setCycleLen(UINT32 cycleLenUs_p)
+{
+    phaseInstance_l.fStarted = FALSE;
+    phaseInstance_l.nominalPeriod = (INT64)cycleLenUs_p * 1000;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the output offset
+
+\param  pOffsetUs_p             Pointer to store the output offset [us].
+
+\return The function returns TRUE if an output offset is configured.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL phase_getOutputOffset(int* pOffsetUs_p)
+{
+    if ((phaseInstance_l.outputOffsetUs == PHASE_OFFSET_NONE) ||
+        (phaseInstance_l.nominalPeriod == 0))
+        return FALSE;
+
+    *pOffsetUs_p = phaseInstance_l.outputOffsetUs;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a task
+
+The function adds a task to the scheduler. The tasks are executed by
+phase_runTasks() in the order of their offsets.
+
+\param  pName_p                 Name of the task.
+\param  offsetUs_p              Offset of the task [us]. Positive offsets are
+                                relative to the current sync event, negative
+                                offsets relative to the next one.
+\param  pfnTask_p               Task callback.
+\param  pArg_p                  Argument passed to the callback.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError phase_addTask(const char* pName_p, int offsetUs_p,
+                         tPhaseTaskCb pfnTask_p, void* pArg_p)
+{
+    tPhaseTask      task;
+    UINT            i;
+
+    if (phaseInstance_l.taskCount >= PHASE_MAX_TASKS)
+        return kErrorNoResource;
+
+    memset(&task, 0, sizeof(task));
+    task.pName = pName_p;
+    task.offsetUs = offsetUs_p;
+    task.pfnTask = pfnTask_p;
+    task.pArg = pArg_p;
+    task.sortKey = getTaskOffset(&task, phaseInstance_l.nominalPeriod);
+
+    if ((task.sortKey < 0) || (task.sortKey >= phaseInstance_l.nominalPeriod))
+        return kErrorApiInvalidParam;
+
+    // insertion sort, the table is tiny and only built at startup
+    for (i = phaseInstance_l.taskCount; i > 0; i--)
+    {
+        if (phaseInstance_l.aTask[i - 1].sortKey <= task.sortKey)
+            break;
+        phaseInstance_l.aTask[i] = phaseInstance_l.aTask[i - 1];
+    }
+    phaseInstance_l.aTask[i] = task;
+    phaseInstance_l.taskCount++;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a sync event
+
+The function must be called right after the sync event has been received. It
+updates the estimated phase and period of the cycle.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void phase_syncEvent(void)
+{
+    tPhaseInstance* pInstance = &phaseInstance_l;
+    INT64           now = (INT64)system_getTimeNs();
+    INT64           error;
+    INT64           absError;
+
+    if (pInstance->nominalPeriod == 0)
+        return;
+
+    pInstance->syncCount++;
+    error = now - pInstance->predictedTime;
+    absError = (error < 0) ? -error : error;
+
+    if (!pInstance->fStarted || (absError > (pInstance->nominalPeriod / 2)))
+    {
+        // first event, lost cycle or stack restart: restart the estimation
+        if (pInstance->fStarted)
+        {
+            pInstance->resyncCount++;
+            CONSOLE_LOG_DEBUG(kConsoleModSync, "Sync: phase error %ld us, resynchronizing\n",
+                              (long)(error / 1000));
+        }
+
+        pInstance->fStarted = TRUE;
+        pInstance->syncTime = now;
+        pInstance->period = pInstance->nominalPeriod;
+        pInstance->lockCount = 0;
+    }
+    else
+    {
+        pInstance->syncTime = pInstance->predictedTime + (error >> PHASE_GAIN_SHIFT);
+        pInstance->period += error >> PERIOD_GAIN_SHIFT;
+
+        if (pInstance->lockCount >= PHASE_LOCK_CYCLES)
+        {
+            if (absError > pInstance->maxSyncError)
+                pInstance->maxSyncError = absError;
+            pInstance->sumSyncError += absError;
+            pInstance->lockedCount++;
+        }
+        else
+        {
+            pInstance->lockCount++;
+        }
+    }
+
+    pInstance->predictedTime = pInstance->syncTime + pInstance->period;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the scheduled tasks
+
+The function executes the tasks of the current cycle. It waits actively
+until the planned start time of each task. A task whose start time has
+already passed is executed immediately and counted as late.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void phase_runTasks(void)
+{
+    tPhaseInstance* pInstance = &phaseInstance_l;
+    tPhaseTask*     pTask;
+    INT64           dueTime;
+    INT64           now;
+    INT64           error;
+    UINT            i;
+
+    for (i = 0; i < pInstance->taskCount; i++)
+    {
+        pTask = &pInstance->aTask[i];
+        dueTime = pInstance->syncTime + getTaskOffset(pTask, pInstance->period);
+
+        // timer resolution is too coarse for sub-cycle offsets, so spin
+        do
+        {
+            now = (INT64)system_getTimeNs();
+        } while (now < dueTime);
+
+        pTask->pfnTask(pTask->pArg);
+
+        error = now - dueTime;
+        if ((pTask->runCount == 0) || (error < pTask->minError))
+            pTask->minError = error;
+        if (error > pTask->maxError)
+            pTask->maxError = error;
+        pTask->sumError += error;
+        pTask->runCount++;
+        if (error > PHASE_LATE_THRESHOLD)
+            pTask->lateCount++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print phase statistics
+
+The function prints the estimated cycle period, the sync jitter and the phase
+error of all tasks.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void phase_printStatistics(void)
+{
+    tPhaseInstance* pInstance = &phaseInstance_l;
+    tPhaseTask*     pTask;
+    UINT            i;
+
+    if (pInstance->taskCount == 0)
+        return;
+
+    printf("Phase-locked scheduler: period %.3f us (nominal %.3f us), %lu sync events, %lu resyncs\n",
+           (double)pInstance->period / 1000.0, (double)pInstance->nominalPeriod / 1000.0,
+           (ULONG)pInstance->syncCount, (ULONG)pInstance->resyncCount);
+
+    if (pInstance->lockedCount != 0)
+    {
+        printf("  Sync error while locked [us]: avg %.3f max %.3f\n",
+               (double)pInstance->sumSyncError / (double)pInstance->lockedCount / 1000.0,
+               (double)pInstance->maxSyncError / 1000.0);
+    }
+
+    for (i = 0; i < pInstance->taskCount; i++)
+    {
+        pTask = &pInstance->aTask[i];
+        if (pTask->runCount == 0)
+            continue;
+
+        printf("  Task %-10s offset %6d us: phase error [us] min %.3f avg %.3f max %.3f, %lu late\n",
+               pTask->pName, pTask->offsetUs,
+               (double)pTask->minError / 1000.0,
+               (double)pTask->sumError / (double)pTask->runCount / 1000.0,
+               (double)pTask->maxError / 1000.0,
+               (ULONG)pTask->lateCount);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the offset of a task from the current sync event
+
+\param  pTask_p                 Pointer to the task.
+\param  period_p                Cycle period [ns].
+
+\return The function returns the offset from the current sync event [ns].
+*/
+//------------------------------------------------------------------------------
+static INT64 getTaskOffset(const tPhaseTask* pTask_p, INT64 period_p)
+{
+    if (pTask_p->offsetUs < 0)
+        return period_p + ((INT64)pTask_p->offsetUs * 1000);
+
+    return (INT64)pTask_p->offsetUs * 1000;
+}
+
+/// \}
@@ -0,0 +1,86 @@
+/**
+********************************************************************************
+\file   phase.h
+
+\brief  Definitions for the phase-locked application scheduler
+
+The file contains the definitions for the phase-locked application scheduler
+of the MN demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_phase_H_
+#define _INC_phase_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <limits.h>
+
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PHASE_MAX_TASKS             8           ///< Maximum number of scheduled tasks
+#define PHASE_OFFSET_NONE           INT_MIN     ///< No output offset configured
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Phase task callback
+
+The type describes a task executed by the phase-locked scheduler.
+*/
+typedef void (*tPhaseTaskCb)(void* pArg_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void       phase_init(UINT32 cycleLenUs_p, int outputOffsetUs_p);
+void       phase_setCycleLen(UINT32 cycleLenUs_p);
+BOOL       phase_getOutputOffset(int* pOffsetUs_p);
+tOplkError phase_addTask(const char* pName_p, int offsetUs_p,
+                         tPhaseTaskCb pfnTask_p, void* pArg_p);
+void       phase_syncEvent(void);
+void       phase_runTasks(void);
+void       phase_printStatistics(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_phase_H_ */
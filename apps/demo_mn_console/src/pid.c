@@ -0,0 +1,810 @@
+/**
+********************************************************************************
+\file   pid.c
+
+\brief  PID controller bank of the MN demo application
+
+This file contains a bank of PID controllers which is executed in the
+synchronous data handler of the MN demo application.
+
+The process value and the output of every loop are analog channels with their
+engineering values provided by the scaling (scale.c). The loops are read from
+a configuration file:
+
+    # name  process value        output               setpoint kp  ki  kd   min max  [options]
+    TIC1    CN1.M01.AI_00h.Temp  CN1.M02.AO_00h.Heat  80.0     2.0 0.5 0.1  0   100  tf=0.01
+
+The integral gain is given in 1/s, the derivative gain in s. Options:
+- tf=T: time constant of the derivative filter [s]
+- imin=X, imax=X: anti-windup limits of the integral part (default min/max)
+- manual: the loop starts disabled
+
+The state and the parameters of all loops are kept in separate arrays and
+all loops are updated by one vector kernel. A disabled loop tracks its
+output, so enabling it is bumpless. Changes from other threads are queued and
+applied at the beginning of the next cycle. The queue has a single consumer,
+the synchronous data handler; concurrent posters are serialized by a spin
+lock, so the handler never waits.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "scale.h"
+#include "simd.h"
+#include "pid.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PID_LINE_LEN            512         // maximum length of a line in the configuration
+#define PID_REQUEST_TIMEOUT     100         // time to wait for a free queue entry [ms]
+#define PID_REQUEST_QUEUE_LEN   64          // number of queued change requests (power of 2)
+
+#if defined(_MSC_VER)
+#define PID_CAS(pVal, cmp, val)     _InterlockedCompareExchange((volatile long*)(pVal), (val), (cmp))
+#else
+#define PID_CAS(pVal, cmp, val)     __sync_val_compare_and_swap((pVal), (cmp), (val))
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Request types
+
+The enumeration lists the changes requested by other threads.
+*/
+typedef enum
+{
+    kPidRequestEnable = 0,                      ///< Enable or disable a loop
+    kPidRequestSetpoint,                    ///< Change the setpoint of a loop
+    kPidRequestTuning                       ///< Change the gains of a loop
+} tPidRequestType;
+
+/**
+\brief  Change request
+
+The structure contains a change requested by another thread. It is applied by
+the synchronous data handler at the beginning of the next cycle.
+*/
+typedef struct
+{
+    UINT            type;                   ///< Request type (tPidRequestType)
+    UINT            loop;                   ///< Index of the loop
+    float           aValue[3];              ///< Request values
+} tPidRequest;
+
+/**
+\brief  PID controller bank
+
+The structure contains the PID controller bank. Every parameter and state
+variable is stored in its own array, so the kernel processes contiguous data.
+The arrays are processed in whole vectors, unused entries are zero.
+*/
+typedef struct
+{
+    float           aSetpoint[PID_MAX_LOOPS];   ///< Setpoints
+    float           aKp[PID_MAX_LOOPS];         ///< Proportional gains
+    float           aKiDt[PID_MAX_LOOPS];       ///< Integral gains multiplied by the cycle time
+    float           aKdDt[PID_MAX_LOOPS];       ///< Derivative gains divided by the cycle time
+    float           aAlpha[PID_MAX_LOOPS];      ///< Derivative filter coefficients
+    float           aIMin[PID_MAX_LOOPS];       ///< Lower limits of the integral part
+    float           aIMax[PID_MAX_LOOPS];       ///< Upper limits of the integral part
+    float           aMin[PID_MAX_LOOPS];        ///< Lower output limits
+    float           aMax[PID_MAX_LOOPS];        ///< Upper output limits
+    float           aEnable[PID_MAX_LOOPS];     ///< 1.0 if the loop is enabled, 0.0 otherwise
+    float           aInteg[PID_MAX_LOOPS];      ///< Integral parts
+    float           aDeriv[PID_MAX_LOOPS];      ///< Filtered derivative parts
+    float           aPvPrev[PID_MAX_LOOPS];     ///< Process values of the previous cycle
+    float           aPv[PID_MAX_LOOPS];         ///< Process values of the current cycle
+    float           aCv[PID_MAX_LOOPS];         ///< Outputs
+    UINT            aPvIndex[PID_MAX_LOOPS];    ///< Indexes of the process values
+    UINT            aCvIndex[PID_MAX_LOOPS];    ///< Indexes of the outputs
+    char            aName[PID_MAX_LOOPS][PID_NAME_LEN]; ///< Loop names
+    UINT            loopCount;                  ///< Number of loops
+    float           cycleTime;                  ///< Cycle time [s]
+    float*          pValues;                    ///< Values the loops are bound to
+    BOOL            fFirstCycle;                ///< No previous process values available
+    tPidRequest     aRequest[PID_REQUEST_QUEUE_LEN];    ///< Queued change requests
+    volatile UINT   requestHead;                ///< Requests posted, written by the posters
+    volatile UINT   requestTail;                ///< Requests applied, written by the handler
+    volatile long   postLock;                   ///< Serializes the posters (1 = locked)
+} tPidInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPidInstance     pidInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p);
+static tOplkError addLoop(const char* pszName_p, UINT pvIndex_p, UINT cvIndex_p, const float* pParam_p,
+                          float tf_p, float iMin_p, float iMax_p, BOOL fEnable_p);
+static tOplkError postRequest(tPidRequestType type_p, UINT loop_p, float value1_p, float value2_p,
+                              float value3_p);
+static void       applyRequests(void);
+static void       applyRequest(const tPidRequest* pRequest_p);
+static void       kernelUpdate(tPidInstance* pInst_p, UINT count_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the PID controller bank
+
+The function loads the loop configuration. The channels are looked up in the
+scaling, which must be initialized before.
+
+\param  pszConfigFile_p         File name of the loop configuration.
+\param  cycleLenUs_p            Cycle length [us].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError pid_init(const char* pszConfigFile_p, UINT32 cycleLenUs_p)
+{
+    FILE*           pFile;
+    char            aLine[PID_LINE_LEN];
+    UINT            lineNo = 0;
+    tOplkError      ret = kErrorOk;
+
+    memset(&pidInstance_l, 0, sizeof(pidInstance_l));
+    if (cycleLenUs_p == 0)
+        return kErrorApiInvalidParam;
+
+    pidInstance_l.cycleTime = (float)cycleLenUs_p / 1000000.0f;
+    pidInstance_l.pValues = scale_getValues();
+    pidInstance_l.fFirstCycle = TRUE;
+
+    pFile = fopen(pszConfigFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open controller configuration %s!\n", pszConfigFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        ret = parseLine(aLine);
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid controller of line %u in %s!\n", lineNo, pszConfigFile_p);
+        return ret;
+    }
+
+    printf("Running %u control loops every %lu us (%s kernel)\n",
+           pidInstance_l.loopCount, (ULONG)cycleLenUs_p, SIMD_NAME);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the control loops
+
+The function updates all control loops. It is called by the synchronous data
+handler after the inputs have been scaled and before the outputs are scaled.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void pid_process(void)
+{
+    tPidInstance*   pInst = &pidInstance_l;
+    UINT            i;
+
+    if (pInst->loopCount == 0)
+        return;
+
+    applyRequests();
+
+    for (i = 0; i < pInst->loopCount; i++)
+    {
+        pInst->aPv[i] = pInst->pValues[pInst->aPvIndex[i]];
+        pInst->aCv[i] = pInst->pValues[pInst->aCvIndex[i]];
+    }
+
+    // there is no derivative in the first cycle
+    if (pInst->fFirstCycle)
+    {
+        memcpy(pInst->aPvPrev, pInst->aPv, pInst->loopCount * sizeof(float));
+        pInst->fFirstCycle = FALSE;
+    }
+
+    kernelUpdate(pInst, pInst->loopCount);
+
+    for (i = 0; i < pInst->loopCount; i++)
+        pInst->pValues[pInst->aCvIndex[i]] = pInst->aCv[i];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find a control loop by name
+
+\param  pszName_p               Name of the loop.
+
+\return The function returns the index of the loop or -1 if it is not found.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int pid_findLoop(const char* pszName_p)
+{
+    UINT    i;
+
+    for (i = 0; i < pidInstance_l.loopCount; i++)
+    {
+        if (strcmp(pidInstance_l.aName[i], pszName_p) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable or disable a control loop
+
+A disabled loop leaves its output unchanged and tracks it, so it continues
+from the current output when it is enabled again.
+
+\param  loop_p                  Index of the loop.
+\param  fEnable_p               TRUE to enable the loop.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError pid_setEnable(UINT loop_p, BOOL fEnable_p)
+{
+    return postRequest(kPidRequestEnable, loop_p, fEnable_p ? 1.0f : 0.0f, 0.0f, 0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change the setpoint of a control loop
+
+\param  loop_p                  Index of the loop.
+\param  setpoint_p              New setpoint.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError pid_setSetpoint(UINT loop_p, float setpoint_p)
+{
+    return postRequest(kPidRequestSetpoint, loop_p, setpoint_p, 0.0f, 0.0f);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change the gains of a control loop
+
+The integral part is corrected, so the output does not jump.
+
+\param  loop_p                  Index of the loop.
+\param  kp_p                    Proportional gain.
+\param  ki_p                    Integral gain [1/s].
+\param  kd_p                    Derivative gain [s].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError pid_setTuning(UINT loop_p, float kp_p, float ki_p, float kd_p)
+{
+    return postRequest(kPidRequestTuning, loop_p, kp_p, ki_p, kd_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the state of the control loops
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void pid_printStatus(void)
+{
+    const tPidInstance* pInst = &pidInstance_l;
+    UINT                i;
+
+    if (pInst->loopCount == 0)
+    {
+        printf("No control loops configured\n");
+        return;
+    }
+
+    printf("Control loops:\n");
+    for (i = 0; i < pInst->loopCount; i++)
+    {
+        printf("  %-16s %-6s SP %10.3f  PV %10.3f  OUT %10.3f\n", pInst->aName[i],
+               (pInst->aEnable[i] != 0.0f) ? "auto" : "manual",
+               pInst->aSetpoint[i], pInst->aPv[i], pInst->aCv[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Benchmark the PID controller bank
+
+The function measures the update time of the given number of loops, each
+controlling a simulated first order plant. The configuration of the
+controller bank is replaced.
+
+\param  loopCount_p             Number of loops.
+\param  cycleCount_p            Number of measured cycles.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void pid_benchmark(UINT loopCount_p, UINT cycleCount_p)
+{
+    float*          pValues;
+    float           aParam[6];
+    UINT            i;
+    UINT            cycle;
+    UINT64          start;
+    UINT64          time;
+    UINT64          minTime = ~0ULL;
+    UINT64          maxTime = 0;
+    UINT64          sumTime = 0;
+
+    if ((loopCount_p == 0) || (cycleCount_p == 0))
+        return;
+
+    if (loopCount_p > PID_MAX_LOOPS)
+        loopCount_p = PID_MAX_LOOPS;
+
+    pValues = (float*)calloc(loopCount_p * 2, sizeof(float));
+    if (pValues == NULL)
+        return;
+
+    memset(&pidInstance_l, 0, sizeof(pidInstance_l));
+    pidInstance_l.cycleTime = 50e-6f;
+    pidInstance_l.pValues = pValues;
+    pidInstance_l.fFirstCycle = TRUE;
+
+    for (i = 0; i < loopCount_p; i++)
+    {
+        // setpoint, kp, ki, kd, min, max
+        aParam[0] = (float)(i % 100);
+        aParam[1] = 2.0f;
+        aParam[2] = 10.0f;
+        aParam[3] = 0.0001f;
+        aParam[4] = 0.0f;
+        aParam[5] = 100.0f;
+        addLoop("bench", i, loopCount_p + i, aParam, 0.001f, -FLT_MAX, FLT_MAX, TRUE);
+    }
+
+    for (cycle = 0; cycle < cycleCount_p; cycle++)
+    {
+        start = system_getTimeNs();
+        pid_process();
+        time = system_getTimeNs() - start;
+
+        if (time < minTime)
+            minTime = time;
+        if (time > maxTime)
+            maxTime = time;
+        sumTime += time;
+
+        // simulated plants
+        for (i = 0; i < loopCount_p; i++)
+            pValues[i] += (pValues[loopCount_p + i] - pValues[i]) * 0.01f;
+    }
+
+    printf("PID controller bank: %u loops, %s kernel\n", loopCount_p, SIMD_NAME);
+    printf("  Cycle time min/avg/max: %lu / %lu / %lu ns, %.1f ns per loop\n",
+           (ULONG)minTime, (ULONG)(sumTime / cycleCount_p), (ULONG)maxTime,
+           (double)sumTime / cycleCount_p / loopCount_p);
+
+    memset(&pidInstance_l, 0, sizeof(pidInstance_l));
+    free(pValues);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a line of the loop configuration
+
+\param  pLine_p                 Pointer to the line, it is modified.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p)
+{
+    char*           apToken[16];
+    char*           pToken;
+    char*           pComment;
+    char*           pEnd;
+    UINT            tokenCount = 0;
+    float           aParam[6];
+    float           tf = 0.0f;
+    float           iMin;
+    float           iMax;
+    BOOL            fEnable = TRUE;
+    int             pvIndex;
+    int             cvIndex;
+    UINT            i;
+
+    pComment = strchr(pLine_p, '#');
+    if (pComment != NULL)
+        *pComment = '\0';
+
+    for (pToken = strtok(pLine_p, " \t\r\n"); pToken != NULL; pToken = strtok(NULL, " \t\r\n"))
+    {
+        if (tokenCount >= 16)
+            return kErrorApiInvalidParam;
+        apToken[tokenCount++] = pToken;
+    }
+
+    if (tokenCount == 0)
+        return kErrorOk;
+    if ((tokenCount < 9) || (strlen(apToken[0]) >= PID_NAME_LEN))
+        return kErrorApiInvalidParam;
+
+    pvIndex = scale_findValue(apToken[1]);
+    cvIndex = scale_findValue(apToken[2]);
+    if ((pvIndex < 0) || (cvIndex < 0))
+    {
+        fprintf(stderr, "Channels of loop %s are not scaled!\n", apToken[0]);
+        return kErrorApiInvalidParam;
+    }
+
+    // setpoint, kp, ki, kd, min, max
+    for (i = 0; i < 6; i++)
+    {
+        aParam[i] = (float)strtod(apToken[3 + i], &pEnd);
+        if (*pEnd != '\0')
+            return kErrorApiInvalidParam;
+    }
+    iMin = aParam[4];
+    iMax = aParam[5];
+
+    for (i = 9; i < tokenCount; i++)
+    {
+        if (strncmp(apToken[i], "tf=", 3) == 0)
+            tf = (float)strtod(apToken[i] + 3, &pEnd);
+        else if (strncmp(apToken[i], "imin=", 5) == 0)
+            iMin = (float)strtod(apToken[i] + 5, &pEnd);
+        else if (strncmp(apToken[i], "imax=", 5) == 0)
+            iMax = (float)strtod(apToken[i] + 5, &pEnd);
+        else if (strcmp(apToken[i], "manual") == 0)
+        {
+            fEnable = FALSE;
+            continue;
+        }
+        else
+            return kErrorApiInvalidParam;
+
+        if (*pEnd != '\0')
+            return kErrorApiInvalidParam;
+    }
+
+    return addLoop(apToken[0], (UINT)pvIndex, (UINT)cvIndex, aParam, tf, iMin, iMax, fEnable);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a control loop
+
+\param  pszName_p               Name of the loop.
+\param  pvIndex_p               Index of the process value.
+\param  cvIndex_p               Index of the output.
+\param  pParam_p                Pointer to setpoint, kp, ki, kd, min and max.
+\param  tf_p                    Time constant of the derivative filter [s].
+\param  iMin_p                  Lower limit of the integral part.
+\param  iMax_p                  Upper limit of the integral part.
+\param  fEnable_p               The loop is enabled.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError addLoop(const char* pszName_p, UINT pvIndex_p, UINT cvIndex_p, const float* pParam_p,
+                          float tf_p, float iMin_p, float iMax_p, BOOL fEnable_p)
+{
+    tPidInstance*   pInst = &pidInstance_l;
+    UINT            i = pInst->loopCount;
+
+    if (i >= PID_MAX_LOOPS)
+        return kErrorNoResource;
+
+    if ((pParam_p[4] > pParam_p[5]) || (iMin_p > iMax_p) || (tf_p < 0.0f))
+        return kErrorApiInvalidParam;
+
+    strncpy(pInst->aName[i], pszName_p, PID_NAME_LEN - 1);
+    pInst->aPvIndex[i] = pvIndex_p;
+    pInst->aCvIndex[i] = cvIndex_p;
+    pInst->aSetpoint[i] = pParam_p[0];
+    pInst->aKp[i] = pParam_p[1];
+    pInst->aKiDt[i] = pParam_p[2] * pInst->cycleTime;
+    pInst->aKdDt[i] = pParam_p[3] / pInst->cycleTime;
+    pInst->aMin[i] = pParam_p[4];
+    pInst->aMax[i] = pParam_p[5];
+    pInst->aAlpha[i] = tf_p / (tf_p + pInst->cycleTime);
+    pInst->aIMin[i] = iMin_p;
+    pInst->aIMax[i] = iMax_p;
+    pInst->aEnable[i] = fEnable_p ? 1.0f : 0.0f;
+
+    pInst->loopCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post a change request
+
+The function queues a change for the synchronous data handler. If the queue
+is full, it waits for the handler to apply queued requests.
+
+\param  type_p                  Request type.
+\param  loop_p                  Index of the loop.
+\param  value1_p                First request value.
+\param  value2_p                Second request value.
+\param  value3_p                Third request value.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError postRequest(tPidRequestType type_p, UINT loop_p, float value1_p, float value2_p,
+                              float value3_p)
+{
+    tPidInstance*   pInst = &pidInstance_l;
+    tPidRequest*    pRequest;
+    UINT            head;
+    UINT            wait;
+
+    if (loop_p >= pInst->loopCount)
+        return kErrorApiInvalidParam;
+
+    while (PID_CAS(&pInst->postLock, 0, 1) != 0)
+        system_msleep(1);
+
+    head = pInst->requestHead;
+    for (wait = 0; ((head - pInst->requestTail) >= PID_REQUEST_QUEUE_LEN) && (wait < PID_REQUEST_TIMEOUT); wait++)
+        system_msleep(1);
+
+    if ((head - pInst->requestTail) >= PID_REQUEST_QUEUE_LEN)
+    {
+        system_memoryBarrier();
+        pInst->postLock = 0;
+        return kErrorNoResource;
+    }
+
+    pRequest = &pInst->aRequest[head & (PID_REQUEST_QUEUE_LEN - 1)];
+    pRequest->type = type_p;
+    pRequest->loop = loop_p;
+    pRequest->aValue[0] = value1_p;
+    pRequest->aValue[1] = value2_p;
+    pRequest->aValue[2] = value3_p;
+    system_memoryBarrier();
+    pInst->requestHead = head + 1;
+
+    system_memoryBarrier();
+    pInst->postLock = 0;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the queued change requests
+
+The function applies all requests queued until now in the order they were
+posted.
+*/
+//------------------------------------------------------------------------------
+static void applyRequests(void)
+{
+    tPidInstance*   pInst = &pidInstance_l;
+    UINT            head = pInst->requestHead;
+    UINT            tail = pInst->requestTail;
+
+    if (head == tail)
+        return;
+
+    system_memoryBarrier();
+    for (; tail != head; tail++)
+        applyRequest(&pInst->aRequest[tail & (PID_REQUEST_QUEUE_LEN - 1)]);
+
+    system_memoryBarrier();
+    pInst->requestTail = tail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply a change request
+
+\param  pRequest_p              Pointer to the request.
+*/
+//------------------------------------------------------------------------------
+static void applyRequest(const tPidRequest* pRequest_p)
+{
+    tPidInstance*   pInst = &pidInstance_l;
+    UINT            i = pRequest_p->loop;
+    float           error;
+    float           kp;
+    float           kdDt;
+    float           deriv;
+
+    switch (pRequest_p->type)
+    {
+        case kPidRequestEnable:
+            pInst->aEnable[i] = pRequest_p->aValue[0];
+            break;
+
+        case kPidRequestSetpoint:
+            pInst->aSetpoint[i] = pRequest_p->aValue[0];
+            break;
+
+        case kPidRequestTuning:
+            // move the change of the proportional and derivative parts into
+            // the integral part, so the output continues smoothly
+            kp = pRequest_p->aValue[0];
+            kdDt = pRequest_p->aValue[2] / pInst->cycleTime;
+            error = pInst->aSetpoint[i] - pInst->aPvPrev[i];
+            deriv = (pInst->aKdDt[i] != 0.0f) ? pInst->aDeriv[i] * kdDt / pInst->aKdDt[i] : 0.0f;
+
+            pInst->aInteg[i] += (pInst->aKp[i] - kp) * error + (pInst->aDeriv[i] - deriv);
+            pInst->aDeriv[i] = deriv;
+            pInst->aKp[i] = kp;
+            pInst->aKiDt[i] = pRequest_p->aValue[1] * pInst->cycleTime;
+            pInst->aKdDt[i] = kdDt;
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the control loops
+
+The function calculates the new outputs of all loops:
+
+    p     = kp * (sp - pv)
+    d     = alpha * d + (1 - alpha) * kd / dt * (pvPrev - pv)
+    i     = clamp(i + ki * dt * (sp - pv), imin, imax, min - p - d, max - p - d)
+    out   = clamp(p + i + d, min, max)
+
+The derivative acts on the process value only, so setpoint changes do not
+cause spikes. A disabled loop keeps its output and sets i = out - p - d.
+Enabled and disabled loops are blended arithmetically, so the kernel contains
+no branches. The number of loops is rounded up to whole vectors.
+
+\param  pInst_p                 Pointer to the controller bank.
+\param  count_p                 Number of loops.
+*/
+//------------------------------------------------------------------------------
+static void kernelUpdate(tPidInstance* pInst_p, UINT count_p)
+{
+    UINT        i;
+    tSimdVec    pv;
+    tSimdVec    cv;
+    tSimdVec    error;
+    tSimdVec    prop;
+    tSimdVec    deriv;
+    tSimdVec    propDeriv;
+    tSimdVec    integ;
+    tSimdVec    track;
+    tSimdVec    out;
+    tSimdVec    enable;
+    tSimdVec    alpha;
+
+    count_p = (count_p + SIMD_WIDTH - 1) & ~(UINT)(SIMD_WIDTH - 1);
+
+    for (i = 0; i < count_p; i += SIMD_WIDTH)
+    {
+        pv = SIMD_LOAD(&pInst_p->aPv[i]);
+        cv = SIMD_LOAD(&pInst_p->aCv[i]);
+        enable = SIMD_LOAD(&pInst_p->aEnable[i]);
+        alpha = SIMD_LOAD(&pInst_p->aAlpha[i]);
+
+        error = SIMD_SUB(SIMD_LOAD(&pInst_p->aSetpoint[i]), pv);
+        prop = SIMD_MUL(SIMD_LOAD(&pInst_p->aKp[i]), error);
+
+        deriv = SIMD_MUL(SIMD_LOAD(&pInst_p->aKdDt[i]), SIMD_SUB(SIMD_LOAD(&pInst_p->aPvPrev[i]), pv));
+        deriv = SIMD_ADD(deriv, SIMD_MUL(alpha, SIMD_SUB(SIMD_LOAD(&pInst_p->aDeriv[i]), deriv)));
+        propDeriv = SIMD_ADD(prop, deriv);
+
+        // anti-windup: limit the integral part and keep the output within its limits
+        integ = SIMD_ADD(SIMD_LOAD(&pInst_p->aInteg[i]), SIMD_MUL(SIMD_LOAD(&pInst_p->aKiDt[i]), error));
+        integ = SIMD_MIN(SIMD_MAX(integ, SIMD_LOAD(&pInst_p->aIMin[i])), SIMD_LOAD(&pInst_p->aIMax[i]));
+        integ = SIMD_MIN(SIMD_MAX(integ, SIMD_SUB(SIMD_LOAD(&pInst_p->aMin[i]), propDeriv)),
+                         SIMD_SUB(SIMD_LOAD(&pInst_p->aMax[i]), propDeriv));
+        out = SIMD_ADD(propDeriv, integ);
+        out = SIMD_MIN(SIMD_MAX(out, SIMD_LOAD(&pInst_p->aMin[i])), SIMD_LOAD(&pInst_p->aMax[i]));
+
+        // bumpless transfer: a disabled loop tracks its output
+        track = SIMD_SUB(cv, propDeriv);
+        integ = SIMD_ADD(track, SIMD_MUL(enable, SIMD_SUB(integ, track)));
+        out = SIMD_ADD(cv, SIMD_MUL(enable, SIMD_SUB(out, cv)));
+
+        SIMD_STORE(&pInst_p->aInteg[i], integ);
+        SIMD_STORE(&pInst_p->aDeriv[i], deriv);
+        SIMD_STORE(&pInst_p->aPvPrev[i], pv);
+        SIMD_STORE(&pInst_p->aCv[i], out);
+    }
+}
+
+/// \}
@@ -0,0 +1,402 @@
+/**
+********************************************************************************
+\file   pidesc.c
+
+\brief  Process image description of the MN demo application
+
+This file contains the reader of the process image description (xap.xml)
+generated by openCONFIGURATOR. It provides the name, data type and location of
+every channel of the process images.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "pidesc.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PIDESC_LINE_LEN         512         // maximum length of a line in xap.xml
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Process image channels
+
+The structure contains the channels of a process image sorted by offset.
+*/
+typedef struct
+{
+    tPiDescChannel  aChannel[PIDESC_MAX_CHANNELS];  ///< Channels
+    UINT            channelCount;                   ///< Number of channels
+} tPiDescImageInfo;
+
+/**
+\brief  Data type name
+
+The structure assigns a data type to its name in xap.xml.
+*/
+typedef struct
+{
+    const char*     pszName;                ///< Name in xap.xml
+    tPiDescType     type;                   ///< Data type
+} tPiDescTypeName;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPiDescImageInfo     aImage_l[kPiDescImageCount];
+
+static const char*          aImageType_l[kPiDescImageCount] = { "output", "input" };
+
+static const tPiDescTypeName aTypeName_l[] =
+{
+    { "Integer8",   kPiDescTypeInteger8   },
+    { "Unsigned8",  kPiDescTypeUnsigned8  },
+    { "Integer16",  kPiDescTypeInteger16  },
+    { "Unsigned16", kPiDescTypeUnsigned16 },
+    { "Integer32",  kPiDescTypeInteger32  },
+    { "Unsigned32", kPiDescTypeUnsigned32 },
+    { "Real32",     kPiDescTypeReal32     },
+    { "Integer64",  kPiDescTypeInteger64  },
+    { "Unsigned64", kPiDescTypeUnsigned64 },
+    { "Real64",     kPiDescTypeReal64     },
+    { NULL,         kPiDescTypeUnknown    }
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError   readChannel(const char* pLine_p, tPiDescImageInfo* pImage_p);
+static BOOL         getAttribute(const char* pLine_p, const char* pszName_p, char* pValue_p,
+                                 size_t valueSize_p);
+static tPiDescType  getType(const char* pszTypeName_p);
+static int          compareChannel(const void* pLeft_p, const void* pRight_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load the process image description
+
+The function reads the channels of both process images from xap.xml.
+
+\param  pszXapFile_p            File name of xap.xml.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError pidesc_load(const char* pszXapFile_p)
+{
+    FILE*               pFile;
+    char                aLine[PIDESC_LINE_LEN];
+    char                aValue[PIDESC_TYPE_LEN];
+    tPiDescImageInfo*   pImage = NULL;
+    UINT                i;
+    tOplkError          ret = kErrorOk;
+
+    memset(aImage_l, 0, sizeof(aImage_l));
+
+    pFile = fopen(pszXapFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open process image file %s!\n", pszXapFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        if (strstr(aLine, "<ProcessImage") != NULL)
+        {
+            pImage = NULL;
+            if (getAttribute(aLine, "type", aValue, sizeof(aValue)))
+            {
+                for (i = 0; i < kPiDescImageCount; i++)
+                {
+                    if (strcmp(aValue, aImageType_l[i]) == 0)
+                        pImage = &aImage_l[i];
+                }
+            }
+        }
+        else if ((strstr(aLine, "<Channel") != NULL) && (pImage != NULL))
+        {
+            ret = readChannel(aLine, pImage);
+        }
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid channel in process image file %s!\n", pszXapFile_p);
+        return ret;
+    }
+
+    for (i = 0; i < kPiDescImageCount; i++)
+    {
+        qsort(aImage_l[i].aChannel, aImage_l[i].channelCount, sizeof(tPiDescChannel),
+              compareChannel);
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of channels of a process image
+
+\param  image_p                 Process image.
+
+\return The function returns the number of channels.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+UINT pidesc_getChannelCount(tPiDescImage image_p)
+{
+    return aImage_l[image_p].channelCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get a channel of a process image
+
+\param  image_p                 Process image.
+\param  index_p                 Index of the channel in the order of offsets.
+
+\return The function returns a pointer to the channel or NULL if the index is
+        invalid.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const tPiDescChannel* pidesc_getChannel(tPiDescImage image_p, UINT index_p)
+{
+    if (index_p >= aImage_l[image_p].channelCount)
+        return NULL;
+
+    return &aImage_l[image_p].aChannel[index_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find a channel by name
+
+The function searches both process images for a channel.
+
+\param  pszName_p               Channel name as in xap.xml.
+\param  pImage_p                Pointer to store the process image containing
+                                the channel.
+
+\return The function returns a pointer to the channel or NULL if it is not
+        found.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const tPiDescChannel* pidesc_findChannel(const char* pszName_p, tPiDescImage* pImage_p)
+{
+    UINT    i;
+    UINT    ch;
+
+    for (i = 0; i < kPiDescImageCount; i++)
+    {
+        for (ch = 0; ch < aImage_l[i].channelCount; ch++)
+        {
+            if (strcmp(aImage_l[i].aChannel[ch].aName, pszName_p) == 0)
+            {
+                *pImage_p = (tPiDescImage)i;
+                return &aImage_l[i].aChannel[ch];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a channel
+
+\param  pLine_p                 Pointer to the Channel element.
+\param  pImage_p                Pointer to the process image of the channel.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError readChannel(const char* pLine_p, tPiDescImageInfo* pImage_p)
+{
+    tPiDescChannel*     pChannel;
+    char                aValue[PIDESC_TYPE_LEN];
+
+    if (pImage_p->channelCount >= PIDESC_MAX_CHANNELS)
+        return kErrorNoResource;
+
+    pChannel = &pImage_p->aChannel[pImage_p->channelCount];
+    if (!getAttribute(pLine_p, "Name", pChannel->aName, sizeof(pChannel->aName)) ||
+        !getAttribute(pLine_p, "dataType", pChannel->aTypeName, sizeof(pChannel->aTypeName)) ||
+        !getAttribute(pLine_p, "dataSize", aValue, sizeof(aValue)))
+        return kErrorApiInvalidParam;
+
+    pChannel->type = getType(pChannel->aTypeName);
+    pChannel->size = (UINT)strtoul(aValue, NULL, 0);
+
+    pChannel->offset = 0;
+    if (getAttribute(pLine_p, "PIOffset", aValue, sizeof(aValue)))
+        pChannel->offset = (UINT)strtoul(aValue, NULL, 0) * 8;
+    if (getAttribute(pLine_p, "BitOffset", aValue, sizeof(aValue)))
+        pChannel->offset += (UINT)strtoul(aValue, NULL, 0);
+
+    pImage_p->channelCount++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get an XML attribute
+
+\param  pLine_p                 Pointer to the XML line.
+\param  pszName_p               Name of the attribute.
+\param  pValue_p                Pointer to store the attribute value.
+\param  valueSize_p             Size of the value buffer.
+
+\return The function returns TRUE if the attribute was found.
+*/
+//------------------------------------------------------------------------------
+static BOOL getAttribute(const char* pLine_p, const char* pszName_p, char* pValue_p,
+                         size_t valueSize_p)
+{
+    const char*     pPos = pLine_p;
+    const char*     pEnd;
+    size_t          nameLen = strlen(pszName_p);
+    size_t          valueLen;
+
+    while ((pPos = strstr(pPos, pszName_p)) != NULL)
+    {
+        if ((pPos > pLine_p) && (pPos[-1] == ' ') && (strncmp(pPos + nameLen, "=\"", 2) == 0))
+        {
+            pPos += nameLen + 2;
+            pEnd = strchr(pPos, '"');
+            if (pEnd == NULL)
+                return FALSE;
+
+            valueLen = (size_t)(pEnd - pPos);
+            if (valueLen >= valueSize_p)
+                valueLen = valueSize_p - 1;
+            memcpy(pValue_p, pPos, valueLen);
+            pValue_p[valueLen] = '\0';
+            return TRUE;
+        }
+        pPos += nameLen;
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the data type of a channel
+
+\param  pszTypeName_p           Data type name in xap.xml.
+
+\return The function returns the data type.
+*/
+//------------------------------------------------------------------------------
+static tPiDescType getType(const char* pszTypeName_p)
+{
+    const tPiDescTypeName*  pTypeName;
+
+    for (pTypeName = aTypeName_l; pTypeName->pszName != NULL; pTypeName++)
+    {
+        if (strcmp(pTypeName->pszName, pszTypeName_p) == 0)
+            return pTypeName->type;
+    }
+
+    return kPiDescTypeUnknown;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare process image channels by offset
+
+\param  pLeft_p                 Pointer to the first channel.
+\param  pRight_p                Pointer to the second channel.
+
+\return The function returns the comparison result for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareChannel(const void* pLeft_p, const void* pRight_p)
+{
+    const tPiDescChannel*   pLeft = (const tPiDescChannel*)pLeft_p;
+    const tPiDescChannel*   pRight = (const tPiDescChannel*)pRight_p;
+
+    return (pLeft->offset < pRight->offset) ? -1 : (pLeft->offset > pRight->offset);
+}
+
+/// \}
@@ -0,0 +1,121 @@
+/**
+********************************************************************************
+\file   pidesc.h
+
+\brief  Definitions for the process image description
+
+The file contains the definitions for the process image description (xap.xml)
+reader of the MN demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_pidesc_H_
+#define _INC_pidesc_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PIDESC_MAX_CHANNELS         1024    ///< Maximum number of channels of a process image
+#define PIDESC_NAME_LEN             128     ///< Maximum length of a channel name
+#define PIDESC_TYPE_LEN             32      ///< Maximum length of a data type name
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Process images
+
+The enumeration lists the process images of the MN. The output image contains
+the data received from the CNs, the input image the data sent to the CNs.
+*/
+typedef enum
+{
+    kPiDescImageOut = 0,                    ///< Output process image (PI_OUT)
+    kPiDescImageIn,                         ///< Input process image (PI_IN)
+    kPiDescImageCount
+} tPiDescImage;
+
+/**
+\brief  Channel data types
+
+The enumeration lists the data types of process image channels.
+*/
+typedef enum
+{
+    kPiDescTypeUnknown = 0,
+    kPiDescTypeInteger8,
+    kPiDescTypeUnsigned8,
+    kPiDescTypeInteger16,
+    kPiDescTypeUnsigned16,
+    kPiDescTypeInteger32,
+    kPiDescTypeUnsigned32,
+    kPiDescTypeReal32,
+    kPiDescTypeInteger64,
+    kPiDescTypeUnsigned64,
+    kPiDescTypeReal64
+} tPiDescType;
+
+/**
+\brief  Process image channel
+
+The structure describes a channel of a process image.
+*/
+typedef struct
+{
+    char            aName[PIDESC_NAME_LEN]; ///< Channel name
+    char            aTypeName[PIDESC_TYPE_LEN]; ///< Data type name
+    tPiDescType     type;                   ///< Data type
+    UINT            size;                   ///< Size of the channel [bits]
+    UINT            offset;                 ///< Offset in the process image [bits]
+} tPiDescChannel;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError            pidesc_load(const char* pszXapFile_p);
+UINT                  pidesc_getChannelCount(tPiDescImage image_p);
+const tPiDescChannel* pidesc_getChannel(tPiDescImage image_p, UINT index_p);
+const tPiDescChannel* pidesc_findChannel(const char* pszName_p, tPiDescImage* pImage_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_pidesc_H_ */
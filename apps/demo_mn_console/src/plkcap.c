@@ -0,0 +1,964 @@
+/**
+********************************************************************************
+\file   plkcap.c
+
+\brief  POWERLINK capture analyzer
+
+This file contains a tool which analyzes the timing of a POWERLINK network
+from a capture (pcap or pcapng, e.g. recorded with tcpdump or Wireshark).
+
+The frames are grouped into cycles starting with a SoC. The tool reports
+- the SoC period and its deviation from the cycle length (0x1006),
+- the PRes latency of every CN, compared with its PRes timeout (0x1F92),
+- the usage of the asynchronous slot: invitations, answers and frames,
+- the payload sizes of PReq and PRes, compared with the payload limits
+  (0x1F8B, 0x1F8D), and the asynchronous frame sizes compared with the
+  asynchronous MTU (0x1F98/8).
+The configured values are read from the CDC of the MN if one is given.
+
+The capture file is mapped into memory and split into chunks which are
+decoded in parallel. A cycle belongs to the chunk containing its SoC; the
+decoder of a chunk continues into the next chunk until the next SoC. After
+all chunks are decoded, the start of every chunk is compared with the end of
+the walk through the previous chunk. A chunk which started at a wrong
+offset is decoded again.
+
+The PRes latency is the time from the end of the PReq to the start of the
+PRes. The capture timestamps are taken at the end of a frame, so the
+transmission time of the PRes at 100 Mbit/s is subtracted.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <getopt/getopt.h>
+
+#include "plkframe.h"
+#include "capfile.h"
+#include "cdc.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PLKCAP_MAX_THREADS          64          // maximum number of decoder threads
+#define PLKCAP_NODE_COUNT           256         // node IDs
+#define PLKCAP_NS_PER_BYTE          80          // transmission time at 100 Mbit/s
+#define PLKCAP_FRAME_OVERHEAD       12          // preamble, SFD and FCS [bytes]
+#define PLKCAP_ASYNC_OTHER          0           // asynchronous frame which is no ASnd
+#define PLKCAP_ASND_SERVICES        6           // counted ASnd service IDs (1 to 5, 0 for others)
+
+#define PLKCAP_CYCLE_LEN_INDEX      0x1006      // NMT_CycleLen_U32 [us]
+#define PLKCAP_PREQ_LIMIT_INDEX     0x1F8B      // NMT_MNPReqPayloadLimitList_AU16
+#define PLKCAP_PRES_LIMIT_INDEX     0x1F8D      // NMT_PResPayloadLimitList_AU16
+#define PLKCAP_PRES_TIMEOUT_INDEX   0x1F92      // NMT_MNCNPResTimeout_AU32 [ns]
+#define PLKCAP_CYCLE_TIMING_INDEX   0x1F98      // NMT_CycleTiming_REC
+#define PLKCAP_ASYNC_MTU_SUBINDEX   8           // AsyncMTU_U16
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Configured network parameters
+
+The structure contains the parameters read from the CDC. A value of 0 means
+not configured.
+*/
+typedef struct
+{
+    UINT64          cycleLenNs;                             ///< Cycle length [ns]
+    UINT32          aPresTimeoutNs[PLKCAP_NODE_COUNT];      ///< PRes timeout per CN [ns]
+    UINT16          aPreqLimit[PLKCAP_NODE_COUNT];          ///< PReq payload limit per CN [bytes]
+    UINT16          aPresLimit[PLKCAP_NODE_COUNT];          ///< PRes payload limit per CN [bytes]
+    UINT16          asyncMtu;                               ///< Asynchronous MTU [bytes]
+} tPlkCapConfig;
+
+/**
+\brief  Statistics of a CN
+*/
+typedef struct
+{
+    UINT32          preqCount;              ///< PReq frames to the CN
+    UINT32          presCount;              ///< PRes frames of the CN
+    UINT32          missingCount;           ///< PReq frames without PRes
+    UINT32          latencyCount;           ///< Measured PRes latencies
+    UINT32          latencyMin;             ///< Minimum PRes latency [ns]
+    UINT32          latencyMax;             ///< Maximum PRes latency [ns]
+    UINT64          latencySum;             ///< Sum of the PRes latencies [ns]
+    UINT32          lateCount;              ///< PRes latencies above the PRes timeout
+    UINT16          maxPreqPayload;         ///< Largest PReq payload [bytes]
+    UINT16          maxPresPayload;         ///< Largest PRes payload [bytes]
+    UINT32          preqOverLimit;          ///< PReq payloads above the limit
+    UINT32          presOverLimit;          ///< PRes payloads above the limit
+} tPlkCapNode;
+
+/**
+\brief  Statistics of a chunk
+
+The statistics of all chunks are added up for the report.
+*/
+typedef struct
+{
+    UINT64          frameCount;                         ///< Frames of the analyzed cycles
+    UINT64          byteCount;                          ///< Bytes of the analyzed cycles
+    UINT64          cycleCount;                         ///< Cycles (SoC frames)
+    UINT64          firstSocNs;                         ///< Time of the first SoC
+    UINT64          lastSocNs;                          ///< Time of the last SoC
+    UINT64          periodCount;                        ///< Measured SoC periods
+    UINT64          periodMin;                          ///< Minimum SoC period [ns]
+    UINT64          periodMax;                          ///< Maximum SoC period [ns]
+    double          periodSum;                          ///< Sum of the SoC periods [ns]
+    double          periodSumSq;                        ///< Sum of the squared SoC periods [ns^2]
+    UINT64          soaCount;                           ///< SoA frames
+    UINT64          aInviteCount[4];                    ///< Invitations by requested service (1 to 3, 0 for unspecified)
+    UINT64          answeredCount;                      ///< Invitations with an asynchronous frame
+    UINT64          unansweredCount;                    ///< Invitations without an asynchronous frame
+    UINT64          aAsyncCount[PLKCAP_ASND_SERVICES];  ///< Asynchronous frames by ASnd service
+    UINT64          asyncSlotCount;                     ///< Asynchronous phases up to the next SoC
+    UINT64          asyncUsedCount;                     ///< Asynchronous phases with a frame
+    UINT64          asyncPhaseNs;                       ///< Sum of the asynchronous phases [ns]
+    UINT64          asyncUsedNs;                        ///< Sum of the used asynchronous time [ns]
+    UINT32          maxAsyncSize;                       ///< Largest asynchronous frame [bytes]
+    UINT32          asyncOverMtu;                       ///< Asynchronous frames above the MTU
+    UINT32          errorCount;                         ///< Corrupt regions of the file
+    tPlkCapNode     aNode[PLKCAP_NODE_COUNT];           ///< Statistics per CN
+} tPlkCapStats;
+
+/**
+\brief  Cycle state
+
+The structure contains the state of the cycle decoded by a chunk decoder.
+*/
+typedef struct
+{
+    BOOL            fInCycle;               ///< A SoC of the chunk has been decoded
+    UINT64          socNs;                  ///< Time of the SoC
+    UINT            preqNodeId;             ///< CN of the PReq waiting for its PRes, 0 for none
+    UINT64          preqNs;                 ///< Time of the PReq
+    BOOL            fAsyncPhase;            ///< A SoA has been decoded
+    UINT            soaService;             ///< Requested service of the SoA
+    UINT64          soaNs;                  ///< Time of the SoA
+    BOOL            fAsyncUsed;             ///< An asynchronous frame has been decoded
+    UINT64          asyncEndNs;             ///< Time of the last asynchronous frame
+} tPlkCapCycle;
+
+/**
+\brief  Chunk of the capture file
+*/
+typedef struct
+{
+    UINT64          start;                  ///< Offset of the first block
+    UINT64          end;                    ///< End of the chunk
+    UINT64          boundary;               ///< Offset of the first block at or after the end
+    BOOL            fFindStart;             ///< Start is not yet at a block
+    tSystemThread   thread;                 ///< Decoder thread
+    tPlkCapStats    stats;                  ///< Statistics of the chunk
+} tPlkCapChunk;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCapFile         capFile_l;
+static tPlkCapConfig    config_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int      getOptions(int argc_p, char** argv_p, const char** ppszCdcFile_p, UINT* pThreads_p);
+static void     readConfig(const char* pszCdcFile_p);
+static void     decodeChunk(void* pArg_p);
+static BOOL     processFrame(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p,
+                             const tCapRecord* pRecord_p, BOOL fBeyondEnd_p);
+static void     closeCycle(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p, UINT64 socNs_p);
+static void     countAsyncFrame(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p,
+                                const tCapRecord* pRecord_p, UINT service_p);
+static void     mergeStats(tPlkCapStats* pTotal_p, const tPlkCapStats* pStats_p);
+static void     printReport(const tPlkCapStats* pStats_p);
+static const char* formatLimit(UINT limit_p, char* pBuffer_p);
+static UINT64   getWireTimeNs(UINT size_p);
+static UINT     getUint16Le(const BYTE* pData_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the capture analyzer
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char*     pszCdcFile;
+    UINT            threadCount;
+    tPlkCapChunk*   pChunk;
+    tPlkCapStats*   pTotal;
+    UINT64          chunkSize;
+    UINT64          startNs;
+    UINT64          elapsedNs;
+    UINT            redoCount = 0;
+    UINT            i;
+
+    if (getOptions(argc, argv, &pszCdcFile, &threadCount) != 0)
+        return EXIT_FAILURE;
+
+    readConfig(pszCdcFile);
+    if (capfile_open(argv[optind], &capFile_l) != kErrorOk)
+        return EXIT_FAILURE;
+
+    pChunk = (tPlkCapChunk*)calloc(threadCount, sizeof(tPlkCapChunk));
+    pTotal = (tPlkCapStats*)calloc(1, sizeof(tPlkCapStats));
+    if ((pChunk == NULL) || (pTotal == NULL))
+    {
+        free(pChunk);
+        free(pTotal);
+        capfile_close(&capFile_l);
+        return EXIT_FAILURE;
+    }
+
+    startNs = system_getTimeNs();
+
+    // small captures are not split
+    chunkSize = (capFile_l.size - capFile_l.dataOffset) / threadCount;
+    if (chunkSize < 65536)
+    {
+        threadCount = 1;
+        chunkSize = capFile_l.size - capFile_l.dataOffset;
+    }
+
+    for (i = 0; i < threadCount; i++)
+    {
+        pChunk[i].start = capFile_l.dataOffset + chunkSize * i;
+        pChunk[i].end = (i == threadCount - 1) ? capFile_l.size : pChunk[i].start + chunkSize;
+        pChunk[i].fFindStart = (i > 0);
+    }
+
+    for (i = 1; i < threadCount; i++)
+    {
+        if (system_createThread(decodeChunk, &pChunk[i], &pChunk[i].thread) != 0)
+            decodeChunk(&pChunk[i]);
+    }
+
+    // the first chunk is decoded by the main thread
+    decodeChunk(&pChunk[0]);
+    for (i = 1; i < threadCount; i++)
+        system_joinThread(&pChunk[i].thread);
+
+    for (i = 0; i < threadCount; i++)
+    {
+        if ((i > 0) && (pChunk[i].start != pChunk[i - 1].boundary))
+        {
+            pChunk[i].start = pChunk[i - 1].boundary;
+            decodeChunk(&pChunk[i]);
+            redoCount++;
+        }
+        mergeStats(pTotal, &pChunk[i].stats);
+    }
+
+    elapsedNs = system_getTimeNs() - startNs;
+
+    printf("Capture %s: %.1f MB decoded by %u threads in %.1f ms (%.0f MB/s)",
+           argv[optind], capFile_l.size / 1e6, threadCount, elapsedNs / 1e6,
+           (elapsedNs > 0) ? capFile_l.size * 1e3 / elapsedNs : 0.0);
+    if (redoCount > 0)
+        printf(", %u chunks decoded again", redoCount);
+    printf("\n");
+
+    printReport(pTotal);
+
+    free(pChunk);
+    free(pTotal);
+    capfile_close(&capFile_l);
+    return EXIT_SUCCESS;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+\param  argc_p                  Number of arguments.
+\param  argv_p                  Pointer to argument strings.
+\param  ppszCdcFile_p           Pointer to store the CDC file, NULL if none.
+\param  pThreads_p              Pointer to store the number of threads.
+
+\return Returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, const char** ppszCdcFile_p, UINT* pThreads_p)
+{
+    int     opt;
+    BOOL    fValid = TRUE;
+
+    *ppszCdcFile_p = NULL;
+    *pThreads_p = 4;
+
+    while ((opt = getopt(argc_p, argv_p, "c:j:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c':
+                *ppszCdcFile_p = optarg;
+                break;
+
+            case 'j':
+                *pThreads_p = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            default: /* '?' */
+                fValid = FALSE;
+                break;
+        }
+    }
+
+    if (!fValid || (optind != argc_p - 1) || (*pThreads_p == 0) || (*pThreads_p > PLKCAP_MAX_THREADS))
+    {
+        printf("Usage: %s [-c CDC-FILE] [-j THREADS] CAPTURE\n", argv_p[0]);
+        printf("  Analyzes the cycle timing of a POWERLINK capture (pcap or pcapng)\n");
+        printf("  -c  Compare with the cycle length, PRes timeouts and limits of the CDC\n");
+        printf("  -j  Number of decoder threads (default: 4, maximum: %d)\n", PLKCAP_MAX_THREADS);
+        return -1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the configured network parameters
+
+\param  pszCdcFile_p            File name of the CDC, NULL if none.
+*/
+//------------------------------------------------------------------------------
+static void readConfig(const char* pszCdcFile_p)
+{
+    tCdcCursor      cursor;
+    tCdcEntry       entry;
+    BYTE*           pCdc;
+    UINT            cdcSize;
+
+    memset(&config_l, 0, sizeof(config_l));
+    if ((pszCdcFile_p == NULL) || (cdc_init(pszCdcFile_p) != kErrorOk))
+        return;
+
+    pCdc = cdc_getBuffer(&cdcSize);
+    if (cdc_openCursor(pCdc, cdcSize, &cursor) == kErrorOk)
+    {
+        while (cdc_nextEntry(&cursor, &entry))
+        {
+            if (entry.index == PLKCAP_CYCLE_LEN_INDEX)
+            {
+                config_l.cycleLenNs = cdc_getEntryValue(&entry) * 1000;
+            }
+            else if ((entry.index == PLKCAP_CYCLE_TIMING_INDEX) &&
+                     (entry.subIndex == PLKCAP_ASYNC_MTU_SUBINDEX))
+            {
+                config_l.asyncMtu = (UINT16)cdc_getEntryValue(&entry);
+            }
+            else if (entry.subIndex == 0)
+            {
+                continue;
+            }
+            else if (entry.index == PLKCAP_PRES_TIMEOUT_INDEX)
+            {
+                config_l.aPresTimeoutNs[entry.subIndex] = (UINT32)cdc_getEntryValue(&entry);
+            }
+            else if (entry.index == PLKCAP_PREQ_LIMIT_INDEX)
+            {
+                config_l.aPreqLimit[entry.subIndex] = (UINT16)cdc_getEntryValue(&entry);
+            }
+            else if (entry.index == PLKCAP_PRES_LIMIT_INDEX)
+            {
+                config_l.aPresLimit[entry.subIndex] = (UINT16)cdc_getEntryValue(&entry);
+            }
+        }
+    }
+
+    cdc_exit();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Decode a chunk
+
+The function decodes the cycles starting with a SoC within the chunk. Frames
+in front of the first SoC belong to the last cycle of the previous chunk.
+Corrupt data is skipped.
+
+\param  pArg_p                  Chunk.
+*/
+//------------------------------------------------------------------------------
+static void decodeChunk(void* pArg_p)
+{
+    tPlkCapChunk*   pChunk = (tPlkCapChunk*)pArg_p;
+    tPlkCapStats*   pStats = &pChunk->stats;
+    tPlkCapCycle    cycle;
+    tCapRecord      record;
+    UINT64          offset;
+    UINT            size;
+    BOOL            fFrame;
+    BOOL            fBeyondEnd = FALSE;
+
+    // the first block of a chunk is searched by its thread
+    if (pChunk->fFindStart)
+    {
+        pChunk->start = capfile_findBlock(&capFile_l, pChunk->start);
+        pChunk->fFindStart = FALSE;
+    }
+
+    memset(pStats, 0, sizeof(tPlkCapStats));
+    memset(&cycle, 0, sizeof(cycle));
+    offset = pChunk->start;
+    pChunk->boundary = capFile_l.size;
+
+    while (offset < capFile_l.size)
+    {
+        if (!fBeyondEnd && (offset >= pChunk->end))
+        {
+            pChunk->boundary = offset;
+            fBeyondEnd = TRUE;
+        }
+
+        // the next cycle belongs to the next chunk
+        if (fBeyondEnd && !cycle.fInCycle)
+            break;
+
+        size = capfile_readBlock(&capFile_l, offset, &record, &fFrame);
+        if (size == 0)
+        {
+            // the cycle in progress is incomplete
+            pStats->errorCount++;
+            memset(&cycle, 0, sizeof(cycle));
+            offset = capfile_findBlock(&capFile_l, offset + 1);
+            continue;
+        }
+
+        if (fFrame && processFrame(pStats, &cycle, &record, fBeyondEnd))
+            break;
+
+        offset += size;
+    }
+
+    if (!fBeyondEnd)
+        pChunk->boundary = offset;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a frame
+
+\param  pStats_p                Statistics of the chunk.
+\param  pCycle_p                Cycle state of the chunk.
+\param  pRecord_p               Captured frame.
+\param  fBeyondEnd_p            Frame is behind the end of the chunk.
+
+\return The function returns TRUE if the frame starts the first cycle of the
+        next chunk.
+*/
+//------------------------------------------------------------------------------
+static BOOL processFrame(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p,
+                         const tCapRecord* pRecord_p, BOOL fBeyondEnd_p)
+{
+    const BYTE*     pData = pRecord_p->pData;
+    tPlkCapNode*    pNode;
+    UINT            msgType;
+    UINT            nodeId;
+    UINT            payload;
+    UINT64          latency;
+    BOOL            fPlk;
+
+    fPlk = (pRecord_p->capLen > PLK_OFS_PDO_SIZE + 1) &&
+           (pData[PLK_OFS_ETHERTYPE] == (PLK_ETHERTYPE >> 8)) &&
+           (pData[PLK_OFS_ETHERTYPE + 1] == (PLK_ETHERTYPE & 0xFF));
+    msgType = fPlk ? (pData[PLK_OFS_MSGTYPE] & 0x7F) : 0;
+
+    if (msgType == PLK_MSGTYPE_SOC)
+    {
+        closeCycle(pStats_p, pCycle_p, pRecord_p->timeNs);
+        if (fBeyondEnd_p)
+            return TRUE;
+
+        if (pStats_p->cycleCount == 0)
+            pStats_p->firstSocNs = pRecord_p->timeNs;
+        pStats_p->lastSocNs = pRecord_p->timeNs;
+        pStats_p->cycleCount++;
+
+        pCycle_p->fInCycle = TRUE;
+        pCycle_p->socNs = pRecord_p->timeNs;
+    }
+
+    if (!pCycle_p->fInCycle)
+        return FALSE;
+
+    pStats_p->frameCount++;
+    pStats_p->byteCount += pRecord_p->origLen;
+
+    if (!fPlk)
+    {
+        // e.g. IP frames sent in the asynchronous phase
+        if (pCycle_p->fAsyncPhase)
+            countAsyncFrame(pStats_p, pCycle_p, pRecord_p, PLKCAP_ASYNC_OTHER);
+        return FALSE;
+    }
+
+    switch (msgType)
+    {
+        case PLK_MSGTYPE_PREQ:
+            nodeId = pData[PLK_OFS_DST_NODE];
+            pNode = &pStats_p->aNode[nodeId];
+            if (pCycle_p->preqNodeId != 0)
+                pStats_p->aNode[pCycle_p->preqNodeId].missingCount++;
+
+            payload = getUint16Le(&pData[PLK_OFS_PDO_SIZE]);
+            pNode->preqCount++;
+            if (payload > pNode->maxPreqPayload)
+                pNode->maxPreqPayload = (UINT16)payload;
+            if ((config_l.aPreqLimit[nodeId] != 0) && (payload > config_l.aPreqLimit[nodeId]))
+                pNode->preqOverLimit++;
+
+            pCycle_p->preqNodeId = nodeId;
+            pCycle_p->preqNs = pRecord_p->timeNs;
+            break;
+
+        case PLK_MSGTYPE_PRES:
+            nodeId = pData[PLK_OFS_SRC_NODE];
+            pNode = &pStats_p->aNode[nodeId];
+            payload = getUint16Le(&pData[PLK_OFS_PDO_SIZE]);
+            pNode->presCount++;
+            if (payload > pNode->maxPresPayload)
+                pNode->maxPresPayload = (UINT16)payload;
+            if ((config_l.aPresLimit[nodeId] != 0) && (payload > config_l.aPresLimit[nodeId]))
+                pNode->presOverLimit++;
+
+            // the PRes of the MN and chained PRes frames are not requested
+            if ((nodeId == pCycle_p->preqNodeId) && (nodeId != 0))
+            {
+                latency = pRecord_p->timeNs - pCycle_p->preqNs;
+                latency = (latency > getWireTimeNs(pRecord_p->origLen)) ?
+                          latency - getWireTimeNs(pRecord_p->origLen) : 0;
+
+                if (pNode->latencyCount == 0)
+                    pNode->latencyMin = (UINT32)latency;
+                if (latency < pNode->latencyMin)
+                    pNode->latencyMin = (UINT32)latency;
+                if (latency > pNode->latencyMax)
+                    pNode->latencyMax = (UINT32)latency;
+                pNode->latencySum += latency;
+                pNode->latencyCount++;
+
+                if ((config_l.aPresTimeoutNs[nodeId] != 0) && (latency > config_l.aPresTimeoutNs[nodeId]))
+                    pNode->lateCount++;
+
+                pCycle_p->preqNodeId = 0;
+            }
+            break;
+
+        case PLK_MSGTYPE_SOA:
+            if (pCycle_p->preqNodeId != 0)
+            {
+                pStats_p->aNode[pCycle_p->preqNodeId].missingCount++;
+                pCycle_p->preqNodeId = 0;
+            }
+
+            pStats_p->soaCount++;
+            pCycle_p->fAsyncPhase = TRUE;
+            pCycle_p->fAsyncUsed = FALSE;
+            pCycle_p->soaNs = pRecord_p->timeNs;
+            pCycle_p->soaService = pData[PLK_OFS_SOA_SERVICE];
+
+            if (pCycle_p->soaService == PLK_SOA_UNSPEC_INVITE)
+                pStats_p->aInviteCount[0]++;
+            else if ((pCycle_p->soaService >= PLK_SOA_IDENT_REQUEST) &&
+                     (pCycle_p->soaService <= PLK_SOA_NMT_REQUEST_INVITE))
+                pStats_p->aInviteCount[pCycle_p->soaService]++;
+            break;
+
+        case PLK_MSGTYPE_ASND:
+            if (pCycle_p->fAsyncPhase)
+                countAsyncFrame(pStats_p, pCycle_p, pRecord_p, pData[PLK_OFS_ASND_SERVICE]);
+            break;
+
+        default:
+            break;
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a cycle
+
+The function completes the statistics of a cycle when the next SoC is
+decoded.
+
+\param  pStats_p                Statistics of the chunk.
+\param  pCycle_p                Cycle state of the chunk.
+\param  socNs_p                 Time of the next SoC.
+*/
+//------------------------------------------------------------------------------
+static void closeCycle(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p, UINT64 socNs_p)
+{
+    UINT64  period;
+
+    if (!pCycle_p->fInCycle)
+        return;
+
+    period = socNs_p - pCycle_p->socNs;
+    if ((pStats_p->periodCount == 0) || (period < pStats_p->periodMin))
+        pStats_p->periodMin = period;
+    if (period > pStats_p->periodMax)
+        pStats_p->periodMax = period;
+    pStats_p->periodSum += (double)period;
+    pStats_p->periodSumSq += (double)period * (double)period;
+    pStats_p->periodCount++;
+
+    if (pCycle_p->preqNodeId != 0)
+        pStats_p->aNode[pCycle_p->preqNodeId].missingCount++;
+
+    if (pCycle_p->fAsyncPhase)
+    {
+        pStats_p->asyncSlotCount++;
+        pStats_p->asyncPhaseNs += socNs_p - pCycle_p->soaNs;
+        if (pCycle_p->fAsyncUsed)
+        {
+            pStats_p->asyncUsedCount++;
+            pStats_p->asyncUsedNs += pCycle_p->asyncEndNs - pCycle_p->soaNs;
+        }
+
+        if (pCycle_p->soaService != PLK_SOA_NO_SERVICE)
+        {
+            if (pCycle_p->fAsyncUsed)
+                pStats_p->answeredCount++;
+            else
+                pStats_p->unansweredCount++;
+        }
+    }
+
+    memset(pCycle_p, 0, sizeof(tPlkCapCycle));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count an asynchronous frame
+
+\param  pStats_p                Statistics of the chunk.
+\param  pCycle_p                Cycle state of the chunk.
+\param  pRecord_p               Captured frame.
+\param  service_p               ASnd service ID, PLKCAP_ASYNC_OTHER for frames
+                                which are not ASnd.
+*/
+//------------------------------------------------------------------------------
+static void countAsyncFrame(tPlkCapStats* pStats_p, tPlkCapCycle* pCycle_p,
+                            const tCapRecord* pRecord_p, UINT service_p)
+{
+    if (service_p >= PLKCAP_ASND_SERVICES)
+        service_p = PLKCAP_ASYNC_OTHER;
+
+    pStats_p->aAsyncCount[service_p]++;
+    if (pRecord_p->origLen > pStats_p->maxAsyncSize)
+        pStats_p->maxAsyncSize = pRecord_p->origLen;
+
+    // the MTU covers the frame without the Ethernet header
+    if ((config_l.asyncMtu != 0) && (pRecord_p->origLen - PLK_OFS_MSGTYPE > config_l.asyncMtu))
+        pStats_p->asyncOverMtu++;
+
+    pCycle_p->fAsyncUsed = TRUE;
+    pCycle_p->asyncEndNs = pRecord_p->timeNs;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add the statistics of a chunk
+
+\param  pTotal_p                Total statistics.
+\param  pStats_p                Statistics of the chunk.
+*/
+//------------------------------------------------------------------------------
+static void mergeStats(tPlkCapStats* pTotal_p, const tPlkCapStats* pStats_p)
+{
+    tPlkCapNode*        pTotalNode;
+    const tPlkCapNode*  pNode;
+    UINT                i;
+
+    if ((pStats_p->cycleCount > 0) && (pTotal_p->cycleCount == 0))
+        pTotal_p->firstSocNs = pStats_p->firstSocNs;
+    if (pStats_p->cycleCount > 0)
+        pTotal_p->lastSocNs = pStats_p->lastSocNs;
+
+    if ((pStats_p->periodCount > 0) &&
+        ((pTotal_p->periodCount == 0) || (pStats_p->periodMin < pTotal_p->periodMin)))
+        pTotal_p->periodMin = pStats_p->periodMin;
+    if (pStats_p->periodMax > pTotal_p->periodMax)
+        pTotal_p->periodMax = pStats_p->periodMax;
+    if (pStats_p->maxAsyncSize > pTotal_p->maxAsyncSize)
+        pTotal_p->maxAsyncSize = pStats_p->maxAsyncSize;
+
+    pTotal_p->frameCount += pStats_p->frameCount;
+    pTotal_p->byteCount += pStats_p->byteCount;
+    pTotal_p->cycleCount += pStats_p->cycleCount;
+    pTotal_p->periodCount += pStats_p->periodCount;
+    pTotal_p->periodSum += pStats_p->periodSum;
+    pTotal_p->periodSumSq += pStats_p->periodSumSq;
+    pTotal_p->soaCount += pStats_p->soaCount;
+    pTotal_p->answeredCount += pStats_p->answeredCount;
+    pTotal_p->unansweredCount += pStats_p->unansweredCount;
+    pTotal_p->asyncSlotCount += pStats_p->asyncSlotCount;
+    pTotal_p->asyncUsedCount += pStats_p->asyncUsedCount;
+    pTotal_p->asyncPhaseNs += pStats_p->asyncPhaseNs;
+    pTotal_p->asyncUsedNs += pStats_p->asyncUsedNs;
+    pTotal_p->asyncOverMtu += pStats_p->asyncOverMtu;
+    pTotal_p->errorCount += pStats_p->errorCount;
+
+    for (i = 0; i < 4; i++)
+        pTotal_p->aInviteCount[i] += pStats_p->aInviteCount[i];
+    for (i = 0; i < PLKCAP_ASND_SERVICES; i++)
+        pTotal_p->aAsyncCount[i] += pStats_p->aAsyncCount[i];
+
+    for (i = 0; i < PLKCAP_NODE_COUNT; i++)
+    {
+        pTotalNode = &pTotal_p->aNode[i];
+        pNode = &pStats_p->aNode[i];
+
+        if ((pNode->latencyCount > 0) &&
+            ((pTotalNode->latencyCount == 0) || (pNode->latencyMin < pTotalNode->latencyMin)))
+            pTotalNode->latencyMin = pNode->latencyMin;
+        if (pNode->latencyMax > pTotalNode->latencyMax)
+            pTotalNode->latencyMax = pNode->latencyMax;
+        if (pNode->maxPreqPayload > pTotalNode->maxPreqPayload)
+            pTotalNode->maxPreqPayload = pNode->maxPreqPayload;
+        if (pNode->maxPresPayload > pTotalNode->maxPresPayload)
+            pTotalNode->maxPresPayload = pNode->maxPresPayload;
+
+        pTotalNode->preqCount += pNode->preqCount;
+        pTotalNode->presCount += pNode->presCount;
+        pTotalNode->missingCount += pNode->missingCount;
+        pTotalNode->latencyCount += pNode->latencyCount;
+        pTotalNode->latencySum += pNode->latencySum;
+        pTotalNode->lateCount += pNode->lateCount;
+        pTotalNode->preqOverLimit += pNode->preqOverLimit;
+        pTotalNode->presOverLimit += pNode->presOverLimit;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the report
+
+\param  pStats_p                Total statistics.
+*/
+//------------------------------------------------------------------------------
+static void printReport(const tPlkCapStats* pStats_p)
+{
+    const tPlkCapNode*  pNode;
+    double              mean = 0.0;
+    double              deviation = 0.0;
+    double              jitter;
+    char                aPreqLimit[8];
+    char                aPresLimit[8];
+    UINT                i;
+
+    printf("%llu frames (%.1f MB) in %llu cycles, %.3f s",
+           (unsigned long long)pStats_p->frameCount, pStats_p->byteCount / 1e6,
+           (unsigned long long)pStats_p->cycleCount,
+           (pStats_p->lastSocNs - pStats_p->firstSocNs) / 1e9);
+    if (pStats_p->errorCount > 0)
+        printf(", %lu corrupt regions skipped", (ULONG)pStats_p->errorCount);
+    printf("\n");
+
+    if (pStats_p->periodCount == 0)
+    {
+        printf("No complete cycle found!\n");
+        return;
+    }
+
+    mean = pStats_p->periodSum / pStats_p->periodCount;
+    deviation = sqrt(fabs(pStats_p->periodSumSq / pStats_p->periodCount - mean * mean));
+
+    // jitter against the configured cycle length, or the mean period without CDC
+    jitter = (config_l.cycleLenNs != 0) ? (double)config_l.cycleLenNs : mean;
+    jitter = (pStats_p->periodMax - jitter > jitter - pStats_p->periodMin) ?
+             pStats_p->periodMax - jitter : jitter - pStats_p->periodMin;
+
+    printf("\nSoC period [us]: mean %.3f, min %.3f, max %.3f, std dev %.3f",
+           mean / 1e3, pStats_p->periodMin / 1e3, pStats_p->periodMax / 1e3, deviation / 1e3);
+    if (config_l.cycleLenNs != 0)
+        printf(", cycle length %.3f", config_l.cycleLenNs / 1e3);
+    printf("\nSoC jitter [us]: %.3f\n", jitter / 1e3);
+
+    printf("\nNode   PReq      PRes   Missing  Latency min/avg/max [us]  Timeout  Late"
+           "  PReq max/limit  PRes max/limit\n");
+    for (i = 1; i < PLKCAP_NODE_COUNT; i++)
+    {
+        pNode = &pStats_p->aNode[i];
+        if ((pNode->preqCount == 0) && (pNode->presCount == 0))
+            continue;
+
+        printf("%4u %9lu %9lu %7lu", i, (ULONG)pNode->preqCount, (ULONG)pNode->presCount,
+               (ULONG)pNode->missingCount);
+        if (pNode->latencyCount > 0)
+            printf("  %7.2f %7.2f %7.2f", pNode->latencyMin / 1e3,
+                   (double)pNode->latencySum / pNode->latencyCount / 1e3, pNode->latencyMax / 1e3);
+        else
+            printf("  %7s %7s %7s", "-", "-", "-");
+
+        if (config_l.aPresTimeoutNs[i] != 0)
+            printf("  %9.2f %5lu", config_l.aPresTimeoutNs[i] / 1e3, (ULONG)pNode->lateCount);
+        else
+            printf("  %9s %5s", "-", "-");
+
+        printf("  %5u/%-5s%s %5u/%-5s%s\n",
+               pNode->maxPreqPayload, formatLimit(config_l.aPreqLimit[i], aPreqLimit),
+               (pNode->preqOverLimit > 0) ? "!" : " ",
+               pNode->maxPresPayload, formatLimit(config_l.aPresLimit[i], aPresLimit),
+               (pNode->presOverLimit > 0) ? "!" : " ");
+    }
+
+    printf("\nAsynchronous phase: %llu SoA\n", (unsigned long long)pStats_p->soaCount);
+    printf("  Invitations: %llu IdentRequest, %llu StatusRequest, %llu NMTRequestInvite, "
+           "%llu UnspecifiedInvite\n",
+           (unsigned long long)pStats_p->aInviteCount[PLK_SOA_IDENT_REQUEST],
+           (unsigned long long)pStats_p->aInviteCount[PLK_SOA_STATUS_REQUEST],
+           (unsigned long long)pStats_p->aInviteCount[PLK_SOA_NMT_REQUEST_INVITE],
+           (unsigned long long)pStats_p->aInviteCount[0]);
+    printf("  Answered: %llu, unanswered: %llu\n",
+           (unsigned long long)pStats_p->answeredCount, (unsigned long long)pStats_p->unansweredCount);
+    printf("  Frames: %llu IdentResponse, %llu StatusResponse, %llu NMTRequest, %llu NMTCommand, "
+           "%llu SDO, %llu other\n",
+           (unsigned long long)pStats_p->aAsyncCount[PLK_ASND_IDENT_RESPONSE],
+           (unsigned long long)pStats_p->aAsyncCount[PLK_ASND_STATUS_RESPONSE],
+           (unsigned long long)pStats_p->aAsyncCount[PLK_ASND_NMT_REQUEST],
+           (unsigned long long)pStats_p->aAsyncCount[PLK_ASND_NMT_COMMAND],
+           (unsigned long long)pStats_p->aAsyncCount[PLK_ASND_SDO],
+           (unsigned long long)pStats_p->aAsyncCount[PLKCAP_ASYNC_OTHER]);
+
+    if (pStats_p->asyncSlotCount > 0)
+    {
+        printf("  Slot usage: %.1f %% of the cycles, %.1f %% of the asynchronous time\n",
+               100.0 * pStats_p->asyncUsedCount / pStats_p->asyncSlotCount,
+               (pStats_p->asyncPhaseNs > 0) ? 100.0 * pStats_p->asyncUsedNs / pStats_p->asyncPhaseNs : 0.0);
+    }
+
+    printf("  Largest frame: %lu bytes", (ULONG)pStats_p->maxAsyncSize);
+    if (config_l.asyncMtu != 0)
+        printf(", MTU %u, %lu frames above the MTU", config_l.asyncMtu, (ULONG)pStats_p->asyncOverMtu);
+    printf("\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Format a payload limit
+
+\param  limit_p                 Payload limit, 0 if not configured.
+\param  pBuffer_p               Buffer for the text (8 bytes).
+
+\return The function returns the text of the limit.
+*/
+//------------------------------------------------------------------------------
+static const char* formatLimit(UINT limit_p, char* pBuffer_p)
+{
+    if (limit_p == 0)
+        return "-";
+
+    sprintf(pBuffer_p, "%u", limit_p);
+    return pBuffer_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the transmission time of a frame
+
+\param  size_p                  Size of the frame without FCS [bytes].
+
+\return The function returns the transmission time at 100 Mbit/s [ns].
+*/
+//------------------------------------------------------------------------------
+static UINT64 getWireTimeNs(UINT size_p)
+{
+    if (size_p < PLK_FRAME_MIN_SIZE)
+        size_p = PLK_FRAME_MIN_SIZE;
+
+    return (UINT64)(size_p + PLKCAP_FRAME_OVERHEAD) * PLKCAP_NS_PER_BYTE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a little endian 16 bit value
+
+\param  pData_p                 Pointer to the value.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT getUint16Le(const BYTE* pData_p)
+{
+    return (UINT)pData_p[0] | ((UINT)pData_p[1] << 8);
+}
+
+/// \}
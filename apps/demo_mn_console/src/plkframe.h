@@ -0,0 +1,180 @@
+/**
+********************************************************************************
+\file   plkframe.h
+
+\brief  Definitions for POWERLINK frames
+
+The file contains the layout of the POWERLINK frames on the wire. It is used
+by the tools of the MN demo application which send or decode frames without
+the openPOWERLINK stack. All multi-byte fields are little endian.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_plkframe_H_
+#define _INC_plkframe_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PLK_ETHERTYPE               0x88AB  ///< EtherType of POWERLINK frames
+#define PLK_FRAME_MIN_SIZE          60      ///< Minimum frame size without FCS
+#define PLK_FRAME_MAX_SIZE          1514    ///< Maximum frame size without FCS
+#define PLK_NODEID_MN               0xF0    ///< Node ID of the MN
+#define PLK_NODEID_BROADCAST        0xFF    ///< Broadcast node ID
+#define PLK_MULTICAST_PREFIX        0x01, 0x11, 0x1E, 0x00, 0x00    ///< First bytes of the multicast MAC addresses
+#define PLK_MULTICAST_SOC           0x01    ///< Last byte of the SoC multicast MAC address
+#define PLK_MULTICAST_PRES          0x02    ///< Last byte of the PRes multicast MAC address
+#define PLK_MULTICAST_SOA           0x03    ///< Last byte of the SoA multicast MAC address
+#define PLK_MULTICAST_ASND          0x04    ///< Last byte of the ASnd multicast MAC address
+
+// offsets of the common header
+#define PLK_OFS_DST_MAC             0       ///< Destination MAC address
+#define PLK_OFS_SRC_MAC             6       ///< Source MAC address
+#define PLK_OFS_ETHERTYPE           12      ///< EtherType (big endian)
+#define PLK_OFS_MSGTYPE             14      ///< Message type
+#define PLK_OFS_DST_NODE            15      ///< Destination node ID
+#define PLK_OFS_SRC_NODE            16      ///< Source node ID
+
+// offsets of SoC, PReq, PRes and SoA
+#define PLK_OFS_NMTSTATE            17      ///< NMT state (PRes, SoA)
+#define PLK_OFS_FLAG1               18      ///< Flags 1
+#define PLK_OFS_FLAG2               19      ///< Flags 2 (PRes)
+#define PLK_OFS_SOC_NETTIME         20      ///< Net time (SoC)
+#define PLK_OFS_PDO_VERSION         20      ///< PDO version (PReq, PRes)
+#define PLK_OFS_PDO_SIZE            22      ///< Payload size (PReq, PRes)
+#define PLK_OFS_PDO_PAYLOAD         24      ///< Payload (PReq, PRes)
+#define PLK_OFS_SOA_SERVICE         20      ///< Requested service (SoA)
+#define PLK_OFS_SOA_TARGET          21      ///< Requested service target (SoA)
+#define PLK_OFS_SOA_VERSION         22      ///< POWERLINK version (SoA)
+
+// offsets of ASnd
+#define PLK_OFS_ASND_SERVICE        17      ///< Service ID
+#define PLK_OFS_ASND_PAYLOAD        18      ///< Payload
+
+// offsets of IdentResponse and StatusResponse
+#define PLK_OFS_RESP_FLAG1          18      ///< Flags 1 (EN, EC)
+#define PLK_OFS_RESP_FLAG2          19      ///< Flags 2 (PR, RS)
+#define PLK_OFS_RESP_NMTSTATE       20      ///< NMT state
+#define PLK_OFS_IDENT_VERSION       22      ///< POWERLINK profile version
+#define PLK_OFS_IDENT_FEATURES      24      ///< Feature flags
+#define PLK_OFS_IDENT_MTU           28      ///< Asynchronous MTU
+#define PLK_OFS_IDENT_POLLIN        30      ///< PReq payload limit
+#define PLK_OFS_IDENT_POLLOUT       32      ///< PRes payload limit
+#define PLK_OFS_IDENT_RESPTIME      34      ///< PRes latency [ns]
+#define PLK_OFS_IDENT_DEVICETYPE    40      ///< Device type
+#define PLK_OFS_IDENT_VENDORID      44      ///< Vendor ID
+#define PLK_OFS_IDENT_PRODUCTCODE   48      ///< Product code
+#define PLK_OFS_IDENT_REVISION      52      ///< Revision number
+#define PLK_OFS_IDENT_SERIAL        56      ///< Serial number
+#define PLK_OFS_IDENT_CONFDATE      68      ///< Verify configuration date
+#define PLK_OFS_IDENT_CONFTIME      72      ///< Verify configuration time
+#define PLK_OFS_IDENT_APPSWDATE     76      ///< Application software date
+#define PLK_OFS_IDENT_APPSWTIME     80      ///< Application software time
+#define PLK_OFS_IDENT_IPADDR        84      ///< IP address (big endian)
+#define PLK_OFS_IDENT_SUBNET        88      ///< Subnet mask (big endian)
+#define PLK_OFS_IDENT_GATEWAY       92      ///< Default gateway (big endian)
+#define PLK_OFS_IDENT_HOSTNAME      96      ///< Host name (32 characters)
+#define PLK_IDENT_RESPONSE_SIZE     176     ///< Size of an IdentResponse frame
+#define PLK_STATUS_RESPONSE_SIZE    32      ///< Size of a StatusResponse frame without error entries
+
+// offsets of NMT commands
+#define PLK_OFS_NMT_COMMAND         18      ///< NMT command ID
+#define PLK_OFS_NMT_DATA            20      ///< NMT command data (node list of extended commands)
+
+// offsets of SDO frames (sequence and command layer)
+#define PLK_OFS_SDO_RECV_SEQ        18      ///< Receive sequence number and connection
+#define PLK_OFS_SDO_SEND_SEQ        19      ///< Send sequence number and connection
+#define PLK_OFS_SDO_TRANSACTION     23      ///< Transaction ID
+#define PLK_OFS_SDO_FLAGS           24      ///< Response, abort and segmentation flags
+#define PLK_OFS_SDO_COMMAND         25      ///< Command ID
+#define PLK_OFS_SDO_SEGMENT_SIZE    26      ///< Segment size
+#define PLK_OFS_SDO_DATA            30      ///< Command data
+
+// message types
+#define PLK_MSGTYPE_SOC             0x01    ///< Start of Cycle
+#define PLK_MSGTYPE_PREQ            0x03    ///< Poll Request
+#define PLK_MSGTYPE_PRES            0x04    ///< Poll Response
+#define PLK_MSGTYPE_SOA             0x05    ///< Start of Asynchronous
+#define PLK_MSGTYPE_ASND            0x06    ///< Asynchronous Send
+#define PLK_MSGTYPE_AMNI            0x07    ///< Active Managing Node Indication
+#define PLK_MSGTYPE_AINV            0x0D    ///< Asynchronous Invite
+
+// flags
+#define PLK_FLAG1_MS                0x20    ///< Multiplexed slot (PReq, PRes)
+#define PLK_FLAG1_EN                0x10    ///< Exception new (PRes, responses)
+#define PLK_FLAG1_EC                0x08    ///< Exception clear (responses)
+#define PLK_FLAG1_EA                0x04    ///< Exception acknowledge (PReq, SoA)
+#define PLK_FLAG1_ER                0x02    ///< Exception reset (SoA)
+#define PLK_FLAG1_RD                0x01    ///< Ready (PReq, PRes)
+#define PLK_FLAG2_PR_SHIFT          3       ///< Position of the priority (PR)
+#define PLK_FLAG2_RS_MASK           0x07    ///< Request to send (RS)
+#define PLK_PRIO_GENERIC_REQUEST    3       ///< Priority of generic asynchronous frames
+
+// SoA services
+#define PLK_SOA_NO_SERVICE          0x00
+#define PLK_SOA_IDENT_REQUEST       0x01
+#define PLK_SOA_STATUS_REQUEST      0x02
+#define PLK_SOA_NMT_REQUEST_INVITE  0x03
+#define PLK_SOA_UNSPEC_INVITE       0xFF
+
+// ASnd services
+#define PLK_ASND_IDENT_RESPONSE     0x01
+#define PLK_ASND_STATUS_RESPONSE    0x02
+#define PLK_ASND_NMT_REQUEST        0x03
+#define PLK_ASND_NMT_COMMAND        0x04
+#define PLK_ASND_SDO                0x05
+
+// SDO
+#define PLK_SDO_CON_NONE            0       ///< No connection
+#define PLK_SDO_CON_INIT            1       ///< Connection initialization
+#define PLK_SDO_CON_VALID           2       ///< Connection valid
+#define PLK_SDO_CON_ACK_REQUEST     3       ///< Error response / acknowledge request
+#define PLK_SDO_FLAG_RESPONSE       0x80
+#define PLK_SDO_FLAG_ABORT          0x40
+#define PLK_SDO_SEGMENT_MASK        0x30
+#define PLK_SDO_CMD_NIL             0x00
+#define PLK_SDO_CMD_WRITE_BY_INDEX  0x01
+#define PLK_SDO_CMD_READ_BY_INDEX   0x02
+
+#define PLK_VERSION                 0x20    ///< POWERLINK version 2.0
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#endif /* _INC_plkframe_H_ */
@@ -0,0 +1,201 @@
+/**
+********************************************************************************
+\file   plktune.c
+
+\brief  Real-time host tuning tool
+
+This file contains a tool which inspects the host settings influencing the
+real-time behavior of the MN and optionally applies the recommended values.
+The wake-up latency is measured before and after every applied setting, so the
+report shows the impact of each change. The application executes the same
+tuning if it is built with CFG_DEMO_MN_CONSOLE_RTTUNE, except for the interrupt
+moderation. It is only tuned by this tool, on the adapter given with -i.
+
+Process settings are only effective for the tool itself. They are reported to
+show their impact, the application applies them when it is built with the
+tuning enabled.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <system/rttune.h>
+#include <getopt/getopt.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, const char** ppszIfName_p, UINT* pFlags_p,
+                      UINT32* pPeriod_p, UINT* pDuration_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the real-time host tuning tool
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char*     pszIfName;
+    UINT            flags;
+    UINT32          period;
+    UINT            duration;
+
+    if (getOptions(argc, argv, &pszIfName, &flags, &period, &duration) != 0)
+        return EXIT_FAILURE;
+
+    return (rttune_run(pszIfName, flags, period, duration) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+\param  argc_p                  Argument count.
+\param  argv_p                  Pointer to arguments.
+\param  ppszIfName_p            Returns the name of the POWERLINK interface, or NULL.
+\param  pFlags_p                Returns the tuning flags.
+\param  pPeriod_p               Returns the wake-up period of the measurement [us].
+\param  pDuration_p             Returns the duration of one measurement [ms].
+
+\return The function returns 0 if the parameters are valid, otherwise -1.
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, const char** ppszIfName_p, UINT* pFlags_p,
+                      UINT32* pPeriod_p, UINT* pDuration_p)
+{
+    int     opt;
+    BOOL    fValid = TRUE;
+
+    *ppszIfName_p = NULL;
+    *pFlags_p = RTTUNE_FLAG_MEASURE;
+    *pPeriod_p = RTTUNE_DEFAULT_PERIOD;
+    *pDuration_p = RTTUNE_DEFAULT_DURATION;
+
+    while ((opt = getopt(argc_p, argv_p, "ad:i:np:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'a':
+                *pFlags_p |= RTTUNE_FLAG_APPLY;
+                break;
+
+            case 'd':
+                *pDuration_p = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'i':
+                *ppszIfName_p = optarg;
+                break;
+
+            case 'n':
+                *pFlags_p &= ~RTTUNE_FLAG_MEASURE;
+                break;
+
+            case 'p':
+                *pPeriod_p = (UINT32)strtoul(optarg, NULL, 0);
+                break;
+
+            default: /* '?' */
+                fValid = FALSE;
+                break;
+        }
+    }
+
+    if (!fValid || (optind != argc_p) || (*pPeriod_p == 0) || (*pDuration_p == 0))
+    {
+        printf("Usage: %s [-a] [-n] [-i INTERFACE] [-p PERIOD] [-d DURATION]\n", argv_p[0]);
+        printf("  Inspects the real-time settings of the host\n");
+        printf("  -a  Apply the recommended settings (requires administrator rights)\n");
+        printf("  -i  POWERLINK interface whose interrupt moderation is tuned (device name or GUID)\n");
+        printf("  -n  Don't measure the impact of the applied settings\n");
+        printf("  -p  Wake-up period of the latency measurement in us (default: %d)\n", RTTUNE_DEFAULT_PERIOD);
+        printf("  -d  Duration of one latency measurement in ms (default: %d)\n", RTTUNE_DEFAULT_DURATION);
+        return -1;
+    }
+    return 0;
+}
+
+/// \}
@@ -0,0 +1,542 @@
+/**
+********************************************************************************
+\file   reinteg.c
+
+\brief  Node reintegration module of the MN demo application
+
+This file contains the node reintegration module of the MN demo application.
+
+The module tracks CNs which have been operational and dropped out of the
+network. The configuration of every CN (concise DCF and configuration
+date/time of object 0x1020) is staged from the CDC at startup and again
+whenever the application modifies the CDC. When a lost CN
+is found again, its IdentResponse is compared with the identity recorded
+during its last successful boot and with the staged configuration date/time.
+If both match, the configuration download is skipped and the CN is directly
+released for the transition to ReadyToOperate.
+
+While a CN is not operational, its process image slots are marked invalid,
+so the application uses safe values instead of stale data. The time from
+losing a CN until it is operational again is measured per node.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <console/console.h>
+#include <system/system.h>
+
+#include "reinteg.h"
+#include "cdc.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define REINTEG_NODE_COUNT          239         // number of possible CNs
+#define REINTEG_CONF_DATE_INDEX     0x1020      // CFM_VerifyConfiguration_REC
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Node reintegration record
+
+The structure contains the reintegration data of a single CN.
+*/
+typedef struct
+{
+    BOOL            fStaged;                ///< Configuration of the node is staged
+    const BYTE*     pDcf;                   ///< Cached concise DCF of the node
+    UINT            dcfSize;                ///< Size of the cached concise DCF
+    BOOL            fConfDateValid;         ///< Configuration date/time is contained in the DCF
+    UINT32          confDate;               ///< Known-good configuration date (0x1020/1)
+    UINT32          confTime;               ///< Known-good configuration time (0x1020/2)
+    BOOL            fIdentValid;            ///< Identity of the node has been recorded
+    UINT32          vendorId;               ///< Recorded vendor ID
+    UINT32          productCode;            ///< Recorded product code
+    UINT32          revisionNumber;         ///< Recorded revision number
+    UINT32          serialNumber;           ///< Recorded serial number
+    volatile BOOL   fDataValid;             ///< Process data of the node is valid
+    BOOL            fWasOperational;        ///< Node has been operational before
+    BOOL            fLost;                  ///< Node has dropped out and is not yet reintegrated
+    BOOL            fFastPath;              ///< Configuration is skipped for this reintegration
+    UINT64          lostTime;               ///< Time the node dropped out [ns]
+    UINT32          lostCount;              ///< Number of times the node dropped out
+    UINT32          reintegCount;           ///< Number of reintegrations
+    UINT32          fastPathCount;          ///< Number of reintegrations using the fast path
+    UINT64          lastReintegTime;        ///< Duration of the last reintegration [ns]
+    UINT64          minReintegTime;         ///< Minimum reintegration duration [ns]
+    UINT64          maxReintegTime;         ///< Maximum reintegration duration [ns]
+    UINT64          sumReintegTime;         ///< Sum of all reintegration durations [ns]
+} tReintegNode;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tReintegNode     aReintegNode_l[REINTEG_NODE_COUNT];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void   stageNodeConfig(UINT nodeId_p, tReintegNode* pNode_p);
+static void   recordIdentity(UINT nodeId_p, tReintegNode* pNode_p);
+static BOOL   checkIdentity(UINT nodeId_p, const tReintegNode* pNode_p);
+static void   nodeOperational(UINT nodeId_p, tReintegNode* pNode_p);
+static UINT32 getIdentValue(const UINT32* pValueLe_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the reintegration module
+
+The function initializes the reintegration module and stages the configuration
+of all CNs contained in the CDC. The CDC module must be initialized before.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError reinteg_init(void)
+{
+    UINT    nodeId;
+    UINT    stagedCount = 0;
+
+    memset(aReintegNode_l, 0, sizeof(aReintegNode_l));
+
+    for (nodeId = 1; nodeId <= REINTEG_NODE_COUNT; nodeId++)
+    {
+        stageNodeConfig(nodeId, &aReintegNode_l[nodeId - 1]);
+        if (aReintegNode_l[nodeId - 1].fStaged)
+            stagedCount++;
+    }
+
+    printf("Staged configuration of %u nodes for fast reintegration\n", stagedCount);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shutdown the reintegration module
+
+The function shuts down the reintegration module.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void reinteg_exit(void)
+{
+    UINT    i;
+
+    // the cached DCFs point into the CDC buffer which is freed by the CDC module
+    for (i = 0; i < REINTEG_NODE_COUNT; i++)
+    {
+        aReintegNode_l[i].pDcf = NULL;
+        aReintegNode_l[i].fDataValid = FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Restage the configuration of all nodes
+
+The function stages the configuration of all CNs again from the current CDC.
+It must be called after the application has modified the CDC, otherwise the
+fast path compares the identity of a CN with its previous configuration
+date/time and skips the download of the modified DCF. The recorded identities
+and statistics are kept.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void reinteg_restage(void)
+{
+    UINT    nodeId;
+
+    for (nodeId = 1; nodeId <= REINTEG_NODE_COUNT; nodeId++)
+        stageNodeConfig(nodeId, &aReintegNode_l[nodeId - 1]);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process node events
+
+The function is called by the application event handler for every node event.
+It tracks the state of the CNs and implements the fast reintegration path.
+
+\param  pNodeEvent_p            Pointer to the node event.
+
+\return The function returns kErrorReject if the configuration of the node is
+        skipped and the node state change has been triggered by the module,
+        otherwise kErrorOk.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError reinteg_processNodeEvent(const tOplkApiEventNode* pNodeEvent_p)
+{
+    tReintegNode*   pNode;
+    UINT            nodeId = pNodeEvent_p->nodeId;
+    tOplkError      ret = kErrorOk;
+
+    if ((nodeId == 0) || (nodeId > REINTEG_NODE_COUNT))
+        return kErrorOk;
+
+    pNode = &aReintegNode_l[nodeId - 1];
+
+    switch (pNodeEvent_p->nodeEvent)
+    {
+        case kNmtNodeEventNmtState:
+            if (pNodeEvent_p->nmtState == kNmtCsOperational)
+            {
+                nodeOperational(nodeId, pNode);
+            }
+            else
+            {
+                pNode->fDataValid = FALSE;
+                if (pNode->fWasOperational && !pNode->fLost)
+                {
+                    pNode->fLost = TRUE;
+                    pNode->fFastPath = FALSE;
+                    pNode->lostTime = system_getTimeNs();
+                    pNode->lostCount++;
+                }
+            }
+            break;
+
+        case kNmtNodeEventFound:
+            if (pNode->fLost)
+            {
+                pNode->fFastPath = checkIdentity(nodeId, pNode);
+                if (pNode->fFastPath)
+                    CONSOLE_LOG_INFO(kConsoleModEvent,
+                                     "Reintegration: (Node=%u) identity and configuration match, skipping configuration\n",
+                                     nodeId);
+                else
+                    CONSOLE_LOG_WARNING(kConsoleModEvent,
+                                        "Reintegration: (Node=%u) identity and configuration changed, full configuration\n",
+                                        nodeId);
+            }
+            break;
+
+#if defined(CONFIG_INCLUDE_CFM)
+        case kNmtNodeEventCheckConf:
+            if (pNode->fLost && pNode->fFastPath)
+            {
+                // The configuration on the node is identical to the staged one,
+                // so the CFM download is skipped. Returning kErrorReject tells the
+                // stack that the application triggers the node state change.
+                ret = oplk_triggerMnStateChange(nodeId, kNmtNodeCommandConfOk);
+                if (ret == kErrorOk)
+                {
+                    ret = kErrorReject;
+                }
+                else
+                {
+                    pNode->fFastPath = FALSE;
+                    ret = kErrorOk;
+                }
+            }
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if process data of a node is valid
+
+The function checks whether the process data of the given node is valid, i.e.
+the node is operational. The function is called by the synchronous task.
+
+\param  nodeId_p                Node ID of the CN.
+
+\return The function returns TRUE if the process data is valid, otherwise
+        FALSE.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL reinteg_isNodeDataValid(UINT nodeId_p)
+{
+    if ((nodeId_p == 0) || (nodeId_p > REINTEG_NODE_COUNT))
+        return FALSE;
+
+    return aReintegNode_l[nodeId_p - 1].fDataValid;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print reintegration statistics
+
+The function prints the time-to-reintegration statistics of all nodes which
+dropped out of the network.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void reinteg_printStatistics(void)
+{
+    UINT            i;
+    tReintegNode*   pNode;
+    BOOL            fHeader = FALSE;
+
+    for (i = 0; i < REINTEG_NODE_COUNT; i++)
+    {
+        pNode = &aReintegNode_l[i];
+        if (pNode->lostCount == 0)
+            continue;
+
+        if (!fHeader)
+        {
+            printf("Node reintegration statistics:\n");
+            printf("  Node   Lost  Reint  Fast   Last[ms]    Min[ms]    Avg[ms]    Max[ms]\n");
+            fHeader = TRUE;
+        }
+
+        if (pNode->reintegCount == 0)
+        {
+            printf("  %4u  %5lu  %5lu  %4lu   (not reintegrated)\n", i + 1,
+                   (ULONG)pNode->lostCount, 0UL, 0UL);
+            continue;
+        }
+
+        printf("  %4u  %5lu  %5lu  %4lu  %9lu  %9lu  %9lu  %9lu\n", i + 1,
+               (ULONG)pNode->lostCount, (ULONG)pNode->reintegCount,
+               (ULONG)pNode->fastPathCount,
+               (ULONG)(pNode->lastReintegTime / 1000000ULL),
+               (ULONG)(pNode->minReintegTime / 1000000ULL),
+               (ULONG)((pNode->sumReintegTime / pNode->reintegCount) / 1000000ULL),
+               (ULONG)(pNode->maxReintegTime / 1000000ULL));
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stage the configuration of a node
+
+The function caches the concise DCF of the node and its configuration
+date/time from the CDC. A previously staged configuration is replaced. The
+node events are processed concurrently, so the configuration is invalidated
+while it is updated.
+
+\param  nodeId_p                Node ID of the CN.
+\param  pNode_p                 Pointer to the node record.
+*/
+//------------------------------------------------------------------------------
+static void stageNodeConfig(UINT nodeId_p, tReintegNode* pNode_p)
+{
+    tCdcEntry       dateEntry;
+    tCdcEntry       timeEntry;
+
+    pNode_p->fStaged = FALSE;
+    pNode_p->fConfDateValid = FALSE;
+    system_memoryBarrier();
+
+    if (!cdc_getNodeDcf(nodeId_p, &pNode_p->pDcf, &pNode_p->dcfSize))
+    {
+        pNode_p->pDcf = NULL;
+        return;
+    }
+
+    if (cdc_findEntry(pNode_p->pDcf, pNode_p->dcfSize, REINTEG_CONF_DATE_INDEX, 1, &dateEntry) &&
+        cdc_findEntry(pNode_p->pDcf, pNode_p->dcfSize, REINTEG_CONF_DATE_INDEX, 2, &timeEntry))
+    {
+        pNode_p->confDate = (UINT32)cdc_getEntryValue(&dateEntry);
+        pNode_p->confTime = (UINT32)cdc_getEntryValue(&timeEntry);
+        system_memoryBarrier();
+        pNode_p->fConfDateValid = TRUE;
+    }
+
+    pNode_p->fStaged = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record identity of a node
+
+The function records the identity of a node from its IdentResponse. It is
+called when the node is operational, i.e. its identity is known to be good.
+
+\param  nodeId_p                Node ID of the CN.
+\param  pNode_p                 Pointer to the node record.
+*/
+//------------------------------------------------------------------------------
+static void recordIdentity(UINT nodeId_p, tReintegNode* pNode_p)
+{
+    tIdentResponse*     pIdent = NULL;
+
+    if ((oplk_getIdentResponse(nodeId_p, &pIdent) != kErrorOk) || (pIdent == NULL))
+        return;
+
+    pNode_p->vendorId = getIdentValue(&pIdent->vendorIdLe);
+    pNode_p->productCode = getIdentValue(&pIdent->productCodeLe);
+    pNode_p->revisionNumber = getIdentValue(&pIdent->revisionNumberLe);
+    pNode_p->serialNumber = getIdentValue(&pIdent->serialNumberLe);
+    pNode_p->fIdentValid = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check identity of a returning node
+
+The function compares the IdentResponse of a returning node with the recorded
+identity and the staged configuration date/time.
+
+\param  nodeId_p                Node ID of the CN.
+\param  pNode_p                 Pointer to the node record.
+
+\return The function returns TRUE if identity and configuration match.
+*/
+//------------------------------------------------------------------------------
+static BOOL checkIdentity(UINT nodeId_p, const tReintegNode* pNode_p)
+{
+    tIdentResponse*     pIdent = NULL;
+
+    if (!pNode_p->fStaged || !pNode_p->fIdentValid || !pNode_p->fConfDateValid)
+        return FALSE;
+
+    if ((oplk_getIdentResponse(nodeId_p, &pIdent) != kErrorOk) || (pIdent == NULL))
+        return FALSE;
+
+    return (getIdentValue(&pIdent->vendorIdLe) == pNode_p->vendorId) &&
+           (getIdentValue(&pIdent->productCodeLe) == pNode_p->productCode) &&
+           (getIdentValue(&pIdent->revisionNumberLe) == pNode_p->revisionNumber) &&
+           (getIdentValue(&pIdent->serialNumberLe) == pNode_p->serialNumber) &&
+           (getIdentValue(&pIdent->verifyConfigurationDateLe) == pNode_p->confDate) &&
+           (getIdentValue(&pIdent->verifyConfigurationTimeLe) == pNode_p->confTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Handle node becoming operational
+
+The function marks the process data of the node as valid and, if the node has
+been lost before, records the time-to-reintegration.
+
+\param  nodeId_p                Node ID of the CN.
+\param  pNode_p                 Pointer to the node record.
+*/
+//------------------------------------------------------------------------------
+static void nodeOperational(UINT nodeId_p, tReintegNode* pNode_p)
+{
+    UINT64      duration;
+
+    if (pNode_p->fLost)
+    {
+        duration = system_getTimeNs() - pNode_p->lostTime;
+
+        pNode_p->lastReintegTime = duration;
+        pNode_p->sumReintegTime += duration;
+        if ((pNode_p->reintegCount == 0) || (duration < pNode_p->minReintegTime))
+            pNode_p->minReintegTime = duration;
+        if (duration > pNode_p->maxReintegTime)
+            pNode_p->maxReintegTime = duration;
+        pNode_p->reintegCount++;
+        if (pNode_p->fFastPath)
+            pNode_p->fastPathCount++;
+
+        CONSOLE_LOG_INFO(kConsoleModEvent, "Reintegration: (Node=%u) operational after %lu ms (%s)\n",
+                         nodeId_p, (ULONG)(duration / 1000000ULL),
+                         (pNode_p->fFastPath ? "fast path" : "full configuration"));
+
+        pNode_p->fLost = FALSE;
+        pNode_p->fFastPath = FALSE;
+    }
+
+    // the identity of an operational node is known to be good
+    recordIdentity(nodeId_p, pNode_p);
+
+    pNode_p->fWasOperational = TRUE;
+    pNode_p->fDataValid = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get value from IdentResponse
+
+The function converts a little endian value of the IdentResponse frame into
+host byte order.
+
+\param  pValueLe_p              Pointer to the little endian value.
+
+\return The function returns the value in host byte order.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getIdentValue(const UINT32* pValueLe_p)
+{
+    const BYTE*     pData = (const BYTE*)pValueLe_p;
+
+    return (UINT32)pData[0] | ((UINT32)pData[1] << 8) |
+           ((UINT32)pData[2] << 16) | ((UINT32)pData[3] << 24);
+}
+
+/// \}
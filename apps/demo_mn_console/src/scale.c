@@ -0,0 +1,1166 @@
+/**
+********************************************************************************
+\file   scale.c
+
+\brief  Analog channel scaling of the MN demo application
+
+This file contains the analog channel scaling of the MN demo application.
+
+The scaling converts the raw values of analog channels into engineering units
+every cycle and the engineering values of outputs back into raw values. The
+channels and their data types are taken from the process image description
+(xap.xml), the conversion of each channel from a scaling table:
+
+    # name                                   gain    offset  [min max] [swap] [pwl=x:y,...]
+    CN1.M01.AnalogInput_00h_AI16.Value       0.01    -10.0   -10 10    swap
+
+A channel is converted by value = pwl(raw * gain + offset), clamped to
+[min, max]. The optional piecewise-linear curve linearizes a sensor, "swap"
+selects big-endian raw data.
+
+The channels are sorted into batches of the same data type and byte order, and
+their parameters are kept in separate arrays. The conversion of a batch is
+split into a gather of the raw values and a vector kernel working on contiguous
+arrays. Channels of 32 and 64 bit integer types and of 64 bit reals exceed the
+precision of float, they are converted to and from engineering units in double
+precision by the gather and scatter, and the float kernels only apply their
+limits.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "pidesc.h"
+#include "scale.h"
+#include "simd.h"
+
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define SCALE_LINE_LEN          512         // maximum length of a line in the scaling table
+#define SCALE_MAX_BATCHES       64          // maximum number of channel batches
+
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Channel configuration
+
+The structure contains the configuration of a channel while the scaling table
+is loaded.
+*/
+typedef struct
+{
+    const char*     pszName;                ///< Channel name (NULL for benchmark channels)
+    tPiDescImage    image;                  ///< Process image of the channel
+    tPiDescType     type;                   ///< Data type of the channel
+    UINT            piOffset;               ///< Offset in the process image [bytes]
+    BOOL            fSwap;                  ///< Raw value is big-endian
+    double          gain;                   ///< Gain
+    double          offset;                 ///< Offset
+    float           min;                    ///< Lower limit of the engineering value
+    float           max;                    ///< Upper limit of the engineering value
+    int             pwlIndex;               ///< Index of the piecewise-linear curve or -1
+} tScaleConfig;
+
+/**
+\brief  Piecewise-linear curve
+
+The structure describes the piecewise-linear curve of a channel.
+*/
+typedef struct
+{
+    UINT            valueIndex;                     ///< Index of the channel value
+    UINT            pointCount;                     ///< Number of points
+    float           aX[SCALE_MAX_PWL_POINTS];       ///< Curve input, strictly increasing
+    float           aY[SCALE_MAX_PWL_POINTS];       ///< Curve output
+    float           min;                            ///< Lower limit of the engineering value
+    float           max;                            ///< Upper limit of the engineering value
+} tScalePwl;
+
+/**
+\brief  Channel batch
+
+The structure describes a batch of channels with the same process image, data
+type and byte order. The channels of a batch occupy a contiguous range of the
+channel arrays.
+*/
+typedef struct
+{
+    tPiDescImage    image;                  ///< Process image of the batch
+    tPiDescType     type;                   ///< Data type of the batch
+    BOOL            fSwap;                  ///< Raw values are big-endian
+    UINT            first;                  ///< Index of the first channel
+    UINT            count;                  ///< Number of channels
+} tScaleBatch;
+
+/**
+\brief  Scaling instance
+
+The structure contains the channel arrays of the scaling. Every channel
+parameter is stored in its own array, so the kernels process contiguous data.
+*/
+typedef struct
+{
+    UINT            aPiOffset[SCALE_MAX_CHANNELS];  ///< Offsets in the process image [bytes]
+    float           aGain[SCALE_MAX_CHANNELS];      ///< Gains, 1 for wide channels
+    float           aInvGain[SCALE_MAX_CHANNELS];   ///< Reciprocal gains for outputs, 1 for wide channels
+    float           aOffset[SCALE_MAX_CHANNELS];    ///< Offsets, 0 for wide channels
+    double          aWideGain[SCALE_MAX_CHANNELS];  ///< Gains of wide channels
+    double          aWideOffset[SCALE_MAX_CHANNELS];///< Offsets of wide channels
+    float           aMin[SCALE_MAX_CHANNELS];       ///< Lower limits, -FLT_MAX for curves
+    float           aMax[SCALE_MAX_CHANNELS];       ///< Upper limits, FLT_MAX for curves
+    float           aValue[SCALE_MAX_CHANNELS];     ///< Engineering values
+    float           aStage[SCALE_MAX_CHANNELS];     ///< Staging area of output conversion
+    const char*     apName[SCALE_MAX_CHANNELS];     ///< Channel names
+    UINT            channelCount;                   ///< Number of channels
+    UINT            inputCount;                     ///< Number of input channels (first)
+    tScaleBatch     aBatch[SCALE_MAX_BATCHES];      ///< Channel batches
+    UINT            batchCount;                     ///< Number of batches
+    tScalePwl       aPwl[SCALE_MAX_PWL_CHANNELS];   ///< Piecewise-linear curves
+    UINT            pwlCount;                       ///< Number of curves
+} tScaleInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tScaleInstance   scaleInstance_l;
+static tScaleConfig     aConfig_l[SCALE_MAX_CHANNELS];
+static UINT             configCount_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p);
+static tOplkError parseCurve(const char* pCurve_p, tScalePwl* pPwl_p, BOOL fOutput_p);
+static tOplkError addChannel(const tScaleConfig* pConfig_p);
+static void       buildChannels(void);
+static int        compareConfig(const void* pLeft_p, const void* pRight_p);
+static void       gatherBatch(const tScaleBatch* pBatch_p, const BYTE* pPi_p);
+static void       scatterBatch(const tScaleBatch* pBatch_p, BYTE* pPi_p);
+static void       kernelForward(float* pValue_p, const float* pGain_p, const float* pOffset_p,
+                                const float* pMin_p, const float* pMax_p, UINT count_p);
+static void       kernelReverse(float* pValue_p, const float* pInvGain_p, const float* pOffset_p,
+                                const float* pMin_p, const float* pMax_p, UINT count_p);
+static float      evalCurve(const float* pX_p, const float* pY_p, UINT count_p, float x_p);
+static UINT64     loadRaw(const BYTE* pData_p, UINT size_p, BOOL fSwap_p);
+static void       storeRaw(BYTE* pData_p, UINT64 value_p, UINT size_p, BOOL fSwap_p);
+static UINT       getTypeSize(tPiDescType type_p);
+static BOOL       isWideType(tPiDescType type_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the scaling
+
+The function loads the scaling table. The channels are looked up in the
+process image description, which must be loaded before.
+
+\param  pszTableFile_p          File name of the scaling table.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError scale_init(const char* pszTableFile_p)
+{
+    FILE*           pFile;
+    char            aLine[SCALE_LINE_LEN];
+    UINT            lineNo = 0;
+    tOplkError      ret = kErrorOk;
+
+    memset(&scaleInstance_l, 0, sizeof(scaleInstance_l));
+    configCount_l = 0;
+
+    pFile = fopen(pszTableFile_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Unable to open scaling table %s!\n", pszTableFile_p);
+        return kErrorNoResource;
+    }
+
+    while ((ret == kErrorOk) && (fgets(aLine, sizeof(aLine), pFile) != NULL))
+    {
+        lineNo++;
+        ret = parseLine(aLine);
+    }
+    fclose(pFile);
+
+    if (ret != kErrorOk)
+    {
+        fprintf(stderr, "Invalid scaling of line %u in %s!\n", lineNo, pszTableFile_p);
+        return ret;
+    }
+
+    buildChannels();
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert the inputs
+
+The function converts the raw values of all input channels into engineering
+values. It is called after the output process image has been received.
+
+\param  pPiOut_p                Pointer to the output process image (data
+                                received from the CNs).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void scale_processInputs(const BYTE* pPiOut_p)
+{
+    tScaleInstance*     pInst = &scaleInstance_l;
+    const tScalePwl*    pPwl;
+    float               value;
+    UINT                i;
+
+    for (i = 0; i < pInst->batchCount; i++)
+    {
+        if (pInst->aBatch[i].image == kPiDescImageOut)
+            gatherBatch(&pInst->aBatch[i], pPiOut_p);
+    }
+
+    kernelForward(pInst->aValue, pInst->aGain, pInst->aOffset, pInst->aMin, pInst->aMax,
+                  pInst->inputCount);
+
+    // the curves are evaluated after the linear part, their limits are applied here
+    for (i = 0; i < pInst->pwlCount; i++)
+    {
+        pPwl = &pInst->aPwl[i];
+        if (pPwl->valueIndex >= pInst->inputCount)
+            continue;
+
+        value = evalCurve(pPwl->aX, pPwl->aY, pPwl->pointCount, pInst->aValue[pPwl->valueIndex]);
+        pInst->aValue[pPwl->valueIndex] = (value < pPwl->min) ? pPwl->min :
+                                          (value > pPwl->max) ? pPwl->max : value;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert the outputs
+
+The function converts the engineering values of all output channels into raw
+values. It is called before the input process image is handed over.
+
+\param  pPiIn_p                 Pointer to the input process image (data sent
+                                to the CNs).
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void scale_processOutputs(BYTE* pPiIn_p)
+{
+    tScaleInstance*     pInst = &scaleInstance_l;
+    const tScalePwl*    pPwl;
+    UINT                first = pInst->inputCount;
+    UINT                count = pInst->channelCount - pInst->inputCount;
+    float               value;
+    UINT                i;
+
+    if (count == 0)
+        return;
+
+    memcpy(&pInst->aStage[first], &pInst->aValue[first], count * sizeof(float));
+
+    // the curves are inverted before the linear part
+    for (i = 0; i < pInst->pwlCount; i++)
+    {
+        pPwl = &pInst->aPwl[i];
+        if (pPwl->valueIndex < first)
+            continue;
+
+        value = pInst->aStage[pPwl->valueIndex];
+        value = (value < pPwl->min) ? pPwl->min : (value > pPwl->max) ? pPwl->max : value;
+        pInst->aStage[pPwl->valueIndex] = evalCurve(pPwl->aY, pPwl->aX, pPwl->pointCount, value);
+    }
+
+    kernelReverse(&pInst->aStage[first], &pInst->aInvGain[first], &pInst->aOffset[first],
+                  &pInst->aMin[first], &pInst->aMax[first], count);
+
+    for (i = 0; i < pInst->batchCount; i++)
+    {
+        if (pInst->aBatch[i].image == kPiDescImageIn)
+            scatterBatch(&pInst->aBatch[i], pPiIn_p);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the engineering values
+
+The function returns the array of engineering values. The inputs are written
+by scale_processInputs(), the outputs are read by scale_processOutputs().
+
+\return The function returns a pointer to the engineering values.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+float* scale_getValues(void)
+{
+    return scaleInstance_l.aValue;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find the engineering value of a channel
+
+\param  pszName_p               Channel name as in xap.xml.
+
+\return The function returns the index of the value or -1 if the channel is
+        not scaled.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+int scale_findValue(const char* pszName_p)
+{
+    UINT    i;
+
+    for (i = 0; i < scaleInstance_l.channelCount; i++)
+    {
+        if ((scaleInstance_l.apName[i] != NULL) && (strcmp(scaleInstance_l.apName[i], pszName_p) == 0))
+            return (int)i;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the scaling configuration
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void scale_printConfig(void)
+{
+    printf("Scaling %u input and %u output channels in %u batches (%u curves, %s kernel)\n",
+           scaleInstance_l.inputCount, scaleInstance_l.channelCount - scaleInstance_l.inputCount,
+           scaleInstance_l.batchCount, scaleInstance_l.pwlCount, SIMD_NAME);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Benchmark the scaling
+
+The function measures the conversion time of a synthetic configuration with
+the given number of 16 bit input and output channels. Every fourth channel is
+big-endian, every sixteenth has a curve. The configuration of the scaling is
+replaced.
+
+\param  channelCount_p          Number of input and of output channels.
+\param  cycleCount_p            Number of measured cycles.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void scale_benchmark(UINT channelCount_p, UINT cycleCount_p)
+{
+    tScaleConfig    config;
+    BYTE*           pImage;
+    UINT            imageSize;
+    UINT            i;
+    UINT            cycle;
+    UINT64          start;
+    UINT64          time;
+    UINT64          minTime = ~0ULL;
+    UINT64          maxTime = 0;
+    UINT64          sumTime = 0;
+
+    if ((channelCount_p == 0) || (cycleCount_p == 0))
+        return;
+
+    if (channelCount_p > SCALE_MAX_CHANNELS / 2)
+        channelCount_p = SCALE_MAX_CHANNELS / 2;
+
+    imageSize = channelCount_p * 2;
+    pImage = (BYTE*)malloc(imageSize * 2);
+    if (pImage == NULL)
+        return;
+
+    memset(&scaleInstance_l, 0, sizeof(scaleInstance_l));
+    configCount_l = 0;
+
+    for (i = 0; i < channelCount_p * 2; i++)
+    {
+        memset(&config, 0, sizeof(config));
+        config.image = (i < channelCount_p) ? kPiDescImageOut : kPiDescImageIn;
+        config.type = kPiDescTypeInteger16;
+        config.piOffset = (i % channelCount_p) * 2;
+        config.fSwap = ((i % 4) == 0);
+        config.gain = 0.01f;
+        config.offset = -10.0f;
+        config.min = -100.0f;
+        config.max = 100.0f;
+        config.pwlIndex = -1;
+        if (((i % 16) == 0) && (scaleInstance_l.pwlCount < SCALE_MAX_PWL_CHANNELS))
+        {
+            config.pwlIndex = (int)scaleInstance_l.pwlCount;
+            parseCurve("-400:-100,0:0,100:50,400:100", &scaleInstance_l.aPwl[scaleInstance_l.pwlCount++], TRUE);
+        }
+        addChannel(&config);
+    }
+    buildChannels();
+
+    for (i = 0; i < imageSize * 2; i++)
+        pImage[i] = (BYTE)(i * 37);
+
+    for (cycle = 0; cycle < cycleCount_p; cycle++)
+    {
+        start = system_getTimeNs();
+        scale_processInputs(pImage);
+        scale_processOutputs(pImage + imageSize);
+        time = system_getTimeNs() - start;
+
+        if (time < minTime)
+            minTime = time;
+        if (time > maxTime)
+            maxTime = time;
+        sumTime += time;
+
+        // the application would calculate new outputs here
+        memcpy(&scaleInstance_l.aValue[channelCount_p], scaleInstance_l.aValue,
+               channelCount_p * sizeof(float));
+    }
+
+    printf("Scaling: %u inputs + %u outputs, %s kernel\n", channelCount_p, channelCount_p,
+           SIMD_NAME);
+    printf("  Cycle time min/avg/max: %lu / %lu / %lu ns, %.1f ns per channel\n",
+           (ULONG)minTime, (ULONG)(sumTime / cycleCount_p), (ULONG)maxTime,
+           (double)sumTime / cycleCount_p / (channelCount_p * 2));
+
+    memset(&scaleInstance_l, 0, sizeof(scaleInstance_l));
+    free(pImage);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a line of the scaling table
+
+\param  pLine_p                 Pointer to the line, it is modified.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseLine(char* pLine_p)
+{
+    tScaleConfig            config;
+    const tPiDescChannel*   pChannel;
+    char*                   apToken[8];
+    char*                   pToken;
+    UINT                    tokenCount = 0;
+    UINT                    i;
+    char*                   pEnd;
+    char*                   pComment;
+    tOplkError              ret;
+
+    pComment = strchr(pLine_p, '#');
+    if (pComment != NULL)
+        *pComment = '\0';
+
+    for (pToken = strtok(pLine_p, " \t\r\n"); pToken != NULL; pToken = strtok(NULL, " \t\r\n"))
+    {
+        if (tokenCount >= 8)
+            return kErrorApiInvalidParam;
+        apToken[tokenCount++] = pToken;
+    }
+
+    if (tokenCount == 0)
+        return kErrorOk;
+    if (tokenCount < 3)
+        return kErrorApiInvalidParam;
+
+    memset(&config, 0, sizeof(config));
+    pChannel = pidesc_findChannel(apToken[0], &config.image);
+    if (pChannel == NULL)
+    {
+        fprintf(stderr, "Channel %s not found in the process image!\n", apToken[0]);
+        return kErrorApiInvalidParam;
+    }
+    if ((getTypeSize(pChannel->type) == 0) || ((pChannel->offset % 8) != 0))
+    {
+        fprintf(stderr, "Channel %s can't be scaled!\n", apToken[0]);
+        return kErrorApiInvalidParam;
+    }
+
+    config.pszName = pChannel->aName;
+    config.type = pChannel->type;
+    config.piOffset = pChannel->offset / 8;
+    config.min = -FLT_MAX;
+    config.max = FLT_MAX;
+    config.pwlIndex = -1;
+    config.gain = strtod(apToken[1], &pEnd);
+    if ((*pEnd != '\0') || (config.gain == 0.0))
+        return kErrorApiInvalidParam;
+    config.offset = strtod(apToken[2], &pEnd);
+    if (*pEnd != '\0')
+        return kErrorApiInvalidParam;
+
+    // the limits are optional, options start with a letter
+    i = 3;
+    if (tokenCount >= 5)
+    {
+        config.min = (float)strtod(apToken[3], &pEnd);
+        if (*pEnd == '\0')
+        {
+            config.max = (float)strtod(apToken[4], &pEnd);
+            if ((*pEnd != '\0') || (config.min > config.max))
+                return kErrorApiInvalidParam;
+            i = 5;
+        }
+        else
+        {
+            config.min = -FLT_MAX;
+        }
+    }
+
+    for (; i < tokenCount; i++)
+    {
+        if (strcmp(apToken[i], "swap") == 0)
+        {
+            config.fSwap = TRUE;
+        }
+        else if ((strncmp(apToken[i], "pwl=", 4) == 0) &&
+                 (scaleInstance_l.pwlCount < SCALE_MAX_PWL_CHANNELS))
+        {
+            ret = parseCurve(apToken[i] + 4, &scaleInstance_l.aPwl[scaleInstance_l.pwlCount],
+                             config.image == kPiDescImageIn);
+            if (ret != kErrorOk)
+                return ret;
+            config.pwlIndex = (int)scaleInstance_l.pwlCount++;
+        }
+        else
+        {
+            return kErrorApiInvalidParam;
+        }
+    }
+
+    return addChannel(&config);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse a piecewise-linear curve
+
+\param  pCurve_p                Pointer to the curve points (x:y,x:y,...).
+\param  pPwl_p                  Pointer to store the curve.
+\param  fOutput_p               The curve is used for an output, so it must be
+                                invertible.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError parseCurve(const char* pCurve_p, tScalePwl* pPwl_p, BOOL fOutput_p)
+{
+    const char*     pPos = pCurve_p;
+    char*           pEnd;
+    UINT            i;
+
+    memset(pPwl_p, 0, sizeof(tScalePwl));
+    while ((*pPos != '\0') && (pPwl_p->pointCount < SCALE_MAX_PWL_POINTS))
+    {
+        pPwl_p->aX[pPwl_p->pointCount] = (float)strtod(pPos, &pEnd);
+        if (*pEnd != ':')
+            return kErrorApiInvalidParam;
+        pPwl_p->aY[pPwl_p->pointCount] = (float)strtod(pEnd + 1, &pEnd);
+        if ((*pEnd != ',') && (*pEnd != '\0'))
+            return kErrorApiInvalidParam;
+
+        pPwl_p->pointCount++;
+        pPos = (*pEnd == ',') ? pEnd + 1 : pEnd;
+    }
+
+    if ((*pPos != '\0') || (pPwl_p->pointCount < 2))
+        return kErrorApiInvalidParam;
+
+    for (i = 1; i < pPwl_p->pointCount; i++)
+    {
+        if (pPwl_p->aX[i] <= pPwl_p->aX[i - 1])
+            return kErrorApiInvalidParam;
+
+        // outputs evaluate the curve from y to x
+        if (fOutput_p && (pPwl_p->aY[i] <= pPwl_p->aY[i - 1]))
+            return kErrorApiInvalidParam;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a channel to the configuration
+
+\param  pConfig_p               Pointer to the channel configuration.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError addChannel(const tScaleConfig* pConfig_p)
+{
+    if (configCount_l >= SCALE_MAX_CHANNELS)
+        return kErrorNoResource;
+
+    aConfig_l[configCount_l++] = *pConfig_p;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Build the channel arrays
+
+The function sorts the configured channels into batches and fills the channel
+arrays. Inputs come first, so both directions are contiguous.
+*/
+//------------------------------------------------------------------------------
+static void buildChannels(void)
+{
+    tScaleInstance*     pInst = &scaleInstance_l;
+    const tScaleConfig* pConfig;
+    tScaleBatch*        pBatch = NULL;
+    tScalePwl*          pPwl;
+    UINT                i;
+
+    qsort(aConfig_l, configCount_l, sizeof(tScaleConfig), compareConfig);
+
+    for (i = 0; i < configCount_l; i++)
+    {
+        pConfig = &aConfig_l[i];
+
+        if ((pBatch == NULL) || (pBatch->image != pConfig->image) ||
+            (pBatch->type != pConfig->type) || (pBatch->fSwap != pConfig->fSwap))
+        {
+            if (pInst->batchCount >= SCALE_MAX_BATCHES)
+                break;
+
+            pBatch = &pInst->aBatch[pInst->batchCount++];
+            pBatch->image = pConfig->image;
+            pBatch->type = pConfig->type;
+            pBatch->fSwap = pConfig->fSwap;
+            pBatch->first = i;
+            pBatch->count = 0;
+        }
+        pBatch->count++;
+
+        pInst->apName[i] = pConfig->pszName;
+        pInst->aPiOffset[i] = pConfig->piOffset;
+        if (isWideType(pConfig->type))
+        {
+            pInst->aWideGain[i] = pConfig->gain;
+            pInst->aWideOffset[i] = pConfig->offset;
+            pInst->aGain[i] = 1.0f;
+            pInst->aInvGain[i] = 1.0f;
+            pInst->aOffset[i] = 0.0f;
+        }
+        else
+        {
+            pInst->aGain[i] = (float)pConfig->gain;
+            pInst->aInvGain[i] = (float)(1.0 / pConfig->gain);
+            pInst->aOffset[i] = (float)pConfig->offset;
+        }
+        pInst->aMin[i] = pConfig->min;
+        pInst->aMax[i] = pConfig->max;
+
+        // the limits of channels with a curve are applied by the curve
+        if (pConfig->pwlIndex >= 0)
+        {
+            pPwl = &pInst->aPwl[pConfig->pwlIndex];
+            pPwl->valueIndex = i;
+            pPwl->min = pConfig->min;
+            pPwl->max = pConfig->max;
+            pInst->aMin[i] = -FLT_MAX;
+            pInst->aMax[i] = FLT_MAX;
+        }
+
+        if (pConfig->image == kPiDescImageOut)
+            pInst->inputCount++;
+        pInst->channelCount++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare channel configurations
+
+The channels are ordered by process image, data type, byte order and offset.
+
+\param  pLeft_p                 Pointer to the first channel.
+\param  pRight_p                Pointer to the second channel.
+
+\return The function returns the comparison result for qsort().
+*/
+//------------------------------------------------------------------------------
+static int compareConfig(const void* pLeft_p, const void* pRight_p)
+{
+    const tScaleConfig* pLeft = (const tScaleConfig*)pLeft_p;
+    const tScaleConfig* pRight = (const tScaleConfig*)pRight_p;
+
+    if (pLeft->image != pRight->image)
+        return (pLeft->image < pRight->image) ? -1 : 1;
+    if (pLeft->type != pRight->type)
+        return (pLeft->type < pRight->type) ? -1 : 1;
+    if (pLeft->fSwap != pRight->fSwap)
+        return pLeft->fSwap ? 1 : -1;
+
+    return (pLeft->piOffset < pRight->piOffset) ? -1 : (pLeft->piOffset > pRight->piOffset);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Gather the raw values of a batch
+
+The function reads the raw values of a batch of input channels and stores them
+as floating point values. Wide channels are scaled to engineering units here
+in double precision. The type is resolved once per batch, so the loops contain
+no branches.
+
+\param  pBatch_p                Pointer to the batch.
+\param  pPi_p                   Pointer to the process image.
+*/
+//------------------------------------------------------------------------------
+static void gatherBatch(const tScaleBatch* pBatch_p, const BYTE* pPi_p)
+{
+    const UINT*     pOffset = &scaleInstance_l.aPiOffset[pBatch_p->first];
+    float*          pValue = &scaleInstance_l.aValue[pBatch_p->first];
+    const double*   pGain = &scaleInstance_l.aWideGain[pBatch_p->first];
+    const double*   pWideOffset = &scaleInstance_l.aWideOffset[pBatch_p->first];
+    UINT            size = getTypeSize(pBatch_p->type);
+    BOOL            fSwap = pBatch_p->fSwap;
+    UINT64          raw;
+    UINT32          raw32;
+    float           real32;
+    double          real64;
+    UINT            i;
+
+    switch (pBatch_p->type)
+    {
+        case kPiDescTypeInteger8:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)(INT8)pPi_p[pOffset[i]];
+            break;
+
+        case kPiDescTypeUnsigned8:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)pPi_p[pOffset[i]];
+            break;
+
+        case kPiDescTypeInteger16:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)(INT16)loadRaw(&pPi_p[pOffset[i]], 2, fSwap);
+            break;
+
+        case kPiDescTypeUnsigned16:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)(UINT16)loadRaw(&pPi_p[pOffset[i]], 2, fSwap);
+            break;
+
+        case kPiDescTypeInteger32:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)((double)(INT32)loadRaw(&pPi_p[pOffset[i]], 4, fSwap) * pGain[i] + pWideOffset[i]);
+            break;
+
+        case kPiDescTypeUnsigned32:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)((double)(UINT32)loadRaw(&pPi_p[pOffset[i]], 4, fSwap) * pGain[i] + pWideOffset[i]);
+            break;
+
+        case kPiDescTypeReal32:
+            for (i = 0; i < pBatch_p->count; i++)
+            {
+                raw32 = (UINT32)loadRaw(&pPi_p[pOffset[i]], size, fSwap);
+                memcpy(&real32, &raw32, sizeof(real32));
+                pValue[i] = real32;
+            }
+            break;
+
+        case kPiDescTypeInteger64:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)((double)(INT64)loadRaw(&pPi_p[pOffset[i]], 8, fSwap) * pGain[i] + pWideOffset[i]);
+            break;
+
+        case kPiDescTypeUnsigned64:
+            for (i = 0; i < pBatch_p->count; i++)
+                pValue[i] = (float)((double)loadRaw(&pPi_p[pOffset[i]], 8, fSwap) * pGain[i] + pWideOffset[i]);
+            break;
+
+        case kPiDescTypeReal64:
+            for (i = 0; i < pBatch_p->count; i++)
+            {
+                raw = loadRaw(&pPi_p[pOffset[i]], size, fSwap);
+                memcpy(&real64, &raw, sizeof(real64));
+                pValue[i] = (float)(real64 * pGain[i] + pWideOffset[i]);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Scatter the raw values of a batch
+
+The function rounds the converted values of a batch of output channels,
+saturates them to the range of the data type and writes them into the process
+image. Wide channels are scaled to raw units here in double precision. NaN is
+written as 0 to integer channels.
+
+\param  pBatch_p                Pointer to the batch.
+\param  pPi_p                   Pointer to the process image.
+*/
+//------------------------------------------------------------------------------
+static void scatterBatch(const tScaleBatch* pBatch_p, BYTE* pPi_p)
+{
+    const UINT*     pOffset = &scaleInstance_l.aPiOffset[pBatch_p->first];
+    const float*    pStage = &scaleInstance_l.aStage[pBatch_p->first];
+    const double*   pGain = &scaleInstance_l.aWideGain[pBatch_p->first];
+    const double*   pWideOffset = &scaleInstance_l.aWideOffset[pBatch_p->first];
+    BOOL            fWide = isWideType(pBatch_p->type);
+    UINT            size = getTypeSize(pBatch_p->type);
+    BOOL            fSwap = pBatch_p->fSwap;
+    double          min;
+    double          max;
+    double          value;
+    UINT32          raw32;
+    UINT64          raw;
+    UINT            i;
+
+    switch (pBatch_p->type)
+    {
+        case kPiDescTypeReal32:
+            for (i = 0; i < pBatch_p->count; i++)
+            {
+                memcpy(&raw32, &pStage[i], sizeof(raw32));
+                storeRaw(&pPi_p[pOffset[i]], raw32, size, fSwap);
+            }
+            return;
+
+        case kPiDescTypeReal64:
+            for (i = 0; i < pBatch_p->count; i++)
+            {
+                value = ((double)pStage[i] - pWideOffset[i]) / pGain[i];
+                memcpy(&raw, &value, sizeof(raw));
+                storeRaw(&pPi_p[pOffset[i]], raw, size, fSwap);
+            }
+            return;
+
+        case kPiDescTypeInteger8:
+        case kPiDescTypeInteger16:
+        case kPiDescTypeInteger32:
+        case kPiDescTypeInteger64:
+            // the largest 64 bit value is not representable as double
+            max = (size == 8) ? 9223372036854774784.0 : (double)((1ULL << (size * 8 - 1)) - 1);
+            min = -max - 1.0;
+            break;
+
+        default:
+            min = 0.0;
+            max = (size == 8) ? 18446744073709549568.0 : (double)((1ULL << (size * 8)) - 1);
+            break;
+    }
+
+    for (i = 0; i < pBatch_p->count; i++)
+    {
+        value = fWide ? (((double)pStage[i] - pWideOffset[i]) / pGain[i]) : (double)pStage[i];
+
+        // the conversion of NaN or of values out of range is undefined
+        if (value != value)
+            value = 0.0;
+        value += (value >= 0.0) ? 0.5 : -0.5;
+        value = (value < min) ? min : (value > max) ? max : value;
+        raw = (min < 0.0) ? (UINT64)(INT64)value : (UINT64)value;
+        storeRaw(&pPi_p[pOffset[i]], raw, size, fSwap);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Scale values to engineering units
+
+The function calculates value = clamp(value * gain + offset, min, max) for
+contiguous arrays.
+
+\param  pValue_p                Pointer to the values, converted in place.
+\param  pGain_p                 Pointer to the gains.
+\param  pOffset_p               Pointer to the offsets.
+\param  pMin_p                  Pointer to the lower limits.
+\param  pMax_p                  Pointer to the upper limits.
+\param  count_p                 Number of values.
+*/
+//------------------------------------------------------------------------------
+static void kernelForward(float* pValue_p, const float* pGain_p, const float* pOffset_p,
+                          const float* pMin_p, const float* pMax_p, UINT count_p)
+{
+    UINT        i = 0;
+    float       value;
+    tSimdVec    vec;
+
+    for (; i + SIMD_WIDTH <= count_p; i += SIMD_WIDTH)
+    {
+        vec = SIMD_ADD(SIMD_MUL(SIMD_LOAD(&pValue_p[i]), SIMD_LOAD(&pGain_p[i])), SIMD_LOAD(&pOffset_p[i]));
+        vec = SIMD_MIN(SIMD_MAX(vec, SIMD_LOAD(&pMin_p[i])), SIMD_LOAD(&pMax_p[i]));
+        SIMD_STORE(&pValue_p[i], vec);
+    }
+
+    for (; i < count_p; i++)
+    {
+        value = pValue_p[i] * pGain_p[i] + pOffset_p[i];
+        pValue_p[i] = (value < pMin_p[i]) ? pMin_p[i] : (value > pMax_p[i]) ? pMax_p[i] : value;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Scale values to raw units
+
+The function calculates value = (clamp(value, min, max) - offset) / gain for
+contiguous arrays.
+
+\param  pValue_p                Pointer to the values, converted in place.
+\param  pInvGain_p              Pointer to the reciprocal gains.
+\param  pOffset_p               Pointer to the offsets.
+\param  pMin_p                  Pointer to the lower limits.
+\param  pMax_p                  Pointer to the upper limits.
+\param  count_p                 Number of values.
+*/
+//------------------------------------------------------------------------------
+static void kernelReverse(float* pValue_p, const float* pInvGain_p, const float* pOffset_p,
+                          const float* pMin_p, const float* pMax_p, UINT count_p)
+{
+    UINT        i = 0;
+    float       value;
+    tSimdVec    vec;
+
+    for (; i + SIMD_WIDTH <= count_p; i += SIMD_WIDTH)
+    {
+        vec = SIMD_MIN(SIMD_MAX(SIMD_LOAD(&pValue_p[i]), SIMD_LOAD(&pMin_p[i])), SIMD_LOAD(&pMax_p[i]));
+        vec = SIMD_MUL(SIMD_SUB(vec, SIMD_LOAD(&pOffset_p[i])), SIMD_LOAD(&pInvGain_p[i]));
+        SIMD_STORE(&pValue_p[i], vec);
+    }
+
+    for (; i < count_p; i++)
+    {
+        value = pValue_p[i];
+        value = (value < pMin_p[i]) ? pMin_p[i] : (value > pMax_p[i]) ? pMax_p[i] : value;
+        pValue_p[i] = (value - pOffset_p[i]) * pInvGain_p[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate a piecewise-linear curve
+
+Values outside of the curve are limited to its end points.
+
+\param  pX_p                    Pointer to the curve inputs, strictly increasing.
+\param  pY_p                    Pointer to the curve outputs.
+\param  count_p                 Number of points.
+\param  x_p                     Input value.
+
+\return The function returns the output value.
+*/
+//------------------------------------------------------------------------------
+static float evalCurve(const float* pX_p, const float* pY_p, UINT count_p, float x_p)
+{
+    UINT    i;
+
+    if (x_p <= pX_p[0])
+        return pY_p[0];
+
+    for (i = 1; i < count_p; i++)
+    {
+        if (x_p <= pX_p[i])
+            return pY_p[i - 1] + (x_p - pX_p[i - 1]) * (pY_p[i] - pY_p[i - 1]) / (pX_p[i] - pX_p[i - 1]);
+    }
+
+    return pY_p[count_p - 1];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load a raw value
+
+\param  pData_p                 Pointer to the value in the process image.
+\param  size_p                  Size of the value in bytes.
+\param  fSwap_p                 The value is big-endian.
+
+\return The function returns the raw value.
+*/
+//------------------------------------------------------------------------------
+static UINT64 loadRaw(const BYTE* pData_p, UINT size_p, BOOL fSwap_p)
+{
+    UINT64  value = 0;
+    UINT    i;
+
+    // the process image is little-endian
+    if (fSwap_p)
+    {
+        for (i = 0; i < size_p; i++)
+            value = (value << 8) | pData_p[i];
+    }
+    else
+    {
+        for (i = size_p; i > 0; i--)
+            value = (value << 8) | pData_p[i - 1];
+    }
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Store a raw value
+
+\param  pData_p                 Pointer to the value in the process image.
+\param  value_p                 Raw value.
+\param  size_p                  Size of the value in bytes.
+\param  fSwap_p                 The value is big-endian.
+*/
+//------------------------------------------------------------------------------
+static void storeRaw(BYTE* pData_p, UINT64 value_p, UINT size_p, BOOL fSwap_p)
+{
+    UINT    i;
+
+    for (i = 0; i < size_p; i++)
+    {
+        pData_p[fSwap_p ? (size_p - 1 - i) : i] = (BYTE)value_p;
+        value_p >>= 8;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the size of a data type
+
+\param  type_p                  Data type.
+
+\return The function returns the size in bytes or 0 for unknown types.
+*/
+//------------------------------------------------------------------------------
+static UINT getTypeSize(tPiDescType type_p)
+{
+    switch (type_p)
+    {
+        case kPiDescTypeInteger8:
+        case kPiDescTypeUnsigned8:
+            return 1;
+
+        case kPiDescTypeInteger16:
+        case kPiDescTypeUnsigned16:
+            return 2;
+
+        case kPiDescTypeInteger32:
+        case kPiDescTypeUnsigned32:
+        case kPiDescTypeReal32:
+            return 4;
+
+        case kPiDescTypeInteger64:
+        case kPiDescTypeUnsigned64:
+        case kPiDescTypeReal64:
+            return 8;
+
+        default:
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for a wide data type
+
+\param  type_p                  Data type of the channel.
+
+\return The function returns TRUE if the raw values of the type exceed the
+        precision of float and are scaled in double precision.
+*/
+//------------------------------------------------------------------------------
+static BOOL isWideType(tPiDescType type_p)
+{
+    switch (type_p)
+    {
+        case kPiDescTypeInteger32:
+        case kPiDescTypeUnsigned32:
+        case kPiDescTypeInteger64:
+        case kPiDescTypeUnsigned64:
+        case kPiDescTypeReal64:
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+/// \}
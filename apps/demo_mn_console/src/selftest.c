@@ -0,0 +1,277 @@
+/**
+********************************************************************************
+\file   selftest.c
+
+\brief  Platform latency self-test
+
+The file implements the platform latency self-test of the MN demo application.
+Before the network is brought up, a thread with the priority of the sync thread
+wakes up periodically with the configured cycle length and measures how late it
+is woken up. If the worst-case wake-up latency takes more than
+SELFTEST_LIMIT_PERCENT of the cycle, the platform can't be expected to finish
+the synchronous processing in time and the test fails.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "selftest.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Self-test instance
+
+The structure contains the parameters and the results of the self-test.
+*/
+typedef struct
+{
+    UINT64              periodNs;           ///< Wake-up period [ns]
+    UINT64              durationNs;         ///< Duration of the measurement [ns]
+    int                 ret;                ///< Result of the timer setup
+    UINT32              count;              ///< Number of wake-ups
+    UINT32              missedCount;        ///< Number of periods missed completely
+    UINT64              minLatency;         ///< Minimum wake-up latency [ns]
+    UINT64              maxLatency;         ///< Maximum wake-up latency [ns]
+    UINT64              sumLatency;         ///< Sum of all wake-up latencies [ns]
+    UINT32              aHist[SELFTEST_HIST_SIZE + 1];  ///< Latency histogram, 1 us buckets and overflow
+} tSelfTestInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tSelfTestInstance    selfTestInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void measureThread(void* pArg_p);
+static void printReport(UINT64 limitNs_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the platform latency self-test
+
+The function measures the wake-up latency of a thread with the priority of the
+sync thread for the given duration and compares the worst case with the cycle
+length. It blocks until the measurement is finished.
+
+\param  cycleLen_p              Cycle length [us].
+\param  duration_p              Duration of the measurement [s].
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The platform meets the latency limit or the
+                                test could not be executed.
+\retval kErrorReject            The worst-case wake-up latency exceeds the limit.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError selftest_run(UINT32 cycleLen_p, UINT duration_p)
+{
+    tSelfTestInstance*  pInstance = &selfTestInstance_l;
+    tSystemThread       thread;
+    UINT64              limitNs;
+
+    if (cycleLen_p == 0)
+    {
+        printf("Self-test skipped, the CDC does not contain the cycle length\n");
+        return kErrorOk;
+    }
+
+    memset(pInstance, 0, sizeof(tSelfTestInstance));
+    pInstance->periodNs = (UINT64)cycleLen_p * 1000;
+    pInstance->durationNs = (UINT64)duration_p * 1000000000;
+
+    printf("Running platform latency self-test for %u s with cycle length %lu us...\n",
+           duration_p, (ULONG)cycleLen_p);
+
+    // The main thread runs with low priority, so the measurement is executed
+    // by a thread created like the sync thread.
+    if (system_createThread(measureThread, pInstance, &thread) != 0)
+    {
+        printf("Self-test skipped, the measurement thread could not be created\n");
+        return kErrorOk;
+    }
+    system_joinThread(&thread);
+
+    if ((pInstance->ret != 0) || (pInstance->count == 0))
+    {
+        printf("Self-test skipped, the timer could not be created\n");
+        return kErrorOk;
+    }
+
+    limitNs = pInstance->periodNs * SELFTEST_LIMIT_PERCENT / 100;
+    printReport(limitNs);
+
+    return ((pInstance->maxLatency > limitNs) || (pInstance->missedCount != 0)) ?
+           kErrorReject : kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measurement thread
+
+The function wakes up periodically at absolute times and records the delay
+between the programmed and the actual wake-up. If a wake-up is so late that
+whole periods have passed, the missed periods are counted and the measurement
+continues with the next period in the future instead of catching up.
+
+\param  pArg_p                  Pointer to the self-test instance.
+*/
+//------------------------------------------------------------------------------
+static void measureThread(void* pArg_p)
+{
+    tSelfTestInstance*  pInstance = (tSelfTestInstance*)pArg_p;
+    tSystemTimer        timer;
+    UINT64              wakeTime;
+    UINT64              endTime;
+    UINT64              now;
+    UINT64              latency;
+    UINT64              bucket;
+    UINT64              missed;
+
+    pInstance->ret = system_openTimer(&timer);
+    if (pInstance->ret != 0)
+        return;
+
+    wakeTime = system_getTimeNs() + pInstance->periodNs;
+    endTime = wakeTime + pInstance->durationNs;
+
+    while (wakeTime < endTime)
+    {
+        system_waitTimer(&timer, wakeTime);
+        now = system_getTimeNs();
+        latency = (now > wakeTime) ? (now - wakeTime) : 0;
+
+        if ((pInstance->count == 0) || (latency < pInstance->minLatency))
+            pInstance->minLatency = latency;
+        if (latency > pInstance->maxLatency)
+            pInstance->maxLatency = latency;
+        pInstance->sumLatency += latency;
+        pInstance->count++;
+
+        bucket = latency / 1000;
+        if (bucket > SELFTEST_HIST_SIZE)
+            bucket = SELFTEST_HIST_SIZE;
+        pInstance->aHist[bucket]++;
+
+        missed = latency / pInstance->periodNs;
+        pInstance->missedCount += (UINT32)missed;
+        wakeTime += (missed + 1) * pInstance->periodNs;
+    }
+
+    system_closeTimer(&timer);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the self-test report
+
+\param  limitNs_p               Allowed worst-case wake-up latency [ns].
+*/
+//------------------------------------------------------------------------------
+static void printReport(UINT64 limitNs_p)
+{
+    tSelfTestInstance*  pInstance = &selfTestInstance_l;
+    UINT32              threshold;
+    UINT32              sum = 0;
+    UINT                i;
+
+    // 99.9 % of the wake-ups are within the bucket found here
+    threshold = pInstance->count - pInstance->count / 1000;
+    for (i = 0; i < SELFTEST_HIST_SIZE; i++)
+    {
+        sum += pInstance->aHist[i];
+        if (sum >= threshold)
+            break;
+    }
+
+    printf("Platform latency self-test: %lu wake-ups, %lu missed cycles\n",
+           (ULONG)pInstance->count, (ULONG)pInstance->missedCount);
+    printf("  Wake-up latency [us]: min %.1f avg %.1f max %.1f\n",
+           (double)pInstance->minLatency / 1000.0,
+           (double)pInstance->sumLatency / (double)pInstance->count / 1000.0,
+           (double)pInstance->maxLatency / 1000.0);
+    if (i < SELFTEST_HIST_SIZE)
+        printf("  99.9 %% of the wake-ups within %u us\n", i + 1);
+    else
+        printf("  99.9 %% of the wake-ups not within %u us\n", SELFTEST_HIST_SIZE);
+    printf("  Worst case takes %.1f %% of the cycle, limit %u %% (%.1f us): %s\n",
+           (double)pInstance->maxLatency * 100.0 / (double)pInstance->periodNs,
+           SELFTEST_LIMIT_PERCENT, (double)limitNs_p / 1000.0,
+           ((pInstance->maxLatency > limitNs_p) || (pInstance->missedCount != 0)) ?
+           "FAILED" : "passed");
+}
+
+/// \}
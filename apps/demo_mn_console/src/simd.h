@@ -0,0 +1,119 @@
+/**
+********************************************************************************
+\file   simd.h
+
+\brief  Definitions for the vector kernels
+
+The file contains a small set of single precision vector operations used by
+the cyclic processing stages of the MN demo application. The instruction set
+is selected by the compiler target: AVX, SSE (always available on x64), NEON
+or a scalar fallback with a vector width of one.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_simd_H_
+#define _INC_simd_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#if defined(__AVX__)
+
+typedef __m256 tSimdVec;
+
+#define SIMD_NAME               "AVX"
+#define SIMD_WIDTH              8
+#define SIMD_LOAD(p)            _mm256_loadu_ps(p)
+#define SIMD_STORE(p, v)        _mm256_storeu_ps(p, v)
+#define SIMD_SET1(x)            _mm256_set1_ps(x)
+#define SIMD_ADD(a, b)          _mm256_add_ps(a, b)
+#define SIMD_SUB(a, b)          _mm256_sub_ps(a, b)
+#define SIMD_MUL(a, b)          _mm256_mul_ps(a, b)
+#define SIMD_MIN(a, b)          _mm256_min_ps(a, b)
+#define SIMD_MAX(a, b)          _mm256_max_ps(a, b)
+
+#elif defined(_M_X64) || defined(__SSE__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+
+typedef __m128 tSimdVec;
+
+#define SIMD_NAME               "SSE"
+#define SIMD_WIDTH              4
+#define SIMD_LOAD(p)            _mm_loadu_ps(p)
+#define SIMD_STORE(p, v)        _mm_storeu_ps(p, v)
+#define SIMD_SET1(x)            _mm_set1_ps(x)
+#define SIMD_ADD(a, b)          _mm_add_ps(a, b)
+#define SIMD_SUB(a, b)          _mm_sub_ps(a, b)
+#define SIMD_MUL(a, b)          _mm_mul_ps(a, b)
+#define SIMD_MIN(a, b)          _mm_min_ps(a, b)
+#define SIMD_MAX(a, b)          _mm_max_ps(a, b)
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+typedef float32x4_t tSimdVec;
+
+#define SIMD_NAME               "NEON"
+#define SIMD_WIDTH              4
+#define SIMD_LOAD(p)            vld1q_f32(p)
+#define SIMD_STORE(p, v)        vst1q_f32(p, v)
+#define SIMD_SET1(x)            vdupq_n_f32(x)
+#define SIMD_ADD(a, b)          vaddq_f32(a, b)
+#define SIMD_SUB(a, b)          vsubq_f32(a, b)
+#define SIMD_MUL(a, b)          vmulq_f32(a, b)
+#define SIMD_MIN(a, b)          vminq_f32(a, b)
+#define SIMD_MAX(a, b)          vmaxq_f32(a, b)
+
+#else
+
+typedef float tSimdVec;
+
+#define SIMD_NAME               "scalar"
+#define SIMD_WIDTH              1
+#define SIMD_LOAD(p)            (*(p))
+#define SIMD_STORE(p, v)        (*(p) = (v))
+#define SIMD_SET1(x)            (x)
+#define SIMD_ADD(a, b)          ((a) + (b))
+#define SIMD_SUB(a, b)          ((a) - (b))
+#define SIMD_MUL(a, b)          ((a) * (b))
+#define SIMD_MIN(a, b)          (((a) < (b)) ? (a) : (b))
+#define SIMD_MAX(a, b)          (((a) > (b)) ? (a) : (b))
+
+#endif
+
+#endif /* _INC_simd_H_ */
@@ -0,0 +1,740 @@
+/**
+********************************************************************************
+\file   standby.c
+
+\brief  Hot-standby module of the MN demo application
+
+This file contains the hot-standby module of the MN demo application.
+
+The primary MN replicates its application state (node table, last process
+images, cycle count and configuration fingerprint) into a named shared memory
+region once per cycle. A second MN process started in standby mode maps the
+same region, keeps a consistent copy of the replicated state and takes over
+when the heartbeat of the primary stops.
+
+The replication channel is lock-free: the primary is the only writer and
+protects the state with a sequence counter (odd while a write is in
+progress). The standby retries its copy if the sequence counter changed
+during the read, so the primary is never blocked by the standby.
+
+The heartbeat of the primary is signaled by a thread of its own, but only
+while the primary makes progress: cycles are published and the main loop
+runs. While the network boots, no cycles are published. Every NMT state
+change of the MN grants a grace time for the boot, so a primary whose stack
+stops during the boot is detected as well. A standby only considers the
+heartbeat, so it takes over from a primary whose sync thread, stack or main
+loop hangs.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "standby.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STANDBY_SHM_NAME            "openPOWERLINK_MN_standby"
+#define STANDBY_CHANNEL_MAGIC       0x53424D4EUL        // "SBMN"
+#define STANDBY_CHANNEL_VERSION     1
+#define STANDBY_READ_RETRIES        8
+#define STANDBY_HEARTBEAT_PERIOD_MS (STANDBY_HEARTBEAT_TIMEOUT_MS / 5)
+#define STANDBY_MAIN_TIMEOUT_MS     1000                // max. time of a main loop iteration
+#define STANDBY_BOOT_TIMEOUT_MS     15000               // max. time between MN state changes without cycles
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Replication channel
+
+The structure describes the layout of the replication channel in the shared
+memory region.
+*/
+typedef struct
+{
+    UINT32              magic;              ///< Magic number identifying an initialized channel
+    UINT32              version;            ///< Layout version of the channel
+    volatile UINT32     sequence;           ///< Sequence counter protecting the state (odd = write in progress)
+    volatile UINT32     heartbeat;          ///< Heartbeat counter incremented while the primary makes progress
+    volatile UINT32     fPrimaryExited;     ///< Set by the primary on an orderly shutdown
+    tStandbyState       state;              ///< Replicated application state
+} tStandbyChannel;
+
+/**
+\brief  Replication statistics
+
+The structure contains the statistics of the replication.
+*/
+typedef struct
+{
+    UINT32              publishCount;       ///< Number of published cycles
+    UINT64              publishTimeSum;     ///< Sum of the publishing times [ns]
+    UINT64              publishTimeMin;     ///< Minimum publishing time [ns]
+    UINT64              publishTimeMax;     ///< Maximum publishing time [ns]
+    UINT32              readRetries;        ///< Number of retried standby reads
+    UINT64              detectionTime;      ///< Time from last heartbeat to takeover [ns]
+    UINT64              failoverTime;       ///< Time from last heartbeat to first cycle [ns]
+} tStandbyStatistics;
+
+/**
+\brief  Hot-standby module instance
+
+The structure contains the local variables of the hot-standby module.
+*/
+typedef struct
+{
+    tSystemSharedMem    shm;                ///< Shared memory holding the channel
+    tStandbyChannel*    pChannel;           ///< Replication channel
+    BOOL                fStandby;           ///< Waiting as standby for the primary to fail
+    BOOL                fPublish;           ///< Replicating the state as primary
+    BOOL                fTakenOver;         ///< This instance has taken over from a primary
+    BOOL                fStateValid;        ///< A consistent copy of the primary's state is available
+    BOOL                fPrimarySeen;       ///< A primary has been seen alive
+    BOOL                fFailoverMeasured;  ///< The failover time has been measured
+    BOOL                fHeartbeatRunning;  ///< The heartbeat thread is running
+    volatile BOOL       fHeartbeatExit;     ///< Request the heartbeat thread to exit
+    tSystemThread       heartbeatThread;    ///< Thread signaling the heartbeat of the primary
+    volatile UINT32     mainCount;          ///< Number of main loop iterations
+    volatile UINT32     stateCount;         ///< Number of NMT state changes of the MN
+    UINT32              cdcFingerprint;     ///< Fingerprint of the own configuration
+    UINT32              lastSequence;       ///< Last sequence counter seen by the standby
+    UINT32              lastHeartbeat;      ///< Last heartbeat counter seen by the standby
+    UINT64              lastAliveTime;      ///< Time the primary was last seen alive [ns]
+    volatile UINT16     aNodeState[STANDBY_NODE_COUNT]; ///< Local node table
+    tStandbyState       takeoverState;      ///< Last consistent copy of the primary's state
+    tStandbyStatistics  stats;              ///< Replication statistics
+} tStandbyInstance;
+
+/**
+\brief  Progress of the primary
+
+The structure contains the progress of the primary last seen by its
+heartbeat thread. It is only used by the heartbeat thread.
+*/
+typedef struct
+{
+    UINT32              sequence;           ///< Last sequence counter of the channel
+    UINT32              mainCount;          ///< Last main loop count
+    UINT32              stateCount;         ///< Last NMT state change count
+    BOOL                fMainSeen;          ///< The main loop has been entered
+    UINT64              cycleTime;          ///< Time of the last published cycle [ns]
+    UINT64              mainTime;           ///< Time of the last main loop iteration [ns]
+    UINT64              bootDeadline;       ///< End of the grace time for the boot [ns]
+} tStandbyProgress;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tStandbyInstance     standbyInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL readState(void);
+static BOOL startHeartbeat(void);
+static void signalHeartbeat(void* pArg_p);
+static BOOL checkProgress(tStandbyProgress* pProgress_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the hot-standby module
+
+The function opens the replication channel. If \p fStandby_p is TRUE, the
+instance waits as standby for the primary to fail (see standby_checkPrimary()),
+otherwise it replicates its state as primary.
+
+\param  fStandby_p              Run as standby MN.
+\param  cdcFingerprint_p        Fingerprint of the used configuration.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError standby_init(BOOL fStandby_p, UINT32 cdcFingerprint_p)
+{
+    tStandbyChannel*    pChannel;
+
+    memset(&standbyInstance_l, 0, sizeof(standbyInstance_l));
+    standbyInstance_l.stats.publishTimeMin = (UINT64)-1;
+
+    if (system_openSharedMem(STANDBY_SHM_NAME, sizeof(tStandbyChannel), &standbyInstance_l.shm) != 0)
+    {
+        fprintf(stderr, "Unable to open standby replication channel!\n");
+        return kErrorNoResource;
+    }
+
+    pChannel = (tStandbyChannel*)standbyInstance_l.shm.pBase;
+    if (pChannel->magic == 0)
+    {
+        pChannel->version = STANDBY_CHANNEL_VERSION;
+        system_memoryBarrier();
+        pChannel->magic = STANDBY_CHANNEL_MAGIC;
+    }
+    else if ((pChannel->magic != STANDBY_CHANNEL_MAGIC) ||
+             (pChannel->version != STANDBY_CHANNEL_VERSION))
+    {
+        fprintf(stderr, "Standby replication channel has an incompatible layout!\n");
+        system_closeSharedMem(&standbyInstance_l.shm);
+        return kErrorNoResource;
+    }
+
+    standbyInstance_l.pChannel = pChannel;
+    standbyInstance_l.cdcFingerprint = cdcFingerprint_p;
+    standbyInstance_l.fStandby = fStandby_p;
+    standbyInstance_l.fPublish = !fStandby_p;
+
+    if (standbyInstance_l.fPublish)
+    {
+        pChannel->fPrimaryExited = FALSE;
+        if (!startHeartbeat())
+        {
+            standbyInstance_l.pChannel = NULL;
+            system_closeSharedMem(&standbyInstance_l.shm);
+            return kErrorNoResource;
+        }
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shutdown the hot-standby module
+
+The function closes the replication channel. If the instance is the primary,
+it signals the orderly shutdown to a waiting standby, so the standby can take
+over without waiting for the heartbeat timeout.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_exit(void)
+{
+    if (standbyInstance_l.pChannel == NULL)
+        return;
+
+    if (standbyInstance_l.fHeartbeatRunning)
+    {
+        standbyInstance_l.fHeartbeatExit = TRUE;
+        system_joinThread(&standbyInstance_l.heartbeatThread);
+        standbyInstance_l.fHeartbeatRunning = FALSE;
+    }
+
+    if (standbyInstance_l.fPublish)
+        standbyInstance_l.pChannel->fPrimaryExited = TRUE;
+
+    standbyInstance_l.pChannel = NULL;
+    system_closeSharedMem(&standbyInstance_l.shm);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the primary MN
+
+The function is called periodically by a standby MN. It updates the local copy
+of the replicated state and checks the heartbeat of the primary. If the
+primary has stopped, the standby takes over and starts to replicate its own
+state.
+
+\return The function returns TRUE if the standby has taken over, otherwise
+        FALSE.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL standby_checkPrimary(void)
+{
+    tStandbyChannel*    pChannel = standbyInstance_l.pChannel;
+    UINT64              now;
+    UINT32              sequence;
+    UINT32              heartbeat;
+    BOOL                fAlive = FALSE;
+
+    if ((pChannel == NULL) || !standbyInstance_l.fStandby)
+        return TRUE;
+
+    now = system_getTimeNs();
+
+    sequence = pChannel->sequence;
+    heartbeat = pChannel->heartbeat;
+
+    // published cycles alone do not prove that the primary is healthy, only
+    // the heartbeat does
+    if (sequence != standbyInstance_l.lastSequence)
+        readState();
+
+    if (heartbeat != standbyInstance_l.lastHeartbeat)
+    {
+        standbyInstance_l.lastHeartbeat = heartbeat;
+        fAlive = TRUE;
+    }
+
+    if (fAlive)
+    {
+        if (!standbyInstance_l.fPrimarySeen)
+            printf("Standby: primary MN detected\n");
+
+        standbyInstance_l.fPrimarySeen = TRUE;
+        standbyInstance_l.lastAliveTime = now;
+        if (!pChannel->fPrimaryExited)
+            return FALSE;
+    }
+
+    if (!standbyInstance_l.fPrimarySeen)
+        return FALSE;
+
+    if (!pChannel->fPrimaryExited &&
+        ((now - standbyInstance_l.lastAliveTime) < (STANDBY_HEARTBEAT_TIMEOUT_MS * 1000000ULL)))
+        return FALSE;
+
+    // primary is gone -> take over
+    standbyInstance_l.stats.detectionTime = now - standbyInstance_l.lastAliveTime;
+    printf("Standby: primary MN %s, taking over (detection time %lu ms)\n",
+           (pChannel->fPrimaryExited ? "has shut down" : "is lost"),
+           (ULONG)(standbyInstance_l.stats.detectionTime / 1000000ULL));
+
+    if (standbyInstance_l.fStateValid &&
+        (standbyInstance_l.takeoverState.cdcFingerprint != standbyInstance_l.cdcFingerprint))
+    {
+        printf("Standby: configuration fingerprint mismatch (primary 0x%08lX, own 0x%08lX), "
+               "replicated state is discarded!\n",
+               (ULONG)standbyInstance_l.takeoverState.cdcFingerprint,
+               (ULONG)standbyInstance_l.cdcFingerprint);
+        standbyInstance_l.fStateValid = FALSE;
+    }
+
+    standbyInstance_l.fStandby = FALSE;
+    standbyInstance_l.fTakenOver = TRUE;
+    standbyInstance_l.fPublish = TRUE;
+    pChannel->fPrimaryExited = FALSE;
+
+    // a later standby must not take over from this instance while it boots
+    if (!startHeartbeat())
+        fprintf(stderr, "Standby: unable to start the heartbeat, a second standby may take over!\n");
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the NMT state of the MN
+
+The function is called by the application event handler for every NMT state
+change of the MN. A state change shows that the stack is alive and grants the
+primary a grace time for the boot of the network, during which no cycles are
+published.
+
+\param  nmtState_p              New NMT state of the MN.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_processNmtState(tNmtState nmtState_p)
+{
+    UNUSED_PARAMETER(nmtState_p);
+
+    standbyInstance_l.stateCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the hot-standby module
+
+The function is called periodically by the main loop. It signals the progress
+of the main loop to the heartbeat thread, so the heartbeat stops if the main
+loop hangs.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_process(void)
+{
+    standbyInstance_l.mainCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the state replicated from the primary
+
+The function returns the last consistent state replicated from the primary MN
+before the takeover.
+
+\return The function returns a pointer to the replicated state or NULL if no
+        valid state is available.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+const tStandbyState* standby_getTakeoverState(void)
+{
+    if (!standbyInstance_l.fTakenOver || !standbyInstance_l.fStateValid)
+        return NULL;
+
+    return &standbyInstance_l.takeoverState;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the node table
+
+The function stores the NMT state of a CN in the node table which is
+replicated with the next cycle.
+
+\param  nodeId_p                Node ID of the CN.
+\param  nmtState_p              New NMT state of the CN.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_setNodeState(UINT nodeId_p, tNmtState nmtState_p)
+{
+    if ((nodeId_p == 0) || (nodeId_p > STANDBY_NODE_COUNT))
+        return;
+
+    standbyInstance_l.aNodeState[nodeId_p - 1] = (UINT16)nmtState_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Publish the application state
+
+The function is called by the primary MN once per cycle from the synchronous
+task. It writes the application state into the replication channel and
+measures the replication overhead.
+
+\param  cycleCount_p            Cycle count of the application.
+\param  pPiIn_p                 Pointer to the input process image.
+\param  piInSize_p              Size of the input process image.
+\param  pPiOut_p                Pointer to the output process image.
+\param  piOutSize_p             Size of the output process image.
+\param  pAppData_p              Pointer to application specific data.
+\param  appDataSize_p           Size of the application specific data.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_publish(UINT32 cycleCount_p,
+                     const void* pPiIn_p, UINT piInSize_p,
+                     const void* pPiOut_p, UINT piOutSize_p,
+                     const void* pAppData_p, UINT appDataSize_p)
+{
+    tStandbyChannel*    pChannel = standbyInstance_l.pChannel;
+    tStandbyState*      pState;
+    tStandbyStatistics* pStats = &standbyInstance_l.stats;
+    UINT64              startTime;
+    UINT64              duration;
+    UINT32              sequence;
+
+    if ((pChannel == NULL) || !standbyInstance_l.fPublish)
+        return;
+
+    startTime = system_getTimeNs();
+    pState = &pChannel->state;
+
+    if (piInSize_p > STANDBY_PI_SIZE_MAX)
+        piInSize_p = 0;
+    if (piOutSize_p > STANDBY_PI_SIZE_MAX)
+        piOutSize_p = 0;
+    if (appDataSize_p > STANDBY_APPDATA_SIZE_MAX)
+        appDataSize_p = 0;
+
+    // mark write in progress
+    sequence = pChannel->sequence;
+    pChannel->sequence = sequence + 1;
+    system_memoryBarrier();
+
+    pState->cycleCount = cycleCount_p;
+    pState->cdcFingerprint = standbyInstance_l.cdcFingerprint;
+    memcpy(pState->aNodeState, (const void*)standbyInstance_l.aNodeState, sizeof(pState->aNodeState));
+    pState->piInSize = piInSize_p;
+    pState->piOutSize = piOutSize_p;
+    pState->appDataSize = appDataSize_p;
+    memcpy(pState->aPiIn, pPiIn_p, piInSize_p);
+    memcpy(pState->aPiOut, pPiOut_p, piOutSize_p);
+    memcpy(pState->aAppData, pAppData_p, appDataSize_p);
+
+    // mark write completed
+    system_memoryBarrier();
+    pChannel->sequence = sequence + 2;
+
+    duration = system_getTimeNs() - startTime;
+
+    if (standbyInstance_l.fTakenOver && !standbyInstance_l.fFailoverMeasured)
+    {
+        pStats->failoverTime = startTime - standbyInstance_l.lastAliveTime;
+        standbyInstance_l.fFailoverMeasured = TRUE;
+    }
+
+    pStats->publishCount++;
+    pStats->publishTimeSum += duration;
+    if (duration < pStats->publishTimeMin)
+        pStats->publishTimeMin = duration;
+    if (duration > pStats->publishTimeMax)
+        pStats->publishTimeMax = duration;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print replication statistics
+
+The function prints the replication overhead per cycle and, if this instance
+has taken over from a primary, the measured failover time.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void standby_printStatistics(void)
+{
+    tStandbyStatistics* pStats = &standbyInstance_l.stats;
+
+    if (standbyInstance_l.pChannel == NULL)
+        return;
+
+    printf("Standby replication statistics:\n");
+    if (pStats->publishCount != 0)
+    {
+        printf("  Replicated cycles:    %lu\n", (ULONG)pStats->publishCount);
+        printf("  Overhead per cycle:   min %lu ns, avg %lu ns, max %lu ns\n",
+               (ULONG)pStats->publishTimeMin,
+               (ULONG)(pStats->publishTimeSum / pStats->publishCount),
+               (ULONG)pStats->publishTimeMax);
+    }
+    else
+    {
+        printf("  No cycles replicated\n");
+    }
+
+    if (standbyInstance_l.fTakenOver)
+    {
+        printf("  Standby reads retried: %lu\n", (ULONG)pStats->readRetries);
+        printf("  Detection time:       %lu us\n", (ULONG)(pStats->detectionTime / 1000));
+        if (standbyInstance_l.fFailoverMeasured)
+            printf("  Failover time:        %lu us (last primary heartbeat to first cycle)\n",
+                   (ULONG)(pStats->failoverTime / 1000));
+        else
+            printf("  Failover time:        no cycle after takeover\n");
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the replicated state
+
+The function copies the replicated state from the channel into the local
+takeover state. The copy is retried if the primary modified the state during
+the read.
+
+\return The function returns TRUE if a consistent copy was read, otherwise
+        FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL readState(void)
+{
+    tStandbyChannel*    pChannel = standbyInstance_l.pChannel;
+    UINT32              seqStart;
+    UINT32              seqEnd;
+    int                 retry;
+
+    for (retry = 0; retry < STANDBY_READ_RETRIES; retry++)
+    {
+        seqStart = pChannel->sequence;
+        if ((seqStart & 1) != 0)
+        {
+            standbyInstance_l.stats.readRetries++;
+            continue;
+        }
+
+        system_memoryBarrier();
+        memcpy(&standbyInstance_l.takeoverState, (const void*)&pChannel->state,
+               sizeof(standbyInstance_l.takeoverState));
+        system_memoryBarrier();
+
+        seqEnd = pChannel->sequence;
+        if (seqStart == seqEnd)
+        {
+            standbyInstance_l.lastSequence = seqEnd;
+            standbyInstance_l.fStateValid = TRUE;
+            return TRUE;
+        }
+
+        standbyInstance_l.stats.readRetries++;
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start the heartbeat thread
+
+The function starts the thread signaling the heartbeat of the primary.
+
+\return The function returns TRUE if the thread is running, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL startHeartbeat(void)
+{
+    standbyInstance_l.fHeartbeatExit = FALSE;
+    if (system_createThread(signalHeartbeat, NULL, &standbyInstance_l.heartbeatThread) != 0)
+    {
+        fprintf(stderr, "Unable to start the standby heartbeat thread!\n");
+        return FALSE;
+    }
+
+    standbyInstance_l.fHeartbeatRunning = TRUE;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Heartbeat thread
+
+The thread increments the heartbeat counter of the primary well within the
+heartbeat timeout until standby_exit() stops it. The counter is only
+incremented while the primary makes progress (see checkProgress()). The boot
+grace time starts with the thread, so the primary may initialize the stack
+and tune the cycle length before the first state change.
+
+\param  pArg_p                  Unused.
+*/
+//------------------------------------------------------------------------------
+static void signalHeartbeat(void* pArg_p)
+{
+    tStandbyProgress    progress;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    memset(&progress, 0, sizeof(progress));
+    progress.sequence = standbyInstance_l.pChannel->sequence;
+    progress.mainCount = standbyInstance_l.mainCount;
+    progress.stateCount = standbyInstance_l.stateCount;
+    progress.cycleTime = system_getTimeNs();
+    progress.bootDeadline = progress.cycleTime + (STANDBY_BOOT_TIMEOUT_MS * 1000000ULL);
+
+    while (!standbyInstance_l.fHeartbeatExit)
+    {
+        if (checkProgress(&progress))
+            standbyInstance_l.pChannel->heartbeat++;
+        system_msleep(STANDBY_HEARTBEAT_PERIOD_MS);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the progress of the primary
+
+The function checks whether the primary makes progress. The cyclic path must
+have published a cycle within the heartbeat timeout, unless the network boots,
+i.e. the MN has changed its NMT state within the boot timeout. Once the main
+loop has been entered, it must have run within the main loop timeout.
+
+\param  pProgress_p             Pointer to the progress last seen.
+
+\return The function returns TRUE if the primary makes progress.
+*/
+//------------------------------------------------------------------------------
+static BOOL checkProgress(tStandbyProgress* pProgress_p)
+{
+    UINT64              now = system_getTimeNs();
+    UINT32              count;
+    BOOL                fCycleAlive;
+    BOOL                fMainAlive;
+
+    count = standbyInstance_l.pChannel->sequence;
+    if (count != pProgress_p->sequence)
+    {
+        pProgress_p->sequence = count;
+        pProgress_p->cycleTime = now;
+    }
+
+    count = standbyInstance_l.stateCount;
+    if (count != pProgress_p->stateCount)
+    {
+        pProgress_p->stateCount = count;
+        pProgress_p->bootDeadline = now + (STANDBY_BOOT_TIMEOUT_MS * 1000000ULL);
+    }
+
+    count = standbyInstance_l.mainCount;
+    if (count != pProgress_p->mainCount)
+    {
+        pProgress_p->mainCount = count;
+        pProgress_p->mainTime = now;
+        pProgress_p->fMainSeen = TRUE;
+    }
+
+    fCycleAlive = ((now - pProgress_p->cycleTime) < (STANDBY_HEARTBEAT_TIMEOUT_MS * 1000000ULL)) ||
+                  (now < pProgress_p->bootDeadline);
+    fMainAlive = !pProgress_p->fMainSeen ||
+                 ((now - pProgress_p->mainTime) < (STANDBY_MAIN_TIMEOUT_MS * 1000000ULL));
+
+    return fCycleAlive && fMainAlive;
+}
+
+/// \}
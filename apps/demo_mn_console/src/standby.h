@@ -0,0 +1,102 @@
+/**
+********************************************************************************
+\file   standby.h
+
+\brief  Definitions for the hot-standby module
+
+The file contains the definitions for the hot-standby module of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_standby_H_
+#define _INC_standby_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STANDBY_PI_SIZE_MAX             4096    ///< Max. size of a replicated process image
+#define STANDBY_APPDATA_SIZE_MAX        4096    ///< Max. size of the replicated application data
+#define STANDBY_NODE_COUNT              254     ///< Number of entries in the node table
+#define STANDBY_HEARTBEAT_TIMEOUT_MS    250     ///< Primary is considered lost after this time
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Replicated application state
+
+The structure contains the application state which is replicated from the
+primary MN to the standby MN.
+*/
+typedef struct
+{
+    UINT32          cycleCount;                             ///< Cycle count of the application
+    UINT32          cdcFingerprint;                         ///< Fingerprint of the used configuration
+    UINT16          aNodeState[STANDBY_NODE_COUNT];         ///< NMT state of the CNs (index = node ID - 1)
+    UINT32          piInSize;                               ///< Size of the input process image
+    UINT32          piOutSize;                              ///< Size of the output process image
+    UINT32          appDataSize;                            ///< Size of the application data
+    BYTE            aPiIn[STANDBY_PI_SIZE_MAX];             ///< Last input process image (outputs to CNs)
+    BYTE            aPiOut[STANDBY_PI_SIZE_MAX];            ///< Last output process image (inputs from CNs)
+    BYTE            aAppData[STANDBY_APPDATA_SIZE_MAX];     ///< Application specific data
+} tStandbyState;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError           standby_init(BOOL fStandby_p, UINT32 cdcFingerprint_p);
+void                 standby_exit(void);
+BOOL                 standby_checkPrimary(void);
+void                 standby_processNmtState(tNmtState nmtState_p);
+void                 standby_process(void);
+const tStandbyState* standby_getTakeoverState(void);
+void                 standby_setNodeState(UINT nodeId_p, tNmtState nmtState_p);
+void                 standby_publish(UINT32 cycleCount_p,
+                                     const void* pPiIn_p, UINT piInSize_p,
+                                     const void* pPiOut_p, UINT piOutSize_p,
+                                     const void* pAppData_p, UINT appDataSize_p);
+void                 standby_printStatistics(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_standby_H_ */
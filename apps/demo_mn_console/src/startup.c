@@ -0,0 +1,400 @@
+/**
+********************************************************************************
+\file   startup.c
+
+\brief  Startup profiler of the MN demo application
+
+This file contains the startup profiler of the MN demo application.
+
+The profiler records the start and end time of the individual startup phases
+and the time until the first POWERLINK cycle has been processed by the
+application. In the fast-start mode, independent phases are executed in
+parallel. The report shows how much of the startup time is saved by that.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "startup.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STARTUP_PAGE_SIZE       4096        // granularity used for prefaulting memory
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Startup phase record
+
+The structure contains the time stamps of a startup phase.
+*/
+typedef struct
+{
+    UINT64              beginTime;          ///< Start of the phase [ns]
+    UINT64              endTime;            ///< End of the phase [ns] (0 = not finished)
+} tStartupPhaseRecord;
+
+/**
+\brief  Startup profiler instance
+
+The structure contains the local variables of the startup profiler.
+*/
+typedef struct
+{
+    BOOL                fFastStart;                     ///< Fast-start mode is enabled
+    UINT64              startTime;                      ///< Start of the application [ns]
+    tStartupPhaseRecord aPhase[kStartupPhaseCount];     ///< Time stamps of the phases
+    UINT64              firstCycleTime;                 ///< First cycle processed [ns]
+    UINT64              operationalTime;                ///< MN reached operational [ns]
+    volatile BOOL       fFirstCycle;                    ///< First cycle has been processed
+    volatile BOOL       fOperational;                   ///< MN has reached operational
+    BOOL                fReported;                      ///< Report after first cycle is printed
+} tStartupInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tStartupInstance     startupInstance_l;
+
+static const char*          aPhaseName_l[kStartupPhaseCount] =
+{
+    "System",
+    "CDC",
+    "Error history",
+    "Self-test",
+    "Standby wait",
+    "Stack",
+    "Application",
+    "Prefault",
+    "Threads",
+    "Boot"
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT64 getPhaseDuration(tStartupPhase phase_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the startup profiler
+
+The function initializes the startup profiler. It must be called as early as
+possible, because the startup time is measured from this call.
+
+\param  fFastStart_p            Determines whether the fast-start mode is used.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_init(BOOL fFastStart_p)
+{
+    memset(&startupInstance_l, 0, sizeof(startupInstance_l));
+    startupInstance_l.fFastStart = fFastStart_p;
+    startupInstance_l.startTime = system_getTimeNs();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Determine whether fast-start mode is used
+
+\return The function returns TRUE if the fast-start mode is used.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL startup_isFastStart(void)
+{
+    return startupInstance_l.fFastStart;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Begin a startup phase
+
+The function records the start of a startup phase. Different phases may be
+recorded by different threads.
+
+\param  phase_p                 Startup phase
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_beginPhase(tStartupPhase phase_p)
+{
+    startupInstance_l.aPhase[phase_p].beginTime = system_getTimeNs();
+    startupInstance_l.aPhase[phase_p].endTime = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  End a startup phase
+
+The function records the end of a startup phase.
+
+\param  phase_p                 Startup phase
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_endPhase(tStartupPhase phase_p)
+{
+    startupInstance_l.aPhase[phase_p].endTime = system_getTimeNs();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a processed cycle
+
+The function is called by the synchronous task after a cycle has been
+processed. Only the first call is recorded, further calls return immediately.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_signalCycle(void)
+{
+    if (startupInstance_l.fFirstCycle)
+        return;
+
+    startupInstance_l.firstCycleTime = system_getTimeNs();
+    if (startupInstance_l.aPhase[kStartupPhaseBoot].beginTime != 0)
+        startupInstance_l.aPhase[kStartupPhaseBoot].endTime = startupInstance_l.firstCycleTime;
+
+    system_memoryBarrier();
+    startupInstance_l.fFirstCycle = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal that the MN is operational
+
+The function is called when the MN has reached the state operational. Only
+the first call is recorded.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_signalOperational(void)
+{
+    if (startupInstance_l.fOperational)
+        return;
+
+    startupInstance_l.operationalTime = system_getTimeNs();
+    system_memoryBarrier();
+    startupInstance_l.fOperational = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the startup profiler
+
+The function is called periodically by the main loop. It prints the startup
+report once the first cycle has been processed.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_process(void)
+{
+    if (startupInstance_l.fReported || !startupInstance_l.fFirstCycle)
+        return;
+
+    system_memoryBarrier();
+    startupInstance_l.fReported = TRUE;
+    startup_printReport();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Prefault memory
+
+The function touches every page of the given memory region, so the page
+faults occur during the startup instead of the first cycles.
+
+\param  pMem_p                  Start of the memory region
+\param  size_p                  Size of the memory region in bytes
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_prefault(void* pMem_p, size_t size_p)
+{
+    volatile BYTE*  pByte = (volatile BYTE*)pMem_p;
+    size_t          offset;
+
+    if ((pMem_p == NULL) || (size_p == 0))
+        return;
+
+    // write the current value back, so copy-on-write pages are resolved too
+    for (offset = 0; offset < size_p; offset += STARTUP_PAGE_SIZE)
+        pByte[offset] = pByte[offset];
+
+    pByte[size_p - 1] = pByte[size_p - 1];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the startup report
+
+The function prints the start time and the duration of all recorded phases,
+the time to the first cycle and the time until the MN was operational.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void startup_printReport(void)
+{
+    tStartupPhaseRecord*    pPhase;
+    UINT64                  sum = 0;
+    UINT64                  elapsed;
+    UINT64                  standbyWait;
+    UINT64                  selfTest;
+    int                     i;
+
+    printf("Startup profile (%s):\n",
+           startupInstance_l.fFastStart ? "fast-start mode" : "sequential mode");
+    printf("  %-14s %12s %14s\n", "Phase", "Start [ms]", "Duration [ms]");
+
+    for (i = 0; i < kStartupPhaseCount; i++)
+    {
+        pPhase = &startupInstance_l.aPhase[i];
+        if (pPhase->beginTime == 0)
+            continue;
+
+        if (pPhase->endTime == 0)
+        {
+            printf("  %-14s %12.3f %14s\n", aPhaseName_l[i],
+                   (double)(pPhase->beginTime - startupInstance_l.startTime) / 1000000.0,
+                   "running");
+            continue;
+        }
+
+        printf("  %-14s %12.3f %14.3f\n", aPhaseName_l[i],
+               (double)(pPhase->beginTime - startupInstance_l.startTime) / 1000000.0,
+               (double)(pPhase->endTime - pPhase->beginTime) / 1000000.0);
+
+        // waiting phases don't contribute to the startup time
+        if ((i != kStartupPhaseStandby) && (i != kStartupPhaseSelfTest))
+            sum += pPhase->endTime - pPhase->beginTime;
+    }
+
+    if (!startupInstance_l.fFirstCycle)
+    {
+        printf("  First cycle not yet reached\n");
+        return;
+    }
+
+    standbyWait = getPhaseDuration(kStartupPhaseStandby);
+    selfTest = getPhaseDuration(kStartupPhaseSelfTest);
+    elapsed = startupInstance_l.firstCycleTime - startupInstance_l.startTime - standbyWait - selfTest;
+
+    printf("  Time to first cycle: %.3f ms", (double)elapsed / 1000000.0);
+    if (standbyWait != 0)
+        printf(" (excluding %.3f ms standby wait)", (double)standbyWait / 1000000.0);
+    if (selfTest != 0)
+        printf(" (excluding %.3f ms self-test)", (double)selfTest / 1000000.0);
+    printf("\n");
+
+    if (sum > elapsed)
+    {
+        printf("  Sum of phases: %.3f ms, %.3f ms saved by parallel initialization\n",
+               (double)sum / 1000000.0, (double)(sum - elapsed) / 1000000.0);
+    }
+
+    if (startupInstance_l.fOperational)
+    {
+        printf("  Time to operational: %.3f ms\n",
+               (double)(startupInstance_l.operationalTime - startupInstance_l.startTime -
+                        standbyWait - selfTest) / 1000000.0);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the duration of a startup phase
+
+\param  phase_p                 Startup phase
+
+\return The function returns the duration of the phase in ns or 0 if the phase
+        has not been finished.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getPhaseDuration(tStartupPhase phase_p)
+{
+    tStartupPhaseRecord*    pPhase = &startupInstance_l.aPhase[phase_p];
+
+    if ((pPhase->beginTime == 0) || (pPhase->endTime == 0))
+        return 0;
+
+    return pPhase->endTime - pPhase->beginTime;
+}
+
+/// \}
@@ -0,0 +1,97 @@
+/**
+********************************************************************************
+\file   startup.h
+
+\brief  Definitions for the startup profiler
+
+The file contains the definitions for the startup profiler of the MN demo
+application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_startup_H_
+#define _INC_startup_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Startup phases
+
+The enumeration lists the phases measured by the startup profiler. In the
+fast-start mode, some of the phases are executed in parallel.
+*/
+typedef enum
+{
+    kStartupPhaseSystem = 0,        ///< System initialization
+    kStartupPhaseCdc,               ///< CDC loading, validation and staging
+    kStartupPhaseLog,               ///< Error history setup
+    kStartupPhaseSelfTest,          ///< Platform latency self-test
+    kStartupPhaseStandby,           ///< Waiting for the takeover as standby MN
+    kStartupPhaseStack,             ///< Stack initialization and creation
+    kStartupPhaseApp,               ///< Process image allocation and setup
+    kStartupPhasePrefault,          ///< Prefaulting of the process image buffers
+    kStartupPhaseThreads,           ///< Creation of the application threads
+    kStartupPhaseBoot,              ///< NMT reset until the first cycle
+    kStartupPhaseCount
+} tStartupPhase;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void startup_init(BOOL fFastStart_p);
+BOOL startup_isFastStart(void);
+void startup_beginPhase(tStartupPhase phase_p);
+void startup_endPhase(tStartupPhase phase_p);
+void startup_signalCycle(void);
+void startup_signalOperational(void);
+void startup_process(void);
+void startup_prefault(void* pMem_p, size_t size_p);
+void startup_printReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_startup_H_ */
@@ -0,0 +1,368 @@
+/**
+********************************************************************************
+\file   threadstat.c
+
+\brief  Thread statistics module of the MN demo application
+
+This file contains the thread statistics module of the MN demo application.
+
+Every application thread announces itself with its role on each activation
+(e.g. once per cycle for the synchronous data handler). The first activation
+registers the thread; later activations count the wake-ups and detect
+migrations to another CPU. The main loop periodically samples the CPU time and
+the context switches of all registered threads and derives the load and the
+switches per activation of the last interval. A synchronous data handler which
+is switched out more often than expected or migrates between CPUs is reported,
+as it is disturbed by other work on its CPU.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "threadstat.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Thread statistics record
+
+The structure contains the statistics of the thread running a role. The
+activation counters are written by the thread itself, all other members by
+the main loop.
+*/
+typedef struct
+{
+    tSystemThreadRef    ref;                    ///< Reference of the thread
+    volatile BOOL       fRegistered;            ///< The thread has registered
+    int                 lastCpu;                ///< CPU of the last activation (-1 = unknown)
+    volatile UINT32     activationCount;        ///< Number of activations
+    volatile UINT32     migrationCount;         ///< Number of activations on another CPU than the previous one
+    BOOL                fSampled;               ///< A previous sample is available
+    tSystemThreadStats  lastStats;              ///< Statistics of the previous sample
+    UINT32              lastActivations;        ///< Activations at the previous sample
+    UINT32              lastMigrations;         ///< Migrations at the previous sample
+    UINT                load;                   ///< CPU load in the last interval [0.1 %]
+    UINT                maxLoad;                ///< Maximum CPU load of an interval [0.1 %]
+    UINT32              switchRate;             ///< Context switches per second in the last interval
+    UINT                switchesPerAct;         ///< Context switches per activation in the last interval [0.1]
+    BOOL                fDisturbed;             ///< The last interval was disturbed
+    UINT32              disturbedCount;         ///< Number of disturbed intervals
+} tThreadStatRecord;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tThreadStatRecord    aRecord_l[kThreadStatRoleCount];
+static UINT64               lastSampleTime_l = 0;
+
+static const char*          apRoleName_l[kThreadStatRoleCount] =
+{
+    "main", "sync", "event", "historian", "param"
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void sampleThreads(UINT64 intervalNs_p);
+static void evaluateRecord(tThreadStatRole role_p, tThreadStatRecord* pRecord_p,
+                           const tSystemThreadStats* pStats_p, UINT64 intervalNs_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Announce the activation of a thread
+
+The function is called by a thread each time it wakes up to do the work of its
+role. The first call registers the calling thread for the role; calls from
+other threads are ignored afterwards. The function does not block and may be
+called from the synchronous data handler.
+
+\param[in]      role_p              Role of the calling thread.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void threadstat_enter(tThreadStatRole role_p)
+{
+    tThreadStatRecord*  pRecord = &aRecord_l[role_p];
+    int                 cpu;
+
+    if (!pRecord->fRegistered)
+    {
+        // a failed reference only yields zero CPU statistics, the activation
+        // counters still work
+        system_openThreadRef(&pRecord->ref);
+        pRecord->lastCpu = -1;
+        system_memoryBarrier();
+        pRecord->fRegistered = TRUE;
+    }
+    else if (pRecord->ref.threadId != system_getCurrentThreadId())
+    {
+        return;
+    }
+
+    pRecord->activationCount++;
+    cpu = system_getCurrentCpu();
+    if ((pRecord->lastCpu >= 0) && (cpu != pRecord->lastCpu))
+        pRecord->migrationCount++;
+    pRecord->lastCpu = cpu;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the thread statistics
+
+The function is called periodically by the main loop. Once per collection
+interval it samples the statistics of all registered threads.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void threadstat_process(void)
+{
+    UINT64  now = system_getTimeNs();
+
+    if (lastSampleTime_l == 0)
+    {
+        lastSampleTime_l = now;
+        return;
+    }
+
+    if ((now - lastSampleTime_l) < (THREADSTAT_INTERVAL * 1000000ULL))
+        return;
+
+    sampleThreads(now - lastSampleTime_l);
+    lastSampleTime_l = now;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the thread statistics
+
+The function prints the CPU and scheduling statistics of all registered
+threads. The load and rate columns refer to the last collection interval.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void threadstat_printStatistics(void)
+{
+    UINT                    i;
+    tThreadStatRecord*      pRecord;
+    BOOL                    fHeader = FALSE;
+
+    for (i = 0; i < kThreadStatRoleCount; i++)
+    {
+        pRecord = &aRecord_l[i];
+        if (!pRecord->fRegistered || !pRecord->fSampled)
+            continue;
+
+        if (!fHeader)
+        {
+            printf("Thread statistics:\n");
+            printf("  Role       Thread    CPU[ms]  Kern[%%]  Load[%%]  Max[%%]  Mcycles  Switches   Sw/s  Sw/act  Migr  Dist\n");
+            fHeader = TRUE;
+        }
+
+        printf("  %-9s  %6lu  %9lu  %7u  %3u.%01u  %3u.%01u  %7lu  %8lu  %5lu  %3u.%01u  %4lu  %4lu\n",
+               apRoleName_l[i], (ULONG)pRecord->ref.threadId,
+               (ULONG)(pRecord->lastStats.cpuTimeNs / 1000000ULL),
+               (pRecord->lastStats.cpuTimeNs != 0) ?
+                   (UINT)((pRecord->lastStats.kernelTimeNs * 100ULL) / pRecord->lastStats.cpuTimeNs) : 0,
+               pRecord->load / 10, pRecord->load % 10,
+               pRecord->maxLoad / 10, pRecord->maxLoad % 10,
+               (ULONG)(pRecord->lastStats.cycleCount / 1000000ULL),
+               (ULONG)pRecord->lastStats.switchCount, (ULONG)pRecord->switchRate,
+               pRecord->switchesPerAct / 10, pRecord->switchesPerAct % 10,
+               (ULONG)pRecord->lastMigrations, (ULONG)pRecord->disturbedCount);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shutdown the thread statistics module
+
+The function releases the references of all registered threads. It must be
+called after the threads have stopped.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void threadstat_exit(void)
+{
+    UINT    i;
+
+    for (i = 0; i < kThreadStatRoleCount; i++)
+    {
+        if (aRecord_l[i].fRegistered)
+            system_closeThreadRef(&aRecord_l[i].ref);
+    }
+
+    memset(aRecord_l, 0, sizeof(aRecord_l));
+    lastSampleTime_l = 0;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Sample the statistics of all registered threads
+
+\param[in]      intervalNs_p        Time since the previous sample [ns].
+*/
+//------------------------------------------------------------------------------
+static void sampleThreads(UINT64 intervalNs_p)
+{
+    tSystemThreadRef    aRef[kThreadStatRoleCount];
+    tSystemThreadStats  aStats[kThreadStatRoleCount];
+    tThreadStatRole     aRole[kThreadStatRoleCount];
+    UINT                count = 0;
+    UINT                i;
+
+    for (i = 0; i < kThreadStatRoleCount; i++)
+    {
+        if (!aRecord_l[i].fRegistered)
+            continue;
+
+        system_memoryBarrier();
+        aRef[count] = aRecord_l[i].ref;
+        aRole[count] = (tThreadStatRole)i;
+        count++;
+    }
+
+    if ((count == 0) || (system_getThreadStats(aRef, count, aStats) != 0))
+        return;
+
+    for (i = 0; i < count; i++)
+        evaluateRecord(aRole[i], &aRecord_l[aRole[i]], &aStats[i], intervalNs_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate a sample of a thread
+
+The function derives the interval values of a thread from its current and its
+previous sample and reports a disturbed synchronous data handler.
+
+\param[in]      role_p              Role of the thread.
+\param[in,out]  pRecord_p           Statistics record of the thread.
+\param[in]      pStats_p            Current statistics of the thread.
+\param[in]      intervalNs_p        Time since the previous sample [ns].
+*/
+//------------------------------------------------------------------------------
+static void evaluateRecord(tThreadStatRole role_p, tThreadStatRecord* pRecord_p,
+                           const tSystemThreadStats* pStats_p, UINT64 intervalNs_p)
+{
+    UINT32  activations = pRecord_p->activationCount;
+    UINT32  migrations = pRecord_p->migrationCount;
+    UINT32  deltaActivations;
+    UINT32  deltaMigrations;
+    UINT64  deltaSwitches;
+    BOOL    fDisturbed;
+
+    if (pRecord_p->fSampled)
+    {
+        deltaActivations = activations - pRecord_p->lastActivations;
+        deltaMigrations = migrations - pRecord_p->lastMigrations;
+        deltaSwitches = pStats_p->switchCount - pRecord_p->lastStats.switchCount;
+
+        pRecord_p->load = (UINT)(((pStats_p->cpuTimeNs - pRecord_p->lastStats.cpuTimeNs) * 1000ULL) /
+                                 intervalNs_p);
+        if (pRecord_p->load > pRecord_p->maxLoad)
+            pRecord_p->maxLoad = pRecord_p->load;
+        pRecord_p->switchRate = (UINT32)((deltaSwitches * 1000000000ULL) / intervalNs_p);
+        pRecord_p->switchesPerAct = (deltaActivations != 0) ?
+                                    (UINT)((deltaSwitches * 10ULL) / deltaActivations) : 0;
+
+        // a thread which blocks once per activation is switched out about once;
+        // more switches mean it is preempted by other work on its CPU
+        fDisturbed = (deltaMigrations != 0) ||
+                     ((deltaActivations != 0) &&
+                      (deltaSwitches > (UINT64)deltaActivations * THREADSTAT_SWITCH_LIMIT));
+        if (fDisturbed)
+            pRecord_p->disturbedCount++;
+
+        if ((role_p == kThreadStatRoleSync) && fDisturbed && !pRecord_p->fDisturbed)
+        {
+            CONSOLE_LOG_WARNING(kConsoleModSystem,
+                                "Sync thread is disturbed: %lu context switches in %lu cycles, %lu migrations\n",
+                                (ULONG)deltaSwitches, (ULONG)deltaActivations, (ULONG)deltaMigrations);
+        }
+        pRecord_p->fDisturbed = fDisturbed;
+    }
+
+    pRecord_p->lastStats = *pStats_p;
+    pRecord_p->lastActivations = activations;
+    pRecord_p->lastMigrations = migrations;
+    pRecord_p->fSampled = TRUE;
+}
+
+/// \}
@@ -0,0 +1,89 @@
+/**
+********************************************************************************
+\file   threadstat.h
+
+\brief  Definitions for the thread statistics module
+
+This file contains the definitions for the per-thread CPU and scheduling
+statistics of the demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_threadstat_H_
+#define _INC_threadstat_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define THREADSTAT_INTERVAL             1000    ///< Collection interval [ms]
+#define THREADSTAT_SWITCH_LIMIT         3       ///< Context switches per activation above which a thread is considered disturbed
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Thread roles
+
+The enumeration lists the roles of the application threads for which
+statistics are collected.
+*/
+typedef enum
+{
+    kThreadStatRoleMain = 0,                ///< Main loop (keyboard, supervision)
+    kThreadStatRoleSync,                    ///< Synchronous data handler
+    kThreadStatRoleEvent,                   ///< Stack event handler
+    kThreadStatRoleHistorian,               ///< Historian data reduction
+    kThreadStatRoleParam,                   ///< Runtime parameter file watcher
+    kThreadStatRoleCount                    ///< Number of roles
+} tThreadStatRole;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void threadstat_enter(tThreadStatRole role_p);
+void threadstat_process(void);
+void threadstat_printStatistics(void);
+void threadstat_exit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_threadstat_H_ */
@@ -0,0 +1,239 @@
+/**
+********************************************************************************
+\file   oplk/oplk.h
+
+\brief  Stack declarations for the host unit checks
+
+The file declares the part of the openPOWERLINK API which is used by the
+modules under test. The unit checks are built on any host without the stack,
+the API functions are implemented by the fakes of the individual checks.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_oplk_oplk_H_
+#define _INC_oplk_oplk_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef TRUE
+#define TRUE                        1
+#endif
+#ifndef FALSE
+#define FALSE                       0
+#endif
+
+#define UNUSED_PARAMETER(par)       (void)(par)
+
+#define C_ADR_BROADCAST             0xFF    ///< Broadcast node ID
+#define C_ADR_MN_DEF_NODE_ID        0xF0    ///< Default node ID of the MN
+
+#define E_DLL_CYCLE_EXCEED          0x8233  ///< Cycle length exceeded
+#define E_DLL_LOSS_PRES_TH          0x8242  ///< PRes loss threshold reached
+#define E_DLL_LOSS_SOA_TH           0x8244  ///< SoA loss threshold reached
+#define E_DLL_LOSS_SOC_TH           0x8245  ///< SoC loss threshold reached
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef int                 BOOL;
+typedef unsigned char       BYTE;
+typedef char                CHAR;
+typedef int                 INT;
+typedef unsigned int        UINT;
+typedef unsigned long       ULONG;
+typedef unsigned short      WORD;
+typedef uint32_t            DWORD;
+typedef int8_t              INT8;
+typedef int16_t             INT16;
+typedef int32_t             INT32;
+typedef int64_t             INT64;
+typedef uint8_t             UINT8;
+typedef uint16_t            UINT16;
+typedef uint32_t            UINT32;
+typedef uint64_t            UINT64;
+
+typedef enum
+{
+    kErrorOk                        = 0x0000,
+    kErrorIllegalInstance           = 0x0001,
+    kErrorInvalidNodeId             = 0x0007,
+    kErrorNoResource                = 0x0008,
+    kErrorShutdown                  = 0x0009,
+    kErrorReject                    = 0x000A,
+    kErrorObdInvalidDcf             = 0x003C,
+    kErrorApiTaskDeferred           = 0x0140,
+    kErrorApiInvalidParam           = 0x0142,
+    kErrorApiNotInitialized         = 0x014A
+} tOplkError;
+
+typedef enum
+{
+    kNmtGsOff                       = 0x0000,
+    kNmtGsInitialising              = 0x0019,
+    kNmtGsResetApplication          = 0x0029,
+    kNmtGsResetCommunication        = 0x0039,
+    kNmtGsResetConfiguration        = 0x0079,
+    kNmtCsNotActive                 = 0x011C,
+    kNmtCsPreOperational1           = 0x011D,
+    kNmtCsStopped                   = 0x014D,
+    kNmtCsPreOperational2           = 0x015D,
+    kNmtCsReadyToOperate            = 0x016D,
+    kNmtCsOperational               = 0x01FD,
+    kNmtMsNotActive                 = 0x021C,
+    kNmtMsPreOperational1           = 0x021D,
+    kNmtMsPreOperational2           = 0x025D,
+    kNmtMsReadyToOperate            = 0x026D,
+    kNmtMsOperational               = 0x02FD
+} tNmtState;
+
+typedef enum
+{
+    kNmtEventSwReset                = 0x08
+} tNmtEvent;
+
+typedef enum
+{
+    kNmtCmdStartNode                = 0x21,
+    kNmtCmdStopNode                 = 0x22,
+    kNmtCmdEnterPreOperational2     = 0x23,
+    kNmtCmdEnableReadyToOperate     = 0x24,
+    kNmtCmdResetNode                = 0x28,
+    kNmtCmdResetCommunication       = 0x29,
+    kNmtCmdResetConfiguration       = 0x2A,
+    kNmtCmdSwReset                  = 0x2B
+} tNmtCommand;
+
+typedef enum
+{
+    kNmtNodeEventFound              = 0x00,
+    kNmtNodeEventUpdateSw           = 0x01,
+    kNmtNodeEventCheckConf          = 0x02,
+    kNmtNodeEventUpdateConf         = 0x03,
+    kNmtNodeEventVerifyConf         = 0x04,
+    kNmtNodeEventReadyToStart       = 0x05,
+    kNmtNodeEventIsochronous        = 0x06,
+    kNmtNodeEventAsyncOnly          = 0x07,
+    kNmtNodeEventError              = 0x08,
+    kNmtNodeEventNmtState           = 0x09,
+    kNmtNodeEventConfDone           = 0x0A
+} tNmtNodeEvent;
+
+typedef struct
+{
+    UINT                nodeId;
+    tNmtState           nmtState;
+    tNmtNodeEvent       nodeEvent;
+    UINT16              errorCode;
+    BOOL                fMandatory;
+} tOplkApiEventNode;
+
+typedef struct
+{
+    UINT32              sec;
+    UINT32              nsec;
+} tNetTime;
+
+typedef struct
+{
+    tNetTime            netTime;
+    UINT64              relTime;
+    BOOL                fValidRelTime;
+} tOplkApiSocTimeInfo;
+
+typedef struct
+{
+    UINT16              entryType;
+    UINT16              errorCode;
+    tNetTime            timeStamp;
+    UINT8               aAddInfo[8];
+} tErrHistoryEntry;
+
+typedef UINT                tSdoComConHdl;
+
+typedef enum
+{
+    kSdoComTransferNotActive        = 0x00,
+    kSdoComTransferRunning          = 0x01,
+    kSdoComTransferTxAborted        = 0x02,
+    kSdoComTransferRxAborted        = 0x03,
+    kSdoComTransferFinished         = 0x04,
+    kSdoComTransferLowerLayerAbort  = 0x05
+} tSdoComConState;
+
+typedef enum
+{
+    kSdoTypeAuto                    = 0x00,
+    kSdoTypeUdp                     = 0x01,
+    kSdoTypeAsnd                    = 0x02
+} tSdoType;
+
+typedef struct
+{
+    tSdoComConHdl       sdoComConHdl;
+    tSdoComConState     sdoComConState;
+    UINT32              abortCode;
+    UINT                nodeId;
+    UINT                targetIndex;
+    UINT                targetSubIndex;
+    UINT                transferredBytes;
+    void*               pUserArg;
+} tSdoComFinished;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+tOplkError oplk_execNmtCommand(tNmtEvent nmtEvent_p);
+tOplkError oplk_execRemoteNmtCommand(UINT nodeId_p, tNmtCommand nmtCommand_p);
+tOplkError oplk_getSocTime(tOplkApiSocTimeInfo* pTimeInfo_p);
+tOplkError oplk_readLocalObject(UINT index_p, UINT subindex_p, void* pDstData_p, UINT* pSize_p);
+tOplkError oplk_readObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                           UINT subindex_p, void* pDstData_le_p, UINT* pSize_p,
+                           tSdoType sdoType_p, void* pUserArg_p);
+tOplkError oplk_freeSdoChannel(tSdoComConHdl sdoComConHdl_p);
+tOplkError oplk_postUserEvent(void* pUserArg_p);
+tOplkError oplk_setCdcBuffer(BYTE* pCdc_p, UINT cdcSize_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_oplk_H_ */
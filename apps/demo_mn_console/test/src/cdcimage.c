@@ -0,0 +1,182 @@
+/**
+********************************************************************************
+\file   cdcimage.c
+
+\brief  CDC image builder of the host unit checks
+
+This file contains the CDC image builder used by the host unit checks of the
+MN demo application. It creates CDCs and concise DCFs in the binary format read
+by the CDC module, so the checks need no configuration files.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include "cdcimage.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CDCIMAGE_COUNT_SIZE         4       // size of the entry count
+#define CDCIMAGE_HEADER_SIZE        7       // index (2), sub-index (1), size (4)
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void writeUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize a CDC image
+
+The function initializes an image without entries.
+
+\param  pImage_p                Pointer to the image.
+*/
+//------------------------------------------------------------------------------
+void cdcimage_init(tCdcImage* pImage_p)
+{
+    memset(pImage_p, 0, sizeof(tCdcImage));
+    pImage_p->size = CDCIMAGE_COUNT_SIZE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an entry with raw data
+
+The function appends an entry and increments the entry count. Entries which
+do not fit into the image are dropped.
+
+\param  pImage_p                Pointer to the image.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  pData_p                 Object data.
+\param  size_p                  Size of the object data [bytes].
+*/
+//------------------------------------------------------------------------------
+void cdcimage_addData(tCdcImage* pImage_p, UINT index_p, UINT subIndex_p,
+                      const void* pData_p, UINT size_p)
+{
+    BYTE*   pEntry = pImage_p->aData + pImage_p->size;
+    UINT32  count = (UINT32)pImage_p->aData[0] | ((UINT32)pImage_p->aData[1] << 8) |
+                    ((UINT32)pImage_p->aData[2] << 16) | ((UINT32)pImage_p->aData[3] << 24);
+
+    if ((pImage_p->size + CDCIMAGE_HEADER_SIZE + size_p) > sizeof(pImage_p->aData))
+        return;
+
+    writeUintLe(pEntry, index_p, 2);
+    writeUintLe(pEntry + 2, subIndex_p, 1);
+    writeUintLe(pEntry + 3, size_p, 4);
+    memcpy(pEntry + CDCIMAGE_HEADER_SIZE, pData_p, size_p);
+    pImage_p->size += CDCIMAGE_HEADER_SIZE + size_p;
+
+    writeUintLe(pImage_p->aData, count + 1, CDCIMAGE_COUNT_SIZE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an entry with an integer value
+
+\param  pImage_p                Pointer to the image.
+\param  index_p                 Object index.
+\param  subIndex_p              Object sub-index.
+\param  value_p                 Object value.
+\param  size_p                  Size of the object [bytes] (1 to 8).
+*/
+//------------------------------------------------------------------------------
+void cdcimage_addValue(tCdcImage* pImage_p, UINT index_p, UINT subIndex_p,
+                       UINT64 value_p, UINT size_p)
+{
+    BYTE    aData[8];
+
+    writeUintLe(aData, value_p, size_p);
+    cdcimage_addData(pImage_p, index_p, subIndex_p, aData, size_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write a CDC image to a file
+
+\param  pImage_p                Pointer to the image.
+\param  pszFileName_p           File name of the CDC.
+
+\return The function returns TRUE if the file has been written.
+*/
+//------------------------------------------------------------------------------
+BOOL cdcimage_write(const tCdcImage* pImage_p, const char* pszFileName_p)
+{
+    FILE*   pFile;
+    size_t  written;
+
+    pFile = fopen(pszFileName_p, "wb");
+    if (pFile == NULL)
+        return FALSE;
+
+    written = fwrite(pImage_p->aData, 1, pImage_p->size, pFile);
+    fclose(pFile);
+
+    return (written == pImage_p->size);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write a little endian value
+
+\param  pData_p                 Pointer to store the value.
+\param  value_p                 Value to write.
+\param  size_p                  Size of the value in bytes.
+*/
+//------------------------------------------------------------------------------
+static void writeUintLe(BYTE* pData_p, UINT64 value_p, UINT size_p)
+{
+    UINT    i;
+
+    for (i = 0; i < size_p; i++)
+        pData_p[i] = (BYTE)(value_p >> (i * 8));
+}
+
+/// \}
@@ -0,0 +1,85 @@
+/**
+********************************************************************************
+\file   cdcimage.h
+
+\brief  Definitions for the CDC image builder of the host unit checks
+
+The file contains the definitions of the CDC image builder used by the host
+unit checks of the MN demo application.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_cdcimage_H_
+#define _INC_cdcimage_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CDCIMAGE_MAX_SIZE           4096    ///< Maximum size of a built CDC [bytes]
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  CDC image
+
+The structure contains a CDC or concise DCF which is built entry by entry.
+*/
+typedef struct
+{
+    BYTE        aData[CDCIMAGE_MAX_SIZE];   ///< CDC contents
+    UINT        size;                       ///< Size of the CDC [bytes]
+} tCdcImage;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void cdcimage_init(tCdcImage* pImage_p);
+void cdcimage_addData(tCdcImage* pImage_p, UINT index_p, UINT subIndex_p,
+                      const void* pData_p, UINT size_p);
+void cdcimage_addValue(tCdcImage* pImage_p, UINT index_p, UINT subIndex_p,
+                       UINT64 value_p, UINT size_p);
+BOOL cdcimage_write(const tCdcImage* pImage_p, const char* pszFileName_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_cdcimage_H_ */
@@ -0,0 +1,348 @@
+/**
+********************************************************************************
+\file   cdctest.c
+
+\brief  Unit checks of the CDC module
+
+This file contains the host unit checks of the CDC module: the CRC32 used as
+fingerprint of the configuration, the entry cursor, the lookup of entries and
+node DCFs, and the validation of truncated configurations.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "check.h"
+#include "cdcimage.h"
+#include "cdc.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CDCTEST_FILE            "cdctest.cdc"
+#define CDCTEST_NODE_ID         5
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void checkCrc(void);
+static void checkFingerprint(void);
+static void checkCursor(void);
+static void checkTruncated(void);
+static void checkFindEntry(void);
+static void checkNodeDcf(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the CDC checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkCrc();
+    checkFingerprint();
+    checkCursor();
+    checkTruncated();
+    checkFindEntry();
+    checkNodeDcf();
+
+    return check_finish("cdctest");
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the CRC32 calculation
+
+The CRC must match the IEEE 802.3 check value and give the same result when
+it is calculated in pieces.
+*/
+//------------------------------------------------------------------------------
+static void checkCrc(void)
+{
+    static const char   aCheckData[] = "123456789";
+    UINT32              crc;
+
+    CHECK(cdc_calcCrc32(0, aCheckData, 9) == 0xCBF43926UL);
+    CHECK(cdc_calcCrc32(0, aCheckData, 0) == 0);
+
+    crc = cdc_calcCrc32(0, aCheckData, 4);
+    crc = cdc_calcCrc32(crc, aCheckData + 4, 5);
+    CHECK(crc == 0xCBF43926UL);
+
+    CHECK(cdc_calcCrc32(0, "123456780", 9) != 0xCBF43926UL);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the fingerprint of a loaded CDC
+
+The fingerprint is the CRC32 over the file contents.
+*/
+//------------------------------------------------------------------------------
+static void checkFingerprint(void)
+{
+    static const BYTE   aCdc[] =
+    {
+        0x01, 0x00, 0x00, 0x00,                         // one entry
+        0x06, 0x10, 0x00, 0x04, 0x00, 0x00, 0x00,       // 0x1006/0, 4 bytes
+        0xE8, 0x03, 0x00, 0x00                          // 1000 us
+    };
+    FILE*               pFile;
+    UINT                size;
+
+    pFile = fopen(CDCTEST_FILE, "wb");
+    if (!CHECK(pFile != NULL))
+        return;
+    CHECK(fwrite(aCdc, 1, sizeof(aCdc), pFile) == sizeof(aCdc));
+    fclose(pFile);
+
+    if (!CHECK(cdc_init(CDCTEST_FILE) == kErrorOk))
+        return;
+
+    CHECK(cdc_getBuffer(&size) != NULL);
+    CHECK(size == sizeof(aCdc));
+    CHECK(cdc_getFingerprint() == cdc_calcCrc32(0, aCdc, sizeof(aCdc)));
+
+    cdc_exit();
+    remove(CDCTEST_FILE);
+
+    CHECK(cdc_init(CDCTEST_FILE) == kErrorNoResource);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the iteration over the entries of a CDC
+
+The cursor returns all entries in order with their data and stops after the
+number of entries given in the header.
+*/
+//------------------------------------------------------------------------------
+static void checkCursor(void)
+{
+    static const BYTE   aDomain[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99 };
+    tCdcImage           image;
+    tCdcCursor          cursor;
+    tCdcEntry           entry;
+
+    CHECK(cdc_openCursor(NULL, 16, &cursor) == kErrorApiInvalidParam);
+    cdcimage_init(&image);
+    CHECK(cdc_openCursor(image.aData, 3, &cursor) == kErrorApiInvalidParam);
+
+    // an empty CDC has no entries
+    if (CHECK(cdc_openCursor(image.aData, image.size, &cursor) == kErrorOk))
+        CHECK(!cdc_nextEntry(&cursor, &entry));
+
+    cdcimage_addValue(&image, 0x1006, 0, 1000, 4);
+    cdcimage_addValue(&image, 0x1F98, 7, 0xFE, 1);
+    cdcimage_addData(&image, 0x2000, 0x01, aDomain, sizeof(aDomain));
+    cdcimage_addData(&image, 0x2001, 0x00, aDomain, 0);
+
+    if (!CHECK(cdc_openCursor(image.aData, image.size, &cursor) == kErrorOk))
+        return;
+
+    CHECK(cdc_nextEntry(&cursor, &entry));
+    CHECK((entry.index == 0x1006) && (entry.subIndex == 0) && (entry.size == 4));
+    CHECK(cdc_getEntryValue(&entry) == 1000);
+
+    CHECK(cdc_nextEntry(&cursor, &entry));
+    CHECK((entry.index == 0x1F98) && (entry.subIndex == 7) && (entry.size == 1));
+    CHECK(cdc_getEntryValue(&entry) == 0xFE);
+
+    // values are little endian and limited to 8 bytes
+    CHECK(cdc_nextEntry(&cursor, &entry));
+    CHECK((entry.index == 0x2000) && (entry.subIndex == 1) && (entry.size == sizeof(aDomain)));
+    CHECK(memcmp(entry.pData, aDomain, sizeof(aDomain)) == 0);
+    CHECK(cdc_getEntryValue(&entry) == 0x8877665544332211ULL);
+
+    CHECK(cdc_nextEntry(&cursor, &entry));
+    CHECK((entry.index == 0x2001) && (entry.size == 0));
+    CHECK(cdc_getEntryValue(&entry) == 0);
+
+    CHECK(!cdc_nextEntry(&cursor, &entry));
+    CHECK(cursor.remainingEntries == 0);
+    CHECK(cursor.offset == image.size);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the iteration over truncated CDCs
+
+The cursor must never read beyond the end of the CDC. An entry whose header
+or data is cut off ends the iteration, and the remaining entry count shows
+that the CDC is incomplete.
+*/
+//------------------------------------------------------------------------------
+static void checkTruncated(void)
+{
+    tCdcImage           image;
+    tCdcCursor          cursor;
+    tCdcEntry           entry;
+    UINT                size;
+    UINT                count;
+
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1006, 0, 1000, 4);
+    cdcimage_addValue(&image, 0x1F98, 7, 3, 1);
+
+    // every truncation yields only the complete entries in front of the cut
+    for (size = 4; size < image.size; size++)
+    {
+        if (!CHECK(cdc_openCursor(image.aData, size, &cursor) == kErrorOk))
+            continue;
+
+        for (count = 0; cdc_nextEntry(&cursor, &entry); count++)
+            CHECK((entry.pData + entry.size) <= (image.aData + size));
+
+        CHECK(count == ((size < 15) ? 0U : 1U));
+        CHECK(cursor.remainingEntries == (2 - count));
+    }
+
+    // an entry size beyond the end of the CDC
+    image.aData[4 + 3] = 0xFF;
+    image.aData[4 + 6] = 0x7F;
+    if (CHECK(cdc_openCursor(image.aData, image.size, &cursor) == kErrorOk))
+    {
+        CHECK(!cdc_nextEntry(&cursor, &entry));
+        CHECK(cursor.remainingEntries == 2);
+    }
+
+    // more entries announced than contained
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1006, 0, 1000, 4);
+    image.aData[0] = 3;
+    if (CHECK(cdc_openCursor(image.aData, image.size, &cursor) == kErrorOk))
+    {
+        CHECK(cdc_nextEntry(&cursor, &entry));
+        CHECK(!cdc_nextEntry(&cursor, &entry));
+        CHECK(cursor.remainingEntries == 2);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the lookup of entries
+
+An object which is contained multiple times is found with its last entry,
+because that entry determines the final value.
+*/
+//------------------------------------------------------------------------------
+static void checkFindEntry(void)
+{
+    tCdcImage           image;
+    tCdcEntry           entry;
+
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1006, 0, 1000, 4);
+    cdcimage_addValue(&image, 0x1F81, 5, 0x00000003, 4);
+    cdcimage_addValue(&image, 0x1006, 0, 2000, 4);
+
+    CHECK(cdc_findEntry(image.aData, image.size, 0x1006, 0, &entry));
+    CHECK(cdc_getEntryValue(&entry) == 2000);
+    CHECK(cdc_findEntry(image.aData, image.size, 0x1F81, 5, &entry));
+    CHECK(cdc_getEntryValue(&entry) == 3);
+
+    CHECK(!cdc_findEntry(image.aData, image.size, 0x1F81, 6, &entry));
+    CHECK(!cdc_findEntry(image.aData, image.size, 0x1007, 0, &entry));
+    CHECK(!cdc_findEntry(image.aData, 2, 0x1006, 0, &entry));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the access to the DCFs of the CNs
+
+The concise DCFs of the CNs are contained in object 0x1F22 of the loaded CDC.
+A DCF which announces more entries than it contains makes the CDC invalid.
+*/
+//------------------------------------------------------------------------------
+static void checkNodeDcf(void)
+{
+    tCdcImage           dcf;
+    tCdcImage           image;
+    tCdcEntry           entry;
+    const BYTE*         pDcf;
+    UINT                dcfSize;
+
+    cdcimage_init(&dcf);
+    cdcimage_addValue(&dcf, 0x1006, 0, 1000, 4);
+    cdcimage_addValue(&dcf, 0x1020, 2, 12345, 4);
+
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1006, 0, 1000, 4);
+    cdcimage_addData(&image, CDC_DCF_LIST_INDEX, CDCTEST_NODE_ID, dcf.aData, dcf.size);
+    if (!CHECK(cdcimage_write(&image, CDCTEST_FILE)) ||
+        !CHECK(cdc_init(CDCTEST_FILE) == kErrorOk))
+        return;
+
+    CHECK(cdc_validate() == kErrorOk);
+    CHECK(!cdc_getNodeDcf(CDCTEST_NODE_ID + 1, &pDcf, &dcfSize));
+    if (CHECK(cdc_getNodeDcf(CDCTEST_NODE_ID, &pDcf, &dcfSize)))
+    {
+        CHECK(dcfSize == dcf.size);
+        CHECK(cdc_findEntry(pDcf, dcfSize, 0x1020, 2, &entry));
+        CHECK(cdc_getEntryValue(&entry) == 12345);
+    }
+    cdc_exit();
+
+    // the DCF claims a third entry
+    dcf.aData[0] = 3;
+    cdcimage_init(&image);
+    cdcimage_addData(&image, CDC_DCF_LIST_INDEX, CDCTEST_NODE_ID, dcf.aData, dcf.size);
+    if (CHECK(cdcimage_write(&image, CDCTEST_FILE)) &&
+        CHECK(cdc_init(CDCTEST_FILE) == kErrorOk))
+    {
+        CHECK(cdc_validate() == kErrorObdInvalidDcf);
+        cdc_exit();
+    }
+
+    remove(CDCTEST_FILE);
+}
+
+/// \}
@@ -0,0 +1,117 @@
+/**
+********************************************************************************
+\file   check.c
+
+\brief  Assertion helpers of the host unit checks
+
+This file contains the assertion helpers used by the host unit checks of the
+MN demo application. Failed checks are printed with their source location, the
+exit code of a check program tells ctest whether all checks passed.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+
+#include "check.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Check instance
+
+The structure contains the counters of the check program.
+*/
+typedef struct
+{
+    UINT                checkCount;         ///< Number of executed checks
+    UINT                failCount;          ///< Number of failed checks
+} tCheckInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCheckInstance       checkInstance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record the result of a check
+
+The function is usually called through the CHECK() macro.
+
+\param  fPassed_p               Result of the check.
+\param  pszExpr_p               Checked expression.
+\param  pszFile_p               Source file of the check.
+\param  line_p                  Source line of the check.
+
+\return The function returns the result of the check.
+*/
+//------------------------------------------------------------------------------
+BOOL check_expect(BOOL fPassed_p, const char* pszExpr_p, const char* pszFile_p, int line_p)
+{
+    checkInstance_l.checkCount++;
+    if (!fPassed_p)
+    {
+        checkInstance_l.failCount++;
+        printf("%s:%d: check failed: %s\n", pszFile_p, line_p, pszExpr_p);
+    }
+
+    return fPassed_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish the check program
+
+The function prints the summary of all checks.
+
+\param  pszName_p               Name of the check program.
+
+\return The function returns the exit code of the check program, 0 if all
+        checks have passed.
+*/
+//------------------------------------------------------------------------------
+int check_finish(const char* pszName_p)
+{
+    printf("%s: %u checks, %u failed\n", pszName_p,
+           checkInstance_l.checkCount, checkInstance_l.failCount);
+
+    return (checkInstance_l.failCount == 0) ? 0 : 1;
+}
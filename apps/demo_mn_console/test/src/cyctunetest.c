@@ -0,0 +1,549 @@
+/**
+********************************************************************************
+\file   cyctunetest.c
+
+\brief  Unit checks of the cycle length tuner
+
+This file contains the host unit checks of the cycle length tuner. The tuner
+runs its complete search against a simulated network: a fake stack boots on
+an NMT reset, drives the sync events of the tuner and reports errors below
+configurable cycle lengths. The simulated clock makes each soak instant.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "check.h"
+#include "fake.h"
+#include "cdcimage.h"
+#include "cdc.h"
+#include "errhist.h"
+#include "phase.h"
+#include "reinteg.h"
+#include "cyctune.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CYCTUNETEST_FILE        "cyctunetest.cdc"
+#define CYCTUNETEST_TUNED_FILE  "cyctunetest-tuned.cdc"
+#define CYCTUNETEST_CYCLE_LEN   1000        // configured cycle length [us]
+#define CYCTUNETEST_MIN_LEN     200         // lower bound of the search [us]
+#define CYCTUNETEST_NODE_ID     1           // CN whose DCF contains the cycle length
+#define CYCTUNETEST_BOOT_TIME   2000        // time from the reset to operational [ms]
+#define CYCTUNETEST_DROP_TIME   5000        // time from operational to a drop [ms]
+#define CYCTUNETEST_MAX_RESETS  64          // resets recorded by the fake stack
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Simulated network
+
+The structure describes the behavior of the simulated network. A cycle length
+below a limit causes the corresponding error, a limit of 0 disables it.
+*/
+typedef struct
+{
+    UINT32              bootLimit;          ///< Below: the MN does not become operational
+    UINT32              presLimit;          ///< Below: PRes timeouts
+    UINT32              dropLimit;          ///< Below: the MN drops out of operational
+    UINT32              appTime;            ///< Application time per cycle [us]
+    UINT                failingReset;       ///< Number of the reset which fails (0 = none)
+} tCycTuneTestNet;
+
+/**
+\brief  Fake stack
+
+The structure contains the state of the fake stack.
+*/
+typedef struct
+{
+    tCycTuneTestNet     net;                ///< Behavior of the network
+    UINT32              cdcCycleLen;        ///< Cycle length of the CDC passed to the stack [us]
+    UINT32              cycleLen;           ///< Cycle length of the running network [us]
+    UINT                resetCount;         ///< Number of NMT resets
+    UINT32              aResetCycleLen[CYCTUNETEST_MAX_RESETS]; ///< Cycle length of each reset [us]
+    BOOL                fBooting;           ///< The network boots after a reset
+    BOOL                fOperational;       ///< The MN is operational
+    BOOL                fDropped;           ///< The MN dropped out of operational in this run
+    UINT64              operationalTime;    ///< Time the MN becomes operational [ns]
+    UINT64              nextSyncTime;       ///< Time of the next sync event [ns]
+    UINT32              phaseCycleLen;      ///< Last cycle length passed to the phase module [us]
+} tCycTuneTestStack;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCycTuneTestStack    stack_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError runTuner(const tCycTuneTestNet* pNet_p, UINT32 cycleLen_p);
+static UINT32     readCycleLen(const BYTE* pCdc_p, UINT size_p);
+static UINT32     readNodeCycleLen(void);
+static void       simulate(UINT milliSeconds_p);
+static void       checkSearch(void);
+static void       checkStableRange(void);
+static void       checkAppBudget(void);
+static void       checkBootFailure(void);
+static void       checkDrops(void);
+static void       checkMarginLimit(void);
+static void       checkUnstableConfig(void);
+static void       checkResetFailure(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the cycle length tuner checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    fake_setSleepHook(simulate);
+
+    checkSearch();
+    checkStableRange();
+    checkAppBudget();
+    checkBootFailure();
+    checkDrops();
+    checkMarginLimit();
+    checkUnstableConfig();
+    checkResetFailure();
+
+    cdc_exit();
+    remove(CYCTUNETEST_FILE);
+    remove(CYCTUNETEST_TUNED_FILE);
+    return check_finish("cyctunetest");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute an NMT command (fake)
+
+A software reset restarts the network with the cycle length of the CDC last
+passed to the stack.
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_execNmtCommand(tNmtEvent nmtEvent_p)
+{
+    if (nmtEvent_p != kNmtEventSwReset)
+        return kErrorApiInvalidParam;
+
+    stack_l.resetCount++;
+    if (stack_l.resetCount <= CYCTUNETEST_MAX_RESETS)
+        stack_l.aResetCycleLen[stack_l.resetCount - 1] = stack_l.cdcCycleLen;
+
+    if (stack_l.resetCount == stack_l.net.failingReset)
+        return kErrorNoResource;
+
+    if (stack_l.fOperational)
+        cyctune_processNmtState(kNmtGsResetCommunication);
+
+    stack_l.cycleLen = stack_l.cdcCycleLen;
+    stack_l.fOperational = FALSE;
+    stack_l.fDropped = FALSE;
+    stack_l.fBooting = (stack_l.cycleLen >= stack_l.net.bootLimit);
+    stack_l.operationalTime = system_getTimeNs() + ((UINT64)CYCTUNETEST_BOOT_TIME * 1000000);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pass a CDC to the stack (fake)
+
+The stack only keeps the cycle length of the CDC.
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setCdcBuffer(BYTE* pCdc_p, UINT cdcSize_p)
+{
+    stack_l.cdcCycleLen = readCycleLen(pCdc_p, cdcSize_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the cycle length of the phase-locked scheduler (fake)
+*/
+//------------------------------------------------------------------------------
+void phase_setCycleLen(UINT32 cycleLenUs_p)
+{
+    stack_l.phaseCycleLen = cycleLenUs_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Restage the node configurations (fake)
+*/
+//------------------------------------------------------------------------------
+void reinteg_restage(void)
+{
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the tuner against a simulated network
+
+The function loads a CDC with the configured cycle length for the MN and for
+one CN and runs the complete search.
+
+\param  pNet_p                  Behavior of the network.
+\param  cycleLen_p              Configured cycle length [us].
+
+\return The function returns the result of cyctune_run().
+*/
+//------------------------------------------------------------------------------
+static tOplkError runTuner(const tCycTuneTestNet* pNet_p, UINT32 cycleLen_p)
+{
+    tCdcImage   dcf;
+    tCdcImage   image;
+
+    memset(&stack_l, 0, sizeof(stack_l));
+    stack_l.net = *pNet_p;
+    fake_setTime(1000000000);
+    errhist_init();
+
+    cdcimage_init(&dcf);
+    cdcimage_addValue(&dcf, 0x1006, 0, cycleLen_p, 4);
+    cdcimage_addValue(&dcf, 0x1020, 2, 0, 4);
+
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1006, 0, cycleLen_p, 4);
+    cdcimage_addData(&image, CDC_DCF_LIST_INDEX, CYCTUNETEST_NODE_ID, dcf.aData, dcf.size);
+
+    cdc_exit();
+    remove(CYCTUNETEST_TUNED_FILE);
+    if (!cdcimage_write(&image, CYCTUNETEST_FILE) || (cdc_init(CYCTUNETEST_FILE) != kErrorOk))
+        return kErrorNoResource;
+
+    cyctune_init(cycleLen_p, CYCTUNETEST_MIN_LEN, CYCTUNETEST_TUNED_FILE, NULL);
+    return cyctune_run();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the cycle length of a CDC
+
+\param  pCdc_p                  Pointer to the CDC.
+\param  size_p                  Size of the CDC [bytes].
+
+\return The function returns the cycle length or 0 if it is not contained.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readCycleLen(const BYTE* pCdc_p, UINT size_p)
+{
+    tCdcEntry   entry;
+
+    if (!cdc_findEntry(pCdc_p, size_p, 0x1006, 0, &entry))
+        return 0;
+
+    return (UINT32)cdc_getEntryValue(&entry);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the cycle length of the CN in the loaded CDC
+
+\return The function returns the cycle length or 0 if it is not contained.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readNodeCycleLen(void)
+{
+    const BYTE* pDcf;
+    UINT        dcfSize;
+
+    if (!cdc_getNodeDcf(CYCTUNETEST_NODE_ID, &pDcf, &dcfSize))
+        return 0;
+
+    return readCycleLen(pDcf, dcfSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Simulate the network while the tuner sleeps
+
+The function is the sleep hook of the fake platform. It lets the network boot
+and produces the sync events of the tuner with the application time of the
+network. Errors of a too short cycle length are reported once per sleep, a
+drop out of operational happens once per run after CYCTUNETEST_DROP_TIME.
+
+\param  milliSeconds_p          Sleep period [ms].
+*/
+//------------------------------------------------------------------------------
+static void simulate(UINT milliSeconds_p)
+{
+    tCycTuneTestStack*  pStack = &stack_l;
+    UINT64              endTime = system_getTimeNs() + ((UINT64)milliSeconds_p * 1000000);
+
+    if (pStack->fBooting && (endTime >= pStack->operationalTime))
+    {
+        pStack->fBooting = FALSE;
+        pStack->fOperational = TRUE;
+        pStack->nextSyncTime = pStack->operationalTime;
+        cyctune_processNmtState(kNmtMsOperational);
+    }
+
+    if (pStack->fOperational)
+    {
+        while (pStack->nextSyncTime <= endTime)
+        {
+            fake_setTime(pStack->nextSyncTime);
+            cyctune_syncEvent();
+            fake_advanceTime((UINT64)pStack->net.appTime * 1000);
+            cyctune_syncDone();
+            pStack->nextSyncTime += (UINT64)pStack->cycleLen * 1000;
+        }
+
+        if (pStack->cycleLen < pStack->net.presLimit)
+            errhist_addNodeError(CYCTUNETEST_NODE_ID, E_DLL_LOSS_PRES_TH);
+
+        if ((pStack->cycleLen < pStack->net.dropLimit) && !pStack->fDropped &&
+            (endTime >= pStack->operationalTime + ((UINT64)CYCTUNETEST_DROP_TIME * 1000000)))
+        {
+            pStack->fDropped = TRUE;
+            cyctune_processNmtState(kNmtMsPreOperational2);
+            cyctune_processNmtState(kNmtMsOperational);
+        }
+    }
+
+    fake_setTime(endTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the search for the smallest stable cycle length
+
+The search bisects between the largest unstable and the smallest stable cycle
+length with the resolution of the tuner. The tuned length with margin is
+passed to the stack, written to the DCFs of the CNs and saved.
+*/
+//------------------------------------------------------------------------------
+static void checkSearch(void)
+{
+    tCycTuneTestNet     net = { 0, 430, 0, 10, 0 };
+    FILE*               pFile;
+    UINT                i;
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+
+    // 430 us + 20 % = 516 us, rounded up to the resolution
+    CHECK(stack_l.cdcCycleLen == 520);
+    CHECK(stack_l.phaseCycleLen == 520);
+    CHECK(readNodeCycleLen() == 520);
+
+    // the configured length and at most log2((1000 - 190) / 10) + 1 steps
+    CHECK(stack_l.resetCount <= 9);
+    CHECK(stack_l.aResetCycleLen[0] == CYCTUNETEST_CYCLE_LEN);
+    for (i = 0; (i < stack_l.resetCount) && (i < CYCTUNETEST_MAX_RESETS); i++)
+    {
+        CHECK((stack_l.aResetCycleLen[i] % CYCTUNE_RESOLUTION) == 0);
+        CHECK((stack_l.aResetCycleLen[i] >= CYCTUNETEST_MIN_LEN) &&
+              (stack_l.aResetCycleLen[i] <= CYCTUNETEST_CYCLE_LEN));
+    }
+
+    // both neighbors of the result have been tested
+    for (i = 0; i < stack_l.resetCount; i++)
+    {
+        if (stack_l.aResetCycleLen[i] == 420)
+            break;
+    }
+    CHECK(i < stack_l.resetCount);
+    for (i = 0; i < stack_l.resetCount; i++)
+    {
+        if (stack_l.aResetCycleLen[i] == 430)
+            break;
+    }
+    CHECK(i < stack_l.resetCount);
+
+    // the tuned CDC has been saved
+    cdc_exit();
+    pFile = fopen(CYCTUNETEST_TUNED_FILE, "rb");
+    if (CHECK(pFile != NULL))
+    {
+        fclose(pFile);
+        if (CHECK(cdc_init(CYCTUNETEST_TUNED_FILE) == kErrorOk))
+        {
+            UINT    size;
+            BYTE*   pCdc = cdc_getBuffer(&size);
+
+            CHECK(readCycleLen(pCdc, size) == 520);
+            CHECK(readNodeCycleLen() == 520);
+            CHECK(cdc_validate() == kErrorOk);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a network which is stable in the whole range
+
+The lower bound of the search is tested as well and becomes the result.
+*/
+//------------------------------------------------------------------------------
+static void checkStableRange(void)
+{
+    tCycTuneTestNet     net = { 0, 0, 0, 10, 0 };
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+    CHECK(stack_l.aResetCycleLen[stack_l.resetCount - 1] == CYCTUNETEST_MIN_LEN);
+    CHECK(stack_l.cdcCycleLen == 240);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the application time budget
+
+A cycle length is unstable if the application needs more than
+CYCTUNE_BUDGET_PERCENT of it.
+*/
+//------------------------------------------------------------------------------
+static void checkAppBudget(void)
+{
+    tCycTuneTestNet     net = { 0, 0, 0, 300, 0 };
+
+    // 300 us fit into 80 % of 375 us, the smallest multiple of 10 is 380 us
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+    CHECK(stack_l.cdcCycleLen == 460);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check cycle lengths at which the network does not boot
+
+A network which does not become operational within CYCTUNE_BOOT_TIMEOUT is
+unstable.
+*/
+//------------------------------------------------------------------------------
+static void checkBootFailure(void)
+{
+    tCycTuneTestNet     net = { 600, 0, 0, 10, 0 };
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+    CHECK(stack_l.cdcCycleLen == 720);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check cycle lengths at which the MN drops out of operational
+*/
+//------------------------------------------------------------------------------
+static void checkDrops(void)
+{
+    tCycTuneTestNet     net = { 0, 0, 350, 10, 0 };
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+    CHECK(stack_l.cdcCycleLen == 420);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the limitation of the margin
+
+The tuned cycle length never exceeds the configured one.
+*/
+//------------------------------------------------------------------------------
+static void checkMarginLimit(void)
+{
+    tCycTuneTestNet     net = { 0, 900, 0, 10, 0 };
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorOk);
+    CHECK(stack_l.cdcCycleLen == CYCTUNETEST_CYCLE_LEN);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check an unstable configured cycle length
+
+The search is not started and the CDC is not saved.
+*/
+//------------------------------------------------------------------------------
+static void checkUnstableConfig(void)
+{
+    tCycTuneTestNet     net = { 0, 2000, 0, 10, 0 };
+    FILE*               pFile;
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorReject);
+    CHECK(stack_l.resetCount == 1);
+
+    pFile = fopen(CYCTUNETEST_TUNED_FILE, "rb");
+    CHECK(pFile == NULL);
+    if (pFile != NULL)
+        fclose(pFile);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a failing NMT reset
+
+The error of the reset ends the search, it is not taken as an unstable cycle
+length.
+*/
+//------------------------------------------------------------------------------
+static void checkResetFailure(void)
+{
+    tCycTuneTestNet     net = { 0, 0, 0, 10, 3 };
+    FILE*               pFile;
+
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorNoResource);
+    CHECK(stack_l.resetCount == 3);
+
+    pFile = fopen(CYCTUNETEST_TUNED_FILE, "rb");
+    CHECK(pFile == NULL);
+    if (pFile != NULL)
+        fclose(pFile);
+
+    net.failingReset = 1;
+    CHECK(runTuner(&net, CYCTUNETEST_CYCLE_LEN) == kErrorNoResource);
+    CHECK(stack_l.resetCount == 1);
+}
+
+/// \}
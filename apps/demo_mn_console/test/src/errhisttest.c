@@ -0,0 +1,321 @@
+/**
+********************************************************************************
+\file   errhisttest.c
+
+\brief  Unit checks of the error history store
+
+This file contains the host unit checks of the error history store: the node
+and error code chains, the time queries and the behavior when the ring and
+the code index are full.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "check.h"
+#include "fake.h"
+#include "errhist.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ERRHISTTEST_TIME_STEP   1000        // time between two records [ns]
+#define ERRHISTTEST_MAX_TIME    (~(UINT64)0)
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tErrHistRecord       aRecord_l[ERRHIST_ENTRY_COUNT];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void addError(UINT nodeId_p, UINT16 errorCode_p);
+static void checkChains(void);
+static void checkTimeQuery(void);
+static void checkEntry(void);
+static void checkRingWrap(void);
+static void checkCodeIndexFull(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the error history checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkChains();
+    checkTimeQuery();
+    checkEntry();
+    checkRingWrap();
+    checkCodeIndexFull();
+
+    return check_finish("errhisttest");
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a node error one time step after the previous one
+
+\param  nodeId_p                Node ID.
+\param  errorCode_p             Error code.
+*/
+//------------------------------------------------------------------------------
+static void addError(UINT nodeId_p, UINT16 errorCode_p)
+{
+    fake_advanceTime(ERRHISTTEST_TIME_STEP);
+    errhist_addNodeError(nodeId_p, errorCode_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the node and error code chains
+
+Each query returns only the records of its node or error code, in
+chronological order. If the array is too small, the most recent records are
+returned.
+*/
+//------------------------------------------------------------------------------
+static void checkChains(void)
+{
+    UINT    count;
+
+    errhist_init();
+    fake_setTime(0);
+
+    addError(1, 0x8242);        // sequence 1
+    addError(2, 0x8245);        // sequence 2
+    addError(1, 0x8245);        // sequence 3
+    addError(3, 0x8242);        // sequence 4
+    addError(1, 0x8242);        // sequence 5
+
+    CHECK(errhist_getTotalCount() == 5);
+    CHECK(errhist_getNodeCount(1) == 3);
+    CHECK(errhist_getNodeCount(2) == 1);
+    CHECK(errhist_getNodeCount(4) == 0);
+    CHECK(errhist_getNodeCount(1000) == 0);
+    CHECK(errhist_getCodeCount(0x8242) == 3);
+    CHECK(errhist_getCodeCount(0x8245) == 2);
+    CHECK(errhist_getCodeCount(0x8233) == 0);
+
+    count = errhist_queryByNode(1, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == 3))
+    {
+        CHECK((aRecord_l[0].sequence == 1) && (aRecord_l[1].sequence == 3) &&
+              (aRecord_l[2].sequence == 5));
+        CHECK((aRecord_l[0].nodeId == 1) && (aRecord_l[1].errorCode == 0x8245));
+        CHECK(aRecord_l[0].entryType == ERRHIST_TYPE_NODE_ERROR);
+    }
+
+    count = errhist_queryByCode(0x8245, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == 2))
+        CHECK((aRecord_l[0].sequence == 2) && (aRecord_l[1].sequence == 3));
+
+    count = errhist_queryByCode(0x8242, 0, ERRHISTTEST_MAX_TIME, aRecord_l, 2);
+    if (CHECK(count == 2))
+        CHECK((aRecord_l[0].sequence == 4) && (aRecord_l[1].sequence == 5));
+
+    // time range of sequences 2 to 4
+    count = errhist_queryByNode(1, 2 * ERRHISTTEST_TIME_STEP, 4 * ERRHISTTEST_TIME_STEP,
+                                aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == 1))
+        CHECK(aRecord_l[0].sequence == 3);
+
+    CHECK(errhist_queryByNode(4, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+    CHECK(errhist_queryByCode(0x8233, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the time query
+
+The query returns the records of the range in chronological order. If the
+array is too small, the oldest records of the range are returned.
+*/
+//------------------------------------------------------------------------------
+static void checkTimeQuery(void)
+{
+    UINT    count;
+    UINT    i;
+
+    errhist_init();
+    fake_setTime(0);
+    CHECK(errhist_queryByTime(0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+
+    for (i = 0; i < 100; i++)
+        addError(i % 7, (UINT16)(0x8000 + (i % 3)));
+
+    count = errhist_queryByTime(10 * ERRHISTTEST_TIME_STEP, 20 * ERRHISTTEST_TIME_STEP,
+                                aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == 11))
+        CHECK((aRecord_l[0].sequence == 10) && (aRecord_l[10].sequence == 20));
+
+    // the start lies between two records
+    count = errhist_queryByTime((10 * ERRHISTTEST_TIME_STEP) + 1, 20 * ERRHISTTEST_TIME_STEP,
+                                aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == 10))
+        CHECK(aRecord_l[0].sequence == 11);
+
+    count = errhist_queryByTime(10 * ERRHISTTEST_TIME_STEP, ERRHISTTEST_MAX_TIME, aRecord_l, 5);
+    if (CHECK(count == 5))
+        CHECK((aRecord_l[0].sequence == 10) && (aRecord_l[4].sequence == 14));
+
+    CHECK(errhist_queryByTime(101 * ERRHISTTEST_TIME_STEP, ERRHISTTEST_MAX_TIME,
+                              aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+    CHECK(errhist_queryByTime(0, ERRHISTTEST_TIME_STEP - 1, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the contents of a history entry reported by the stack
+*/
+//------------------------------------------------------------------------------
+static void checkEntry(void)
+{
+    tErrHistoryEntry    entry;
+
+    errhist_init();
+    fake_setTime(5000);
+
+    memset(&entry, 0, sizeof(entry));
+    entry.entryType = 0x1001;
+    entry.errorCode = 0x8233;
+    entry.timeStamp.sec = 17;
+    entry.timeStamp.nsec = 42;
+    entry.aAddInfo[0] = 0xAA;
+    entry.aAddInfo[7] = 0x55;
+    errhist_addEntry(ERRHIST_NODE_LOCAL, &entry);
+
+    if (CHECK(errhist_queryByCode(0x8233, 0, ERRHISTTEST_MAX_TIME, aRecord_l, 1) == 1))
+    {
+        CHECK((aRecord_l[0].nodeId == ERRHIST_NODE_LOCAL) && (aRecord_l[0].entryType == 0x1001));
+        CHECK((aRecord_l[0].netTime.sec == 17) && (aRecord_l[0].netTime.nsec == 42));
+        CHECK((aRecord_l[0].aAddInfo[0] == 0xAA) && (aRecord_l[0].aAddInfo[7] == 0x55));
+        CHECK(aRecord_l[0].time == 5000);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the store after the ring has wrapped
+
+Overwritten records are neither returned by the time query nor followed in
+the chains, while the counters keep all records.
+*/
+//------------------------------------------------------------------------------
+static void checkRingWrap(void)
+{
+    UINT    count;
+    UINT    i;
+
+    errhist_init();
+    fake_setTime(0);
+
+    // node 1 only has records which are overwritten later
+    addError(1, 0x8242);
+    for (i = 1; i < ERRHIST_ENTRY_COUNT + 100; i++)
+        addError(2 + (i % 2), (UINT16)((i % 2) ? 0x8245 : 0x8244));
+
+    CHECK(errhist_getTotalCount() == ERRHIST_ENTRY_COUNT + 100);
+    CHECK(errhist_getNodeCount(1) == 1);
+    CHECK(errhist_getCodeCount(0x8242) == 1);
+
+    count = errhist_queryByTime(0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == ERRHIST_ENTRY_COUNT))
+    {
+        CHECK(aRecord_l[0].sequence == 101);
+        CHECK(aRecord_l[ERRHIST_ENTRY_COUNT - 1].sequence == ERRHIST_ENTRY_COUNT + 100);
+    }
+
+    CHECK(errhist_queryByNode(1, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+    CHECK(errhist_queryByCode(0x8242, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+
+    count = errhist_queryByNode(2, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT);
+    if (CHECK(count == ERRHIST_ENTRY_COUNT / 2))
+    {
+        CHECK(aRecord_l[0].sequence > 100);
+        for (i = 1; i < count; i++)
+            CHECK(aRecord_l[i].sequence == aRecord_l[i - 1].sequence + 2);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the store with a full error code index
+
+Records with codes that do not fit into the index are stored and counted as
+unindexed, they are still found by node and time.
+*/
+//------------------------------------------------------------------------------
+static void checkCodeIndexFull(void)
+{
+    UINT    i;
+
+    errhist_init();
+    fake_setTime(0);
+
+    for (i = 0; i < ERRHIST_CODE_TABLE_SIZE; i++)
+        addError(1, (UINT16)(0x1000 + i));
+    CHECK(errhist_getCodeCount(0x1000) == 1);
+    CHECK(errhist_getCodeCount((UINT16)(0x1000 + ERRHIST_CODE_TABLE_SIZE - 1)) == 1);
+
+    addError(2, 0x2000);
+    CHECK(errhist_getTotalCount() == ERRHIST_CODE_TABLE_SIZE + 1);
+    CHECK(errhist_getCodeCount(0x2000) == 0);
+    CHECK(errhist_queryByCode(0x2000, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 0);
+    if (CHECK(errhist_queryByNode(2, 0, ERRHISTTEST_MAX_TIME, aRecord_l, ERRHIST_ENTRY_COUNT) == 1))
+        CHECK(aRecord_l[0].errorCode == 0x2000);
+
+    // indexed codes keep counting
+    addError(3, 0x1000);
+    CHECK(errhist_getCodeCount(0x1000) == 2);
+}
+
+/// \}
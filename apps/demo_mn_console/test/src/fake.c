@@ -0,0 +1,197 @@
+/**
+********************************************************************************
+\file   fake.c
+
+\brief  Fake platform of the host unit checks
+
+This file contains the platform functions used by the modules under test.
+Time is simulated: system_getTimeNs() returns a fake time which only moves when
+a check advances it or a module sleeps, so time dependent code is checked
+deterministically and without waiting. The console never reports a key.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <system/system.h>
+#include <console/console.h>
+
+#include "fake.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Fake platform instance
+
+The structure contains the state of the fake platform.
+*/
+typedef struct
+{
+    UINT64              timeNs;             ///< Current fake time [ns]
+    tFakeSleepCb        pfnSleep;           ///< Replacement of the sleep time advance, or NULL
+} tFakeInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tFakeInstance        fakeInstance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the fake time
+
+\param  timeNs_p                New fake time [ns].
+*/
+//------------------------------------------------------------------------------
+void fake_setTime(UINT64 timeNs_p)
+{
+    fakeInstance_l.timeNs = timeNs_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Advance the fake time
+
+\param  timeNs_p                Period to advance [ns].
+*/
+//------------------------------------------------------------------------------
+void fake_advanceTime(UINT64 timeNs_p)
+{
+    fakeInstance_l.timeNs += timeNs_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the sleep hook
+
+The hook is called by system_msleep() instead of advancing the fake time, so a
+check can simulate what happens while a module waits.
+
+\param  pfnSleep_p              Sleep routine, NULL to only advance the time.
+*/
+//------------------------------------------------------------------------------
+void fake_setSleepHook(tFakeSleepCb pfnSleep_p)
+{
+    fakeInstance_l.pfnSleep = pfnSleep_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for a termination signal
+
+\return The function returns FALSE, the checks are never terminated.
+*/
+//------------------------------------------------------------------------------
+BOOL system_getTermSignalState(void)
+{
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Sleep
+
+The function advances the fake time or calls the sleep hook.
+
+\param  milliSeconds_p          Sleep period [ms].
+*/
+//------------------------------------------------------------------------------
+void system_msleep(unsigned int milliSeconds_p)
+{
+    if (fakeInstance_l.pfnSleep != NULL)
+        fakeInstance_l.pfnSleep(milliSeconds_p);
+    else
+        fakeInstance_l.timeNs += (UINT64)milliSeconds_p * 1000000;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the monotonic time
+
+\return The function returns the fake time [ns].
+*/
+//------------------------------------------------------------------------------
+UINT64 system_getTimeNs(void)
+{
+    return fakeInstance_l.timeNs;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Memory barrier
+
+The checks are single-threaded, so only the compiler must not reorder.
+*/
+//------------------------------------------------------------------------------
+void system_memoryBarrier(void)
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for a key press
+
+\return The function returns 0, no key is ever pressed.
+*/
+//------------------------------------------------------------------------------
+int console_kbhit(void)
+{
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a key
+
+\return The function returns 0.
+*/
+//------------------------------------------------------------------------------
+int console_getch(void)
+{
+    return 0;
+}
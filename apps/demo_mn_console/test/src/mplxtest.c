@@ -0,0 +1,360 @@
+/**
+********************************************************************************
+\file   mplxtest.c
+
+\brief  Unit checks of the multiplexed cycle handling
+
+This file contains the host unit checks of the multiplexed cycle handling: the
+node lists of the slots built from the CDC, the selection of the slot from
+the SoC time and the rejection of invalid configurations.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+
+#include "check.h"
+#include "fake.h"
+#include "cdcimage.h"
+#include "cdc.h"
+#include "mplx.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define MPLXTEST_FILE           "mplxtest.cdc"
+#define MPLXTEST_CYCLE_LEN      1000        // cycle length [us]
+
+#define MPLXTEST_CN             0x00000002  // node is a CN
+#define MPLXTEST_ASYNCONLY      0x00000100  // node is not polled isochronously
+#define MPLXTEST_MULTIPLEXED    0x00000200  // node is polled in a multiplexed slot
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Fake stack
+
+The structure contains the state of the stack as seen by the module.
+*/
+typedef struct
+{
+    UINT32              cycleLen;           ///< Cycle length in the object dictionary [us]
+    UINT64              relTime;            ///< Relative time of the last SoC [us]
+    BOOL                fValidRelTime;      ///< The relative time is valid
+} tMplxTestStack;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tMplxTestStack       stack_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError initMplx(UINT cycleCount_p, UINT cycleCountSize_p);
+static BOOL       checkNodes(UINT64 relTime_p, const UINT8* pExpected_p, UINT count_p);
+static void       checkSlots(void);
+static void       checkUnknownSlot(void);
+static void       checkNoMultiplexing(void);
+static void       checkInvalidConfig(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the multiplexed cycle checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkSlots();
+    checkUnknownSlot();
+    checkNoMultiplexing();
+    checkInvalidConfig();
+
+    remove(MPLXTEST_FILE);
+    return check_finish("mplxtest");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a local object (fake)
+
+Only the cycle length 0x1006 exists.
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_readLocalObject(UINT index_p, UINT subindex_p, void* pDstData_p, UINT* pSize_p)
+{
+    if ((index_p != 0x1006) || (subindex_p != 0) || (*pSize_p < sizeof(UINT32)))
+        return kErrorApiInvalidParam;
+
+    memcpy(pDstData_p, &stack_l.cycleLen, sizeof(UINT32));
+    *pSize_p = sizeof(UINT32);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the time of the last SoC (fake)
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSocTime(tOplkApiSocTimeInfo* pTimeInfo_p)
+{
+    memset(pTimeInfo_p, 0, sizeof(tOplkApiSocTimeInfo));
+    pTimeInfo_p->relTime = stack_l.relTime;
+    pTimeInfo_p->fValidRelTime = stack_l.fValidRelTime;
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the module with the check network
+
+The network consists of:
+- nodes 1 and 2, refreshed in every cycle,
+- node 3 in slot 1, nodes 4 and 5 in slot 2,
+- node 6, which is async-only although it has a slot,
+- node 7, which is not a CN.
+
+\param  cycleCount_p            Multiplexed cycle length.
+\param  cycleCountSize_p        Size of the cycle length object [bytes].
+
+\return The function returns the result of mplx_init().
+*/
+//------------------------------------------------------------------------------
+static tOplkError initMplx(UINT cycleCount_p, UINT cycleCountSize_p)
+{
+    tCdcImage   image;
+    tOplkError  ret;
+
+    cdcimage_init(&image);
+    cdcimage_addValue(&image, 0x1F81, 1, MPLXTEST_CN, 4);
+    cdcimage_addValue(&image, 0x1F81, 2, MPLXTEST_CN, 4);
+    cdcimage_addValue(&image, 0x1F81, 3, MPLXTEST_CN | MPLXTEST_MULTIPLEXED, 4);
+    cdcimage_addValue(&image, 0x1F81, 4, MPLXTEST_CN | MPLXTEST_MULTIPLEXED, 4);
+    cdcimage_addValue(&image, 0x1F81, 5, MPLXTEST_CN | MPLXTEST_MULTIPLEXED, 4);
+    cdcimage_addValue(&image, 0x1F81, 6, MPLXTEST_CN | MPLXTEST_MULTIPLEXED | MPLXTEST_ASYNCONLY, 4);
+    cdcimage_addValue(&image, 0x1F81, 7, 0, 4);
+    cdcimage_addValue(&image, 0x1F9B, 3, 1, 1);
+    cdcimage_addValue(&image, 0x1F9B, 4, 2, 1);
+    cdcimage_addValue(&image, 0x1F9B, 5, 2, 1);
+    cdcimage_addValue(&image, 0x1F9B, 6, 1, 1);
+    cdcimage_addValue(&image, 0x1F98, 7, cycleCount_p, cycleCountSize_p);
+
+    cdc_exit();
+    if (!cdcimage_write(&image, MPLXTEST_FILE))
+        return kErrorNoResource;
+
+    ret = cdc_init(MPLXTEST_FILE);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = mplx_init();
+    if (ret == kErrorOk)
+    {
+        stack_l.cycleLen = MPLXTEST_CYCLE_LEN;
+        stack_l.fValidRelTime = TRUE;
+        mplx_restart();
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the nodes serviced in a cycle
+
+\param  relTime_p               Relative time of the SoC of the cycle [us].
+\param  pExpected_p             Expected node IDs in ascending order.
+\param  count_p                 Number of expected nodes.
+
+\return The function returns TRUE if the expected nodes have been serviced.
+*/
+//------------------------------------------------------------------------------
+static BOOL checkNodes(UINT64 relTime_p, const UINT8* pExpected_p, UINT count_p)
+{
+    const UINT8*    pNodes;
+    UINT            count;
+    UINT            i;
+
+    fake_advanceTime(MPLXTEST_CYCLE_LEN * 1000);
+    stack_l.relTime = relTime_p;
+    pNodes = mplx_beginCycle(&count);
+    if (!CHECK(count == count_p))
+        return FALSE;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!CHECK(pNodes[i] == pExpected_p[i]))
+            return FALSE;
+        CHECK(mplx_getLastRefresh(pNodes[i]) == system_getTimeNs());
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the node lists of the slots
+
+Every cycle services the continuous nodes and the nodes of its slot. The slot
+follows from the SoC time, so it wraps after the multiplexed cycle.
+*/
+//------------------------------------------------------------------------------
+static void checkSlots(void)
+{
+    static const UINT8  aSlot1[] = { 1, 2, 3 };
+    static const UINT8  aSlot2[] = { 1, 2, 4, 5 };
+    static const UINT8  aSlot3[] = { 1, 2 };
+    UINT64              refresh;
+
+    fake_setTime(1000000);
+    if (!CHECK(initMplx(3, 1) == kErrorOk))
+        return;
+
+    CHECK(mplx_getCycleCount() == 3);
+    CHECK(mplx_getSlot(1) == MPLX_SLOT_CONTINUOUS);
+    CHECK(mplx_getSlot(3) == 1);
+    CHECK(mplx_getSlot(5) == 2);
+    CHECK(mplx_getSlot(6) == MPLX_SLOT_CONTINUOUS);
+    CHECK(mplx_getSlot(0) == MPLX_SLOT_CONTINUOUS);
+    CHECK(mplx_getSlot(MPLX_NODE_COUNT + 1) == MPLX_SLOT_CONTINUOUS);
+
+    CHECK(checkNodes(0, aSlot1, sizeof(aSlot1)));
+    CHECK(checkNodes(1 * MPLXTEST_CYCLE_LEN, aSlot2, sizeof(aSlot2)));
+    refresh = system_getTimeNs();
+    CHECK(checkNodes(2 * MPLXTEST_CYCLE_LEN, aSlot3, sizeof(aSlot3)));
+    CHECK(checkNodes(3 * MPLXTEST_CYCLE_LEN, aSlot1, sizeof(aSlot1)));
+
+    // a skipped cycle does not shift the slot
+    CHECK(checkNodes(5 * MPLXTEST_CYCLE_LEN, aSlot3, sizeof(aSlot3)));
+    CHECK(checkNodes(302 * MPLXTEST_CYCLE_LEN, aSlot3, sizeof(aSlot3)));
+
+    CHECK(mplx_getLastRefresh(4) == refresh);
+    CHECK(mplx_getLastRefresh(6) == 0);
+    CHECK(mplx_getLastRefresh(7) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the cycles with unknown slot
+
+Without a valid SoC time or cycle length, only the continuous nodes are
+serviced.
+*/
+//------------------------------------------------------------------------------
+static void checkUnknownSlot(void)
+{
+    static const UINT8  aContinuous[] = { 1, 2 };
+
+    if (!CHECK(initMplx(3, 1) == kErrorOk))
+        return;
+
+    stack_l.fValidRelTime = FALSE;
+    CHECK(checkNodes(MPLXTEST_CYCLE_LEN, aContinuous, sizeof(aContinuous)));
+
+    stack_l.fValidRelTime = TRUE;
+    stack_l.cycleLen = 0;
+    mplx_restart();
+    CHECK(checkNodes(MPLXTEST_CYCLE_LEN, aContinuous, sizeof(aContinuous)));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the network without multiplexed cycle
+
+All isochronous nodes are serviced in every cycle, their slot assignment is
+ignored.
+*/
+//------------------------------------------------------------------------------
+static void checkNoMultiplexing(void)
+{
+    static const UINT8  aAll[] = { 1, 2, 3, 4, 5 };
+
+    if (!CHECK(initMplx(0, 1) == kErrorOk))
+        return;
+
+    CHECK(mplx_getCycleCount() == 0);
+    CHECK(mplx_getSlot(4) == MPLX_SLOT_CONTINUOUS);
+    CHECK(checkNodes(0, aAll, sizeof(aAll)));
+    CHECK(checkNodes(MPLXTEST_CYCLE_LEN, aAll, sizeof(aAll)));
+
+    stack_l.fValidRelTime = FALSE;
+    CHECK(checkNodes(MPLXTEST_CYCLE_LEN, aAll, sizeof(aAll)));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the rejection of invalid configurations
+
+A slot beyond the multiplexed cycle and a multiplexed cycle longer than the
+slot table are rejected, the longest supported cycle is accepted.
+*/
+//------------------------------------------------------------------------------
+static void checkInvalidConfig(void)
+{
+    static const UINT8  aSlot2[] = { 1, 2, 4, 5 };
+    static const UINT8  aLastSlot[] = { 1, 2 };
+
+    // nodes 4 and 5 are assigned to slot 2
+    CHECK(initMplx(1, 1) == kErrorApiInvalidParam);
+
+    CHECK(initMplx(MPLX_MAX_CYCLE_COUNT + 1, 4) == kErrorApiInvalidParam);
+    CHECK(initMplx(0x10000, 4) == kErrorApiInvalidParam);
+
+    if (!CHECK(initMplx(MPLX_MAX_CYCLE_COUNT, 1) == kErrorOk))
+        return;
+
+    CHECK(mplx_getCycleCount() == MPLX_MAX_CYCLE_COUNT);
+    CHECK(checkNodes(MPLXTEST_CYCLE_LEN, aSlot2, sizeof(aSlot2)));
+    CHECK(checkNodes((MPLX_MAX_CYCLE_COUNT - 1) * MPLXTEST_CYCLE_LEN, aLastSlot, sizeof(aLastSlot)));
+}
+
+/// \}
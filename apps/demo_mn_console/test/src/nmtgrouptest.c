@@ -0,0 +1,429 @@
+/**
+********************************************************************************
+\file   nmtgrouptest.c
+
+\brief  Unit checks of the NMT group commands
+
+This file contains the host unit checks of the NMT group command module: the
+node list parser, the preset, the per-node sending of a command and the
+tracking of its completion.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+#include "check.h"
+#include "fake.h"
+#include "nmtgroup.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NMTGROUPTEST_MAX_SENT   (NMTGROUP_MAX_NODE_ID + 1)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Fake stack
+
+The structure records the remote NMT commands passed to the fake stack.
+*/
+typedef struct
+{
+    UINT                sentCount;                          ///< Number of commands
+    UINT                aNodeId[NMTGROUPTEST_MAX_SENT];     ///< Node of each command
+    tNmtCommand         aCommand[NMTGROUPTEST_MAX_SENT];    ///< Each command
+    UINT                failingCommand;                     ///< Number of the command which fails (0 = none)
+} tNmtGroupTestStack;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tNmtGroupTestStack   stack_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL isParsed(const char* pList_p, UINT firstId_p, UINT lastId_p);
+static BOOL isActive(void);
+static void sendEvent(UINT nodeId_p, tNmtNodeEvent nodeEvent_p, tNmtState nmtState_p);
+static void checkParseValid(void);
+static void checkParseInvalid(void);
+static void checkPreset(void);
+static void checkSend(void);
+static void checkCompletion(void);
+static void checkSendFailure(void);
+static void checkTimeout(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the NMT group command checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkParseValid();
+    checkParseInvalid();
+    checkPreset();
+    checkSend();
+    checkCompletion();
+    checkSendFailure();
+    checkTimeout();
+
+    return check_finish("nmtgrouptest");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute a remote NMT command (fake)
+
+The function records the command and fails on the configured command.
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_execRemoteNmtCommand(UINT nodeId_p, tNmtCommand nmtCommand_p)
+{
+    stack_l.sentCount++;
+    if (stack_l.sentCount == stack_l.failingCommand)
+        return kErrorNoResource;
+
+    if (stack_l.sentCount <= NMTGROUPTEST_MAX_SENT)
+    {
+        stack_l.aNodeId[stack_l.sentCount - 1] = nodeId_p;
+        stack_l.aCommand[stack_l.sentCount - 1] = nmtCommand_p;
+    }
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the result of the node list parser
+
+\param  pList_p                 Text of the node list.
+\param  firstId_p               First node expected in the list.
+\param  lastId_p                Last node expected in the list.
+
+\return The function returns TRUE if the list is accepted and contains exactly
+        the nodes firstId_p to lastId_p.
+*/
+//------------------------------------------------------------------------------
+static BOOL isParsed(const char* pList_p, UINT firstId_p, UINT lastId_p)
+{
+    tNmtGroupNodeList   nodes;
+    tNmtGroupNodeList   expected;
+    UINT                nodeId;
+
+    if (nmtgroup_parseNodeList(pList_p, &nodes) != kErrorOk)
+        return FALSE;
+
+    memset(&expected, 0, sizeof(expected));
+    for (nodeId = firstId_p; nodeId <= lastId_p; nodeId++)
+        expected.aBits[nodeId >> 3] |= (UINT8)(1 << (nodeId & 7));
+
+    return (memcmp(&nodes, &expected, sizeof(nodes)) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a group command is active
+
+The function tries to send a command to an empty node list, which is
+rejected as busy before the node list is checked.
+
+\return The function returns TRUE if a group command is tracked.
+*/
+//------------------------------------------------------------------------------
+static BOOL isActive(void)
+{
+    tNmtGroupNodeList   nodes;
+
+    memset(&nodes, 0, sizeof(nodes));
+    return (nmtgroup_execCommand(kNmtCmdStartNode, &nodes) == kErrorReject);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pass a node event to the module
+
+\param  nodeId_p                Node ID.
+\param  nodeEvent_p             Node event.
+\param  nmtState_p              NMT state of the node.
+*/
+//------------------------------------------------------------------------------
+static void sendEvent(UINT nodeId_p, tNmtNodeEvent nodeEvent_p, tNmtState nmtState_p)
+{
+    tOplkApiEventNode   nodeEvent;
+
+    memset(&nodeEvent, 0, sizeof(nodeEvent));
+    nodeEvent.nodeId = nodeId_p;
+    nodeEvent.nodeEvent = nodeEvent_p;
+    nodeEvent.nmtState = nmtState_p;
+    nmtgroup_processNodeEvent(&nodeEvent);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check valid node lists
+*/
+//------------------------------------------------------------------------------
+static void checkParseValid(void)
+{
+    tNmtGroupNodeList   nodes;
+
+    CHECK(isParsed("1", 1, 1));
+    CHECK(isParsed("239", 239, 239));
+    CHECK(isParsed("1-239", 1, 239));
+    CHECK(isParsed("0x10", 16, 16));
+    CHECK(isParsed("8-15", 8, 15));
+    CHECK(isParsed("5-5", 5, 5));
+    CHECK(isParsed("3-7,5,4-6", 3, 7));
+    CHECK(isParsed("1-3,4,5-10", 1, 10));
+
+    if (CHECK(nmtgroup_parseNodeList("1-40,45", &nodes) == kErrorOk))
+    {
+        CHECK(nodes.aBits[0] == 0xFE);
+        CHECK((nodes.aBits[1] == 0xFF) && (nodes.aBits[4] == 0xFF));
+        CHECK(nodes.aBits[5] == 0x21);
+        CHECK(nodes.aBits[6] == 0x00);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check invalid node lists
+*/
+//------------------------------------------------------------------------------
+static void checkParseInvalid(void)
+{
+    static const char*  apList[] =
+    {
+        "", "0", "0x0", "240", "1-240", "7-3", "-5", "1-", "1,", ",1", "1,,2",
+        "abc", "1;2", "1 2", "1-3-5", "4294967297"
+    };
+    tNmtGroupNodeList   nodes;
+    UINT                i;
+
+    for (i = 0; i < (sizeof(apList) / sizeof(apList[0])); i++)
+    {
+        if (!CHECK(nmtgroup_parseNodeList(apList[i], &nodes) == kErrorApiInvalidParam))
+            printf("    node list \"%s\"\n", apList[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the preset command
+*/
+//------------------------------------------------------------------------------
+static void checkPreset(void)
+{
+    CHECK(nmtgroup_init(NULL) == kErrorOk);
+    CHECK(!nmtgroup_hasPreset());
+    CHECK(nmtgroup_execPreset() == kErrorApiInvalidParam);
+
+    CHECK(nmtgroup_init("resetcomm") == kErrorApiInvalidParam);
+    CHECK(nmtgroup_init("reset:1") == kErrorApiInvalidParam);
+    CHECK(nmtgroup_init("resetcommx:1") == kErrorApiInvalidParam);
+    CHECK(nmtgroup_init("resetcomm:0") == kErrorApiInvalidParam);
+    CHECK(!nmtgroup_hasPreset());
+
+    memset(&stack_l, 0, sizeof(stack_l));
+    CHECK(nmtgroup_init("resetcomm:1-3") == kErrorOk);
+    CHECK(nmtgroup_hasPreset());
+    CHECK(nmtgroup_execPreset() == kErrorOk);
+    CHECK(stack_l.sentCount == 3);
+    CHECK((stack_l.aNodeId[0] == 1) && (stack_l.aNodeId[2] == 3));
+    CHECK((stack_l.aCommand[0] == kNmtCmdResetCommunication) &&
+          (stack_l.aCommand[2] == kNmtCmdResetCommunication));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the sending of a group command
+
+The command is sent once to every node of the list in ascending order. Only
+plain NMT state commands and non-empty node lists are accepted.
+*/
+//------------------------------------------------------------------------------
+static void checkSend(void)
+{
+    tNmtGroupNodeList   nodes;
+    UINT                i;
+
+    nmtgroup_init(NULL);
+    memset(&stack_l, 0, sizeof(stack_l));
+
+    memset(&nodes, 0, sizeof(nodes));
+    CHECK(nmtgroup_execCommand(kNmtCmdStopNode, &nodes) == kErrorApiInvalidParam);
+    nmtgroup_parseNodeList("1-239", &nodes);
+    CHECK(nmtgroup_execCommand((tNmtCommand)0x20, &nodes) == kErrorApiInvalidParam);
+    CHECK(stack_l.sentCount == 0);
+    CHECK(!isActive());
+
+    CHECK(nmtgroup_execCommand(kNmtCmdStopNode, &nodes) == kErrorOk);
+    if (CHECK(stack_l.sentCount == NMTGROUP_MAX_NODE_ID))
+    {
+        for (i = 0; i < NMTGROUP_MAX_NODE_ID; i++)
+        {
+            if (!CHECK((stack_l.aNodeId[i] == i + 1) && (stack_l.aCommand[i] == kNmtCmdStopNode)))
+                break;
+        }
+    }
+
+    // a second command is rejected while the first one is tracked
+    CHECK(isActive());
+    CHECK(nmtgroup_execCommand(kNmtCmdStartNode, &nodes) == kErrorReject);
+    CHECK(stack_l.sentCount == NMTGROUP_MAX_NODE_ID);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the tracking of the completion
+
+A state command is completed by the target state, a reset command by a found
+node or an initial state. Events of other nodes and other states are ignored.
+*/
+//------------------------------------------------------------------------------
+static void checkCompletion(void)
+{
+    tNmtGroupNodeList   nodes;
+
+    nmtgroup_init(NULL);
+    nmtgroup_parseNodeList("2,4", &nodes);
+    CHECK(nmtgroup_execCommand(kNmtCmdStartNode, &nodes) == kErrorOk);
+
+    sendEvent(2, kNmtNodeEventNmtState, kNmtCsOperational);
+    sendEvent(3, kNmtNodeEventNmtState, kNmtCsOperational);
+    sendEvent(4, kNmtNodeEventNmtState, kNmtCsReadyToOperate);
+    sendEvent(4, kNmtNodeEventFound, kNmtCsOperational);
+    nmtgroup_process();
+    CHECK(isActive());
+
+    sendEvent(4, kNmtNodeEventNmtState, kNmtCsOperational);
+    nmtgroup_process();
+    CHECK(!isActive());
+
+    nmtgroup_parseNodeList("5-7", &nodes);
+    CHECK(nmtgroup_execCommand(kNmtCmdResetNode, &nodes) == kErrorOk);
+    sendEvent(5, kNmtNodeEventFound, kNmtCsNotActive);
+    sendEvent(6, kNmtNodeEventNmtState, kNmtCsNotActive);
+    sendEvent(7, kNmtNodeEventNmtState, kNmtCsPreOperational2);
+    nmtgroup_process();
+    CHECK(isActive());
+
+    sendEvent(7, kNmtNodeEventNmtState, kNmtCsPreOperational1);
+    nmtgroup_process();
+    CHECK(!isActive());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a failure while sending a group command
+
+The remaining nodes are skipped, the nodes which got the command are still
+tracked.
+*/
+//------------------------------------------------------------------------------
+static void checkSendFailure(void)
+{
+    tNmtGroupNodeList   nodes;
+
+    nmtgroup_init(NULL);
+    nmtgroup_parseNodeList("10-13", &nodes);
+
+    memset(&stack_l, 0, sizeof(stack_l));
+    stack_l.failingCommand = 3;
+    CHECK(nmtgroup_execCommand(kNmtCmdStopNode, &nodes) == kErrorNoResource);
+    CHECK(stack_l.sentCount == 3);
+    CHECK(isActive());
+
+    sendEvent(10, kNmtNodeEventNmtState, kNmtCsStopped);
+    nmtgroup_process();
+    CHECK(isActive());
+
+    sendEvent(11, kNmtNodeEventNmtState, kNmtCsStopped);
+    nmtgroup_process();
+    CHECK(!isActive());
+
+    // nothing to track if the first node fails
+    memset(&stack_l, 0, sizeof(stack_l));
+    stack_l.failingCommand = 1;
+    CHECK(nmtgroup_execCommand(kNmtCmdStopNode, &nodes) == kErrorNoResource);
+    CHECK(stack_l.sentCount == 1);
+    CHECK(!isActive());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the timeout of a group command
+*/
+//------------------------------------------------------------------------------
+static void checkTimeout(void)
+{
+    tNmtGroupNodeList   nodes;
+
+    nmtgroup_init(NULL);
+    memset(&stack_l, 0, sizeof(stack_l));
+    nmtgroup_parseNodeList("20-21", &nodes);
+    CHECK(nmtgroup_execCommand(kNmtCmdEnterPreOperational2, &nodes) == kErrorOk);
+
+    sendEvent(20, kNmtNodeEventNmtState, kNmtCsPreOperational2);
+    fake_advanceTime((UINT64)NMTGROUP_TIMEOUT * 1000000);
+    nmtgroup_process();
+    CHECK(isActive());
+
+    fake_advanceTime(1000000);
+    nmtgroup_process();
+    CHECK(!isActive());
+}
+
+/// \}
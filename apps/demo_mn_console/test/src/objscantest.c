@@ -0,0 +1,683 @@
+/**
+********************************************************************************
+\file   objscantest.c
+
+\brief  Unit checks of the object scan
+
+This file contains the host unit checks of the object scan: the object list
+parser, the selection of the configured nodes, the reading through the SDO
+channel pool with synchronous, deferred and failing requests, the result
+lookup and the release of the SDO connections.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include <oplk/oplk.h>
+
+#include "check.h"
+#include "fake.h"
+#include "objscan.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define OBJSCANTEST_MAX_REQUESTS    512         // requests of the fake stack per scan
+#define OBJSCANTEST_MAX_HANDLES     64          // connections of the fake stack per scan
+#define OBJSCANTEST_ABORT_CODE      0x06020000  // object does not exist
+#define OBJSCANTEST_ABORT_GENERAL   0x08000000  // general error
+#define OBJSCANTEST_ABORT_TIMEOUT   0x05040000  // SDO protocol timed out
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Node behavior
+
+The enumeration defines how the fake stack answers the read requests of a
+node.
+*/
+typedef enum
+{
+    kObjScanTestSync = 0,               ///< The object is read immediately
+    kObjScanTestDeferred,               ///< The object is read by an SDO event
+    kObjScanTestAbort,                  ///< As deferred, subindex 2 is aborted by the node
+    kObjScanTestLowerLayer,             ///< The connection fails with a lower layer abort
+    kObjScanTestError                   ///< The request is refused
+} tObjScanTestMode;
+
+/**
+\brief  Deferred read request
+
+The structure contains a read request which is completed by an SDO event.
+*/
+typedef struct
+{
+    tSdoComConHdl       sdoHdl;         ///< Handle of the connection
+    UINT                nodeId;         ///< Node ID
+    UINT                index;          ///< Index of the object
+    UINT                subindex;       ///< Subindex of the object
+    void*               pData;          ///< Receive buffer
+    UINT                size;           ///< Size of the receive buffer
+    void*               pUserArg;       ///< User argument of the request
+} tObjScanTestRequest;
+
+/**
+\brief  Fake stack
+
+The structure contains the state of the fake stack.
+*/
+typedef struct
+{
+    tObjScanTestMode    aMode[OBJSCAN_MAX_NODE_ID + 1];     ///< Behavior of each node
+    UINT                aReadCount[OBJSCAN_MAX_NODE_ID + 1]; ///< Read requests of each node
+    tObjScanTestRequest aRequest[OBJSCANTEST_MAX_REQUESTS]; ///< Deferred requests
+    UINT                requestHead;                        ///< First request not completed
+    UINT                requestTail;                        ///< End of the requests
+    UINT                handleCount;                        ///< Number of opened connections
+    UINT                aHandleNodeId[OBJSCANTEST_MAX_HANDLES];    ///< Node of each connection
+    UINT                aFreeCount[OBJSCANTEST_MAX_HANDLES];       ///< Releases of each connection
+    BOOL                fInvalidFree;                       ///< An unknown connection has been released
+    void*               pUserArg;                           ///< Argument of the posted user event
+    UINT                userEventCount;                     ///< Number of posted user events
+    tOplkError          userEventError;                     ///< Result of posting a user event
+} tObjScanTestStack;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tObjScanTestStack    stack_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT32 getValue(UINT nodeId_p, UINT index_p, UINT subindex_p);
+static UINT   getSize(UINT index_p);
+static void   setNodeState(UINT nodeId_p, tNmtState nmtState_p);
+static void   resetStack(void);
+static void   completeRequests(void);
+static BOOL   isObjectRead(UINT nodeId_p, UINT index_p, UINT subindex_p);
+static BOOL   isObjectAborted(UINT nodeId_p, UINT index_p, UINT subindex_p, UINT32 abortCode_p);
+static UINT   getFreeCount(UINT nodeId_p);
+static void   checkParse(void);
+static void   checkSort(void);
+static void   checkNoNodes(void);
+static void   checkScan(void);
+static void   checkNodeReset(void);
+static void   checkStartFailure(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the object scan checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkParse();
+    checkSort();
+    checkNoNodes();
+    checkScan();
+    checkNodeReset();
+    checkStartFailure();
+
+    return check_finish("objscantest");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an object of a node (fake)
+
+The function opens a connection if the handle is not valid and answers the
+request according to the behavior of the node.
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_readObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                           UINT subindex_p, void* pDstData_le_p, UINT* pSize_p,
+                           tSdoType sdoType_p, void* pUserArg_p)
+{
+    tObjScanTestStack*      pStack = &stack_l;
+    tObjScanTestRequest*    pRequest;
+    UINT32                  value;
+    UINT                    size;
+
+    (void)sdoType_p;
+
+    if ((nodeId_p == 0) || (nodeId_p > OBJSCAN_MAX_NODE_ID) ||
+        (pStack->aMode[nodeId_p] == kObjScanTestError))
+        return kErrorNoResource;
+
+    pStack->aReadCount[nodeId_p]++;
+    if (*pSdoComConHdl_p == UINT_MAX)
+    {
+        if (pStack->handleCount == OBJSCANTEST_MAX_HANDLES)
+            return kErrorNoResource;
+
+        pStack->aHandleNodeId[pStack->handleCount] = nodeId_p;
+        *pSdoComConHdl_p = pStack->handleCount++;
+    }
+
+    if (pStack->aMode[nodeId_p] == kObjScanTestSync)
+    {
+        value = getValue(nodeId_p, index_p, subindex_p);
+        size = getSize(index_p);
+        if (size > *pSize_p)
+            size = *pSize_p;
+        memcpy(pDstData_le_p, &value, size);       // the host is little endian
+        *pSize_p = size;
+        return kErrorOk;
+    }
+
+    if (pStack->requestTail == OBJSCANTEST_MAX_REQUESTS)
+        return kErrorNoResource;
+
+    pRequest = &pStack->aRequest[pStack->requestTail++];
+    pRequest->sdoHdl = *pSdoComConHdl_p;
+    pRequest->nodeId = nodeId_p;
+    pRequest->index = index_p;
+    pRequest->subindex = subindex_p;
+    pRequest->pData = pDstData_le_p;
+    pRequest->size = *pSize_p;
+    pRequest->pUserArg = pUserArg_p;
+    return kErrorApiTaskDeferred;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release an SDO connection (fake)
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_freeSdoChannel(tSdoComConHdl sdoComConHdl_p)
+{
+    if (sdoComConHdl_p >= stack_l.handleCount)
+    {
+        stack_l.fInvalidFree = TRUE;
+        return kErrorIllegalInstance;
+    }
+
+    stack_l.aFreeCount[sdoComConHdl_p]++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post a user event (fake)
+
+The event is delivered by the check calling objscan_processUserEvent().
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_postUserEvent(void* pUserArg_p)
+{
+    if (stack_l.userEventError != kErrorOk)
+        return stack_l.userEventError;
+
+    stack_l.pUserArg = pUserArg_p;
+    stack_l.userEventCount++;
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the value of an object of the fake nodes
+
+\param  nodeId_p                Node ID.
+\param  index_p                 Index of the object.
+\param  subindex_p              Subindex of the object.
+
+\return The function returns the value of the object.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getValue(UINT nodeId_p, UINT index_p, UINT subindex_p)
+{
+    return ((UINT32)nodeId_p << 24) | ((UINT32)index_p << 8) | subindex_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the size of an object of the fake nodes
+
+\param  index_p                 Index of the object.
+
+\return The function returns the size of the object [bytes].
+*/
+//------------------------------------------------------------------------------
+static UINT getSize(UINT index_p)
+{
+    // the error register is a single byte, the other objects are 4 bytes
+    return (index_p == 0x1001) ? 1 : 4;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Report the NMT state of a node to the module
+
+\param  nodeId_p                Node ID.
+\param  nmtState_p              NMT state of the node.
+*/
+//------------------------------------------------------------------------------
+static void setNodeState(UINT nodeId_p, tNmtState nmtState_p)
+{
+    tOplkApiEventNode   nodeEvent;
+
+    memset(&nodeEvent, 0, sizeof(nodeEvent));
+    nodeEvent.nodeId = nodeId_p;
+    nodeEvent.nodeEvent = kNmtNodeEventNmtState;
+    nodeEvent.nmtState = nmtState_p;
+    objscan_processNodeEvent(&nodeEvent);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset the fake stack
+*/
+//------------------------------------------------------------------------------
+static void resetStack(void)
+{
+    memset(&stack_l, 0, sizeof(stack_l));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Complete the deferred requests
+
+The function completes the deferred requests in the order they have been
+issued, including the requests issued while processing the SDO events.
+*/
+//------------------------------------------------------------------------------
+static void completeRequests(void)
+{
+    tObjScanTestStack*      pStack = &stack_l;
+    tObjScanTestRequest*    pRequest;
+    tSdoComFinished         sdo;
+    UINT32                  value;
+    UINT                    size;
+
+    while (pStack->requestHead < pStack->requestTail)
+    {
+        pRequest = &pStack->aRequest[pStack->requestHead++];
+
+        memset(&sdo, 0, sizeof(sdo));
+        sdo.sdoComConHdl = pRequest->sdoHdl;
+        sdo.nodeId = pRequest->nodeId;
+        sdo.targetIndex = pRequest->index;
+        sdo.targetSubIndex = pRequest->subindex;
+        sdo.pUserArg = pRequest->pUserArg;
+        sdo.sdoComConState = kSdoComTransferFinished;
+
+        if (pStack->aMode[pRequest->nodeId] == kObjScanTestLowerLayer)
+        {
+            sdo.sdoComConState = kSdoComTransferLowerLayerAbort;
+        }
+        else if ((pStack->aMode[pRequest->nodeId] == kObjScanTestAbort) &&
+                 (pRequest->subindex == 2))
+        {
+            sdo.sdoComConState = kSdoComTransferRxAborted;
+            sdo.abortCode = OBJSCANTEST_ABORT_CODE;
+        }
+        else
+        {
+            value = getValue(pRequest->nodeId, pRequest->index, pRequest->subindex);
+            size = getSize(pRequest->index);
+            if (size > pRequest->size)
+                size = pRequest->size;
+            memcpy(pRequest->pData, &value, size);
+            sdo.transferredBytes = size;
+        }
+
+        CHECK(objscan_processSdoEvent(&sdo));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check that an object has been read
+
+\param  nodeId_p                Node ID.
+\param  index_p                 Index of the object.
+\param  subindex_p              Subindex of the object.
+
+\return The function returns TRUE if the result contains the value of the
+        object.
+*/
+//------------------------------------------------------------------------------
+static BOOL isObjectRead(UINT nodeId_p, UINT index_p, UINT subindex_p)
+{
+    const tObjScanEntry*    pEntry = objscan_findEntry(nodeId_p, index_p, subindex_p);
+    UINT32                  value = getValue(nodeId_p, index_p, subindex_p);
+
+    if (getSize(index_p) == 1)
+        value &= 0xFF;
+
+    return (pEntry != NULL) && (pEntry->nodeId == nodeId_p) && (pEntry->index == index_p) &&
+           (pEntry->subindex == subindex_p) && (pEntry->abortCode == 0) &&
+           (pEntry->value == value);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check that an object has not been read
+
+\param  nodeId_p                Node ID.
+\param  index_p                 Index of the object.
+\param  subindex_p              Subindex of the object.
+\param  abortCode_p             Expected abort code.
+
+\return The function returns TRUE if the result contains the abort code.
+*/
+//------------------------------------------------------------------------------
+static BOOL isObjectAborted(UINT nodeId_p, UINT index_p, UINT subindex_p, UINT32 abortCode_p)
+{
+    const tObjScanEntry*    pEntry = objscan_findEntry(nodeId_p, index_p, subindex_p);
+
+    return (pEntry != NULL) && (pEntry->abortCode == abortCode_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count the releases of the connections of a node
+
+\param  nodeId_p                Node ID.
+
+\return The function returns the number of released connections of the node.
+*/
+//------------------------------------------------------------------------------
+static UINT getFreeCount(UINT nodeId_p)
+{
+    UINT    count = 0;
+    UINT    i;
+
+    for (i = 0; i < stack_l.handleCount; i++)
+    {
+        if (stack_l.aHandleNodeId[i] == nodeId_p)
+            count += stack_l.aFreeCount[i];
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the object list parser
+*/
+//------------------------------------------------------------------------------
+static void checkParse(void)
+{
+    static const char*  apList[] =
+    {
+        "", "0/1", "0x10000/1", "0x1018", "0x1018/", "0x1018/256", "0x1018/4-1",
+        "0x1018/1-", "0x1018/1,", ",0x1018/1", "0x1018/1;0x1001/0", "0x1018/1 ",
+        "0x1018/1,0x1018/1", "0x1018/1-4,0x1018/4", "0x1018/0-32", "0x1018/x"
+    };
+    UINT                i;
+
+    for (i = 0; i < (sizeof(apList) / sizeof(apList[0])); i++)
+    {
+        if (!CHECK(objscan_init(apList[i]) == kErrorApiInvalidParam))
+            printf("    object list \"%s\"\n", apList[i]);
+        objscan_exit();
+    }
+
+    CHECK(objscan_init("0x1018/0-31") == kErrorOk);
+    objscan_exit();
+    CHECK(objscan_init("0x1018/255,0xFFFF/0") == kErrorOk);
+    objscan_exit();
+    CHECK(objscan_init(NULL) == kErrorOk);
+    objscan_exit();
+
+    CHECK(objscan_start() == kErrorApiNotInitialized);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the order of the result table
+
+The objects are sorted, so the result table is ordered by node, index and
+subindex and can be searched.
+*/
+//------------------------------------------------------------------------------
+static void checkSort(void)
+{
+    const tObjScanEntry*    apEntry[4];
+
+    resetStack();
+    CHECK(objscan_init("0x2000/1,0x1018/3-4,0x1000/0") == kErrorOk);
+    setNodeState(1, kNmtCsOperational);
+    setNodeState(2, kNmtCsReadyToOperate);
+    CHECK(objscan_start() == kErrorOk);
+    CHECK(objscan_processUserEvent(stack_l.pUserArg));
+    objscan_process();
+
+    apEntry[0] = objscan_findEntry(1, 0x1000, 0);
+    apEntry[1] = objscan_findEntry(1, 0x1018, 3);
+    apEntry[2] = objscan_findEntry(1, 0x2000, 1);
+    apEntry[3] = objscan_findEntry(2, 0x1000, 0);
+    if (CHECK((apEntry[0] != NULL) && (apEntry[1] != NULL) && (apEntry[2] != NULL) &&
+              (apEntry[3] != NULL)))
+    {
+        CHECK((apEntry[0] < apEntry[1]) && (apEntry[1] < apEntry[2]) && (apEntry[2] < apEntry[3]));
+    }
+
+    CHECK(isObjectRead(1, 0x1018, 4));
+    CHECK(isObjectRead(2, 0x2000, 1));
+    CHECK(objscan_findEntry(1, 0x1018, 2) == NULL);
+    CHECK(objscan_findEntry(3, 0x1000, 0) == NULL);
+    objscan_exit();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a scan without configured nodes
+*/
+//------------------------------------------------------------------------------
+static void checkNoNodes(void)
+{
+    resetStack();
+    CHECK(objscan_init(NULL) == kErrorOk);
+    setNodeState(1, kNmtCsOperational);
+    setNodeState(1, kNmtCsPreOperational2);
+
+    CHECK(objscan_start() == kErrorOk);
+    CHECK(stack_l.userEventCount == 0);
+    objscan_process();
+    CHECK(objscan_findEntry(1, 0x1018, 1) == NULL);
+    objscan_exit();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a scan of a network
+
+The network has more configured nodes than SDO channels, with nodes which
+answer immediately or by SDO events, abort an object, fail completely or
+refuse the requests. Only configured nodes are read and every connection is
+released once.
+*/
+//------------------------------------------------------------------------------
+static void checkScan(void)
+{
+    static const UINT   aSub1018[] = {1, 2, 3, 4};
+    tSdoComFinished     sdo;
+    UINT                nodeId;
+    UINT                i;
+
+    resetStack();
+    CHECK(objscan_init(NULL) == kErrorOk);
+
+    for (nodeId = 1; nodeId <= 12; nodeId++)
+        setNodeState(nodeId, kNmtCsOperational);
+    setNodeState(3, kNmtCsPreOperational2);
+    setNodeState(200, kNmtCsReadyToOperate);
+
+    stack_l.aMode[2] = kObjScanTestDeferred;
+    stack_l.aMode[4] = kObjScanTestDeferred;
+    stack_l.aMode[5] = kObjScanTestAbort;
+    stack_l.aMode[7] = kObjScanTestLowerLayer;
+    stack_l.aMode[8] = kObjScanTestError;
+    stack_l.aMode[11] = kObjScanTestDeferred;
+    stack_l.aMode[200] = kObjScanTestDeferred;
+
+    CHECK(objscan_start() == kErrorOk);
+    CHECK(stack_l.userEventCount == 1);
+    CHECK(objscan_start() == kErrorReject);
+
+    // a node which has left the configured state before its turn is skipped
+    setNodeState(12, kNmtCsPreOperational2);
+
+    CHECK(!objscan_processUserEvent(NULL));
+    CHECK(objscan_processUserEvent(stack_l.pUserArg));
+    objscan_process();
+    CHECK(objscan_findEntry(1, 0x1018, 1) == NULL);
+
+    memset(&sdo, 0, sizeof(sdo));
+    sdo.sdoComConState = kSdoComTransferFinished;
+    sdo.pUserArg = &sdo;
+    CHECK(!objscan_processSdoEvent(&sdo));
+
+    completeRequests();
+    objscan_process();
+
+    for (i = 0; i < (sizeof(aSub1018) / sizeof(aSub1018[0])); i++)
+    {
+        CHECK(isObjectRead(1, 0x1018, aSub1018[i]));
+        CHECK(isObjectRead(2, 0x1018, aSub1018[i]));
+        CHECK(isObjectRead(200, 0x1018, aSub1018[i]));
+        CHECK(isObjectAborted(7, 0x1018, aSub1018[i], OBJSCANTEST_ABORT_TIMEOUT));
+        CHECK(isObjectAborted(8, 0x1018, aSub1018[i], OBJSCANTEST_ABORT_GENERAL));
+        CHECK(isObjectAborted(12, 0x1018, aSub1018[i], OBJSCANTEST_ABORT_GENERAL));
+    }
+
+    CHECK(isObjectRead(1, 0x1001, 0));
+    CHECK(isObjectRead(4, 0x1020, 2));
+    CHECK(isObjectRead(11, 0x1001, 0));
+    CHECK(isObjectRead(5, 0x1018, 1));
+    CHECK(isObjectAborted(5, 0x1018, 2, OBJSCANTEST_ABORT_CODE));
+    CHECK(isObjectAborted(5, 0x1020, 2, OBJSCANTEST_ABORT_CODE));
+    CHECK(isObjectRead(5, 0x1018, 3));
+    CHECK(isObjectAborted(7, 0x1001, 0, OBJSCANTEST_ABORT_TIMEOUT));
+    CHECK(objscan_findEntry(3, 0x1018, 1) == NULL);
+    CHECK(objscan_findEntry(13, 0x1018, 1) == NULL);
+    CHECK(objscan_findEntry(1, 0x1018, 5) == NULL);
+
+    // a lower layer abort ends the node after the first request
+    CHECK(stack_l.aReadCount[7] == 1);
+    CHECK(stack_l.aReadCount[1] == 7);
+    CHECK(stack_l.aReadCount[3] == 0);
+    CHECK(stack_l.aReadCount[12] == 0);
+    CHECK(stack_l.aReadCount[200] == 7);
+
+    for (nodeId = 1; nodeId <= OBJSCAN_MAX_NODE_ID; nodeId++)
+    {
+        if (stack_l.aReadCount[nodeId] != 0)
+        {
+            if (!CHECK(getFreeCount(nodeId) == 1))
+                printf("    node %u\n", nodeId);
+        }
+    }
+    CHECK(!stack_l.fInvalidFree);
+
+    objscan_printResult();
+    objscan_exit();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a node reset during the scan
+
+The connection of a node which has been reset during its read may be reused
+by the configuration manager, so it is not released by the scan.
+*/
+//------------------------------------------------------------------------------
+static void checkNodeReset(void)
+{
+    resetStack();
+    CHECK(objscan_init("0x1018/1-2") == kErrorOk);
+    setNodeState(1, kNmtCsOperational);
+    setNodeState(2, kNmtCsOperational);
+    stack_l.aMode[1] = kObjScanTestDeferred;
+    stack_l.aMode[2] = kObjScanTestDeferred;
+
+    CHECK(objscan_start() == kErrorOk);
+    CHECK(objscan_processUserEvent(stack_l.pUserArg));
+    setNodeState(2, kNmtCsNotActive);
+    setNodeState(2, kNmtCsOperational);
+    completeRequests();
+    objscan_process();
+
+    CHECK(isObjectRead(1, 0x1018, 2));
+    CHECK(isObjectRead(2, 0x1018, 2));
+    CHECK(getFreeCount(1) == 1);
+    CHECK(getFreeCount(2) == 0);
+    objscan_exit();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check a failure to start the scan
+
+The scan is not running, so it can be started again.
+*/
+//------------------------------------------------------------------------------
+static void checkStartFailure(void)
+{
+    resetStack();
+    CHECK(objscan_init(NULL) == kErrorOk);
+    setNodeState(1, kNmtCsOperational);
+
+    stack_l.userEventError = kErrorNoResource;
+    CHECK(objscan_start() == kErrorNoResource);
+
+    stack_l.userEventError = kErrorOk;
+    CHECK(objscan_start() == kErrorOk);
+    CHECK(objscan_processUserEvent(stack_l.pUserArg));
+    objscan_process();
+    CHECK(isObjectRead(1, 0x1020, 1));
+    objscan_exit();
+}
+
+/// \}
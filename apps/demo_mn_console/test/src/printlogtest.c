@@ -0,0 +1,220 @@
+/**
+********************************************************************************
+\file   printlogtest.c
+
+\brief  Unit checks of the console log rate limiting
+
+This file contains the host unit checks of the rate limiting of the console
+log: the burst per message, the separation of messages by call site, node and
+code, the new budget of a window and the behavior with a full table.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2015, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include <time.h>
+
+#include <oplk/oplk.h>
+#include <console/console.h>
+
+#include "check.h"
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PRINTLOGTEST_FILE           "printlogtest.c"
+#define PRINTLOGTEST_TABLE_SIZE     256     // size of the rate limiting table of printlog.c
+#define PRINTLOGTEST_MESSAGES       400     // distinct messages to overflow the table
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int  logMessage(const char* pFile_p, int line_p, unsigned int node_p, unsigned int code_p);
+static void checkBurst(void);
+static void checkMessageKey(void);
+static void checkWindow(void);
+static void checkTableFull(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the log rate limiting checks
+
+\return The function returns 0 if all checks have passed.
+*/
+//------------------------------------------------------------------------------
+int main(void)
+{
+    checkBurst();
+    checkMessageKey();
+    checkWindow();
+    checkTableFull();
+
+    return check_finish("printlogtest");
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Log a rate-limited message
+
+\param  pFile_p                 Source file of the call site.
+\param  line_p                  Source line of the call site.
+\param  node_p                  Node of the message.
+\param  code_p                  Code of the message.
+
+\return The function returns 1 if the message was printed.
+*/
+//------------------------------------------------------------------------------
+static int logMessage(const char* pFile_p, int line_p, unsigned int node_p, unsigned int code_p)
+{
+    return console_printloglimit(pFile_p, line_p, node_p, code_p,
+                                 "Check message %d, node %u, code 0x%X\n", line_p, node_p, code_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the burst of a message
+
+Within a window, only the configured number of messages is printed.
+*/
+//------------------------------------------------------------------------------
+static void checkBurst(void)
+{
+    int     printed = 0;
+    int     i;
+
+    console_setloglimit(CONSOLE_LOG_LIMIT_BURST, 3600);
+    for (i = 0; i < (3 * CONSOLE_LOG_LIMIT_BURST); i++)
+        printed += logMessage(PRINTLOGTEST_FILE, 100, 1, 0x8242);
+
+    CHECK(printed == CONSOLE_LOG_LIMIT_BURST);
+
+    console_setloglimit(2, 3600);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 101, 1, 0x8242) == 1);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 101, 1, 0x8242) == 1);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 101, 1, 0x8242) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the separation of messages
+
+Messages are identified by call site, node and code. The file name is
+compared by contents, so a copy of the name addresses the same message.
+*/
+//------------------------------------------------------------------------------
+static void checkMessageKey(void)
+{
+    char    aFileCopy[sizeof(PRINTLOGTEST_FILE)];
+
+    console_setloglimit(1, 3600);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 200, 1, 0x8242) == 1);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 200, 1, 0x8242) == 0);
+
+    CHECK(logMessage(PRINTLOGTEST_FILE, 201, 1, 0x8242) == 1);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 200, 2, 0x8242) == 1);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 200, 1, 0x8245) == 1);
+    CHECK(logMessage("other.c", 200, 1, 0x8242) == 1);
+
+    strcpy(aFileCopy, PRINTLOGTEST_FILE);
+    CHECK(logMessage(aFileCopy, 200, 1, 0x8242) == 0);
+    CHECK(logMessage(aFileCopy, 201, 1, 0x8242) == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the start of a new window
+
+A message gets a new budget when its window has expired. The window has a
+resolution of one second, so the check waits for the next second.
+*/
+//------------------------------------------------------------------------------
+static void checkWindow(void)
+{
+    time_t  start;
+
+    console_setloglimit(1, 1);
+    start = time(NULL);
+    CHECK(logMessage(PRINTLOGTEST_FILE, 300, 1, 0x8242) == 1);
+    if (time(NULL) == start)
+        CHECK(logMessage(PRINTLOGTEST_FILE, 300, 1, 0x8242) == 0);
+
+    while (time(NULL) < (start + 2))
+        ;
+
+    CHECK(logMessage(PRINTLOGTEST_FILE, 300, 1, 0x8242) == 1);
+    console_flushlog();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the behavior with a full table
+
+Messages which do not get a table entry are printed without limit, and no
+message is ever suppressed before it has used up its own burst.
+*/
+//------------------------------------------------------------------------------
+static void checkTableFull(void)
+{
+    int     suppressed = 0;
+    int     printed = 0;
+    int     i;
+
+    console_setloglimit(1, 3600);
+    for (i = 0; i < PRINTLOGTEST_MESSAGES; i++)
+        printed += logMessage(PRINTLOGTEST_FILE, 1000 + i, 3, 0);
+    CHECK(printed == PRINTLOGTEST_MESSAGES);
+
+    for (i = 0; i < PRINTLOGTEST_MESSAGES; i++)
+    {
+        if (logMessage(PRINTLOGTEST_FILE, 1000 + i, 3, 0) == 0)
+            suppressed++;
+    }
+
+    // the messages of the previous checks occupy entries as well
+    CHECK(suppressed > 0);
+    CHECK(suppressed <= PRINTLOGTEST_TABLE_SIZE);
+}
+
+/// \}
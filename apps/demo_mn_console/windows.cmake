@@ -39,12 +39,18 @@ ADD_DEFINITIONS(-D_CONSOLE -DWPCAP -DHAVE_REMOTE -D_CRT_SECURE_NO_WARNINGS)
 SET (DEMO_ARCH_SOURCES
      ${DEMO_ARCHSOURCES}
      ${COMMON_SOURCE_DIR}/system/system-windows.c
+     ${COMMON_SOURCE_DIR}/system/rttune-windows.c
      ${CONTRIB_SOURCE_DIR}/console/console-windows.c
      )
 
 ################################################################################
 # Set architecture specific libraries
 
+SET(PCAP_LIBRARIES wpcap)
+
+INCLUDE_DIRECTORIES(${CONTRIB_SOURCE_DIR}/pcap/windows/WpdPack/Include)
+LINK_DIRECTORIES(${CONTRIB_SOURCE_DIR}/pcap/windows/WpdPack/Lib)
+
 ################################################################################
 # Set architecture specific installation files
 IF(NOT (${OPLKDLL} STREQUAL "OPLKDLL-NOTFOUND"))
@@ -44,10 +44,98 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define CONSOLE_LOG_LIMIT_BURST     10      ///< Default number of messages logged per window
+#define CONSOLE_LOG_LIMIT_WINDOW    10      ///< Default length of the rate limiting window [s]
+
+/**
+\brief  Print rate-limited log entry
+
+The macro prints a log entry which is rate-limited per call site, node and
+code. See console_printloglimit().
+*/
+#define CONSOLE_PRINTLOG_LIMITED(node_p, code_p, ...) \
+    console_printloglimit(__FILE__, __LINE__, (node_p), (code_p), __VA_ARGS__)
+
+#define CONSOLE_LEVEL_NONE          0       ///< No log entries are printed
+#define CONSOLE_LEVEL_ERROR         1       ///< Errors only
+#define CONSOLE_LEVEL_WARNING       2       ///< Errors and warnings
+#define CONSOLE_LEVEL_INFO          3       ///< Additionally informational entries
+#define CONSOLE_LEVEL_DEBUG         4       ///< All entries including diagnostics
+
+#ifndef CONSOLE_LOG_FLOOR
+#define CONSOLE_LOG_FLOOR           CONSOLE_LEVEL_DEBUG     ///< Highest level compiled in
+#endif
+
+#if (CONSOLE_LOG_FLOOR < CONSOLE_LEVEL_NONE) || (CONSOLE_LOG_FLOOR > CONSOLE_LEVEL_DEBUG)
+#error "CONSOLE_LOG_FLOOR must be in the range CONSOLE_LEVEL_NONE..CONSOLE_LEVEL_DEBUG"
+#endif
+
+#ifndef CONSOLE_LOG_DEFAULT
+#define CONSOLE_LOG_DEFAULT         CONSOLE_LEVEL_INFO      ///< Initial level of all modules
+#endif
+
+/**
+\brief  Check whether a log level is enabled
+
+The macro evaluates to true if entries of the given level are printed for the
+given module. Levels above CONSOLE_LOG_FLOOR evaluate to a constant false, so
+the compiler removes the guarded code.
+*/
+#define CONSOLE_LOG_ENABLED(module_p, level_p) \
+    (((level_p) <= CONSOLE_LOG_FLOOR) && ((level_p) <= aConsoleLogLevel_g[(module_p)]))
+
+/**
+\brief  Print leveled log entries
+
+The macros print a log entry with console_printlog() if the level is enabled
+for the module. Levels above CONSOLE_LOG_FLOOR expand to nothing, the
+arguments are not evaluated.
+*/
+#if (CONSOLE_LOG_FLOOR >= CONSOLE_LEVEL_ERROR)
+#define CONSOLE_LOG_ERROR(module_p, ...) \
+    do { if (CONSOLE_LOG_ENABLED(module_p, CONSOLE_LEVEL_ERROR)) console_printlog(__VA_ARGS__); } while (0)
+#else
+#define CONSOLE_LOG_ERROR(module_p, ...)    do { } while (0)
+#endif
+
+#if (CONSOLE_LOG_FLOOR >= CONSOLE_LEVEL_WARNING)
+#define CONSOLE_LOG_WARNING(module_p, ...) \
+    do { if (CONSOLE_LOG_ENABLED(module_p, CONSOLE_LEVEL_WARNING)) console_printlog(__VA_ARGS__); } while (0)
+#else
+#define CONSOLE_LOG_WARNING(module_p, ...)  do { } while (0)
+#endif
+
+#if (CONSOLE_LOG_FLOOR >= CONSOLE_LEVEL_INFO)
+#define CONSOLE_LOG_INFO(module_p, ...) \
+    do { if (CONSOLE_LOG_ENABLED(module_p, CONSOLE_LEVEL_INFO)) console_printlog(__VA_ARGS__); } while (0)
+#else
+#define CONSOLE_LOG_INFO(module_p, ...)     do { } while (0)
+#endif
+
+#if (CONSOLE_LOG_FLOOR >= CONSOLE_LEVEL_DEBUG)
+#define CONSOLE_LOG_DEBUG(module_p, ...) \
+    do { if (CONSOLE_LOG_ENABLED(module_p, CONSOLE_LEVEL_DEBUG)) console_printlog(__VA_ARGS__); } while (0)
+#else
+#define CONSOLE_LOG_DEBUG(module_p, ...)    do { } while (0)
+#endif
 
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
+/**
+\brief  Log modules
+
+The enumeration lists the modules with a separate log level.
+*/
+typedef enum
+{
+    kConsoleModEvent = 0,               ///< Stack event processing
+    kConsoleModSync,                    ///< Synchronous data exchange
+    kConsoleModCfm,                     ///< Configuration manager
+    kConsoleModProdTest,                ///< Production test
+    kConsoleModSystem,                  ///< System and platform services
+    kConsoleModCount                    ///< Number of modules
+} tConsoleModule;
 
 //------------------------------------------------------------------------------
 // function prototypes
@@ -57,10 +145,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 extern "C" {
 #endif
 
+extern volatile int aConsoleLogLevel_g[kConsoleModCount];
+
 int console_getch(void);
 int console_kbhit(void);
 void console_printlog(char* fmt, ...);
 void console_printlogadd(char* fmt, ...);
+int  console_printloglimit(const char* pFile_p, int line_p, unsigned int node_p,
+                           unsigned int code_p, char* fmt, ...);
+void console_setloglimit(unsigned int burst_p, unsigned int windowSec_p);
+void console_flushlog(void);
+int  console_setloglevel(tConsoleModule module_p, int level_p);
+int  console_getloglevel(tConsoleModule module_p);
+int  console_parseloglevels(const char* pSpec_p);
+void console_toggleverbose(void);
+void console_printloglevels(void);
 
 #ifdef __cplusplus
 }
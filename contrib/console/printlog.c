@@ -40,8 +40,107 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "console.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+volatile int aConsoleLogLevel_g[kConsoleModCount] =
+{
+    CONSOLE_LOG_DEFAULT, CONSOLE_LOG_DEFAULT, CONSOLE_LOG_DEFAULT,
+    CONSOLE_LOG_DEFAULT, CONSOLE_LOG_DEFAULT
+};
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define LOGLIMIT_TABLE_SIZE     256         // number of rate limited messages (power of 2)
+#define LOGLIMIT_MAX_PROBES     16          // max. probes before a message is logged unlimited
+#define LOGLIMIT_KEY_FREE       0           // entry has never been used
+#define LOGLIMIT_KEY_BUSY       (-1L)       // entry is being (re)initialized
+
+#if defined(_MSC_VER)
+#define LOGLIMIT_CAS(pVal, cmp, val)    _InterlockedCompareExchange((volatile long*)(pVal), (val), (cmp))
+#define LOGLIMIT_XCHG(pVal, val)        _InterlockedExchange((volatile long*)(pVal), (val))
+#define LOGLIMIT_INC(pVal)              _InterlockedIncrement((volatile long*)(pVal))
+#else
+#define LOGLIMIT_CAS(pVal, cmp, val)    __sync_val_compare_and_swap((pVal), (cmp), (val))
+#define LOGLIMIT_XCHG(pVal, val)        __sync_lock_test_and_set((pVal), (val))
+#define LOGLIMIT_INC(pVal)              __sync_add_and_fetch((pVal), 1)
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Rate limited message entry
+
+The structure describes an entry of the lock-free rate limiting table. An
+entry is claimed by atomically setting its key to LOGLIMIT_KEY_BUSY, filled
+and then published with the hash of its message. All counters are updated
+with atomic operations.
+*/
+typedef struct
+{
+    volatile long       key;                ///< Hash of call site, node and code, or LOGLIMIT_KEY_xxx
+    const char*         pFile;              ///< Source file of the call site
+    int                 line;               ///< Source line of the call site
+    unsigned int        node;               ///< Node of the message
+    unsigned int        code;               ///< Code of the message
+    volatile long       windowStart;        ///< Start of the current window [s]
+    volatile long       count;              ///< Occurrences in the current window
+    volatile long       suppressed;         ///< Suppressed occurrences in the current window
+    volatile long       lastUse;            ///< Time of the last occurrence [s]
+} tLogLimitEntry;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tLogLimitEntry   aLogLimit_l[LOGLIMIT_TABLE_SIZE];
+static long             logLimitBurst_l = CONSOLE_LOG_LIMIT_BURST;
+static long             logLimitWindow_l = CONSOLE_LOG_LIMIT_WINDOW;
+static int              aSavedLogLevel_l[kConsoleModCount];
+static int              fVerbose_l = 0;
+
+static const char*      apModuleName_l[kConsoleModCount] =
+{
+    "event", "sync", "cfm", "prodtest", "system"
+};
+
+static const char*      apLevelName_l[CONSOLE_LEVEL_DEBUG + 1] =
+{
+    "none", "error", "warning", "info", "debug"
+};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void            printlogv(char* fmt, va_list arglist);
+static tLogLimitEntry* findEntry(const char* pFile_p, int line_p,
+                                 unsigned int node_p, unsigned int code_p, long now_p);
+static int             matchEntry(const tLogLimitEntry* pEntry_p, long key_p, const char* pFile_p,
+                                  int line_p, unsigned int node_p, unsigned int code_p);
+static void            initEntry(tLogLimitEntry* pEntry_p, long key_p, const char* pFile_p,
+                                 int line_p, unsigned int node_p, unsigned int code_p, long now_p);
+static void            rollWindow(tLogLimitEntry* pEntry_p, long now_p);
+static int             findName(const char** apNames_p, int count_p,
+                                const char* pName_p, size_t len_p);
+
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
@@ -62,17 +161,9 @@ with the current date and time.
 void console_printlog(char* fmt, ...)
 {
     va_list             arglist;
-    time_t              timeStamp;
-    struct tm*          p_timeVal;
-    char                timeStr[20];
-
-    time(&timeStamp);
-    p_timeVal = localtime(&timeStamp);
-    strftime(timeStr, 20, "%Y/%m/%d %H:%M:%S", p_timeVal);
 
-    fprintf(stderr, "%s - ", timeStr);
     va_start(arglist, fmt);
-    vfprintf(stderr, fmt, arglist);
+    printlogv(fmt, arglist);
     va_end(arglist);
 }
 
@@ -97,3 +188,531 @@ void console_printlogadd(char* fmt, ...)
     va_end(arglist);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Print rate-limited log entry
+
+The function prints a log entry like console_printlog(), but limits the
+number of identical messages. Messages are identified by their call site,
+node and code. Within a window, only the first messages up to the configured
+burst are printed. The remaining ones are counted, and a summary line is
+printed when the window has expired. The function is usually called through
+the CONSOLE_PRINTLOG_LIMITED() macro.
+
+\param  pFile_p     Source file of the call site
+\param  line_p      Source line of the call site
+\param  node_p      Node the message refers to
+\param  code_p      Code the message refers to
+\param  fmt         Format string
+\param  ...         Arguments to print
+
+\return The function returns 1 if the message was printed or 0 if it was
+        suppressed. Continuation lines must only be printed if the message
+        was printed.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+int console_printloglimit(const char* pFile_p, int line_p, unsigned int node_p,
+                          unsigned int code_p, char* fmt, ...)
+{
+    va_list             arglist;
+    tLogLimitEntry*     pEntry;
+    long                now;
+
+    now = (long)time(NULL);
+    pEntry = findEntry(pFile_p, line_p, node_p, code_p, now);
+    if (pEntry != NULL)
+    {
+        pEntry->lastUse = now;
+        if ((now - pEntry->windowStart) >= logLimitWindow_l)
+            rollWindow(pEntry, now);
+
+        if (LOGLIMIT_INC(&pEntry->count) > logLimitBurst_l)
+        {
+            LOGLIMIT_INC(&pEntry->suppressed);
+            return 0;
+        }
+    }
+
+    // table is full or message is below the limit -> print it
+    va_start(arglist, fmt);
+    printlogv(fmt, arglist);
+    va_end(arglist);
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Configure log rate limiting
+
+The function sets the number of identical messages printed per window and the
+length of the window.
+
+\param  burst_p         Number of messages printed per window
+\param  windowSec_p     Length of the window in seconds
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+void console_setloglimit(unsigned int burst_p, unsigned int windowSec_p)
+{
+    logLimitBurst_l = (long)burst_p;
+    logLimitWindow_l = (windowSec_p == 0) ? 1 : (long)windowSec_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Flush rate-limited log messages
+
+The function prints the summary lines of suppressed messages whose window has
+expired. It should be called periodically, so summaries are printed even if
+a message does not occur again.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+void console_flushlog(void)
+{
+    tLogLimitEntry*     pEntry;
+    long                now = (long)time(NULL);
+    int                 i;
+
+    for (i = 0; i < LOGLIMIT_TABLE_SIZE; i++)
+    {
+        pEntry = &aLogLimit_l[i];
+        if ((pEntry->key != LOGLIMIT_KEY_FREE) && (pEntry->key != LOGLIMIT_KEY_BUSY) &&
+            (pEntry->suppressed != 0) &&
+            ((now - pEntry->windowStart) >= logLimitWindow_l))
+            rollWindow(pEntry, now);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set log level of a module
+
+The function sets the level up to which log entries of the given module are
+printed. It can be called at any time, the new level is effective with the
+next log entry. Levels above the build-time floor CONSOLE_LOG_FLOOR are
+limited to the floor, because their entries are not compiled in.
+
+\param  module_p    Module to configure
+\param  level_p     New log level (CONSOLE_LEVEL_NONE to CONSOLE_LEVEL_DEBUG)
+
+\return The function returns 0 if the level was set or -1 if the module or
+        level is invalid.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+int console_setloglevel(tConsoleModule module_p, int level_p)
+{
+    if (((int)module_p < 0) || (module_p >= kConsoleModCount) ||
+        (level_p < CONSOLE_LEVEL_NONE) || (level_p > CONSOLE_LEVEL_DEBUG))
+        return -1;
+
+    if (level_p > CONSOLE_LOG_FLOOR)
+        level_p = CONSOLE_LOG_FLOOR;
+
+    aConsoleLogLevel_g[module_p] = level_p;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get log level of a module
+
+\param  module_p    Module to query
+
+\return The function returns the current log level of the module or -1 if the
+        module is invalid.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+int console_getloglevel(tConsoleModule module_p)
+{
+    if (((int)module_p < 0) || (module_p >= kConsoleModCount))
+        return -1;
+
+    return aConsoleLogLevel_g[module_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse log level specification
+
+The function sets the log levels from a comma separated list of
+MODULE=LEVEL items, e.g. "all=warning,event=debug". MODULE is a module name
+or "all", an item without a module applies to all modules. LEVEL is a level
+name (none, error, warning, info, debug) or its number. The items are applied
+in the given order.
+
+\param  pSpec_p     Log level specification
+
+\return The function returns 0 if the specification is valid or -1 otherwise.
+        Items before an invalid item are applied.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+int console_parseloglevels(const char* pSpec_p)
+{
+    const char*     pItem = pSpec_p;
+    const char*     pEnd;
+    const char*     pLevel;
+    int             module;
+    int             level;
+    int             i;
+
+    while (*pItem != '\0')
+    {
+        pEnd = strchr(pItem, ',');
+        if (pEnd == NULL)
+            pEnd = pItem + strlen(pItem);
+
+        pLevel = (const char*)memchr(pItem, '=', (size_t)(pEnd - pItem));
+        if (pLevel == NULL)
+        {
+            module = kConsoleModCount;
+            pLevel = pItem;
+        }
+        else
+        {
+            if (((size_t)(pLevel - pItem) == 3) && (strncmp(pItem, "all", 3) == 0))
+                module = kConsoleModCount;
+            else
+                module = findName(apModuleName_l, kConsoleModCount, pItem, (size_t)(pLevel - pItem));
+            pLevel++;
+        }
+
+        if (((pEnd - pLevel) == 1) && (*pLevel >= '0') && (*pLevel <= '9'))
+            level = *pLevel - '0';
+        else
+            level = findName(apLevelName_l, CONSOLE_LEVEL_DEBUG + 1, pLevel, (size_t)(pEnd - pLevel));
+
+        if ((module < 0) || (level < CONSOLE_LEVEL_NONE) || (level > CONSOLE_LEVEL_DEBUG))
+            return -1;
+
+        if (module == kConsoleModCount)
+        {
+            for (i = 0; i < kConsoleModCount; i++)
+                console_setloglevel((tConsoleModule)i, level);
+        }
+        else
+            console_setloglevel((tConsoleModule)module, level);
+
+        pItem = (*pEnd == ',') ? pEnd + 1 : pEnd;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Toggle verbose logging
+
+The function switches all modules to the debug level (limited by the
+build-time floor) and saves the current levels. The next call restores the
+saved levels. It allows to enable diagnostics for a short time on a running
+system.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+void console_toggleverbose(void)
+{
+    int     i;
+
+    if (!fVerbose_l)
+    {
+        for (i = 0; i < kConsoleModCount; i++)
+        {
+            aSavedLogLevel_l[i] = aConsoleLogLevel_g[i];
+            console_setloglevel((tConsoleModule)i, CONSOLE_LEVEL_DEBUG);
+        }
+        fVerbose_l = 1;
+    }
+    else
+    {
+        for (i = 0; i < kConsoleModCount; i++)
+            aConsoleLogLevel_g[i] = aSavedLogLevel_l[i];
+        fVerbose_l = 0;
+    }
+
+    console_printloglevels();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print log levels
+
+The function prints the current log level of all modules and the build-time
+floor.
+
+\ingroup module_console
+*/
+//------------------------------------------------------------------------------
+void console_printloglevels(void)
+{
+    int     i;
+
+    printf("Log levels:");
+    for (i = 0; i < kConsoleModCount; i++)
+        printf(" %s=%s", apModuleName_l[i], apLevelName_l[aConsoleLogLevel_g[i]]);
+    printf(" (compiled up to %s)\n", apLevelName_l[CONSOLE_LOG_FLOOR]);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print log entry with variable argument list
+
+The function prints a log entry prepended with the current date and time.
+
+\param  fmt         Format string
+\param  arglist     Arguments to print
+*/
+//------------------------------------------------------------------------------
+static void printlogv(char* fmt, va_list arglist)
+{
+    time_t              timeStamp;
+    struct tm*          p_timeVal;
+    char                timeStr[20];
+
+    time(&timeStamp);
+    p_timeVal = localtime(&timeStamp);
+    strftime(timeStr, 20, "%Y/%m/%d %H:%M:%S", p_timeVal);
+
+    fprintf(stderr, "%s - ", timeStr);
+    vfprintf(stderr, fmt, arglist);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find rate limiting entry
+
+The function searches the rate limiting table for the given message. Entries
+are matched by their full key, so messages with colliding hashes never share
+a budget. If the message is not yet contained, a free entry or an entry which
+has been idle for longer than the window is claimed with a compare and swap
+operation, so concurrent callers never block each other.
+
+\param  pFile_p     Source file of the call site
+\param  line_p      Source line of the call site
+\param  node_p      Node the message refers to
+\param  code_p      Code the message refers to
+\param  now_p       Current time [s]
+
+\return The function returns a pointer to the entry or NULL if no entry is
+        available.
+*/
+//------------------------------------------------------------------------------
+static tLogLimitEntry* findEntry(const char* pFile_p, int line_p,
+                                 unsigned int node_p, unsigned int code_p, long now_p)
+{
+    tLogLimitEntry*     pEntry;
+    tLogLimitEntry*     pIdle = NULL;
+    unsigned long       hash = 2166136261UL;
+    const char*         pChar;
+    long                key;
+    long                idleKey = LOGLIMIT_KEY_FREE;
+    long                entryKey;
+    int                 i;
+
+    // FNV-1a over the call site, node and code
+    for (pChar = pFile_p; *pChar != '\0'; pChar++)
+        hash = (hash ^ (unsigned char)*pChar) * 16777619UL;
+    hash = (hash ^ (unsigned long)line_p) * 16777619UL;
+    hash = (hash ^ (unsigned long)node_p) * 16777619UL;
+    hash = (hash ^ (unsigned long)code_p) * 16777619UL;
+
+    key = (long)(hash & 0x7FFFFFFFUL) | 1;
+
+    for (i = 0; i < LOGLIMIT_MAX_PROBES; i++)
+    {
+        pEntry = &aLogLimit_l[(hash + i) & (LOGLIMIT_TABLE_SIZE - 1)];
+        entryKey = pEntry->key;
+
+        if (matchEntry(pEntry, key, pFile_p, line_p, node_p, code_p))
+            return pEntry;
+
+        if (entryKey == LOGLIMIT_KEY_FREE)
+        {
+            // entries are never freed again, so the message is not contained
+            // further down the probe sequence -> prefer an idle entry before
+            if (pIdle != NULL)
+                break;
+
+            if (LOGLIMIT_CAS(&pEntry->key, LOGLIMIT_KEY_FREE, LOGLIMIT_KEY_BUSY) == LOGLIMIT_KEY_FREE)
+            {
+                initEntry(pEntry, key, pFile_p, line_p, node_p, code_p, now_p);
+                return pEntry;
+            }
+
+            // entry was claimed concurrently, possibly by the same message
+            if (matchEntry(pEntry, key, pFile_p, line_p, node_p, code_p))
+                return pEntry;
+            continue;
+        }
+
+        if ((pIdle == NULL) && (entryKey != LOGLIMIT_KEY_BUSY) &&
+            ((now_p - pEntry->lastUse) > logLimitWindow_l))
+        {
+            pIdle = pEntry;
+            idleKey = entryKey;
+        }
+    }
+
+    if (pIdle == NULL)
+        return NULL;
+
+    if (LOGLIMIT_CAS(&pIdle->key, idleKey, LOGLIMIT_KEY_BUSY) != idleKey)
+        return NULL;
+
+    // the entry may have been used again since it was selected
+    if ((now_p - pIdle->lastUse) <= logLimitWindow_l)
+    {
+        LOGLIMIT_XCHG(&pIdle->key, idleKey);
+        return NULL;
+    }
+
+    // print the summary of the previous message before the entry is reused
+    if (pIdle->suppressed != 0)
+        rollWindow(pIdle, now_p);
+
+    initEntry(pIdle, key, pFile_p, line_p, node_p, code_p, now_p);
+    return pIdle;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare rate limiting entry
+
+The function checks whether a published entry belongs to the given message.
+
+\param  pEntry_p    Pointer to the rate limiting entry
+\param  key_p       Hash of the message
+\param  pFile_p     Source file of the call site
+\param  line_p      Source line of the call site
+\param  node_p      Node the message refers to
+\param  code_p      Code the message refers to
+
+\return The function returns 1 if the entry belongs to the message, otherwise 0.
+*/
+//------------------------------------------------------------------------------
+static int matchEntry(const tLogLimitEntry* pEntry_p, long key_p, const char* pFile_p,
+                      int line_p, unsigned int node_p, unsigned int code_p)
+{
+    if (pEntry_p->key != key_p)
+        return 0;
+
+    if ((pEntry_p->line != line_p) || (pEntry_p->node != node_p) || (pEntry_p->code != code_p))
+        return 0;
+
+    if ((pEntry_p->pFile != pFile_p) && (strcmp(pEntry_p->pFile, pFile_p) != 0))
+        return 0;
+
+    // the entry must not have been recycled while it was compared
+    return (pEntry_p->key == key_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize rate limiting entry
+
+The function fills a claimed entry for the given message and publishes it by
+setting its key.
+
+\param  pEntry_p    Pointer to the rate limiting entry
+\param  key_p       Hash of the message
+\param  pFile_p     Source file of the call site
+\param  line_p      Source line of the call site
+\param  node_p      Node the message refers to
+\param  code_p      Code the message refers to
+\param  now_p       Current time [s]
+*/
+//------------------------------------------------------------------------------
+static void initEntry(tLogLimitEntry* pEntry_p, long key_p, const char* pFile_p,
+                      int line_p, unsigned int node_p, unsigned int code_p, long now_p)
+{
+    pEntry_p->pFile = pFile_p;
+    pEntry_p->line = line_p;
+    pEntry_p->node = node_p;
+    pEntry_p->code = code_p;
+    pEntry_p->windowStart = now_p;
+    pEntry_p->lastUse = now_p;
+    LOGLIMIT_XCHG(&pEntry_p->count, 0);
+    LOGLIMIT_XCHG(&pEntry_p->suppressed, 0);
+
+    // the compare and swap is a full barrier, the fields are visible before the key
+    LOGLIMIT_CAS(&pEntry_p->key, LOGLIMIT_KEY_BUSY, key_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start a new rate limiting window
+
+The function starts a new window for the given entry and prints a summary of
+the messages suppressed in the previous window. Only the caller which
+succeeds in updating the window start prints the summary.
+
+\param  pEntry_p    Pointer to the rate limiting entry
+\param  now_p       Current time [s]
+*/
+//------------------------------------------------------------------------------
+static void rollWindow(tLogLimitEntry* pEntry_p, long now_p)
+{
+    long    windowStart = pEntry_p->windowStart;
+    long    suppressed;
+
+    if (LOGLIMIT_CAS(&pEntry_p->windowStart, windowStart, now_p) != windowStart)
+        return;
+
+    suppressed = LOGLIMIT_XCHG(&pEntry_p->suppressed, 0);
+    LOGLIMIT_XCHG(&pEntry_p->count, 0);
+
+    if (suppressed != 0)
+    {
+        console_printlog("Last message repeated %ld times in %ld s (%s:%d, node %u, code 0x%X)\n",
+                         suppressed, now_p - windowStart, pEntry_p->pFile, pEntry_p->line,
+                         pEntry_p->node, pEntry_p->code);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find name in table
+
+The function searches a name table for a string which is not zero terminated.
+
+\param  apNames_p   Name table
+\param  count_p     Number of names in the table
+\param  pName_p     Name to search
+\param  len_p       Length of the name
+
+\return The function returns the index of the name or -1 if it is not found.
+*/
+//------------------------------------------------------------------------------
+static int findName(const char** apNames_p, int count_p,
+                    const char* pName_p, size_t len_p)
+{
+    int     i;
+
+    for (i = 0; i < count_p; i++)
+    {
+        if ((strlen(apNames_p[i]) == len_p) && (strncmp(apNames_p[i], pName_p, len_p) == 0))
+            return i;
+    }
+
+    return -1;
+}
+
+/// \}